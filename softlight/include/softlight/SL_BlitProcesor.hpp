@@ -5,7 +5,9 @@
 #include <cstdint>
 
 #include "softlight/SL_Color.hpp"
+#include "softlight/SL_PackedColor.hpp"
 #include "softlight/SL_Texture.hpp"
+#include "softlight/SL_ToneMap.hpp"
 
 
 
@@ -20,13 +22,12 @@ struct SL_Blit_R_to_R
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                   offset  = outIndex * stride;
-        const SL_ColorRType<inColor_type> inColor = pTexture->texel<SL_ColorRType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRType<inColor_type> inColor = pTexture->raw_texel<SL_ColorRType<inColor_type>>(srcIndex);
 
         *reinterpret_cast<SL_ColorRType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor);
     }
@@ -37,13 +38,12 @@ struct SL_Blit_RG_to_R
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                    offset  = outIndex * stride;
-        const SL_ColorRGType<inColor_type> inColor = pTexture->texel<SL_ColorRGType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRGType<inColor_type> inColor = pTexture->raw_texel<SL_ColorRGType<inColor_type>>(srcIndex);
 
         *reinterpret_cast<SL_ColorRType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor)[0];
     }
@@ -54,13 +54,12 @@ struct SL_Blit_RGB_to_R
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                     offset  = outIndex * stride;
-        const SL_ColorRGBType<inColor_type> inColor = pTexture->texel<SL_ColorRGBType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRGBType<inColor_type> inColor = pTexture->raw_texel<SL_ColorRGBType<inColor_type>>(srcIndex);
 
         *reinterpret_cast<SL_ColorRType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor)[0];
     }
@@ -71,13 +70,12 @@ struct SL_Blit_RGBA_to_R
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                      offset  = outIndex * stride;
-        const SL_ColorRGBAType<inColor_type> inColor = pTexture->texel<SL_ColorRGBAType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRGBAType<inColor_type> inColor = pTexture->raw_texel<SL_ColorRGBAType<inColor_type>>(srcIndex);
 
         *reinterpret_cast<SL_ColorRType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor)[0];
     }
@@ -93,13 +91,12 @@ struct SL_Blit_R_to_RG
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                    offset   = outIndex * stride;
-        const SL_ColorRType<inColor_type>  inColorR = pTexture->texel<SL_ColorRType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRType<inColor_type>  inColorR = pTexture->raw_texel<SL_ColorRType<inColor_type>>(srcIndex);
         const SL_ColorRGType<inColor_type> inColor  = SL_ColorRGType<inColor_type>{inColorR[0], (inColor_type)0};
 
         *reinterpret_cast<SL_ColorRGType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor);
@@ -111,13 +108,12 @@ struct SL_Blit_RG_to_RG
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                    offset  = outIndex * stride;
-        const SL_ColorRGType<inColor_type> inColor = pTexture->texel<SL_ColorRGType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRGType<inColor_type> inColor = pTexture->raw_texel<SL_ColorRGType<inColor_type>>(srcIndex);
 
         *reinterpret_cast<SL_ColorRGType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor);
     }
@@ -128,13 +124,12 @@ struct SL_Blit_RGB_to_RG
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                     offset     = outIndex * stride;
-        const SL_ColorRGBType<inColor_type> inColorRGB = pTexture->texel<SL_ColorRGBType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRGBType<inColor_type> inColorRGB = pTexture->raw_texel<SL_ColorRGBType<inColor_type>>(srcIndex);
         const SL_ColorRGType<inColor_type>  inColor    = ls::math::vec2_cast(inColorRGB);
 
         *reinterpret_cast<SL_ColorRGType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor);
@@ -146,13 +141,12 @@ struct SL_Blit_RGBA_to_RG
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                      offset      = outIndex * stride;
-        const SL_ColorRGBAType<inColor_type> inColorRGBA = pTexture->texel<SL_ColorRGBAType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRGBAType<inColor_type> inColorRGBA = pTexture->raw_texel<SL_ColorRGBAType<inColor_type>>(srcIndex);
         const SL_ColorRGType<inColor_type>   inColor     = ls::math::vec2_cast(inColorRGBA);
 
         *reinterpret_cast<SL_ColorRGType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor);
@@ -169,13 +163,12 @@ struct SL_Blit_R_to_RGB
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                     offset   = outIndex * stride;
-        const SL_ColorRType<inColor_type>   inColorR = pTexture->texel<SL_ColorRType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRType<inColor_type>   inColorR = pTexture->raw_texel<SL_ColorRType<inColor_type>>(srcIndex);
         const SL_ColorRGBType<inColor_type> inColor  = SL_ColorRGBType<inColor_type>{(inColor_type)0, (inColor_type)0, inColorR[0]};
 
         *reinterpret_cast<SL_ColorRGBType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor);
@@ -187,13 +180,12 @@ struct SL_Blit_RG_to_RGB
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                     offset    = outIndex * stride;
-        const SL_ColorRGType<inColor_type>  inColorRG = pTexture->texel<SL_ColorRGType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRGType<inColor_type>  inColorRG = pTexture->raw_texel<SL_ColorRGType<inColor_type>>(srcIndex);
         const SL_ColorRGBType<inColor_type> inColor   = ls::math::vec3_cast(inColorRG, (inColor_type)0);
 
         *reinterpret_cast<SL_ColorRGBType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor);
@@ -205,13 +197,12 @@ struct SL_Blit_RGB_to_RGB
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                     offset  = outIndex * stride;
-        const SL_ColorRGBType<inColor_type> inColor = pTexture->texel<SL_ColorRGBType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRGBType<inColor_type> inColor = pTexture->raw_texel<SL_ColorRGBType<inColor_type>>(srcIndex);
 
         *reinterpret_cast<SL_ColorRGBType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor);
     }
@@ -222,13 +213,12 @@ struct SL_Blit_RGBA_to_RGB
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                      offset      = outIndex * stride;
-        const SL_ColorRGBAType<inColor_type> inColorRGBA = pTexture->texel<SL_ColorRGBAType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRGBAType<inColor_type> inColorRGBA = pTexture->raw_texel<SL_ColorRGBAType<inColor_type>>(srcIndex);
         const SL_ColorRGBType<inColor_type>  inColor     = ls::math::vec3_cast(inColorRGBA);
 
         *reinterpret_cast<SL_ColorRGBType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor);
@@ -245,13 +235,12 @@ struct SL_Blit_R_to_RGBA
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                      offset   = outIndex * stride;
-        const SL_ColorRType<inColor_type>    inColorR = pTexture->texel<SL_ColorRType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRType<inColor_type>    inColorR = pTexture->raw_texel<SL_ColorRType<inColor_type>>(srcIndex);
         const SL_ColorRGBAType<inColor_type> inColor  = SL_ColorRGBAType<inColor_type>{(inColor_type)0, (inColor_type)0, inColorR[0], (inColor_type)1};
 
         *reinterpret_cast<SL_ColorRGBAType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor);
@@ -263,13 +252,12 @@ struct SL_Blit_RG_to_RGBA
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                      offset    = outIndex * stride;
-        const SL_ColorRGType<inColor_type>   inColorRG = pTexture->texel<SL_ColorRGType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRGType<inColor_type>   inColorRG = pTexture->raw_texel<SL_ColorRGType<inColor_type>>(srcIndex);
         const SL_ColorRGBAType<inColor_type> inColor   = ls::math::vec4_cast((inColor_type)0, inColorRG, (inColor_type)1);
 
         *reinterpret_cast<SL_ColorRGBAType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor);
@@ -281,13 +269,12 @@ struct SL_Blit_RGB_to_RGBA
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                      offset     = outIndex * stride;
-        const SL_ColorRGBType<inColor_type>  inColorRGB = pTexture->texel<SL_ColorRGBType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRGBType<inColor_type>  inColorRGB = pTexture->raw_texel<SL_ColorRGBType<inColor_type>>(srcIndex);
         const SL_ColorRGBAType<inColor_type> inColor    = ls::math::vec4_cast(inColorRGB, (inColor_type)1);
 
         *reinterpret_cast<SL_ColorRGBAType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor);
@@ -299,13 +286,12 @@ struct SL_Blit_RGBA_to_RGBA
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                      offset = outIndex * stride;
-        const SL_ColorRGBAType<inColor_type> inColor = pTexture->texel<SL_ColorRGBAType<inColor_type>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRGBAType<inColor_type> inColor = pTexture->raw_texel<SL_ColorRGBAType<inColor_type>>(srcIndex);
 
         *reinterpret_cast<SL_ColorRGBAType<outColor_type>*>(pOutBuf + offset) = color_cast<outColor_type, inColor_type>(inColor);
     }
@@ -313,6 +299,128 @@ struct SL_Blit_RGBA_to_RGBA
 
 
 
+/*-------------------------------------
+ * Load half-float texels for blitting
+-------------------------------------*/
+template<unsigned inChannels>
+struct SL_BlitHalfLoader
+{
+    struct InTexel
+    {
+        ls::math::half c[inChannels];
+    };
+
+    static constexpr unsigned num_components() noexcept { return inChannels; }
+
+    inline LS_INLINE ls::math::vec4 operator()(const SL_Texture* pTexture, ptrdiff_t index) const noexcept
+    {
+        return sl_load_half_color<inChannels>(reinterpret_cast<const InTexel*>(pTexture->data())[index].c);
+    }
+};
+
+
+
+/*-------------------------------------
+ * Load floating-point texels for blitting
+-------------------------------------*/
+template<unsigned inChannels>
+struct SL_BlitFloatLoader
+{
+    struct InTexel
+    {
+        float c[inChannels];
+    };
+
+    static constexpr unsigned num_components() noexcept { return inChannels; }
+
+    inline LS_INLINE ls::math::vec4 operator()(const SL_Texture* pTexture, ptrdiff_t index) const noexcept
+    {
+        const InTexel* const pIn = reinterpret_cast<const InTexel*>(pTexture->data()) + index;
+
+        // Indices are relative to inChannels so both branches stay in bounds
+        if (inChannels == 4)
+        {
+            return ls::math::vec4{pIn->c[0], pIn->c[1], pIn->c[inChannels-2], pIn->c[inChannels-1]};
+        }
+
+        return ls::math::vec4{pIn->c[0], pIn->c[1], pIn->c[inChannels-1], 1.f};
+    }
+};
+
+
+
+/*-------------------------------------
+ * Load packed texels for blitting
+-------------------------------------*/
+template<class packed_color>
+struct SL_BlitPackedLoader
+{
+    static constexpr unsigned num_components() noexcept { return packed_color::num_components(); }
+
+    inline LS_INLINE ls::math::vec4 operator()(const SL_Texture* pTexture, ptrdiff_t index) const noexcept
+    {
+        return packed_color::unpack(pTexture->raw_texel<typename packed_color::packed_type>(index));
+    }
+};
+
+
+
+/*-------------------------------------
+ * Recolor from texels which must be unpacked to floats
+ *
+ * Channels are arranged the same way as the other recoloring operations. HDR
+ * values are clamped when written to an integer buffer.
+-------------------------------------*/
+template<class TexelLoader, unsigned outChannels, typename outColor_type, ptrdiff_t stride = sizeof(outColor_type) * outChannels>
+struct SL_Blit_Unpacked
+{
+    inline LS_INLINE void operator()(
+        const SL_Texture* pTexture,
+        const ptrdiff_t srcIndex,
+        unsigned char* const pOutBuf,
+        uint_fast32_t outIndex) const noexcept
+    {
+        constexpr TexelLoader loader;
+        constexpr unsigned    inChannels = TexelLoader::num_components();
+
+        const ptrdiff_t      offset  = outIndex * stride;
+        const ls::math::vec4 inColor = loader(pTexture, srcIndex);
+        ls::math::vec4       c;
+
+        if (inChannels == 1 && outChannels >= 3)
+        {
+            c = ls::math::vec4{0.f, 0.f, inColor[0], 1.f};
+        }
+        else if (inChannels == 2 && outChannels == 4)
+        {
+            c = ls::math::vec4{0.f, inColor[0], inColor[1], 1.f};
+        }
+        else if (inChannels == 3)
+        {
+            c = ls::math::vec4{inColor[0], inColor[1], inColor[2], 1.f};
+        }
+        else
+        {
+            c = inColor;
+        }
+
+        if (ls::setup::IsIntegral<outColor_type>::value)
+        {
+            c = ls::math::clamp(c, ls::math::vec4{0.f}, ls::math::vec4{1.f});
+        }
+
+        const SL_ColorRGBAType<outColor_type>&& outColor = color_cast<outColor_type, float>(c);
+        outColor_type* const pOut = reinterpret_cast<outColor_type*>(pOutBuf + offset);
+
+        for (unsigned i = 0; i < outChannels; ++i)
+        {
+            pOut[i] = outColor[i];
+        }
+    }
+};
+
+
+
 // I spent enough time on blitting... Here, I'm only optimizing for the most
 // common blit operations, from RGBAf & RGBA8 to RGBA8
 template<>
@@ -320,13 +428,12 @@ struct SL_Blit_RGBA_to_RGBA<uint8_t, uint8_t, sizeof(SL_ColorRGBAType<uint8_t>)>
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t offset = outIndex * sizeof(SL_ColorRGBAType<uint8_t>);
-        const int32_t   inColor = pTexture->texel<int32_t>((uint16_t)srcX, (uint16_t)srcY);
+        const int32_t   inColor = pTexture->raw_texel<int32_t>(srcIndex);
 
         //_mm_stream_s32(reinterpret_cast<int32_t*>(pOutBuf + offset), inColor);
         *reinterpret_cast<int32_t*>(pOutBuf + offset) = inColor;
@@ -340,13 +447,12 @@ struct SL_Blit_RGBA_to_RGBA<float, uint8_t, sizeof(SL_ColorRGBAType<uint8_t>)>
 {
     inline LS_INLINE void operator()(
         const SL_Texture* pTexture,
-        const uint_fast32_t srcX,
-        const uint_fast32_t srcY,
+        const ptrdiff_t srcIndex,
         unsigned char* const pOutBuf,
         uint_fast32_t outIndex) const noexcept
     {
         const ptrdiff_t                 offset = outIndex * sizeof(SL_ColorRGBAType<uint8_t>);
-        const SL_ColorRGBAType<float>   inColor = pTexture->texel<SL_ColorRGBAType<float>>((uint16_t)srcX, (uint16_t)srcY);
+        const SL_ColorRGBAType<float>   inColor = pTexture->raw_texel<SL_ColorRGBAType<float>>(srcIndex);
         const SL_ColorRGBAType<uint8_t> in = color_cast<uint8_t, float>(inColor);
 
         //_mm_stream_si32(reinterpret_cast<int32_t*>(pOutBuf + offset), reinterpret_cast<const int32_t&>(in));
@@ -356,6 +462,41 @@ struct SL_Blit_RGBA_to_RGBA<float, uint8_t, sizeof(SL_ColorRGBAType<uint8_t>)>
 
 
 
+/*-------------------------------------
+ * Tone map HDR texels into an 8-bit RGBA buffer
+ *
+ * Exposure, tone mapping, and display encoding are all applied to a single
+ * vec4 before it's written, so the HDR image is only read once.
+-------------------------------------*/
+template<class TexelLoader, class ToneMapOp, class Encoder>
+struct SL_Blit_ToneMapped
+{
+    ls::math::vec4 exposure;
+    const uint8_t* pGammaLut;
+
+    inline LS_INLINE void operator()(
+        const SL_Texture* pTexture,
+        const ptrdiff_t srcIndex,
+        unsigned char* const pOutBuf,
+        uint_fast32_t outIndex) const noexcept
+    {
+        constexpr TexelLoader loader;
+        constexpr ToneMapOp   toneMap;
+        constexpr Encoder     encoder;
+
+        const ptrdiff_t       offset  = outIndex * sizeof(SL_ColorRGBA8);
+        const ls::math::vec4  inColor = loader(pTexture, srcIndex);
+        ls::math::vec4&&      c       = toneMap(ls::math::max(inColor * exposure, ls::math::vec4{0.f}));
+
+        // Alpha is not tone mapped
+        c[3] = inColor[3];
+
+        *reinterpret_cast<SL_ColorRGBA8*>(pOutBuf + offset) = encoder(c, pGammaLut);
+    }
+};
+
+
+
 /**----------------------------------------------------------------------------
  * @brief The Blit Processor helps to perform texture blitting to the native
  * window backbuffer on another thread.
@@ -392,7 +533,10 @@ struct SL_BlitProcessor
     const SL_Texture* mTexture;
     SL_Texture* mBackBuffer;
 
-    // 224-288 bits total, 28-36 bytes
+    // 32-64 bits, optional
+    const SL_ToneMap* mToneMap;
+
+    // 256-352 bits total, 32-44 bytes
 
     // Blit a single R channel
     template<typename inColor_type>
@@ -410,11 +554,35 @@ struct SL_BlitProcessor
     template<typename inColor_type>
     void blit_src_rgba() noexcept;
 
+    // Blit a half-float or packed texture
+    template<class TexelLoader>
+    void blit_src_unpacked() noexcept;
+
+    // Blit an HDR texture with tone mapping
+    template<class TexelLoader>
+    void blit_src_tonemapped() noexcept;
+
+    template<class TexelLoader, class ToneMapOp>
+    void blit_tonemapped_encoded() noexcept;
+
     // Blit all 4 color components
     template<class BlitOp>
     void blit_nearest() noexcept;
 
+    template<class BlitOp>
+    void blit_nearest(const BlitOp& blitOp) noexcept;
+
+    // Source texels are addressed in the texture's native order, which is
+    // resolved once per blit rather than once per texel.
+    template<class BlitOp, SL_TexelOrder order>
+    void blit_nearest_texels(const BlitOp& blitOp) noexcept;
+
     void execute() noexcept;
+
+    // Determine if texels can be converted between two formats. Compressed
+    // textures cannot be blitted, and only uncompressed integer or floating
+    // point R, RG, RGB, and RGBA textures can be blitted into.
+    static bool is_blittable(SL_ColorDataType inType, SL_ColorDataType outType) noexcept;
 };
 
 
@@ -455,6 +623,9 @@ void SL_BlitProcessor::blit_src_r() noexcept
         case SL_COLOR_RGBA_64U:     blit_nearest<SL_Blit_R_to_RGBA<inColor_type, uint64_t>>(); break;
         case SL_COLOR_RGBA_FLOAT:   blit_nearest<SL_Blit_R_to_RGBA<inColor_type, float>>();    break;
         case SL_COLOR_RGBA_DOUBLE:  blit_nearest<SL_Blit_R_to_RGBA<inColor_type, double>>();   break;
+
+        default:
+            break;
     }
 }
 
@@ -495,6 +666,9 @@ void SL_BlitProcessor::blit_src_rg() noexcept
         case SL_COLOR_RGBA_64U:     blit_nearest<SL_Blit_RG_to_RGBA<inColor_type, uint64_t>>(); break;
         case SL_COLOR_RGBA_FLOAT:   blit_nearest<SL_Blit_RG_to_RGBA<inColor_type, float>>();    break;
         case SL_COLOR_RGBA_DOUBLE:  blit_nearest<SL_Blit_RG_to_RGBA<inColor_type, double>>();   break;
+
+        default:
+            break;
     }
 }
 
@@ -535,6 +709,9 @@ void SL_BlitProcessor::blit_src_rgb() noexcept
         case SL_COLOR_RGBA_64U:     blit_nearest<SL_Blit_RGB_to_RGBA<inColor_type, uint64_t>>(); break;
         case SL_COLOR_RGBA_FLOAT:   blit_nearest<SL_Blit_RGB_to_RGBA<inColor_type, float>>();    break;
         case SL_COLOR_RGBA_DOUBLE:  blit_nearest<SL_Blit_RGB_to_RGBA<inColor_type, double>>();   break;
+
+        default:
+            break;
     }
 }
 
@@ -575,6 +752,115 @@ void SL_BlitProcessor::blit_src_rgba() noexcept
         case SL_COLOR_RGBA_64U:     blit_nearest<SL_Blit_RGBA_to_RGBA<inColor_type, uint64_t>>(); break;
         case SL_COLOR_RGBA_FLOAT:   blit_nearest<SL_Blit_RGBA_to_RGBA<inColor_type, float>>();    break;
         case SL_COLOR_RGBA_DOUBLE:  blit_nearest<SL_Blit_RGBA_to_RGBA<inColor_type, double>>();   break;
+
+        default:
+            break;
+    }
+}
+
+
+
+/*-------------------------------------
+ * Nearest-neighbor filtering (half-float or packed colors)
+-------------------------------------*/
+template<class TexelLoader>
+void SL_BlitProcessor::blit_src_unpacked() noexcept
+{
+    switch (mBackBuffer->type())
+    {
+        case SL_COLOR_R_8U:         blit_nearest<SL_Blit_Unpacked<TexelLoader, 1, uint8_t>>();  break;
+        case SL_COLOR_R_16U:        blit_nearest<SL_Blit_Unpacked<TexelLoader, 1, uint16_t>>(); break;
+        case SL_COLOR_R_32U:        blit_nearest<SL_Blit_Unpacked<TexelLoader, 1, uint32_t>>(); break;
+        case SL_COLOR_R_64U:        blit_nearest<SL_Blit_Unpacked<TexelLoader, 1, uint64_t>>(); break;
+        case SL_COLOR_R_FLOAT:      blit_nearest<SL_Blit_Unpacked<TexelLoader, 1, float>>();    break;
+        case SL_COLOR_R_DOUBLE:     blit_nearest<SL_Blit_Unpacked<TexelLoader, 1, double>>();   break;
+
+        case SL_COLOR_RG_8U:        blit_nearest<SL_Blit_Unpacked<TexelLoader, 2, uint8_t>>();  break;
+        case SL_COLOR_RG_16U:       blit_nearest<SL_Blit_Unpacked<TexelLoader, 2, uint16_t>>(); break;
+        case SL_COLOR_RG_32U:       blit_nearest<SL_Blit_Unpacked<TexelLoader, 2, uint32_t>>(); break;
+        case SL_COLOR_RG_64U:       blit_nearest<SL_Blit_Unpacked<TexelLoader, 2, uint64_t>>(); break;
+        case SL_COLOR_RG_FLOAT:     blit_nearest<SL_Blit_Unpacked<TexelLoader, 2, float>>();    break;
+        case SL_COLOR_RG_DOUBLE:    blit_nearest<SL_Blit_Unpacked<TexelLoader, 2, double>>();   break;
+
+        case SL_COLOR_RGB_8U:       blit_nearest<SL_Blit_Unpacked<TexelLoader, 3, uint8_t>>();  break;
+        case SL_COLOR_RGB_16U:      blit_nearest<SL_Blit_Unpacked<TexelLoader, 3, uint16_t>>(); break;
+        case SL_COLOR_RGB_32U:      blit_nearest<SL_Blit_Unpacked<TexelLoader, 3, uint32_t>>(); break;
+        case SL_COLOR_RGB_64U:      blit_nearest<SL_Blit_Unpacked<TexelLoader, 3, uint64_t>>(); break;
+        case SL_COLOR_RGB_FLOAT:    blit_nearest<SL_Blit_Unpacked<TexelLoader, 3, float>>();    break;
+        case SL_COLOR_RGB_DOUBLE:   blit_nearest<SL_Blit_Unpacked<TexelLoader, 3, double>>();   break;
+
+        case SL_COLOR_RGBA_8U:      blit_nearest<SL_Blit_Unpacked<TexelLoader, 4, uint8_t>>();  break;
+        case SL_COLOR_RGBA_16U:     blit_nearest<SL_Blit_Unpacked<TexelLoader, 4, uint16_t>>(); break;
+        case SL_COLOR_RGBA_32U:     blit_nearest<SL_Blit_Unpacked<TexelLoader, 4, uint32_t>>(); break;
+        case SL_COLOR_RGBA_64U:     blit_nearest<SL_Blit_Unpacked<TexelLoader, 4, uint64_t>>(); break;
+        case SL_COLOR_RGBA_FLOAT:   blit_nearest<SL_Blit_Unpacked<TexelLoader, 4, float>>();    break;
+        case SL_COLOR_RGBA_DOUBLE:  blit_nearest<SL_Blit_Unpacked<TexelLoader, 4, double>>();   break;
+
+        default:
+            break;
+    }
+}
+
+
+
+/*-------------------------------------
+ * Nearest-neighbor filtering (tone mapped)
+-------------------------------------*/
+template<class TexelLoader>
+void SL_BlitProcessor::blit_src_tonemapped() noexcept
+{
+    // Only 8-bit display buffers are tone mapped
+    if (mBackBuffer->type() != SL_COLOR_RGBA_8U)
+    {
+        blit_src_unpacked<TexelLoader>();
+        return;
+    }
+
+    switch (mToneMap->op)
+    {
+        case SL_TONE_MAP_CLAMP:    blit_tonemapped_encoded<TexelLoader, SL_ToneMapOpClamp>();    break;
+        case SL_TONE_MAP_REINHARD: blit_tonemapped_encoded<TexelLoader, SL_ToneMapOpReinhard>(); break;
+        case SL_TONE_MAP_ACES:     blit_tonemapped_encoded<TexelLoader, SL_ToneMapOpACES>();     break;
+
+        default:
+            break;
+    }
+}
+
+
+
+template<class TexelLoader, class ToneMapOp>
+void SL_BlitProcessor::blit_tonemapped_encoded() noexcept
+{
+    const float exposure = mToneMap->exposure;
+    const float invGamma = (mToneMap->gamma > 0.f) ? ls::math::rcp(mToneMap->gamma) : 1.f;
+    const ls::math::vec4 exposure4{exposure, exposure, exposure, 1.f};
+
+    // A gamma of 1 is linear and doesn't need a table
+    const SL_ToneMapEncoding encoding = (mToneMap->encoding == SL_TONE_MAP_ENCODE_GAMMA && invGamma == 1.f)
+        ? SL_TONE_MAP_ENCODE_LINEAR
+        : mToneMap->encoding;
+
+    switch (encoding)
+    {
+        case SL_TONE_MAP_ENCODE_LINEAR:
+            blit_nearest(SL_Blit_ToneMapped<TexelLoader, ToneMapOp, SL_ToneMapEncodeLinear>{exposure4, nullptr});
+            break;
+
+        case SL_TONE_MAP_ENCODE_GAMMA:
+        {
+            uint8_t gammaLut[SL_SRGB_ENCODE_LUT_SIZE];
+            sl_make_gamma_lut(invGamma, gammaLut);
+            blit_nearest(SL_Blit_ToneMapped<TexelLoader, ToneMapOp, SL_ToneMapEncodeGamma>{exposure4, gammaLut});
+            break;
+        }
+
+        case SL_TONE_MAP_ENCODE_SRGB:
+            blit_nearest(SL_Blit_ToneMapped<TexelLoader, ToneMapOp, SL_ToneMapEncodeSRGB>{exposure4, nullptr});
+            break;
+
+        default:
+            break;
     }
 }
 
@@ -606,6 +892,18 @@ void SL_BlitProcessor::blit_src_rgba() noexcept
     extern template void SL_BlitProcessor::blit_src_rgba<uint64_t>();
     extern template void SL_BlitProcessor::blit_src_rgba<float>();
     extern template void SL_BlitProcessor::blit_src_rgba<double>();
+    extern template void SL_BlitProcessor::blit_src_unpacked<SL_BlitHalfLoader<1>>();
+    extern template void SL_BlitProcessor::blit_src_unpacked<SL_BlitHalfLoader<2>>();
+    extern template void SL_BlitProcessor::blit_src_unpacked<SL_BlitHalfLoader<3>>();
+    extern template void SL_BlitProcessor::blit_src_unpacked<SL_BlitHalfLoader<4>>();
+    extern template void SL_BlitProcessor::blit_src_unpacked<SL_BlitPackedLoader<SL_PackedColorRGB565>>();
+    extern template void SL_BlitProcessor::blit_src_unpacked<SL_BlitPackedLoader<SL_PackedColorRGB10A2>>();
+    extern template void SL_BlitProcessor::blit_src_unpacked<SL_BlitPackedLoader<SL_PackedColorR11G11B10F>>();
+    extern template void SL_BlitProcessor::blit_src_tonemapped<SL_BlitHalfLoader<3>>();
+    extern template void SL_BlitProcessor::blit_src_tonemapped<SL_BlitHalfLoader<4>>();
+    extern template void SL_BlitProcessor::blit_src_tonemapped<SL_BlitFloatLoader<3>>();
+    extern template void SL_BlitProcessor::blit_src_tonemapped<SL_BlitFloatLoader<4>>();
+    extern template void SL_BlitProcessor::blit_src_tonemapped<SL_BlitPackedLoader<SL_PackedColorR11G11B10F>>();
 #endif
 
 
@@ -617,11 +915,41 @@ template<class BlipOp>
 void SL_BlitProcessor::blit_nearest() noexcept
 {
     constexpr BlipOp blitOp;
+    blit_nearest<BlipOp>(blitOp);
+}
+
+
+
+/*-------------------------------------
+ * Nearest-neighbor filtering (stateful blit operations)
+-------------------------------------*/
+template<class BlipOp>
+void SL_BlitProcessor::blit_nearest(const BlipOp& blitOp) noexcept
+{
+    if (mTexture->texel_order() == SL_TexelOrder::SL_TEXELS_SWIZZLED)
+    {
+        blit_nearest_texels<BlipOp, SL_TexelOrder::SL_TEXELS_SWIZZLED>(blitOp);
+    }
+    else
+    {
+        blit_nearest_texels<BlipOp, SL_TexelOrder::SL_TEXELS_ORDERED>(blitOp);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Nearest-neighbor filtering (known texel order)
+-------------------------------------*/
+template<class BlipOp, SL_TexelOrder order>
+void SL_BlitProcessor::blit_nearest_texels(const BlipOp& blitOp) noexcept
+{
     unsigned char* const pOutBuf = reinterpret_cast<unsigned char* const>(mBackBuffer->data());
 
     const uint_fast32_t inW  = (uint_fast32_t)srcX1 - (uint_fast32_t)srcX0;
     const uint_fast32_t inH  = (uint_fast32_t)srcY1 - (uint_fast32_t)srcY0;
     const uint_fast32_t outW = (uint_fast32_t)dstX1 - (uint_fast32_t)dstX0;
+    const uint_fast32_t outH = (uint_fast32_t)dstY1 - (uint_fast32_t)dstY0;
 
     const uint_fast32_t totalOutW = mBackBuffer->width();
     const uint_fast32_t totalOutH = mBackBuffer->height();
@@ -631,25 +959,28 @@ void SL_BlitProcessor::blit_nearest() noexcept
     const uint_fast32_t x0        = ls::math::max<uint_fast32_t>(0u, dstX0);
     const uint_fast32_t x1        = ls::math::min<uint_fast32_t>(totalOutW, x0 + outW);
     const uint_fast32_t y0        = dstY0+mThreadId;
-    const uint_fast32_t y1        = dstY1;
+    const uint_fast32_t y1        = ls::math::min<uint_fast32_t>(totalOutH, dstY1);
 
+    // Scale relative to the destination rectangle so sub-regions (i.e.
+    // damaged areas) map onto the same source texels as a full blit.
     const sl_fixed_type finW      = ls::math::fixed_cast<sl_fixed_type>(inW);
     const sl_fixed_type finH      = ls::math::fixed_cast<sl_fixed_type>(inH);
-    const sl_fixed_type foutW     = finW / ls::math::fixed_cast<sl_fixed_type>(totalOutW);
-    const sl_fixed_type foutH     = finH / ls::math::fixed_cast<sl_fixed_type>(totalOutH);
+    const sl_fixed_type foutW     = finW / ls::math::fixed_cast<sl_fixed_type>(outW);
+    const sl_fixed_type foutH     = finH / ls::math::fixed_cast<sl_fixed_type>(outH);
 
     for (uint_fast32_t y = y0; y < y1; y += mNumThreads)
     {
-        const sl_fixed_type yf   = ls::math::fixed_cast<sl_fixed_type>(y) * foutH;
-        const uint_fast32_t srcY = srcY1 - (srcY0 + ls::math::integer_cast<uint_fast32_t>(yf)) - 1;
+        const sl_fixed_type yf   = ls::math::fixed_cast<sl_fixed_type>(y - dstY0) * foutH;
+        const uint_fast32_t srcY = srcY1 - ls::math::integer_cast<uint_fast32_t>(yf) - 1;
 
         for (uint_fast32_t x = x0; x < x1; ++x)
         {
-            const sl_fixed_type  xf       = ls::math::fixed_cast<sl_fixed_type>(x) * foutW;
+            const sl_fixed_type  xf       = ls::math::fixed_cast<sl_fixed_type>(x - dstX0) * foutW;
             const uint_fast32_t  srcX     = srcX0 + ls::math::integer_cast<uint_fast32_t>(xf);
             const uint_fast32_t  outIndex = x + totalOutW * y;
+            const ptrdiff_t      srcIndex = mTexture->map_coordinate<order>(srcX, srcY);
 
-            blitOp(mTexture, srcX, srcY, pOutBuf, outIndex);
+            blitOp(mTexture, srcIndex, pOutBuf, outIndex);
         }
     }
 }
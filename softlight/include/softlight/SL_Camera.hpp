@@ -60,6 +60,44 @@ bool sl_is_visible(const SL_BoundingBox& bb, const ls::math::mat4& mvMatrix, con
 
 
 
+/**
+ * @brief Extract the side planes of a rectangular sub-region of a view
+ * frustum, such as a screen tile or light cluster.
+ *
+ * @param projection
+ * The projection matrix which generated the full view frustum.
+ *
+ * @param ndcRect
+ * The normalized device coordinates of the sub-region, stored as
+ * {left, bottom, right, top}.
+ *
+ * @param planes
+ * Output array for the left, right, bottom, and top planes, respectively.
+ * Each plane is normalized and faces inward, in view-space.
+ */
+void sl_extract_subfrustum_planes(const ls::math::mat4& projection, const ls::math::vec4& ndcRect, ls::math::vec4 planes[4]) noexcept;
+
+
+
+/**
+ * @brief Convert a post-projection depth value (such as
+ * SL_FragCoordXYZ::depth) back into a view-space Z coordinate.
+ *
+ * @param projection
+ * The projection matrix used to render the depth value.
+ *
+ * @param ndcDepth
+ * The depth of a fragment after perspective division.
+ *
+ * @return The view-space Z coordinate of the fragment.
+ */
+inline float sl_view_depth_from_ndc(const ls::math::mat4& projection, float ndcDepth) noexcept
+{
+    return (projection[3][2] - ndcDepth * projection[3][3]) / (ndcDepth * projection[2][3] - projection[2][2]);
+}
+
+
+
 /**
  * Determine if a point is contained within a frustum.
  * 
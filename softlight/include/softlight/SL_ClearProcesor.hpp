@@ -8,9 +8,16 @@
 
 
 
+class SL_DamageRegion;
+
+
+
 /**----------------------------------------------------------------------------
  * @brief The Clear Processor helps to assign all texels in a texture to a
  * single color. This helps distribute color clearing across multiple threads.
+ *
+ * When a region is provided, only the texels within its rectangles are
+ * cleared.
 -----------------------------------------------------------------------------*/
 struct SL_ClearProcessor
 {
@@ -20,16 +27,24 @@ struct SL_ClearProcessor
     uint16_t mThreadId;
     uint16_t mNumThreads;
 
-    // 64-128 bits
+    // 96-192 bits
     const void* mTexture;
     SL_Texture* mBackBuffer;
+    const SL_DamageRegion* mRegion;
 
-    // 96-160 bits total, 12-20 bytes
+    // 128-224 bits total, 16-28 bytes
 
     // clear all 4 color components
     template<typename color_type>
     void clear_texture(const color_type& inColor) noexcept;
 
+    // clear only the texels within mRegion
+    template<typename color_type>
+    void clear_region(const color_type& inColor) noexcept;
+
+    template<typename color_type>
+    void clear(const color_type& inColor) noexcept;
+
     void execute() noexcept;
 };
 
@@ -51,12 +66,14 @@ extern template void SL_ClearProcessor::clear_texture<SL_ColorRType<uint8_t>>(co
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRType<uint16_t>>(const SL_ColorRType<uint16_t>&) noexcept;
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRType<uint32_t>>(const SL_ColorRType<uint32_t>&) noexcept;
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRType<uint64_t>>(const SL_ColorRType<uint64_t>&) noexcept;
+extern template void SL_ClearProcessor::clear_texture<SL_ColorRType<ls::math::half>>(const SL_ColorRType<ls::math::half>&) noexcept;
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRType<double>>(const SL_ColorRType<double>&) noexcept;
 
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRGType<uint8_t>>(const SL_ColorRGType<uint8_t>&) noexcept;
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRGType<uint16_t>>(const SL_ColorRGType<uint16_t>&) noexcept;
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRGType<uint32_t>>(const SL_ColorRGType<uint32_t>&) noexcept;
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRGType<uint64_t>>(const SL_ColorRGType<uint64_t>&) noexcept;
+extern template void SL_ClearProcessor::clear_texture<SL_ColorRGType<ls::math::half>>(const SL_ColorRGType<ls::math::half>&) noexcept;
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRGType<float>>(const SL_ColorRGType<float>&) noexcept;
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRGType<double>>(const SL_ColorRGType<double>&) noexcept;
 
@@ -64,11 +81,13 @@ extern template void SL_ClearProcessor::clear_texture<SL_ColorRGBType<uint8_t>>(
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRGBType<uint16_t>>(const SL_ColorRGBType<uint16_t>&) noexcept;
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRGBType<uint32_t>>(const SL_ColorRGBType<uint32_t>&) noexcept;
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRGBType<uint64_t>>(const SL_ColorRGBType<uint64_t>&) noexcept;
+extern template void SL_ClearProcessor::clear_texture<SL_ColorRGBType<ls::math::half>>(const SL_ColorRGBType<ls::math::half>&) noexcept;
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRGBType<float>>(const SL_ColorRGBType<float>&) noexcept;
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRGBType<double>>(const SL_ColorRGBType<double>&) noexcept;
 
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRGBAType<uint16_t>>(const SL_ColorRGBAType<uint16_t>&) noexcept;
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRGBAType<uint64_t>>(const SL_ColorRGBAType<uint64_t>&) noexcept;
+extern template void SL_ClearProcessor::clear_texture<SL_ColorRGBAType<ls::math::half>>(const SL_ColorRGBAType<ls::math::half>&) noexcept;
 extern template void SL_ClearProcessor::clear_texture<SL_ColorRGBAType<double>>(const SL_ColorRGBAType<double>&) noexcept;
 
 
@@ -3,7 +3,9 @@
 #define SL_COLOR_TYPE_HPP
 
 #include "lightsky/setup/Api.h"
+#include "lightsky/setup/Arch.h"
 #include "lightsky/setup/Compiler.h"
+#include "lightsky/setup/Macros.h" // LS_INLINE
 
 // Microsoft imposing its will on us inferior programmers
 #ifdef LS_COMPILER_MSC
@@ -20,6 +22,7 @@
 #include <cstdint> // fixed-width types
 #include <limits> // c++ limits
 
+#include "lightsky/math/half.h"
 #include "lightsky/math/scalar_utils.h"
 #include "lightsky/math/vec2.h"
 #include "lightsky/math/vec3.h"
@@ -60,19 +63,68 @@ enum SL_ColorDataType : uint16_t
     SL_COLOR_RGBA_FLOAT,
     SL_COLOR_RGBA_DOUBLE,
 
-    SL_COLOR_RGB_DEFAULT = SL_COLOR_RGB_8U,
-    SL_COLOR_INVALID
+    // Block-compressed formats. Texels are stored in 4x4 blocks and can only
+    // be read through the samplers in SL_Sampler.hpp.
+    SL_COLOR_BC1_RGBA,
+    SL_COLOR_BC3_RGBA,
+    SL_COLOR_BC4_R,
+    SL_COLOR_BC5_RG,
+
+    // Packed formats. Each texel is stored in a single integer and can be
+    // converted using the types in SL_PackedColor.hpp.
+    SL_COLOR_RGB_565,
+    SL_COLOR_RGB10_A2,
+    SL_COLOR_R11G11B10_FLOAT,
+
+    // 8-bit sRGB formats. Color channels are decoded into linear space when
+    // sampled and encoded when written, using the tables in SL_ColorSRGB.hpp.
+    // Alpha is always linear.
+    SL_COLOR_SRGB_8U,
+    SL_COLOR_SRGBA_8U,
+
+    // Half-float formats. Channels are converted to and from floats using
+    // sl_load_half_color() and sl_store_half_color().
+    SL_COLOR_R_HALF,
+    SL_COLOR_RG_HALF,
+    SL_COLOR_RGB_HALF,
+    SL_COLOR_RGBA_HALF,
+
+    // Must follow every color type so range checks exclude only this value
+    SL_COLOR_INVALID,
+
+    SL_COLOR_RGB_DEFAULT = SL_COLOR_RGB_8U
 };
 
 
 
 /*-------------------------------------
- * Number of bytes per color
+ * Number of bytes per color (or per 4x4 block for compressed formats)
 -------------------------------------*/
 size_t sl_bytes_per_color(SL_ColorDataType p);
 
 
 
+/*-------------------------------------
+ * Check if a color type is block-compressed
+-------------------------------------*/
+bool sl_is_compressed_color(SL_ColorDataType p);
+
+
+
+/*-------------------------------------
+ * Check if a color type is packed into a single integer
+-------------------------------------*/
+bool sl_is_packed_color(SL_ColorDataType p);
+
+
+
+/*-------------------------------------
+ * Check if a color type is stored in sRGB space
+-------------------------------------*/
+bool sl_is_srgb_color(SL_ColorDataType p);
+
+
+
 /*-------------------------------------
  * Number of elements per color
 -------------------------------------*/
@@ -230,6 +282,7 @@ typedef SL_ColorRType<uint8_t>  SL_ColorR8;
 typedef SL_ColorRType<uint16_t> SL_ColorR16;
 typedef SL_ColorRType<uint32_t> SL_ColorR32;
 typedef SL_ColorRType<uint64_t> SL_ColorR64;
+typedef SL_ColorRType<ls::math::half> SL_ColorRh;
 typedef SL_ColorRType<float>    SL_ColorRf;
 typedef SL_ColorRType<double>   SL_ColorRd;
 
@@ -329,6 +382,7 @@ typedef SL_ColorRGType<uint8_t>  SL_ColorRG8;
 typedef SL_ColorRGType<uint16_t> SL_ColorRG16;
 typedef SL_ColorRGType<uint32_t> SL_ColorRG32;
 typedef SL_ColorRGType<uint64_t> SL_ColorRG64;
+typedef SL_ColorRGType<ls::math::half> SL_ColorRGh;
 typedef SL_ColorRGType<float>    SL_ColorRGf;
 typedef SL_ColorRGType<double>   SL_ColorRGd;
 
@@ -422,6 +476,7 @@ typedef SL_ColorRGBType<uint8_t>  SL_ColorRGB8;
 typedef SL_ColorRGBType<uint16_t> SL_ColorRGB16;
 typedef SL_ColorRGBType<uint32_t> SL_ColorRGB32;
 typedef SL_ColorRGBType<uint64_t> SL_ColorRGB64;
+typedef SL_ColorRGBType<ls::math::half> SL_ColorRGBh;
 typedef SL_ColorRGBType<float>    SL_ColorRGBf;
 typedef SL_ColorRGBType<double>   SL_ColorRGBd;
 
@@ -515,6 +570,7 @@ typedef SL_ColorRGBAType<uint8_t>  SL_ColorRGBA8;
 typedef SL_ColorRGBAType<uint16_t> SL_ColorRGBA16;
 typedef SL_ColorRGBAType<uint32_t> SL_ColorRGBA32;
 typedef SL_ColorRGBAType<uint64_t> SL_ColorRGBA64;
+typedef SL_ColorRGBAType<ls::math::half> SL_ColorRGBAh;
 typedef SL_ColorRGBAType<float>    SL_ColorRGBAf;
 typedef SL_ColorRGBAType<double>   SL_ColorRGBAd;
 
@@ -607,6 +663,7 @@ struct SL_GeneralColor
         SL_ColorRType<uint16_t> r16;
         SL_ColorRType<uint32_t> r32;
         SL_ColorRType<uint64_t> r64;
+        SL_ColorRType<ls::math::half> rh;
         SL_ColorRType<float> rf;
         SL_ColorRType<double> rd;
 
@@ -614,6 +671,7 @@ struct SL_GeneralColor
         ls::math::vec2_t<uint16_t> rg16;
         ls::math::vec2_t<uint32_t> rg32;
         ls::math::vec2_t<uint64_t> rg64;
+        ls::math::vec2_t<ls::math::half> rgh;
         ls::math::vec2_t<float> rgf;
         ls::math::vec2_t<double> rgd;
 
@@ -621,6 +679,7 @@ struct SL_GeneralColor
         ls::math::vec3_t<uint16_t> rgb16;
         ls::math::vec3_t<uint32_t> rgb32;
         ls::math::vec3_t<uint64_t> rgb64;
+        ls::math::vec3_t<ls::math::half> rgbh;
         ls::math::vec3_t<float> rgbf;
         ls::math::vec3_t<double> rgbd;
 
@@ -628,8 +687,13 @@ struct SL_GeneralColor
         ls::math::vec4_t<uint16_t> rgba16;
         ls::math::vec4_t<uint32_t> rgba32;
         ls::math::vec4_t<uint64_t> rgba64;
+        ls::math::vec4_t<ls::math::half> rgbah;
         ls::math::vec4_t<float> rgbaf;
         ls::math::vec4_t<double> rgbad;
+
+        uint16_t rgb565;
+        uint32_t rgb10a2;
+        uint32_t r11g11b10f;
     } color;
 };
 
@@ -666,6 +730,94 @@ extern template SL_GeneralColor sl_match_color_for_type<ls::math::vec4_t<double>
 
 
 
+/*-----------------------------------------------------------------------------
+ * Half-Float Conversion
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Load half-float channels into a vec4. Unused channels are set to 0.
+ *
+ * F16C and NEON convert all 4 channels at once. Colors with fewer channels
+ * are padded first so the conversion never reads past the end of a texel.
+-------------------------------------*/
+template <unsigned num_channels>
+inline LS_INLINE ls::math::vec4 sl_load_half_color(const ls::math::half* pColor) noexcept
+{
+    static_assert(num_channels >= 1 && num_channels <= 4, "Half-float colors must have 1-4 channels.");
+
+    #if defined(LS_X86_FP16) || defined(LS_ARM_NEON)
+        const ls::math::half  zero{0x00u, 0x00u};
+        ls::math::half        padded[4] = {zero, zero, zero, zero};
+        const ls::math::half* pTexel = pColor;
+
+        if (num_channels < 4)
+        {
+            for (unsigned i = 0; i < num_channels; ++i)
+            {
+                padded[i] = pColor[i];
+            }
+
+            pTexel = padded;
+        }
+
+        #if defined(LS_X86_FP16)
+            return ls::math::vec4{_mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pTexel)))};
+        #else
+            return ls::math::vec4{vcvt_f32_f16(vld1_f16(reinterpret_cast<const __fp16*>(pTexel)))};
+        #endif
+
+    #else
+        ls::math::vec4 ret{0.f};
+
+        for (unsigned i = 0; i < num_channels; ++i)
+        {
+            ret[i] = (float)pColor[i];
+        }
+
+        return ret;
+    #endif
+}
+
+
+
+/*-------------------------------------
+ * Store the first channels of a vec4 as half-floats
+ *
+ * Like sl_load_half_color(), colors with fewer than 4 channels are converted
+ * into a temporary so only the used channels are written.
+-------------------------------------*/
+template <unsigned num_channels>
+inline LS_INLINE void sl_store_half_color(ls::math::half* pColor, const ls::math::vec4& c) noexcept
+{
+    static_assert(num_channels >= 1 && num_channels <= 4, "Half-float colors must have 1-4 channels.");
+
+    #if defined(LS_X86_FP16) || defined(LS_ARM_NEON)
+        ls::math::half  padded[4];
+        ls::math::half* pTexel = (num_channels < 4) ? padded : pColor;
+
+        #if defined(LS_X86_FP16)
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(pTexel), _mm_cvtps_ph(c.simd, _MM_FROUND_TO_NEAREST_INT));
+        #else
+            vst1_f16(reinterpret_cast<__fp16*>(pTexel), vcvt_f16_f32(c.simd));
+        #endif
+
+        if (num_channels < 4)
+        {
+            for (unsigned i = 0; i < num_channels; ++i)
+            {
+                pColor[i] = padded[i];
+            }
+        }
+
+    #else
+        for (unsigned i = 0; i < num_channels; ++i)
+        {
+            pColor[i] = (ls::math::half)c[i];
+        }
+    #endif
+}
+
+
+
 /*-----------------------------------------------------------------------------
  * Extended Color Models
 -----------------------------------------------------------------------------*/
@@ -1143,5 +1295,70 @@ constexpr SL_ColorRGBAType<T> rgb_cast(const SL_ColorTypeYCoCgA<T>& p) noexcept
 
 
 
+/*-----------------------------------------------------------------------------
+ * Batch Color Conversion
+ *
+ * The following functions convert spans of colors at once using SSE4.1 or
+ * NEON, with a scalar loop for any remaining colors. Input and output spans
+ * must not overlap.
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Normalize 8-bit elements into the range [0, 1]. "count" is the number of
+ * elements (not colors) to convert.
+-------------------------------------*/
+void sl_convert_u8_to_float(const uint8_t* pIn, float* pOut, size_t count) noexcept;
+
+
+
+/*-------------------------------------
+ * Clamp floats to [0, 1] and round them half up to 8-bit elements. "count"
+ * is the number of elements (not colors) to convert.
+-------------------------------------*/
+void sl_convert_float_to_u8(const float* pIn, uint8_t* pOut, size_t count) noexcept;
+
+
+
+/*-------------------------------------
+ * Add an alpha channel to RGB colors
+-------------------------------------*/
+void sl_convert_rgb_to_rgba(const SL_ColorRGB8* pIn, SL_ColorRGBA8* pOut, size_t count, uint8_t alpha = 255) noexcept;
+
+void sl_convert_rgb_to_rgba(const SL_ColorRGBf* pIn, SL_ColorRGBAf* pOut, size_t count, float alpha = 1.f) noexcept;
+
+
+
+/*-------------------------------------
+ * Drop the alpha channel from RGBA colors
+-------------------------------------*/
+void sl_convert_rgba_to_rgb(const SL_ColorRGBA8* pIn, SL_ColorRGB8* pOut, size_t count) noexcept;
+
+void sl_convert_rgba_to_rgb(const SL_ColorRGBAf* pIn, SL_ColorRGBf* pOut, size_t count) noexcept;
+
+
+
+/*-------------------------------------
+ * RGB <-> HSV
+ *
+ * RGB channels are in the range [0, 1]. Hue is in degrees [0, 360], while
+ * saturation and value are in the range [0, 1].
+-------------------------------------*/
+void sl_convert_rgb_to_hsv(const SL_ColorRGBf* pIn, SL_ColorTypeHSVf* pOut, size_t count) noexcept;
+
+void sl_convert_hsv_to_rgb(const SL_ColorTypeHSVf* pIn, SL_ColorRGBf* pOut, size_t count) noexcept;
+
+
+
+/*-------------------------------------
+ * RGB <-> HSL
+ *
+ * RGB channels are in the range [0, 1]. Hue is in degrees [0, 360], while
+ * saturation and lightness are in the range [0, 1].
+-------------------------------------*/
+void sl_convert_rgb_to_hsl(const SL_ColorRGBf* pIn, SL_ColorTypeHSLf* pOut, size_t count) noexcept;
+
+void sl_convert_hsl_to_rgb(const SL_ColorTypeHSLf* pIn, SL_ColorRGBf* pOut, size_t count) noexcept;
+
+
+
 #endif /* SL_COLOR_TYPE_HPP */
 
@@ -0,0 +1,155 @@
+
+#ifndef SL_COLOR_SRGB_HPP
+#define SL_COLOR_SRGB_HPP
+
+#include <cstdint>
+
+#include "lightsky/setup/Arch.h"
+#include "lightsky/setup/Macros.h" // LS_INLINE
+
+#include "lightsky/math/vec4.h"
+#include "lightsky/math/vec_utils.h"
+
+#include "softlight/SL_Color.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * sRGB Lookup Tables
+-----------------------------------------------------------------------------*/
+enum SL_SRGBInfo : uint32_t
+{
+    // Number of linear values which can be encoded into sRGB. This provides
+    // enough precision to round-trip all 256 sRGB values.
+    SL_SRGB_ENCODE_LUT_SIZE = 4096
+};
+
+
+
+/*-------------------------------------
+ * Linear value of each 8-bit sRGB value
+-------------------------------------*/
+extern const float SL_SRGB_TO_LINEAR_LUT[256];
+
+
+
+/*-------------------------------------
+ * 8-bit sRGB value of (i / (SL_SRGB_ENCODE_LUT_SIZE-1)) in linear space
+-------------------------------------*/
+extern const uint8_t SL_LINEAR_TO_SRGB_LUT[SL_SRGB_ENCODE_LUT_SIZE];
+
+
+
+/*-----------------------------------------------------------------------------
+ * sRGB Decoding
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Decode a single sRGB channel
+-------------------------------------*/
+inline LS_INLINE float sl_srgb_to_linear(uint8_t c) noexcept
+{
+    return SL_SRGB_TO_LINEAR_LUT[c];
+}
+
+
+
+/*-------------------------------------
+ * Decode an sRGB color. Alpha is always 1.
+-------------------------------------*/
+inline LS_INLINE ls::math::vec4 sl_srgb_to_linear(const SL_ColorRGB8& c) noexcept
+{
+    return ls::math::vec4{
+        SL_SRGB_TO_LINEAR_LUT[c[0]],
+        SL_SRGB_TO_LINEAR_LUT[c[1]],
+        SL_SRGB_TO_LINEAR_LUT[c[2]],
+        1.f
+    };
+}
+
+
+
+/*-------------------------------------
+ * Decode an sRGB color. Alpha is already linear.
+-------------------------------------*/
+inline LS_INLINE ls::math::vec4 sl_srgb_to_linear(const SL_ColorRGBA8& c) noexcept
+{
+    return ls::math::vec4{
+        SL_SRGB_TO_LINEAR_LUT[c[0]],
+        SL_SRGB_TO_LINEAR_LUT[c[1]],
+        SL_SRGB_TO_LINEAR_LUT[c[2]],
+        SL_ColorU8ToF::byte_to_float(c[3])
+    };
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * sRGB Encoding
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Encode a single linear channel
+-------------------------------------*/
+inline LS_INLINE uint8_t sl_linear_to_srgb(float c) noexcept
+{
+    const float n = ls::math::clamp(c, 0.f, 1.f) * (float)(SL_SRGB_ENCODE_LUT_SIZE-1u) + 0.5f;
+    return SL_LINEAR_TO_SRGB_LUT[(unsigned)n];
+}
+
+
+
+/*-------------------------------------
+ * Encode a linear color using any table of SL_SRGB_ENCODE_LUT_SIZE 8-bit
+ * values, such as a gamma curve. Alpha is stored linearly.
+-------------------------------------*/
+inline LS_INLINE SL_ColorRGBA8 sl_linear_to_lut(const ls::math::vec4& c, const uint8_t* pLut) noexcept
+{
+    // Only the table indices are vectorized, lookups are always scalar
+    #if defined(LS_X86_SSE2)
+        const __m128 n = _mm_add_ps(
+            _mm_mul_ps(
+                _mm_min_ps(_mm_max_ps(c.simd, _mm_setzero_ps()), _mm_set1_ps(1.f)),
+                _mm_set_ps(255.f, (float)(SL_SRGB_ENCODE_LUT_SIZE-1u), (float)(SL_SRGB_ENCODE_LUT_SIZE-1u), (float)(SL_SRGB_ENCODE_LUT_SIZE-1u))),
+            _mm_set1_ps(0.5f));
+
+        alignas(16) int32_t i[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(i), _mm_cvttps_epi32(n));
+
+    #elif defined(LS_ARM_NEON)
+        alignas(16) const float scale[4] = {(float)(SL_SRGB_ENCODE_LUT_SIZE-1u), (float)(SL_SRGB_ENCODE_LUT_SIZE-1u), (float)(SL_SRGB_ENCODE_LUT_SIZE-1u), 255.f};
+        const float32x4_t n = vmlaq_f32(
+            vdupq_n_f32(0.5f),
+            vminq_f32(vmaxq_f32(c.simd, vdupq_n_f32(0.f)), vdupq_n_f32(1.f)),
+            vld1q_f32(scale));
+
+        alignas(16) uint32_t i[4];
+        vst1q_u32(i, vcvtq_u32_f32(n));
+
+    #else
+        const ls::math::vec4&& n = ls::math::clamp(c, ls::math::vec4{0.f}, ls::math::vec4{1.f})
+            * ls::math::vec4{(float)(SL_SRGB_ENCODE_LUT_SIZE-1u), (float)(SL_SRGB_ENCODE_LUT_SIZE-1u), (float)(SL_SRGB_ENCODE_LUT_SIZE-1u), 255.f}
+            + 0.5f;
+
+        const unsigned i[4] = {(unsigned)n[0], (unsigned)n[1], (unsigned)n[2], (unsigned)n[3]};
+    #endif
+
+    return SL_ColorRGBA8{
+        pLut[i[0]],
+        pLut[i[1]],
+        pLut[i[2]],
+        (uint8_t)i[3]
+    };
+}
+
+
+
+/*-------------------------------------
+ * Encode a linear color into sRGB. Alpha is stored linearly.
+-------------------------------------*/
+inline LS_INLINE SL_ColorRGBA8 sl_linear_to_srgb(const ls::math::vec4& c) noexcept
+{
+    return sl_linear_to_lut(c, SL_LINEAR_TO_SRGB_LUT);
+}
+
+
+
+#endif /* SL_COLOR_SRGB_HPP */
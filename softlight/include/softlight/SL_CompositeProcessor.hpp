@@ -0,0 +1,62 @@
+
+#ifndef SL_COMPOSITE_PROCESSOR_HPP
+#define SL_COMPOSITE_PROCESSOR_HPP
+
+#include <cstdint>
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+class SL_Texture;
+
+
+
+/*-------------------------------------
+ * Weighted-blended OIT layout.
+ *
+ * Draws using SL_BLEND_WEIGHTED_OIT write their first output into a pair of
+ * color attachments rather than blending against a single target. The
+ * accumulation attachment must be an RGBA float texture cleared to 0 and the
+ * revealage attachment must be an R float texture cleared to 1.
+-------------------------------------*/
+enum SL_OITAttachment : uint32_t
+{
+    SL_OIT_ACCUMULATION = 0,
+    SL_OIT_REVEALAGE    = 1,
+
+    SL_OIT_MIN_ATTACHMENTS = 2
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief The Composite Processor resolves the accumulation and revealage
+ * targets of a weighted-blended OIT pass over an opaque image.
+ *
+ * Scanlines are interleaved between threads. Pixels which received no
+ * transparent fragments (a revealage of 1) are left untouched.
+-----------------------------------------------------------------------------*/
+struct SL_CompositeProcessor
+{
+    // 32 bits
+    uint16_t mThreadId;
+    uint16_t mNumThreads;
+
+    // 192 bits
+    const SL_Texture* mAccum;
+    const SL_Texture* mRevealage;
+    SL_Texture* mBackBuffer;
+
+    // 224 bits total, 28 bytes
+
+    template <typename out_type>
+    void composite() noexcept;
+
+    void execute() noexcept;
+};
+
+
+
+#endif /* SL_COMPOSITE_PROCESSOR_HPP */
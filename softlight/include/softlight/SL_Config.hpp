@@ -29,4 +29,21 @@
 #endif /* SL_CONSERVE_MEMORY */
 
 
+
+/*-----------------------------------------------------------------------------
+ * Profiling Configuration
+-----------------------------------------------------------------------------*/
+#ifndef SL_PROFILING_ENABLED
+    #define SL_PROFILING_ENABLED 0
+#endif /* SL_PROFILING_ENABLED */
+
+#ifndef SL_PROFILER_MAX_THREADS
+    #define SL_PROFILER_MAX_THREADS 64
+#endif /* SL_PROFILER_MAX_THREADS */
+
+#ifndef SL_PROFILER_MAX_EVENTS
+    #define SL_PROFILER_MAX_EVENTS 65536
+#endif /* SL_PROFILER_MAX_EVENTS */
+
+
 #endif /* SL_CONFIG_HPP */
@@ -9,7 +9,10 @@
 
 #include "lightsky/utils/Pointer.h"
 
+#include "softlight/SL_CpuTopology.hpp" // SL_ThreadPlacement
+#include "softlight/SL_DamageRegion.hpp"
 #include "softlight/SL_PipelineState.hpp"
+#include "softlight/SL_PipelineStatistics.hpp"
 #include "softlight/SL_ProcessorPool.hpp"
 #include "softlight/SL_Setup.hpp"
 #include "softlight/SL_ViewportState.hpp"
@@ -19,16 +22,22 @@
 /*-----------------------------------------------------------------------------
  * Forward declarations
 -----------------------------------------------------------------------------*/
+struct SL_CaptureTextureSlot;
 class SL_Framebuffer;
+class SL_FrameCapture;
 struct SL_FragmentShader;
 class SL_IndexBuffer;
+class SL_LightClusters;
 struct SL_Mesh;
+struct SL_PointLight;
 class SL_Shader;
 class SL_Texture;
+struct SL_ToneMap;
 class SL_UniformBuffer;
 class SL_VertexArray;
 class SL_VertexBuffer;
 struct SL_VertexShader;
+class SL_VolumeBricks;
 class SL_WindowBuffer;
 
 
@@ -48,6 +57,9 @@ namespace math
 
     template <typename T>
     union vec4_t;
+
+    template <typename T>
+    struct mat4_t;
 }
 }
 
@@ -79,8 +91,14 @@ class SL_Context
 
     SL_ViewportState mViewState;
 
+    SL_DamageRegion mDirtyRegion;
+
+    bool mUseDirtyRegion;
+
     SL_ProcessorPool mProcessors;
 
+    SL_FrameCapture* mCapture;
+
   public:
     ~SL_Context() noexcept;
 
@@ -209,6 +227,30 @@ class SL_Context
 
     SL_ViewportState& viewport_state() noexcept;
 
+    /*
+     * Restrict all following clears and draws to the rectangles of a region,
+     * in framebuffer coordinates, until clear_dirty_region() is called. This
+     * allows mostly static scenes to re-render only the areas which have
+     * changed since the previous frame, leaving all other texels intact.
+     *
+     * Draws are rasterized once, using the intersection of the region's
+     * bounding rectangle and the current scissor. Primitives which miss every
+     * rectangle are rejected before binning, and fragments which fall between
+     * rectangles are rejected before shading, so texels outside of the region
+     * are never written. The scissor is treated as a framebuffer-space
+     * rectangle, which is only the case while the viewport has its default
+     * origin of (0, 0).
+     */
+    void set_dirty_region(const SL_DamageRegion& region) noexcept;
+
+    void clear_dirty_region() noexcept;
+
+    /*
+     * Retrieve the active dirty region, or NULL if clears and draws affect
+     * entire framebuffers.
+     */
+    const SL_DamageRegion* dirty_region() const noexcept;
+
     /*
      *
      */
@@ -225,7 +267,10 @@ class SL_Context
     void draw_instanced(const SL_Mesh& meshes, size_t numInstances, size_t shaderId, size_t fboId) noexcept;
 
     /*
-     *
+     * Copy and convert one texture into another. Blits from compressed
+     * textures, or into textures other than uncompressed integer and
+     * floating point formats, are ignored (see
+     * SL_BlitProcessor::is_blittable()).
      */
     void blit(size_t outTextureId, size_t inTextureId) noexcept;
 
@@ -264,6 +309,37 @@ class SL_Context
         uint16_t dstX1,
         uint16_t dstY1) noexcept;
 
+    /*
+     * Blit only the damaged regions of a texture (in texel coordinates, such
+     * as SL_Framebuffer::damage()) to a window. The regions are added to the
+     * window buffer's damage so they can be presented with
+     * SL_RenderWindow::render_damage(). Textures which differ in size from
+     * the window buffer are blitted entirely.
+     */
+    void blit(SL_WindowBuffer& buffer, size_t textureId, const SL_DamageRegion& damage) noexcept;
+
+    /*
+     * Tone map an HDR texture (RGB/RGBA half or float, or R11G11B10F) while
+     * blitting it to a window, avoiding a separate tone mapping pass.
+     */
+    void blit(SL_WindowBuffer& buffer, size_t textureId, const SL_ToneMap& toneMap) noexcept;
+
+    /*
+     *
+     */
+    void blit(
+        SL_WindowBuffer& buffer,
+        size_t textureId,
+        const SL_ToneMap& toneMap,
+        uint16_t srcX0,
+        uint16_t srcY0,
+        uint16_t srcX1,
+        uint16_t srcY1,
+        uint16_t dstX0,
+        uint16_t dstY0,
+        uint16_t dstX1,
+        uint16_t dstY1) noexcept;
+
     /*
      *
      */
@@ -294,6 +370,79 @@ class SL_Context
      */
     void clear_framebuffer(size_t fboId, const std::array<size_t, 4>& bufferIndices, const std::array<ls::math::vec4_t<double>, 4>& colors, double depth) noexcept;
 
+    /*
+     * Tiled deferred lighting. The framebuffer "gbufferId" must follow the
+     * layout in SL_GBufferAttachment. Lights must be in view-space and the
+     * projection matrix must be the one used to render the G-Buffer. All
+     * attachments and the output texture must use SL_TEXELS_ORDERED.
+     *
+     * Returns 0 on success or a negative value if the G-Buffer or output
+     * texture are incompatible.
+     */
+    int draw_lights(
+        size_t gbufferId,
+        size_t outTextureId,
+        const SL_PointLight* lights,
+        size_t numLights,
+        const ls::math::mat4_t<float>& projection,
+        const ls::math::vec4_t<float>& ambient) noexcept;
+
+    /*
+     * Assign view-space lights to the froxels of a clustered light grid. The
+     * clusters must have been initialized and updated with the current
+     * camera beforehand. Fragment shaders may then query the per-cluster
+     * light lists through SL_LightClusters::lights().
+     *
+     * Returns 0 on success, -1 if the clusters are invalid, or -2 if there
+     * are too many lights to index.
+     */
+    int build_light_clusters(SL_LightClusters& clusters, const SL_PointLight* lights, size_t numLights) noexcept;
+
+    /*
+     * Resolve a weighted-blended OIT pass. The framebuffer "oitFboId" must
+     * follow the layout in SL_OITAttachment and have been rendered with
+     * SL_BLEND_WEIGHTED_OIT. The result is blended over the contents of
+     * "outTextureId", which should already contain the opaque scene. Both the
+     * framebuffer and output texture must use SL_TEXELS_ORDERED.
+     *
+     * Returns 0 on success or a negative value if the framebuffer or output
+     * texture are incompatible.
+     */
+    int composite_transparency(size_t oitFboId, size_t outTextureId) noexcept;
+
+    /*
+     * Calculate the min/max value range of every brick in a volume. The
+     * bricks must have been initialized with the same dimensions as the
+     * volume, which must be a single-channel R8, R16, R32, or float texture.
+     * "texelOrder" should match the order used to store the volume's texels.
+     *
+     * Returns 0 on success, -1 if the bricks are invalid, -2 if the volume
+     * format is unsupported, or -3 if the brick grid does not match the
+     * volume's dimensions.
+     */
+    int build_volume_bricks(const SL_Texture& volume, SL_VolumeBricks& bricks, SL_TexelOrder texelOrder = SL_TEXELS_ORDERED) noexcept;
+
+    /*
+     * Copy an image into a texture using all threads. "pTexels" must contain
+     * one texel of type "srcType" for each texel in the texture, stored
+     * using "srcOrder." Texels are converted into the texture's own format
+     * and texel order, as described by sl_is_tex_upload_supported().
+     *
+     * Returns 0 on success, -1 if the texture or input data is invalid, or
+     * -2 if the texel formats cannot be converted.
+     */
+    int upload_texture(SL_Texture& tex, const void* pTexels, SL_ColorDataType srcType, SL_TexelOrder srcOrder = SL_TEXELS_ORDERED) noexcept;
+
+    /*
+     * Convert a 1D, 2D, or 3D texture between ordered and swizzled layouts
+     * using all threads. Swizzled textures must have a width and height
+     * which are multiples of SL_TEXELS_PER_CHUNK.
+     *
+     * Returns 0 on success, -1 if the texture is invalid, -2 if it cannot
+     * be stored using "texelOrder," or -3 if memory could not be allocated.
+     */
+    int reorder_texture(SL_Texture& tex, SL_TexelOrder texelOrder) noexcept;
+
     /*
      *
      */
@@ -303,6 +452,71 @@ class SL_Context
      *
      */
     unsigned num_threads(unsigned inNumThreads) noexcept;
+
+    /*
+     * Set the number of threads and pin them to CPUs. See
+     * SL_ThreadPlacement for the available strategies.
+     */
+    unsigned num_threads(unsigned inNumThreads, SL_ThreadPlacement placement) noexcept;
+
+    /*
+     * Retrieve the current thread placement.
+     */
+    SL_ThreadPlacement thread_placement() const noexcept;
+
+    /*
+     * Time a representative workload across thread counts and placements,
+     * then keep the fastest configuration. Powers of two up to the number
+     * of physical cores are tried, along with one thread per core and one
+     * thread per logical CPU. SMT and NUMA placements are only tried if the
+     * host has more than one thread per core or more than one node.
+     *
+     * "pWorkload" should render one or more frames and must not change the
+     * number of threads. Each configuration is run once to warm caches, then
+     * "numIterations" times, keeping the fastest run.
+     *
+     * Returns the selected number of threads, or 0 if "pWorkload" is null.
+     */
+    unsigned calibrate_threads(void (*pWorkload)(SL_Context&, void*), void* pUserData = nullptr, unsigned numIterations = 4) noexcept;
+
+    /*
+     * Retrieve the pipeline statistics accumulated by all threads since this
+     * context was created. Statistics should only be read while no draw
+     * calls are in progress.
+     */
+    SL_PipelineStatistics pipeline_statistics() const noexcept;
+
+    /*
+     * Begin recording the pipeline statistics of all subsequent draw calls
+     * into a query object.
+     */
+    void begin_query(SL_PipelineQuery& query) const noexcept;
+
+    /*
+     * Stop recording pipeline statistics. The counters accumulated since
+     * begin_query() are stored in "query.result".
+     */
+    void end_query(SL_PipelineQuery& query) const noexcept;
+
+    /*
+     * Snapshot all resources in *this and record every subsequent draw,
+     * clear, and blit into "capture" until end_capture() is called. The
+     * capture must remain valid until recording ends.
+     *
+     * "pTextureSlots" lists the uniform buffer offsets which hold texture
+     * pointers. These are relocated when the capture is replayed. Any other
+     * pointers in a uniform buffer are copied as-is.
+     *
+     * Returns 0 on success, -1 if a capture is already in progress, -2 if
+     * the resources could not be copied, or -3 if a texture slot does not
+     * fit within an existing uniform buffer.
+     */
+    int begin_capture(SL_FrameCapture& capture, const SL_CaptureTextureSlot* pTextureSlots = nullptr, size_t numTextureSlots = 0) noexcept;
+
+    /*
+     * Stop recording commands into the active frame capture.
+     */
+    void end_capture() noexcept;
 };
 
 
@@ -325,4 +539,36 @@ inline SL_ViewportState& SL_Context::viewport_state() noexcept
 
 
 
+/*-------------------------------------
+ * Begin incremental rendering
+-------------------------------------*/
+inline void SL_Context::set_dirty_region(const SL_DamageRegion& region) noexcept
+{
+    mDirtyRegion = region;
+    mUseDirtyRegion = true;
+}
+
+
+
+/*-------------------------------------
+ * End incremental rendering
+-------------------------------------*/
+inline void SL_Context::clear_dirty_region() noexcept
+{
+    mDirtyRegion.clear();
+    mUseDirtyRegion = false;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the active dirty region
+-------------------------------------*/
+inline const SL_DamageRegion* SL_Context::dirty_region() const noexcept
+{
+    return mUseDirtyRegion ? &mDirtyRegion : nullptr;
+}
+
+
+
 #endif /* SL_CONTEXT_HPP */
@@ -0,0 +1,206 @@
+
+#ifndef SL_CPU_TOPOLOGY_HPP
+#define SL_CPU_TOPOLOGY_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include "softlight/SL_Setup.hpp" // SL_AlignedVector
+
+
+
+/*-----------------------------------------------------------------------------
+ * Thread Placement
+-----------------------------------------------------------------------------*/
+enum SL_ThreadPlacement : uint8_t
+{
+    // Pin the main thread to CPU 0 and let the OS schedule workers.
+    SL_THREAD_PLACEMENT_NONE,
+
+    // One thread per physical core, filling each NUMA node in turn. SMT
+    // siblings are only used once every core has a thread.
+    SL_THREAD_PLACEMENT_CORES,
+
+    // Fill every SMT sibling of a core before moving to the next core.
+    SL_THREAD_PLACEMENT_SMT,
+
+    // Alternate between NUMA nodes, one physical core at a time.
+    SL_THREAD_PLACEMENT_NODES
+};
+
+
+
+/*-------------------------------------
+ * Retrieve a printable name for a thread placement.
+-------------------------------------*/
+const char* sl_thread_placement_name(SL_ThreadPlacement placement) noexcept;
+
+
+
+/*-------------------------------------
+ * Location of a single logical CPU.
+-------------------------------------*/
+struct SL_CpuInfo
+{
+    uint16_t cpuId;
+    uint16_t coreId;
+    uint16_t packageId;
+    uint16_t numaNode;
+    uint16_t smtIndex; // 0 for the first hardware thread of a core
+};
+
+
+
+/*-------------------------------------
+ * Pin the calling thread to a logical CPU.
+ *
+ * Returns 0 on success or -1 if the thread could not be pinned.
+-------------------------------------*/
+int sl_pin_current_thread(unsigned cpuId) noexcept;
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief The Affinity Processor pins a worker thread to a logical CPU.
+ *
+ * Worker threads are only reachable through their task queues, so placement
+ * is applied by having each worker run one of these before any other work.
+ * Workers which cannot be pinned increment "mNumFailures".
+-----------------------------------------------------------------------------*/
+struct SL_AffinityProcessor
+{
+    uint16_t mCpuId;
+
+    std::atomic_uint* mNumFailures;
+
+    void execute() noexcept;
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief CPU Topology
+ *
+ * Lists the online logical CPUs of the host along with their physical core,
+ * package, and NUMA node. On Linux the topology is read from sysfs and only
+ * includes the CPUs in the affinity mask of the process. Other platforms
+ * report every hardware thread as a separate core on one node.
+-----------------------------------------------------------------------------*/
+class SL_CpuTopology
+{
+  private:
+    SL_AlignedVector<SL_CpuInfo> mCpus;
+
+    unsigned mNumCores;
+
+    unsigned mNumPackages;
+
+    unsigned mNumNodes;
+
+    void load_fallback() noexcept;
+
+    void count_resources() noexcept;
+
+  public:
+    ~SL_CpuTopology() noexcept = default;
+
+    SL_CpuTopology() noexcept;
+
+    /*
+     * Use a known topology rather than querying the host. Each CPU must
+     * already have its SMT index assigned.
+     */
+    SL_CpuTopology(const SL_CpuInfo* pCpus, unsigned numCpus) noexcept;
+
+    SL_CpuTopology(const SL_CpuTopology&) = default;
+
+    SL_CpuTopology(SL_CpuTopology&&) noexcept = default;
+
+    SL_CpuTopology& operator=(const SL_CpuTopology&) = default;
+
+    SL_CpuTopology& operator=(SL_CpuTopology&&) noexcept = default;
+
+    /*
+     * Query the topology of the host.
+     *
+     * Returns 0 on success, or -1 if sysfs topology information was not
+     * available. A flat topology of the CPUs in the affinity mask of the
+     * process, or std::thread::hardware_concurrency() CPUs, is loaded if -1
+     * is returned.
+     */
+    int load() noexcept;
+
+    const SL_CpuInfo& cpu(unsigned index) const noexcept;
+
+    unsigned num_cpus() const noexcept;
+
+    unsigned num_cores() const noexcept;
+
+    unsigned num_packages() const noexcept;
+
+    unsigned num_nodes() const noexcept;
+
+    /*
+     * Select a CPU for each of "numThreads" threads. Entry 0 is used for the
+     * main thread and the remaining entries are used by worker threads.
+     * CPUs are reused once every CPU has a thread.
+     *
+     * Returns the number of IDs written to "outCpuIds", which is 0 for
+     * SL_THREAD_PLACEMENT_NONE or an empty topology.
+     */
+    unsigned placement(SL_ThreadPlacement placement, unsigned numThreads, uint16_t* outCpuIds) const noexcept;
+};
+
+
+
+/*-------------------------------------
+ * Retrieve a CPU
+-------------------------------------*/
+inline const SL_CpuInfo& SL_CpuTopology::cpu(unsigned index) const noexcept
+{
+    return mCpus[index];
+}
+
+
+
+/*-------------------------------------
+ * Number of logical CPUs
+-------------------------------------*/
+inline unsigned SL_CpuTopology::num_cpus() const noexcept
+{
+    return (unsigned)mCpus.size();
+}
+
+
+
+/*-------------------------------------
+ * Number of physical cores
+-------------------------------------*/
+inline unsigned SL_CpuTopology::num_cores() const noexcept
+{
+    return mNumCores;
+}
+
+
+
+/*-------------------------------------
+ * Number of CPU packages (sockets)
+-------------------------------------*/
+inline unsigned SL_CpuTopology::num_packages() const noexcept
+{
+    return mNumPackages;
+}
+
+
+
+/*-------------------------------------
+ * Number of NUMA nodes
+-------------------------------------*/
+inline unsigned SL_CpuTopology::num_nodes() const noexcept
+{
+    return mNumNodes;
+}
+
+
+
+#endif /* SL_CPU_TOPOLOGY_HPP */
@@ -0,0 +1,175 @@
+
+#ifndef SL_DAMAGE_REGION_HPP
+#define SL_DAMAGE_REGION_HPP
+
+#include <cstdint>
+
+#include "lightsky/math/vec4.h"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+class SL_BoundingBox;
+
+namespace ls
+{
+namespace math
+{
+    template <typename T>
+    struct mat4_t;
+}
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Damage Region Utilities
+-----------------------------------------------------------------------------*/
+enum SL_DamageLimits : unsigned
+{
+    // Rectangles are merged once this many have been accumulated
+    SL_DAMAGE_MAX_RECTS = 16
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief The Damage Region tracks the rectangles of a framebuffer or window
+ * buffer which have been modified since it was last presented.
+ *
+ * Each rectangle is stored as {x, y, width, height}. Overlapping rectangles
+ * are merged when doing so wastes no more pixels than their overlap. Once
+ * SL_DAMAGE_MAX_RECTS rectangles have been accumulated, new rectangles are
+ * merged with whichever existing rectangle grows the least.
+-----------------------------------------------------------------------------*/
+class SL_DamageRegion
+{
+  private:
+    unsigned mNumRects;
+
+    ls::math::vec4_t<int32_t> mRects[SL_DAMAGE_MAX_RECTS];
+
+    void remove_rect(unsigned index) noexcept;
+
+  public:
+    ~SL_DamageRegion() noexcept = default;
+
+    SL_DamageRegion() noexcept;
+
+    SL_DamageRegion(const SL_DamageRegion&) noexcept = default;
+
+    SL_DamageRegion(SL_DamageRegion&&) noexcept = default;
+
+    SL_DamageRegion& operator=(const SL_DamageRegion&) noexcept = default;
+
+    SL_DamageRegion& operator=(SL_DamageRegion&&) noexcept = default;
+
+    void clear() noexcept;
+
+    bool empty() const noexcept;
+
+    unsigned num_rects() const noexcept;
+
+    const ls::math::vec4_t<int32_t>& rect(unsigned index) const noexcept;
+
+    void add(int32_t x, int32_t y, int32_t w, int32_t h) noexcept;
+
+    void add(const ls::math::vec4_t<int32_t>& r) noexcept;
+
+    void add(const SL_DamageRegion& region) noexcept;
+
+    /*
+     * Add the screen-space bounds of an object after transforming it by a
+     * model-view-projection matrix. The entire framebuffer is added if the
+     * object crosses the camera's near plane. Objects which move need both
+     * their previous and current bounds added.
+     */
+    void add(const SL_BoundingBox& box, const ls::math::mat4_t<float>& mvp, int32_t fboW, int32_t fboH) noexcept;
+
+    void clip(int32_t w, int32_t h) noexcept;
+
+    void flip_vertical(int32_t h) noexcept;
+
+    ls::math::vec4_t<int32_t> bounds() const noexcept;
+
+    uint64_t area() const noexcept;
+
+    bool contains(int32_t x, int32_t y) const noexcept;
+};
+
+
+
+/*-------------------------------------
+ * Remove all rectangles
+-------------------------------------*/
+inline void SL_DamageRegion::clear() noexcept
+{
+    mNumRects = 0;
+}
+
+
+
+/*-------------------------------------
+ * Check if any rectangles have been damaged
+-------------------------------------*/
+inline bool SL_DamageRegion::empty() const noexcept
+{
+    return mNumRects == 0;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the number of damaged rectangles
+-------------------------------------*/
+inline unsigned SL_DamageRegion::num_rects() const noexcept
+{
+    return mNumRects;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve a damaged rectangle
+-------------------------------------*/
+inline const ls::math::vec4_t<int32_t>& SL_DamageRegion::rect(unsigned index) const noexcept
+{
+    return mRects[index];
+}
+
+
+
+/*-------------------------------------
+ * Add a rectangle
+-------------------------------------*/
+inline void SL_DamageRegion::add(const ls::math::vec4_t<int32_t>& r) noexcept
+{
+    add(r[0], r[1], r[2], r[3]);
+}
+
+
+
+
+/*-------------------------------------
+ * Determine if a pixel lies within any rectangle
+-------------------------------------*/
+inline bool SL_DamageRegion::contains(int32_t x, int32_t y) const noexcept
+{
+    for (unsigned i = 0; i < mNumRects; ++i)
+    {
+        const ls::math::vec4_t<int32_t>& r = mRects[i];
+
+        if (x >= r[0] && y >= r[1] && x < r[0]+r[2] && y < r[1]+r[3])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+#endif /* SL_DAMAGE_REGION_HPP */
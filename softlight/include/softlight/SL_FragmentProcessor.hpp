@@ -22,9 +22,11 @@ namespace ls
 template <typename data_t>
 union SL_BinCounter;
 
+class SL_DamageRegion;
 struct SL_FragCoord; // SL_ShaderProcessor.hpp
 struct SL_FragmentBin; // SL_ShaderProcessor.hpp
 class SL_Framebuffer;
+struct SL_PipelineStatistics;
 class SL_ViewportState;
 class SL_Shader;
 class SL_Texture;
@@ -51,6 +53,8 @@ struct SL_FragmentProcessor
     SL_BinCounter<uint32_t>* mBinIds;
     const SL_FragmentBin* mBins;
     SL_FragCoord* mQueues;
+    SL_PipelineStatistics* mStats;
+    const SL_DamageRegion* mDirtyRegion; // NULL unless drawing into a dirty region
 
     virtual ~SL_FragmentProcessor() noexcept {}
 
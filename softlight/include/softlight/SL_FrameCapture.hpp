@@ -0,0 +1,372 @@
+
+#ifndef SL_FRAME_CAPTURE_HPP
+#define SL_FRAME_CAPTURE_HPP
+
+#include <cstdint>
+
+#include "softlight/SL_IndexBuffer.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_Setup.hpp" // SL_AlignedVector
+#include "softlight/SL_Shader.hpp"
+#include "softlight/SL_Texture.hpp"
+#include "softlight/SL_UniformBuffer.hpp"
+#include "softlight/SL_VertexArray.hpp"
+#include "softlight/SL_VertexBuffer.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward declarations
+-----------------------------------------------------------------------------*/
+class SL_Context;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Capture Commands
+-----------------------------------------------------------------------------*/
+enum SL_CaptureCommandType : uint32_t
+{
+    SL_CAPTURE_CMD_DRAW,
+    SL_CAPTURE_CMD_CLEAR_COLOR,
+    SL_CAPTURE_CMD_CLEAR_DEPTH,
+    SL_CAPTURE_CMD_CLEAR_FRAMEBUFFER,
+    SL_CAPTURE_CMD_BLIT
+};
+
+
+
+enum SL_CaptureLimits : uint32_t
+{
+    // Placeholder for blits into a window buffer. Replays blit into an
+    // offscreen texture instead.
+    SL_CAPTURE_WINDOW_ID = 0xFFFFFFFFu,
+
+    // Matches the largest clear_framebuffer() overload
+    SL_CAPTURE_MAX_CLEAR_ATTACHMENTS = 4
+};
+
+
+
+/*-------------------------------------
+ * A single recorded context operation. Each command stores a copy of the
+ * viewport state which was active when it was issued.
+-------------------------------------*/
+struct SL_CaptureCommand
+{
+    SL_CaptureCommandType type;
+
+    // SL_CAPTURE_CMD_DRAW
+    uint32_t shaderId;
+    uint32_t uniformsId; // index of a uniform snapshot, or UINT32_MAX
+    uint32_t firstMesh;
+    uint32_t numMeshes;
+    uint32_t numInstances;
+    uint32_t firstClipMesh; // post-transform copies of each mesh, or UINT32_MAX
+
+    // Draws and clears
+    uint32_t fboId;
+    uint32_t numAttachments;
+    uint32_t attachmentIds[SL_CAPTURE_MAX_CLEAR_ATTACHMENTS];
+    double   colors[SL_CAPTURE_MAX_CLEAR_ATTACHMENTS][4];
+    double   depth;
+
+    // SL_CAPTURE_CMD_BLIT
+    uint32_t srcTextureId;
+    uint32_t dstTextureId;
+    uint16_t srcRect[4]; // x0, y0, x1, y1
+    uint16_t dstRect[4];
+
+    int32_t viewport[4];
+    int32_t scissor[4];
+};
+
+
+
+/*-------------------------------------
+ * Location of a texture pointer within a uniform buffer. Texture slots are
+ * declared when a capture begins, since uniform buffers are untyped.
+-------------------------------------*/
+struct SL_CaptureTextureSlot
+{
+    uint32_t uboId;
+    uint32_t offset; // byte offset of a "const SL_Texture*"
+};
+
+
+
+/*-------------------------------------
+ * Contents of a uniform buffer at the time of a draw call. Declared texture
+ * slots are stored as texture IDs and relocated during replay.
+-------------------------------------*/
+struct SL_CaptureUniforms
+{
+    uint32_t uboId;
+    uint32_t firstFixup;
+    uint32_t numFixups;
+
+    SL_UniformBuffer data;
+};
+
+
+
+struct SL_CaptureFixup
+{
+    uint32_t offset;
+    uint32_t textureId;
+};
+
+
+
+/*-------------------------------------
+ * Framebuffer attachments, stored as texture IDs.
+-------------------------------------*/
+struct SL_CaptureFramebuffer
+{
+    uint32_t numColors;
+    uint32_t colorIds[SL_SHADER_MAX_FRAG_OUTPUTS];
+    uint32_t depthId; // UINT32_MAX if there is no depth buffer
+};
+
+
+
+/*-------------------------------------
+ * Shader state. Shader functions are application code and cannot be
+ * serialized, only their configuration is captured.
+-------------------------------------*/
+struct SL_CaptureShader
+{
+    uint32_t     uboId; // UINT32_MAX if the shader has no uniforms
+    uint8_t      vertNumVaryings;
+    SL_CullMode  cullMode;
+    uint8_t      fragNumVaryings;
+    uint8_t      numOutputs;
+    SL_BlendMode blend;
+    SL_DepthTest depthTest;
+    SL_DepthMask depthMask;
+};
+
+
+
+/*-------------------------------------
+ * Shader functions used to replay a capture.
+-------------------------------------*/
+struct SL_CaptureShaderFuncs
+{
+    ls::math::vec4_t<float> (*vertShader)(SL_VertexParam& vertParams);
+
+    bool (*fragShader)(SL_FragmentParam& perFragParams);
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief Frame Capture
+ *
+ * Frame captures record the commands issued to an SL_Context between calls
+ * to SL_Context::begin_capture() and SL_Context::end_capture(), along with a
+ * snapshot of every resource which existed when the capture began. Captures
+ * can be saved to a file and replayed into another context, allowing slow
+ * frames to be benchmarked outside of the application which produced them.
+ *
+ * Draws, clears, and texture/window blits are recorded. Each draw also
+ * records the output of its vertex shader, so captures replayed without the
+ * application's shaders still rasterize the original primitives. Light,
+ * transparency, and volume processing are not recorded. Only the texture slots passed to
+ * SL_Context::begin_capture() are relocated within uniform buffers. All
+ * other uniform data, including pointers, is copied as-is.
+-----------------------------------------------------------------------------*/
+class SL_FrameCapture
+{
+    friend class SL_Context;
+
+  private:
+    bool mActive;
+
+    uint32_t mNumContextTextures;
+
+    uint32_t mNumContextVaos;
+
+    uint32_t mNumUbos;
+
+    uint16_t mWindowWidth;
+
+    uint16_t mWindowHeight;
+
+    SL_AlignedVector<SL_CaptureCommand> mCommands;
+
+    SL_AlignedVector<SL_Mesh> mMeshes;
+
+    SL_AlignedVector<SL_CaptureUniforms> mUniforms;
+
+    SL_AlignedVector<SL_CaptureFixup> mFixups;
+
+    SL_AlignedVector<SL_CaptureShader> mShaders;
+
+    SL_AlignedVector<SL_CaptureFramebuffer> mFbos;
+
+    SL_AlignedVector<SL_VertexArray> mVaos;
+
+    SL_AlignedVector<SL_VertexBuffer> mVbos;
+
+    SL_AlignedVector<SL_IndexBuffer> mIbos;
+
+    SL_AlignedVector<SL_Texture> mTextures;
+
+    // Address of each captured texture in the source context, and the most
+    // recent snapshot of each uniform buffer. Only valid while recording.
+    SL_AlignedVector<const SL_Texture*> mTexturePtrs;
+
+    SL_AlignedVector<uint32_t> mLatestUniforms;
+
+    SL_AlignedVector<SL_CaptureTextureSlot> mTextureSlots;
+
+    uint32_t find_texture(const SL_Texture* pTex) const noexcept;
+
+    int add_texture(const SL_Texture* pTex, uint32_t& outId) noexcept;
+
+    void add_shader(const SL_Context& context, size_t shaderId) noexcept;
+
+    uint32_t add_clip_meshes(const SL_Context& context, const SL_Mesh* pMeshes, size_t numMeshes, size_t numInstances, size_t shaderId) noexcept;
+
+    uint32_t add_uniforms(const SL_UniformBuffer& ubo, uint32_t uboId) noexcept;
+
+    void apply_uniforms(SL_Context& context, uint32_t uniformsId) const noexcept;
+
+    void record_state(const SL_Context& context, SL_CaptureCommand& cmd) const noexcept;
+
+    bool validate_mesh(const SL_Mesh& m) const noexcept;
+
+    bool validate_clear(const SL_CaptureCommand& cmd) const noexcept;
+
+    bool validate_blit(const SL_CaptureCommand& cmd) const noexcept;
+
+    int validate() const noexcept;
+
+    int begin(const SL_Context& context, const SL_CaptureTextureSlot* pTextureSlots, size_t numTextureSlots) noexcept;
+
+    void end() noexcept;
+
+    void record_draw(const SL_Context& context, const SL_Mesh* pMeshes, size_t numMeshes, size_t numInstances, size_t shaderId, size_t fboId) noexcept;
+
+    void record_clear(const SL_Context& context, SL_CaptureCommandType type, size_t fboId, size_t numAttachments, const size_t* pAttachments, const ls::math::vec4_t<double>* pColors, double depth) noexcept;
+
+    void record_blit(
+        const SL_Context& context,
+        const SL_Texture* pSrc,
+        const SL_Texture* pDst,
+        uint16_t srcX0,
+        uint16_t srcY0,
+        uint16_t srcX1,
+        uint16_t srcY1,
+        uint16_t dstX0,
+        uint16_t dstY0,
+        uint16_t dstX1,
+        uint16_t dstY1) noexcept;
+
+  public:
+    ~SL_FrameCapture() noexcept = default;
+
+    SL_FrameCapture() noexcept;
+
+    SL_FrameCapture(const SL_FrameCapture&) = delete;
+
+    SL_FrameCapture(SL_FrameCapture&&) noexcept = default;
+
+    SL_FrameCapture& operator=(const SL_FrameCapture&) = delete;
+
+    SL_FrameCapture& operator=(SL_FrameCapture&&) noexcept = default;
+
+    /*
+     * Determine if commands are currently being recorded.
+     */
+    bool recording() const noexcept;
+
+    /*
+     * Retrieve the number of recorded commands.
+     */
+    size_t num_commands() const noexcept;
+
+    /*
+     * Retrieve the number of shaders which must be provided to instantiate().
+     */
+    size_t num_shaders() const noexcept;
+
+    /*
+     * Discard all recorded commands and resources.
+     */
+    void clear() noexcept;
+
+    /*
+     * Write the capture to a file.
+     *
+     * Returns 0 on success, -1 if the capture is empty or still recording,
+     * -2 if the file could not be opened, or -3 if an error occurred while
+     * writing.
+     */
+    int save(const char* pFilename) const noexcept;
+
+    /*
+     * Read a capture from a file, replacing any existing data.
+     *
+     * Returns 0 on success, -1 if the file could not be opened, -2 if the
+     * file is not a capture or was written by an incompatible version, -3
+     * if the file is truncated or corrupt, or -4 if memory could not be
+     * allocated.
+     */
+    int load(const char* pFilename) noexcept;
+
+    /*
+     * Create the captured resources in an empty context so resource IDs
+     * match those in the capture. "pShaders" is indexed by captured shader
+     * ID. Draws using shaders which are not provided replay the recorded
+     * clip-space positions and varyings through a pass-through vertex shader
+     * and a fragment shader writing a constant color. Coverage matches the
+     * original frame, but shading costs are only approximated.
+     *
+     * Returns 0 on success, -1 if the context already contains resources,
+     * -2 if a texture could not be allocated, or -3 if a shader or buffer
+     * could not be created.
+     */
+    int instantiate(SL_Context& context, const SL_CaptureShaderFuncs* pShaders, size_t numShaders) const noexcept;
+
+    /*
+     * Execute the recorded commands using a context previously passed to
+     * instantiate().
+     */
+    void replay(SL_Context& context) const noexcept;
+};
+
+
+
+/*-------------------------------------
+ * Check if commands are being recorded
+-------------------------------------*/
+inline bool SL_FrameCapture::recording() const noexcept
+{
+    return mActive;
+}
+
+
+
+/*-------------------------------------
+ * Number of recorded commands
+-------------------------------------*/
+inline size_t SL_FrameCapture::num_commands() const noexcept
+{
+    return mCommands.size();
+}
+
+
+
+/*-------------------------------------
+ * Number of captured shaders
+-------------------------------------*/
+inline size_t SL_FrameCapture::num_shaders() const noexcept
+{
+    return mShaders.size();
+}
+
+
+
+#endif /* SL_FRAME_CAPTURE_HPP */
@@ -9,6 +9,7 @@
 #include "lightsky/utils/Assertions.h"
 #include "lightsky/utils/Copy.h" // utils::fast_memset, fast_fill
 
+#include "softlight/SL_DamageRegion.hpp"
 #include "softlight/SL_Texture.hpp"
 
 
@@ -28,6 +29,7 @@ union vec4_t;
 
 struct SL_FragmentParam;
 enum SL_BlendMode : uint8_t;
+class SL_WindowBuffer;
 
 
 
@@ -47,13 +49,18 @@ enum SL_FboOutputMask
     SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0_1,
     SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0_1_2,
     SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0_1_2_3,
+
+    // Output 0 is accumulated into the SL_OITAttachment targets
+    SL_FBO_OUTPUT_WEIGHTED_OIT,
 };
 
 
 
-constexpr SL_FboOutputMask sl_calc_fbo_out_mask(unsigned numOutputs, bool blendEnabled) noexcept
+constexpr SL_FboOutputMask sl_calc_fbo_out_mask(unsigned numOutputs, bool blendEnabled, bool oitEnabled = false) noexcept
 {
-    return static_cast<SL_FboOutputMask>(numOutputs + (blendEnabled ? (unsigned)SL_FBO_OUTPUT_ATTACHMENT_0_1_2_3 : (unsigned)SL_FBO_OUTPUT_NONE));
+    return oitEnabled
+        ? SL_FBO_OUTPUT_WEIGHTED_OIT
+        : static_cast<SL_FboOutputMask>(numOutputs + (blendEnabled ? (unsigned)SL_FBO_OUTPUT_ATTACHMENT_0_1_2_3 : (unsigned)SL_FBO_OUTPUT_NONE));
 }
 
 
@@ -70,6 +77,14 @@ class SL_Framebuffer
 
     SL_Texture* mDepth;
 
+    // Regions modified by draws and clears, in texel coordinates
+    SL_DamageRegion mDamage;
+
+    // Fragment depth at the near and far planes
+    float mDepthNear;
+
+    float mDepthFar;
+
   public:
     ~SL_Framebuffer() noexcept;
 
@@ -87,6 +102,10 @@ class SL_Framebuffer
 
     int attach_color_buffer(uint64_t index, SL_Texture& t) noexcept;
 
+    // Render directly into a window's backbuffer, removing the need to blit
+    // before presenting. See SL_WindowBuffer for the memory layout.
+    int attach_color_buffer(uint64_t index, SL_WindowBuffer& w) noexcept;
+
     SL_Texture* detach_color_buffer(uint64_t index) noexcept;
 
     const SL_Texture* get_color_buffer(uint64_t index) const noexcept;
@@ -113,6 +132,20 @@ class SL_Framebuffer
 
     void clear_depth_buffer() noexcept;
 
+    // Fragment depth values of the near and far planes. This defaults to
+    // OpenGL's [-1, 1] and only affects the depth weighting of
+    // SL_BLEND_WEIGHTED_OIT. Use [0, 1] for D3D-style projections or (1, 0)
+    // for reversed-Z.
+    void depth_range(float zNear, float zFar) noexcept;
+
+    float depth_near() const noexcept;
+
+    float depth_far() const noexcept;
+
+    const SL_DamageRegion& damage() const noexcept;
+
+    SL_DamageRegion& damage() noexcept;
+
     int valid() const noexcept;
 
     void terminate() noexcept;
@@ -132,6 +165,8 @@ class SL_Framebuffer
         const ls::math::vec4_t<float>& rgba,
         const SL_BlendMode blendMode) noexcept;
 
+    void put_oit_pixel(const SL_FragmentParam& fragParam) noexcept;
+
     template <typename data_t>
     void put_depth_pixel(
         uint16_t x,
@@ -283,13 +318,65 @@ inline SL_Texture* SL_Framebuffer::get_depth_buffer() noexcept
 
 
 
+/*-------------------------------------
+ * Set the depth of the near and far planes
+-------------------------------------*/
+inline void SL_Framebuffer::depth_range(float zNear, float zFar) noexcept
+{
+    mDepthNear = zNear;
+    mDepthFar = zFar;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the depth of the near plane
+-------------------------------------*/
+inline float SL_Framebuffer::depth_near() const noexcept
+{
+    return mDepthNear;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the depth of the far plane
+-------------------------------------*/
+inline float SL_Framebuffer::depth_far() const noexcept
+{
+    return mDepthFar;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the regions modified since the damage was last cleared
+-------------------------------------*/
+inline const SL_DamageRegion& SL_Framebuffer::damage() const noexcept
+{
+    return mDamage;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the regions modified since the damage was last cleared
+-------------------------------------*/
+inline SL_DamageRegion& SL_Framebuffer::damage() noexcept
+{
+    return mDamage;
+}
+
+
+
+
 /*-------------------------------------
  * Place a single pixel onto the depth buffer
 -------------------------------------*/
 template <>
 inline void SL_Framebuffer::put_depth_pixel<ls::math::half>(uint16_t x, uint16_t y, ls::math::half depth) noexcept
 {
-    mDepth->texel<ls::math::half>(x, y) = depth;
+    mDepth->native_texel<ls::math::half>(x, y) = depth;
 }
 
 
@@ -297,7 +384,7 @@ inline void SL_Framebuffer::put_depth_pixel<ls::math::half>(uint16_t x, uint16_t
 template <>
 inline void SL_Framebuffer::put_depth_pixel<float>(uint16_t x, uint16_t y, float depth) noexcept
 {
-    mDepth->texel<float>(x, y) = depth;
+    mDepth->native_texel<float>(x, y) = depth;
 }
 
 
@@ -305,7 +392,7 @@ inline void SL_Framebuffer::put_depth_pixel<float>(uint16_t x, uint16_t y, float
 template <>
 inline void SL_Framebuffer::put_depth_pixel<double>(uint16_t x, uint16_t y, double depth) noexcept
 {
-    mDepth->texel<double>(x, y) = depth;
+    mDepth->native_texel<double>(x, y) = depth;
 }
 
 
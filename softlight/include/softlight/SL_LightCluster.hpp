@@ -0,0 +1,287 @@
+
+#ifndef SL_LIGHT_CLUSTER_HPP
+#define SL_LIGHT_CLUSTER_HPP
+
+#include <cmath> // std::log()
+#include <cstdint>
+
+#include "lightsky/utils/Pointer.h"
+
+#include "lightsky/math/mat4.h"
+
+#include "softlight/SL_Camera.hpp" // sl_view_depth_from_ndc()
+#include "softlight/SL_ShaderUtil.hpp" // SL_FragCoordXYZ
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+struct SL_PointLight;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Clustered Lighting Constants
+-----------------------------------------------------------------------------*/
+enum SL_LightClusterInfo : uint32_t
+{
+    SL_CLUSTER_DEFAULT_TILES_X    = 16,
+    SL_CLUSTER_DEFAULT_TILES_Y    = 9,
+    SL_CLUSTER_DEFAULT_SLICES     = 24,
+    SL_CLUSTER_DEFAULT_MAX_LIGHTS = 64
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief Clustered Light Lists
+ *
+ * The view frustum is divided into a 3D grid of froxels (tilesX * tilesY
+ * screen tiles, each split into exponentially-spaced depth slices). Every
+ * froxel stores a compact list of indices into an array of SL_PointLight
+ * objects which may affect it.
+ *
+ * Clusters are rebuilt once per frame through SL_Context::build_light_clusters()
+ * and can then be queried from any fragment shader using the fragment's
+ * SL_FragCoordXYZ. Clusters affected by more than max_lights_per_cluster()
+ * lights keep the lowest light indices and report the overflow through
+ * num_dropped_lights().
+-----------------------------------------------------------------------------*/
+class SL_LightClusters
+{
+    friend struct SL_ClusterProcessor;
+
+  private:
+    ls::math::mat4 mProjection;
+
+    float mNearPlane;
+
+    float mFarPlane;
+
+    // slice = log(-viewZ) * mSliceScale + mSliceBias
+    float mSliceScale;
+
+    float mSliceBias;
+
+    uint16_t mWidth;
+
+    uint16_t mHeight;
+
+    uint16_t mTilesX;
+
+    uint16_t mTilesY;
+
+    uint16_t mNumSlices;
+
+    uint16_t mMaxLights;
+
+    // Number of lights which affect each cluster, which may exceed
+    // mMaxLights.
+    ls::utils::UniqueAlignedArray<uint16_t> mCounts;
+
+    ls::utils::UniqueAlignedArray<uint16_t> mLightIds;
+
+  public:
+    ~SL_LightClusters() noexcept;
+
+    SL_LightClusters() noexcept;
+
+    SL_LightClusters(const SL_LightClusters& c) noexcept;
+
+    SL_LightClusters(SL_LightClusters&& c) noexcept;
+
+    SL_LightClusters& operator=(const SL_LightClusters& c) noexcept;
+
+    SL_LightClusters& operator=(SL_LightClusters&& c) noexcept;
+
+    int init(
+        uint16_t tilesX = SL_CLUSTER_DEFAULT_TILES_X,
+        uint16_t tilesY = SL_CLUSTER_DEFAULT_TILES_Y,
+        uint16_t numSlices = SL_CLUSTER_DEFAULT_SLICES,
+        uint16_t maxLightsPerCluster = SL_CLUSTER_DEFAULT_MAX_LIGHTS) noexcept;
+
+    void terminate() noexcept;
+
+    bool valid() const noexcept;
+
+    void update(const SL_Camera& cam, uint16_t fboW, uint16_t fboH) noexcept;
+
+    void update(const ls::math::mat4& projection, float zNear, float zFar, uint16_t fboW, uint16_t fboH) noexcept;
+
+    uint16_t tiles_x() const noexcept;
+
+    uint16_t tiles_y() const noexcept;
+
+    uint16_t num_slices() const noexcept;
+
+    uint16_t max_lights_per_cluster() const noexcept;
+
+    unsigned num_clusters() const noexcept;
+
+    unsigned slice_for_depth(float viewZ) const noexcept;
+
+    unsigned cluster_index(uint16_t x, uint16_t y, float viewZ) const noexcept;
+
+    unsigned num_dropped_lights(unsigned clusterId) const noexcept;
+
+    unsigned num_overflowed_clusters() const noexcept;
+
+    const uint16_t* lights(unsigned clusterId, unsigned& outNumLights) const noexcept;
+
+    const uint16_t* lights(const SL_FragCoordXYZ& coord, unsigned& outNumLights) const noexcept;
+};
+
+
+
+/*-------------------------------------
+ * Check if the clusters can be used
+-------------------------------------*/
+inline bool SL_LightClusters::valid() const noexcept
+{
+    return mCounts != nullptr && mWidth && mHeight;
+}
+
+
+
+/*-------------------------------------
+ * Number of horizontal screen tiles
+-------------------------------------*/
+inline uint16_t SL_LightClusters::tiles_x() const noexcept
+{
+    return mTilesX;
+}
+
+
+
+/*-------------------------------------
+ * Number of vertical screen tiles
+-------------------------------------*/
+inline uint16_t SL_LightClusters::tiles_y() const noexcept
+{
+    return mTilesY;
+}
+
+
+
+/*-------------------------------------
+ * Number of depth slices
+-------------------------------------*/
+inline uint16_t SL_LightClusters::num_slices() const noexcept
+{
+    return mNumSlices;
+}
+
+
+
+/*-------------------------------------
+ * Maximum lights which can be referenced by a single cluster
+-------------------------------------*/
+inline uint16_t SL_LightClusters::max_lights_per_cluster() const noexcept
+{
+    return mMaxLights;
+}
+
+
+
+/*-------------------------------------
+ * Total cluster count
+-------------------------------------*/
+inline unsigned SL_LightClusters::num_clusters() const noexcept
+{
+    return (unsigned)mTilesX * (unsigned)mTilesY * (unsigned)mNumSlices;
+}
+
+
+
+/*-------------------------------------
+ * Depth slice from a view-space Z value
+-------------------------------------*/
+inline unsigned SL_LightClusters::slice_for_depth(float viewZ) const noexcept
+{
+    // Clamp before converting to an integer so depths beyond the far plane,
+    // including infinity, can't overflow the conversion.
+    const float d = ls::math::clamp(-viewZ, mNearPlane, mFarPlane);
+    const float slice = std::log(d) * mSliceScale + mSliceBias;
+
+    return (unsigned)ls::math::clamp<float>(slice, 0.f, (float)(mNumSlices - 1u));
+}
+
+
+
+/*-------------------------------------
+ * Cluster index from screen & view-space coordinates
+-------------------------------------*/
+inline unsigned SL_LightClusters::cluster_index(uint16_t x, uint16_t y, float viewZ) const noexcept
+{
+    const unsigned tileX = ls::math::min<unsigned>(((unsigned)x * mTilesX) / mWidth, mTilesX - 1u);
+    const unsigned tileY = ls::math::min<unsigned>(((unsigned)y * mTilesY) / mHeight, mTilesY - 1u);
+
+    return (tileY * mTilesX + tileX) * mNumSlices + slice_for_depth(viewZ);
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the light list of a cluster
+-------------------------------------*/
+inline const uint16_t* SL_LightClusters::lights(unsigned clusterId, unsigned& outNumLights) const noexcept
+{
+    outNumLights = ls::math::min<unsigned>(mCounts[clusterId], mMaxLights);
+    return mLightIds.get() + (size_t)clusterId * mMaxLights;
+}
+
+
+
+/*-------------------------------------
+ * Lights which did not fit into a cluster's light list
+-------------------------------------*/
+inline unsigned SL_LightClusters::num_dropped_lights(unsigned clusterId) const noexcept
+{
+    const unsigned count = mCounts[clusterId];
+    return (count > mMaxLights) ? (count - mMaxLights) : 0u;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the light list for a fragment
+-------------------------------------*/
+inline const uint16_t* SL_LightClusters::lights(const SL_FragCoordXYZ& coord, unsigned& outNumLights) const noexcept
+{
+    const float viewZ = sl_view_depth_from_ndc(mProjection, coord.depth);
+    return lights(cluster_index(coord.x, coord.y, viewZ), outNumLights);
+}
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief The Cluster Processor assigns lights to froxels in parallel.
+ *
+ * Screen tiles are interleaved between threads. Each thread owns every depth
+ * slice within its tiles so no synchronization is required while writing
+ * light indices.
+-----------------------------------------------------------------------------*/
+struct SL_ClusterProcessor
+{
+    // 32 bits
+    uint16_t mThreadId;
+    uint16_t mNumThreads;
+
+    // 32 bits
+    uint32_t mNumLights;
+
+    // 64 bits
+    const SL_PointLight* mLights;
+
+    // 64 bits
+    SL_LightClusters* mClusters;
+
+    // 192 bits total, 24 bytes
+
+    void execute() noexcept;
+};
+
+
+
+#endif /* SL_LIGHT_CLUSTER_HPP */
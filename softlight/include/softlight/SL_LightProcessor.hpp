@@ -0,0 +1,127 @@
+
+#ifndef SL_LIGHT_PROCESSOR_HPP
+#define SL_LIGHT_PROCESSOR_HPP
+
+#include <cstdint>
+
+#include "lightsky/math/vec4.h"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+namespace ls
+{
+namespace math
+{
+template <typename num_type>
+struct mat4_t;
+}
+}
+
+class SL_Texture;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Deferred Lighting Constants
+-----------------------------------------------------------------------------*/
+enum SL_LightTileInfo : uint32_t
+{
+    SL_LIGHT_TILE_SIZE   = 16,
+    SL_LIGHT_TILE_SHIFTS = 4
+};
+
+
+
+/*-------------------------------------
+ * G-Buffer layout expected by the lighting pass.
+ *
+ * SL_GBUFFER_ALBEDO may be either an RGBA8 or RGBA float texture. The normal
+ * and position attachments must be RGBA float textures containing view-space
+ * data. A position with a W component of 0 marks an empty (background) pixel,
+ * which will pass its albedo color through to the output unlit.
+-------------------------------------*/
+enum SL_GBufferAttachment : uint32_t
+{
+    SL_GBUFFER_ALBEDO   = 0,
+    SL_GBUFFER_NORMAL   = 1,
+    SL_GBUFFER_POSITION = 2,
+
+    SL_GBUFFER_MIN_ATTACHMENTS = 3
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief A point light used by the tiled deferred lighting pass.
+ *
+ * The position must be in view-space, the same space as the G-Buffer's
+ * position attachment.
+-----------------------------------------------------------------------------*/
+struct SL_PointLight
+{
+    // XYZ: View-space position
+    // W:   Radius of influence
+    ls::math::vec4 position;
+
+    // RGB: Light color
+    // A:   Intensity
+    ls::math::vec4 color;
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief The Light Processor performs tiled deferred shading.
+ *
+ * The output image is divided into 16x16 tiles, which are distributed across
+ * threads in an interleaved pattern. Each thread calculates the minimum and
+ * maximum view-space depth of a tile, culls all lights against the tile's
+ * sub-frustum and depth bounds, then shades only the pixels within that tile
+ * using the remaining lights.
+-----------------------------------------------------------------------------*/
+struct SL_LightProcessor
+{
+    // 32 bits
+    uint16_t mThreadId;
+    uint16_t mNumThreads;
+
+    // 32 bits
+    uint32_t mNumLights;
+
+    // 64 bits
+    const SL_PointLight* mLights;
+
+    // 128 bits
+    const ls::math::mat4_t<float>* mProjection;
+    const ls::math::vec4_t<float>* mAmbient;
+
+    // 256 bits
+    const SL_Texture* mAlbedo;
+    const SL_Texture* mNormals;
+    const SL_Texture* mPositions;
+    SL_Texture* mBackBuffer;
+
+    // 480 bits total, 60 bytes
+
+    // Calculate the view-space depth bounds of a tile, then store the indices
+    // of all lights which affect it. "pOutLightIds" must have room for
+    // mNumLights entries. Returns the number of visible lights.
+    unsigned cull_lights(
+        uint16_t x0,
+        uint16_t y0,
+        uint16_t x1,
+        uint16_t y1,
+        uint16_t* pOutLightIds) const noexcept;
+
+    template <typename albedo_type, typename out_type>
+    void shade_tiles() noexcept;
+
+    void execute() noexcept;
+};
+
+
+
+#endif /* SL_LIGHT_PROCESSOR_HPP */
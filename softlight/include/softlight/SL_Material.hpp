@@ -44,7 +44,8 @@ enum SL_MaterialStatus
     SL_MATERIAL_STATUS_INVALID_TEXTURE,
     SL_MATERIAL_STATUS_DUPLICATE_TEXTURES,
     SL_MATERIAL_STATUS_VALUE_UNDERFLOW,
-    SL_MATERIAL_STATUS_VALUE_OVERFLOW
+    SL_MATERIAL_STATUS_VALUE_OVERFLOW,
+    SL_MATERIAL_STATUS_INVALID_LAYER
 };
 
 
@@ -56,6 +57,11 @@ struct SL_Material
 {
     const SL_Texture* pTextures[SL_MaterialProperty::SL_MATERIAL_MAX_TEXTURES];
 
+    // Layer of each texture to sample when it's an array texture. Materials
+    // sharing an array only differ by layer, allowing them to be drawn
+    // together without rebinding textures.
+    uint16_t layers[SL_MaterialProperty::SL_MATERIAL_MAX_TEXTURES];
+
     SL_ColorRGBAf ambient;
     SL_ColorRGBAf diffuse;
     SL_ColorRGBAf specular;
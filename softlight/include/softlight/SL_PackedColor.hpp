@@ -0,0 +1,184 @@
+
+#ifndef SL_PACKED_COLOR_HPP
+#define SL_PACKED_COLOR_HPP
+
+#include <cstdint>
+
+#include "lightsky/setup/Macros.h" // LS_INLINE
+
+#include "lightsky/math/vec4.h"
+#include "lightsky/math/vec_utils.h"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Small Unsigned Floats
+ *
+ * The R11G11B10F format stores each channel as an unsigned float with a
+ * 5-bit exponent (the same bias as a half-float) and a 6-bit or 5-bit
+ * mantissa.
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Convert a float into an unsigned small-float. Negative values and NaN
+ * become 0 while values out of range saturate to the largest finite value.
+-------------------------------------*/
+template <unsigned mantissa_bits>
+inline LS_INLINE uint32_t sl_float_to_ufloat(float f) noexcept
+{
+    constexpr uint32_t maxVal = (30u << mantissa_bits) | ((1u << mantissa_bits) - 1u);
+
+    union
+    {
+        float f;
+        uint32_t i;
+    } bits{f};
+
+    // also catches NaN
+    if (!(f > 0.f))
+    {
+        return 0u;
+    }
+
+    const int32_t  exponent = (int32_t)((bits.i >> 23u) & 0xFFu) - 127 + 15;
+    const uint32_t mantissa = bits.i & 0x007FFFFFu;
+
+    if (exponent >= 31)
+    {
+        return maxVal;
+    }
+
+    if (exponent <= 0)
+    {
+        // Denormalized output, the implicit leading bit becomes explicit
+        const int32_t shift = (int32_t)(24u - mantissa_bits) - exponent;
+        return (shift >= 32) ? 0u : ((mantissa | 0x00800000u) >> (uint32_t)shift);
+    }
+
+    return ((uint32_t)exponent << mantissa_bits) | (mantissa >> (23u - mantissa_bits));
+}
+
+
+
+/*-------------------------------------
+ * Convert an unsigned small-float into a float
+-------------------------------------*/
+template <unsigned mantissa_bits>
+inline LS_INLINE float sl_ufloat_to_float(uint32_t u) noexcept
+{
+    const uint32_t exponent = (u >> mantissa_bits) & 0x1Fu;
+    const uint32_t mantissa = u & ((1u << mantissa_bits) - 1u);
+
+    if (!exponent)
+    {
+        return (float)mantissa * (1.f / (float)(1u << (14u + mantissa_bits)));
+    }
+
+    union
+    {
+        uint32_t i;
+        float f;
+    } bits{(exponent == 31u)
+        ? (0x7F800000u | (mantissa << (23u - mantissa_bits)))
+        : (((exponent + 112u) << 23u) | (mantissa << (23u - mantissa_bits)))
+    };
+
+    return bits.f;
+}
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief 16-bit RGB color with 5 bits of red and blue, and 6 bits of green.
+ *
+ * Red is stored in the most significant bits, matching 16-bit X11 visuals
+ * and GL_UNSIGNED_SHORT_5_6_5.
+-----------------------------------------------------------------------------*/
+struct SL_PackedColorRGB565
+{
+    typedef uint16_t packed_type;
+
+    static constexpr unsigned num_components() noexcept { return 3; }
+
+    static inline LS_INLINE packed_type pack(const ls::math::vec4& c) noexcept
+    {
+        const ls::math::vec4&& n = ls::math::clamp(c, ls::math::vec4{0.f}, ls::math::vec4{1.f}) * ls::math::vec4{31.f, 63.f, 31.f, 0.f} + 0.5f;
+        return (packed_type)(((uint32_t)n[0] << 11u) | ((uint32_t)n[1] << 5u) | (uint32_t)n[2]);
+    }
+
+    static inline LS_INLINE ls::math::vec4 unpack(packed_type p) noexcept
+    {
+        return ls::math::vec4{
+            (float)(p >> 11u),
+            (float)((p >> 5u) & 0x3Fu),
+            (float)(p & 0x1Fu),
+            1.f
+        } * ls::math::vec4{1.f/31.f, 1.f/63.f, 1.f/31.f, 1.f};
+    }
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief 32-bit normalized RGBA color with 10 bits per color channel and a
+ * 2-bit alpha.
+ *
+ * Red is stored in the least significant bits, matching
+ * GL_UNSIGNED_INT_2_10_10_10_REV.
+-----------------------------------------------------------------------------*/
+struct SL_PackedColorRGB10A2
+{
+    typedef uint32_t packed_type;
+
+    static constexpr unsigned num_components() noexcept { return 4; }
+
+    static inline LS_INLINE packed_type pack(const ls::math::vec4& c) noexcept
+    {
+        const ls::math::vec4&& n = ls::math::clamp(c, ls::math::vec4{0.f}, ls::math::vec4{1.f}) * ls::math::vec4{1023.f, 1023.f, 1023.f, 3.f} + 0.5f;
+        return (uint32_t)n[0] | ((uint32_t)n[1] << 10u) | ((uint32_t)n[2] << 20u) | ((uint32_t)n[3] << 30u);
+    }
+
+    static inline LS_INLINE ls::math::vec4 unpack(packed_type p) noexcept
+    {
+        return ls::math::vec4{
+            (float)(p & 0x3FFu),
+            (float)((p >> 10u) & 0x3FFu),
+            (float)((p >> 20u) & 0x3FFu),
+            (float)(p >> 30u)
+        } * ls::math::vec4{1.f/1023.f, 1.f/1023.f, 1.f/1023.f, 1.f/3.f};
+    }
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief 32-bit unsigned floating-point RGB color, using 11 bits for red
+ * and green, and 10 bits for blue.
+ *
+ * Red is stored in the least significant bits, matching
+ * GL_UNSIGNED_INT_10F_11F_11F_REV. Values are HDR and are not clamped to 1.
+-----------------------------------------------------------------------------*/
+struct SL_PackedColorR11G11B10F
+{
+    typedef uint32_t packed_type;
+
+    static constexpr unsigned num_components() noexcept { return 3; }
+
+    static inline LS_INLINE packed_type pack(const ls::math::vec4& c) noexcept
+    {
+        return sl_float_to_ufloat<6>(c[0]) | (sl_float_to_ufloat<6>(c[1]) << 11u) | (sl_float_to_ufloat<5>(c[2]) << 22u);
+    }
+
+    static inline LS_INLINE ls::math::vec4 unpack(packed_type p) noexcept
+    {
+        return ls::math::vec4{
+            sl_ufloat_to_float<6>(p & 0x7FFu),
+            sl_ufloat_to_float<6>((p >> 11u) & 0x7FFu),
+            sl_ufloat_to_float<5>(p >> 22u),
+            1.f
+        };
+    }
+};
+
+
+
+#endif /* SL_PACKED_COLOR_HPP */
@@ -59,7 +59,13 @@ enum SL_BlendMode : uint8_t
     SL_BLEND_PREMULTIPLED_ALPHA,
     SL_BLEND_ADDITIVE,
     SL_BLEND_SCREEN,
-}; // 5 states = 3 bits
+
+    // Order-independent. Output 0 is accumulated into color attachments
+    // SL_OIT_ACCUMULATION and SL_OIT_REVEALAGE, which must then be resolved
+    // with SL_Context::composite_transparency(). Fragments are weighted by
+    // their depth within SL_Framebuffer::depth_range().
+    SL_BLEND_WEIGHTED_OIT,
+}; // 6 states = 3 bits
 
 
 
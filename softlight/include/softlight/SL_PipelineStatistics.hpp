@@ -0,0 +1,158 @@
+
+#ifndef SL_PIPELINE_STATISTICS_HPP
+#define SL_PIPELINE_STATISTICS_HPP
+
+#include <cstdint>
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief Pipeline Statistics
+ *
+ * Counters describing the work performed by each stage of the render
+ * pipeline. Each processor thread accumulates its own set of counters which
+ * are summed together by SL_ProcessorPool::statistics(), so counting does not
+ * add any contention between threads.
+ *
+ * Per-thread counters are padded to a cache line to avoid false sharing.
+-----------------------------------------------------------------------------*/
+struct alignas(64) SL_PipelineStatistics
+{
+    // Vertex shader invocations. Vertices reused from the post-transform
+    // cache are not counted.
+    uint64_t verticesShaded;
+
+    // Points, lines, or triangles read by the vertex processors.
+    uint64_t primsSubmitted;
+
+    // Triangles rejected by face culling.
+    uint64_t primsCulledBackface;
+
+    // Primitives entirely outside of the view frustum, or which were clipped
+    // away completely.
+    uint64_t primsCulledFrustum;
+
+    // Triangles whose screen-space bounds are less than 1 pixel in width or
+    // height.
+    uint64_t primsCulledZeroArea;
+
+    // Triangles which intersected the view frustum and had to be clipped.
+    uint64_t primsClipped;
+
+    // Triangles generated by clipping.
+    uint64_t clipOutputPrims;
+
+    // Primitives sent to the rasterizers.
+    uint64_t binsFlushed;
+
+    // Rasterization passes triggered because all fragment bins were full,
+    // rather than by the end of a draw call.
+    uint64_t binOverflows;
+
+    // Fragments covered by a primitive, before depth testing.
+    uint64_t fragsRasterized;
+
+    // Fragments rejected by the depth test. This is calculated from the
+    // difference between rasterized and shaded fragments.
+    uint64_t fragsDepthFailed;
+
+    // Fragment shader invocations.
+    uint64_t fragsShaded;
+
+    // Fragments discarded by the fragment shader.
+    uint64_t fragsDiscarded;
+
+    // Fragments written to the framebuffer.
+    uint64_t pixelsWritten;
+};
+
+
+
+/*-------------------------------------
+ * Reset all counters to 0
+-------------------------------------*/
+inline void sl_reset_pipeline_statistics(SL_PipelineStatistics& stats) noexcept
+{
+    stats.verticesShaded      = 0;
+    stats.primsSubmitted      = 0;
+    stats.primsCulledBackface = 0;
+    stats.primsCulledFrustum  = 0;
+    stats.primsCulledZeroArea = 0;
+    stats.primsClipped        = 0;
+    stats.clipOutputPrims     = 0;
+    stats.binsFlushed         = 0;
+    stats.binOverflows        = 0;
+    stats.fragsRasterized     = 0;
+    stats.fragsDepthFailed    = 0;
+    stats.fragsShaded         = 0;
+    stats.fragsDiscarded      = 0;
+    stats.pixelsWritten       = 0;
+}
+
+
+
+/*-------------------------------------
+ * Add the counters of "src" into "dst"
+-------------------------------------*/
+inline void sl_accumulate_pipeline_statistics(SL_PipelineStatistics& dst, const SL_PipelineStatistics& src) noexcept
+{
+    dst.verticesShaded      += src.verticesShaded;
+    dst.primsSubmitted      += src.primsSubmitted;
+    dst.primsCulledBackface += src.primsCulledBackface;
+    dst.primsCulledFrustum  += src.primsCulledFrustum;
+    dst.primsCulledZeroArea += src.primsCulledZeroArea;
+    dst.primsClipped        += src.primsClipped;
+    dst.clipOutputPrims     += src.clipOutputPrims;
+    dst.binsFlushed         += src.binsFlushed;
+    dst.binOverflows        += src.binOverflows;
+    dst.fragsRasterized     += src.fragsRasterized;
+    dst.fragsDepthFailed    += src.fragsDepthFailed;
+    dst.fragsShaded         += src.fragsShaded;
+    dst.fragsDiscarded      += src.fragsDiscarded;
+    dst.pixelsWritten       += src.pixelsWritten;
+}
+
+
+
+/*-------------------------------------
+ * Subtract the counters of "src" from "dst"
+-------------------------------------*/
+inline void sl_subtract_pipeline_statistics(SL_PipelineStatistics& dst, const SL_PipelineStatistics& src) noexcept
+{
+    dst.verticesShaded      -= src.verticesShaded;
+    dst.primsSubmitted      -= src.primsSubmitted;
+    dst.primsCulledBackface -= src.primsCulledBackface;
+    dst.primsCulledFrustum  -= src.primsCulledFrustum;
+    dst.primsCulledZeroArea -= src.primsCulledZeroArea;
+    dst.primsClipped        -= src.primsClipped;
+    dst.clipOutputPrims     -= src.clipOutputPrims;
+    dst.binsFlushed         -= src.binsFlushed;
+    dst.binOverflows        -= src.binOverflows;
+    dst.fragsRasterized     -= src.fragsRasterized;
+    dst.fragsDepthFailed    -= src.fragsDepthFailed;
+    dst.fragsShaded         -= src.fragsShaded;
+    dst.fragsDiscarded      -= src.fragsDiscarded;
+    dst.pixelsWritten       -= src.pixelsWritten;
+}
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief Pipeline Statistics Query
+ *
+ * Queries capture the pipeline statistics of all draw calls made between
+ * SL_Context::begin_query() and SL_Context::end_query(). Multiple queries
+ * may be active at the same time, including nested queries.
+-----------------------------------------------------------------------------*/
+struct SL_PipelineQuery
+{
+    // Counters sampled when the query began
+    SL_PipelineStatistics start;
+
+    // Counters accumulated between the beginning and end of the query
+    SL_PipelineStatistics result;
+};
+
+
+
+#endif /* SL_PIPELINE_STATISTICS_HPP */
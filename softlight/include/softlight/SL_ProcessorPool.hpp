@@ -7,7 +7,9 @@
 
 #include "lightsky/utils/Pointer.h" // Pointer, AlignedPointerDeleter
 
+#include "softlight/SL_PipelineStatistics.hpp"
 #include "softlight/SL_ShaderUtil.hpp"
+#include "softlight/SL_Texture.hpp" // SL_TexelOrder
 
 
 
@@ -26,17 +28,27 @@ namespace math
 {
 template <typename T>
 union vec4_t;
+
+template <typename T>
+struct mat4_t;
 } // math namespace
 } // ls namespace
 
+enum SL_ThreadPlacement : uint8_t;
+
 class SL_Context;
+class SL_DamageRegion;
 struct SL_FragCoord;
 struct SL_FragmentBin;
 class SL_Framebuffer;
+class SL_LightClusters;
 struct SL_Mesh;
+struct SL_PointLight;
 class SL_Shader;
 struct SL_ShaderProcessor;
 class SL_Texture;
+struct SL_ToneMap;
+class SL_VolumeBricks;
 
 
 
@@ -66,8 +78,21 @@ class SL_ProcessorPool
 
     ls::utils::UniqueAlignedArray<ThreadedWorker> mWorkers;
 
+    // One set of counters per thread. Counters from threads which have been
+    // removed are kept in mRetiredStats.
+    ls::utils::UniqueAlignedArray<SL_PipelineStatistics> mStats;
+
+    SL_PipelineStatistics mRetiredStats;
+
     unsigned mNumThreads;
 
+    SL_ThreadPlacement mPlacement;
+
+    // Pin the main thread and every worker according to mPlacement. This
+    // must only be called while the processors are idle. Returns the number
+    // of threads which could not be pinned.
+    unsigned apply_placement() noexcept;
+
   public:
     ~SL_ProcessorPool() noexcept;
 
@@ -87,12 +112,22 @@ class SL_ProcessorPool
 
     unsigned concurrency(unsigned n) noexcept;
 
+    // Set the number of threads and pin them to CPUs using a placement
+    // strategy. concurrency(n) keeps the current placement.
+    unsigned concurrency(unsigned n, SL_ThreadPlacement placement) noexcept;
+
+    SL_ThreadPlacement placement() const noexcept;
+
     void flush() noexcept;
 
     void wait() noexcept;
 
     void execute() noexcept;
 
+    // Sum the pipeline statistics of all threads. This must only be called
+    // while the processors are idle.
+    SL_PipelineStatistics statistics() const noexcept;
+
     void run_shader_processors(const SL_Context& c, const SL_Mesh& m, size_t numInstances, const SL_Shader& s, SL_Framebuffer& fbo) noexcept;
 
     void run_shader_processors(const SL_Context& c, const SL_Mesh* meshes, size_t numMeshes, const SL_Shader& s, SL_Framebuffer& fbo) noexcept;
@@ -109,18 +144,37 @@ class SL_ProcessorPool
         uint16_t dstX0,
         uint16_t dstY0,
         uint16_t dstX1,
-        uint16_t dstY1
+        uint16_t dstY1,
+        const SL_ToneMap* toneMap = nullptr
     ) noexcept;
 
-    void run_clear_processors(const void* inColor, SL_Texture* outTex) noexcept;
+    // Clears are limited to the rectangles in "region" if it is not null
+    void run_clear_processors(const void* inColor, SL_Texture* outTex, const SL_DamageRegion* region = nullptr) noexcept;
+
+    void run_clear_processors(const void* inColor, const void* depth, SL_Texture* colorBuf, SL_Texture* depthBuf, const SL_DamageRegion* region = nullptr) noexcept;
 
-    void run_clear_processors(const void* inColor, const void* depth, SL_Texture* colorBuf, SL_Texture* depthBuf) noexcept;
+    void run_clear_processors(const std::array<const void*, 2>& inColors, const void* depth, const std::array<SL_Texture*, 2>& colorBufs, SL_Texture* depthBuf, const SL_DamageRegion* region = nullptr) noexcept;
 
-    void run_clear_processors(const std::array<const void*, 2>& inColors, const void* depth, const std::array<SL_Texture*, 2>& colorBufs, SL_Texture* depthBuf) noexcept;
+    void run_clear_processors(const std::array<const void*, 3>& inColors, const void* depth, const std::array<SL_Texture*, 3>& colorBufs, SL_Texture* depthBuf, const SL_DamageRegion* region = nullptr) noexcept;
 
-    void run_clear_processors(const std::array<const void*, 3>& inColors, const void* depth, const std::array<SL_Texture*, 3>& colorBufs, SL_Texture* depthBuf) noexcept;
+    void run_clear_processors(const std::array<const void*, 4>& inColors, const void* depth, const std::array<SL_Texture*, 4>& colorBufs, SL_Texture* depthBuf, const SL_DamageRegion* region = nullptr) noexcept;
 
-    void run_clear_processors(const std::array<const void*, 4>& inColors, const void* depth, const std::array<SL_Texture*, 4>& colorBufs, SL_Texture* depthBuf) noexcept;
+    void run_light_processors(
+        const SL_PointLight* lights,
+        uint32_t numLights,
+        const ls::math::mat4_t<float>& projection,
+        const ls::math::vec4_t<float>& ambient,
+        const SL_Framebuffer& gbuffer,
+        SL_Texture* outTex
+    ) noexcept;
+
+    void run_cluster_processors(SL_LightClusters& clusters, const SL_PointLight* lights, uint32_t numLights) noexcept;
+
+    void run_composite_processors(const SL_Texture* accum, const SL_Texture* revealage, SL_Texture* outTex) noexcept;
+
+    void run_volume_processors(const SL_Texture& volume, SL_VolumeBricks& bricks, SL_TexelOrder texelOrder) noexcept;
+
+    void run_tex_upload_processors(const void* pTexels, SL_ColorDataType srcType, SL_TexelOrder srcOrder, SL_Texture& outTex) noexcept;
 };
 
 
@@ -135,6 +189,16 @@ inline unsigned SL_ProcessorPool::concurrency() const noexcept
 
 
 
+/*-------------------------------------
+ * Retrieve the thread placement
+-------------------------------------*/
+inline SL_ThreadPlacement SL_ProcessorPool::placement() const noexcept
+{
+    return mPlacement;
+}
+
+
+
 /*-------------------------------------
  * Run the processor threads
 -------------------------------------*/
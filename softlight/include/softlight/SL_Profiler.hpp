@@ -0,0 +1,385 @@
+
+#ifndef SL_PROFILER_HPP
+#define SL_PROFILER_HPP
+
+#include <cstdint>
+
+#include "softlight/SL_Config.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Pipeline Stages
+-----------------------------------------------------------------------------*/
+enum SL_ProfileStage : uint16_t
+{
+    SL_PROFILE_DRAW,         // Dispatch of a draw call, including the wait for all threads
+    SL_PROFILE_VERTEX,       // Vertex processing and binning
+    SL_PROFILE_CLIP,         // Total clipping time of one vertex processing pass, excluding flushes
+    SL_PROFILE_FLUSH,        // A single flush_rasterizer() cycle
+    SL_PROFILE_BIN_SORT,     // Sorting of binned primitives before rasterization
+    SL_PROFILE_RASTER,       // Rasterization and fragment shading of all bins
+    SL_PROFILE_BARRIER_WAIT, // Time spent spinning on another thread
+    SL_PROFILE_BLIT,
+    SL_PROFILE_CLEAR,
+
+    SL_PROFILE_STAGE_COUNT
+};
+
+
+
+/*-------------------------------------
+ * Retrieve a human-readable name for a pipeline stage
+-------------------------------------*/
+const char* sl_profile_stage_name(SL_ProfileStage stage) noexcept;
+
+
+
+#if SL_PROFILING_ENABLED
+
+/*-----------------------------------------------------------------------------
+ * Profiling Events
+ *
+ * Each event records the start and end time of a pipeline stage in
+ * nanoseconds, relative to the call to sl_profiler_begin(). Accumulated
+ * events instead record the time they were sampled and the total time spent
+ * in a stage (see SL_ProfileTotal). Events are
+ * stored in a fixed-size buffer per thread, which is written only by the
+ * thread with the matching processor ID. No locking is required as long as
+ * the profiler is started, stopped, and exported while the processor pool is
+ * idle.
+-----------------------------------------------------------------------------*/
+enum SL_ProfileEventType : uint16_t
+{
+    SL_PROFILE_EVENT_SPAN,  // beginTime to endTime
+    SL_PROFILE_EVENT_TOTAL  // sampled at beginTime, lasting (endTime - beginTime) in total
+};
+
+
+
+struct SL_ProfileEvent
+{
+    uint64_t beginTime;
+    uint64_t endTime;
+    SL_ProfileStage stage;
+    uint16_t threadId;
+    SL_ProfileEventType type;
+};
+
+
+
+/*-------------------------------------
+ * Allocate event buffers for the first "numThreads" threads and begin
+ * recording events. Pass SL_Context::num_threads() to profile every thread
+ * of a context. Buffers of threads beyond "numThreads" are freed and their
+ * events are dropped.
+ *
+ * Returns 0 on success, or -1 if "numThreads" is 0 or greater than
+ * SL_PROFILER_MAX_THREADS, or if the event buffers could not be allocated.
+ * Previously recorded events are discarded.
+-------------------------------------*/
+int sl_profiler_begin(unsigned numThreads) noexcept;
+
+/*-------------------------------------
+ * Stop recording events. Recorded events remain available for export.
+-------------------------------------*/
+void sl_profiler_end() noexcept;
+
+/*-------------------------------------
+ * Discard all recorded events and free the event buffers.
+-------------------------------------*/
+void sl_profiler_terminate() noexcept;
+
+/*-------------------------------------
+ * Determine if events are currently being recorded.
+-------------------------------------*/
+bool sl_profiler_active() noexcept;
+
+/*-------------------------------------
+ * Retrieve the current time, in nanoseconds, relative to the start of
+ * recording.
+-------------------------------------*/
+uint64_t sl_profiler_time() noexcept;
+
+/*-------------------------------------
+ * Add an event to a thread's buffer. Events are dropped if the thread ID is
+ * out of range or the thread's buffer is full.
+-------------------------------------*/
+void sl_profiler_record(SL_ProfileStage stage, uint16_t threadId, uint64_t beginTime, uint64_t endTime) noexcept;
+
+/*-------------------------------------
+ * Add an accumulated event to a thread's buffer. These are exported as
+ * counters rather than spans since the time they add up is spread across
+ * other events.
+-------------------------------------*/
+void sl_profiler_record_total(SL_ProfileStage stage, uint16_t threadId, uint64_t sampleTime, uint64_t totalTime) noexcept;
+
+/*-------------------------------------
+ * Retrieve the number of events recorded and dropped across all threads.
+-------------------------------------*/
+uint64_t sl_profiler_num_events() noexcept;
+
+uint64_t sl_profiler_num_dropped() noexcept;
+
+/*-------------------------------------
+ * Export all recorded events using the Chrome "trace_event" JSON format,
+ * which can be loaded by chrome://tracing or Perfetto.
+ *
+ * Returns 0 on success, -1 if no events were recorded, -2 if the output file
+ * could not be opened, and -3 if an error occurred while writing.
+-------------------------------------*/
+int sl_profiler_save_trace(const char* const pFilename) noexcept;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Scoped Profiling
+ *
+ * Scopes pause the calling thread's running SL_ProfileTotal (if any) so
+ * stages nested inside an accumulated stage are not counted twice.
+-----------------------------------------------------------------------------*/
+class SL_ProfileTotal;
+
+/*-------------------------------------
+ * Retrieve the accumulator which is currently timing the calling thread, or
+ * NULL if there is none.
+-------------------------------------*/
+SL_ProfileTotal*& sl_profiler_running_total() noexcept;
+
+
+
+class SL_ProfileScope
+{
+  private:
+    uint64_t mBeginTime;
+
+    SL_ProfileTotal* mPausedTotal;
+
+    SL_ProfileStage mStage;
+
+    uint16_t mThreadId;
+
+    bool mActive;
+
+  public:
+    ~SL_ProfileScope() noexcept;
+
+    SL_ProfileScope(SL_ProfileStage stage, uint16_t threadId) noexcept;
+
+    SL_ProfileScope(const SL_ProfileScope&) = delete;
+
+    SL_ProfileScope(SL_ProfileScope&&) = delete;
+
+    SL_ProfileScope& operator=(const SL_ProfileScope&) = delete;
+
+    SL_ProfileScope& operator=(SL_ProfileScope&&) = delete;
+};
+
+
+
+/*-----------------------------------------------------------------------------
+ * Accumulated Profiling
+ *
+ * Stages which run many times in a tight loop, such as clipping, add up
+ * their time and record a single accumulated event when the accumulator goes
+ * out of scope. Time spent in nested SL_ProfileScopes is excluded.
+-----------------------------------------------------------------------------*/
+class SL_ProfileTotal
+{
+  private:
+    uint64_t mLastTime;
+
+    uint64_t mTotalTime;
+
+    SL_ProfileStage mStage;
+
+    uint16_t mThreadId;
+
+    bool mActive;
+
+  public:
+    ~SL_ProfileTotal() noexcept;
+
+    SL_ProfileTotal(SL_ProfileStage stage, uint16_t threadId) noexcept;
+
+    SL_ProfileTotal(const SL_ProfileTotal&) = delete;
+
+    SL_ProfileTotal(SL_ProfileTotal&&) = delete;
+
+    SL_ProfileTotal& operator=(const SL_ProfileTotal&) = delete;
+
+    SL_ProfileTotal& operator=(SL_ProfileTotal&&) = delete;
+
+    void begin() noexcept;
+
+    void end() noexcept;
+};
+
+
+
+/*-------------------------------------
+ * Destructor
+-------------------------------------*/
+inline SL_ProfileTotal::~SL_ProfileTotal() noexcept
+{
+    if (mActive && mTotalTime)
+    {
+        sl_profiler_record_total(mStage, mThreadId, sl_profiler_time(), mTotalTime);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+inline SL_ProfileTotal::SL_ProfileTotal(SL_ProfileStage stage, uint16_t threadId) noexcept :
+    mLastTime{0},
+    mTotalTime{0},
+    mStage{stage},
+    mThreadId{threadId},
+    mActive{sl_profiler_active()}
+{}
+
+
+
+/*-------------------------------------
+ * Begin timing one run of the stage
+-------------------------------------*/
+inline void SL_ProfileTotal::begin() noexcept
+{
+    if (mActive)
+    {
+        sl_profiler_running_total() = this;
+        mLastTime = sl_profiler_time();
+    }
+}
+
+
+
+/*-------------------------------------
+ * Add the time since begin() to the total
+-------------------------------------*/
+inline void SL_ProfileTotal::end() noexcept
+{
+    if (mActive)
+    {
+        // Keep the total non-zero so the event is recorded
+        const uint64_t elapsed = sl_profiler_time() - mLastTime;
+        mTotalTime += elapsed ? elapsed : 1u;
+        sl_profiler_running_total() = nullptr;
+    }
+}
+
+
+
+/*-------------------------------------
+ * Destructor
+-------------------------------------*/
+inline SL_ProfileScope::~SL_ProfileScope() noexcept
+{
+    if (mActive)
+    {
+        sl_profiler_record(mStage, mThreadId, mBeginTime, sl_profiler_time());
+
+        if (mPausedTotal)
+        {
+            mPausedTotal->begin();
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+inline SL_ProfileScope::SL_ProfileScope(SL_ProfileStage stage, uint16_t threadId) noexcept :
+    mBeginTime{0},
+    mPausedTotal{nullptr},
+    mStage{stage},
+    mThreadId{threadId},
+    mActive{sl_profiler_active()}
+{
+    if (mActive)
+    {
+        mPausedTotal = sl_profiler_running_total();
+
+        if (mPausedTotal)
+        {
+            mPausedTotal->end();
+        }
+
+        mBeginTime = sl_profiler_time();
+    }
+}
+
+
+
+#define SL_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SL_PROFILE_CONCAT(a, b) SL_PROFILE_CONCAT_IMPL(a, b)
+
+#define SL_PROFILE_SCOPE(stage, threadId) const SL_ProfileScope SL_PROFILE_CONCAT(_slProfileScope, __LINE__){(stage), (uint16_t)(threadId)}
+
+#define SL_PROFILE_TOTAL(name, stage, threadId) SL_ProfileTotal name{(stage), (uint16_t)(threadId)}
+
+#define SL_PROFILE_TOTAL_BEGIN(name) (name).begin()
+
+#define SL_PROFILE_TOTAL_END(name) (name).end()
+
+
+
+#else /* !SL_PROFILING_ENABLED */
+
+
+
+/*-----------------------------------------------------------------------------
+ * Profiling is compiled out. These stubs allow applications to keep their
+ * profiling calls without preprocessor checks.
+-----------------------------------------------------------------------------*/
+inline int sl_profiler_begin(unsigned) noexcept
+{
+    return -1;
+}
+
+inline void sl_profiler_end() noexcept
+{
+}
+
+inline void sl_profiler_terminate() noexcept
+{
+}
+
+inline bool sl_profiler_active() noexcept
+{
+    return false;
+}
+
+inline uint64_t sl_profiler_num_events() noexcept
+{
+    return 0;
+}
+
+inline uint64_t sl_profiler_num_dropped() noexcept
+{
+    return 0;
+}
+
+inline int sl_profiler_save_trace(const char* const) noexcept
+{
+    return -1;
+}
+
+#define SL_PROFILE_SCOPE(stage, threadId)
+
+#define SL_PROFILE_TOTAL(name, stage, threadId)
+
+#define SL_PROFILE_TOTAL_BEGIN(name)
+
+#define SL_PROFILE_TOTAL_END(name)
+
+#endif /* SL_PROFILING_ENABLED */
+
+
+
+#endif /* SL_PROFILER_HPP */
@@ -10,6 +10,7 @@
 #define SL_RENDER_WINDOW_HPP
 
 #include <cstddef> // ptrdiff_t
+#include <cstdint> // uint64_t
 
 #include "lightsky/utils/Pointer.h"
 
@@ -46,9 +47,18 @@ class SL_RenderWindow
   public:
     static ls::utils::Pointer<SL_RenderWindow> create() noexcept;
 
+    // Create a window which renders to memory without a display
+    static ls::utils::Pointer<SL_RenderWindow> create_headless() noexcept;
+
   protected:
     WindowStateInfo mCurrentState;
 
+    // Serial numbers of the last frame submitted through present() and the
+    // last frame the windowing system has finished reading.
+    uint64_t mPresentsQueued;
+
+    uint64_t mPresentsCompleted;
+
   public:
     virtual ~SL_RenderWindow()  noexcept = 0;
 
@@ -108,6 +118,20 @@ class SL_RenderWindow
 
     virtual void render(SL_WindowBuffer& buffer) noexcept = 0;
 
+    // Present only the damaged regions of a window buffer, then clear its
+    // damage. The default implementation presents the entire buffer if any
+    // region has been damaged.
+    virtual void render_damage(SL_WindowBuffer& buffer) noexcept;
+
+    // Asynchronous presentation. A window buffer passed into present() must
+    // not be modified until presents_completed() reaches the returned serial
+    // number. The default implementations present synchronously.
+    virtual uint64_t present(SL_WindowBuffer& buffer) noexcept;
+
+    virtual uint64_t presents_completed() noexcept;
+
+    virtual void wait_for_present(uint64_t serial) noexcept;
+
     virtual void set_mouse_capture(bool isCaptured) noexcept = 0;
 
     virtual bool is_mouse_captured() const noexcept = 0;
@@ -0,0 +1,233 @@
+
+#ifndef SL_RENDER_WINDOW_HEADLESS_HPP
+#define SL_RENDER_WINDOW_HEADLESS_HPP
+
+#include "softlight/SL_RenderWindow.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Headless Render Window
+ *
+ * This window has no connection to a windowing system and never produces
+ * events. Window buffers presented to it are kept in memory, allowing
+ * applications to run on machines without a display. The most recently
+ * presented buffer can be retrieved through last_frame().
+-----------------------------------------------------------------------------*/
+class SL_RenderWindowHeadless final : public SL_RenderWindow
+{
+  private:
+    unsigned mWidth;
+
+    unsigned mHeight;
+
+    int mX;
+
+    int mY;
+
+    bool mKeysRepeat;
+
+    bool mCaptureMouse;
+
+    const SL_WindowBuffer* mLastFrame;
+
+  public:
+    virtual ~SL_RenderWindowHeadless() noexcept override;
+
+    SL_RenderWindowHeadless() noexcept;
+
+    SL_RenderWindowHeadless(const SL_RenderWindowHeadless&) noexcept;
+
+    SL_RenderWindowHeadless(SL_RenderWindowHeadless&&) noexcept;
+
+    SL_RenderWindowHeadless& operator=(const SL_RenderWindowHeadless&) noexcept;
+
+    SL_RenderWindowHeadless& operator=(SL_RenderWindowHeadless&&) noexcept;
+
+    virtual int set_title(const char* const pName) noexcept override;
+
+    virtual int init(unsigned width = 640, unsigned height = 480) noexcept override;
+
+    virtual int destroy() noexcept override;
+
+    virtual unsigned width() const noexcept override;
+
+    virtual unsigned height() const noexcept override;
+
+    virtual void get_size(unsigned& w, unsigned& h) const noexcept override;
+
+    virtual bool set_size(unsigned w, unsigned h) noexcept override;
+
+    virtual int x_position() const noexcept override;
+
+    virtual int y_position() const noexcept override;
+
+    virtual bool get_position(int& x, int& y) const noexcept override;
+
+    virtual bool set_position(int x, int y) noexcept override;
+
+    virtual SL_RenderWindow* clone() const noexcept override;
+
+    virtual bool valid() const noexcept override;
+
+    virtual WindowStateInfo state() const noexcept override;
+
+    virtual void update() noexcept override;
+
+    virtual bool pause() noexcept override;
+
+    virtual bool run() noexcept override;
+
+    virtual bool has_event() const noexcept override;
+
+    virtual bool peek_event(SL_WindowEvent* const pEvent) noexcept override;
+
+    virtual bool pop_event(SL_WindowEvent* const pEvent) noexcept override;
+
+    virtual bool set_keys_repeat(bool doKeysRepeat) noexcept override;
+
+    virtual bool keys_repeat() const noexcept override;
+
+    virtual void render(SL_WindowBuffer& buffer) noexcept override;
+
+    virtual void set_mouse_capture(bool isCaptured) noexcept override;
+
+    virtual bool is_mouse_captured() const noexcept override;
+
+    virtual void* native_handle() noexcept override;
+
+    virtual const void* native_handle() const noexcept override;
+
+    virtual unsigned dpi() const noexcept override;
+
+    void request_clipboard() const noexcept override;
+
+    const SL_WindowBuffer* last_frame() const noexcept;
+};
+
+
+
+/*-------------------------------------
+ * Retrieve the window width
+-------------------------------------*/
+inline unsigned SL_RenderWindowHeadless::width() const noexcept
+{
+    return mWidth;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the window height
+-------------------------------------*/
+inline unsigned SL_RenderWindowHeadless::height() const noexcept
+{
+    return mHeight;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the window size
+-------------------------------------*/
+inline void SL_RenderWindowHeadless::get_size(unsigned& w, unsigned& h) const noexcept
+{
+    w = width();
+    h = height();
+}
+
+
+
+/*-------------------------------------
+ * Get the window position (X)
+-------------------------------------*/
+inline int SL_RenderWindowHeadless::x_position() const noexcept
+{
+    return mX;
+}
+
+
+
+/*-------------------------------------
+ * Get the window position (Y)
+-------------------------------------*/
+inline int SL_RenderWindowHeadless::y_position() const noexcept
+{
+    return mY;
+}
+
+
+
+/*-------------------------------------
+ * Get the window position
+-------------------------------------*/
+inline bool SL_RenderWindowHeadless::get_position(int& x, int& y) const noexcept
+{
+    x = x_position();
+    y = y_position();
+    return true;
+}
+
+
+
+/*-------------------------------------
+ * Determine the window state
+-------------------------------------*/
+inline WindowStateInfo SL_RenderWindowHeadless::state() const noexcept
+{
+    return mCurrentState;
+}
+
+
+
+/*-------------------------------------
+ * Check if keyboard keys repeat.
+-------------------------------------*/
+inline bool SL_RenderWindowHeadless::keys_repeat() const noexcept
+{
+    return mKeysRepeat;
+}
+
+
+
+/*-------------------------------------
+ * Check if the mouse is captured
+-------------------------------------*/
+inline bool SL_RenderWindowHeadless::is_mouse_captured() const noexcept
+{
+    return mCaptureMouse;
+}
+
+
+
+/*-------------------------------------
+ * Get the native window handle
+-------------------------------------*/
+inline void* SL_RenderWindowHeadless::native_handle() noexcept
+{
+    return nullptr;
+}
+
+
+
+/*-------------------------------------
+ * Get the native window handle
+-------------------------------------*/
+inline const void* SL_RenderWindowHeadless::native_handle() const noexcept
+{
+    return nullptr;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the most recently presented window buffer
+-------------------------------------*/
+inline const SL_WindowBuffer* SL_RenderWindowHeadless::last_frame() const noexcept
+{
+    return mLastFrame;
+}
+
+
+
+#endif /* SL_RENDER_WINDOW_HEADLESS_HPP */
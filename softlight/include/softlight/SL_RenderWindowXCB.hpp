@@ -18,6 +18,13 @@ class SL_RenderWindowXCB final : public SL_RenderWindow
 {
     friend class SL_WindowBufferXlib;
 
+  public:
+    enum : unsigned
+    {
+        // Number of frames which can be queued by present() before it blocks
+        SL_XCB_MAX_PENDING_PRESENTS = 4
+    };
+
   private:
     _XDisplay* mDisplay;
 
@@ -51,6 +58,10 @@ class SL_RenderWindowXCB final : public SL_RenderWindow
 
     unsigned char* mClipboard;
 
+    // Sequence numbers of the round-trip requests issued after each
+    // present(), indexed by (serial % SL_XCB_MAX_PENDING_PRESENTS).
+    unsigned mPresentSequences[SL_XCB_MAX_PENDING_PRESENTS];
+
     unsigned char* read_clipboard(const void*) const noexcept;
 
   public:
@@ -112,6 +123,14 @@ class SL_RenderWindowXCB final : public SL_RenderWindow
 
     virtual void render(SL_WindowBuffer& buffer) noexcept override;
 
+    virtual void render_damage(SL_WindowBuffer& buffer) noexcept override;
+
+    virtual uint64_t present(SL_WindowBuffer& buffer) noexcept override;
+
+    virtual uint64_t presents_completed() noexcept override;
+
+    virtual void wait_for_present(uint64_t serial) noexcept override;
+
     virtual void set_mouse_capture(bool isCaptured) noexcept override;
 
     virtual bool is_mouse_captured() const noexcept override;
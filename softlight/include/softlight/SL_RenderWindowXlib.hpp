@@ -45,6 +45,9 @@ class SL_RenderWindowXlib final : public SL_RenderWindow
 
     unsigned char* mClipboard;
 
+    // Event type sent by the X server after reading a shared-memory image
+    int mShmCompletionType;
+
     unsigned char* read_clipboard(const _XEvent*) const noexcept;
 
   public:
@@ -106,6 +109,14 @@ class SL_RenderWindowXlib final : public SL_RenderWindow
 
     virtual void render(SL_WindowBuffer& buffer) noexcept override;
 
+    virtual void render_damage(SL_WindowBuffer& buffer) noexcept override;
+
+    virtual uint64_t present(SL_WindowBuffer& buffer) noexcept override;
+
+    virtual uint64_t presents_completed() noexcept override;
+
+    virtual void wait_for_present(uint64_t serial) noexcept override;
+
     virtual void set_mouse_capture(bool isCaptured) noexcept override;
 
     virtual bool is_mouse_captured() const noexcept override;
@@ -2,12 +2,18 @@
 #ifndef SL_SAMPLER_HPP
 #define SL_SAMPLER_HPP
 
+#include <cstring> // std::memcpy()
+
+#include "lightsky/setup/Macros.h" // LS_LIKELY
 #include "lightsky/setup/Types.h"
 
 #include "lightsky/math/scalar_utils.h"
 #include "lightsky/math/fixed.h"
 
+#include "softlight/SL_ColorSRGB.hpp"
+#include "softlight/SL_PackedColor.hpp"
 #include "softlight/SL_Texture.hpp"
+#include "softlight/SL_TextureCompression.hpp"
 
 
 
@@ -139,8 +145,8 @@ inline LS_INLINE color_type sl_sample_nearest(const SL_Texture& tex, float x, fl
     const float wy = wrapMode(y);
 
     #if 1
-        const uint32_t xi = (uint_fast32_t)((float)tex.width()  * wx);
-        const uint32_t yi = (uint_fast32_t)((float)tex.height() * wy);
+        const uint32_t xi = ls::math::min<uint32_t>((uint32_t)((float)tex.width()  * wx), tex.width()-1u);
+        const uint32_t yi = ls::math::min<uint32_t>((uint32_t)((float)tex.height() * wy), tex.height()-1u);
     #else
         typedef typename SL_Texture::fixed_type fixed_type;
         const fixed_type    xf = ls::math::fixed_cast<fixed_type, float>(wx);
@@ -167,9 +173,9 @@ inline LS_INLINE color_type sl_sample_nearest(const SL_Texture& tex, float x, fl
     const float wz = wrapMode(z);
 
     #if 1
-        const uint32_t xi = (uint_fast32_t)((float)tex.width()  * wx);
-        const uint32_t yi = (uint_fast32_t)((float)tex.height() * wy);
-        const uint32_t zi = (uint_fast32_t)ls::math::round((float)tex.depth() * wz);
+        const uint32_t xi = ls::math::min<uint32_t>((uint32_t)((float)tex.width()  * wx), tex.width()-1u);
+        const uint32_t yi = ls::math::min<uint32_t>((uint32_t)((float)tex.height() * wy), tex.height()-1u);
+        const uint32_t zi = ls::math::min<uint32_t>((uint32_t)((float)tex.depth() * wz + 0.5f), tex.depth()-1u);
     #else
         typedef typename SL_Texture::fixed_type fixed_type;
         const fixed_type    xf = ls::math::fixed_cast<fixed_type, float>(wx);
@@ -198,10 +204,10 @@ inline LS_INLINE color_type sl_sample_bilinear(const SL_Texture& tex, float x, f
 
     const float    xf      = wrapMode(x) * (float)tex.width();
     const float    yf      = wrapMode(y) * (float)tex.height();
-    const uint16_t xi0     = (uint16_t)xf;
-    const uint16_t yi0     = (uint16_t)yf;
-    const uint16_t xi1     = ls::math::clamp<uint16_t>(xi0+1u, 0u, tex.width());
-    const uint16_t yi1     = ls::math::clamp<uint16_t>(yi0+1u, 0u, tex.height());
+    const uint16_t xi0     = ls::math::min<uint16_t>((uint16_t)xf, tex.width()-1u);
+    const uint16_t yi0     = ls::math::min<uint16_t>((uint16_t)yf, tex.height()-1u);
+    const uint16_t xi1     = ls::math::min<uint16_t>(xi0+1u, tex.width()-1u);
+    const uint16_t yi1     = ls::math::min<uint16_t>(yi0+1u, tex.height()-1u);
     const float    dx      = xf - (float)xi0;
     const float    dy      = yf - (float)yi0;
     const float    omdx    = 1.f - dx;
@@ -232,11 +238,11 @@ inline LS_INLINE color_type sl_sample_bilinear(const SL_Texture& tex, float x, f
 
     const float    xf      = wrapMode(x) * (float)tex.width();
     const float    yf      = wrapMode(y) * (float)tex.height();
-    const uint16_t zi      = (uint16_t)ls::math::round(wrapMode(z) * (float)tex.depth());
-    const uint16_t xi0     = (uint16_t)xf;
-    const uint16_t yi0     = (uint16_t)yf;
-    const uint16_t xi1     = ls::math::clamp<uint16_t>(xi0+1u, 0u, tex.width());
-    const uint16_t yi1     = ls::math::clamp<uint16_t>(yi0+1u, 0u, tex.height());
+    const uint16_t zi      = ls::math::min<uint16_t>((uint16_t)(wrapMode(z) * (float)tex.depth() + 0.5f), tex.depth()-1u);
+    const uint16_t xi0     = ls::math::min<uint16_t>((uint16_t)xf, tex.width()-1u);
+    const uint16_t yi0     = ls::math::min<uint16_t>((uint16_t)yf, tex.height()-1u);
+    const uint16_t xi1     = ls::math::min<uint16_t>(xi0+1u, tex.width()-1u);
+    const uint16_t yi1     = ls::math::min<uint16_t>(yi0+1u, tex.height()-1u);
     const float    dx      = xf - (float)xi0;
     const float    dy      = yf - (float)yi0;
     const float    omdx    = 1.f - dx;
@@ -281,11 +287,11 @@ inline LS_INLINE color_type sl_sample_trilinear(const SL_Texture& tex, float x,
     namespace math = ls::math;
 
     x = wrapMode(x) * (float)tex.width();
-    const uint16_t xi = (uint16_t)x;
+    const uint16_t xi = ls::math::min<uint16_t>((uint16_t)x, tex.width()-1u);
     const uint16_t si = (uint16_t)math::max(x-1.f, 0.f);
 
     y = wrapMode(y) * (float)tex.height();
-    const uint16_t yi = (uint16_t)y;
+    const uint16_t yi = ls::math::min<uint16_t>((uint16_t)y, tex.height()-1u);
     const uint16_t ti = (uint16_t)math::max(y-1.f, 0.f);
 
     const auto&& c000 = color_cast<float, typename color_type::value_type>(tex.texel<color_type, order>(si, ti));
@@ -333,15 +339,15 @@ inline LS_INLINE color_type sl_sample_trilinear(const SL_Texture& tex, float x,
     namespace math = ls::math;
 
     x = wrapMode(x) * (float)tex.width();
-    const uint16_t xi = (uint16_t)x;
+    const uint16_t xi = ls::math::min<uint16_t>((uint16_t)x, tex.width()-1u);
     const uint16_t si = math::max(x-1.f, 0.f);
 
     y = wrapMode(y) * (float)tex.height();
-    const uint16_t yi = (uint16_t)y;
+    const uint16_t yi = ls::math::min<uint16_t>((uint16_t)y, tex.height()-1u);
     const uint16_t ti = math::max(y-1.f, 0.f);
 
     z = wrapMode(z) * (float)tex.depth();
-    const uint16_t zi = (uint16_t)z;
+    const uint16_t zi = ls::math::min<uint16_t>((uint16_t)z, tex.depth()-1u);
     const uint16_t ri = math::max(z-1.f, 0.f);
 
     const auto&& c000 = color_cast<float, typename color_type::value_type>(tex.texel<color_type, order>(si, ti, ri));
@@ -385,4 +391,1053 @@ inline LS_INLINE color_type sl_sample_trilinear(const SL_Texture& tex, float x,
 
 
 
+/*-----------------------------------------------------------------------------
+ * Array Texture Sampling
+ *
+ * Wrapping and filtering are applied within a single layer, so neighboring
+ * layers never bleed into each other.
+-----------------------------------------------------------------------------*/
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TEXELS_ORDERED>
+inline LS_INLINE color_type sl_sample_nearest_array(const SL_Texture& tex, float x, float y, uint16_t layer) noexcept
+{
+    if (SL_WrapMode::SL_IsWrapModeBorder<WrapMode>::value && (x < 0.f || x >= 1.f || y < 0.f || y >= 1.f))
+    {
+        return color_type{0};
+    }
+
+    constexpr WrapMode wrapMode;
+
+    const uint16_t xi = (uint16_t)ls::math::min<uint32_t>((uint32_t)((float)tex.width()  * wrapMode(x)), tex.width()-1u);
+    const uint16_t yi = (uint16_t)ls::math::min<uint32_t>((uint32_t)((float)tex.height() * wrapMode(y)), tex.height()-1u);
+
+    return tex.layer_texel<color_type, order>(xi, yi, layer);
+}
+
+
+
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TEXELS_ORDERED>
+inline LS_INLINE color_type sl_sample_bilinear_array(const SL_Texture& tex, float x, float y, uint16_t layer) noexcept
+{
+    if (SL_WrapMode::SL_IsWrapModeBorder<WrapMode>::value && (x < 0.f || x >= 1.f || y < 0.f || y >= 1.f))
+    {
+        return color_type{0};
+    }
+
+    constexpr WrapMode wrapMode;
+
+    const uint16_t maxX    = (uint16_t)(tex.width()-1u);
+    const uint16_t maxY    = (uint16_t)(tex.height()-1u);
+    const float    xf      = wrapMode(x) * (float)maxX;
+    const float    yf      = wrapMode(y) * (float)maxY;
+    const uint16_t xi0     = (uint16_t)xf;
+    const uint16_t yi0     = (uint16_t)yf;
+    const uint16_t xi1     = ls::math::min<uint16_t>(xi0+1u, maxX);
+    const uint16_t yi1     = ls::math::min<uint16_t>(yi0+1u, maxY);
+    const float    dx      = xf - (float)xi0;
+    const float    dy      = yf - (float)yi0;
+    const float    omdx    = 1.f - dx;
+    const float    omdy    = 1.f - dy;
+    const auto&&   pixel0  = color_cast<float, typename color_type::value_type>(tex.layer_texel<color_type, order>(xi0, yi0, layer));
+    const auto&&   pixel1  = color_cast<float, typename color_type::value_type>(tex.layer_texel<color_type, order>(xi0, yi1, layer));
+    const auto&&   pixel2  = color_cast<float, typename color_type::value_type>(tex.layer_texel<color_type, order>(xi1, yi0, layer));
+    const auto&&   pixel3  = color_cast<float, typename color_type::value_type>(tex.layer_texel<color_type, order>(xi1, yi1, layer));
+    const auto&&   weight0 = pixel0 * omdx * omdy;
+    const auto&&   weight1 = pixel1 * omdx * dy;
+    const auto&&   weight2 = pixel2 * dx * omdy;
+    const auto&&   weight3 = pixel3 * dx * dy;
+
+    const auto&& ret = ls::math::sum(weight0, weight1, weight2, weight3);
+
+    return color_cast<typename color_type::value_type, float>(ret);
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Cube Map Sampling
+ *
+ * Faces follow the usual cube map conventions, with the vertical axis flipped
+ * to match images loaded bottom-up by SL_ImgFile. Direction vectors do not
+ * need to be normalized.
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Select a cube face and calculate its 2D texture coordinates
+-------------------------------------*/
+inline LS_INLINE SL_CubeFace sl_cube_face_uv(float x, float y, float z, float& outS, float& outT) noexcept
+{
+    const float ax = ls::math::abs(x);
+    const float ay = ls::math::abs(y);
+    const float az = ls::math::abs(z);
+    SL_CubeFace face;
+    float       sc;
+    float       tc;
+    float       ma;
+
+    if (ax >= ay && ax >= az)
+    {
+        face = (x >= 0.f) ? SL_CUBE_FACE_POSITIVE_X : SL_CUBE_FACE_NEGATIVE_X;
+        sc   = (x >= 0.f) ? -z : z;
+        tc   = y;
+        ma   = ax;
+    }
+    else if (ay >= az)
+    {
+        face = (y >= 0.f) ? SL_CUBE_FACE_POSITIVE_Y : SL_CUBE_FACE_NEGATIVE_Y;
+        sc   = x;
+        tc   = (y >= 0.f) ? -z : z;
+        ma   = ay;
+    }
+    else
+    {
+        face = (z >= 0.f) ? SL_CUBE_FACE_POSITIVE_Z : SL_CUBE_FACE_NEGATIVE_Z;
+        sc   = (z >= 0.f) ? x : -x;
+        tc   = y;
+        ma   = az;
+    }
+
+    const float scale = 0.5f * ls::math::rcp(ls::math::max(ma, 1.e-20f));
+
+    outS = ls::math::clamp(sc * scale + 0.5f, 0.f, 1.f);
+    outT = ls::math::clamp(tc * scale + 0.5f, 0.f, 1.f);
+
+    return face;
+}
+
+
+
+/*-------------------------------------
+ * Fetch a texel which may lie outside of its face. Out-of-bounds texels are
+ * projected back onto the cube so filtering is seamless across edges.
+-------------------------------------*/
+template <typename color_type, SL_TexelOrder order = SL_TEXELS_ORDERED>
+inline color_type sl_cube_edge_texel(const SL_Texture& tex, SL_CubeFace face, int x, int y) noexcept
+{
+    const int size = (int)tex.width();
+
+    if (LS_LIKELY(x >= 0 && y >= 0 && x < size && y < size))
+    {
+        return tex.layer_texel<color_type, order>((uint16_t)x, (uint16_t)y, face);
+    }
+
+    const float scale = 2.f * ls::math::rcp((float)size);
+    const float sc    = ((float)x + 0.5f) * scale - 1.f;
+    const float tc    = ((float)y + 0.5f) * scale - 1.f;
+    float       dir[3];
+
+    switch (face)
+    {
+        case SL_CUBE_FACE_POSITIVE_X: dir[0] = 1.f;  dir[1] = tc;   dir[2] = -sc; break;
+        case SL_CUBE_FACE_NEGATIVE_X: dir[0] = -1.f; dir[1] = tc;   dir[2] = sc;  break;
+        case SL_CUBE_FACE_POSITIVE_Y: dir[0] = sc;   dir[1] = 1.f;  dir[2] = -tc; break;
+        case SL_CUBE_FACE_NEGATIVE_Y: dir[0] = sc;   dir[1] = -1.f; dir[2] = tc;  break;
+        case SL_CUBE_FACE_POSITIVE_Z: dir[0] = sc;   dir[1] = tc;   dir[2] = 1.f; break;
+        default:                      dir[0] = -sc;  dir[1] = tc;   dir[2] = -1.f;
+    }
+
+    float s, t;
+    const SL_CubeFace newFace = sl_cube_face_uv(dir[0], dir[1], dir[2], s, t);
+    const uint16_t    xi      = (uint16_t)ls::math::min<int>((int)(s * (float)size), size-1);
+    const uint16_t    yi      = (uint16_t)ls::math::min<int>((int)(t * (float)size), size-1);
+
+    return tex.layer_texel<color_type, order>(xi, yi, newFace);
+}
+
+
+
+template <typename color_type, SL_TexelOrder order = SL_TEXELS_ORDERED>
+inline LS_INLINE color_type sl_sample_cube_nearest(const SL_Texture& tex, float x, float y, float z) noexcept
+{
+    float s, t;
+    const SL_CubeFace face = sl_cube_face_uv(x, y, z, s, t);
+    const uint32_t    maxXY = tex.width() - 1u;
+    const uint16_t    xi    = (uint16_t)ls::math::min<uint32_t>((uint32_t)((float)tex.width()  * s), maxXY);
+    const uint16_t    yi    = (uint16_t)ls::math::min<uint32_t>((uint32_t)((float)tex.height() * t), maxXY);
+
+    return tex.layer_texel<color_type, order>(xi, yi, face);
+}
+
+
+
+template <typename color_type, SL_TexelOrder order = SL_TEXELS_ORDERED>
+inline LS_INLINE color_type sl_sample_cube_bilinear(const SL_Texture& tex, float x, float y, float z) noexcept
+{
+    float s, t;
+    const SL_CubeFace face = sl_cube_face_uv(x, y, z, s, t);
+
+    // Filter between texel centers. Taps which cross a face's edge are
+    // resolved by sl_cube_edge_texel().
+    const float    xf      = s * (float)tex.width() - 0.5f;
+    const float    yf      = t * (float)tex.height() - 0.5f;
+    const int      xi0     = (int)(xf + 1.f) - 1;
+    const int      yi0     = (int)(yf + 1.f) - 1;
+    const int      xi1     = xi0 + 1;
+    const int      yi1     = yi0 + 1;
+    const float    dx      = xf - (float)xi0;
+    const float    dy      = yf - (float)yi0;
+    const float    omdx    = 1.f - dx;
+    const float    omdy    = 1.f - dy;
+    const auto&&   pixel0  = color_cast<float, typename color_type::value_type>(sl_cube_edge_texel<color_type, order>(tex, face, xi0, yi0));
+    const auto&&   pixel1  = color_cast<float, typename color_type::value_type>(sl_cube_edge_texel<color_type, order>(tex, face, xi0, yi1));
+    const auto&&   pixel2  = color_cast<float, typename color_type::value_type>(sl_cube_edge_texel<color_type, order>(tex, face, xi1, yi0));
+    const auto&&   pixel3  = color_cast<float, typename color_type::value_type>(sl_cube_edge_texel<color_type, order>(tex, face, xi1, yi1));
+    const auto&&   weight0 = pixel0 * omdx * omdy;
+    const auto&&   weight1 = pixel1 * omdx * dy;
+    const auto&&   weight2 = pixel2 * dx * omdy;
+    const auto&&   weight3 = pixel3 * dx * dy;
+
+    const auto&& ret = ls::math::sum(weight0, weight1, weight2, weight3);
+
+    return color_cast<typename color_type::value_type, float>(ret);
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Block-Compressed Texture Sampling
+ *
+ * Compressed textures (BC1, BC3, BC4, BC5) are decoded on-fetch through a
+ * small per-thread block cache. Texels are returned in an 8-bit format: BC4
+ * should be sampled as SL_ColorR8, BC5 as SL_ColorRG8, and BC1/BC3 as
+ * SL_ColorRGB8 or SL_ColorRGBA8.
+-----------------------------------------------------------------------------*/
+template <typename color_type>
+inline LS_INLINE color_type sl_bc_texel_cast(const SL_ColorRGBA8& c) noexcept;
+
+template <>
+inline LS_INLINE SL_ColorR8 sl_bc_texel_cast<SL_ColorR8>(const SL_ColorRGBA8& c) noexcept
+{
+    return SL_ColorR8{c[0]};
+}
+
+template <>
+inline LS_INLINE SL_ColorRG8 sl_bc_texel_cast<SL_ColorRG8>(const SL_ColorRGBA8& c) noexcept
+{
+    return SL_ColorRG8{c[0], c[1]};
+}
+
+template <>
+inline LS_INLINE SL_ColorRGB8 sl_bc_texel_cast<SL_ColorRGB8>(const SL_ColorRGBA8& c) noexcept
+{
+    return SL_ColorRGB8{c[0], c[1], c[2]};
+}
+
+template <>
+inline LS_INLINE SL_ColorRGBA8 sl_bc_texel_cast<SL_ColorRGBA8>(const SL_ColorRGBA8& c) noexcept
+{
+    return c;
+}
+
+
+
+template <typename color_type, class WrapMode>
+inline LS_INLINE color_type sl_sample_compressed_nearest(const SL_Texture& tex, float x, float y) noexcept
+{
+    if (SL_WrapMode::SL_IsWrapModeBorder<WrapMode>::value && (x < 0.f || x >= 1.f || y < 0.f || y >= 1.f))
+    {
+        return color_type{0};
+    }
+
+    constexpr WrapMode wrapMode;
+
+    const uint16_t xi = (uint16_t)ls::math::min<uint32_t>((uint32_t)((float)tex.width()  * wrapMode(x)), tex.width()-1u);
+    const uint16_t yi = (uint16_t)ls::math::min<uint32_t>((uint32_t)((float)tex.height() * wrapMode(y)), tex.height()-1u);
+
+    return sl_bc_texel_cast<color_type>(sl_fetch_compressed_texel(tex, xi, yi));
+}
+
+
+
+template <typename color_type, class WrapMode>
+inline LS_INLINE color_type sl_sample_compressed_bilinear(const SL_Texture& tex, float x, float y) noexcept
+{
+    if (SL_WrapMode::SL_IsWrapModeBorder<WrapMode>::value && (x < 0.f || x >= 1.f || y < 0.f || y >= 1.f))
+    {
+        return color_type{0};
+    }
+
+    constexpr WrapMode wrapMode;
+
+    const uint16_t maxX    = (uint16_t)(tex.width()-1u);
+    const uint16_t maxY    = (uint16_t)(tex.height()-1u);
+    const float    xf      = wrapMode(x) * (float)maxX;
+    const float    yf      = wrapMode(y) * (float)maxY;
+    const uint16_t xi0     = (uint16_t)xf;
+    const uint16_t yi0     = (uint16_t)yf;
+    const uint16_t xi1     = ls::math::min<uint16_t>(xi0+1u, maxX);
+    const uint16_t yi1     = ls::math::min<uint16_t>(yi0+1u, maxY);
+    const float    dx      = xf - (float)xi0;
+    const float    dy      = yf - (float)yi0;
+    const float    omdx    = 1.f - dx;
+    const float    omdy    = 1.f - dy;
+
+    // Most taps land in the same block, which stays hot in the thread's cache
+    const auto&&   pixel0  = color_cast<float, uint8_t>(sl_fetch_compressed_texel(tex, xi0, yi0));
+    const auto&&   pixel1  = color_cast<float, uint8_t>(sl_fetch_compressed_texel(tex, xi0, yi1));
+    const auto&&   pixel2  = color_cast<float, uint8_t>(sl_fetch_compressed_texel(tex, xi1, yi0));
+    const auto&&   pixel3  = color_cast<float, uint8_t>(sl_fetch_compressed_texel(tex, xi1, yi1));
+    const auto&&   weight0 = pixel0 * omdx * omdy;
+    const auto&&   weight1 = pixel1 * omdx * dy;
+    const auto&&   weight2 = pixel2 * dx * omdy;
+    const auto&&   weight3 = pixel3 * dx * dy;
+
+    const auto&& ret = ls::math::sum(weight0, weight1, weight2, weight3);
+
+    return sl_bc_texel_cast<color_type>(color_cast<uint8_t, float>(ret));
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Packed Texture Sampling
+ *
+ * Packed textures (RGB565, RGB10A2, R11G11B10F) are sampled using their
+ * matching type from SL_PackedColor.hpp. Texels are unpacked to floats
+ * before filtering.
+-----------------------------------------------------------------------------*/
+template <class packed_color, class WrapMode, SL_TexelOrder order = SL_TEXELS_ORDERED>
+inline LS_INLINE ls::math::vec4 sl_sample_packed_nearest(const SL_Texture& tex, float x, float y) noexcept
+{
+    return packed_color::unpack(sl_sample_nearest<SL_ColorRType<typename packed_color::packed_type>, WrapMode, order>(tex, x, y).r);
+}
+
+
+
+template <class packed_color, class WrapMode, SL_TexelOrder order = SL_TEXELS_ORDERED>
+inline LS_INLINE ls::math::vec4 sl_sample_packed_bilinear(const SL_Texture& tex, float x, float y) noexcept
+{
+    typedef typename packed_color::packed_type packed_type;
+
+    if (SL_WrapMode::SL_IsWrapModeBorder<WrapMode>::value && (x < 0.f || x >= 1.f || y < 0.f || y >= 1.f))
+    {
+        return ls::math::vec4{0.f};
+    }
+
+    constexpr WrapMode wrapMode;
+
+    const float    xf      = wrapMode(x) * (float)tex.width();
+    const float    yf      = wrapMode(y) * (float)tex.height();
+    const uint16_t xi0     = ls::math::min<uint16_t>((uint16_t)xf, tex.width()-1u);
+    const uint16_t yi0     = ls::math::min<uint16_t>((uint16_t)yf, tex.height()-1u);
+    const uint16_t xi1     = ls::math::min<uint16_t>(xi0+1u, tex.width()-1u);
+    const uint16_t yi1     = ls::math::min<uint16_t>(yi0+1u, tex.height()-1u);
+    const float    dx      = xf - (float)xi0;
+    const float    dy      = yf - (float)yi0;
+    const float    omdx    = 1.f - dx;
+    const float    omdy    = 1.f - dy;
+
+    const ls::math::vec4&& pixel0 = packed_color::unpack(tex.texel<packed_type, order>(xi0, yi0));
+    const ls::math::vec4&& pixel1 = packed_color::unpack(tex.texel<packed_type, order>(xi0, yi1));
+    const ls::math::vec4&& pixel2 = packed_color::unpack(tex.texel<packed_type, order>(xi1, yi0));
+    const ls::math::vec4&& pixel3 = packed_color::unpack(tex.texel<packed_type, order>(xi1, yi1));
+
+    return ls::math::sum(pixel0 * (omdx * omdy), pixel1 * (omdx * dy), pixel2 * (dx * omdy), pixel3 * (dx * dy));
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * sRGB Texture Sampling
+ *
+ * sRGB textures are sampled as either SL_ColorRGB8 or SL_ColorRGBA8. Texels
+ * are decoded into linear space through a lookup table before filtering.
+-----------------------------------------------------------------------------*/
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TEXELS_ORDERED>
+inline LS_INLINE ls::math::vec4 sl_sample_srgb_nearest(const SL_Texture& tex, float x, float y) noexcept
+{
+    return sl_srgb_to_linear(sl_sample_nearest<color_type, WrapMode, order>(tex, x, y));
+}
+
+
+
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TEXELS_ORDERED>
+inline LS_INLINE ls::math::vec4 sl_sample_srgb_bilinear(const SL_Texture& tex, float x, float y) noexcept
+{
+    if (SL_WrapMode::SL_IsWrapModeBorder<WrapMode>::value && (x < 0.f || x >= 1.f || y < 0.f || y >= 1.f))
+    {
+        return ls::math::vec4{0.f};
+    }
+
+    constexpr WrapMode wrapMode;
+
+    const float    xf      = wrapMode(x) * (float)tex.width();
+    const float    yf      = wrapMode(y) * (float)tex.height();
+    const uint16_t xi0     = ls::math::min<uint16_t>((uint16_t)xf, tex.width()-1u);
+    const uint16_t yi0     = ls::math::min<uint16_t>((uint16_t)yf, tex.height()-1u);
+    const uint16_t xi1     = ls::math::min<uint16_t>(xi0+1u, tex.width()-1u);
+    const uint16_t yi1     = ls::math::min<uint16_t>(yi0+1u, tex.height()-1u);
+    const float    dx      = xf - (float)xi0;
+    const float    dy      = yf - (float)yi0;
+    const float    omdx    = 1.f - dx;
+    const float    omdy    = 1.f - dy;
+
+    const ls::math::vec4&& pixel0 = sl_srgb_to_linear(tex.texel<color_type, order>(xi0, yi0));
+    const ls::math::vec4&& pixel1 = sl_srgb_to_linear(tex.texel<color_type, order>(xi0, yi1));
+    const ls::math::vec4&& pixel2 = sl_srgb_to_linear(tex.texel<color_type, order>(xi1, yi0));
+    const ls::math::vec4&& pixel3 = sl_srgb_to_linear(tex.texel<color_type, order>(xi1, yi1));
+
+    return ls::math::sum(pixel0 * (omdx * omdy), pixel1 * (omdx * dy), pixel2 * (dx * omdy), pixel3 * (dx * dy));
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Batched Texture Sampling
+ *
+ * The following functions sample 4 or 8 coordinates at once. Coordinates are
+ * passed as structures-of-arrays (separate X, Y, and Z arrays). Wrapping,
+ * texel addressing, and swizzling are performed 4 lanes at a time using
+ * SSE4.1 or NEON. Texels are loaded using AVX2 gathers where available. Each
+ * function returns the same texels as its scalar equivalent.
+-----------------------------------------------------------------------------*/
+enum SL_SamplerBatchInfo : unsigned
+{
+    SL_SAMPLER_BATCH_LANES = 4
+};
+
+
+
+/*-------------------------------------
+ * Wrap 4 texture coordinates. Returns a bit-mask of the lanes which remain
+ * valid after wrapping (only border-clamping can invalidate a lane).
+-------------------------------------*/
+template <class WrapMode>
+inline LS_INLINE unsigned sl_batch_wrap4(const float* pIn, float* pOut) noexcept
+{
+    #if defined(LS_X86_SSE4_1)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one  = _mm_set1_ps(1.f);
+        const __m128 v    = _mm_loadu_ps(pIn);
+
+        if (SL_WrapMode::SL_IsWrapModeEdge<WrapMode>::value)
+        {
+            _mm_storeu_ps(pOut, _mm_min_ps(_mm_max_ps(v, zero), one));
+            return 0x0Fu;
+        }
+        else if (SL_WrapMode::SL_IsWrapModeRepeat<WrapMode>::value)
+        {
+            const __m128 frac = _mm_sub_ps(v, _mm_round_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+            _mm_storeu_ps(pOut, _mm_add_ps(frac, _mm_and_ps(_mm_cmplt_ps(v, zero), one)));
+            return 0x0Fu;
+        }
+        else
+        {
+            const __m128 inRange = _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmplt_ps(v, one));
+            _mm_storeu_ps(pOut, _mm_and_ps(v, inRange));
+            return (unsigned)_mm_movemask_ps(inRange);
+        }
+
+    #elif defined(LS_ARM_NEON)
+        const float32x4_t zero = vdupq_n_f32(0.f);
+        const float32x4_t one  = vdupq_n_f32(1.f);
+        const float32x4_t v    = vld1q_f32(pIn);
+
+        if (SL_WrapMode::SL_IsWrapModeEdge<WrapMode>::value)
+        {
+            vst1q_f32(pOut, vminq_f32(vmaxq_f32(v, zero), one));
+            return 0x0Fu;
+        }
+        else if (SL_WrapMode::SL_IsWrapModeRepeat<WrapMode>::value)
+        {
+            const float32x4_t frac = vsubq_f32(v, vcvtq_f32_s32(vcvtq_s32_f32(v)));
+            const uint32x4_t  neg  = vcltq_f32(v, zero);
+            vst1q_f32(pOut, vaddq_f32(frac, vreinterpretq_f32_u32(vandq_u32(neg, vreinterpretq_u32_f32(one)))));
+            return 0x0Fu;
+        }
+        else
+        {
+            const uint32x4_t inRange = vandq_u32(vcgeq_f32(v, zero), vcltq_f32(v, one));
+            const uint32x4_t bits    = vandq_u32(inRange, uint32x4_t{1u, 2u, 4u, 8u});
+            vst1q_f32(pOut, vreinterpretq_f32_u32(vandq_u32(inRange, vreinterpretq_u32_f32(v))));
+            return (unsigned)(vgetq_lane_u32(bits, 0) | vgetq_lane_u32(bits, 1) | vgetq_lane_u32(bits, 2) | vgetq_lane_u32(bits, 3));
+        }
+
+    #else
+        constexpr WrapMode wrapMode;
+        unsigned mask = 0;
+
+        for (unsigned i = 0; i < SL_SAMPLER_BATCH_LANES; ++i)
+        {
+            const bool valid = !SL_WrapMode::SL_IsWrapModeBorder<WrapMode>::value || (pIn[i] >= 0.f && pIn[i] < 1.f);
+            pOut[i] = valid ? wrapMode(pIn[i]) : 0.f;
+            mask |= (unsigned)valid << i;
+        }
+
+        return mask;
+    #endif
+}
+
+
+
+/*-------------------------------------
+ * Convert 4 wrapped coordinates into integral texel coordinates.
+ *
+ * Bilinear filtering uses the texels at (t, t+1) while the trilinear filter
+ * mirrors sl_sample_trilinear() by using (t-1, t).
+-------------------------------------*/
+template <bool trilinear>
+inline LS_INLINE void sl_batch_texel_coords4(
+    const float* pWrapped,
+    float scale,
+    int32_t maxCoord,
+    int32_t* pOutLo,
+    int32_t* pOutHi,
+    float* pOutFrac) noexcept
+{
+    #if defined(LS_X86_SSE4_1)
+        const __m128  s    = _mm_mul_ps(_mm_loadu_ps(pWrapped), _mm_set1_ps(scale));
+        const __m128i t    = _mm_cvttps_epi32(s);
+        const __m128i maxV = _mm_set1_epi32(maxCoord);
+        const __m128i lo   = trilinear ? _mm_max_epi32(_mm_sub_epi32(t, _mm_set1_epi32(1)), _mm_setzero_si128()) : _mm_min_epi32(t, maxV);
+        const __m128i hi   = trilinear ? _mm_min_epi32(t, maxV) : _mm_min_epi32(_mm_add_epi32(lo, _mm_set1_epi32(1)), maxV);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOutLo), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOutHi), hi);
+        _mm_storeu_ps(pOutFrac, _mm_sub_ps(s, _mm_cvtepi32_ps(t)));
+
+    #elif defined(LS_ARM_NEON)
+        const float32x4_t s    = vmulq_n_f32(vld1q_f32(pWrapped), scale);
+        const int32x4_t   t    = vcvtq_s32_f32(s);
+        const int32x4_t   maxV = vdupq_n_s32(maxCoord);
+        const int32x4_t   lo   = trilinear ? vmaxq_s32(vsubq_s32(t, vdupq_n_s32(1)), vdupq_n_s32(0)) : vminq_s32(t, maxV);
+        const int32x4_t   hi   = trilinear ? vminq_s32(t, maxV) : vminq_s32(vaddq_s32(lo, vdupq_n_s32(1)), maxV);
+
+        vst1q_s32(pOutLo, lo);
+        vst1q_s32(pOutHi, hi);
+        vst1q_f32(pOutFrac, vsubq_f32(s, vcvtq_f32_s32(t)));
+
+    #else
+        for (unsigned i = 0; i < SL_SAMPLER_BATCH_LANES; ++i)
+        {
+            const float   s = pWrapped[i] * scale;
+            const int32_t t = (int32_t)s;
+
+            pOutLo[i]   = trilinear ? ls::math::max<int32_t>(t-1, 0) : ls::math::min<int32_t>(t, maxCoord);
+            pOutHi[i]   = trilinear ? ls::math::min<int32_t>(t, maxCoord) : ls::math::min<int32_t>(pOutLo[i]+1, maxCoord);
+            pOutFrac[i] = s - (float)t;
+        }
+    #endif
+}
+
+
+
+/*-------------------------------------
+ * Convert 4 wrapped coordinates into the nearest texel slices, rounding as
+ * the scalar 3D samplers do.
+-------------------------------------*/
+inline LS_INLINE void sl_batch_slice_coords4(const float* pWrapped, float scale, int32_t maxCoord, int32_t* pOut) noexcept
+{
+    #if defined(LS_X86_SSE4_1)
+        const __m128 s = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pWrapped), _mm_set1_ps(scale)), _mm_set1_ps(0.5f));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut), _mm_min_epi32(_mm_cvttps_epi32(s), _mm_set1_epi32(maxCoord)));
+
+    #elif defined(LS_ARM_NEON)
+        const float32x4_t s = vaddq_f32(vmulq_n_f32(vld1q_f32(pWrapped), scale), vdupq_n_f32(0.5f));
+        vst1q_s32(pOut, vminq_s32(vcvtq_s32_f32(s), vdupq_n_s32(maxCoord)));
+
+    #else
+        for (unsigned i = 0; i < SL_SAMPLER_BATCH_LANES; ++i)
+        {
+            pOut[i] = ls::math::min<int32_t>((int32_t)(pWrapped[i] * scale + 0.5f), maxCoord);
+        }
+    #endif
+}
+
+
+
+/*-------------------------------------
+ * Map 4 2D texel coordinates to memory offsets
+-------------------------------------*/
+template <SL_TexelOrder order>
+inline LS_INLINE void sl_batch_texel_ids4(const SL_Texture& tex, const int32_t* pX, const int32_t* pY, int32_t* pOutIds) noexcept
+{
+    #if defined(LS_X86_SSE4_1)
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pX));
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pY));
+        __m128i ids;
+
+        if (order == SL_TexelOrder::SL_TEXELS_ORDERED)
+        {
+            ids = _mm_add_epi32(x, _mm_mullo_epi32(y, _mm_set1_epi32(tex.width())));
+        }
+        else
+        {
+            const __m128i chunkMask = _mm_set1_epi32(SL_TEXELS_PER_CHUNK-1);
+            const __m128i tileX     = _mm_srli_epi32(x, SL_TEXEL_SHIFTS_PER_CHUNK);
+            const __m128i tileY     = _mm_srli_epi32(y, SL_TEXEL_SHIFTS_PER_CHUNK);
+            const __m128i tileId    = _mm_add_epi32(tileX, _mm_mullo_epi32(tileY, _mm_set1_epi32(tex.width() >> SL_TEXEL_SHIFTS_PER_CHUNK)));
+            const __m128i innerX    = _mm_and_si128(x, chunkMask);
+            const __m128i innerY    = _mm_slli_epi32(_mm_and_si128(y, chunkMask), SL_TEXEL_SHIFTS_PER_CHUNK);
+
+            ids = _mm_add_epi32(_mm_add_epi32(innerX, innerY), _mm_slli_epi32(tileId, SL_TEXEL_SHIFTS_PER_CHUNK*2));
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOutIds), ids);
+
+    #elif defined(LS_ARM_NEON)
+        const int32x4_t x = vld1q_s32(pX);
+        const int32x4_t y = vld1q_s32(pY);
+        int32x4_t ids;
+
+        if (order == SL_TexelOrder::SL_TEXELS_ORDERED)
+        {
+            ids = vmlaq_n_s32(x, y, (int32_t)tex.width());
+        }
+        else
+        {
+            const int32x4_t chunkMask = vdupq_n_s32(SL_TEXELS_PER_CHUNK-1);
+            const int32x4_t tileX     = vshrq_n_s32(x, SL_TEXEL_SHIFTS_PER_CHUNK);
+            const int32x4_t tileY     = vshrq_n_s32(y, SL_TEXEL_SHIFTS_PER_CHUNK);
+            const int32x4_t tileId    = vmlaq_n_s32(tileX, tileY, (int32_t)(tex.width() >> SL_TEXEL_SHIFTS_PER_CHUNK));
+            const int32x4_t innerX    = vandq_s32(x, chunkMask);
+            const int32x4_t innerY    = vshlq_n_s32(vandq_s32(y, chunkMask), SL_TEXEL_SHIFTS_PER_CHUNK);
+
+            ids = vaddq_s32(vaddq_s32(innerX, innerY), vshlq_n_s32(tileId, SL_TEXEL_SHIFTS_PER_CHUNK*2));
+        }
+
+        vst1q_s32(pOutIds, ids);
+
+    #else
+        for (unsigned i = 0; i < SL_SAMPLER_BATCH_LANES; ++i)
+        {
+            pOutIds[i] = (int32_t)tex.map_coordinate<order>((uint_fast32_t)pX[i], (uint_fast32_t)pY[i]);
+        }
+    #endif
+}
+
+
+
+/*-------------------------------------
+ * Map 4 3D texel coordinates to memory offsets
+-------------------------------------*/
+template <SL_TexelOrder order>
+inline LS_INLINE void sl_batch_texel_ids4(const SL_Texture& tex, const int32_t* pX, const int32_t* pY, const int32_t* pZ, int32_t* pOutIds) noexcept
+{
+    #if defined(LS_X86_SSE4_1)
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pX));
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pY));
+        const __m128i z = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pZ));
+        __m128i ids;
+
+        if (order == SL_TexelOrder::SL_TEXELS_ORDERED)
+        {
+            const __m128i row = _mm_add_epi32(y, _mm_mullo_epi32(z, _mm_set1_epi32(tex.height())));
+            ids = _mm_add_epi32(x, _mm_mullo_epi32(row, _mm_set1_epi32(tex.width())));
+        }
+        else
+        {
+            const __m128i chunkMask = _mm_set1_epi32(SL_TEXELS_PER_CHUNK-1);
+            const __m128i tileX     = _mm_srli_epi32(x, SL_TEXEL_SHIFTS_PER_CHUNK);
+            const __m128i tileY     = _mm_srli_epi32(y, SL_TEXEL_SHIFTS_PER_CHUNK);
+            const __m128i tileZ     = _mm_srli_epi32(z, SL_TEXEL_SHIFTS_PER_CHUNK);
+            const __m128i tileRow   = _mm_add_epi32(tileY, _mm_mullo_epi32(tileZ, _mm_set1_epi32(tex.height() >> SL_TEXEL_SHIFTS_PER_CHUNK)));
+            const __m128i tileId    = _mm_add_epi32(tileX, _mm_mullo_epi32(tileRow, _mm_set1_epi32(tex.width() >> SL_TEXEL_SHIFTS_PER_CHUNK)));
+            const __m128i innerX    = _mm_and_si128(x, chunkMask);
+            const __m128i innerY    = _mm_slli_epi32(_mm_and_si128(y, chunkMask), SL_TEXEL_SHIFTS_PER_CHUNK);
+            const __m128i innerZ    = _mm_slli_epi32(_mm_and_si128(z, chunkMask), SL_TEXEL_SHIFTS_PER_CHUNK*2);
+
+            ids = _mm_add_epi32(_mm_add_epi32(innerX, innerY), _mm_add_epi32(innerZ, _mm_slli_epi32(tileId, SL_TEXEL_SHIFTS_PER_CHUNK*3)));
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOutIds), ids);
+
+    #elif defined(LS_ARM_NEON)
+        const int32x4_t x = vld1q_s32(pX);
+        const int32x4_t y = vld1q_s32(pY);
+        const int32x4_t z = vld1q_s32(pZ);
+        int32x4_t ids;
+
+        if (order == SL_TexelOrder::SL_TEXELS_ORDERED)
+        {
+            ids = vmlaq_n_s32(x, vmlaq_n_s32(y, z, (int32_t)tex.height()), (int32_t)tex.width());
+        }
+        else
+        {
+            const int32x4_t chunkMask = vdupq_n_s32(SL_TEXELS_PER_CHUNK-1);
+            const int32x4_t tileX     = vshrq_n_s32(x, SL_TEXEL_SHIFTS_PER_CHUNK);
+            const int32x4_t tileY     = vshrq_n_s32(y, SL_TEXEL_SHIFTS_PER_CHUNK);
+            const int32x4_t tileZ     = vshrq_n_s32(z, SL_TEXEL_SHIFTS_PER_CHUNK);
+            const int32x4_t tileRow   = vmlaq_n_s32(tileY, tileZ, (int32_t)(tex.height() >> SL_TEXEL_SHIFTS_PER_CHUNK));
+            const int32x4_t tileId    = vmlaq_n_s32(tileX, tileRow, (int32_t)(tex.width() >> SL_TEXEL_SHIFTS_PER_CHUNK));
+            const int32x4_t innerX    = vandq_s32(x, chunkMask);
+            const int32x4_t innerY    = vshlq_n_s32(vandq_s32(y, chunkMask), SL_TEXEL_SHIFTS_PER_CHUNK);
+            const int32x4_t innerZ    = vshlq_n_s32(vandq_s32(z, chunkMask), SL_TEXEL_SHIFTS_PER_CHUNK*2);
+
+            ids = vaddq_s32(vaddq_s32(innerX, innerY), vaddq_s32(innerZ, vshlq_n_s32(tileId, SL_TEXEL_SHIFTS_PER_CHUNK*3)));
+        }
+
+        vst1q_s32(pOutIds, ids);
+
+    #else
+        for (unsigned i = 0; i < SL_SAMPLER_BATCH_LANES; ++i)
+        {
+            pOutIds[i] = (int32_t)tex.map_coordinate<order>((uint_fast32_t)pX[i], (uint_fast32_t)pY[i], (uint_fast32_t)pZ[i]);
+        }
+    #endif
+}
+
+
+
+/*-------------------------------------
+ * Load a batch of 4 or 8 texels. Lanes outside of "validMask" are set to 0.
+ *
+ * AVX2 builds gather 32-bit texels 8 lanes at a time and 64-bit texels 4
+ * lanes at a time. Texels of any other size are gathered as 32-bit words
+ * from byte offsets, which may read up to 3 bytes past the final texel. The
+ * padding allocated at the end of every texture keeps those reads in-bounds.
+ * Other builds load each lane individually.
+-------------------------------------*/
+template <typename color_type, unsigned count>
+inline LS_INLINE void sl_batch_gather(const SL_Texture& tex, const int32_t* pIds, unsigned validMask, color_type* pOut) noexcept
+{
+    static_assert(count == 4 || count == 8, "Texels can only be gathered in groups of 4 or 8.");
+
+    const color_type* pTexels = reinterpret_cast<const color_type*>(tex.data());
+
+    #if defined(LS_X86_AVX2)
+        if (sizeof(color_type) == sizeof(int32_t))
+        {
+            if (count == 8)
+            {
+                const __m256i ids    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pIds));
+                const __m256i lanes  = _mm256_and_si256(_mm256_set1_epi32((int)validMask), _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128));
+                const __m256i mask   = _mm256_cmpgt_epi32(lanes, _mm256_setzero_si256());
+                const __m256i texels = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), reinterpret_cast<const int*>(pTexels), ids, mask, sizeof(int32_t));
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut), texels);
+            }
+            else
+            {
+                const __m128i ids    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIds));
+                const __m128i lanes  = _mm_and_si128(_mm_set1_epi32((int)validMask), _mm_setr_epi32(1, 2, 4, 8));
+                const __m128i mask   = _mm_cmpgt_epi32(lanes, _mm_setzero_si128());
+                const __m128i texels = _mm_mask_i32gather_epi32(_mm_setzero_si128(), reinterpret_cast<const int*>(pTexels), ids, mask, sizeof(int32_t));
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut), texels);
+            }
+
+            return;
+        }
+        else if (sizeof(color_type) == sizeof(int64_t))
+        {
+            for (unsigned i = 0; i < count; i += 4)
+            {
+                const __m128i ids    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIds+i));
+                const __m256i lanes  = _mm256_and_si256(_mm256_set1_epi64x((long long)(validMask >> i)), _mm256_setr_epi64x(1, 2, 4, 8));
+                const __m256i mask   = _mm256_cmpgt_epi64(lanes, _mm256_setzero_si256());
+                const __m256i texels = _mm256_mask_i32gather_epi64(_mm256_setzero_si256(), reinterpret_cast<const long long*>(pTexels), ids, mask, sizeof(int64_t));
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut+i), texels);
+            }
+
+            return;
+        }
+        else if ((size_t)tex.width() * tex.height() * tex.depth() * sizeof(color_type) <= (size_t)INT32_MAX) // byte offsets must fit within 32 bits
+        {
+            constexpr unsigned numWords = (unsigned)((sizeof(color_type) + sizeof(int32_t) - 1) / sizeof(int32_t));
+            const char* const pBytes = reinterpret_cast<const char*>(pTexels);
+            alignas(16) int32_t words[numWords][count];
+
+            for (unsigned i = 0; i < count; i += 4)
+            {
+                const __m128i lanes   = _mm_and_si128(_mm_set1_epi32((int)(validMask >> i)), _mm_setr_epi32(1, 2, 4, 8));
+                const __m128i mask    = _mm_cmpgt_epi32(lanes, _mm_setzero_si128());
+                const __m128i offsets = _mm_mullo_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pIds+i)), _mm_set1_epi32((int)sizeof(color_type)));
+
+                for (unsigned w = 0; w < numWords; ++w)
+                {
+                    const int* pWords = reinterpret_cast<const int*>(pBytes + w*sizeof(int32_t));
+                    _mm_store_si128(reinterpret_cast<__m128i*>(words[w]+i), _mm_mask_i32gather_epi32(_mm_setzero_si128(), pWords, offsets, mask, 1));
+                }
+            }
+
+            for (unsigned i = 0; i < count; ++i)
+            {
+                char* const pDst = reinterpret_cast<char*>(pOut+i);
+
+                for (unsigned w = 0; w < numWords; ++w)
+                {
+                    const size_t numBytes = ls::math::min<size_t>(sizeof(int32_t), sizeof(color_type) - w*sizeof(int32_t));
+                    std::memcpy(pDst + w*sizeof(int32_t), words[w]+i, numBytes);
+                }
+            }
+
+            return;
+        }
+    #endif
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        pOut[i] = (validMask & (1u << i)) ? pTexels[pIds[i]] : color_type{0};
+    }
+}
+
+
+
+/*-------------------------------------
+ * Blend batched texels using a set of per-lane weights
+-------------------------------------*/
+template <typename color_type, unsigned numTaps, unsigned count>
+inline LS_INLINE color_type sl_batch_blend(const color_type (&taps)[numTaps][count], const float (&weights)[numTaps], unsigned lane) noexcept
+{
+    auto ret = color_cast<float, typename color_type::value_type>(taps[0][lane]) * weights[0];
+
+    for (unsigned t = 1; t < numTaps; ++t)
+    {
+        ret = ret + color_cast<float, typename color_type::value_type>(taps[t][lane]) * weights[t];
+    }
+
+    return color_cast<typename color_type::value_type, float>(ret);
+}
+
+
+
+/*-------------------------------------
+ * Batched equivalent of sl_sample_nearest()
+-------------------------------------*/
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TEXELS_ORDERED, unsigned count = SL_SAMPLER_BATCH_LANES>
+inline void sl_sample_nearest_batch(const SL_Texture& tex, const float* pX, const float* pY, color_type* pOutTexels) noexcept
+{
+    static_assert(count == 4 || count == 8, "Texture samples can only be batched in groups of 4 or 8.");
+
+    alignas(16) float   wx[SL_SAMPLER_BATCH_LANES], wy[SL_SAMPLER_BATCH_LANES], frac[SL_SAMPLER_BATCH_LANES];
+    alignas(16) int32_t xi[SL_SAMPLER_BATCH_LANES], yi[SL_SAMPLER_BATCH_LANES], unused[SL_SAMPLER_BATCH_LANES];
+    alignas(32) int32_t ids[count];
+    unsigned valid = 0;
+
+    for (unsigned i = 0; i < count; i += SL_SAMPLER_BATCH_LANES)
+    {
+        valid |= (sl_batch_wrap4<WrapMode>(pX+i, wx) & sl_batch_wrap4<WrapMode>(pY+i, wy)) << i;
+
+        sl_batch_texel_coords4<false>(wx, (float)tex.width(),  tex.width()-1,  xi, unused, frac);
+        sl_batch_texel_coords4<false>(wy, (float)tex.height(), tex.height()-1, yi, unused, frac);
+        sl_batch_texel_ids4<order>(tex, xi, yi, ids+i);
+    }
+
+    sl_batch_gather<color_type, count>(tex, ids, valid, pOutTexels);
+}
+
+
+
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TEXELS_ORDERED, unsigned count = SL_SAMPLER_BATCH_LANES>
+inline void sl_sample_nearest_batch(const SL_Texture& tex, const float* pX, const float* pY, const float* pZ, color_type* pOutTexels) noexcept
+{
+    static_assert(count == 4 || count == 8, "Texture samples can only be batched in groups of 4 or 8.");
+
+    alignas(16) float   wx[SL_SAMPLER_BATCH_LANES], wy[SL_SAMPLER_BATCH_LANES], wz[SL_SAMPLER_BATCH_LANES], frac[SL_SAMPLER_BATCH_LANES];
+    alignas(16) int32_t xi[SL_SAMPLER_BATCH_LANES], yi[SL_SAMPLER_BATCH_LANES], zi[SL_SAMPLER_BATCH_LANES], unused[SL_SAMPLER_BATCH_LANES];
+    alignas(32) int32_t ids[count];
+    unsigned valid = 0;
+
+    for (unsigned i = 0; i < count; i += SL_SAMPLER_BATCH_LANES)
+    {
+        valid |= (sl_batch_wrap4<WrapMode>(pX+i, wx) & sl_batch_wrap4<WrapMode>(pY+i, wy) & sl_batch_wrap4<WrapMode>(pZ+i, wz)) << i;
+
+        sl_batch_texel_coords4<false>(wx, (float)tex.width(),  tex.width()-1,  xi, unused, frac);
+        sl_batch_texel_coords4<false>(wy, (float)tex.height(), tex.height()-1, yi, unused, frac);
+        sl_batch_slice_coords4(wz, (float)tex.depth(), tex.depth()-1, zi);
+        sl_batch_texel_ids4<order>(tex, xi, yi, zi, ids+i);
+    }
+
+    sl_batch_gather<color_type, count>(tex, ids, valid, pOutTexels);
+}
+
+
+
+/*-------------------------------------
+ * Batched equivalent of sl_sample_bilinear()
+-------------------------------------*/
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TEXELS_ORDERED, unsigned count = SL_SAMPLER_BATCH_LANES>
+inline void sl_sample_bilinear_batch(const SL_Texture& tex, const float* pX, const float* pY, color_type* pOutTexels) noexcept
+{
+    static_assert(count == 4 || count == 8, "Texture samples can only be batched in groups of 4 or 8.");
+
+    alignas(16) float   wx[SL_SAMPLER_BATCH_LANES], wy[SL_SAMPLER_BATCH_LANES];
+    alignas(16) int32_t x0[SL_SAMPLER_BATCH_LANES], x1[SL_SAMPLER_BATCH_LANES], y0[SL_SAMPLER_BATCH_LANES], y1[SL_SAMPLER_BATCH_LANES];
+    alignas(32) float   dx[count], dy[count];
+    alignas(32) int32_t ids[4][count];
+    color_type taps[4][count];
+    unsigned valid = 0;
+
+    for (unsigned i = 0; i < count; i += SL_SAMPLER_BATCH_LANES)
+    {
+        valid |= (sl_batch_wrap4<WrapMode>(pX+i, wx) & sl_batch_wrap4<WrapMode>(pY+i, wy)) << i;
+
+        sl_batch_texel_coords4<false>(wx, (float)tex.width(),  tex.width()-1,  x0, x1, dx+i);
+        sl_batch_texel_coords4<false>(wy, (float)tex.height(), tex.height()-1, y0, y1, dy+i);
+
+        sl_batch_texel_ids4<order>(tex, x0, y0, ids[0]+i);
+        sl_batch_texel_ids4<order>(tex, x0, y1, ids[1]+i);
+        sl_batch_texel_ids4<order>(tex, x1, y0, ids[2]+i);
+        sl_batch_texel_ids4<order>(tex, x1, y1, ids[3]+i);
+    }
+
+    for (unsigned t = 0; t < 4; ++t)
+    {
+        sl_batch_gather<color_type, count>(tex, ids[t], valid, taps[t]);
+    }
+
+    for (unsigned lane = 0; lane < count; ++lane)
+    {
+        const float omdx = 1.f - dx[lane];
+        const float omdy = 1.f - dy[lane];
+        const float weights[4] = {omdx*omdy, omdx*dy[lane], dx[lane]*omdy, dx[lane]*dy[lane]};
+
+        pOutTexels[lane] = sl_batch_blend<color_type, 4, count>(taps, weights, lane);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Batched equivalent of sl_sample_bilinear() for 3D textures. Texels are
+ * filtered within the nearest Z slice, without interpolating between slices.
+ * Use sl_sample_trilinear_batch() to filter along all 3 axes.
+-------------------------------------*/
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TEXELS_ORDERED, unsigned count = SL_SAMPLER_BATCH_LANES>
+inline void sl_sample_bilinear_slice_batch(const SL_Texture& tex, const float* pX, const float* pY, const float* pZ, color_type* pOutTexels) noexcept
+{
+    static_assert(count == 4 || count == 8, "Texture samples can only be batched in groups of 4 or 8.");
+
+    alignas(16) float   wx[SL_SAMPLER_BATCH_LANES], wy[SL_SAMPLER_BATCH_LANES], wz[SL_SAMPLER_BATCH_LANES];
+    alignas(16) int32_t x0[SL_SAMPLER_BATCH_LANES], x1[SL_SAMPLER_BATCH_LANES], y0[SL_SAMPLER_BATCH_LANES], y1[SL_SAMPLER_BATCH_LANES];
+    alignas(16) int32_t zi[SL_SAMPLER_BATCH_LANES];
+    alignas(32) float   dx[count], dy[count];
+    alignas(32) int32_t ids[4][count];
+    color_type taps[4][count];
+    unsigned valid = 0;
+
+    for (unsigned i = 0; i < count; i += SL_SAMPLER_BATCH_LANES)
+    {
+        valid |= (sl_batch_wrap4<WrapMode>(pX+i, wx) & sl_batch_wrap4<WrapMode>(pY+i, wy) & sl_batch_wrap4<WrapMode>(pZ+i, wz)) << i;
+
+        sl_batch_texel_coords4<false>(wx, (float)tex.width(),  tex.width()-1,  x0, x1, dx+i);
+        sl_batch_texel_coords4<false>(wy, (float)tex.height(), tex.height()-1, y0, y1, dy+i);
+        sl_batch_slice_coords4(wz, (float)tex.depth(), tex.depth()-1, zi);
+
+        sl_batch_texel_ids4<order>(tex, x0, y0, zi, ids[0]+i);
+        sl_batch_texel_ids4<order>(tex, x0, y1, zi, ids[1]+i);
+        sl_batch_texel_ids4<order>(tex, x1, y0, zi, ids[2]+i);
+        sl_batch_texel_ids4<order>(tex, x1, y1, zi, ids[3]+i);
+    }
+
+    for (unsigned t = 0; t < 4; ++t)
+    {
+        sl_batch_gather<color_type, count>(tex, ids[t], valid, taps[t]);
+    }
+
+    for (unsigned lane = 0; lane < count; ++lane)
+    {
+        const float omdx = 1.f - dx[lane];
+        const float omdy = 1.f - dy[lane];
+        const float weights[4] = {omdx*omdy, omdx*dy[lane], dx[lane]*omdy, dx[lane]*dy[lane]};
+
+        pOutTexels[lane] = sl_batch_blend<color_type, 4, count>(taps, weights, lane);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Batched equivalent of sl_sample_trilinear()
+-------------------------------------*/
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TEXELS_ORDERED, unsigned count = SL_SAMPLER_BATCH_LANES>
+inline void sl_sample_trilinear_batch(const SL_Texture& tex, const float* pX, const float* pY, color_type* pOutTexels) noexcept
+{
+    static_assert(count == 4 || count == 8, "Texture samples can only be batched in groups of 4 or 8.");
+
+    alignas(16) float   wx[SL_SAMPLER_BATCH_LANES], wy[SL_SAMPLER_BATCH_LANES];
+    alignas(16) int32_t si[SL_SAMPLER_BATCH_LANES], xi[SL_SAMPLER_BATCH_LANES], ti[SL_SAMPLER_BATCH_LANES], yi[SL_SAMPLER_BATCH_LANES];
+    alignas(32) float   xf[count], yf[count];
+    alignas(32) int32_t ids[4][count];
+    color_type taps[4][count];
+    unsigned valid = 0;
+
+    for (unsigned i = 0; i < count; i += SL_SAMPLER_BATCH_LANES)
+    {
+        valid |= (sl_batch_wrap4<WrapMode>(pX+i, wx) & sl_batch_wrap4<WrapMode>(pY+i, wy)) << i;
+
+        sl_batch_texel_coords4<true>(wx, (float)tex.width(),  tex.width()-1,  si, xi, xf+i);
+        sl_batch_texel_coords4<true>(wy, (float)tex.height(), tex.height()-1, ti, yi, yf+i);
+
+        sl_batch_texel_ids4<order>(tex, si, ti, ids[0]+i);
+        sl_batch_texel_ids4<order>(tex, xi, ti, ids[1]+i);
+        sl_batch_texel_ids4<order>(tex, si, yi, ids[2]+i);
+        sl_batch_texel_ids4<order>(tex, xi, yi, ids[3]+i);
+    }
+
+    for (unsigned t = 0; t < 4; ++t)
+    {
+        sl_batch_gather<color_type, count>(tex, ids[t], valid, taps[t]);
+    }
+
+    for (unsigned lane = 0; lane < count; ++lane)
+    {
+        const float xd = 1.f - xf[lane];
+        const float yd = 1.f - yf[lane];
+        const float weights[4] = {xd*yd, xf[lane]*yd, xd*yf[lane], xf[lane]*yf[lane]};
+
+        pOutTexels[lane] = sl_batch_blend<color_type, 4, count>(taps, weights, lane);
+    }
+}
+
+
+
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TEXELS_ORDERED, unsigned count = SL_SAMPLER_BATCH_LANES>
+inline void sl_sample_trilinear_batch(const SL_Texture& tex, const float* pX, const float* pY, const float* pZ, color_type* pOutTexels) noexcept
+{
+    static_assert(count == 4 || count == 8, "Texture samples can only be batched in groups of 4 or 8.");
+
+    alignas(16) float   wx[SL_SAMPLER_BATCH_LANES], wy[SL_SAMPLER_BATCH_LANES], wz[SL_SAMPLER_BATCH_LANES];
+    alignas(16) int32_t si[SL_SAMPLER_BATCH_LANES], xi[SL_SAMPLER_BATCH_LANES], ti[SL_SAMPLER_BATCH_LANES], yi[SL_SAMPLER_BATCH_LANES];
+    alignas(16) int32_t ri[SL_SAMPLER_BATCH_LANES], zi[SL_SAMPLER_BATCH_LANES];
+    alignas(32) float   xf[count], yf[count], zf[count];
+    alignas(32) int32_t ids[8][count];
+    color_type taps[8][count];
+    unsigned valid = 0;
+
+    for (unsigned i = 0; i < count; i += SL_SAMPLER_BATCH_LANES)
+    {
+        valid |= (sl_batch_wrap4<WrapMode>(pX+i, wx) & sl_batch_wrap4<WrapMode>(pY+i, wy) & sl_batch_wrap4<WrapMode>(pZ+i, wz)) << i;
+
+        sl_batch_texel_coords4<true>(wx, (float)tex.width(),  tex.width()-1,  si, xi, xf+i);
+        sl_batch_texel_coords4<true>(wy, (float)tex.height(), tex.height()-1, ti, yi, yf+i);
+        sl_batch_texel_coords4<true>(wz, (float)tex.depth(),  tex.depth()-1,  ri, zi, zf+i);
+
+        sl_batch_texel_ids4<order>(tex, si, ti, ri, ids[0]+i);
+        sl_batch_texel_ids4<order>(tex, xi, ti, ri, ids[1]+i);
+        sl_batch_texel_ids4<order>(tex, si, yi, ri, ids[2]+i);
+        sl_batch_texel_ids4<order>(tex, si, ti, zi, ids[3]+i);
+        sl_batch_texel_ids4<order>(tex, xi, ti, zi, ids[4]+i);
+        sl_batch_texel_ids4<order>(tex, si, yi, zi, ids[5]+i);
+        sl_batch_texel_ids4<order>(tex, xi, yi, ri, ids[6]+i);
+        sl_batch_texel_ids4<order>(tex, xi, yi, zi, ids[7]+i);
+    }
+
+    for (unsigned t = 0; t < 8; ++t)
+    {
+        sl_batch_gather<color_type, count>(tex, ids[t], valid, taps[t]);
+    }
+
+    for (unsigned lane = 0; lane < count; ++lane)
+    {
+        const float xd = 1.f - xf[lane];
+        const float yd = 1.f - yf[lane];
+        const float zd = 1.f - zf[lane];
+        const float weights[8] = {
+            xd*yd*zd,
+            xf[lane]*yd*zd,
+            xd*yf[lane]*zd,
+            xd*yd*zf[lane],
+            xf[lane]*yd*zf[lane],
+            xd*yf[lane]*zf[lane],
+            xf[lane]*yf[lane]*zd,
+            xf[lane]*yf[lane]*zf[lane]
+        };
+
+        pOutTexels[lane] = sl_batch_blend<color_type, 8, count>(taps, weights, lane);
+    }
+}
+
+
+
 #endif /* SL_SAMPLER_HPP */
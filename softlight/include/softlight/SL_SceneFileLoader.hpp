@@ -119,6 +119,16 @@ struct SL_SceneLoadOpts
     // Implies "genSmoothNormals." This will generate tangents and bitangents
     // for normal mapping.
     bool genTangents;
+
+    // Block-compress 8-bit textures as they're loaded. R, RG, RGB, and RGBA
+    // images are stored as BC4, BC5, BC1, and BC3 respectively, and must be
+    // read using the compressed samplers in "SL_Sampler.hpp."
+    bool compressTextures;
+
+    // Store uncompressed textures using SL_TEXELS_SWIZZLED. Texels are
+    // converted in parallel as they're loaded. Textures with a width or
+    // height which is not a multiple of SL_TEXELS_PER_CHUNK remain ordered.
+    bool swizzleTextures;
 };
 
 
@@ -134,6 +144,8 @@ struct SL_SceneLoadOpts
  *     genFlatNormals:   FALSE
  *     genSmoothNormals: TRUE
  *     genTangents:      FALSE
+ *     compressTextures: FALSE
+ *     swizzleTextures:  FALSE
  *
  * @return A SL_SceneLoadOpts structure, containing standard data-modification
  * options which will affect a scene being loaded.
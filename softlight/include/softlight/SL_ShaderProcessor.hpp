@@ -6,9 +6,15 @@
 
 #include "softlight/SL_BlitProcesor.hpp"
 #include "softlight/SL_ClearProcesor.hpp"
+#include "softlight/SL_CompositeProcessor.hpp"
+#include "softlight/SL_CpuTopology.hpp" // SL_AffinityProcessor
+#include "softlight/SL_LightCluster.hpp"
+#include "softlight/SL_LightProcessor.hpp"
 #include "softlight/SL_LineProcessor.hpp"
 #include "softlight/SL_PointProcessor.hpp"
+#include "softlight/SL_TexUploadProcessor.hpp"
 #include "softlight/SL_TriProcessor.hpp"
+#include "softlight/SL_VolumeProcessor.hpp"
 
 
 
@@ -25,7 +31,13 @@ enum SL_ShaderType : uint8_t
     SL_LINE_PROCESSOR,
     SL_POINT_PROCESSOR,
     SL_BLIT_PROCESSOR,
-    SL_CLEAR_PROCESSOR
+    SL_CLEAR_PROCESSOR,
+    SL_LIGHT_PROCESSOR,
+    SL_CLUSTER_PROCESSOR,
+    SL_COMPOSITE_PROCESSOR,
+    SL_VOLUME_PROCESSOR,
+    SL_TEX_UPLOAD_PROCESSOR,
+    SL_AFFINITY_PROCESSOR
 };
 
 SL_ShaderType sl_processor_type_for_draw_mode(SL_RenderMode drawMode) noexcept;
@@ -47,6 +59,12 @@ struct SL_ShaderProcessor
         SL_PointProcessor mPointProcessor;
         SL_BlitProcessor mBlitter;
         SL_ClearProcessor mClear;
+        SL_LightProcessor mLighting;
+        SL_ClusterProcessor mClusterer;
+        SL_CompositeProcessor mComposite;
+        SL_VolumeProcessor mVolume;
+        SL_TexUploadProcessor mTexUpload;
+        SL_AffinityProcessor mAffinity;
     };
 
     // 2144 bits (268 bytes), padding not included
@@ -96,6 +114,30 @@ inline void SL_ShaderProcessor::operator()() noexcept
         case SL_CLEAR_PROCESSOR:
             mClear.execute();
             break;
+
+        case SL_LIGHT_PROCESSOR:
+            mLighting.execute();
+            break;
+
+        case SL_CLUSTER_PROCESSOR:
+            mClusterer.execute();
+            break;
+
+        case SL_COMPOSITE_PROCESSOR:
+            mComposite.execute();
+            break;
+
+        case SL_VOLUME_PROCESSOR:
+            mVolume.execute();
+            break;
+
+        case SL_TEX_UPLOAD_PROCESSOR:
+            mTexUpload.execute();
+            break;
+
+        case SL_AFFINITY_PROCESSOR:
+            mAffinity.execute();
+            break;
     }
 }
 
@@ -0,0 +1,126 @@
+
+#ifndef SL_SWAP_CHAIN_HPP
+#define SL_SWAP_CHAIN_HPP
+
+#include <chrono>
+#include <cstdint>
+
+#include "lightsky/utils/Pointer.h"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+class SL_RenderWindow;
+class SL_WindowBuffer;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Swap Chain Utilities
+-----------------------------------------------------------------------------*/
+enum SL_SwapChainLimits : unsigned
+{
+    SL_SWAP_CHAIN_MAX_BUFFERS = 3
+};
+
+
+
+/*-------------------------------------
+ * Timestamps of a single frame.
+ *
+ * "presentedTime" is recorded when the swap chain first notices that the
+ * windowing system has finished reading a frame. It is never earlier than
+ * the actual completion time.
+-------------------------------------*/
+struct SL_FrameTiming
+{
+    uint64_t serial;
+    std::chrono::steady_clock::time_point queuedTime;
+    std::chrono::steady_clock::time_point presentedTime;
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief The Swap Chain rotates between multiple window buffers so a new frame
+ * can be rendered while previous frames are still being read by the
+ * windowing system.
+ *
+ * Call back_buffer() to retrieve the next buffer to render into, followed by
+ * present() once the frame is complete. back_buffer() only blocks when every
+ * buffer is still waiting to be presented.
+-----------------------------------------------------------------------------*/
+class SL_SwapChain
+{
+  private:
+    SL_RenderWindow* mWindow;
+
+    unsigned mNumBuffers;
+
+    unsigned mBackBuffer;
+
+    ls::utils::Pointer<SL_WindowBuffer> mBuffers[SL_SWAP_CHAIN_MAX_BUFFERS];
+
+    SL_FrameTiming mTimings[SL_SWAP_CHAIN_MAX_BUFFERS];
+
+    SL_FrameTiming mLastPresented;
+
+    void update_timings() noexcept;
+
+  public:
+    ~SL_SwapChain() noexcept;
+
+    SL_SwapChain() noexcept;
+
+    SL_SwapChain(const SL_SwapChain&) = delete;
+
+    SL_SwapChain(SL_SwapChain&&) noexcept;
+
+    SL_SwapChain& operator=(const SL_SwapChain&) = delete;
+
+    SL_SwapChain& operator=(SL_SwapChain&&) noexcept;
+
+    int init(SL_RenderWindow& window, unsigned numBuffers, unsigned width, unsigned height) noexcept;
+
+    int resize(unsigned width, unsigned height) noexcept;
+
+    void terminate() noexcept;
+
+    unsigned num_buffers() const noexcept;
+
+    SL_WindowBuffer& back_buffer() noexcept;
+
+    uint64_t present() noexcept;
+
+    void wait_idle() noexcept;
+
+    const SL_FrameTiming& frame_timing(unsigned bufferIndex) const noexcept;
+
+    const SL_FrameTiming& last_presented_frame() noexcept;
+};
+
+
+
+/*-------------------------------------
+ * Retrieve the number of buffers being cycled
+-------------------------------------*/
+inline unsigned SL_SwapChain::num_buffers() const noexcept
+{
+    return mNumBuffers;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the timestamps of the last frame presented from a buffer
+-------------------------------------*/
+inline const SL_FrameTiming& SL_SwapChain::frame_timing(unsigned bufferIndex) const noexcept
+{
+    return mTimings[bufferIndex];
+}
+
+
+
+#endif /* SL_SWAP_CHAIN_HPP */
@@ -0,0 +1,58 @@
+
+#ifndef SL_TEX_UPLOAD_PROCESSOR_HPP
+#define SL_TEX_UPLOAD_PROCESSOR_HPP
+
+#include <cstdint>
+
+#include "softlight/SL_Color.hpp" // SL_ColorDataType
+#include "softlight/SL_Texture.hpp" // SL_TexelOrder
+
+
+
+/*-------------------------------------
+ * Check if texels of one format can be uploaded into a texture of another.
+ *
+ * Identical uncompressed formats can always be copied. Otherwise neither
+ * format can be packed or sRGB, and both must have the same number of channels using
+ * 8-bit, 16-bit, 32-bit, or float elements.
+-------------------------------------*/
+bool sl_is_tex_upload_supported(SL_ColorDataType srcType, SL_ColorDataType dstType) noexcept;
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief The Texture Upload Processor copies an image into a texture,
+ * converting its texel order and color format along the way.
+ *
+ * Work is divided into bands of SL_TEXELS_PER_CHUNK rows which are
+ * interleaved between threads. Within a band, texels are moved in spans of
+ * SL_TEXELS_PER_CHUNK which are contiguous in both ordered and swizzled
+ * layouts, so addresses are only calculated once per span.
+ *
+ * The source image must have the same dimensions as the texture.
+-----------------------------------------------------------------------------*/
+struct SL_TexUploadProcessor
+{
+    // 32 bits
+    uint16_t mThreadId;
+    uint16_t mNumThreads;
+
+    // 32 bits
+    SL_ColorDataType mSrcType;
+    SL_TexelOrder mSrcOrder;
+
+    // 128 bits
+    const void* mSrcTexels;
+    SL_Texture* mTexture;
+
+    // 192 bits total, 24 bytes
+
+    template <class ConvertFunc>
+    void upload_spans(const ConvertFunc& convert) noexcept;
+
+    void execute() noexcept;
+};
+
+
+
+#endif /* SL_TEX_UPLOAD_PROCESSOR_HPP */
@@ -5,6 +5,7 @@
 #include <cstddef> // ptrdiff_t
 
 #include "lightsky/setup/Arch.h"
+#include "lightsky/setup/Macros.h" // LS_LIKELY
 
 #include "lightsky/math/fixed.h"
 #include "lightsky/math/vec_utils.h"
@@ -43,7 +44,7 @@ enum SL_TexChunkInfo : uint32_t
 
 
 
-enum SL_TexelOrder
+enum SL_TexelOrder : uint16_t
 {
     SL_TEXELS_ORDERED,
     SL_TEXELS_SWIZZLED
@@ -51,6 +52,36 @@ enum SL_TexelOrder
 
 
 
+/*-----------------------------------------------------------------------------
+ * Texture storage layouts
+ *
+ * Layered textures store each of their layers as an independent 2D image,
+ * one after another, so a layer can be swizzled without interleaving texels
+ * from its neighbors.
+-----------------------------------------------------------------------------*/
+enum SL_TexLayout : uint16_t
+{
+    SL_TEX_LAYOUT_VOLUME, // 1D, 2D, and 3D textures
+    SL_TEX_LAYOUT_CUBE,   // Six square faces, indexed by SL_CubeFace
+    SL_TEX_LAYOUT_ARRAY   // 2D layers sharing a format and dimensions
+};
+
+
+
+enum SL_CubeFace : uint16_t
+{
+    SL_CUBE_FACE_POSITIVE_X,
+    SL_CUBE_FACE_NEGATIVE_X,
+    SL_CUBE_FACE_POSITIVE_Y,
+    SL_CUBE_FACE_NEGATIVE_Y,
+    SL_CUBE_FACE_POSITIVE_Z,
+    SL_CUBE_FACE_NEGATIVE_Z,
+
+    SL_CUBE_FACE_COUNT
+};
+
+
+
 /**----------------------------------------------------------------------------
  * @brief Generic texture Class
  *
@@ -74,6 +105,10 @@ class alignas(sizeof(uint64_t)) SL_Texture
 
     uint16_t mNumChannels; // 2 bytes
 
+    SL_TexLayout mLayout; // 2 bytes
+
+    SL_TexelOrder mTexelOrder; // 2 bytes
+
     char* mTexels; // 4-8 bytes
 
   public:
@@ -101,6 +136,9 @@ class alignas(sizeof(uint64_t)) SL_Texture
     template <SL_TexelOrder order = SL_TexelOrder::SL_TEXELS_ORDERED>
     ls::math::vec4_t<ptrdiff_t> map_coordinates(uint_fast32_t x, uint_fast32_t y, uint_fast32_t z) const noexcept;
 
+    template <SL_TexelOrder order = SL_TexelOrder::SL_TEXELS_ORDERED>
+    ptrdiff_t map_layer_coordinate(uint_fast32_t x, uint_fast32_t y, uint_fast32_t layer) const noexcept;
+
     uint16_t width() const noexcept;
 
     uint16_t height() const noexcept;
@@ -111,10 +149,38 @@ class alignas(sizeof(uint64_t)) SL_Texture
 
     uint32_t channels() const noexcept;
 
-    int init(SL_ColorDataType type, uint16_t w, uint16_t h, uint16_t d = 1) noexcept;
+    SL_TexLayout layout() const noexcept;
+
+    SL_TexelOrder texel_order() const noexcept;
 
+    // Swizzled (tiled) textures must have a width and height which are
+    // multiples of SL_TEXELS_PER_CHUNK.
+    int init(SL_ColorDataType type, uint16_t w, uint16_t h, uint16_t d = 1, SL_TexelOrder texelOrder = SL_TexelOrder::SL_TEXELS_ORDERED) noexcept;
+
+    // Returns 0 on success, -1 if the image is empty, -2 if the texture is
+    // already initialized, -3 if the image is too large, -4 if the image
+    // could not be swizzled, or -5 if a swizzled image's width or height is
+    // not a multiple of SL_TEXELS_PER_CHUNK. Other errors are forwarded from
+    // init().
     int init(const SL_ImgFile& imgFile, SL_TexelOrder texelOrder = SL_TexelOrder::SL_TEXELS_ORDERED) noexcept;
 
+    // Encode an 8-bit image into one of the block-compressed color types.
+    int init_compressed(const SL_ImgFile& imgFile, SL_ColorDataType compressedType) noexcept;
+
+    int init_cube(SL_ColorDataType type, uint16_t faceSize) noexcept;
+
+    // Faces must be square, share a format, and be ordered by SL_CubeFace.
+    int init_cube(const SL_ImgFile* const pFaces[SL_CUBE_FACE_COUNT], SL_TexelOrder texelOrder = SL_TexelOrder::SL_TEXELS_ORDERED) noexcept;
+
+    // Load a horizontal (4x3 faces) or vertical (3x4 faces) cross.
+    int init_cube_cross(const SL_ImgFile& imgFile, SL_TexelOrder texelOrder = SL_TexelOrder::SL_TEXELS_ORDERED) noexcept;
+
+    int init_array(SL_ColorDataType type, uint16_t w, uint16_t h, uint16_t numLayers) noexcept;
+
+    // Copy an image into one layer of an array texture. The image must match
+    // the texture's format and 2D dimensions.
+    int set_layer(uint16_t layer, const SL_ImgFile& imgFile, SL_TexelOrder texelOrder = SL_TexelOrder::SL_TEXELS_ORDERED) noexcept;
+
     void terminate() noexcept;
 
     SL_ColorDataType type() const noexcept;
@@ -123,6 +189,9 @@ class alignas(sizeof(uint64_t)) SL_Texture
 
     void* data() noexcept;
 
+    // Number of bytes pointed to by data(), including any padding.
+    size_t num_bytes() const noexcept;
+
     template <SL_TexelOrder order = SL_TexelOrder::SL_TEXELS_ORDERED>
     void set_texel(uint16_t x, uint16_t y, uint16_t z, const void* pData) noexcept;
 
@@ -137,6 +206,11 @@ class alignas(sizeof(uint64_t)) SL_Texture
             const void* pData
     ) noexcept;
 
+    // Copy an entire image into the texture on the calling thread,
+    // converting it from "srcOrder" into this texture's texel order. See
+    // SL_Context::upload_texture() for a multi-threaded upload.
+    int upload(const void* pTexels, SL_ColorDataType srcType, SL_TexelOrder srcOrder = SL_TexelOrder::SL_TEXELS_ORDERED) noexcept;
+
     template <typename color_type, SL_TexelOrder order = SL_TexelOrder::SL_TEXELS_ORDERED>
     const color_type texel(uint16_t x, uint16_t y) const noexcept;
 
@@ -149,6 +223,12 @@ class alignas(sizeof(uint64_t)) SL_Texture
     template <typename color_type, SL_TexelOrder order = SL_TexelOrder::SL_TEXELS_ORDERED>
     color_type& texel(uint16_t x, uint16_t y, uint16_t z) noexcept;
 
+    template <typename color_type, SL_TexelOrder order = SL_TexelOrder::SL_TEXELS_ORDERED>
+    const color_type layer_texel(uint16_t x, uint16_t y, uint16_t layer) const noexcept;
+
+    template <typename color_type, SL_TexelOrder order = SL_TexelOrder::SL_TEXELS_ORDERED>
+    color_type& layer_texel(uint16_t x, uint16_t y, uint16_t layer) noexcept;
+
     template <typename color_type, SL_TexelOrder order = SL_TexelOrder::SL_TEXELS_ORDERED>
     const color_type* texel_pointer(uint16_t x, uint16_t y) const noexcept;
 
@@ -161,6 +241,26 @@ class alignas(sizeof(uint64_t)) SL_Texture
     template <typename color_type, SL_TexelOrder order = SL_TexelOrder::SL_TEXELS_ORDERED>
     color_type* texel_pointer(uint16_t x, uint16_t y, uint16_t z) noexcept;
 
+    // Address a texel using the order the texture was initialized with. This
+    // branches on the texel order, so loops over many texels should resolve
+    // it once and use map_coordinate<order>() instead.
+    ptrdiff_t map_native_coordinate(uint_fast32_t x, uint_fast32_t y) const noexcept;
+
+    template <typename color_type>
+    const color_type* native_texel_pointer(uint16_t x, uint16_t y) const noexcept;
+
+    template <typename color_type>
+    color_type* native_texel_pointer(uint16_t x, uint16_t y) noexcept;
+
+    template <typename color_type>
+    const color_type native_texel(uint16_t x, uint16_t y) const noexcept;
+
+    template <typename color_type>
+    color_type& native_texel(uint16_t x, uint16_t y) noexcept;
+
+    // Retrieve the 4x4 block containing a texel of a compressed texture
+    const void* block_pointer(uint16_t x, uint16_t y) const noexcept;
+
     template <typename color_type>
     const color_type* row_pointer(uintptr_t y) const noexcept;
 
@@ -312,6 +412,17 @@ inline LS_INLINE ls::math::vec4_t<ptrdiff_t> SL_Texture::map_coordinates<SL_Texe
 
 
 
+/*-------------------------------------
+ * Convert an X/Y coordinate within a single layer of a layered texture.
+-------------------------------------*/
+template <SL_TexelOrder order>
+inline LS_INLINE ptrdiff_t SL_Texture::map_layer_coordinate(uint_fast32_t x, uint_fast32_t y, uint_fast32_t layer) const noexcept
+{
+    return map_coordinate<order>(x, y) + (ptrdiff_t)((uint_fast32_t)mWidth * (uint_fast32_t)mHeight * layer);
+}
+
+
+
 /*-------------------------------------
  * Get the texture width
 -------------------------------------*/
@@ -362,6 +473,26 @@ inline LS_INLINE uint32_t SL_Texture::channels() const noexcept
 
 
 
+/*-------------------------------------
+ * Get the storage layout
+-------------------------------------*/
+inline LS_INLINE SL_TexLayout SL_Texture::layout() const noexcept
+{
+    return mLayout;
+}
+
+
+
+/*-------------------------------------
+ * Get the order of the texture's texels in memory
+-------------------------------------*/
+inline LS_INLINE SL_TexelOrder SL_Texture::texel_order() const noexcept
+{
+    return mTexelOrder;
+}
+
+
+
 /*-------------------------------------
  * Get the texture mType
 -------------------------------------*/
@@ -494,6 +625,30 @@ inline LS_INLINE color_type& SL_Texture::texel(uint16_t x, uint16_t y, uint16_t
 
 
 
+/*-------------------------------------
+ * Retrieve a texel from a layer (const)
+-------------------------------------*/
+template <typename color_type, SL_TexelOrder order>
+inline LS_INLINE const color_type SL_Texture::layer_texel(uint16_t x, uint16_t y, uint16_t layer) const noexcept
+{
+    const ptrdiff_t index = map_layer_coordinate<order>(x, y, layer);
+    return reinterpret_cast<const color_type*>(mTexels)[index];
+}
+
+
+
+/*-------------------------------------
+ * Retrieve a texel from a layer
+-------------------------------------*/
+template <typename color_type, SL_TexelOrder order>
+inline LS_INLINE color_type& SL_Texture::layer_texel(uint16_t x, uint16_t y, uint16_t layer) noexcept
+{
+    const ptrdiff_t index = map_layer_coordinate<order>(x, y, layer);
+    return reinterpret_cast<color_type*>(mTexels)[index];
+}
+
+
+
 /*-------------------------------------
  * Retrieve a swizzled texel (const)
 -------------------------------------*/
@@ -542,6 +697,75 @@ inline LS_INLINE color_type* SL_Texture::texel_pointer(uint16_t x, uint16_t y, u
 
 
 
+/*-------------------------------------
+ * Convert an X/Y coordinate using the texture's own texel order
+-------------------------------------*/
+inline LS_INLINE ptrdiff_t SL_Texture::map_native_coordinate(uint_fast32_t x, uint_fast32_t y) const noexcept
+{
+    return LS_LIKELY(mTexelOrder == SL_TexelOrder::SL_TEXELS_ORDERED)
+        ? map_coordinate<SL_TexelOrder::SL_TEXELS_ORDERED>(x, y)
+        : map_coordinate<SL_TexelOrder::SL_TEXELS_SWIZZLED>(x, y);
+}
+
+
+
+/*-------------------------------------
+ * Retrieve a texel in its native order (const)
+-------------------------------------*/
+template <typename color_type>
+inline LS_INLINE const color_type* SL_Texture::native_texel_pointer(uint16_t x, uint16_t y) const noexcept
+{
+    return reinterpret_cast<const color_type*>(mTexels) + map_native_coordinate(x, y);
+}
+
+
+
+/*-------------------------------------
+ * Retrieve a texel in its native order
+-------------------------------------*/
+template <typename color_type>
+inline LS_INLINE color_type* SL_Texture::native_texel_pointer(uint16_t x, uint16_t y) noexcept
+{
+    return reinterpret_cast<color_type*>(mTexels) + map_native_coordinate(x, y);
+}
+
+
+
+/*-------------------------------------
+ * Retrieve a texel in its native order (const)
+-------------------------------------*/
+template <typename color_type>
+inline LS_INLINE const color_type SL_Texture::native_texel(uint16_t x, uint16_t y) const noexcept
+{
+    return *native_texel_pointer<color_type>(x, y);
+}
+
+
+
+/*-------------------------------------
+ * Retrieve a texel in its native order
+-------------------------------------*/
+template <typename color_type>
+inline LS_INLINE color_type& SL_Texture::native_texel(uint16_t x, uint16_t y) noexcept
+{
+    return *native_texel_pointer<color_type>(x, y);
+}
+
+
+
+/*-------------------------------------
+ * Retrieve a compressed block
+-------------------------------------*/
+inline LS_INLINE const void* SL_Texture::block_pointer(uint16_t x, uint16_t y) const noexcept
+{
+    const uintptr_t blocksX = ((uintptr_t)mWidth + 3u) >> 2u;
+    const uintptr_t index   = ((uintptr_t)x >> 2u) + blocksX * ((uintptr_t)y >> 2u);
+
+    return mTexels + index * (uintptr_t)mBytesPerTexel;
+}
+
+
+
 /*-------------------------------------
  * Retrieve a scanline
 -------------------------------------*/
@@ -0,0 +1,129 @@
+
+#ifndef SL_TEXTURE_COMPRESSION_HPP
+#define SL_TEXTURE_COMPRESSION_HPP
+
+#include <cstdint>
+
+#include "softlight/SL_Color.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+class SL_Texture;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Block-compression constants
+-----------------------------------------------------------------------------*/
+enum SL_TexBlockInfo : uint32_t
+{
+    SL_TEXELS_PER_BLOCK_SIDE  = 4,
+    SL_TEXEL_SHIFTS_PER_BLOCK = 2,
+    SL_TEXELS_PER_BLOCK       = SL_TEXELS_PER_BLOCK_SIDE * SL_TEXELS_PER_BLOCK_SIDE,
+
+    SL_TEX_BLOCK_CACHE_ENTRIES = 16
+};
+
+
+
+/*-----------------------------------------------------------------------------
+ * Block decoding
+ *
+ * All decoders output 16 texels in row-major order. Single and dual-channel
+ * formats (BC4 & BC5) place their data in the red and green channels, with
+ * blue set to 0 and alpha set to 255.
+-----------------------------------------------------------------------------*/
+void sl_decode_bc1_block(const void* pBlock, SL_ColorRGBA8* pOutTexels) noexcept;
+
+void sl_decode_bc3_block(const void* pBlock, SL_ColorRGBA8* pOutTexels) noexcept;
+
+void sl_decode_bc4_block(const void* pBlock, SL_ColorRGBA8* pOutTexels) noexcept;
+
+void sl_decode_bc5_block(const void* pBlock, SL_ColorRGBA8* pOutTexels) noexcept;
+
+void sl_decode_block(SL_ColorDataType type, const void* pBlock, SL_ColorRGBA8* pOutTexels) noexcept;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Block encoding
+ *
+ * Encoders take 16 RGBA texels in row-major order and use a bounding-box fit
+ * of the block's endpoints. BC4 encodes the red channel and BC5 encodes the
+ * red & green channels.
+-----------------------------------------------------------------------------*/
+void sl_encode_bc1_block(const SL_ColorRGBA8* pTexels, void* pOutBlock) noexcept;
+
+void sl_encode_bc3_block(const SL_ColorRGBA8* pTexels, void* pOutBlock) noexcept;
+
+void sl_encode_bc4_block(const SL_ColorRGBA8* pTexels, void* pOutBlock) noexcept;
+
+void sl_encode_bc5_block(const SL_ColorRGBA8* pTexels, void* pOutBlock) noexcept;
+
+/**
+ * @brief Compress an uncompressed 8-bit image into a block-compressed
+ * texture's storage.
+ *
+ * @param pTexels
+ * A pointer to a tightly-packed R8, RG8, RGB8, or RGBA8 image.
+ *
+ * @param srcType
+ * The color type of the input image.
+ *
+ * @param outTex
+ * A texture, initialized with a compressed format, matching the width and
+ * height of the input image.
+ *
+ * @return 0 on success, -1 if the source format is unsupported, or -2 if the
+ * output texture does not use a compressed format.
+ */
+int sl_encode_texture(const void* pTexels, SL_ColorDataType srcType, SL_Texture& outTex) noexcept;
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief Per-thread cache of decoded texture blocks.
+ *
+ * Neighboring fragments tend to sample the same 4x4 blocks, so decoded
+ * blocks are kept in a small direct-mapped cache owned by each thread. Every
+ * (re)initialization of a compressed texture bumps a global generation count
+ * which invalidates all caches the next time they are accessed.
+-----------------------------------------------------------------------------*/
+struct SL_TexBlockCache
+{
+    uint32_t mGeneration;
+
+    const void* mKeys[SL_TEX_BLOCK_CACHE_ENTRIES];
+
+    SL_ColorRGBA8 mTexels[SL_TEX_BLOCK_CACHE_ENTRIES][SL_TEXELS_PER_BLOCK];
+
+    const SL_ColorRGBA8* fetch(SL_ColorDataType type, const void* pBlock, uint32_t blockBytes) noexcept;
+};
+
+
+
+/*-------------------------------------
+ * Retrieve the calling thread's block cache
+-------------------------------------*/
+SL_TexBlockCache& sl_tex_block_cache() noexcept;
+
+
+
+/*-------------------------------------
+ * Invalidate the block caches of all threads
+-------------------------------------*/
+void sl_invalidate_tex_block_caches() noexcept;
+
+
+
+/*-------------------------------------
+ * Load a single texel from a compressed texture
+-------------------------------------*/
+SL_ColorRGBA8 sl_fetch_compressed_texel(const SL_Texture& tex, uint16_t x, uint16_t y) noexcept;
+
+
+
+#endif /* SL_TEXTURE_COMPRESSION_HPP */
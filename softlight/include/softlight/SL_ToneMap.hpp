@@ -0,0 +1,167 @@
+
+#ifndef SL_TONE_MAP_HPP
+#define SL_TONE_MAP_HPP
+
+#include <cmath> // std::pow()
+#include <cstdint>
+
+#include "lightsky/setup/Macros.h" // LS_INLINE
+
+#include "lightsky/math/vec4.h"
+#include "lightsky/math/vec_utils.h"
+
+#include "softlight/SL_ColorSRGB.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Tone Mapping Parameters
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Curve used to compress HDR colors into the range [0, 1]
+-------------------------------------*/
+enum SL_ToneMapOperator : uint8_t
+{
+    SL_TONE_MAP_CLAMP,
+    SL_TONE_MAP_REINHARD,
+    SL_TONE_MAP_ACES
+};
+
+
+
+/*-------------------------------------
+ * Transfer function applied after tone mapping
+-------------------------------------*/
+enum SL_ToneMapEncoding : uint8_t
+{
+    SL_TONE_MAP_ENCODE_LINEAR,
+    SL_TONE_MAP_ENCODE_GAMMA,
+    SL_TONE_MAP_ENCODE_SRGB
+};
+
+
+
+/*-------------------------------------
+ * Tone mapping applied while blitting an HDR texture.
+ *
+ * Colors are multiplied by "exposure," compressed by the tone mapping
+ * operator, then encoded for display. "gamma" is only used with
+ * SL_TONE_MAP_ENCODE_GAMMA. Alpha is passed through unchanged.
+-------------------------------------*/
+struct SL_ToneMap
+{
+    SL_ToneMapOperator op;
+    SL_ToneMapEncoding encoding;
+    float exposure;
+    float gamma;
+};
+
+
+
+/*-----------------------------------------------------------------------------
+ * Tone Mapping Operators
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Clamp exposed colors to 1
+-------------------------------------*/
+struct SL_ToneMapOpClamp
+{
+    inline LS_INLINE ls::math::vec4 operator()(const ls::math::vec4& c) const noexcept
+    {
+        return ls::math::min(c, ls::math::vec4{1.f});
+    }
+};
+
+
+
+/*-------------------------------------
+ * Reinhard: c / (1 + c)
+-------------------------------------*/
+struct SL_ToneMapOpReinhard
+{
+    inline LS_INLINE ls::math::vec4 operator()(const ls::math::vec4& c) const noexcept
+    {
+        return c * ls::math::rcp(c + 1.f);
+    }
+};
+
+
+
+/*-------------------------------------
+ * Krzysztof Narkowicz's fit of the ACES filmic curve
+-------------------------------------*/
+struct SL_ToneMapOpACES
+{
+    inline LS_INLINE ls::math::vec4 operator()(const ls::math::vec4& c) const noexcept
+    {
+        const ls::math::vec4&& num = c * ls::math::fmadd(c, ls::math::vec4{2.51f}, ls::math::vec4{0.03f});
+        const ls::math::vec4&& den = ls::math::fmadd(c, ls::math::fmadd(c, ls::math::vec4{2.43f}, ls::math::vec4{0.59f}), ls::math::vec4{0.14f});
+        return ls::math::min(num * ls::math::rcp(den), ls::math::vec4{1.f});
+    }
+};
+
+
+
+/*-----------------------------------------------------------------------------
+ * Display Encoding
+ *
+ * Each encoder converts a tone-mapped color into 8-bit RGBA. Encoders which
+ * use a curve read it from a table of SL_SRGB_ENCODE_LUT_SIZE values.
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Build a table for the power curve (1/gamma), indexed like
+ * SL_LINEAR_TO_SRGB_LUT. This is evaluated once per blit so no power
+ * functions are needed per texel.
+-------------------------------------*/
+inline void sl_make_gamma_lut(float invGamma, uint8_t* outLut) noexcept
+{
+    constexpr float scale = 1.f / (float)(SL_SRGB_ENCODE_LUT_SIZE-1u);
+
+    for (unsigned i = 0; i < SL_SRGB_ENCODE_LUT_SIZE; ++i)
+    {
+        outLut[i] = (uint8_t)(std::pow((float)i * scale, invGamma) * 255.f + 0.5f);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Store linear values
+-------------------------------------*/
+struct SL_ToneMapEncodeLinear
+{
+    inline LS_INLINE SL_ColorRGBA8 operator()(const ls::math::vec4& c, const uint8_t*) const noexcept
+    {
+        return color_cast<uint8_t, float>(ls::math::clamp(c, ls::math::vec4{0.f}, ls::math::vec4{1.f}));
+    }
+};
+
+
+
+/*-------------------------------------
+ * Apply a power curve of (1/gamma) using a table from sl_make_gamma_lut()
+-------------------------------------*/
+struct SL_ToneMapEncodeGamma
+{
+    inline LS_INLINE SL_ColorRGBA8 operator()(const ls::math::vec4& c, const uint8_t* pGammaLut) const noexcept
+    {
+        return sl_linear_to_lut(c, pGammaLut);
+    }
+};
+
+
+
+/*-------------------------------------
+ * Encode into sRGB using the lookup table from SL_ColorSRGB.hpp
+-------------------------------------*/
+struct SL_ToneMapEncodeSRGB
+{
+    inline LS_INLINE SL_ColorRGBA8 operator()(const ls::math::vec4& c, const uint8_t*) const noexcept
+    {
+        return sl_linear_to_srgb(c);
+    }
+};
+
+
+
+#endif /* SL_TONE_MAP_HPP */
@@ -34,6 +34,8 @@ class SL_PTVCache
 
     SL_TransformedVert mVertices[PTV_CACHE_SIZE];
 
+    size_t mNumShaded;
+
   public:
     SL_PTVCache(ls::math::vec4_t<float> (*pShader)(SL_VertexParam&), SL_VertexParam& inParam) noexcept;
 
@@ -50,6 +52,8 @@ class SL_PTVCache
     void query_and_update(size_t key, const ls::math::mat4& scissorMat, SL_TransformedVert& out) noexcept;
 
     void reset(ls::math::vec4_t<float> (*pShader)(SL_VertexParam&), SL_VertexParam& inParam) noexcept;
+
+    size_t num_shaded() const noexcept;
 };
 
 
@@ -77,6 +81,7 @@ inline LS_INLINE SL_TransformedVert* SL_PTVCache::query_and_update(size_t key, c
         mParam->vertId = key;
         mParam->pVaryings = mVertices[i].varyings;
         mVertices[i].vert = scissorMat * mShader(*mParam);
+        ++mNumShaded;
     }
 
     return mVertices+i;
@@ -119,4 +124,14 @@ inline LS_INLINE void SL_PTVCache::query_and_update(size_t key, const ls::math::
 
 
 
+/*-------------------------------------
+ * Number of cache misses (shader invocations) since the last reset
+-------------------------------------*/
+inline LS_INLINE size_t SL_PTVCache::num_shaded() const noexcept
+{
+    return mNumShaded;
+}
+
+
+
 #endif /* SL_VERTEX_CACHE_HPP */
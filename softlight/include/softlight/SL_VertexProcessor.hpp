@@ -32,9 +32,11 @@ template <typename data_t>
 union SL_BinCounterAtomic;
 
 class SL_Context; // SL_Context.hpp
+class SL_DamageRegion; // SL_DamageRegion.hpp
 struct SL_FragmentBin; // SL_ShaderProcessor.hpp
 struct SL_FragCoord;
 class SL_Framebuffer; // SL_Framebuffer.hpp
+struct SL_PipelineStatistics; // SL_PipelineStatistics.hpp
 struct SL_PointRasterizer;
 struct SL_LineRasterizer;
 class SL_Shader; // SL_Shader.hpp
@@ -72,6 +74,10 @@ class SL_VertexProcessor
     SL_FragmentBin* mFragBins;
     SL_FragCoord* mFragQueues;
 
+    SL_PipelineStatistics* mStats; // indexed by thread ID
+
+    const SL_DamageRegion* mDirtyRegion; // NULL unless drawing into a dirty region
+
     virtual ~SL_VertexProcessor() noexcept = default;
     SL_VertexProcessor() noexcept = default;
     SL_VertexProcessor(const SL_VertexProcessor&) noexcept = default;
@@ -82,6 +88,8 @@ class SL_VertexProcessor
     virtual void execute() noexcept = 0;
 
   protected:
+    bool is_outside_dirty_region(float bboxMinX, float bboxMinY, float bboxMaxX, float bboxMaxY) const noexcept;
+
     template <typename RasterizerType>
     void flush_rasterizer() const noexcept;
 
@@ -0,0 +1,48 @@
+#ifndef SL_VOLUME_PROCESSOR_HPP
+#define SL_VOLUME_PROCESSOR_HPP
+
+#include <cstdint>
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+enum SL_TexelOrder : uint16_t;
+class SL_Texture;
+class SL_VolumeBricks;
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief The Volume Processor fills an SL_VolumeBricks grid in parallel.
+ *
+ * Bricks are interleaved between threads. Each brick reads its own region of
+ * the volume and writes only its own range, so no synchronization is needed.
+-----------------------------------------------------------------------------*/
+struct SL_VolumeProcessor
+{
+    // 32 bits
+    uint16_t mThreadId;
+    uint16_t mNumThreads;
+
+    // 16 bits
+    SL_TexelOrder mTexelOrder;
+
+    // 64 bits
+    const SL_Texture* mVolume;
+
+    // 64 bits
+    SL_VolumeBricks* mBricks;
+
+    // 192 bits total, 24 bytes
+
+    template <typename data_type, SL_TexelOrder order>
+    void reduce_bricks() noexcept;
+
+    void execute() noexcept;
+};
+
+
+
+#endif /* SL_VOLUME_PROCESSOR_HPP */
@@ -0,0 +1,324 @@
+
+#ifndef SL_VOLUME_RENDERING_HPP
+#define SL_VOLUME_RENDERING_HPP
+
+#include <cstdint>
+
+#include "lightsky/utils/Pointer.h"
+
+#include "lightsky/math/scalar_utils.h"
+#include "lightsky/math/vec4.h"
+#include "lightsky/math/vec_utils.h"
+
+#include "softlight/SL_Sampler.hpp" // sl_sample_trilinear_batch()
+#include "softlight/SL_Texture.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Volume Rendering Constants
+-----------------------------------------------------------------------------*/
+enum SL_VolumeInfo : uint32_t
+{
+    SL_VOLUME_DEFAULT_BRICK_SIZE = 8,
+
+    // Number of samples taken at once by sl_sample_volume_ray()
+    SL_VOLUME_RAY_BATCH_SIZE = SL_SAMPLER_BATCH_LANES
+};
+
+
+
+/*-------------------------------------
+ * Min/Max range of texel values within a brick
+-------------------------------------*/
+struct SL_VolumeBrickRange
+{
+    float minVal;
+    float maxVal;
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief Volume Brick Grid
+ *
+ * A coarse grid over a single-channel 3D texture which stores the minimum
+ * and maximum texel values of each (brickSize^3) region. Each range also
+ * includes a one-texel border around its brick, so every tap made by
+ * sl_sample_trilinear() from within a brick is accounted for. A ray marcher
+ * can then step over bricks whose maximum falls below its visibility
+ * threshold without sampling the volume.
+ *
+ * Ranges are stored in the texture's native units (0-255 for an R8 volume).
+ * Bricks are allocated with init() and filled in parallel through
+ * SL_Context::build_volume_bricks().
+-----------------------------------------------------------------------------*/
+class SL_VolumeBricks
+{
+    friend struct SL_VolumeProcessor;
+
+  private:
+    // Number of bricks per unit of normalized texture coordinates
+    float mScaleX;
+
+    float mScaleY;
+
+    float mScaleZ;
+
+    uint16_t mBrickSize;
+
+    uint16_t mBricksX;
+
+    uint16_t mBricksY;
+
+    uint16_t mBricksZ;
+
+    ls::utils::UniqueAlignedArray<SL_VolumeBrickRange> mRanges;
+
+  public:
+    ~SL_VolumeBricks() noexcept;
+
+    SL_VolumeBricks() noexcept;
+
+    SL_VolumeBricks(const SL_VolumeBricks& b) noexcept;
+
+    SL_VolumeBricks(SL_VolumeBricks&& b) noexcept;
+
+    SL_VolumeBricks& operator=(const SL_VolumeBricks& b) noexcept;
+
+    SL_VolumeBricks& operator=(SL_VolumeBricks&& b) noexcept;
+
+    int init(uint16_t volumeW, uint16_t volumeH, uint16_t volumeD, uint16_t brickSize = SL_VOLUME_DEFAULT_BRICK_SIZE) noexcept;
+
+    int init(const SL_Texture& volume, uint16_t brickSize = SL_VOLUME_DEFAULT_BRICK_SIZE) noexcept;
+
+    void terminate() noexcept;
+
+    bool valid() const noexcept;
+
+    uint16_t brick_size() const noexcept;
+
+    uint16_t bricks_x() const noexcept;
+
+    uint16_t bricks_y() const noexcept;
+
+    uint16_t bricks_z() const noexcept;
+
+    unsigned num_bricks() const noexcept;
+
+    unsigned brick_index(float u, float v, float w) const noexcept;
+
+    const SL_VolumeBrickRange& range(unsigned brickId) const noexcept;
+
+    const SL_VolumeBrickRange& range(float u, float v, float w) const noexcept;
+
+    unsigned skip_steps(const ls::math::vec4& rayPos, const ls::math::vec4& rayStep, float threshold) const noexcept;
+};
+
+
+
+/*-------------------------------------
+ * Check if the bricks can be used
+-------------------------------------*/
+inline bool SL_VolumeBricks::valid() const noexcept
+{
+    return mRanges != nullptr;
+}
+
+
+
+/*-------------------------------------
+ * Number of texels along each side of a brick
+-------------------------------------*/
+inline uint16_t SL_VolumeBricks::brick_size() const noexcept
+{
+    return mBrickSize;
+}
+
+
+
+/*-------------------------------------
+ * Number of bricks along the X axis
+-------------------------------------*/
+inline uint16_t SL_VolumeBricks::bricks_x() const noexcept
+{
+    return mBricksX;
+}
+
+
+
+/*-------------------------------------
+ * Number of bricks along the Y axis
+-------------------------------------*/
+inline uint16_t SL_VolumeBricks::bricks_y() const noexcept
+{
+    return mBricksY;
+}
+
+
+
+/*-------------------------------------
+ * Number of bricks along the Z axis
+-------------------------------------*/
+inline uint16_t SL_VolumeBricks::bricks_z() const noexcept
+{
+    return mBricksZ;
+}
+
+
+
+/*-------------------------------------
+ * Total brick count
+-------------------------------------*/
+inline unsigned SL_VolumeBricks::num_bricks() const noexcept
+{
+    return (unsigned)mBricksX * (unsigned)mBricksY * (unsigned)mBricksZ;
+}
+
+
+
+/*-------------------------------------
+ * Brick index from normalized texture coordinates
+-------------------------------------*/
+inline unsigned SL_VolumeBricks::brick_index(float u, float v, float w) const noexcept
+{
+    const unsigned bx = (unsigned)ls::math::clamp<int>((int)(u * mScaleX), 0, (int)mBricksX - 1);
+    const unsigned by = (unsigned)ls::math::clamp<int>((int)(v * mScaleY), 0, (int)mBricksY - 1);
+    const unsigned bz = (unsigned)ls::math::clamp<int>((int)(w * mScaleZ), 0, (int)mBricksZ - 1);
+
+    return bx + mBricksX * (by + mBricksY * bz);
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the value range of a brick
+-------------------------------------*/
+inline const SL_VolumeBrickRange& SL_VolumeBricks::range(unsigned brickId) const noexcept
+{
+    return mRanges[brickId];
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the value range at a texture coordinate
+-------------------------------------*/
+inline const SL_VolumeBrickRange& SL_VolumeBricks::range(float u, float v, float w) const noexcept
+{
+    return mRanges[brick_index(u, v, w)];
+}
+
+
+
+/*-------------------------------------
+ * Empty-space skipping
+ *
+ * Returns 0 if the brick at "rayPos" contains any value at or above
+ * "threshold." Otherwise this returns the number of steps of "rayStep"
+ * required to leave the brick. Both vectors are in normalized texture
+ * coordinates.
+-------------------------------------*/
+inline unsigned SL_VolumeBricks::skip_steps(const ls::math::vec4& rayPos, const ls::math::vec4& rayStep, float threshold) const noexcept
+{
+    namespace math = ls::math;
+
+    const unsigned bx = (unsigned)math::clamp<int>((int)(rayPos[0] * mScaleX), 0, (int)mBricksX - 1);
+    const unsigned by = (unsigned)math::clamp<int>((int)(rayPos[1] * mScaleY), 0, (int)mBricksY - 1);
+    const unsigned bz = (unsigned)math::clamp<int>((int)(rayPos[2] * mScaleZ), 0, (int)mBricksZ - 1);
+
+    if (mRanges[bx + mBricksX * (by + mBricksY * bz)].maxVal >= threshold)
+    {
+        return 0;
+    }
+
+    const math::vec4 brickMin = {(float)bx, (float)by, (float)bz, 0.f};
+    const math::vec4 invScale = math::rcp(math::vec4{mScaleX, mScaleY, mScaleZ, 1.f});
+    const math::vec4&& lo     = brickMin * invScale;
+    const math::vec4&& hi     = (brickMin + 1.f) * invScale;
+
+    // Parametric distance to the exit plane of each axis
+    float t = 65535.f;
+
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        if (rayStep[i] > 0.f)
+        {
+            t = math::min(t, (hi[i] - rayPos[i]) * math::rcp(rayStep[i]));
+        }
+        else if (rayStep[i] < 0.f)
+        {
+            t = math::min(t, (lo[i] - rayPos[i]) * math::rcp(rayStep[i]));
+        }
+    }
+
+    // Round up so the ray lands on or just past the brick's exit plane
+    const unsigned steps = (unsigned)math::max(t, 0.f);
+    return math::max<unsigned>(steps + ((float)steps < t ? 1u : 0u), 1u);
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Ray Marching Utilities
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Sample a volume at SL_VOLUME_RAY_BATCH_SIZE consecutive ray steps
+ *
+ * Positions are generated as (rayPos + rayStep * i) in normalized texture
+ * coordinates, then filtered together with sl_sample_trilinear_batch().
+-------------------------------------*/
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TEXELS_ORDERED>
+inline LS_INLINE void sl_sample_volume_ray(
+    const SL_Texture& tex,
+    const ls::math::vec4& rayPos,
+    const ls::math::vec4& rayStep,
+    color_type* pOutTexels) noexcept
+{
+    alignas(16) float x[SL_VOLUME_RAY_BATCH_SIZE];
+    alignas(16) float y[SL_VOLUME_RAY_BATCH_SIZE];
+    alignas(16) float z[SL_VOLUME_RAY_BATCH_SIZE];
+
+    for (unsigned i = 0; i < SL_VOLUME_RAY_BATCH_SIZE; ++i)
+    {
+        const ls::math::vec4&& p = ls::math::fmadd(rayStep, ls::math::vec4{(float)i}, rayPos);
+        x[i] = p[0];
+        y[i] = p[1];
+        z[i] = p[2];
+    }
+
+    sl_sample_trilinear_batch<color_type, WrapMode, order, SL_VOLUME_RAY_BATCH_SIZE>(tex, x, y, z, pOutTexels);
+}
+
+
+
+/*-------------------------------------
+ * Front-to-back compositing
+ *
+ * "dst" contains premultiplied color with its accumulated opacity in the
+ * alpha channel. "src" should not be premultiplied.
+-------------------------------------*/
+inline LS_INLINE ls::math::vec4 sl_volume_blend(const ls::math::vec4& dst, const ls::math::vec4& src, float srcAlpha) noexcept
+{
+    const float weight = (1.f - dst[3]) * srcAlpha;
+    const ls::math::vec4 premultiplied = {src[0], src[1], src[2], 1.f};
+
+    return ls::math::fmadd(premultiplied, ls::math::vec4{weight}, dst);
+}
+
+
+
+/*-------------------------------------
+ * Early ray termination
+ *
+ * Once a front-to-back ray has become (nearly) opaque, further samples can
+ * no longer contribute to its final color.
+-------------------------------------*/
+inline LS_INLINE bool sl_volume_ray_terminated(const ls::math::vec4& dst, float opacityCutoff = 0.99f) noexcept
+{
+    return dst[3] >= opacityCutoff;
+}
+
+
+
+#endif /* SL_VOLUME_RENDERING_HPP */
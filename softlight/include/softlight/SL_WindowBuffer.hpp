@@ -6,6 +6,9 @@
 
 #include "lightsky/utils/Pointer.h"
 
+#include "lightsky/math/mat4.h"
+
+#include "softlight/SL_DamageRegion.hpp"
 #include "softlight/SL_Texture.hpp"
 
 
@@ -31,6 +34,21 @@ class SL_Texture;
  * @brief The SL_WindowBuffer class encapsulates the native windowing system's
  * backbuffer. This class gets passed into an SL_RenderWindow for blitting to
  * the front buffer.
+ *
+ * The internal texture aliases the memory shared with the windowing system
+ * and can be attached to a framebuffer so fragments are written directly
+ * into presentable memory. Such a framebuffer differs from a regular render
+ * target in two ways:
+ *
+ * - Rows are stored top-down while SL_Context::blit() flips textures
+ *   vertically. Use sl_window_buffer_projection() and swap the cull mode to
+ *   keep images upright.
+ * - Texels are stored in the native BGRA order of the display, the same as
+ *   blitting an SL_COLOR_RGBA_8U texture. Shaders should output (b, g, r, a)
+ *   when the original color order matters.
+ *
+ * Any depth buffer used with the window buffer must be reallocated whenever
+ * the window buffer is resized.
 -----------------------------------------------------------------------------*/
 class SL_WindowBuffer
 {
@@ -40,9 +58,17 @@ class SL_WindowBuffer
   public:
     static ls::utils::Pointer<SL_WindowBuffer> create() noexcept;
 
+    // Create a window buffer compatible with a specific window, including
+    // headless windows
+    static ls::utils::Pointer<SL_WindowBuffer> create(const SL_RenderWindow& window) noexcept;
+
   protected:
     SL_Texture mTexture;
 
+    // Regions modified by blits since the last presentation, in window
+    // coordinates (rows are top-down)
+    SL_DamageRegion mDamage;
+
   public:
     virtual ~SL_WindowBuffer() noexcept = 0;
 
@@ -77,6 +103,10 @@ class SL_WindowBuffer
     inline const SL_Texture& texture() const noexcept;
 
     inline SL_Texture& texture() noexcept;
+
+    inline const SL_DamageRegion& damage() const noexcept;
+
+    inline SL_DamageRegion& damage() noexcept;
 };
 
 
@@ -111,4 +141,40 @@ inline SL_Texture& SL_WindowBuffer::texture() noexcept
 
 
 
+/*-------------------------------------
+ * Retrieve the regions which need to be presented.
+-------------------------------------*/
+inline const SL_DamageRegion& SL_WindowBuffer::damage() const noexcept
+{
+    return mDamage;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the regions which need to be presented.
+-------------------------------------*/
+inline SL_DamageRegion& SL_WindowBuffer::damage() noexcept
+{
+    return mDamage;
+}
+
+
+
+/*-------------------------------------
+ * Flip a projection matrix vertically so it can render directly into a
+ * window buffer.
+-------------------------------------*/
+inline ls::math::mat4 sl_window_buffer_projection(const ls::math::mat4& projection) noexcept
+{
+    return ls::math::mat4{
+        1.f,  0.f, 0.f, 0.f,
+        0.f, -1.f, 0.f, 0.f,
+        0.f,  0.f, 1.f, 0.f,
+        0.f,  0.f, 0.f, 1.f
+    } * projection;
+}
+
+
+
 #endif /* SL_WINDOW_BUFFER_HPP */
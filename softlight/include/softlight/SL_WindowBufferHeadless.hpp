@@ -0,0 +1,130 @@
+
+#ifndef SL_WINDOW_BUFFER_HEADLESS_HPP
+#define SL_WINDOW_BUFFER_HEADLESS_HPP
+
+#include "softlight/SL_WindowBuffer.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+namespace ls
+{
+    namespace math
+    {
+        template <typename color_type>
+        union vec4_t;
+    }
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Headless Window Buffer
+ *
+ * The backbuffer is a plain texture in system memory which is never shared
+ * with a windowing system. Like the native window buffers, it holds
+ * SL_COLOR_RGBA_8U texels in top-down rows and blits copy channels without
+ * reordering them, so rendering code behaves identically with or without a
+ * display. Native displays read those bytes as BGRA, while no such
+ * conversion happens here.
+-----------------------------------------------------------------------------*/
+class SL_WindowBufferHeadless : public SL_WindowBuffer
+{
+  private:
+    SL_RenderWindow* mWindow;
+
+  public:
+    virtual ~SL_WindowBufferHeadless() noexcept override;
+
+    SL_WindowBufferHeadless() noexcept;
+
+    SL_WindowBufferHeadless(const SL_WindowBufferHeadless&) = delete;
+
+    SL_WindowBufferHeadless(SL_WindowBufferHeadless&&) noexcept;
+
+    SL_WindowBufferHeadless& operator=(const SL_WindowBufferHeadless&) = delete;
+
+    SL_WindowBufferHeadless& operator=(SL_WindowBufferHeadless&&) noexcept;
+
+    virtual int init(SL_RenderWindow& win, unsigned width, unsigned height) noexcept override;
+
+    virtual int terminate() noexcept override;
+
+    virtual unsigned width() const noexcept override;
+
+    virtual unsigned height() const noexcept override;
+
+    virtual const void* native_handle() const noexcept override;
+
+    virtual void* native_handle() noexcept override;
+
+    virtual const ls::math::vec4_t<uint8_t>* buffer() const noexcept override;
+
+    virtual ls::math::vec4_t<uint8_t>* buffer() noexcept override;
+};
+
+
+
+/*-------------------------------------
+ * Get the backbuffer width
+-------------------------------------*/
+inline unsigned SL_WindowBufferHeadless::width() const noexcept
+{
+    return mTexture.width();
+}
+
+
+
+/*-------------------------------------
+ * Get the backbuffer height
+-------------------------------------*/
+inline unsigned SL_WindowBufferHeadless::height() const noexcept
+{
+    return mTexture.height();
+}
+
+
+
+/*-------------------------------------
+ * Native Handle
+-------------------------------------*/
+inline const void* SL_WindowBufferHeadless::native_handle() const noexcept
+{
+    return mTexture.data();
+}
+
+
+
+/*-------------------------------------
+ * Native Handle
+-------------------------------------*/
+inline void* SL_WindowBufferHeadless::native_handle() noexcept
+{
+    return mTexture.data();
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the raw data within the backbuffer
+-------------------------------------*/
+inline const ls::math::vec4_t<uint8_t>* SL_WindowBufferHeadless::buffer() const noexcept
+{
+    return reinterpret_cast<const ls::math::vec4_t<uint8_t>*>(mTexture.data());
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the raw data within the backbuffer
+-------------------------------------*/
+inline ls::math::vec4_t<uint8_t>* SL_WindowBufferHeadless::buffer() noexcept
+{
+    return reinterpret_cast<ls::math::vec4_t<uint8_t>*>(mTexture.data());
+}
+
+
+
+#endif /* SL_WINDOW_BUFFER_HEADLESS_HPP */
@@ -3,6 +3,7 @@
 #include "lightsky/math/fixed.h"
 
 #include "softlight/SL_BlitProcesor.hpp"
+#include "softlight/SL_Profiler.hpp"
 
 
 
@@ -41,21 +42,111 @@ namespace math = ls::math;
     template void SL_BlitProcessor::blit_src_rgba<uint64_t>();
     template void SL_BlitProcessor::blit_src_rgba<float>();
     template void SL_BlitProcessor::blit_src_rgba<double>();
+    template void SL_BlitProcessor::blit_src_unpacked<SL_BlitHalfLoader<1>>();
+    template void SL_BlitProcessor::blit_src_unpacked<SL_BlitHalfLoader<2>>();
+    template void SL_BlitProcessor::blit_src_unpacked<SL_BlitHalfLoader<3>>();
+    template void SL_BlitProcessor::blit_src_unpacked<SL_BlitHalfLoader<4>>();
+    template void SL_BlitProcessor::blit_src_unpacked<SL_BlitPackedLoader<SL_PackedColorRGB565>>();
+    template void SL_BlitProcessor::blit_src_unpacked<SL_BlitPackedLoader<SL_PackedColorRGB10A2>>();
+    template void SL_BlitProcessor::blit_src_unpacked<SL_BlitPackedLoader<SL_PackedColorR11G11B10F>>();
+    template void SL_BlitProcessor::blit_src_tonemapped<SL_BlitHalfLoader<3>>();
+    template void SL_BlitProcessor::blit_src_tonemapped<SL_BlitHalfLoader<4>>();
+    template void SL_BlitProcessor::blit_src_tonemapped<SL_BlitFloatLoader<3>>();
+    template void SL_BlitProcessor::blit_src_tonemapped<SL_BlitFloatLoader<4>>();
+    template void SL_BlitProcessor::blit_src_tonemapped<SL_BlitPackedLoader<SL_PackedColorR11G11B10F>>();
 #endif
 
 
 
+/*-------------------------------------
+ * Check if a blit is supported
+-------------------------------------*/
+bool SL_BlitProcessor::is_blittable(SL_ColorDataType inType, SL_ColorDataType outType) noexcept
+{
+    switch (inType)
+    {
+        case SL_COLOR_BC1_RGBA:
+        case SL_COLOR_BC3_RGBA:
+        case SL_COLOR_BC4_R:
+        case SL_COLOR_BC5_RG:
+        case SL_COLOR_INVALID:
+            return false;
+
+        default:
+            break;
+    }
+
+    switch (outType)
+    {
+        case SL_COLOR_R_8U:
+        case SL_COLOR_R_16U:
+        case SL_COLOR_R_32U:
+        case SL_COLOR_R_64U:
+        case SL_COLOR_R_FLOAT:
+        case SL_COLOR_R_DOUBLE:
+
+        case SL_COLOR_RG_8U:
+        case SL_COLOR_RG_16U:
+        case SL_COLOR_RG_32U:
+        case SL_COLOR_RG_64U:
+        case SL_COLOR_RG_FLOAT:
+        case SL_COLOR_RG_DOUBLE:
+
+        case SL_COLOR_RGB_8U:
+        case SL_COLOR_RGB_16U:
+        case SL_COLOR_RGB_32U:
+        case SL_COLOR_RGB_64U:
+        case SL_COLOR_RGB_FLOAT:
+        case SL_COLOR_RGB_DOUBLE:
+
+        case SL_COLOR_RGBA_8U:
+        case SL_COLOR_RGBA_16U:
+        case SL_COLOR_RGBA_32U:
+        case SL_COLOR_RGBA_64U:
+        case SL_COLOR_RGBA_FLOAT:
+        case SL_COLOR_RGBA_DOUBLE:
+            return true;
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+
+
 /*-------------------------------------
  * Run the texture blitter
 -------------------------------------*/
 void SL_BlitProcessor::execute() noexcept
 {
+    SL_PROFILE_SCOPE(SL_PROFILE_BLIT, mThreadId);
+
+    // HDR textures are tone mapped in the same pass as format conversion.
+    // Other formats ignore the tone mapping parameters.
+    if (mToneMap)
+    {
+        switch (mTexture->type())
+        {
+            case SL_COLOR_RGB_HALF:        blit_src_tonemapped<SL_BlitHalfLoader<3>>();  return;
+            case SL_COLOR_RGBA_HALF:       blit_src_tonemapped<SL_BlitHalfLoader<4>>();  return;
+            case SL_COLOR_RGB_FLOAT:       blit_src_tonemapped<SL_BlitFloatLoader<3>>(); return;
+            case SL_COLOR_RGBA_FLOAT:      blit_src_tonemapped<SL_BlitFloatLoader<4>>(); return;
+            case SL_COLOR_R11G11B10_FLOAT: blit_src_tonemapped<SL_BlitPackedLoader<SL_PackedColorR11G11B10F>>(); return;
+
+            default:
+                break;
+        }
+    }
+
     switch (mTexture->type())
     {
         case SL_COLOR_R_8U:       blit_src_r<uint8_t>();     break;
         case SL_COLOR_R_16U:      blit_src_r<uint16_t>();    break;
         case SL_COLOR_R_32U:      blit_src_r<uint32_t>();    break;
         case SL_COLOR_R_64U:      blit_src_r<uint64_t>();    break;
+        case SL_COLOR_R_HALF:     blit_src_unpacked<SL_BlitHalfLoader<1>>(); break;
         case SL_COLOR_R_FLOAT:    blit_src_r<float>();       break;
         case SL_COLOR_R_DOUBLE:   blit_src_r<double>();      break;
 
@@ -63,6 +154,7 @@ void SL_BlitProcessor::execute() noexcept
         case SL_COLOR_RG_16U:     blit_src_rg<uint16_t>();   break;
         case SL_COLOR_RG_32U:     blit_src_rg<uint32_t>();   break;
         case SL_COLOR_RG_64U:     blit_src_rg<uint64_t>();   break;
+        case SL_COLOR_RG_HALF:    blit_src_unpacked<SL_BlitHalfLoader<2>>(); break;
         case SL_COLOR_RG_FLOAT:   blit_src_rg<float>();      break;
         case SL_COLOR_RG_DOUBLE:  blit_src_rg<double>();     break;
 
@@ -70,6 +162,7 @@ void SL_BlitProcessor::execute() noexcept
         case SL_COLOR_RGB_16U:    blit_src_rgb<uint16_t>();  break;
         case SL_COLOR_RGB_32U:    blit_src_rgb<uint32_t>();  break;
         case SL_COLOR_RGB_64U:    blit_src_rgb<uint64_t>();  break;
+        case SL_COLOR_RGB_HALF:   blit_src_unpacked<SL_BlitHalfLoader<3>>(); break;
         case SL_COLOR_RGB_FLOAT:  blit_src_rgb<float>();     break;
         case SL_COLOR_RGB_DOUBLE: blit_src_rgb<double>();    break;
 
@@ -77,7 +170,20 @@ void SL_BlitProcessor::execute() noexcept
         case SL_COLOR_RGBA_16U:    blit_src_rgba<uint16_t>(); break;
         case SL_COLOR_RGBA_32U:    blit_src_rgba<uint32_t>(); break;
         case SL_COLOR_RGBA_64U:    blit_src_rgba<uint64_t>(); break;
+        case SL_COLOR_RGBA_HALF:   blit_src_unpacked<SL_BlitHalfLoader<4>>(); break;
         case SL_COLOR_RGBA_FLOAT:  blit_src_rgba<float>();    break;
         case SL_COLOR_RGBA_DOUBLE: blit_src_rgba<double>();   break;
+
+        case SL_COLOR_RGB_565:         blit_src_unpacked<SL_BlitPackedLoader<SL_PackedColorRGB565>>();     break;
+        case SL_COLOR_RGB10_A2:        blit_src_unpacked<SL_BlitPackedLoader<SL_PackedColorRGB10A2>>();    break;
+        case SL_COLOR_R11G11B10_FLOAT: blit_src_unpacked<SL_BlitPackedLoader<SL_PackedColorR11G11B10F>>(); break;
+
+        // Window buffers are already in sRGB space, so encoded texels are
+        // copied without conversion
+        case SL_COLOR_SRGB_8U:         blit_src_rgb<uint8_t>();  break;
+        case SL_COLOR_SRGBA_8U:        blit_src_rgba<uint8_t>(); break;
+
+        default:
+            break;
     }
 }
@@ -86,6 +86,28 @@ bool sl_is_visible(const SL_BoundingBox& bb, const ls::math::mat4& mvpMatrix, co
 
 
 
+/*-------------------------------------
+ * Extract the side planes of a sub-frustum
+-------------------------------------*/
+void sl_extract_subfrustum_planes(const ls::math::mat4& projection, const ls::math::vec4& ndcRect, ls::math::vec4 planes[4]) noexcept
+{
+    // Same as sl_extract_frustum_planes(), but with the unit-cube boundaries
+    // replaced with the sub-region's NDC coordinates.
+    for (unsigned i = 4; i--;) planes[SL_FRUSTUM_PLANE_LEFT][i]   = projection[i][0] - ndcRect[0] * projection[i][3];
+    for (unsigned i = 4; i--;) planes[SL_FRUSTUM_PLANE_RIGHT][i]  = ndcRect[2] * projection[i][3] - projection[i][0];
+
+    for (unsigned i = 4; i--;) planes[SL_FRUSTUM_PLANE_BOTTOM][i] = projection[i][1] - ndcRect[1] * projection[i][3];
+    for (unsigned i = 4; i--;) planes[SL_FRUSTUM_PLANE_TOP][i]    = ndcRect[3] * projection[i][3] - projection[i][1];
+
+    for (unsigned i = 4; i--;)
+    {
+        const float lenInv = math::rcp(math::length(math::vec3_cast(planes[i])));
+        planes[i] = planes[i] * lenInv;
+    }
+}
+
+
+
 /*-------------------------------------
  * Test the visibility of a point
 -------------------------------------*/
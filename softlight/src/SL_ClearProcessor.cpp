@@ -4,6 +4,8 @@
 
 #include "softlight/SL_Texture.hpp"
 #include "softlight/SL_ClearProcesor.hpp"
+#include "softlight/SL_DamageRegion.hpp"
+#include "softlight/SL_Profiler.hpp"
 #include "softlight/SL_ShaderUtil.hpp"
 
 
@@ -124,12 +126,14 @@ template void SL_ClearProcessor::clear_texture<SL_ColorRType<uint8_t>>(const SL_
 template void SL_ClearProcessor::clear_texture<SL_ColorRType<uint16_t>>(const SL_ColorRType<uint16_t>&) noexcept;
 template void SL_ClearProcessor::clear_texture<SL_ColorRType<uint32_t>>(const SL_ColorRType<uint32_t>&) noexcept;
 template void SL_ClearProcessor::clear_texture<SL_ColorRType<uint64_t>>(const SL_ColorRType<uint64_t>&) noexcept;
+template void SL_ClearProcessor::clear_texture<SL_ColorRType<ls::math::half>>(const SL_ColorRType<ls::math::half>&) noexcept;
 template void SL_ClearProcessor::clear_texture<SL_ColorRType<double>>(const SL_ColorRType<double>&) noexcept;
 
 template void SL_ClearProcessor::clear_texture<SL_ColorRGType<uint8_t>>(const SL_ColorRGType<uint8_t>&) noexcept;
 template void SL_ClearProcessor::clear_texture<SL_ColorRGType<uint16_t>>(const SL_ColorRGType<uint16_t>&) noexcept;
 template void SL_ClearProcessor::clear_texture<SL_ColorRGType<uint32_t>>(const SL_ColorRGType<uint32_t>&) noexcept;
 template void SL_ClearProcessor::clear_texture<SL_ColorRGType<uint64_t>>(const SL_ColorRGType<uint64_t>&) noexcept;
+template void SL_ClearProcessor::clear_texture<SL_ColorRGType<ls::math::half>>(const SL_ColorRGType<ls::math::half>&) noexcept;
 template void SL_ClearProcessor::clear_texture<SL_ColorRGType<float>>(const SL_ColorRGType<float>&) noexcept;
 template void SL_ClearProcessor::clear_texture<SL_ColorRGType<double>>(const SL_ColorRGType<double>&) noexcept;
 
@@ -137,11 +141,13 @@ template void SL_ClearProcessor::clear_texture<SL_ColorRGBType<uint8_t>>(const S
 template void SL_ClearProcessor::clear_texture<SL_ColorRGBType<uint16_t>>(const SL_ColorRGBType<uint16_t>&) noexcept;
 template void SL_ClearProcessor::clear_texture<SL_ColorRGBType<uint32_t>>(const SL_ColorRGBType<uint32_t>&) noexcept;
 template void SL_ClearProcessor::clear_texture<SL_ColorRGBType<uint64_t>>(const SL_ColorRGBType<uint64_t>&) noexcept;
+template void SL_ClearProcessor::clear_texture<SL_ColorRGBType<ls::math::half>>(const SL_ColorRGBType<ls::math::half>&) noexcept;
 template void SL_ClearProcessor::clear_texture<SL_ColorRGBType<float>>(const SL_ColorRGBType<float>&) noexcept;
 template void SL_ClearProcessor::clear_texture<SL_ColorRGBType<double>>(const SL_ColorRGBType<double>&) noexcept;
 
 template void SL_ClearProcessor::clear_texture<SL_ColorRGBAType<uint16_t>>(const SL_ColorRGBAType<uint16_t>&) noexcept;
 template void SL_ClearProcessor::clear_texture<SL_ColorRGBAType<uint64_t>>(const SL_ColorRGBAType<uint64_t>&) noexcept;
+template void SL_ClearProcessor::clear_texture<SL_ColorRGBAType<ls::math::half>>(const SL_ColorRGBAType<ls::math::half>&) noexcept;
 template void SL_ClearProcessor::clear_texture<SL_ColorRGBAType<double>>(const SL_ColorRGBAType<double>&) noexcept;
 
 #if !defined(LS_ARCH_X86)
@@ -153,39 +159,129 @@ template void SL_ClearProcessor::clear_texture<SL_ColorRGBAType<double>>(const S
 #endif
 
 
+
+/*-------------------------------------
+ * Clear the texels within a set of rectangles
+-------------------------------------*/
+template<class color_type>
+void SL_ClearProcessor::clear_region(const color_type& inColor) noexcept
+{
+    const int32_t  w        = (int32_t)mBackBuffer->width();
+    const int32_t  h        = (int32_t)mBackBuffer->height();
+    const bool     ordered  = mBackBuffer->texel_order() == SL_TexelOrder::SL_TEXELS_ORDERED;
+    const unsigned numRects = mRegion->num_rects();
+
+    // Rows are interleaved between threads, counting across all rectangles
+    uint_fast32_t row = 0;
+
+    for (unsigned i = 0; i < numRects; ++i)
+    {
+        const math::vec4_t<int32_t>& r = mRegion->rect(i);
+
+        const int32_t x0 = math::max(r[0], 0);
+        const int32_t y0 = math::max(r[1], 0);
+        const int32_t x1 = math::min(r[0]+r[2], w);
+        const int32_t y1 = math::min(r[1]+r[3], h);
+
+        for (int32_t y = y0; y < y1; ++y, ++row)
+        {
+            if ((row % mNumThreads) != mThreadId)
+            {
+                continue;
+            }
+
+            if (ordered)
+            {
+                color_type* pOutBuf = mBackBuffer->native_texel_pointer<color_type>((uint16_t)x0, (uint16_t)y);
+                const color_type* pEnd = pOutBuf + (x1 - x0);
+
+                while (LS_LIKELY(pOutBuf < pEnd))
+                {
+                    *pOutBuf++ = inColor;
+                }
+            }
+            else
+            {
+                for (int32_t x = x0; x < x1; ++x)
+                {
+                    *mBackBuffer->native_texel_pointer<color_type>((uint16_t)x, (uint16_t)y) = inColor;
+                }
+            }
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Clear either an entire texture or a region
+-------------------------------------*/
+template<class color_type>
+inline void SL_ClearProcessor::clear(const color_type& inColor) noexcept
+{
+    if (mRegion)
+    {
+        clear_region<color_type>(inColor);
+    }
+    else
+    {
+        clear_texture<color_type>(inColor);
+    }
+}
+
+
+
 /*-------------------------------------
  * Run the texture clearer
 -------------------------------------*/
 void SL_ClearProcessor::execute() noexcept
 {
+    SL_PROFILE_SCOPE(SL_PROFILE_CLEAR, mThreadId);
+
     switch (mBackBuffer->type())
     {
-        case SL_COLOR_R_8U:       clear_texture<SL_ColorRType<uint8_t>>(*reinterpret_cast<const SL_ColorRType<uint8_t>*>(mTexture));     break;
-        case SL_COLOR_R_16U:      clear_texture<SL_ColorRType<uint16_t>>(*reinterpret_cast<const SL_ColorRType<uint16_t>*>(mTexture));    break;
-        case SL_COLOR_R_32U:      clear_texture<SL_ColorRType<uint32_t>>(*reinterpret_cast<const SL_ColorRType<uint32_t>*>(mTexture));    break;
-        case SL_COLOR_R_64U:      clear_texture<SL_ColorRType<uint64_t>>(*reinterpret_cast<const SL_ColorRType<uint64_t>*>(mTexture));    break;
-        case SL_COLOR_R_FLOAT:    clear_texture<SL_ColorRType<float>>(*reinterpret_cast<const SL_ColorRType<float>*>(mTexture));       break;
-        case SL_COLOR_R_DOUBLE:   clear_texture<SL_ColorRType<double>>(*reinterpret_cast<const SL_ColorRType<double>*>(mTexture));      break;
-
-        case SL_COLOR_RG_8U:      clear_texture<SL_ColorRGType<uint8_t>>(*reinterpret_cast<const SL_ColorRGType<uint8_t>*>(mTexture));    break;
-        case SL_COLOR_RG_16U:     clear_texture<SL_ColorRGType<uint16_t>>(*reinterpret_cast<const SL_ColorRGType<uint16_t>*>(mTexture));   break;
-        case SL_COLOR_RG_32U:     clear_texture<SL_ColorRGType<uint32_t>>(*reinterpret_cast<const SL_ColorRGType<uint32_t>*>(mTexture));   break;
-        case SL_COLOR_RG_64U:     clear_texture<SL_ColorRGType<uint64_t>>(*reinterpret_cast<const SL_ColorRGType<uint64_t>*>(mTexture));   break;
-        case SL_COLOR_RG_FLOAT:   clear_texture<SL_ColorRGType<float>>(*reinterpret_cast<const SL_ColorRGType<float>*>(mTexture));      break;
-        case SL_COLOR_RG_DOUBLE:  clear_texture<SL_ColorRGType<double>>(*reinterpret_cast<const SL_ColorRGType<double>*>(mTexture));     break;
-
-        case SL_COLOR_RGB_8U:     clear_texture<SL_ColorRGBType<uint8_t>>(*reinterpret_cast<const SL_ColorRGBType<uint8_t>*>(mTexture));   break;
-        case SL_COLOR_RGB_16U:    clear_texture<SL_ColorRGBType<uint16_t>>(*reinterpret_cast<const SL_ColorRGBType<uint16_t>*>(mTexture));  break;
-        case SL_COLOR_RGB_32U:    clear_texture<SL_ColorRGBType<uint32_t>>(*reinterpret_cast<const SL_ColorRGBType<uint32_t>*>(mTexture));  break;
-        case SL_COLOR_RGB_64U:    clear_texture<SL_ColorRGBType<uint64_t>>(*reinterpret_cast<const SL_ColorRGBType<uint64_t>*>(mTexture));  break;
-        case SL_COLOR_RGB_FLOAT:  clear_texture<SL_ColorRGBType<float>>(*reinterpret_cast<const SL_ColorRGBType<float>*>(mTexture));     break;
-        case SL_COLOR_RGB_DOUBLE: clear_texture<SL_ColorRGBType<double>>(*reinterpret_cast<const SL_ColorRGBType<double>*>(mTexture));    break;
-
-        case SL_COLOR_RGBA_8U:     clear_texture<SL_ColorRGBAType<uint8_t>>(*reinterpret_cast<const SL_ColorRGBAType<uint8_t>*>(mTexture));  break;
-        case SL_COLOR_RGBA_16U:    clear_texture<SL_ColorRGBAType<uint16_t>>(*reinterpret_cast<const SL_ColorRGBAType<uint16_t>*>(mTexture)); break;
-        case SL_COLOR_RGBA_32U:    clear_texture<SL_ColorRGBAType<uint32_t>>(*reinterpret_cast<const SL_ColorRGBAType<uint32_t>*>(mTexture)); break;
-        case SL_COLOR_RGBA_64U:    clear_texture<SL_ColorRGBAType<uint64_t>>(*reinterpret_cast<const SL_ColorRGBAType<uint64_t>*>(mTexture)); break;
-        case SL_COLOR_RGBA_FLOAT:  clear_texture<SL_ColorRGBAType<float>>(*reinterpret_cast<const SL_ColorRGBAType<float>*>(mTexture));    break;
-        case SL_COLOR_RGBA_DOUBLE: clear_texture<SL_ColorRGBAType<double>>(*reinterpret_cast<const SL_ColorRGBAType<double>*>(mTexture));   break;
+        case SL_COLOR_R_8U:       clear<SL_ColorRType<uint8_t>>(*reinterpret_cast<const SL_ColorRType<uint8_t>*>(mTexture));     break;
+        case SL_COLOR_R_16U:      clear<SL_ColorRType<uint16_t>>(*reinterpret_cast<const SL_ColorRType<uint16_t>*>(mTexture));    break;
+        case SL_COLOR_R_32U:      clear<SL_ColorRType<uint32_t>>(*reinterpret_cast<const SL_ColorRType<uint32_t>*>(mTexture));    break;
+        case SL_COLOR_R_64U:      clear<SL_ColorRType<uint64_t>>(*reinterpret_cast<const SL_ColorRType<uint64_t>*>(mTexture));    break;
+        case SL_COLOR_R_HALF:     clear<SL_ColorRType<ls::math::half>>(*reinterpret_cast<const SL_ColorRType<ls::math::half>*>(mTexture)); break;
+        case SL_COLOR_R_FLOAT:    clear<SL_ColorRType<float>>(*reinterpret_cast<const SL_ColorRType<float>*>(mTexture));       break;
+        case SL_COLOR_R_DOUBLE:   clear<SL_ColorRType<double>>(*reinterpret_cast<const SL_ColorRType<double>*>(mTexture));      break;
+
+        case SL_COLOR_RG_8U:      clear<SL_ColorRGType<uint8_t>>(*reinterpret_cast<const SL_ColorRGType<uint8_t>*>(mTexture));    break;
+        case SL_COLOR_RG_16U:     clear<SL_ColorRGType<uint16_t>>(*reinterpret_cast<const SL_ColorRGType<uint16_t>*>(mTexture));   break;
+        case SL_COLOR_RG_32U:     clear<SL_ColorRGType<uint32_t>>(*reinterpret_cast<const SL_ColorRGType<uint32_t>*>(mTexture));   break;
+        case SL_COLOR_RG_64U:     clear<SL_ColorRGType<uint64_t>>(*reinterpret_cast<const SL_ColorRGType<uint64_t>*>(mTexture));   break;
+        case SL_COLOR_RG_HALF:    clear<SL_ColorRGType<ls::math::half>>(*reinterpret_cast<const SL_ColorRGType<ls::math::half>*>(mTexture)); break;
+        case SL_COLOR_RG_FLOAT:   clear<SL_ColorRGType<float>>(*reinterpret_cast<const SL_ColorRGType<float>*>(mTexture));      break;
+        case SL_COLOR_RG_DOUBLE:  clear<SL_ColorRGType<double>>(*reinterpret_cast<const SL_ColorRGType<double>*>(mTexture));     break;
+
+        case SL_COLOR_RGB_8U:     clear<SL_ColorRGBType<uint8_t>>(*reinterpret_cast<const SL_ColorRGBType<uint8_t>*>(mTexture));   break;
+        case SL_COLOR_RGB_16U:    clear<SL_ColorRGBType<uint16_t>>(*reinterpret_cast<const SL_ColorRGBType<uint16_t>*>(mTexture));  break;
+        case SL_COLOR_RGB_32U:    clear<SL_ColorRGBType<uint32_t>>(*reinterpret_cast<const SL_ColorRGBType<uint32_t>*>(mTexture));  break;
+        case SL_COLOR_RGB_64U:    clear<SL_ColorRGBType<uint64_t>>(*reinterpret_cast<const SL_ColorRGBType<uint64_t>*>(mTexture));  break;
+        case SL_COLOR_RGB_HALF:   clear<SL_ColorRGBType<ls::math::half>>(*reinterpret_cast<const SL_ColorRGBType<ls::math::half>*>(mTexture)); break;
+        case SL_COLOR_RGB_FLOAT:  clear<SL_ColorRGBType<float>>(*reinterpret_cast<const SL_ColorRGBType<float>*>(mTexture));     break;
+        case SL_COLOR_RGB_DOUBLE: clear<SL_ColorRGBType<double>>(*reinterpret_cast<const SL_ColorRGBType<double>*>(mTexture));    break;
+
+        case SL_COLOR_RGBA_8U:     clear<SL_ColorRGBAType<uint8_t>>(*reinterpret_cast<const SL_ColorRGBAType<uint8_t>*>(mTexture));  break;
+        case SL_COLOR_RGBA_16U:    clear<SL_ColorRGBAType<uint16_t>>(*reinterpret_cast<const SL_ColorRGBAType<uint16_t>*>(mTexture)); break;
+        case SL_COLOR_RGBA_32U:    clear<SL_ColorRGBAType<uint32_t>>(*reinterpret_cast<const SL_ColorRGBAType<uint32_t>*>(mTexture)); break;
+        case SL_COLOR_RGBA_64U:    clear<SL_ColorRGBAType<uint64_t>>(*reinterpret_cast<const SL_ColorRGBAType<uint64_t>*>(mTexture)); break;
+        case SL_COLOR_RGBA_HALF:   clear<SL_ColorRGBAType<ls::math::half>>(*reinterpret_cast<const SL_ColorRGBAType<ls::math::half>*>(mTexture)); break;
+        case SL_COLOR_RGBA_FLOAT:  clear<SL_ColorRGBAType<float>>(*reinterpret_cast<const SL_ColorRGBAType<float>*>(mTexture));    break;
+        case SL_COLOR_RGBA_DOUBLE: clear<SL_ColorRGBAType<double>>(*reinterpret_cast<const SL_ColorRGBAType<double>*>(mTexture));   break;
+
+        // Packed colors are cleared as single integers
+        case SL_COLOR_RGB_565:         clear<SL_ColorRType<uint16_t>>(*reinterpret_cast<const SL_ColorRType<uint16_t>*>(mTexture)); break;
+        case SL_COLOR_RGB10_A2:        clear<SL_ColorRType<uint32_t>>(*reinterpret_cast<const SL_ColorRType<uint32_t>*>(mTexture)); break;
+        case SL_COLOR_R11G11B10_FLOAT: clear<SL_ColorRType<uint32_t>>(*reinterpret_cast<const SL_ColorRType<uint32_t>*>(mTexture)); break;
+
+        // sRGB clear colors are encoded before reaching the processor
+        case SL_COLOR_SRGB_8U:         clear<SL_ColorRGBType<uint8_t>>(*reinterpret_cast<const SL_ColorRGBType<uint8_t>*>(mTexture));   break;
+        case SL_COLOR_SRGBA_8U:        clear<SL_ColorRGBAType<uint8_t>>(*reinterpret_cast<const SL_ColorRGBAType<uint8_t>*>(mTexture)); break;
+
+        default:
+            break;
     }
 }
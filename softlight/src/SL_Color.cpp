@@ -1,5 +1,7 @@
 
 #include "softlight/SL_Color.hpp"
+#include "softlight/SL_ColorSRGB.hpp"
+#include "softlight/SL_PackedColor.hpp"
 
 
 
@@ -14,6 +16,7 @@ size_t sl_bytes_per_color(SL_ColorDataType p)
         case SL_COLOR_R_16U:       return 1 * sizeof(uint16_t);
         case SL_COLOR_R_32U:       return 1 * sizeof(uint32_t);
         case SL_COLOR_R_64U:       return 1 * sizeof(uint64_t);
+        case SL_COLOR_R_HALF:      return 1 * sizeof(ls::math::half);
         case SL_COLOR_R_FLOAT:     return 1 * sizeof(float);
         case SL_COLOR_R_DOUBLE:    return 1 * sizeof(double);
 
@@ -21,6 +24,7 @@ size_t sl_bytes_per_color(SL_ColorDataType p)
         case SL_COLOR_RG_16U:      return 2 * sizeof(uint16_t);
         case SL_COLOR_RG_32U:      return 2 * sizeof(uint32_t);
         case SL_COLOR_RG_64U:      return 2 * sizeof(uint64_t);
+        case SL_COLOR_RG_HALF:     return 2 * sizeof(ls::math::half);
         case SL_COLOR_RG_FLOAT:    return 2 * sizeof(float);
         case SL_COLOR_RG_DOUBLE:   return 2 * sizeof(double);
 
@@ -28,6 +32,7 @@ size_t sl_bytes_per_color(SL_ColorDataType p)
         case SL_COLOR_RGB_16U:     return 3 * sizeof(uint16_t);
         case SL_COLOR_RGB_32U:     return 3 * sizeof(uint32_t);
         case SL_COLOR_RGB_64U:     return 3 * sizeof(uint64_t);
+        case SL_COLOR_RGB_HALF:    return 3 * sizeof(ls::math::half);
         case SL_COLOR_RGB_FLOAT:   return 3 * sizeof(float);
         case SL_COLOR_RGB_DOUBLE:  return 3 * sizeof(double);
 
@@ -35,9 +40,22 @@ size_t sl_bytes_per_color(SL_ColorDataType p)
         case SL_COLOR_RGBA_16U:    return 4 * sizeof(uint16_t);
         case SL_COLOR_RGBA_32U:    return 4 * sizeof(uint32_t);
         case SL_COLOR_RGBA_64U:    return 4 * sizeof(uint64_t);
+        case SL_COLOR_RGBA_HALF:   return 4 * sizeof(ls::math::half);
         case SL_COLOR_RGBA_FLOAT:  return 4 * sizeof(float);
         case SL_COLOR_RGBA_DOUBLE: return 4 * sizeof(double);
 
+        case SL_COLOR_BC1_RGBA:    return 8;
+        case SL_COLOR_BC3_RGBA:    return 16;
+        case SL_COLOR_BC4_R:       return 8;
+        case SL_COLOR_BC5_RG:      return 16;
+
+        case SL_COLOR_RGB_565:          return sizeof(SL_PackedColorRGB565::packed_type);
+        case SL_COLOR_RGB10_A2:         return sizeof(SL_PackedColorRGB10A2::packed_type);
+        case SL_COLOR_R11G11B10_FLOAT:  return sizeof(SL_PackedColorR11G11B10F::packed_type);
+
+        case SL_COLOR_SRGB_8U:     return 3 * sizeof(uint8_t);
+        case SL_COLOR_SRGBA_8U:    return 4 * sizeof(uint8_t);
+
         default:
             break;
     }
@@ -47,6 +65,59 @@ size_t sl_bytes_per_color(SL_ColorDataType p)
 
 
 
+/*-------------------------------------
+ * Check if a color type is block-compressed
+-------------------------------------*/
+bool sl_is_compressed_color(SL_ColorDataType p)
+{
+    switch (p)
+    {
+        case SL_COLOR_BC1_RGBA:
+        case SL_COLOR_BC3_RGBA:
+        case SL_COLOR_BC4_R:
+        case SL_COLOR_BC5_RG:
+            return true;
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+
+
+/*-------------------------------------
+ * Check if a color type is packed into a single integer
+-------------------------------------*/
+bool sl_is_packed_color(SL_ColorDataType p)
+{
+    switch (p)
+    {
+        case SL_COLOR_RGB_565:
+        case SL_COLOR_RGB10_A2:
+        case SL_COLOR_R11G11B10_FLOAT:
+            return true;
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+
+
+/*-------------------------------------
+ * Check if a color type is stored in sRGB space
+-------------------------------------*/
+bool sl_is_srgb_color(SL_ColorDataType p)
+{
+    return p == SL_COLOR_SRGB_8U || p == SL_COLOR_SRGBA_8U;
+}
+
+
+
 /*-------------------------------------
  * Get the number of elements per pixel
 -------------------------------------*/
@@ -58,6 +129,7 @@ unsigned sl_elements_per_color(SL_ColorDataType p)
         case SL_COLOR_R_16U:       return 1;
         case SL_COLOR_R_32U:       return 1;
         case SL_COLOR_R_64U:       return 1;
+        case SL_COLOR_R_HALF:      return 1;
         case SL_COLOR_R_FLOAT:     return 1;
         case SL_COLOR_R_DOUBLE:    return 1;
 
@@ -65,6 +137,7 @@ unsigned sl_elements_per_color(SL_ColorDataType p)
         case SL_COLOR_RG_16U:      return 2;
         case SL_COLOR_RG_32U:      return 2;
         case SL_COLOR_RG_64U:      return 2;
+        case SL_COLOR_RG_HALF:     return 2;
         case SL_COLOR_RG_FLOAT:    return 2;
         case SL_COLOR_RG_DOUBLE:   return 2;
 
@@ -72,6 +145,7 @@ unsigned sl_elements_per_color(SL_ColorDataType p)
         case SL_COLOR_RGB_16U:     return 3;
         case SL_COLOR_RGB_32U:     return 3;
         case SL_COLOR_RGB_64U:     return 3;
+        case SL_COLOR_RGB_HALF:    return 3;
         case SL_COLOR_RGB_FLOAT:   return 3;
         case SL_COLOR_RGB_DOUBLE:  return 3;
 
@@ -79,9 +153,22 @@ unsigned sl_elements_per_color(SL_ColorDataType p)
         case SL_COLOR_RGBA_16U:    return 4;
         case SL_COLOR_RGBA_32U:    return 4;
         case SL_COLOR_RGBA_64U:    return 4;
+        case SL_COLOR_RGBA_HALF:   return 4;
         case SL_COLOR_RGBA_FLOAT:  return 4;
         case SL_COLOR_RGBA_DOUBLE: return 4;
 
+        case SL_COLOR_BC1_RGBA:    return 4;
+        case SL_COLOR_BC3_RGBA:    return 4;
+        case SL_COLOR_BC4_R:       return 1;
+        case SL_COLOR_BC5_RG:      return 2;
+
+        case SL_COLOR_RGB_565:          return SL_PackedColorRGB565::num_components();
+        case SL_COLOR_RGB10_A2:         return SL_PackedColorRGB10A2::num_components();
+        case SL_COLOR_R11G11B10_FLOAT:  return SL_PackedColorR11G11B10F::num_components();
+
+        case SL_COLOR_SRGB_8U:     return 3;
+        case SL_COLOR_SRGBA_8U:    return 4;
+
         default:
             break;
     }
@@ -138,6 +225,11 @@ SL_GeneralColor sl_match_color_for_type(SL_ColorDataType typeToMatch, const colo
         case SL_COLOR_RGB_64U:     outColor.type = SL_COLOR_RGB_64U; outColor.color.rgb64 = color_cast<uint64_t, double>(*reinterpret_cast<const SL_ColorRGBd*>(temp4.v)); break;
         case SL_COLOR_RGBA_64U:    outColor.type = SL_COLOR_RGBA_64U; outColor.color.rgba64 = color_cast<uint64_t, double>(*reinterpret_cast<const SL_ColorRGBAd*>(temp4.v)); break;
 
+        case SL_COLOR_R_HALF:      outColor.type = SL_COLOR_R_HALF; sl_store_half_color<1>(&outColor.color.rh.r, (ls::math::vec4)temp4); break;
+        case SL_COLOR_RG_HALF:     outColor.type = SL_COLOR_RG_HALF; sl_store_half_color<2>(outColor.color.rgh.v, (ls::math::vec4)temp4); break;
+        case SL_COLOR_RGB_HALF:    outColor.type = SL_COLOR_RGB_HALF; sl_store_half_color<3>(outColor.color.rgbh.v, (ls::math::vec4)temp4); break;
+        case SL_COLOR_RGBA_HALF:   outColor.type = SL_COLOR_RGBA_HALF; sl_store_half_color<4>(outColor.color.rgbah.v, (ls::math::vec4)temp4); break;
+
         case SL_COLOR_R_FLOAT:     outColor.type = SL_COLOR_R_FLOAT; outColor.color.rf = color_cast<float, double>(*reinterpret_cast<const SL_ColorRd*>(temp4.v)); break;
         case SL_COLOR_RG_FLOAT:    outColor.type = SL_COLOR_RG_FLOAT; outColor.color.rgf = color_cast<float, double>(*reinterpret_cast<const SL_ColorRGd*>(temp4.v)); break;
         case SL_COLOR_RGB_FLOAT:   outColor.type = SL_COLOR_RGB_FLOAT; outColor.color.rgbf = color_cast<float, double>(*reinterpret_cast<const SL_ColorRGBd*>(temp4.v)); break;
@@ -148,6 +240,13 @@ SL_GeneralColor sl_match_color_for_type(SL_ColorDataType typeToMatch, const colo
         case SL_COLOR_RGB_DOUBLE:   outColor.type = SL_COLOR_RGB_DOUBLE; outColor.color.rgbd = *reinterpret_cast<const SL_ColorRGBd*>(temp4.v); break;
         case SL_COLOR_RGBA_DOUBLE:  outColor.type = SL_COLOR_RGBA_DOUBLE; outColor.color.rgbad = *reinterpret_cast<const SL_ColorRGBAd*>(temp4.v); break;
 
+        case SL_COLOR_RGB_565:         outColor.type = SL_COLOR_RGB_565; outColor.color.rgb565 = SL_PackedColorRGB565::pack((ls::math::vec4)temp4); break;
+        case SL_COLOR_RGB10_A2:        outColor.type = SL_COLOR_RGB10_A2; outColor.color.rgb10a2 = SL_PackedColorRGB10A2::pack((ls::math::vec4)temp4); break;
+        case SL_COLOR_R11G11B10_FLOAT: outColor.type = SL_COLOR_R11G11B10_FLOAT; outColor.color.r11g11b10f = SL_PackedColorR11G11B10F::pack((ls::math::vec4)temp4); break;
+
+        case SL_COLOR_SRGB_8U:         outColor.type = SL_COLOR_SRGB_8U; outColor.color.rgb8 = ls::math::vec3_cast(sl_linear_to_srgb((ls::math::vec4)temp4)); break;
+        case SL_COLOR_SRGBA_8U:        outColor.type = SL_COLOR_SRGBA_8U; outColor.color.rgba8 = sl_linear_to_srgb((ls::math::vec4)temp4); break;
+
         default:
             LS_UNREACHABLE();
     }
@@ -183,3 +282,611 @@ template SL_GeneralColor sl_match_color_for_type<ls::math::vec4_t<uint32_t>>(SL_
 template SL_GeneralColor sl_match_color_for_type<ls::math::vec4_t<uint64_t>>(SL_ColorDataType, const ls::math::vec4_t<uint64_t>&) noexcept;
 template SL_GeneralColor sl_match_color_for_type<ls::math::vec4_t<float>>(   SL_ColorDataType, const ls::math::vec4_t<float>&) noexcept;
 template SL_GeneralColor sl_match_color_for_type<ls::math::vec4_t<double>>(  SL_ColorDataType, const ls::math::vec4_t<double>&) noexcept;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Batch Color Conversion
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+
+
+/*-------------------------------------
+ * 4-wide float operations used by the HSV/HSL kernels. The scalar version
+ * processes one color at a time using the same code.
+-------------------------------------*/
+#if defined(LS_X86_SSE4_1)
+struct SL_ColorLanes
+{
+    typedef __m128 value_type;
+
+    enum : unsigned { width = 4 };
+
+    static inline LS_INLINE value_type set(float f) noexcept { return _mm_set1_ps(f); }
+    static inline LS_INLINE value_type load(const float* p) noexcept { return _mm_load_ps(p); }
+    static inline LS_INLINE void store(float* p, value_type a) noexcept { _mm_store_ps(p, a); }
+    static inline LS_INLINE value_type add(value_type a, value_type b) noexcept { return _mm_add_ps(a, b); }
+    static inline LS_INLINE value_type sub(value_type a, value_type b) noexcept { return _mm_sub_ps(a, b); }
+    static inline LS_INLINE value_type mul(value_type a, value_type b) noexcept { return _mm_mul_ps(a, b); }
+    static inline LS_INLINE value_type div(value_type a, value_type b) noexcept { return _mm_div_ps(a, b); }
+    static inline LS_INLINE value_type min(value_type a, value_type b) noexcept { return _mm_min_ps(a, b); }
+    static inline LS_INLINE value_type max(value_type a, value_type b) noexcept { return _mm_max_ps(a, b); }
+    static inline LS_INLINE value_type abs(value_type a) noexcept { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+    static inline LS_INLINE value_type eq(value_type a, value_type b) noexcept { return _mm_cmpeq_ps(a, b); }
+    static inline LS_INLINE value_type ge(value_type a, value_type b) noexcept { return _mm_cmpge_ps(a, b); }
+    static inline LS_INLINE value_type lt(value_type a, value_type b) noexcept { return _mm_cmplt_ps(a, b); }
+    static inline LS_INLINE value_type select(value_type mask, value_type a, value_type b) noexcept { return _mm_blendv_ps(b, a, mask); }
+};
+
+#elif defined(LS_ARM_NEON)
+struct SL_ColorLanes
+{
+    typedef float32x4_t value_type;
+
+    enum : unsigned { width = 4 };
+
+    static inline LS_INLINE value_type set(float f) noexcept { return vdupq_n_f32(f); }
+    static inline LS_INLINE value_type load(const float* p) noexcept { return vld1q_f32(p); }
+    static inline LS_INLINE void store(float* p, value_type a) noexcept { vst1q_f32(p, a); }
+    static inline LS_INLINE value_type add(value_type a, value_type b) noexcept { return vaddq_f32(a, b); }
+    static inline LS_INLINE value_type sub(value_type a, value_type b) noexcept { return vsubq_f32(a, b); }
+    static inline LS_INLINE value_type mul(value_type a, value_type b) noexcept { return vmulq_f32(a, b); }
+    static inline LS_INLINE value_type min(value_type a, value_type b) noexcept { return vminq_f32(a, b); }
+    static inline LS_INLINE value_type max(value_type a, value_type b) noexcept { return vmaxq_f32(a, b); }
+    static inline LS_INLINE value_type abs(value_type a) noexcept { return vabsq_f32(a); }
+    static inline LS_INLINE value_type eq(value_type a, value_type b) noexcept { return vreinterpretq_f32_u32(vceqq_f32(a, b)); }
+    static inline LS_INLINE value_type ge(value_type a, value_type b) noexcept { return vreinterpretq_f32_u32(vcgeq_f32(a, b)); }
+    static inline LS_INLINE value_type lt(value_type a, value_type b) noexcept { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+    static inline LS_INLINE value_type select(value_type mask, value_type a, value_type b) noexcept { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+
+    // Two Newton-Raphson steps are enough for 8-bit colors
+    static inline LS_INLINE value_type div(value_type a, value_type b) noexcept
+    {
+        float32x4_t r = vrecpeq_f32(b);
+        r = vmulq_f32(vrecpsq_f32(b, r), r);
+        r = vmulq_f32(vrecpsq_f32(b, r), r);
+        return vmulq_f32(a, r);
+    }
+};
+
+#else
+struct SL_ColorLanes
+{
+    typedef float value_type;
+
+    enum : unsigned { width = 1 };
+
+    static inline LS_INLINE value_type set(float f) noexcept { return f; }
+    static inline LS_INLINE value_type load(const float* p) noexcept { return *p; }
+    static inline LS_INLINE void store(float* p, value_type a) noexcept { *p = a; }
+    static inline LS_INLINE value_type add(value_type a, value_type b) noexcept { return a + b; }
+    static inline LS_INLINE value_type sub(value_type a, value_type b) noexcept { return a - b; }
+    static inline LS_INLINE value_type mul(value_type a, value_type b) noexcept { return a * b; }
+    static inline LS_INLINE value_type div(value_type a, value_type b) noexcept { return a / b; }
+    static inline LS_INLINE value_type min(value_type a, value_type b) noexcept { return a < b ? a : b; }
+    static inline LS_INLINE value_type max(value_type a, value_type b) noexcept { return a > b ? a : b; }
+    static inline LS_INLINE value_type abs(value_type a) noexcept { return a < 0.f ? -a : a; }
+    static inline LS_INLINE value_type eq(value_type a, value_type b) noexcept { return a == b ? 1.f : 0.f; }
+    static inline LS_INLINE value_type ge(value_type a, value_type b) noexcept { return a >= b ? 1.f : 0.f; }
+    static inline LS_INLINE value_type lt(value_type a, value_type b) noexcept { return a < b ? 1.f : 0.f; }
+    static inline LS_INLINE value_type select(value_type mask, value_type a, value_type b) noexcept { return mask != 0.f ? a : b; }
+};
+
+#endif
+
+
+
+/*-------------------------------------
+ * Hue (in degrees), chroma, and the max/min channels of an RGB color
+-------------------------------------*/
+template <class L>
+inline LS_INLINE typename L::value_type _sl_rgb_hue(
+    typename L::value_type r,
+    typename L::value_type g,
+    typename L::value_type b,
+    typename L::value_type maxVal,
+    typename L::value_type delta) noexcept
+{
+    typedef typename L::value_type lane;
+
+    const lane zero  = L::set(0.f);
+    const lane hueR  = L::div(L::sub(g, b), delta);
+    const lane hueG  = L::add(L::div(L::sub(b, r), delta), L::set(2.f));
+    const lane hueB  = L::add(L::div(L::sub(r, g), delta), L::set(4.f));
+
+    lane h = L::select(L::eq(maxVal, r), hueR, L::select(L::eq(maxVal, g), hueG, hueB));
+    h = L::select(L::lt(h, zero), L::add(h, L::set(6.f)), h);
+    h = L::mul(h, L::set(60.f));
+
+    // Gray colors have no hue (and a NaN from dividing by 0)
+    return L::select(L::eq(delta, zero), zero, h);
+}
+
+
+
+/*-------------------------------------
+ * Wrap a non-negative value which is less than 2*m into the range [0, m)
+-------------------------------------*/
+template <class L>
+inline LS_INLINE typename L::value_type _sl_wrap(typename L::value_type x, typename L::value_type m) noexcept
+{
+    return L::select(L::ge(x, m), L::sub(x, m), x);
+}
+
+
+
+/*-------------------------------------
+ * Convert a group of colors stored as separate channels
+-------------------------------------*/
+template <class L>
+inline LS_INLINE void _sl_rgb_to_hsv_lanes(const float* r, const float* g, const float* b, float* h, float* s, float* v) noexcept
+{
+    typedef typename L::value_type lane;
+
+    const lane red    = L::load(r);
+    const lane green  = L::load(g);
+    const lane blue   = L::load(b);
+    const lane zero   = L::set(0.f);
+    const lane maxVal = L::max(red, L::max(green, blue));
+    const lane minVal = L::min(red, L::min(green, blue));
+    const lane delta  = L::sub(maxVal, minVal);
+
+    L::store(h, _sl_rgb_hue<L>(red, green, blue, maxVal, delta));
+    L::store(s, L::select(L::eq(maxVal, zero), zero, L::div(delta, maxVal)));
+    L::store(v, maxVal);
+}
+
+
+
+template <class L>
+inline LS_INLINE void _sl_rgb_to_hsl_lanes(const float* r, const float* g, const float* b, float* h, float* s, float* l) noexcept
+{
+    typedef typename L::value_type lane;
+
+    const lane red    = L::load(r);
+    const lane green  = L::load(g);
+    const lane blue   = L::load(b);
+    const lane zero   = L::set(0.f);
+    const lane one    = L::set(1.f);
+    const lane maxVal = L::max(red, L::max(green, blue));
+    const lane minVal = L::min(red, L::min(green, blue));
+    const lane delta  = L::sub(maxVal, minVal);
+    const lane light  = L::mul(L::add(maxVal, minVal), L::set(0.5f));
+    const lane denom  = L::sub(one, L::abs(L::sub(L::add(light, light), one)));
+
+    L::store(h, _sl_rgb_hue<L>(red, green, blue, maxVal, delta));
+    L::store(s, L::select(L::eq(delta, zero), zero, L::div(delta, denom)));
+    L::store(l, light);
+}
+
+
+
+/*-------------------------------------
+ * HSV to RGB: f(n) = v - v*s*max(0, min(k, 4-k, 1)), where
+ * k = (n + h/60) mod 6
+-------------------------------------*/
+template <class L>
+inline LS_INLINE typename L::value_type _sl_hsv_channel(typename L::value_type n, typename L::value_type h, typename L::value_type vs, typename L::value_type v) noexcept
+{
+    typedef typename L::value_type lane;
+
+    const lane six = L::set(6.f);
+    const lane k   = _sl_wrap<L>(L::add(n, h), six);
+    const lane f   = L::max(L::set(0.f), L::min(k, L::min(L::sub(L::set(4.f), k), L::set(1.f))));
+
+    return L::sub(v, L::mul(vs, f));
+}
+
+
+
+template <class L>
+inline LS_INLINE void _sl_hsv_to_rgb_lanes(const float* h, const float* s, const float* v, float* r, float* g, float* b) noexcept
+{
+    typedef typename L::value_type lane;
+
+    const lane hue = L::mul(L::load(h), L::set(1.f / 60.f));
+    const lane val = L::load(v);
+    const lane vs  = L::mul(val, L::load(s));
+
+    L::store(r, _sl_hsv_channel<L>(L::set(5.f), hue, vs, val));
+    L::store(g, _sl_hsv_channel<L>(L::set(3.f), hue, vs, val));
+    L::store(b, _sl_hsv_channel<L>(L::set(1.f), hue, vs, val));
+}
+
+
+
+/*-------------------------------------
+ * HSL to RGB: f(n) = l - a*max(-1, min(k-3, 9-k, 1)), where
+ * k = (n + h/30) mod 12 and a = s*min(l, 1-l)
+-------------------------------------*/
+template <class L>
+inline LS_INLINE typename L::value_type _sl_hsl_channel(typename L::value_type n, typename L::value_type h, typename L::value_type a, typename L::value_type l) noexcept
+{
+    typedef typename L::value_type lane;
+
+    const lane k = _sl_wrap<L>(L::add(n, h), L::set(12.f));
+    const lane f = L::max(L::set(-1.f), L::min(L::sub(k, L::set(3.f)), L::min(L::sub(L::set(9.f), k), L::set(1.f))));
+
+    return L::sub(l, L::mul(a, f));
+}
+
+
+
+template <class L>
+inline LS_INLINE void _sl_hsl_to_rgb_lanes(const float* h, const float* s, const float* l, float* r, float* g, float* b) noexcept
+{
+    typedef typename L::value_type lane;
+
+    const lane hue   = L::mul(L::load(h), L::set(1.f / 30.f));
+    const lane light = L::load(l);
+    const lane a     = L::mul(L::load(s), L::min(light, L::sub(L::set(1.f), light)));
+
+    L::store(r, _sl_hsl_channel<L>(L::set(0.f), hue, a, light));
+    L::store(g, _sl_hsl_channel<L>(L::set(8.f), hue, a, light));
+    L::store(b, _sl_hsl_channel<L>(L::set(4.f), hue, a, light));
+}
+
+
+
+/*-------------------------------------
+ * Run a lane kernel over a span of 3-channel colors. Colors are transposed
+ * into separate channels so each lane holds a different color.
+-------------------------------------*/
+template <class L, typename in_type, typename out_type, void (*kernel)(const float*, const float*, const float*, float*, float*, float*)>
+inline void _sl_convert_3_channels(const in_type* pIn, out_type* pOut, size_t count) noexcept
+{
+    alignas(16) float a[L::width];
+    alignas(16) float b[L::width];
+    alignas(16) float c[L::width];
+    alignas(16) float x[L::width];
+    alignas(16) float y[L::width];
+    alignas(16) float z[L::width];
+
+    size_t i = 0;
+
+    for (; i + L::width <= count; i += L::width)
+    {
+        for (unsigned j = 0; j < L::width; ++j)
+        {
+            const float* const pInC = reinterpret_cast<const float*>(pIn + i + j);
+            a[j] = pInC[0];
+            b[j] = pInC[1];
+            c[j] = pInC[2];
+        }
+
+        kernel(a, b, c, x, y, z);
+
+        for (unsigned j = 0; j < L::width; ++j)
+        {
+            float* const pOutC = reinterpret_cast<float*>(pOut + i + j);
+            pOutC[0] = x[j];
+            pOutC[1] = y[j];
+            pOutC[2] = z[j];
+        }
+    }
+
+    // Remaining colors are padded with the last valid one
+    if (i < count)
+    {
+        for (unsigned j = 0; j < L::width; ++j)
+        {
+            const float* const pInC = reinterpret_cast<const float*>(pIn + ls::math::min<size_t>(i + j, count - 1u));
+            a[j] = pInC[0];
+            b[j] = pInC[1];
+            c[j] = pInC[2];
+        }
+
+        kernel(a, b, c, x, y, z);
+
+        for (unsigned j = 0; i + j < count; ++j)
+        {
+            float* const pOutC = reinterpret_cast<float*>(pOut + i + j);
+            pOutC[0] = x[j];
+            pOutC[1] = y[j];
+            pOutC[2] = z[j];
+        }
+    }
+}
+
+
+
+} // end anonymous namespace
+
+
+
+/*-------------------------------------
+ * 8-bit to normalized float
+-------------------------------------*/
+void sl_convert_u8_to_float(const uint8_t* pIn, float* pOut, size_t count) noexcept
+{
+    size_t i = 0;
+
+    #if defined(LS_X86_SSE4_1)
+        const __m128 scale = _mm_set1_ps(1.f / 255.f);
+
+        for (; i + 16u <= count; i += 16u)
+        {
+            const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i));
+            _mm_storeu_ps(pOut + i + 0u,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(in)), scale));
+            _mm_storeu_ps(pOut + i + 4u,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(in, 4))), scale));
+            _mm_storeu_ps(pOut + i + 8u,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(in, 8))), scale));
+            _mm_storeu_ps(pOut + i + 12u, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(in, 12))), scale));
+        }
+
+    #elif defined(LS_ARM_NEON)
+        const float32x4_t scale = vdupq_n_f32(1.f / 255.f);
+
+        for (; i + 16u <= count; i += 16u)
+        {
+            const uint8x16_t in = vld1q_u8(pIn + i);
+            const uint16x8_t lo = vmovl_u8(vget_low_u8(in));
+            const uint16x8_t hi = vmovl_u8(vget_high_u8(in));
+            vst1q_f32(pOut + i + 0u,  vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), scale));
+            vst1q_f32(pOut + i + 4u,  vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), scale));
+            vst1q_f32(pOut + i + 8u,  vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), scale));
+            vst1q_f32(pOut + i + 12u, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), scale));
+        }
+    #endif
+
+    for (; i < count; ++i)
+    {
+        pOut[i] = (float)pIn[i] * (1.f / 255.f);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Normalized float to 8-bit
+-------------------------------------*/
+void sl_convert_float_to_u8(const float* pIn, uint8_t* pOut, size_t count) noexcept
+{
+    size_t i = 0;
+
+    #if defined(LS_X86_SSE4_1)
+        const __m128 zero  = _mm_setzero_ps();
+        const __m128 one   = _mm_set1_ps(1.f);
+        const __m128 scale = _mm_set1_ps(255.f);
+        const __m128 half  = _mm_set1_ps(0.5f);
+
+        for (; i + 16u <= count; i += 16u)
+        {
+            // Round half up by truncation, matching the NEON and scalar loops
+            // rather than _mm_cvtps_epi32()'s round-to-nearest-even.
+            const __m128i a = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(pIn + i + 0u),  zero), one), scale), half));
+            const __m128i b = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(pIn + i + 4u),  zero), one), scale), half));
+            const __m128i c = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(pIn + i + 8u),  zero), one), scale), half));
+            const __m128i d = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(pIn + i + 12u), zero), one), scale), half));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + i), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+        }
+
+    #elif defined(LS_ARM_NEON)
+        const float32x4_t zero  = vdupq_n_f32(0.f);
+        const float32x4_t one   = vdupq_n_f32(1.f);
+        const float32x4_t scale = vdupq_n_f32(255.f);
+        const float32x4_t half  = vdupq_n_f32(0.5f);
+
+        for (; i + 16u <= count; i += 16u)
+        {
+            const uint32x4_t a = vcvtq_u32_f32(vmlaq_f32(half, vminq_f32(vmaxq_f32(vld1q_f32(pIn + i + 0u),  zero), one), scale));
+            const uint32x4_t b = vcvtq_u32_f32(vmlaq_f32(half, vminq_f32(vmaxq_f32(vld1q_f32(pIn + i + 4u),  zero), one), scale));
+            const uint32x4_t c = vcvtq_u32_f32(vmlaq_f32(half, vminq_f32(vmaxq_f32(vld1q_f32(pIn + i + 8u),  zero), one), scale));
+            const uint32x4_t d = vcvtq_u32_f32(vmlaq_f32(half, vminq_f32(vmaxq_f32(vld1q_f32(pIn + i + 12u), zero), one), scale));
+
+            const uint16x8_t ab = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+            const uint16x8_t cd = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+            vst1q_u8(pOut + i, vcombine_u8(vmovn_u16(ab), vmovn_u16(cd)));
+        }
+    #endif
+
+    for (; i < count; ++i)
+    {
+        pOut[i] = (uint8_t)(ls::math::clamp(pIn[i], 0.f, 1.f) * 255.f + 0.5f);
+    }
+}
+
+
+
+/*-------------------------------------
+ * RGB8 to RGBA8
+-------------------------------------*/
+void sl_convert_rgb_to_rgba(const SL_ColorRGB8* pIn, SL_ColorRGBA8* pOut, size_t count, uint8_t alpha) noexcept
+{
+    size_t i = 0;
+
+    #if defined(LS_X86_SSE4_1)
+        const __m128i shuffle = _mm_set_epi8(-1, 11, 10, 9, -1, 8, 7, 6, -1, 5, 4, 3, -1, 2, 1, 0);
+        const __m128i alphas  = _mm_set1_epi32((int32_t)((uint32_t)alpha << 24u));
+
+        // 4 colors are written per iteration but 16 bytes are read
+        for (; i + 6u <= count; i += 4u)
+        {
+            const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + i), _mm_or_si128(_mm_shuffle_epi8(in, shuffle), alphas));
+        }
+
+    #elif defined(LS_ARM_NEON)
+        const uint8x8_t alphas = vdup_n_u8(alpha);
+
+        for (; i + 8u <= count; i += 8u)
+        {
+            const uint8x8x3_t in = vld3_u8(reinterpret_cast<const uint8_t*>(pIn + i));
+            const uint8x8x4_t out = {{in.val[0], in.val[1], in.val[2], alphas}};
+            vst4_u8(reinterpret_cast<uint8_t*>(pOut + i), out);
+        }
+    #endif
+
+    for (; i < count; ++i)
+    {
+        pOut[i] = SL_ColorRGBA8{pIn[i][0], pIn[i][1], pIn[i][2], alpha};
+    }
+}
+
+
+
+/*-------------------------------------
+ * RGBf to RGBAf
+-------------------------------------*/
+void sl_convert_rgb_to_rgba(const SL_ColorRGBf* pIn, SL_ColorRGBAf* pOut, size_t count, float alpha) noexcept
+{
+    size_t i = 0;
+
+    #if defined(LS_X86_SSE4_1)
+        const __m128 alphas = _mm_set1_ps(alpha);
+
+        // 4 colors span 3 registers: [r0 g0 b0 r1], [g1 b1 r2 g2], [b2 r3 g3 b3]
+        for (; i + 4u <= count; i += 4u)
+        {
+            const float* pSrc = reinterpret_cast<const float*>(pIn + i);
+            float* pDst = reinterpret_cast<float*>(pOut + i);
+
+            const __m128i a = _mm_castps_si128(_mm_loadu_ps(pSrc + 0u));
+            const __m128i b = _mm_castps_si128(_mm_loadu_ps(pSrc + 4u));
+            const __m128i c = _mm_castps_si128(_mm_loadu_ps(pSrc + 8u));
+
+            _mm_storeu_ps(pDst + 0u,  _mm_blend_ps(_mm_castsi128_ps(a), alphas, 0x08));
+            _mm_storeu_ps(pDst + 4u,  _mm_blend_ps(_mm_castsi128_ps(_mm_alignr_epi8(b, a, 12)), alphas, 0x08));
+            _mm_storeu_ps(pDst + 8u,  _mm_blend_ps(_mm_castsi128_ps(_mm_alignr_epi8(c, b, 8)), alphas, 0x08));
+            _mm_storeu_ps(pDst + 12u, _mm_blend_ps(_mm_castsi128_ps(_mm_srli_si128(c, 4)), alphas, 0x08));
+        }
+
+    #elif defined(LS_ARM_NEON)
+        const float32x4_t alphas = vdupq_n_f32(alpha);
+
+        for (; i + 4u <= count; i += 4u)
+        {
+            const float32x4x3_t in = vld3q_f32(reinterpret_cast<const float*>(pIn + i));
+            const float32x4x4_t out = {{in.val[0], in.val[1], in.val[2], alphas}};
+            vst4q_f32(reinterpret_cast<float*>(pOut + i), out);
+        }
+    #endif
+
+    for (; i < count; ++i)
+    {
+        pOut[i] = SL_ColorRGBAf{pIn[i][0], pIn[i][1], pIn[i][2], alpha};
+    }
+}
+
+
+
+/*-------------------------------------
+ * RGBA8 to RGB8
+-------------------------------------*/
+void sl_convert_rgba_to_rgb(const SL_ColorRGBA8* pIn, SL_ColorRGB8* pOut, size_t count) noexcept
+{
+    size_t i = 0;
+
+    #if defined(LS_X86_SSE4_1)
+        const __m128i shuffle = _mm_set_epi8(-1, -1, -1, -1, 14, 13, 12, 10, 9, 8, 6, 5, 4, 2, 1, 0);
+
+        for (; i + 4u <= count; i += 4u)
+        {
+            const __m128i out  = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i)), shuffle);
+            unsigned char* pDst = reinterpret_cast<unsigned char*>(pOut + i);
+
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(pDst), out);
+            *reinterpret_cast<int32_t*>(pDst + 8) = _mm_extract_epi32(out, 2);
+        }
+
+    #elif defined(LS_ARM_NEON)
+        for (; i + 8u <= count; i += 8u)
+        {
+            const uint8x8x4_t in = vld4_u8(reinterpret_cast<const uint8_t*>(pIn + i));
+            const uint8x8x3_t out = {{in.val[0], in.val[1], in.val[2]}};
+            vst3_u8(reinterpret_cast<uint8_t*>(pOut + i), out);
+        }
+    #endif
+
+    for (; i < count; ++i)
+    {
+        pOut[i] = SL_ColorRGB8{pIn[i][0], pIn[i][1], pIn[i][2]};
+    }
+}
+
+
+
+/*-------------------------------------
+ * RGBAf to RGBf
+-------------------------------------*/
+void sl_convert_rgba_to_rgb(const SL_ColorRGBAf* pIn, SL_ColorRGBf* pOut, size_t count) noexcept
+{
+    size_t i = 0;
+
+    #if defined(LS_X86_SSE4_1)
+        for (; i + 4u <= count; i += 4u)
+        {
+            const float* pSrc = reinterpret_cast<const float*>(pIn + i);
+            float* pDst = reinterpret_cast<float*>(pOut + i);
+
+            const __m128 c0 = _mm_loadu_ps(pSrc + 0u);
+            const __m128 c1 = _mm_loadu_ps(pSrc + 4u);
+            const __m128 c2 = _mm_loadu_ps(pSrc + 8u);
+            const __m128 c3 = _mm_loadu_ps(pSrc + 12u);
+
+            // [r0 g0 b0 r1], [g1 b1 r2 g2], [b2 r3 g3 b3]
+            const __m128 a = _mm_blend_ps(c0, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(c1), 12)), 0x08);
+            const __m128 b = _mm_shuffle_ps(c1, c2, _MM_SHUFFLE(1, 0, 2, 1));
+            const __m128 c = _mm_blend_ps(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(c3), 4)), _mm_movehl_ps(c2, c2), 0x01);
+
+            _mm_storeu_ps(pDst + 0u, a);
+            _mm_storeu_ps(pDst + 4u, b);
+            _mm_storeu_ps(pDst + 8u, c);
+        }
+
+    #elif defined(LS_ARM_NEON)
+        for (; i + 4u <= count; i += 4u)
+        {
+            const float32x4x4_t in = vld4q_f32(reinterpret_cast<const float*>(pIn + i));
+            const float32x4x3_t out = {{in.val[0], in.val[1], in.val[2]}};
+            vst3q_f32(reinterpret_cast<float*>(pOut + i), out);
+        }
+    #endif
+
+    for (; i < count; ++i)
+    {
+        pOut[i] = SL_ColorRGBf{pIn[i][0], pIn[i][1], pIn[i][2]};
+    }
+}
+
+
+
+/*-------------------------------------
+ * RGB to HSV
+-------------------------------------*/
+void sl_convert_rgb_to_hsv(const SL_ColorRGBf* pIn, SL_ColorTypeHSVf* pOut, size_t count) noexcept
+{
+    _sl_convert_3_channels<SL_ColorLanes, SL_ColorRGBf, SL_ColorTypeHSVf, _sl_rgb_to_hsv_lanes<SL_ColorLanes>>(pIn, pOut, count);
+}
+
+
+
+/*-------------------------------------
+ * HSV to RGB
+-------------------------------------*/
+void sl_convert_hsv_to_rgb(const SL_ColorTypeHSVf* pIn, SL_ColorRGBf* pOut, size_t count) noexcept
+{
+    _sl_convert_3_channels<SL_ColorLanes, SL_ColorTypeHSVf, SL_ColorRGBf, _sl_hsv_to_rgb_lanes<SL_ColorLanes>>(pIn, pOut, count);
+}
+
+
+
+/*-------------------------------------
+ * RGB to HSL
+-------------------------------------*/
+void sl_convert_rgb_to_hsl(const SL_ColorRGBf* pIn, SL_ColorTypeHSLf* pOut, size_t count) noexcept
+{
+    _sl_convert_3_channels<SL_ColorLanes, SL_ColorRGBf, SL_ColorTypeHSLf, _sl_rgb_to_hsl_lanes<SL_ColorLanes>>(pIn, pOut, count);
+}
+
+
+
+/*-------------------------------------
+ * HSL to RGB
+-------------------------------------*/
+void sl_convert_hsl_to_rgb(const SL_ColorTypeHSLf* pIn, SL_ColorRGBf* pOut, size_t count) noexcept
+{
+    _sl_convert_3_channels<SL_ColorLanes, SL_ColorTypeHSLf, SL_ColorRGBf, _sl_hsl_to_rgb_lanes<SL_ColorLanes>>(pIn, pOut, count);
+}
@@ -0,0 +1,131 @@
+
+#include "lightsky/utils/Assertions.h"
+
+#include "lightsky/math/scalar_utils.h"
+#include "lightsky/math/vec_utils.h"
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_CompositeProcessor.hpp"
+#include "softlight/SL_Texture.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions and namespaces
+-----------------------------------------------------------------------------*/
+namespace math = ls::math;
+
+namespace
+{
+
+
+
+/*-------------------------------------
+ * Read a destination texel as a normalized float
+-------------------------------------*/
+template <typename color_type>
+inline LS_INLINE math::vec4 _sl_load_dst(const color_type& c) noexcept;
+
+template <>
+inline LS_INLINE math::vec4 _sl_load_dst<SL_ColorRGBA8>(const SL_ColorRGBA8& c) noexcept
+{
+    return color_cast<float, uint8_t>(c);
+}
+
+template <>
+inline LS_INLINE math::vec4 _sl_load_dst<SL_ColorRGBAf>(const SL_ColorRGBAf& c) noexcept
+{
+    return c;
+}
+
+
+
+/*-------------------------------------
+ * Convert a composited color into the output format
+-------------------------------------*/
+template <typename color_type>
+inline LS_INLINE color_type _sl_store_dst(const math::vec4& c) noexcept;
+
+template <>
+inline LS_INLINE SL_ColorRGBA8 _sl_store_dst<SL_ColorRGBA8>(const math::vec4& c) noexcept
+{
+    return color_cast<uint8_t, float>(math::clamp(c, math::vec4{0.f}, math::vec4{1.f}));
+}
+
+template <>
+inline LS_INLINE SL_ColorRGBAf _sl_store_dst<SL_ColorRGBAf>(const math::vec4& c) noexcept
+{
+    return c;
+}
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_CompositeProcessor Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Resolve transparency over the back buffer
+-------------------------------------*/
+template <typename out_type>
+void SL_CompositeProcessor::composite() noexcept
+{
+    const uint16_t w = mBackBuffer->width();
+    const uint16_t h = mBackBuffer->height();
+
+    for (uint16_t y = mThreadId; y < h; y += mNumThreads)
+    {
+        const SL_ColorRGBAf* pAccum  = mAccum->row_pointer<SL_ColorRGBAf>(y);
+        const SL_ColorRf*    pReveal = mRevealage->row_pointer<SL_ColorRf>(y);
+        out_type*            pOut    = mBackBuffer->row_pointer<out_type>(y);
+
+        for (uint16_t x = 0; x < w; ++x)
+        {
+            const float revealage = pReveal[x].r;
+
+            if (revealage >= 1.f)
+            {
+                continue;
+            }
+
+            // The weighted average of all transparent colors is blended over
+            // the opaque image using the total coverage of the pixel.
+            const math::vec4& accum = pAccum[x];
+            const math::vec4&& avg  = accum * math::rcp(math::max(accum[3], 1.e-5f));
+            const math::vec4&& dst  = _sl_load_dst<out_type>(pOut[x]);
+
+            math::vec4&& result = math::mix(avg, dst, revealage);
+            result[3] = dst[3] + (1.f - dst[3]) * (1.f - revealage);
+
+            pOut[x] = _sl_store_dst<out_type>(result);
+        }
+    }
+}
+
+
+
+template void SL_CompositeProcessor::composite<SL_ColorRGBA8>() noexcept;
+template void SL_CompositeProcessor::composite<SL_ColorRGBAf>() noexcept;
+
+
+
+/*-------------------------------------
+ * Run the composite pass
+-------------------------------------*/
+void SL_CompositeProcessor::execute() noexcept
+{
+    LS_DEBUG_ASSERT(mAccum->type() == SL_COLOR_RGBA_FLOAT);
+    LS_DEBUG_ASSERT(mRevealage->type() == SL_COLOR_R_FLOAT);
+
+    switch (mBackBuffer->type())
+    {
+        case SL_COLOR_RGBA_8U:    composite<SL_ColorRGBA8>(); break;
+        case SL_COLOR_RGBA_FLOAT: composite<SL_ColorRGBAf>(); break;
+        default:
+            LS_DEBUG_ASSERT(false);
+            LS_UNREACHABLE();
+    }
+}
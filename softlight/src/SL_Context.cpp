@@ -1,28 +1,145 @@
 
 #include <algorithm> // std::move (overload)
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include <iterator> // std::back_inserter
 #include <utility> // std::move
 
+#include "softlight/SL_CompositeProcessor.hpp"
 #include "softlight/SL_Context.hpp"
+#include "softlight/SL_DamageRegion.hpp"
 #include "softlight/SL_FragmentProcessor.hpp"
+#include "softlight/SL_FrameCapture.hpp"
 #include "softlight/SL_Framebuffer.hpp"
 #include "softlight/SL_IndexBuffer.hpp"
+#include "softlight/SL_LightCluster.hpp"
+#include "softlight/SL_LightProcessor.hpp"
 #include "softlight/SL_Shader.hpp"
+#include "softlight/SL_TexUploadProcessor.hpp"
 #include "softlight/SL_Texture.hpp"
 #include "softlight/SL_UniformBuffer.hpp"
 #include "softlight/SL_VertexArray.hpp"
 #include "softlight/SL_VertexBuffer.hpp"
+#include "softlight/SL_VolumeRendering.hpp"
 #include "softlight/SL_WindowBuffer.hpp"
 
 
 
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+
+
+/*-------------------------------------
+ * Mark the area covered by a draw call as damaged
+-------------------------------------*/
+inline void _sl_damage_draw_area(SL_Framebuffer& fbo, const SL_ViewportState& viewState, const SL_DamageRegion* pDirty = nullptr) noexcept
+{
+    const SL_Texture* pTex = fbo.num_color_buffers() ? fbo.get_color_buffer(0) : fbo.get_depth_buffer();
+
+    if (!pTex)
+    {
+        return;
+    }
+
+    const ls::math::vec4_t<int32_t>&& area = viewState.viewport_rect(0, 0, (int32_t)pTex->width(), (int32_t)pTex->height());
+
+    if (!pDirty)
+    {
+        fbo.damage().add(area);
+        return;
+    }
+
+    // Fragments outside of the dirty rectangles are never written
+    for (unsigned i = 0; i < pDirty->num_rects(); ++i)
+    {
+        const ls::math::vec4_t<int32_t>& r = pDirty->rect(i);
+        const int32_t x0 = ls::math::max(r[0], area[0]);
+        const int32_t y0 = ls::math::max(r[1], area[1]);
+        const int32_t x1 = ls::math::min(r[0]+r[2], area[0]+area[2]);
+        const int32_t y1 = ls::math::min(r[1]+r[3], area[1]+area[3]);
+
+        if (x1 > x0 && y1 > y0)
+        {
+            fbo.damage().add(x0, y0, x1-x0, y1-y0);
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Mark an entire attachment as damaged
+-------------------------------------*/
+inline void _sl_damage_attachment(SL_Framebuffer& fbo, const SL_Texture& tex, const SL_DamageRegion* pDirty) noexcept
+{
+    if (pDirty)
+    {
+        SL_DamageRegion damage = *pDirty;
+        damage.clip((int32_t)tex.width(), (int32_t)tex.height());
+        fbo.damage().add(damage);
+    }
+    else
+    {
+        fbo.damage().add(0, 0, (int32_t)tex.width(), (int32_t)tex.height());
+    }
+}
+
+
+
+/*-------------------------------------
+ * Run a draw call once, restricting the scissor to the bounds of a dirty
+ * region. Vertex processors reject primitives which miss every rectangle and
+ * fragment processors reject fragments which fall between rectangles.
+-------------------------------------*/
+template <typename draw_func_type>
+void _sl_draw_dirty_region(
+    SL_Framebuffer& fbo,
+    SL_ViewportState& viewState,
+    const SL_DamageRegion& dirty,
+    const draw_func_type& drawFunc) noexcept
+{
+    const ls::math::vec4_t<int32_t> scissor = viewState.scissor();
+    const ls::math::vec4_t<int32_t>&& r = dirty.bounds();
+
+    const int32_t x0 = ls::math::max(r[0], scissor[0]);
+    const int32_t y0 = ls::math::max(r[1], scissor[1]);
+    const int32_t x1 = ls::math::min(r[0]+r[2], scissor[0]+scissor[2]);
+    const int32_t y1 = ls::math::min(r[1]+r[3], scissor[1]+scissor[3]);
+
+    if (x1 <= x0 || y1 <= y0)
+    {
+        return;
+    }
+
+    viewState.scissor(x0, y0, (uint16_t)(x1-x0), (uint16_t)(y1-y0));
+
+    _sl_damage_draw_area(fbo, viewState, &dirty);
+    drawFunc();
+
+    viewState.scissor(scissor[0], scissor[1], (uint16_t)scissor[2], (uint16_t)scissor[3]);
+}
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_Context Class
+-----------------------------------------------------------------------------*/
 /*-------------------------------------
  *
 -------------------------------------*/
 SL_Context::~SL_Context() noexcept
 {
+    end_capture();
+
     for (SL_Texture* pTex : mTextures)
     {
         delete pTex;
@@ -43,7 +160,10 @@ SL_Context::SL_Context() noexcept :
     mUniforms{},
     mShaders{},
     mViewState{},
-    mProcessors{}
+    mDirtyRegion{},
+    mUseDirtyRegion{false},
+    mProcessors{},
+    mCapture{nullptr}
 {}
 
 
@@ -60,7 +180,10 @@ SL_Context::SL_Context(const SL_Context& c) noexcept :
     mUniforms{c.mUniforms},
     mShaders{c.mShaders},
     mViewState{c.mViewState},
-    mProcessors{c.mProcessors}
+    mDirtyRegion{c.mDirtyRegion},
+    mUseDirtyRegion{c.mUseDirtyRegion},
+    mProcessors{c.mProcessors},
+    mCapture{nullptr}
 {
     mTextures.reserve(c.mTextures.size());
 
@@ -84,8 +207,14 @@ SL_Context::SL_Context(SL_Context&& c) noexcept :
     mUniforms{std::move(c.mUniforms)},
     mShaders{std::move(c.mShaders)},
     mViewState{std::move(c.mViewState)},
-    mProcessors{std::move(c.mProcessors)}
-{}
+    mDirtyRegion{c.mDirtyRegion},
+    mUseDirtyRegion{c.mUseDirtyRegion},
+    mProcessors{std::move(c.mProcessors)},
+    mCapture{c.mCapture}
+{
+    c.mCapture = nullptr;
+    c.clear_dirty_region();
+}
 
 
 
@@ -117,6 +246,8 @@ SL_Context& SL_Context::operator=(const SL_Context& c) noexcept
         }
 
         mViewState = c.mViewState;
+        mDirtyRegion = c.mDirtyRegion;
+        mUseDirtyRegion = c.mUseDirtyRegion;
         mProcessors = c.mProcessors;
     }
 
@@ -140,7 +271,15 @@ SL_Context& SL_Context::operator=(SL_Context&& c) noexcept
         mUniforms   = std::move(c.mUniforms);
         mShaders    = std::move(c.mShaders);
         mViewState      = std::move(c.mViewState);
+        mDirtyRegion = c.mDirtyRegion;
+        mUseDirtyRegion = c.mUseDirtyRegion;
         mProcessors = std::move(c.mProcessors);
+
+        end_capture();
+        mCapture = c.mCapture;
+        c.mCapture = nullptr;
+
+        c.clear_dirty_region();
     }
 
     return *this;
@@ -567,6 +706,8 @@ void SL_Context::destroy_shader(std::size_t index)
 -------------------------------------*/
 void SL_Context::terminate()
 {
+    end_capture();
+
     mVaos.clear();
     mVaos.shrink_to_fit();
 
@@ -591,6 +732,8 @@ void SL_Context::terminate()
 
     mViewState.reset();
 
+    clear_dirty_region();
+
     mProcessors.concurrency(1);
 }
 
@@ -643,7 +786,7 @@ void SL_Context::import(SL_Context&& inContext) noexcept
 -------------------------------------*/
 void SL_Context::draw(const SL_Mesh& m, size_t shaderId, size_t fboId) noexcept
 {
-    mProcessors.run_shader_processors(*this, m, 1, mShaders[shaderId], mFbos[fboId]);
+    draw_instanced(m, 1, shaderId, fboId);
 }
 
 
@@ -655,6 +798,21 @@ void SL_Context::draw_multiple(const SL_Mesh* meshes, size_t numMeshes, size_t s
 {
     if (meshes != nullptr && numMeshes > 0)
     {
+        if (mCapture)
+        {
+            mCapture->record_draw(*this, meshes, numMeshes, 1, shaderId, fboId);
+        }
+
+        if (mUseDirtyRegion)
+        {
+            _sl_draw_dirty_region(mFbos[fboId], mViewState, mDirtyRegion, [&]()->void
+            {
+                mProcessors.run_shader_processors(*this, meshes, numMeshes, mShaders[shaderId], mFbos[fboId]);
+            });
+            return;
+        }
+
+        _sl_damage_draw_area(mFbos[fboId], mViewState);
         mProcessors.run_shader_processors(*this, meshes, numMeshes, mShaders[shaderId], mFbos[fboId]);
     }
 }
@@ -666,6 +824,21 @@ void SL_Context::draw_multiple(const SL_Mesh* meshes, size_t numMeshes, size_t s
 -------------------------------------*/
 void SL_Context::draw_instanced(const SL_Mesh& m, size_t numInstances, size_t shaderId, size_t fboId) noexcept
 {
+    if (mCapture)
+    {
+        mCapture->record_draw(*this, &m, 1, numInstances, shaderId, fboId);
+    }
+
+    if (mUseDirtyRegion)
+    {
+        _sl_draw_dirty_region(mFbos[fboId], mViewState, mDirtyRegion, [&]()->void
+        {
+            mProcessors.run_shader_processors(*this, m, numInstances, mShaders[shaderId], mFbos[fboId]);
+        });
+        return;
+    }
+
+    _sl_damage_draw_area(mFbos[fboId], mViewState);
     mProcessors.run_shader_processors(*this, m, numInstances, mShaders[shaderId], mFbos[fboId]);
 }
 
@@ -687,6 +860,11 @@ void SL_Context::blit(size_t outTextureId, size_t inTextureId) noexcept
     const uint16_t dstX1 = pOut->width();
     const uint16_t dstY1 = pOut->height();
 
+    if (mCapture)
+    {
+        mCapture->record_blit(*this, mTextures[inTextureId], mTextures[outTextureId], srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1);
+    }
+
     mProcessors.run_blit_processors(
         mTextures[inTextureId],
         mTextures[outTextureId],
@@ -717,6 +895,11 @@ void SL_Context::blit(
     uint16_t dstX1,
     uint16_t dstY1) noexcept
 {
+    if (mCapture)
+    {
+        mCapture->record_blit(*this, mTextures[inTextureId], mTextures[outTextureId], srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1);
+    }
+
     mProcessors.run_blit_processors(
         mTextures[inTextureId],
         mTextures[outTextureId],
@@ -747,6 +930,13 @@ void SL_Context::blit(SL_WindowBuffer& buffer, size_t textureId) noexcept
     const uint16_t dstX1 = (uint16_t)buffer.width();
     const uint16_t dstY1 = (uint16_t)buffer.height();
 
+    buffer.mDamage.add(dstX0, dstY0, dstX1-dstX0, dstY1-dstY0);
+
+    if (mCapture)
+    {
+        mCapture->record_blit(*this, mTextures[textureId], &(buffer.mTexture), srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1);
+    }
+
     mProcessors.run_blit_processors(
         mTextures[textureId],
         &(buffer.mTexture),
@@ -777,6 +967,13 @@ void SL_Context::blit(
     uint16_t dstX1,
     uint16_t dstY1) noexcept
 {
+    buffer.mDamage.add(dstX0, dstY0, dstX1-dstX0, dstY1-dstY0);
+
+    if (mCapture)
+    {
+        mCapture->record_blit(*this, mTextures[textureId], &(buffer.mTexture), srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1);
+    }
+
     mProcessors.run_blit_processors(
         mTextures[textureId],
         &(buffer.mTexture),
@@ -792,6 +989,140 @@ void SL_Context::blit(
 
 
 
+/*-------------------------------------
+ * Blit damaged regions to a window
+-------------------------------------*/
+void SL_Context::blit(SL_WindowBuffer& buffer, size_t textureId, const SL_DamageRegion& damage) noexcept
+{
+    SL_Texture*   pTex = mTextures[textureId];
+    const int32_t w    = (int32_t)pTex->width();
+    const int32_t h    = (int32_t)pTex->height();
+
+    // Rectangles can only be copied one-to-one
+    if (w != (int32_t)buffer.width() || h != (int32_t)buffer.height())
+    {
+        blit(buffer, textureId);
+        return;
+    }
+
+    SL_DamageRegion region = damage;
+    region.clip(w, h);
+
+    for (unsigned i = 0; i < region.num_rects(); ++i)
+    {
+        const ls::math::vec4_t<int32_t>& r = region.rect(i);
+
+        // Textures are stored bottom-up while windows are top-down
+        const uint16_t srcX0 = (uint16_t)r[0];
+        const uint16_t srcY0 = (uint16_t)r[1];
+        const uint16_t srcX1 = (uint16_t)(r[0] + r[2]);
+        const uint16_t srcY1 = (uint16_t)(r[1] + r[3]);
+        const uint16_t dstX0 = srcX0;
+        const uint16_t dstY0 = (uint16_t)(h - srcY1);
+        const uint16_t dstX1 = srcX1;
+        const uint16_t dstY1 = (uint16_t)(h - srcY0);
+
+        if (mCapture)
+        {
+            mCapture->record_blit(*this, pTex, &(buffer.mTexture), srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1);
+        }
+
+        mProcessors.run_blit_processors(
+            pTex,
+            &(buffer.mTexture),
+            srcX0,
+            srcY0,
+            srcX1,
+            srcY1,
+            dstX0,
+            dstY0,
+            dstX1,
+            dstY1);
+    }
+
+    region.flip_vertical(h);
+    buffer.mDamage.add(region);
+}
+
+
+
+/*-------------------------------------
+ * Tone map and blit to a window
+-------------------------------------*/
+void SL_Context::blit(SL_WindowBuffer& buffer, size_t textureId, const SL_ToneMap& toneMap) noexcept
+{
+    SL_Texture*    pTex  = mTextures[textureId];
+    const uint16_t srcX0 = 0;
+    const uint16_t srcY0 = 0;
+    const uint16_t srcX1 = pTex->width();
+    const uint16_t srcY1 = pTex->height();
+    const uint16_t dstX0 = 0;
+    const uint16_t dstY0 = 0;
+    const uint16_t dstX1 = (uint16_t)buffer.width();
+    const uint16_t dstY1 = (uint16_t)buffer.height();
+
+    buffer.mDamage.add(dstX0, dstY0, dstX1-dstX0, dstY1-dstY0);
+
+    if (mCapture)
+    {
+        mCapture->record_blit(*this, mTextures[textureId], &(buffer.mTexture), srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1);
+    }
+
+    mProcessors.run_blit_processors(
+        mTextures[textureId],
+        &(buffer.mTexture),
+        srcX0,
+        srcY0,
+        srcX1,
+        srcY1,
+        dstX0,
+        dstY0,
+        dstX1,
+        dstY1,
+        &toneMap);
+}
+
+
+
+/*-------------------------------------
+ * Tone map and blit to a window
+-------------------------------------*/
+void SL_Context::blit(
+    SL_WindowBuffer& buffer,
+    size_t textureId,
+    const SL_ToneMap& toneMap,
+    uint16_t srcX0,
+    uint16_t srcY0,
+    uint16_t srcX1,
+    uint16_t srcY1,
+    uint16_t dstX0,
+    uint16_t dstY0,
+    uint16_t dstX1,
+    uint16_t dstY1) noexcept
+{
+    buffer.mDamage.add(dstX0, dstY0, dstX1-dstX0, dstY1-dstY0);
+
+    if (mCapture)
+    {
+        mCapture->record_blit(*this, mTextures[textureId], &(buffer.mTexture), srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1);
+    }
+
+    mProcessors.run_blit_processors(
+        mTextures[textureId],
+        &(buffer.mTexture),
+        srcX0,
+        srcY0,
+        srcX1,
+        srcY1,
+        dstX0,
+        dstY0,
+        dstX1,
+        dstY1,
+        &toneMap);
+}
+
+
+
 /*--------------------------------------
  * Clear a framebuffer's color attachment
 --------------------------------------*/
@@ -800,7 +1131,13 @@ void SL_Context::clear_color_buffer(size_t fboId, size_t attachmentId, const ls:
     SL_Texture* pTex = mFbos[fboId].get_color_buffer(attachmentId);
     SL_GeneralColor outColor = sl_match_color_for_type(pTex->type(), color);
 
-    mProcessors.run_clear_processors(&outColor.color, pTex);
+    if (mCapture)
+    {
+        mCapture->record_clear(*this, SL_CAPTURE_CMD_CLEAR_COLOR, fboId, 1, &attachmentId, &color, 0.0);
+    }
+
+    _sl_damage_attachment(mFbos[fboId], *pTex, dirty_region());
+    mProcessors.run_clear_processors(&outColor.color, pTex, dirty_region());
 }
 
 
@@ -836,8 +1173,13 @@ void SL_Context::clear_depth_buffer(size_t fboId, double depth) noexcept
             return;
     }
 
-    mProcessors.run_clear_processors(&depthVal, pTex);
+    if (mCapture)
+    {
+        mCapture->record_clear(*this, SL_CAPTURE_CMD_CLEAR_DEPTH, fboId, 0, nullptr, nullptr, depth);
+    }
 
+    _sl_damage_attachment(mFbos[fboId], *pTex, dirty_region());
+    mProcessors.run_clear_processors(&depthVal, pTex, dirty_region());
 }
 
 
@@ -876,7 +1218,13 @@ void SL_Context::clear_framebuffer(size_t fboId, size_t attachmentId, const ls::
             return;
     }
 
-    mProcessors.run_clear_processors(&outColor.color, &depthVal, pColorBuf, pDepth);
+    if (mCapture)
+    {
+        mCapture->record_clear(*this, SL_CAPTURE_CMD_CLEAR_FRAMEBUFFER, fboId, 1, &attachmentId, &color, depth);
+    }
+
+    _sl_damage_attachment(mFbos[fboId], *pColorBuf, dirty_region());
+    mProcessors.run_clear_processors(&outColor.color, &depthVal, pColorBuf, pDepth, dirty_region());
 }
 
 
@@ -928,7 +1276,13 @@ void SL_Context::clear_framebuffer(size_t fboId, const std::array<size_t, 2>& bu
             return;
     }
 
-    mProcessors.run_clear_processors(outColors, &depthVal, buffers, pDepth);
+    if (mCapture)
+    {
+        mCapture->record_clear(*this, SL_CAPTURE_CMD_CLEAR_FRAMEBUFFER, fboId, bufferIndices.size(), bufferIndices.data(), colors.data(), depth);
+    }
+
+    _sl_damage_attachment(mFbos[fboId], *pDepth, dirty_region());
+    mProcessors.run_clear_processors(outColors, &depthVal, buffers, pDepth, dirty_region());
 }
 
 
@@ -983,7 +1337,13 @@ void SL_Context::clear_framebuffer(size_t fboId, const std::array<size_t, 3>& bu
             return;
     }
 
-    mProcessors.run_clear_processors(outColors, &depthVal, buffers, pDepth);
+    if (mCapture)
+    {
+        mCapture->record_clear(*this, SL_CAPTURE_CMD_CLEAR_FRAMEBUFFER, fboId, bufferIndices.size(), bufferIndices.data(), colors.data(), depth);
+    }
+
+    _sl_damage_attachment(mFbos[fboId], *pDepth, dirty_region());
+    mProcessors.run_clear_processors(outColors, &depthVal, buffers, pDepth, dirty_region());
 }
 
 
@@ -1041,7 +1401,252 @@ void SL_Context::clear_framebuffer(size_t fboId, const std::array<size_t, 4>& bu
             return;
     }
 
-    mProcessors.run_clear_processors(outColors, &depthVal, buffers, pDepth);
+    if (mCapture)
+    {
+        mCapture->record_clear(*this, SL_CAPTURE_CMD_CLEAR_FRAMEBUFFER, fboId, bufferIndices.size(), bufferIndices.data(), colors.data(), depth);
+    }
+
+    _sl_damage_attachment(mFbos[fboId], *pDepth, dirty_region());
+    mProcessors.run_clear_processors(outColors, &depthVal, buffers, pDepth, dirty_region());
+}
+
+
+
+/*-------------------------------------
+ * Tiled deferred lighting
+-------------------------------------*/
+int SL_Context::draw_lights(
+    size_t gbufferId,
+    size_t outTextureId,
+    const SL_PointLight* lights,
+    size_t numLights,
+    const ls::math::mat4_t<float>& projection,
+    const ls::math::vec4_t<float>& ambient) noexcept
+{
+    const SL_Framebuffer& gbuffer = mFbos[gbufferId];
+    SL_Texture* pOut = mTextures[outTextureId];
+
+    if (gbuffer.num_color_buffers() < SL_GBUFFER_MIN_ATTACHMENTS)
+    {
+        return -1;
+    }
+
+    const SL_Texture* pAlbedo = gbuffer.get_color_buffer(SL_GBUFFER_ALBEDO);
+    const SL_Texture* pNormals = gbuffer.get_color_buffer(SL_GBUFFER_NORMAL);
+    const SL_Texture* pPositions = gbuffer.get_color_buffer(SL_GBUFFER_POSITION);
+
+    if (!pAlbedo || !pNormals || !pPositions)
+    {
+        return -1;
+    }
+
+    if (pAlbedo->type() != SL_COLOR_RGBA_8U && pAlbedo->type() != SL_COLOR_RGBA_FLOAT)
+    {
+        return -2;
+    }
+
+    if (pNormals->type() != SL_COLOR_RGBA_FLOAT || pPositions->type() != SL_COLOR_RGBA_FLOAT)
+    {
+        return -3;
+    }
+
+    if (pOut->type() != SL_COLOR_RGBA_8U && pOut->type() != SL_COLOR_RGBA_FLOAT)
+    {
+        return -4;
+    }
+
+    if (pOut->width() != gbuffer.width() || pOut->height() != gbuffer.height())
+    {
+        return -5;
+    }
+
+    // Per-tile light lists store 16-bit indices
+    if (numLights > 0xFFFFu)
+    {
+        return -6;
+    }
+
+    // Lighting reads the G-Buffer one row at a time
+    if (pAlbedo->texel_order() != SL_TEXELS_ORDERED
+    || pNormals->texel_order() != SL_TEXELS_ORDERED
+    || pPositions->texel_order() != SL_TEXELS_ORDERED
+    || pOut->texel_order() != SL_TEXELS_ORDERED)
+    {
+        return -7;
+    }
+
+    mProcessors.run_light_processors(lights, (uint32_t)numLights, projection, ambient, gbuffer, pOut);
+
+    return 0;
+}
+
+
+
+/*--------------------------------------
+ * Clustered light assignment
+--------------------------------------*/
+int SL_Context::build_light_clusters(SL_LightClusters& clusters, const SL_PointLight* lights, size_t numLights) noexcept
+{
+    if (!clusters.valid())
+    {
+        return -1;
+    }
+
+    // Cluster light lists store 16-bit indices
+    if (numLights > 0xFFFFu)
+    {
+        return -2;
+    }
+
+    mProcessors.run_cluster_processors(clusters, lights, (uint32_t)numLights);
+
+    return 0;
+}
+
+
+
+/*--------------------------------------
+ * Weighted-blended OIT resolve
+--------------------------------------*/
+int SL_Context::composite_transparency(size_t oitFboId, size_t outTextureId) noexcept
+{
+    const SL_Framebuffer& fbo = mFbos[oitFboId];
+    SL_Texture* pOut = mTextures[outTextureId];
+
+    if (fbo.num_color_buffers() < SL_OIT_MIN_ATTACHMENTS)
+    {
+        return -1;
+    }
+
+    const SL_Texture* pAccum = fbo.get_color_buffer(SL_OIT_ACCUMULATION);
+    const SL_Texture* pReveal = fbo.get_color_buffer(SL_OIT_REVEALAGE);
+
+    if (!pAccum || !pReveal)
+    {
+        return -1;
+    }
+
+    if (pAccum->type() != SL_COLOR_RGBA_FLOAT || pReveal->type() != SL_COLOR_R_FLOAT)
+    {
+        return -2;
+    }
+
+    if (pOut->type() != SL_COLOR_RGBA_8U && pOut->type() != SL_COLOR_RGBA_FLOAT)
+    {
+        return -3;
+    }
+
+    if (pOut->width() != fbo.width() || pOut->height() != fbo.height())
+    {
+        return -4;
+    }
+
+    // Compositing reads and writes one row at a time
+    if (pAccum->texel_order() != SL_TEXELS_ORDERED
+    || pReveal->texel_order() != SL_TEXELS_ORDERED
+    || pOut->texel_order() != SL_TEXELS_ORDERED)
+    {
+        return -5;
+    }
+
+    mProcessors.run_composite_processors(pAccum, pReveal, pOut);
+
+    return 0;
+}
+
+
+
+/*--------------------------------------
+ * Volume brick generation
+--------------------------------------*/
+int SL_Context::build_volume_bricks(const SL_Texture& volume, SL_VolumeBricks& bricks, SL_TexelOrder texelOrder) noexcept
+{
+    if (!bricks.valid())
+    {
+        return -1;
+    }
+
+    switch (volume.type())
+    {
+        case SL_COLOR_R_8U:
+        case SL_COLOR_R_16U:
+        case SL_COLOR_R_32U:
+        case SL_COLOR_R_FLOAT:
+            break;
+
+        default:
+            return -2;
+    }
+
+    const uint16_t brickSize = bricks.brick_size();
+    if (bricks.bricks_x() != (volume.width() + brickSize - 1u) / brickSize
+    || bricks.bricks_y() != (volume.height() + brickSize - 1u) / brickSize
+    || bricks.bricks_z() != (volume.depth() + brickSize - 1u) / brickSize)
+    {
+        return -3;
+    }
+
+    mProcessors.run_volume_processors(volume, bricks, texelOrder);
+
+    return 0;
+}
+
+
+
+/*--------------------------------------
+ * Upload texels using all threads
+--------------------------------------*/
+int SL_Context::upload_texture(SL_Texture& tex, const void* pTexels, SL_ColorDataType srcType, SL_TexelOrder srcOrder) noexcept
+{
+    if (!pTexels || !tex.data() || tex.layout() != SL_TEX_LAYOUT_VOLUME)
+    {
+        return -1;
+    }
+
+    if (!sl_is_tex_upload_supported(srcType, tex.type()))
+    {
+        return -2;
+    }
+
+    mProcessors.run_tex_upload_processors(pTexels, srcType, srcOrder, tex);
+
+    return 0;
+}
+
+
+
+/*--------------------------------------
+ * Convert a texture's texel order using all threads
+--------------------------------------*/
+int SL_Context::reorder_texture(SL_Texture& tex, SL_TexelOrder texelOrder) noexcept
+{
+    if (!tex.data() || tex.layout() != SL_TEX_LAYOUT_VOLUME)
+    {
+        return -1;
+    }
+
+    if (tex.texel_order() == texelOrder)
+    {
+        return 0;
+    }
+
+    SL_Texture reordered;
+    const int initCode = reordered.init(tex.type(), tex.width(), tex.height(), tex.depth(), texelOrder);
+
+    if (initCode == -2)
+    {
+        return -2;
+    }
+
+    if (initCode != 0)
+    {
+        return -3;
+    }
+
+    mProcessors.run_tex_upload_processors(tex.data(), tex.type(), tex.texel_order(), reordered);
+    tex = std::move(reordered);
+
+    return 0;
 }
 
 
@@ -1063,3 +1668,180 @@ unsigned SL_Context::num_threads(unsigned inNumThreads) noexcept
 {
     return mProcessors.concurrency(inNumThreads);
 }
+
+
+
+/*--------------------------------------
+ * Set the number of threads and their placement
+--------------------------------------*/
+unsigned SL_Context::num_threads(unsigned inNumThreads, SL_ThreadPlacement placement) noexcept
+{
+    return mProcessors.concurrency(inNumThreads, placement);
+}
+
+
+
+/*--------------------------------------
+ * Retrieve the thread placement
+--------------------------------------*/
+SL_ThreadPlacement SL_Context::thread_placement() const noexcept
+{
+    return mProcessors.placement();
+}
+
+
+
+/*--------------------------------------
+ * Find the fastest thread configuration for a workload
+--------------------------------------*/
+unsigned SL_Context::calibrate_threads(void (*pWorkload)(SL_Context&, void*), void* pUserData, unsigned numIterations) noexcept
+{
+    if (!pWorkload)
+    {
+        return 0;
+    }
+
+    // The topology only lists CPUs the process may run on, so no thread
+    // count exceeds the available CPUs.
+    SL_CpuTopology topology;
+    topology.load();
+
+    const unsigned numCpus = topology.num_cpus();
+    const unsigned numCores = ls::math::clamp<unsigned>(topology.num_cores(), 1u, numCpus);
+
+    SL_AlignedVector<unsigned> counts;
+    for (unsigned n = 1; n < numCores; n += n)
+    {
+        counts.push_back(n);
+    }
+
+    counts.push_back(numCores);
+    if (numCpus > numCores)
+    {
+        counts.push_back(numCpus);
+    }
+
+    SL_AlignedVector<SL_ThreadPlacement> placements;
+    placements.push_back(SL_THREAD_PLACEMENT_NONE);
+    placements.push_back(SL_THREAD_PLACEMENT_CORES);
+
+    if (numCpus > numCores)
+    {
+        placements.push_back(SL_THREAD_PLACEMENT_SMT);
+    }
+
+    if (topology.num_nodes() > 1)
+    {
+        placements.push_back(SL_THREAD_PLACEMENT_NODES);
+    }
+
+    numIterations = ls::math::max<unsigned>(1u, numIterations);
+
+    unsigned bestCount = num_threads();
+    SL_ThreadPlacement bestPlacement = thread_placement();
+    double bestTime = 0.0;
+
+    for (unsigned n : counts)
+    {
+        for (SL_ThreadPlacement placement : placements)
+        {
+            // Every placement of a single thread uses one core
+            if (n == 1 && placement != SL_THREAD_PLACEMENT_CORES)
+            {
+                continue;
+            }
+
+            mProcessors.concurrency(n, placement);
+            pWorkload(*this, pUserData);
+
+            double minTime = 0.0;
+            for (unsigned i = 0; i < numIterations; ++i)
+            {
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                pWorkload(*this, pUserData);
+                const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+                const double t = std::chrono::duration<double>{end - start}.count();
+                minTime = (i == 0) ? t : ls::math::min(minTime, t);
+            }
+
+            if (bestTime == 0.0 || minTime < bestTime)
+            {
+                bestTime = minTime;
+                bestCount = n;
+                bestPlacement = placement;
+            }
+        }
+    }
+
+    return mProcessors.concurrency(bestCount, bestPlacement);
+}
+
+
+
+/*--------------------------------------
+ * Retrieve the accumulated pipeline statistics
+--------------------------------------*/
+SL_PipelineStatistics SL_Context::pipeline_statistics() const noexcept
+{
+    return mProcessors.statistics();
+}
+
+
+
+/*--------------------------------------
+ * Begin a pipeline statistics query
+--------------------------------------*/
+void SL_Context::begin_query(SL_PipelineQuery& query) const noexcept
+{
+    query.start = mProcessors.statistics();
+    sl_reset_pipeline_statistics(query.result);
+}
+
+
+
+/*--------------------------------------
+ * End a pipeline statistics query
+--------------------------------------*/
+void SL_Context::end_query(SL_PipelineQuery& query) const noexcept
+{
+    query.result = mProcessors.statistics();
+    sl_subtract_pipeline_statistics(query.result, query.start);
+}
+
+
+
+/*-------------------------------------
+ * Begin recording a frame capture
+-------------------------------------*/
+int SL_Context::begin_capture(SL_FrameCapture& capture, const SL_CaptureTextureSlot* pTextureSlots, size_t numTextureSlots) noexcept
+{
+    if (mCapture || capture.recording())
+    {
+        return -1;
+    }
+
+    const int ret = capture.begin(*this, pTextureSlots, numTextureSlots);
+    if (ret != 0)
+    {
+        return ret == -3 ? -3 : -2;
+    }
+
+    mCapture = &capture;
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Stop recording a frame capture
+-------------------------------------*/
+void SL_Context::end_capture() noexcept
+{
+    if (mCapture)
+    {
+        mCapture->end();
+        mCapture = nullptr;
+    }
+}
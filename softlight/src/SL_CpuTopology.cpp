@@ -0,0 +1,486 @@
+
+#include <algorithm> // std::find(), std::remove_if(), std::sort(), std::unique()
+#include <cstdlib> // std::strtol(), std::strtoul()
+#include <fstream>
+#include <string>
+#include <thread> // std::thread::hardware_concurrency()
+
+#if defined(__linux__)
+    #include <sched.h> // sched_getaffinity(), sched_setaffinity()
+#endif
+
+#include "lightsky/utils/WorkerThread.hpp" // set_thread_affinity()
+
+#include "softlight/SL_CpuTopology.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+
+
+/*-------------------------------------
+ * Sort key used to order CPUs for placement
+-------------------------------------*/
+struct _SL_CpuOrder
+{
+    uint32_t keys[4];
+    uint16_t cpuId;
+};
+
+
+
+inline bool _sl_cpu_order_less(const _SL_CpuOrder& a, const _SL_CpuOrder& b) noexcept
+{
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        if (a.keys[i] != b.keys[i])
+        {
+            return a.keys[i] < b.keys[i];
+        }
+    }
+
+    return a.cpuId < b.cpuId;
+}
+
+
+
+/*-------------------------------------
+ * Read the first line of a sysfs file
+-------------------------------------*/
+bool _sl_read_sysfs_line(const std::string& path, std::string& outLine) noexcept
+{
+    std::ifstream f{path, std::ifstream::in};
+    outLine.clear();
+
+    return f.good() && std::getline(f, outLine) && !outLine.empty();
+}
+
+
+
+/*-------------------------------------
+ * Read an integer from a sysfs file
+-------------------------------------*/
+bool _sl_read_sysfs_uint(const std::string& path, uint16_t& outVal) noexcept
+{
+    std::string line;
+    if (!_sl_read_sysfs_line(path, line))
+    {
+        return false;
+    }
+
+    // Some hypervisors report -1 for unknown packages
+    char* pEnd = nullptr;
+    const long val = std::strtol(line.c_str(), &pEnd, 10);
+    if (pEnd == line.c_str() || val < 0 || val > UINT16_MAX)
+    {
+        return false;
+    }
+
+    outVal = (uint16_t)val;
+    return true;
+}
+
+
+
+/*-------------------------------------
+ * Parse a sysfs CPU or node list, such as "0-3,8-11"
+-------------------------------------*/
+void _sl_parse_id_list(const std::string& list, SL_AlignedVector<uint16_t>& outIds) noexcept
+{
+    const char* pStr = list.c_str();
+    outIds.clear();
+
+    while (*pStr)
+    {
+        char* pEnd = nullptr;
+        const unsigned long first = std::strtoul(pStr, &pEnd, 10);
+        if (pEnd == pStr)
+        {
+            break;
+        }
+
+        unsigned long last = first;
+        pStr = pEnd;
+
+        if (*pStr == '-')
+        {
+            ++pStr;
+            last = std::strtoul(pStr, &pEnd, 10);
+            if (pEnd == pStr)
+            {
+                break;
+            }
+            pStr = pEnd;
+        }
+
+        for (unsigned long id = first; id <= last && id <= UINT16_MAX; ++id)
+        {
+            outIds.push_back((uint16_t)id);
+        }
+
+        while (*pStr == ',' || *pStr == ' ' || *pStr == '\n')
+        {
+            ++pStr;
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Count the unique values of a CPU field
+-------------------------------------*/
+unsigned _sl_count_unique(const SL_AlignedVector<SL_CpuInfo>& cpus, uint16_t SL_CpuInfo::*pField) noexcept
+{
+    SL_AlignedVector<uint16_t> ids;
+    ids.reserve(cpus.size());
+
+    for (const SL_CpuInfo& c : cpus)
+    {
+        ids.push_back(c.*pField);
+    }
+
+    std::sort(ids.begin(), ids.end());
+    return (unsigned)(std::unique(ids.begin(), ids.end()) - ids.begin());
+}
+
+
+
+#if defined(__linux__)
+/*-------------------------------------
+ * CPUs the process may run on
+-------------------------------------*/
+const cpu_set_t* _sl_process_cpus() noexcept
+{
+    // The affinity mask is per-thread and the main thread is pinned once a
+    // processor pool exists, so the mask is read before any pinning occurs.
+    static cpu_set_t cpus;
+    static const bool valid = sched_getaffinity(0, sizeof(cpu_set_t), &cpus) == 0;
+
+    return valid ? &cpus : nullptr;
+}
+
+// Captured during static initialization, before any thread is pinned
+const cpu_set_t* const gProcessCpus = _sl_process_cpus();
+#endif
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Thread Pinning
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Placement names
+-------------------------------------*/
+const char* sl_thread_placement_name(SL_ThreadPlacement placement) noexcept
+{
+    switch (placement)
+    {
+        case SL_THREAD_PLACEMENT_NONE:
+            return "none";
+
+        case SL_THREAD_PLACEMENT_CORES:
+            return "cores";
+
+        case SL_THREAD_PLACEMENT_SMT:
+            return "smt";
+
+        case SL_THREAD_PLACEMENT_NODES:
+            return "nodes";
+    }
+
+    return "unknown";
+}
+
+
+
+/*-------------------------------------
+ * Pin the calling thread
+-------------------------------------*/
+int sl_pin_current_thread(unsigned cpuId) noexcept
+{
+    #if defined(__linux__)
+        if (cpuId >= CPU_SETSIZE)
+        {
+            return -1;
+        }
+
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpuId, &cpus);
+
+        return sched_setaffinity(0, sizeof(cpu_set_t), &cpus) == 0 ? 0 : -1;
+    #else
+        ls::utils::set_thread_affinity(ls::utils::get_thread_id(), cpuId);
+        return 0;
+    #endif
+}
+
+
+
+/*-------------------------------------
+ * Pin a worker thread
+-------------------------------------*/
+void SL_AffinityProcessor::execute() noexcept
+{
+    if (sl_pin_current_thread(mCpuId) != 0)
+    {
+        mNumFailures->fetch_add(1u, std::memory_order_relaxed);
+    }
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_CpuTopology Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_CpuTopology::SL_CpuTopology() noexcept :
+    mCpus{},
+    mNumCores{0},
+    mNumPackages{0},
+    mNumNodes{0}
+{}
+
+
+
+/*-------------------------------------
+ * Known Topology Constructor
+-------------------------------------*/
+SL_CpuTopology::SL_CpuTopology(const SL_CpuInfo* pCpus, unsigned numCpus) noexcept :
+    mCpus{pCpus, pCpus+numCpus},
+    mNumCores{0},
+    mNumPackages{0},
+    mNumNodes{0}
+{
+    count_resources();
+}
+
+
+
+/*-------------------------------------
+ * Assume every hardware thread is a separate core
+-------------------------------------*/
+void SL_CpuTopology::load_fallback() noexcept
+{
+    mCpus.clear();
+
+    #if defined(__linux__)
+        if (gProcessCpus)
+        {
+            for (unsigned i = 0; i < CPU_SETSIZE && i <= UINT16_MAX; ++i)
+            {
+                if (CPU_ISSET(i, gProcessCpus))
+                {
+                    mCpus.push_back(SL_CpuInfo{(uint16_t)i, (uint16_t)i, 0, 0, 0});
+                }
+            }
+        }
+    #endif
+
+    if (mCpus.empty())
+    {
+        const unsigned numCpus = std::max<unsigned>(1u, std::thread::hardware_concurrency());
+        mCpus.reserve(numCpus);
+
+        for (unsigned i = 0; i < numCpus; ++i)
+        {
+            mCpus.push_back(SL_CpuInfo{(uint16_t)i, (uint16_t)i, 0, 0, 0});
+        }
+    }
+
+    count_resources();
+}
+
+
+
+/*-------------------------------------
+ * Count cores, packages, and nodes
+-------------------------------------*/
+void SL_CpuTopology::count_resources() noexcept
+{
+    mNumCores = 0;
+
+    for (const SL_CpuInfo& c : mCpus)
+    {
+        mNumCores += (c.smtIndex == 0) ? 1u : 0u;
+    }
+
+    mNumPackages = _sl_count_unique(mCpus, &SL_CpuInfo::packageId);
+    mNumNodes = _sl_count_unique(mCpus, &SL_CpuInfo::numaNode);
+}
+
+
+
+/*-------------------------------------
+ * Query the host topology
+-------------------------------------*/
+int SL_CpuTopology::load() noexcept
+{
+    #if defined(__linux__)
+        const std::string cpuDir = "/sys/devices/system/cpu/cpu";
+        const std::string nodeDir = "/sys/devices/system/node/node";
+
+        std::string line;
+        SL_AlignedVector<uint16_t> ids;
+
+        if (!_sl_read_sysfs_line("/sys/devices/system/cpu/online", line))
+        {
+            load_fallback();
+            return -1;
+        }
+
+        _sl_parse_id_list(line, ids);
+
+        // Containers and taskset may restrict the process to a subset of the
+        // online CPUs.
+        if (gProcessCpus)
+        {
+            ids.erase(std::remove_if(ids.begin(), ids.end(), [](uint16_t id)->bool {
+                return id >= CPU_SETSIZE || !CPU_ISSET(id, gProcessCpus);
+            }), ids.end());
+        }
+
+        if (ids.empty())
+        {
+            load_fallback();
+            return -1;
+        }
+
+        mCpus.clear();
+        mCpus.reserve(ids.size());
+
+        for (uint16_t id : ids)
+        {
+            const std::string topoDir = cpuDir + std::to_string(id) + "/topology/";
+            SL_CpuInfo info{id, id, 0, 0, 0};
+
+            _sl_read_sysfs_uint(topoDir + "core_id", info.coreId);
+            _sl_read_sysfs_uint(topoDir + "physical_package_id", info.packageId);
+
+            mCpus.push_back(info);
+        }
+
+        // Kernels without NUMA support place every CPU on node 0
+        if (_sl_read_sysfs_line("/sys/devices/system/node/online", line))
+        {
+            SL_AlignedVector<uint16_t> nodes;
+            _sl_parse_id_list(line, nodes);
+
+            for (uint16_t node : nodes)
+            {
+                if (!_sl_read_sysfs_line(nodeDir + std::to_string(node) + "/cpulist", line))
+                {
+                    continue;
+                }
+
+                _sl_parse_id_list(line, ids);
+
+                for (SL_CpuInfo& c : mCpus)
+                {
+                    if (std::find(ids.begin(), ids.end(), c.cpuId) != ids.end())
+                    {
+                        c.numaNode = node;
+                    }
+                }
+            }
+        }
+
+        // Core IDs are only unique within a package. Hardware threads of
+        // the same core are ranked by CPU ID.
+        for (SL_CpuInfo& c : mCpus)
+        {
+            for (const SL_CpuInfo& sibling : mCpus)
+            {
+                if (sibling.cpuId < c.cpuId && sibling.coreId == c.coreId && sibling.packageId == c.packageId)
+                {
+                    ++c.smtIndex;
+                }
+            }
+        }
+
+        count_resources();
+        return 0;
+
+    #else
+        load_fallback();
+        return -1;
+    #endif
+}
+
+
+
+/*-------------------------------------
+ * Assign CPUs to threads
+-------------------------------------*/
+unsigned SL_CpuTopology::placement(SL_ThreadPlacement placement, unsigned numThreads, uint16_t* outCpuIds) const noexcept
+{
+    if (placement == SL_THREAD_PLACEMENT_NONE || mCpus.empty() || !numThreads || !outCpuIds)
+    {
+        return 0;
+    }
+
+    SL_AlignedVector<_SL_CpuOrder> order;
+    order.reserve(mCpus.size());
+
+    for (const SL_CpuInfo& c : mCpus)
+    {
+        switch (placement)
+        {
+            case SL_THREAD_PLACEMENT_SMT:
+                order.push_back(_SL_CpuOrder{{c.numaNode, c.packageId, c.coreId, c.smtIndex}, c.cpuId});
+                break;
+
+            case SL_THREAD_PLACEMENT_CORES:
+            case SL_THREAD_PLACEMENT_NODES:
+            default:
+                order.push_back(_SL_CpuOrder{{c.smtIndex, c.numaNode, c.packageId, c.coreId}, c.cpuId});
+                break;
+        }
+    }
+
+    std::sort(order.begin(), order.end(), &_sl_cpu_order_less);
+
+    // Interleave nodes by ranking each core within its node, then sorting
+    // by rank before node.
+    if (placement == SL_THREAD_PLACEMENT_NODES)
+    {
+        uint32_t rank = 0;
+        uint32_t prevSmt = UINT32_MAX;
+        uint32_t prevNode = UINT32_MAX;
+
+        for (_SL_CpuOrder& o : order)
+        {
+            const uint32_t smtIndex = o.keys[0];
+            const uint32_t node = o.keys[1];
+
+            rank = (smtIndex == prevSmt && node == prevNode) ? (rank+1u) : 0u;
+            prevSmt = smtIndex;
+            prevNode = node;
+
+            o.keys[1] = rank;
+            o.keys[2] = node;
+            o.keys[3] = 0;
+        }
+
+        std::sort(order.begin(), order.end(), &_sl_cpu_order_less);
+    }
+
+    for (unsigned i = 0; i < numThreads; ++i)
+    {
+        outCpuIds[i] = order[i % order.size()].cpuId;
+    }
+
+    return numThreads;
+}
@@ -0,0 +1,309 @@
+
+#include "lightsky/math/mat4.h"
+#include "lightsky/math/scalar_utils.h"
+
+#include "softlight/SL_BoundingBox.hpp"
+#include "softlight/SL_DamageRegion.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions
+-----------------------------------------------------------------------------*/
+namespace math = ls::math;
+
+namespace
+{
+
+
+
+/*-------------------------------------
+ * Area of a rectangle
+-------------------------------------*/
+inline uint64_t _sl_rect_area(const math::vec4_t<int32_t>& r) noexcept
+{
+    return (uint64_t)r[2] * (uint64_t)r[3];
+}
+
+
+
+/*-------------------------------------
+ * Smallest rectangle containing two others
+-------------------------------------*/
+inline math::vec4_t<int32_t> _sl_rect_union(const math::vec4_t<int32_t>& a, const math::vec4_t<int32_t>& b) noexcept
+{
+    const int32_t x0 = math::min(a[0], b[0]);
+    const int32_t y0 = math::min(a[1], b[1]);
+    const int32_t x1 = math::max(a[0]+a[2], b[0]+b[2]);
+    const int32_t y1 = math::max(a[1]+a[3], b[1]+b[3]);
+
+    return math::vec4_t<int32_t>{x0, y0, x1-x0, y1-y0};
+}
+
+
+
+/*-------------------------------------
+ * Number of pixels shared by two rectangles
+-------------------------------------*/
+inline uint64_t _sl_rect_overlap(const math::vec4_t<int32_t>& a, const math::vec4_t<int32_t>& b) noexcept
+{
+    const int32_t w = math::min(a[0]+a[2], b[0]+b[2]) - math::max(a[0], b[0]);
+    const int32_t h = math::min(a[1]+a[3], b[1]+b[3]) - math::max(a[1], b[1]);
+
+    return (w > 0 && h > 0) ? ((uint64_t)w * (uint64_t)h) : 0;
+}
+
+
+
+/*-------------------------------------
+ * Check if one rectangle contains another
+-------------------------------------*/
+inline bool _sl_rect_contains(const math::vec4_t<int32_t>& outer, const math::vec4_t<int32_t>& inner) noexcept
+{
+    return inner[0] >= outer[0]
+        && inner[1] >= outer[1]
+        && inner[0]+inner[2] <= outer[0]+outer[2]
+        && inner[1]+inner[3] <= outer[1]+outer[3];
+}
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_DamageRegion Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_DamageRegion::SL_DamageRegion() noexcept :
+    mNumRects{0},
+    mRects{}
+{}
+
+
+
+/*-------------------------------------
+ * Remove a rectangle without preserving order
+-------------------------------------*/
+void SL_DamageRegion::remove_rect(unsigned index) noexcept
+{
+    mRects[index] = mRects[--mNumRects];
+}
+
+
+
+/*-------------------------------------
+ * Add a rectangle, merging it with others if possible
+-------------------------------------*/
+void SL_DamageRegion::add(int32_t x, int32_t y, int32_t w, int32_t h) noexcept
+{
+    if (w <= 0 || h <= 0)
+    {
+        return;
+    }
+
+    math::vec4_t<int32_t> r{x, y, w, h};
+
+    // Merging may produce a rectangle which overlaps others. Keep merging
+    // until nothing else can be absorbed.
+    for (unsigned i = 0; i < mNumRects;)
+    {
+        const math::vec4_t<int32_t>& existing = mRects[i];
+
+        if (_sl_rect_contains(existing, r))
+        {
+            return;
+        }
+
+        const math::vec4_t<int32_t>&& u = _sl_rect_union(existing, r);
+        const uint64_t overlap = _sl_rect_overlap(existing, r);
+
+        if (_sl_rect_area(u) + overlap <= _sl_rect_area(existing) + _sl_rect_area(r))
+        {
+            r = u;
+            remove_rect(i);
+            i = 0;
+            continue;
+        }
+
+        ++i;
+    }
+
+    if (mNumRects < SL_DAMAGE_MAX_RECTS)
+    {
+        mRects[mNumRects++] = r;
+        return;
+    }
+
+    // Out of space, grow whichever rectangle wastes the fewest pixels
+    unsigned best = 0;
+    uint64_t bestGrowth = ~(uint64_t)0;
+
+    for (unsigned i = 0; i < mNumRects; ++i)
+    {
+        const uint64_t growth = _sl_rect_area(_sl_rect_union(mRects[i], r)) - _sl_rect_area(mRects[i]);
+        if (growth < bestGrowth)
+        {
+            best = i;
+            bestGrowth = growth;
+        }
+    }
+
+    r = _sl_rect_union(mRects[best], r);
+    remove_rect(best);
+    add(r);
+}
+
+
+
+/*-------------------------------------
+ * Merge another region into *this
+-------------------------------------*/
+void SL_DamageRegion::add(const SL_DamageRegion& region) noexcept
+{
+    if (&region == this)
+    {
+        return;
+    }
+
+    for (unsigned i = 0; i < region.mNumRects; ++i)
+    {
+        add(region.mRects[i]);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Add the projected bounds of an object
+-------------------------------------*/
+void SL_DamageRegion::add(const SL_BoundingBox& box, const math::mat4& mvp, int32_t fboW, int32_t fboH) noexcept
+{
+    const math::vec4& p0 = box.min_point();
+    const math::vec4& p1 = box.max_point();
+
+    float minX = 1.f;
+    float minY = 1.f;
+    float maxX = -1.f;
+    float maxY = -1.f;
+
+    for (unsigned i = 0; i < 8; ++i)
+    {
+        const math::vec4 corner{
+            (i & 1u) ? p1[0] : p0[0],
+            (i & 2u) ? p1[1] : p0[1],
+            (i & 4u) ? p1[2] : p0[2],
+            1.f
+        };
+        const math::vec4&& clip = mvp * corner;
+
+        // Projecting points behind the camera would mirror them
+        if (clip[3] <= 0.f)
+        {
+            add(0, 0, fboW, fboH);
+            return;
+        }
+
+        const float wInv = 1.f / clip[3];
+        minX = math::min(minX, clip[0] * wInv);
+        minY = math::min(minY, clip[1] * wInv);
+        maxX = math::max(maxX, clip[0] * wInv);
+        maxY = math::max(maxY, clip[1] * wInv);
+    }
+
+    minX = math::clamp(minX, -1.f, 1.f);
+    minY = math::clamp(minY, -1.f, 1.f);
+    maxX = math::clamp(maxX, -1.f, 1.f);
+    maxY = math::clamp(maxY, -1.f, 1.f);
+
+    // Expand by a pixel to account for rasterization rounding
+    const int32_t x0 = math::max((int32_t)((minX * 0.5f + 0.5f) * (float)fboW) - 1, 0);
+    const int32_t y0 = math::max((int32_t)((minY * 0.5f + 0.5f) * (float)fboH) - 1, 0);
+    const int32_t x1 = math::min((int32_t)((maxX * 0.5f + 0.5f) * (float)fboW) + 2, fboW);
+    const int32_t y1 = math::min((int32_t)((maxY * 0.5f + 0.5f) * (float)fboH) + 2, fboH);
+
+    add(x0, y0, x1-x0, y1-y0);
+}
+
+
+
+/*-------------------------------------
+ * Restrict all rectangles to the range [0, w) x [0, h)
+-------------------------------------*/
+void SL_DamageRegion::clip(int32_t w, int32_t h) noexcept
+{
+    for (unsigned i = 0; i < mNumRects;)
+    {
+        math::vec4_t<int32_t>& r = mRects[i];
+
+        const int32_t x0 = math::max(r[0], 0);
+        const int32_t y0 = math::max(r[1], 0);
+        const int32_t x1 = math::min(r[0]+r[2], w);
+        const int32_t y1 = math::min(r[1]+r[3], h);
+
+        if (x1 <= x0 || y1 <= y0)
+        {
+            remove_rect(i);
+            continue;
+        }
+
+        r = math::vec4_t<int32_t>{x0, y0, x1-x0, y1-y0};
+        ++i;
+    }
+}
+
+
+
+/*-------------------------------------
+ * Convert between bottom-up and top-down rows
+-------------------------------------*/
+void SL_DamageRegion::flip_vertical(int32_t h) noexcept
+{
+    for (unsigned i = 0; i < mNumRects; ++i)
+    {
+        mRects[i][1] = h - (mRects[i][1] + mRects[i][3]);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Smallest rectangle containing all damage
+-------------------------------------*/
+math::vec4_t<int32_t> SL_DamageRegion::bounds() const noexcept
+{
+    if (!mNumRects)
+    {
+        return math::vec4_t<int32_t>{0, 0, 0, 0};
+    }
+
+    math::vec4_t<int32_t> r = mRects[0];
+
+    for (unsigned i = 1; i < mNumRects; ++i)
+    {
+        r = _sl_rect_union(r, mRects[i]);
+    }
+
+    return r;
+}
+
+
+
+/*-------------------------------------
+ * Number of damaged pixels. Pixels covered by more than one rectangle are
+ * counted more than once.
+-------------------------------------*/
+uint64_t SL_DamageRegion::area() const noexcept
+{
+    uint64_t total = 0;
+
+    for (unsigned i = 0; i < mNumRects; ++i)
+    {
+        total += _sl_rect_area(mRects[i]);
+    }
+
+    return total;
+}
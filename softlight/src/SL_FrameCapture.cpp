@@ -0,0 +1,1661 @@
+
+#include <cstring> // std::memcmp(), std::memcpy(), std::memset()
+#include <fstream>
+#include <limits> // std::numeric_limits
+
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_BlitProcesor.hpp" // SL_BlitProcessor::is_blittable()
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_FrameCapture.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_Geometry.hpp" // sl_bytes_per_vertex()
+#include "softlight/SL_ViewportState.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+
+
+namespace math = ls::math;
+
+
+
+constexpr uint32_t SL_CAPTURE_INVALID_ID = std::numeric_limits<uint32_t>::max();
+
+constexpr uint64_t SL_CAPTURE_INVALID_BUFFER = std::numeric_limits<uint64_t>::max();
+
+// "SLFC" in little-endian byte order
+constexpr uint32_t SL_CAPTURE_MAGIC = 0x43464C53u;
+
+constexpr uint32_t SL_CAPTURE_VERSION = 2u;
+
+
+
+/*-------------------------------------
+ * Binary I/O
+ *
+ * Captures are written in native byte order and can only be replayed on a
+ * machine with the same endianness.
+-------------------------------------*/
+template <typename data_type>
+inline bool _sl_write(std::ostream& f, const data_type& val) noexcept
+{
+    f.write(reinterpret_cast<const char*>(&val), sizeof(data_type));
+    return f.good();
+}
+
+
+
+inline bool _sl_write_bytes(std::ostream& f, const void* pData, size_t numBytes) noexcept
+{
+    if (numBytes)
+    {
+        f.write(reinterpret_cast<const char*>(pData), (std::streamsize)numBytes);
+    }
+    return f.good();
+}
+
+
+
+template <typename data_type>
+inline bool _sl_write_array(std::ostream& f, const SL_AlignedVector<data_type>& v) noexcept
+{
+    return _sl_write<uint64_t>(f, (uint64_t)v.size()) && _sl_write_bytes(f, v.data(), v.size() * sizeof(data_type));
+}
+
+
+
+template <typename data_type>
+inline bool _sl_read(std::istream& f, data_type& val) noexcept
+{
+    f.read(reinterpret_cast<char*>(&val), sizeof(data_type));
+    return f.good();
+}
+
+
+
+inline bool _sl_read_bytes(std::istream& f, void* pData, size_t numBytes) noexcept
+{
+    if (numBytes)
+    {
+        f.read(reinterpret_cast<char*>(pData), (std::streamsize)numBytes);
+    }
+    return f.good();
+}
+
+
+
+/*-------------------------------------
+ * Read an array of plain structures. Returns 0 on success, -3 on a read
+ * error, or -4 if the array could not be allocated.
+-------------------------------------*/
+template <typename data_type>
+inline int _sl_read_array(std::istream& f, SL_AlignedVector<data_type>& v) noexcept
+{
+    uint64_t count;
+    if (!_sl_read<uint64_t>(f, count) || count > (uint64_t)std::numeric_limits<uint32_t>::max())
+    {
+        return -3;
+    }
+
+    try
+    {
+        v.resize((size_t)count);
+    }
+    catch (...)
+    {
+        return -4;
+    }
+
+    return _sl_read_bytes(f, v.data(), v.size() * sizeof(data_type)) ? 0 : -3;
+}
+
+
+
+/*-------------------------------------
+ * Determine if a mesh reads its vertices through an index buffer
+-------------------------------------*/
+inline bool _sl_capture_is_indexed(SL_RenderMode mode) noexcept
+{
+    switch (mode)
+    {
+        case RENDER_MODE_INDEXED_POINTS:
+        case RENDER_MODE_INDEXED_LINES:
+        case RENDER_MODE_INDEXED_TRIANGLES:
+        case RENDER_MODE_INDEXED_TRI_WIRE:
+            return true;
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+
+
+/*-------------------------------------
+ * Convert a render mode to its non-indexed equivalent
+-------------------------------------*/
+inline SL_RenderMode _sl_capture_unindexed_mode(SL_RenderMode mode) noexcept
+{
+    switch (mode)
+    {
+        case RENDER_MODE_INDEXED_POINTS:    return RENDER_MODE_POINTS;
+        case RENDER_MODE_INDEXED_LINES:     return RENDER_MODE_LINES;
+        case RENDER_MODE_INDEXED_TRIANGLES: return RENDER_MODE_TRIANGLES;
+        case RENDER_MODE_INDEXED_TRI_WIRE:  return RENDER_MODE_TRI_WIRE;
+        default:
+            break;
+    }
+
+    return mode;
+}
+
+
+
+/*-------------------------------------
+ * Replacement shaders for captures replayed without application shaders.
+ * Clip-space positions are interleaved with the varyings of each vertex.
+-------------------------------------*/
+math::vec4 _sl_capture_vert_shader(SL_VertexParam& param)
+{
+    const SL_VertexArray& vao = *param.pVao;
+    const math::vec4* pVert = param.pVbo->element<const math::vec4>(vao.offset(0, param.vertId));
+
+    for (size_t i = 1; i < vao.num_bindings(); ++i)
+    {
+        param.pVaryings[i-1] = pVert[i];
+    }
+
+    return pVert[0];
+}
+
+
+
+bool _sl_capture_frag_shader(SL_FragmentParam& fragParam)
+{
+    for (unsigned i = 0; i < SL_SHADER_MAX_FRAG_OUTPUTS; ++i)
+    {
+        fragParam.pOutputs[i] = math::vec4{1.f};
+    }
+
+    return true;
+}
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_FrameCapture Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_FrameCapture::SL_FrameCapture() noexcept :
+    mActive{false},
+    mNumContextTextures{0},
+    mNumContextVaos{0},
+    mNumUbos{0},
+    mWindowWidth{0},
+    mWindowHeight{0},
+    mCommands{},
+    mMeshes{},
+    mUniforms{},
+    mFixups{},
+    mShaders{},
+    mFbos{},
+    mVaos{},
+    mVbos{},
+    mIbos{},
+    mTextures{},
+    mTexturePtrs{},
+    mLatestUniforms{},
+    mTextureSlots{}
+{}
+
+
+
+/*-------------------------------------
+ * Discard all data
+-------------------------------------*/
+void SL_FrameCapture::clear() noexcept
+{
+    mActive = false;
+    mNumContextTextures = 0;
+    mNumContextVaos = 0;
+    mNumUbos = 0;
+    mWindowWidth = 0;
+    mWindowHeight = 0;
+
+    mCommands.clear();
+    mMeshes.clear();
+    mUniforms.clear();
+    mFixups.clear();
+    mShaders.clear();
+    mFbos.clear();
+    mVaos.clear();
+    mVbos.clear();
+    mIbos.clear();
+    mTextures.clear();
+    mTexturePtrs.clear();
+    mLatestUniforms.clear();
+    mTextureSlots.clear();
+}
+
+
+
+/*-------------------------------------
+ * Map a texture in the source context to a captured ID
+-------------------------------------*/
+uint32_t SL_FrameCapture::find_texture(const SL_Texture* pTex) const noexcept
+{
+    if (pTex)
+    {
+        for (size_t i = 0; i < mTexturePtrs.size(); ++i)
+        {
+            if (mTexturePtrs[i] == pTex)
+            {
+                return (uint32_t)i;
+            }
+        }
+    }
+
+    return SL_CAPTURE_INVALID_ID;
+}
+
+
+
+/*-------------------------------------
+ * Snapshot a texture which is not owned by the context
+-------------------------------------*/
+int SL_FrameCapture::add_texture(const SL_Texture* pTex, uint32_t& outId) noexcept
+{
+    outId = find_texture(pTex);
+
+    if (!pTex || outId != SL_CAPTURE_INVALID_ID)
+    {
+        return 0;
+    }
+
+    mTextures.push_back(*pTex);
+    mTexturePtrs.push_back(pTex);
+
+    if (pTex->data() && !mTextures.back().data())
+    {
+        mTextures.pop_back();
+        mTexturePtrs.pop_back();
+        outId = SL_CAPTURE_INVALID_ID;
+        return -1;
+    }
+
+    outId = (uint32_t)(mTextures.size() - 1);
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Capture the configuration of a shader
+-------------------------------------*/
+void SL_FrameCapture::add_shader(const SL_Context& context, size_t shaderId) noexcept
+{
+    const SL_Shader&         shader     = context.shader(shaderId);
+    const SL_VertexShader&   vertShader = shader.vertex_shader();
+    const SL_FragmentShader& fragShader = shader.fragment_shader();
+    const SL_UniformBuffer*  pUniforms  = shader.uniforms();
+    const SL_AlignedVector<SL_UniformBuffer>& ubos = context.ubos();
+
+    // Padding bytes are written to disk
+    SL_CaptureShader s;
+    std::memset(&s, 0, sizeof(SL_CaptureShader));
+    s.uboId           = SL_CAPTURE_INVALID_ID;
+    s.vertNumVaryings = vertShader.numVaryings;
+    s.cullMode        = vertShader.cullMode;
+    s.fragNumVaryings = fragShader.numVaryings;
+    s.numOutputs      = fragShader.numOutputs;
+    s.blend           = fragShader.blend;
+    s.depthTest       = fragShader.depthTest;
+    s.depthMask       = fragShader.depthMask;
+
+    if (pUniforms && !ubos.empty() && pUniforms >= ubos.data() && pUniforms < ubos.data() + ubos.size())
+    {
+        s.uboId = (uint32_t)(pUniforms - ubos.data());
+    }
+
+    mShaders.push_back(s);
+}
+
+
+
+/*-------------------------------------
+ * Run a draw's vertex shader over each mesh, storing the clip-space
+ * positions and varyings of every vertex and instance in a new VBO.
+-------------------------------------*/
+uint32_t SL_FrameCapture::add_clip_meshes(
+    const SL_Context& context,
+    const SL_Mesh* pMeshes,
+    size_t numMeshes,
+    size_t numInstances,
+    size_t shaderId) noexcept
+{
+    const SL_VertexShader&  vertShader  = context.shader(shaderId).vertex_shader();
+    const SL_UniformBuffer* pUniforms   = context.shader(shaderId).uniforms();
+    const size_t            numVaryings = math::min<size_t>(vertShader.numVaryings, SL_SHADER_MAX_VARYING_VECTORS);
+    const size_t            stride      = (numVaryings + 1) * sizeof(math::vec4);
+
+    numInstances = numInstances ? numInstances : 1;
+
+    if (!vertShader.shader)
+    {
+        return SL_CAPTURE_INVALID_ID;
+    }
+
+    size_t numVerts = 0;
+    for (size_t i = 0; i < numMeshes; ++i)
+    {
+        const SL_Mesh& m = pMeshes[i];
+        const SL_VertexArray& vao = context.vao(m.vaoId);
+
+        if (m.elementEnd < m.elementBegin
+        || !vao.has_vertex_buffer()
+        || (_sl_capture_is_indexed(m.mode) && !vao.has_index_buffer()))
+        {
+            return SL_CAPTURE_INVALID_ID;
+        }
+
+        numVerts += (m.elementEnd - m.elementBegin) * numInstances;
+    }
+
+    if (!numVerts)
+    {
+        return SL_CAPTURE_INVALID_ID;
+    }
+
+    mVbos.emplace_back();
+    SL_VertexBuffer& vbo = mVbos.back();
+    if (vbo.init(numVerts * stride) != 0)
+    {
+        mVbos.pop_back();
+        return SL_CAPTURE_INVALID_ID;
+    }
+
+    mVaos.emplace_back();
+    SL_VertexArray& vao = mVaos.back();
+    vao.set_vertex_buffer(mVbos.size() - 1);
+    if (vao.set_num_bindings(numVaryings + 1) != (int)(numVaryings + 1))
+    {
+        mVaos.pop_back();
+        mVbos.pop_back();
+        return SL_CAPTURE_INVALID_ID;
+    }
+
+    for (size_t i = 0; i <= numVaryings; ++i)
+    {
+        vao.set_binding(i, (ptrdiff_t)(i * sizeof(math::vec4)), (ptrdiff_t)stride, VERTEX_DIMENSION_4, VERTEX_DATA_FLOAT);
+    }
+
+    const uint32_t firstClipMesh = (uint32_t)mMeshes.size();
+    math::vec4* pOut = vbo.element<math::vec4>(0);
+    size_t vertId = 0;
+
+    for (size_t i = 0; i < numMeshes; ++i)
+    {
+        const SL_Mesh& m = pMeshes[i];
+        const SL_VertexArray& srcVao = context.vao(m.vaoId);
+        const SL_IndexBuffer* pIbo = _sl_capture_is_indexed(m.mode) ? &context.ibo(srcVao.get_index_buffer()) : nullptr;
+
+        SL_Mesh clipMesh = m;
+        clipMesh.vaoId        = mVaos.size() - 1;
+        clipMesh.elementBegin = vertId;
+        clipMesh.elementEnd   = vertId + (m.elementEnd - m.elementBegin) * numInstances;
+        clipMesh.mode         = _sl_capture_unindexed_mode(m.mode);
+
+        SL_VertexParam params;
+        params.pUniforms = pUniforms;
+        params.pVao      = &srcVao;
+        params.pVbo      = &context.vbo(srcVao.get_vertex_buffer());
+
+        for (size_t instanceId = 0; instanceId < numInstances; ++instanceId)
+        {
+            params.instanceId = instanceId;
+
+            for (size_t e = m.elementBegin; e < m.elementEnd; ++e, ++vertId, pOut += numVaryings + 1)
+            {
+                math::vec4 varyings[SL_SHADER_MAX_VARYING_VECTORS];
+
+                params.vertId    = pIbo ? pIbo->index(e) : e;
+                params.pVaryings = varyings;
+                pOut[0] = vertShader.shader(params);
+
+                for (size_t v = 0; v < numVaryings; ++v)
+                {
+                    pOut[v+1] = varyings[v];
+                }
+            }
+        }
+
+        mMeshes.push_back(clipMesh);
+    }
+
+    return firstClipMesh;
+}
+
+
+
+/*-------------------------------------
+ * Snapshot a uniform buffer, replacing texture pointers with IDs
+-------------------------------------*/
+uint32_t SL_FrameCapture::add_uniforms(const SL_UniformBuffer& ubo, uint32_t uboId) noexcept
+{
+    SL_CaptureUniforms u;
+    u.uboId      = uboId;
+    u.firstFixup = (uint32_t)mFixups.size();
+    u.numFixups  = 0;
+    u.data       = ubo;
+
+    unsigned char* const pBytes = u.data.buffer();
+
+    for (const SL_CaptureTextureSlot& slot : mTextureSlots)
+    {
+        if (slot.uboId != uboId)
+        {
+            continue;
+        }
+
+        const SL_Texture* pTex;
+        std::memcpy(&pTex, pBytes + slot.offset, sizeof(const SL_Texture*));
+        std::memset(pBytes + slot.offset, 0, sizeof(const SL_Texture*));
+
+        // Textures which are not owned by the context are copied on first
+        // use. Slots are left null if the copy fails.
+        uint32_t texId;
+        if (pTex && add_texture(pTex, texId) == 0)
+        {
+            mFixups.push_back(SL_CaptureFixup{slot.offset, texId});
+            ++u.numFixups;
+        }
+    }
+
+    // Reuse the previous snapshot if the buffer has not changed
+    if (uboId < mLatestUniforms.size() && mLatestUniforms[uboId] != SL_CAPTURE_INVALID_ID)
+    {
+        const uint32_t prevId = mLatestUniforms[uboId];
+        const SL_CaptureUniforms& prev = mUniforms[prevId];
+
+        if (prev.numFixups == u.numFixups
+        && 0 == std::memcmp(prev.data.buffer(), u.data.buffer(), SL_MAX_UNIFORM_BUFFER_SIZE)
+        && 0 == std::memcmp(mFixups.data() + prev.firstFixup, mFixups.data() + u.firstFixup, u.numFixups * sizeof(SL_CaptureFixup)))
+        {
+            mFixups.resize(u.firstFixup);
+            return prevId;
+        }
+    }
+
+    mUniforms.push_back(u);
+
+    const uint32_t uniformsId = (uint32_t)(mUniforms.size() - 1);
+    if (uboId < mLatestUniforms.size())
+    {
+        mLatestUniforms[uboId] = uniformsId;
+    }
+
+    return uniformsId;
+}
+
+
+
+/*-------------------------------------
+ * Restore a uniform buffer snapshot
+-------------------------------------*/
+void SL_FrameCapture::apply_uniforms(SL_Context& context, uint32_t uniformsId) const noexcept
+{
+    const SL_CaptureUniforms& u = mUniforms[uniformsId];
+    SL_UniformBuffer& ubo = context.ubo(u.uboId);
+
+    ubo = u.data;
+
+    for (uint32_t i = 0; i < u.numFixups; ++i)
+    {
+        const SL_CaptureFixup& fixup = mFixups[u.firstFixup + i];
+        const SL_Texture* pTex = fixup.textureId == SL_CAPTURE_WINDOW_ID ? nullptr : &context.texture(fixup.textureId);
+        std::memcpy(ubo.buffer() + fixup.offset, &pTex, sizeof(const SL_Texture*));
+    }
+}
+
+
+
+/*-------------------------------------
+ * Store the viewport state of a command
+-------------------------------------*/
+void SL_FrameCapture::record_state(const SL_Context& context, SL_CaptureCommand& cmd) const noexcept
+{
+    const math::vec4_t<int32_t> viewport = context.viewport_state().viewport();
+    const math::vec4_t<int32_t> scissor  = context.viewport_state().scissor();
+
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        cmd.viewport[i] = viewport[i];
+        cmd.scissor[i]  = scissor[i];
+    }
+}
+
+
+
+/*-------------------------------------
+ * Ensure a mesh only references vertices and indices within its buffers
+-------------------------------------*/
+bool SL_FrameCapture::validate_mesh(const SL_Mesh& m) const noexcept
+{
+    const SL_VertexArray& vao = mVaos[m.vaoId];
+
+    if (m.elementEnd < m.elementBegin || !vao.has_vertex_buffer())
+    {
+        return false;
+    }
+
+    if (m.elementEnd == m.elementBegin)
+    {
+        return true;
+    }
+
+    size_t maxVertId = m.elementEnd - 1;
+
+    if (_sl_capture_is_indexed(m.mode))
+    {
+        if (!vao.has_index_buffer())
+        {
+            return false;
+        }
+
+        const SL_IndexBuffer& ibo = mIbos[vao.get_index_buffer()];
+        if (!ibo.valid() || m.elementEnd > ibo.count())
+        {
+            return false;
+        }
+
+        maxVertId = 0;
+        for (size_t i = m.elementBegin; i < m.elementEnd; ++i)
+        {
+            maxVertId = math::max(maxVertId, ibo.index(i));
+        }
+    }
+
+    const SL_VertexBuffer& vbo = mVbos[vao.get_vertex_buffer()];
+
+    for (size_t i = 0; i < vao.num_bindings(); ++i)
+    {
+        const ptrdiff_t first = vao.offset(i);
+        const ptrdiff_t last  = vao.offset(i, maxVertId) + (ptrdiff_t)sl_bytes_per_vertex(vao.type(i), vao.dimensions(i));
+
+        if (first < 0 || last < first || (size_t)last > vbo.num_bytes())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+/*-------------------------------------
+ * Ensure a clear only references existing attachments
+-------------------------------------*/
+bool SL_FrameCapture::validate_clear(const SL_CaptureCommand& cmd) const noexcept
+{
+    if (cmd.fboId >= mFbos.size() || cmd.numAttachments > SL_CAPTURE_MAX_CLEAR_ATTACHMENTS)
+    {
+        return false;
+    }
+
+    const SL_CaptureFramebuffer& fbo = mFbos[cmd.fboId];
+    const bool clearsColor = cmd.type != SL_CAPTURE_CMD_CLEAR_DEPTH;
+    const bool clearsDepth = cmd.type != SL_CAPTURE_CMD_CLEAR_COLOR;
+
+    if (clearsColor && !cmd.numAttachments)
+    {
+        return false;
+    }
+
+    if (clearsDepth && (fbo.depthId == SL_CAPTURE_INVALID_ID || !mTextures[fbo.depthId].data()))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; clearsColor && i < cmd.numAttachments; ++i)
+    {
+        const uint32_t attachId = cmd.attachmentIds[i];
+
+        if (attachId >= fbo.numColors
+        || fbo.colorIds[attachId] == SL_CAPTURE_INVALID_ID
+        || !mTextures[fbo.colorIds[attachId]].data())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+/*-------------------------------------
+ * Ensure a blit reads and writes within its textures
+-------------------------------------*/
+bool SL_FrameCapture::validate_blit(const SL_CaptureCommand& cmd) const noexcept
+{
+    if (cmd.srcTextureId >= mTextures.size()
+    || (cmd.dstTextureId != SL_CAPTURE_WINDOW_ID && cmd.dstTextureId >= mTextures.size()))
+    {
+        return false;
+    }
+
+    const SL_Texture& src = mTextures[cmd.srcTextureId];
+    const uint16_t* r = cmd.srcRect;
+
+    if (!src.data() || r[0] > r[2] || r[1] > r[3] || r[2] > src.width() || r[3] > src.height())
+    {
+        return false;
+    }
+
+    uint16_t dstW = mWindowWidth;
+    uint16_t dstH = mWindowHeight;
+    SL_ColorDataType dstType = SL_COLOR_RGBA_8U; // replayed window buffers
+
+    if (cmd.dstTextureId != SL_CAPTURE_WINDOW_ID)
+    {
+        const SL_Texture& dst = mTextures[cmd.dstTextureId];
+        if (!dst.data())
+        {
+            return false;
+        }
+
+        dstType = dst.type();
+
+        dstW = dst.width();
+        dstH = dst.height();
+    }
+
+    if (!SL_BlitProcessor::is_blittable(src.type(), dstType))
+    {
+        return false;
+    }
+
+    r = cmd.dstRect;
+    return r[0] <= r[2] && r[1] <= r[3] && r[2] <= dstW && r[3] <= dstH;
+}
+
+
+
+/*-------------------------------------
+ * Validate a loaded capture
+-------------------------------------*/
+int SL_FrameCapture::validate() const noexcept
+{
+    const size_t numTextures = mTextures.size();
+
+    if (mNumContextTextures > numTextures || mNumUbos > mUniforms.size())
+    {
+        return -3;
+    }
+
+    for (const SL_CaptureUniforms& u : mUniforms)
+    {
+        if (u.uboId >= mNumUbos || (uint64_t)u.firstFixup + u.numFixups > mFixups.size())
+        {
+            return -3;
+        }
+    }
+
+    for (const SL_CaptureFixup& fixup : mFixups)
+    {
+        if (fixup.offset + sizeof(const SL_Texture*) > SL_MAX_UNIFORM_BUFFER_SIZE || fixup.textureId >= numTextures)
+        {
+            return -3;
+        }
+    }
+
+    for (const SL_CaptureShader& s : mShaders)
+    {
+        if (s.uboId != SL_CAPTURE_INVALID_ID && s.uboId >= mNumUbos)
+        {
+            return -3;
+        }
+    }
+
+    for (const SL_CaptureFramebuffer& fbo : mFbos)
+    {
+        if (fbo.numColors > SL_SHADER_MAX_FRAG_OUTPUTS || (fbo.depthId != SL_CAPTURE_INVALID_ID && fbo.depthId >= numTextures))
+        {
+            return -3;
+        }
+
+        for (uint32_t i = 0; i < fbo.numColors; ++i)
+        {
+            if (fbo.colorIds[i] != SL_CAPTURE_INVALID_ID && fbo.colorIds[i] >= numTextures)
+            {
+                return -3;
+            }
+        }
+    }
+
+    for (const SL_VertexArray& vao : mVaos)
+    {
+        if ((vao.has_vertex_buffer() && vao.get_vertex_buffer() >= mVbos.size())
+        || (vao.has_index_buffer() && vao.get_index_buffer() >= mIbos.size()))
+        {
+            return -3;
+        }
+    }
+
+    for (const SL_Mesh& m : mMeshes)
+    {
+        if (m.vaoId >= mVaos.size() || !validate_mesh(m))
+        {
+            return -3;
+        }
+    }
+
+    for (const SL_CaptureCommand& cmd : mCommands)
+    {
+        switch (cmd.type)
+        {
+            case SL_CAPTURE_CMD_DRAW:
+                if (cmd.shaderId >= mShaders.size()
+                || cmd.fboId >= mFbos.size()
+                || !cmd.numMeshes
+                || (uint64_t)cmd.firstMesh + cmd.numMeshes > mMeshes.size()
+                || (cmd.firstClipMesh != SL_CAPTURE_INVALID_ID && (uint64_t)cmd.firstClipMesh + cmd.numMeshes > mMeshes.size())
+                || (cmd.uniformsId != SL_CAPTURE_INVALID_ID && cmd.uniformsId >= mUniforms.size()))
+                {
+                    return -3;
+                }
+                break;
+
+            case SL_CAPTURE_CMD_CLEAR_COLOR:
+            case SL_CAPTURE_CMD_CLEAR_DEPTH:
+            case SL_CAPTURE_CMD_CLEAR_FRAMEBUFFER:
+                if (!validate_clear(cmd))
+                {
+                    return -3;
+                }
+                break;
+
+            case SL_CAPTURE_CMD_BLIT:
+                if (!validate_blit(cmd))
+                {
+                    return -3;
+                }
+                break;
+
+            default:
+                return -3;
+        }
+    }
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Snapshot all resources in a context
+-------------------------------------*/
+int SL_FrameCapture::begin(const SL_Context& context, const SL_CaptureTextureSlot* pTextureSlots, size_t numTextureSlots) noexcept
+{
+    if (mActive)
+    {
+        return -1;
+    }
+
+    clear();
+
+    for (size_t i = 0; i < numTextureSlots; ++i)
+    {
+        const SL_CaptureTextureSlot& slot = pTextureSlots[i];
+
+        if (slot.uboId >= context.ubos().size() || (size_t)slot.offset + sizeof(const SL_Texture*) > SL_MAX_UNIFORM_BUFFER_SIZE)
+        {
+            clear();
+            return -3;
+        }
+
+        mTextureSlots.push_back(slot);
+    }
+
+    const SL_AlignedVector<SL_Texture*>& textures = context.textures();
+    for (const SL_Texture* pTex : textures)
+    {
+        mTextures.push_back(*pTex);
+        mTexturePtrs.push_back(pTex);
+
+        if (pTex->data() && !mTextures.back().data())
+        {
+            clear();
+            return -2;
+        }
+    }
+
+    mNumContextTextures = (uint32_t)textures.size();
+
+    // Framebuffers may reference window buffers, which are not managed by
+    // the context.
+    for (const SL_Framebuffer& fbo : context.framebuffers())
+    {
+        SL_CaptureFramebuffer f;
+        f.numColors = (uint32_t)fbo.num_color_buffers();
+
+        for (uint32_t i = 0; i < f.numColors; ++i)
+        {
+            if (add_texture(fbo.get_color_buffer(i), f.colorIds[i]) != 0)
+            {
+                clear();
+                return -2;
+            }
+        }
+
+        if (add_texture(fbo.get_depth_buffer(), f.depthId) != 0)
+        {
+            clear();
+            return -2;
+        }
+
+        mFbos.push_back(f);
+    }
+
+    for (const SL_VertexArray& vao : context.vaos())
+    {
+        mVaos.push_back(vao);
+    }
+
+    // Post-transform vertices are stored in VAOs following the context's
+    mNumContextVaos = (uint32_t)mVaos.size();
+
+    for (const SL_VertexBuffer& vbo : context.vbos())
+    {
+        mVbos.push_back(vbo);
+
+        if (vbo.num_bytes() != mVbos.back().num_bytes())
+        {
+            clear();
+            return -2;
+        }
+    }
+
+    for (const SL_IndexBuffer& ibo : context.ibos())
+    {
+        mIbos.push_back(ibo);
+
+        if (ibo.num_bytes() != mIbos.back().num_bytes())
+        {
+            clear();
+            return -2;
+        }
+    }
+
+    // The initial state of each uniform buffer occupies the first snapshots
+    const SL_AlignedVector<SL_UniformBuffer>& ubos = context.ubos();
+    mNumUbos = (uint32_t)ubos.size();
+    mLatestUniforms.resize(ubos.size(), SL_CAPTURE_INVALID_ID);
+
+    for (uint32_t i = 0; i < mNumUbos; ++i)
+    {
+        add_uniforms(ubos[i], i);
+    }
+
+    for (size_t i = 0; i < context.shaders().size(); ++i)
+    {
+        add_shader(context, i);
+    }
+
+    mActive = true;
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Stop recording
+-------------------------------------*/
+void SL_FrameCapture::end() noexcept
+{
+    mActive = false;
+    mTexturePtrs.clear();
+    mTexturePtrs.shrink_to_fit();
+    mLatestUniforms.clear();
+    mLatestUniforms.shrink_to_fit();
+    mTextureSlots.clear();
+    mTextureSlots.shrink_to_fit();
+}
+
+
+
+/*-------------------------------------
+ * Record a draw call
+-------------------------------------*/
+void SL_FrameCapture::record_draw(
+    const SL_Context& context,
+    const SL_Mesh* pMeshes,
+    size_t numMeshes,
+    size_t numInstances,
+    size_t shaderId,
+    size_t fboId) noexcept
+{
+    // Resources created during a capture cannot be replayed, with the
+    // exception of shaders, which only contain configuration data.
+    if (fboId >= mFbos.size() || !numMeshes)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < numMeshes; ++i)
+    {
+        if (pMeshes[i].vaoId >= mNumContextVaos)
+        {
+            return;
+        }
+    }
+
+    while (mShaders.size() <= shaderId)
+    {
+        add_shader(context, mShaders.size());
+    }
+
+    SL_CaptureCommand cmd;
+    std::memset(&cmd, 0, sizeof(SL_CaptureCommand));
+    cmd.type         = SL_CAPTURE_CMD_DRAW;
+    cmd.shaderId     = (uint32_t)shaderId;
+    cmd.uniformsId   = SL_CAPTURE_INVALID_ID;
+    cmd.firstMesh    = (uint32_t)mMeshes.size();
+    cmd.numMeshes    = (uint32_t)numMeshes;
+    cmd.numInstances = (uint32_t)numInstances;
+    cmd.fboId        = (uint32_t)fboId;
+    record_state(context, cmd);
+
+    const uint32_t uboId = mShaders[shaderId].uboId;
+    if (uboId < mNumUbos)
+    {
+        cmd.uniformsId = add_uniforms(context.ubo(uboId), uboId);
+    }
+
+    mMeshes.insert(mMeshes.end(), pMeshes, pMeshes + numMeshes);
+    cmd.firstClipMesh = add_clip_meshes(context, pMeshes, numMeshes, numInstances, shaderId);
+    mCommands.push_back(cmd);
+}
+
+
+
+/*-------------------------------------
+ * Record a framebuffer clear
+-------------------------------------*/
+void SL_FrameCapture::record_clear(
+    const SL_Context& context,
+    SL_CaptureCommandType type,
+    size_t fboId,
+    size_t numAttachments,
+    const size_t* pAttachments,
+    const math::vec4_t<double>* pColors,
+    double depth) noexcept
+{
+    if (fboId >= mFbos.size() || numAttachments > SL_CAPTURE_MAX_CLEAR_ATTACHMENTS)
+    {
+        return;
+    }
+
+    SL_CaptureCommand cmd;
+    std::memset(&cmd, 0, sizeof(SL_CaptureCommand));
+    cmd.type           = type;
+    cmd.uniformsId     = SL_CAPTURE_INVALID_ID;
+    cmd.firstClipMesh  = SL_CAPTURE_INVALID_ID;
+    cmd.fboId          = (uint32_t)fboId;
+    cmd.numAttachments = (uint32_t)numAttachments;
+    cmd.depth          = depth;
+    record_state(context, cmd);
+
+    for (size_t i = 0; i < numAttachments; ++i)
+    {
+        cmd.attachmentIds[i] = (uint32_t)pAttachments[i];
+        cmd.colors[i][0] = pColors[i][0];
+        cmd.colors[i][1] = pColors[i][1];
+        cmd.colors[i][2] = pColors[i][2];
+        cmd.colors[i][3] = pColors[i][3];
+    }
+
+    mCommands.push_back(cmd);
+}
+
+
+
+/*-------------------------------------
+ * Record a blit between textures or into a window
+-------------------------------------*/
+void SL_FrameCapture::record_blit(
+    const SL_Context& context,
+    const SL_Texture* pSrc,
+    const SL_Texture* pDst,
+    uint16_t srcX0,
+    uint16_t srcY0,
+    uint16_t srcX1,
+    uint16_t srcY1,
+    uint16_t dstX0,
+    uint16_t dstY0,
+    uint16_t dstX1,
+    uint16_t dstY1) noexcept
+{
+    const uint32_t srcId = find_texture(pSrc);
+    if (srcId == SL_CAPTURE_INVALID_ID)
+    {
+        return;
+    }
+
+    uint32_t dstId = find_texture(pDst);
+    if (dstId == SL_CAPTURE_INVALID_ID)
+    {
+        dstId = SL_CAPTURE_WINDOW_ID;
+        mWindowWidth = dstX1 > mWindowWidth ? dstX1 : mWindowWidth;
+        mWindowHeight = dstY1 > mWindowHeight ? dstY1 : mWindowHeight;
+    }
+
+    SL_CaptureCommand cmd;
+    std::memset(&cmd, 0, sizeof(SL_CaptureCommand));
+    cmd.type         = SL_CAPTURE_CMD_BLIT;
+    cmd.firstClipMesh = SL_CAPTURE_INVALID_ID;
+    cmd.uniformsId   = SL_CAPTURE_INVALID_ID;
+    cmd.srcTextureId = srcId;
+    cmd.dstTextureId = dstId;
+    cmd.srcRect[0]   = srcX0;
+    cmd.srcRect[1]   = srcY0;
+    cmd.srcRect[2]   = srcX1;
+    cmd.srcRect[3]   = srcY1;
+    cmd.dstRect[0]   = dstX0;
+    cmd.dstRect[1]   = dstY0;
+    cmd.dstRect[2]   = dstX1;
+    cmd.dstRect[3]   = dstY1;
+    record_state(context, cmd);
+
+    mCommands.push_back(cmd);
+}
+
+
+
+/*-------------------------------------
+ * Save a capture
+-------------------------------------*/
+int SL_FrameCapture::save(const char* pFilename) const noexcept
+{
+    if (mActive || mCommands.empty())
+    {
+        return -1;
+    }
+
+    std::ofstream f{pFilename, std::ofstream::out | std::ofstream::binary};
+    if (!f.good())
+    {
+        return -2;
+    }
+
+    bool ok = _sl_write<uint32_t>(f, SL_CAPTURE_MAGIC)
+        && _sl_write<uint32_t>(f, SL_CAPTURE_VERSION)
+        && _sl_write<uint32_t>(f, (uint32_t)sizeof(SL_CaptureCommand))
+        && _sl_write<uint32_t>(f, (uint32_t)sizeof(SL_CaptureShader))
+        && _sl_write<uint32_t>(f, mNumContextTextures)
+        && _sl_write<uint32_t>(f, mNumUbos)
+        && _sl_write<uint16_t>(f, mWindowWidth)
+        && _sl_write<uint16_t>(f, mWindowHeight)
+        && _sl_write_array(f, mCommands)
+        && _sl_write_array(f, mMeshes)
+        && _sl_write_array(f, mUniforms)
+        && _sl_write_array(f, mFixups)
+        && _sl_write_array(f, mShaders)
+        && _sl_write_array(f, mFbos);
+
+    ok = ok && _sl_write<uint64_t>(f, (uint64_t)mVaos.size());
+    for (size_t i = 0; ok && i < mVaos.size(); ++i)
+    {
+        const SL_VertexArray& vao = mVaos[i];
+        const uint64_t numBindings = (uint64_t)vao.num_bindings();
+
+        ok = _sl_write<uint64_t>(f, vao.has_vertex_buffer() ? vao.get_vertex_buffer() : SL_CAPTURE_INVALID_BUFFER)
+            && _sl_write<uint64_t>(f, vao.has_index_buffer() ? vao.get_index_buffer() : SL_CAPTURE_INVALID_BUFFER)
+            && _sl_write<uint64_t>(f, numBindings);
+
+        for (uint64_t j = 0; ok && j < numBindings; ++j)
+        {
+            ok = _sl_write<int64_t>(f, (int64_t)vao.offset(j))
+                && _sl_write<int64_t>(f, (int64_t)vao.stride(j))
+                && _sl_write<uint32_t>(f, (uint32_t)vao.dimensions(j))
+                && _sl_write<uint32_t>(f, (uint32_t)vao.type(j));
+        }
+    }
+
+    ok = ok && _sl_write<uint64_t>(f, (uint64_t)mVbos.size());
+    for (size_t i = 0; ok && i < mVbos.size(); ++i)
+    {
+        const SL_VertexBuffer& vbo = mVbos[i];
+        const uint64_t numBytes = (uint64_t)vbo.num_bytes();
+
+        ok = _sl_write<uint64_t>(f, numBytes)
+            && (!numBytes || _sl_write_bytes(f, vbo.element<unsigned char>(0), numBytes));
+    }
+
+    ok = ok && _sl_write<uint64_t>(f, (uint64_t)mIbos.size());
+    for (size_t i = 0; ok && i < mIbos.size(); ++i)
+    {
+        const SL_IndexBuffer& ibo = mIbos[i];
+        const uint64_t numBytes = ibo.valid() ? (uint64_t)ibo.num_bytes() : 0;
+
+        ok = _sl_write<uint32_t>(f, (uint32_t)ibo.count())
+            && _sl_write<uint32_t>(f, (uint32_t)ibo.type())
+            && _sl_write<uint64_t>(f, numBytes)
+            && _sl_write_bytes(f, ibo.data(), numBytes);
+    }
+
+    ok = ok && _sl_write<uint64_t>(f, (uint64_t)mTextures.size());
+    for (size_t i = 0; ok && i < mTextures.size(); ++i)
+    {
+        const SL_Texture& tex = mTextures[i];
+        const uint64_t numBytes = (uint64_t)tex.num_bytes();
+
+        ok = _sl_write<uint32_t>(f, (uint32_t)tex.type())
+            && _sl_write<uint16_t>(f, tex.width())
+            && _sl_write<uint16_t>(f, tex.height())
+            && _sl_write<uint16_t>(f, tex.depth())
+            && _sl_write<uint16_t>(f, (uint16_t)tex.layout())
+            && _sl_write<uint16_t>(f, (uint16_t)tex.texel_order())
+            && _sl_write<uint64_t>(f, numBytes)
+            && _sl_write_bytes(f, tex.data(), numBytes);
+    }
+
+    f.close();
+
+    return (!ok || f.fail()) ? -3 : 0;
+}
+
+
+
+/*-------------------------------------
+ * Load a capture
+-------------------------------------*/
+int SL_FrameCapture::load(const char* pFilename) noexcept
+{
+    std::ifstream f{pFilename, std::ifstream::in | std::ifstream::binary};
+    if (!f.good())
+    {
+        return -1;
+    }
+
+    uint32_t magic, version, cmdSize, shaderSize;
+    if (!_sl_read<uint32_t>(f, magic)
+    || !_sl_read<uint32_t>(f, version)
+    || !_sl_read<uint32_t>(f, cmdSize)
+    || !_sl_read<uint32_t>(f, shaderSize))
+    {
+        return -2;
+    }
+
+    if (magic != SL_CAPTURE_MAGIC
+    || version != SL_CAPTURE_VERSION
+    || cmdSize != (uint32_t)sizeof(SL_CaptureCommand)
+    || shaderSize != (uint32_t)sizeof(SL_CaptureShader))
+    {
+        return -2;
+    }
+
+    clear();
+
+    int ret = 0;
+
+    if (!_sl_read<uint32_t>(f, mNumContextTextures)
+    || !_sl_read<uint32_t>(f, mNumUbos)
+    || !_sl_read<uint16_t>(f, mWindowWidth)
+    || !_sl_read<uint16_t>(f, mWindowHeight))
+    {
+        ret = -3;
+    }
+
+    if (ret == 0) ret = _sl_read_array(f, mCommands);
+    if (ret == 0) ret = _sl_read_array(f, mMeshes);
+    if (ret == 0) ret = _sl_read_array(f, mUniforms);
+    if (ret == 0) ret = _sl_read_array(f, mFixups);
+    if (ret == 0) ret = _sl_read_array(f, mShaders);
+    if (ret == 0) ret = _sl_read_array(f, mFbos);
+
+    uint64_t count = 0;
+
+    if (ret == 0 && !_sl_read<uint64_t>(f, count))
+    {
+        ret = -3;
+    }
+
+    for (uint64_t i = 0; ret == 0 && i < count; ++i)
+    {
+        uint64_t vboId, iboId, numBindings;
+        if (!_sl_read<uint64_t>(f, vboId) || !_sl_read<uint64_t>(f, iboId) || !_sl_read<uint64_t>(f, numBindings))
+        {
+            ret = -3;
+            break;
+        }
+
+        mVaos.emplace_back();
+        SL_VertexArray& vao = mVaos.back();
+
+        if (vboId != SL_CAPTURE_INVALID_BUFFER)
+        {
+            vao.set_vertex_buffer((size_t)vboId);
+        }
+
+        if (iboId != SL_CAPTURE_INVALID_BUFFER)
+        {
+            vao.set_index_buffer((size_t)iboId);
+        }
+
+        vao.set_num_bindings((size_t)numBindings);
+        if (vao.num_bindings() != numBindings)
+        {
+            ret = -4;
+            break;
+        }
+
+        for (uint64_t j = 0; j < numBindings; ++j)
+        {
+            int64_t offset, stride;
+            uint32_t dimens, type;
+
+            if (!_sl_read<int64_t>(f, offset)
+            || !_sl_read<int64_t>(f, stride)
+            || !_sl_read<uint32_t>(f, dimens)
+            || !_sl_read<uint32_t>(f, type))
+            {
+                ret = -3;
+                break;
+            }
+
+            vao.set_binding((size_t)j, (ptrdiff_t)offset, (ptrdiff_t)stride, (SL_Dimension)dimens, (SL_DataType)type);
+        }
+    }
+
+    if (ret == 0 && !_sl_read<uint64_t>(f, count))
+    {
+        ret = -3;
+    }
+
+    for (uint64_t i = 0; ret == 0 && i < count; ++i)
+    {
+        uint64_t numBytes;
+        if (!_sl_read<uint64_t>(f, numBytes))
+        {
+            ret = -3;
+            break;
+        }
+
+        mVbos.emplace_back();
+        SL_VertexBuffer& vbo = mVbos.back();
+
+        if (numBytes)
+        {
+            if (vbo.init((size_t)numBytes) != 0)
+            {
+                ret = -4;
+            }
+            else if (!_sl_read_bytes(f, vbo.element<unsigned char>(0), (size_t)numBytes))
+            {
+                ret = -3;
+            }
+        }
+    }
+
+    if (ret == 0 && !_sl_read<uint64_t>(f, count))
+    {
+        ret = -3;
+    }
+
+    for (uint64_t i = 0; ret == 0 && i < count; ++i)
+    {
+        uint32_t numElements, type;
+        uint64_t numBytes;
+        if (!_sl_read<uint32_t>(f, numElements) || !_sl_read<uint32_t>(f, type) || !_sl_read<uint64_t>(f, numBytes))
+        {
+            ret = -3;
+            break;
+        }
+
+        mIbos.emplace_back();
+        SL_IndexBuffer& ibo = mIbos.back();
+
+        if (numBytes)
+        {
+            if (ibo.init(numElements, (SL_DataType)type) != 0)
+            {
+                ret = -4;
+            }
+            else if (ibo.num_bytes() != numBytes || !_sl_read_bytes(f, ibo.data(), (size_t)numBytes))
+            {
+                ret = -3;
+            }
+        }
+    }
+
+    if (ret == 0 && !_sl_read<uint64_t>(f, count))
+    {
+        ret = -3;
+    }
+
+    for (uint64_t i = 0; ret == 0 && i < count; ++i)
+    {
+        uint32_t type;
+        uint16_t w, h, d, layout, texelOrder;
+        uint64_t numBytes;
+
+        if (!_sl_read<uint32_t>(f, type)
+        || !_sl_read<uint16_t>(f, w)
+        || !_sl_read<uint16_t>(f, h)
+        || !_sl_read<uint16_t>(f, d)
+        || !_sl_read<uint16_t>(f, layout)
+        || !_sl_read<uint16_t>(f, texelOrder)
+        || !_sl_read<uint64_t>(f, numBytes))
+        {
+            ret = -3;
+            break;
+        }
+
+        mTextures.emplace_back();
+        SL_Texture& tex = mTextures.back();
+
+        if (!numBytes)
+        {
+            continue;
+        }
+
+        int initErr;
+        switch (layout)
+        {
+            case SL_TEX_LAYOUT_CUBE:
+                initErr = tex.init_cube((SL_ColorDataType)type, w);
+                break;
+
+            case SL_TEX_LAYOUT_ARRAY:
+                initErr = tex.init_array((SL_ColorDataType)type, w, h, d);
+                break;
+
+            default:
+                initErr = tex.init((SL_ColorDataType)type, w, h, d, (SL_TexelOrder)texelOrder);
+                break;
+        }
+
+        if (initErr != 0)
+        {
+            ret = -4;
+        }
+        else if (tex.num_bytes() != numBytes
+        || (uint16_t)tex.texel_order() != texelOrder
+        || !_sl_read_bytes(f, tex.data(), (size_t)numBytes))
+        {
+            ret = -3;
+        }
+    }
+
+    if (ret == 0)
+    {
+        ret = validate();
+    }
+
+    if (ret != 0)
+    {
+        clear();
+    }
+
+    return ret;
+}
+
+
+
+/*-------------------------------------
+ * Recreate the captured resources
+-------------------------------------*/
+int SL_FrameCapture::instantiate(SL_Context& context, const SL_CaptureShaderFuncs* pShaders, size_t numShaders) const noexcept
+{
+    if (!context.textures().empty()
+    || !context.framebuffers().empty()
+    || !context.vaos().empty()
+    || !context.vbos().empty()
+    || !context.ibos().empty()
+    || !context.ubos().empty()
+    || !context.shaders().empty())
+    {
+        return -1;
+    }
+
+    for (const SL_Texture& t : mTextures)
+    {
+        SL_Texture& tex = context.texture(context.create_texture());
+
+        if (t.data())
+        {
+            tex = t;
+            if (!tex.data())
+            {
+                return -2;
+            }
+        }
+    }
+
+    // Window blits are redirected to the last texture
+    if (mWindowWidth && mWindowHeight)
+    {
+        SL_Texture& tex = context.texture(context.create_texture());
+        if (tex.init(SL_COLOR_RGBA_8U, mWindowWidth, mWindowHeight, 1) != 0)
+        {
+            return -2;
+        }
+    }
+
+    for (const SL_VertexBuffer& v : mVbos)
+    {
+        SL_VertexBuffer& vbo = context.vbo(context.create_vbo());
+        vbo = v;
+
+        if (vbo.num_bytes() != v.num_bytes())
+        {
+            return -3;
+        }
+    }
+
+    for (const SL_IndexBuffer& i : mIbos)
+    {
+        SL_IndexBuffer& ibo = context.ibo(context.create_ibo());
+        ibo = i;
+
+        if (ibo.num_bytes() != i.num_bytes())
+        {
+            return -3;
+        }
+    }
+
+    for (const SL_VertexArray& v : mVaos)
+    {
+        SL_VertexArray& vao = context.vao(context.create_vao());
+        vao = v;
+
+        if (vao.num_bindings() != v.num_bindings())
+        {
+            return -3;
+        }
+    }
+
+    // Uniform buffers must all exist before shaders reference them
+    for (uint32_t i = 0; i < mNumUbos; ++i)
+    {
+        context.create_ubo();
+    }
+
+    for (uint32_t i = 0; i < mNumUbos; ++i)
+    {
+        apply_uniforms(context, i);
+    }
+
+    for (const SL_CaptureFramebuffer& f : mFbos)
+    {
+        SL_Framebuffer& fbo = context.framebuffer(context.create_framebuffer());
+
+        if (f.numColors && fbo.reserve_color_buffers(f.numColors) != 0)
+        {
+            return -3;
+        }
+
+        for (uint32_t i = 0; i < f.numColors; ++i)
+        {
+            if (f.colorIds[i] != SL_CAPTURE_INVALID_ID && fbo.attach_color_buffer(i, context.texture(f.colorIds[i])) != 0)
+            {
+                return -3;
+            }
+        }
+
+        if (f.depthId != SL_CAPTURE_INVALID_ID && fbo.attach_depth_buffer(context.texture(f.depthId)) != 0)
+        {
+            return -3;
+        }
+    }
+
+    for (size_t i = 0; i < mShaders.size(); ++i)
+    {
+        const SL_CaptureShader& s = mShaders[i];
+        const bool haveFuncs = pShaders && i < numShaders;
+
+        SL_VertexShader vertShader;
+        vertShader.numVaryings = s.vertNumVaryings;
+        vertShader.cullMode    = s.cullMode;
+        vertShader.shader      = (haveFuncs && pShaders[i].vertShader) ? pShaders[i].vertShader : &_sl_capture_vert_shader;
+
+        SL_FragmentShader fragShader;
+        fragShader.numVaryings = s.fragNumVaryings;
+        fragShader.numOutputs  = s.numOutputs;
+        fragShader.blend       = s.blend;
+        fragShader.depthTest   = s.depthTest;
+        fragShader.depthMask   = s.depthMask;
+        fragShader.shader      = (haveFuncs && pShaders[i].fragShader) ? pShaders[i].fragShader : &_sl_capture_frag_shader;
+
+        const size_t shaderId = (s.uboId != SL_CAPTURE_INVALID_ID)
+            ? context.create_shader(vertShader, fragShader, s.uboId)
+            : context.create_shader(vertShader, fragShader);
+
+        if (shaderId == (size_t)-1)
+        {
+            return -3;
+        }
+    }
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Execute all recorded commands
+-------------------------------------*/
+void SL_FrameCapture::replay(SL_Context& context) const noexcept
+{
+    SL_ViewportState& viewState = context.viewport_state();
+    const size_t windowId = mTextures.size();
+
+    for (const SL_CaptureCommand& cmd : mCommands)
+    {
+        viewState.viewport(cmd.viewport[0], cmd.viewport[1], (uint16_t)cmd.viewport[2], (uint16_t)cmd.viewport[3]);
+        viewState.scissor(cmd.scissor[0], cmd.scissor[1], (uint16_t)cmd.scissor[2], (uint16_t)cmd.scissor[3]);
+
+        const math::vec4_t<double> colors[SL_CAPTURE_MAX_CLEAR_ATTACHMENTS] = {
+            math::vec4_t<double>{cmd.colors[0][0], cmd.colors[0][1], cmd.colors[0][2], cmd.colors[0][3]},
+            math::vec4_t<double>{cmd.colors[1][0], cmd.colors[1][1], cmd.colors[1][2], cmd.colors[1][3]},
+            math::vec4_t<double>{cmd.colors[2][0], cmd.colors[2][1], cmd.colors[2][2], cmd.colors[2][3]},
+            math::vec4_t<double>{cmd.colors[3][0], cmd.colors[3][1], cmd.colors[3][2], cmd.colors[3][3]}
+        };
+        const uint32_t* ids = cmd.attachmentIds;
+
+        switch (cmd.type)
+        {
+            case SL_CAPTURE_CMD_DRAW:
+            {
+                // Replacement shaders read post-transform vertices, which
+                // already contain every instance.
+                const bool clipSpace = context.shader(cmd.shaderId).vertex_shader().shader == &_sl_capture_vert_shader;
+                if (clipSpace && cmd.firstClipMesh == SL_CAPTURE_INVALID_ID)
+                {
+                    break;
+                }
+
+                const SL_Mesh* pMeshes = mMeshes.data() + (clipSpace ? cmd.firstClipMesh : cmd.firstMesh);
+
+                if (cmd.uniformsId != SL_CAPTURE_INVALID_ID)
+                {
+                    apply_uniforms(context, cmd.uniformsId);
+                }
+
+                if (cmd.numMeshes > 1)
+                {
+                    context.draw_multiple(pMeshes, cmd.numMeshes, cmd.shaderId, cmd.fboId);
+                }
+                else
+                {
+                    context.draw_instanced(*pMeshes, clipSpace ? 1 : cmd.numInstances, cmd.shaderId, cmd.fboId);
+                }
+                break;
+            }
+
+            case SL_CAPTURE_CMD_CLEAR_COLOR:
+                context.clear_color_buffer(cmd.fboId, ids[0], colors[0]);
+                break;
+
+            case SL_CAPTURE_CMD_CLEAR_DEPTH:
+                context.clear_depth_buffer(cmd.fboId, cmd.depth);
+                break;
+
+            case SL_CAPTURE_CMD_CLEAR_FRAMEBUFFER:
+                switch (cmd.numAttachments)
+                {
+                    case 1:
+                        context.clear_framebuffer(cmd.fboId, ids[0], colors[0], cmd.depth);
+                        break;
+
+                    case 2:
+                        context.clear_framebuffer(cmd.fboId, std::array<size_t, 2>{ids[0], ids[1]}, std::array<math::vec4_t<double>, 2>{colors[0], colors[1]}, cmd.depth);
+                        break;
+
+                    case 3:
+                        context.clear_framebuffer(cmd.fboId, std::array<size_t, 3>{ids[0], ids[1], ids[2]}, std::array<math::vec4_t<double>, 3>{colors[0], colors[1], colors[2]}, cmd.depth);
+                        break;
+
+                    case 4:
+                        context.clear_framebuffer(cmd.fboId, std::array<size_t, 4>{ids[0], ids[1], ids[2], ids[3]}, std::array<math::vec4_t<double>, 4>{colors[0], colors[1], colors[2], colors[3]}, cmd.depth);
+                        break;
+
+                    default:
+                        break;
+                }
+                break;
+
+            case SL_CAPTURE_CMD_BLIT:
+                context.blit(
+                    cmd.dstTextureId == SL_CAPTURE_WINDOW_ID ? windowId : (size_t)cmd.dstTextureId,
+                    cmd.srcTextureId,
+                    cmd.srcRect[0],
+                    cmd.srcRect[1],
+                    cmd.srcRect[2],
+                    cmd.srcRect[3],
+                    cmd.dstRect[0],
+                    cmd.dstRect[1],
+                    cmd.dstRect[2],
+                    cmd.dstRect[3]);
+                break;
+        }
+    }
+}
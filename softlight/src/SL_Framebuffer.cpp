@@ -1,11 +1,17 @@
 
 #include "lightsky/setup/Compiler.h" // LS_COMPILER_MSC
 
+#include "lightsky/utils/Assertions.h" // LS_DEBUG_ASSERT
+
 #include "softlight/SL_Color.hpp"
+#include "softlight/SL_ColorSRGB.hpp"
+#include "softlight/SL_CompositeProcessor.hpp" // SL_OITAttachment
 
 #include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_PackedColor.hpp"
 #include "softlight/SL_PipelineState.hpp" // SL_BlendMode
 #include "softlight/SL_Shader.hpp" // SL_FragmentParam
+#include "softlight/SL_WindowBuffer.hpp"
 
 namespace math = ls::math;
 
@@ -24,8 +30,7 @@ namespace
 -------------------------------------*/
 template <typename color_type>
 inline void assign_pixel(
-    uint16_t x,
-    uint16_t y,
+    ptrdiff_t index,
     const math::vec4& rgba,
     SL_Texture* pTexture) noexcept
 {
@@ -33,7 +38,7 @@ inline void assign_pixel(
     typedef typename color_type::value_type ConvertedType;
 
     // Get a reference to the source texel
-    void* const outTexel = pTexture->texel_pointer<color_type>(x, y);
+    void* const outTexel = &pTexture->raw_texel<color_type>(index);
 
     union
     {
@@ -61,13 +66,12 @@ inline void assign_pixel(
 #if defined(LS_ARCH_X86)
 template <>
 inline void assign_pixel<SL_ColorRGBA8>(
-    uint16_t x,
-    uint16_t y,
+    ptrdiff_t index,
     const math::vec4& rgba,
     SL_Texture* pTexture) noexcept
 {
     // Get a reference to the source texel
-    int32_t* const  outTexel = pTexture->texel_pointer<int32_t>(x, y);
+    int32_t* const  outTexel = &pTexture->raw_texel<int32_t>(index);
     SL_ColorRGBA8&& inTexel  = color_cast<uint8_t, float>(rgba);
 
     _mm_stream_si32(outTexel, reinterpret_cast<int32_t&>(inTexel));
@@ -78,8 +82,7 @@ inline void assign_pixel<SL_ColorRGBA8>(
 
 template <>
 inline void assign_pixel<SL_ColorRGBA16>(
-    uint16_t x,
-    uint16_t y,
+    ptrdiff_t index,
     const math::vec4& rgba,
     SL_Texture* pTexture) noexcept
 {
@@ -87,7 +90,7 @@ inline void assign_pixel<SL_ColorRGBA16>(
 
     // MSVConly supports __m64 on 32-bit builds
     #if defined(LS_COMPILER_MSC) && LS_ARCH_X86 >= 64
-        __int64* const outTexel = pTexture->texel_pointer<__int64>(x, y);
+        __int64* const outTexel = &pTexture->raw_texel<__int64>(index);
 
         union
         {
@@ -97,7 +100,7 @@ inline void assign_pixel<SL_ColorRGBA16>(
     
         _mm_stream_si64(outTexel, inTexel.scalar);
     #else
-        __m64* const outTexel = pTexture->texel_pointer<__m64>(x, y);
+        __m64* const outTexel = &pTexture->raw_texel<__m64>(index);
     
         union
         {
@@ -114,13 +117,12 @@ inline void assign_pixel<SL_ColorRGBA16>(
 
 template <>
 inline void assign_pixel<SL_ColorRGBAf>(
-    uint16_t x,
-    uint16_t y,
+    ptrdiff_t index,
     const math::vec4& rgba,
     SL_Texture* pTexture) noexcept
 {
     // Get a reference to the source texel
-    SL_ColorRGBAf* const outTexel = pTexture->texel_pointer<SL_ColorRGBAf>(x, y);
+    SL_ColorRGBAf* const outTexel = &pTexture->raw_texel<SL_ColorRGBAf>(index);
 
     _mm_stream_ps(reinterpret_cast<float*>(outTexel), _mm_load_ps(&rgba));
 }
@@ -130,13 +132,12 @@ inline void assign_pixel<SL_ColorRGBAf>(
 #elif defined(LS_ARM_NEON)
 template <>
 inline void assign_pixel<SL_ColorRGBA8>(
-    uint16_t x,
-    uint16_t y,
+    ptrdiff_t index,
     const math::vec4& rgba,
     SL_Texture* pTexture) noexcept
 {
     // Get a reference to the source texel
-    uint32_t* const outTexel = pTexture->texel_pointer<uint32_t>(x, y);
+    uint32_t* const outTexel = &pTexture->raw_texel<uint32_t>(index);
 
     #if defined(LS_ARCH_AARCH64)
         const uint32x4_t color32 = vcvtq_u32_f32(vmulq_n_f32(rgba.simd, 255.f));
@@ -152,13 +153,12 @@ inline void assign_pixel<SL_ColorRGBA8>(
 
 template <>
 inline void assign_pixel<SL_ColorRGBA16>(
-    uint16_t x,
-    uint16_t y,
+    ptrdiff_t index,
     const math::vec4& rgba,
     SL_Texture* pTexture) noexcept
 {
     // Get a reference to the source texel
-    int64_t* const outTexel = pTexture->texel_pointer<int64_t>(x, y);
+    int64_t* const outTexel = &pTexture->raw_texel<int64_t>(index);
 
     #if defined(LS_ARCH_AARCH64)
         const uint32x4_t color32 = vcvtq_u32_f32(vmulq_n_f32(rgba.simd, 65536.f));
@@ -173,13 +173,50 @@ inline void assign_pixel<SL_ColorRGBA16>(
 
 
 
+/*-------------------------------------
+ * Blend a source color with a destination color
+-------------------------------------*/
+inline math::vec4 blend_pixel(
+    const math::vec4& s,
+    math::vec4 d,
+    const SL_BlendMode blendMode) noexcept
+{
+    // This method of blending uses premultiplied alpha. I will need to support
+    // configurable blend modes later.
+    const math::vec4 srcAlpha = s[3];
+    const math::vec4&& modulation = math::vec4{1.f - s[3]};
+
+    if (blendMode == SL_BLEND_ALPHA)
+    {
+        const math::vec4&& dstMod = modulation * d[3];
+        const float dstAlpha = dstMod[3] + srcAlpha[3];
+        d = math::fmadd(s, srcAlpha, (d * dstMod)) * math::rcp(dstAlpha);
+        d[3] = dstAlpha;
+    }
+    else if (blendMode == SL_BLEND_PREMULTIPLED_ALPHA)
+    {
+        d = math::fmadd(d, modulation, s);
+    }
+    else if (blendMode == SL_BLEND_ADDITIVE)
+    {
+        d = math::fmadd(s, srcAlpha, d);
+    }
+    else if (blendMode == SL_BLEND_SCREEN)
+    {
+        d = (s*srcAlpha) + (d*modulation);
+    }
+
+    return d;
+}
+
+
+
 /*-------------------------------------
  * Place an alpha-blended pixel onto a texture
 -------------------------------------*/
 template <typename color_type>
 inline void assign_alpha_pixel(
-    uint16_t x,
-    uint16_t y,
+    ptrdiff_t index,
     const math::vec4& rgba,
     SL_Texture* pTexture,
     const SL_BlendMode blendMode) noexcept
@@ -188,7 +225,7 @@ inline void assign_alpha_pixel(
     typedef typename color_type::value_type ConvertedType;
 
     // Get a reference to the source texel
-    void* const outTexel = pTexture->texel_pointer<color_type>(x, y);
+    void* const outTexel = &pTexture->raw_texel<color_type>(index);
 
     // sample the source texel
     union DestColor
@@ -217,30 +254,7 @@ inline void assign_alpha_pixel(
             break;
     }
 
-    // This method of blending uses premultiplied alpha. I will need to support
-    // configurable blend modes later.
-    const math::vec4 srcAlpha = rgba[3];
-    const math::vec4&& modulation = math::vec4{1.f - rgba[3]};
-
-    if (blendMode == SL_BLEND_ALPHA)
-    {
-        const math::vec4&& dstMod = modulation * d.rgba[3];
-        d.rgba[3] = dstMod[3] + srcAlpha[3];
-        d.rgb = math::vec3_cast(math::fmadd(s.rgba, srcAlpha, (d.rgba * dstMod)) * math::rcp(d.rgba[3]));
-    }
-    else if (blendMode == SL_BLEND_PREMULTIPLED_ALPHA)
-    {
-        d.rgba = math::fmadd(d.rgba, modulation, s.rgba);
-    }
-    else if (blendMode == SL_BLEND_ADDITIVE)
-    {
-        d.rgba = math::fmadd(s.rgba, srcAlpha, d.rgba);
-    }
-    else if (blendMode == SL_BLEND_SCREEN)
-    {
-        d.rgba = (s.rgba*srcAlpha) + (d.rgba*modulation);
-    }
-
+    d.rgba = blend_pixel(s.rgba, d.rgba, blendMode);
     d.rgba = math::clamp(d.rgba, math::vec4{0.f, 0.f, 0.f, 0.f}, math::vec4{1.f, 1.f, 1.f, 1.f});
 
     switch (color_type::num_components())
@@ -265,6 +279,230 @@ inline void assign_alpha_pixel(
 
 
 
+/*-------------------------------------
+ * Place a single half-float pixel onto a texture
+-------------------------------------*/
+template <typename color_type>
+inline void assign_half_pixel(
+    ptrdiff_t index,
+    const math::vec4& rgba,
+    SL_Texture* pTexture) noexcept
+{
+    math::half* const outTexel = reinterpret_cast<math::half*>(&pTexture->raw_texel<color_type>(index));
+    sl_store_half_color<color_type::num_components()>(outTexel, rgba);
+}
+
+
+
+/*-------------------------------------
+ * Place an alpha-blended half-float pixel onto a texture
+-------------------------------------*/
+template <typename color_type>
+inline void assign_alpha_half_pixel(
+    ptrdiff_t index,
+    const math::vec4& rgba,
+    SL_Texture* pTexture,
+    const SL_BlendMode blendMode) noexcept
+{
+    math::half* const outTexel = reinterpret_cast<math::half*>(&pTexture->raw_texel<color_type>(index));
+
+    // HDR colors are only clamped to 0 so values above 1 are preserved.
+    const math::vec4&& d = blend_pixel(rgba, sl_load_half_color<color_type::num_components()>(outTexel), blendMode);
+
+    sl_store_half_color<color_type::num_components()>(outTexel, math::max(d, math::vec4{0.f}));
+}
+
+
+
+/*-------------------------------------
+ * Place a single packed pixel onto a texture
+-------------------------------------*/
+template <class packed_color>
+inline void assign_packed_pixel(
+    ptrdiff_t index,
+    const math::vec4& rgba,
+    SL_Texture* pTexture) noexcept
+{
+    pTexture->raw_texel<typename packed_color::packed_type>(index) = packed_color::pack(rgba);
+}
+
+
+
+/*-------------------------------------
+ * Place an alpha-blended packed pixel onto a texture
+-------------------------------------*/
+template <class packed_color>
+inline void assign_alpha_packed_pixel(
+    ptrdiff_t index,
+    const math::vec4& rgba,
+    SL_Texture* pTexture,
+    const SL_BlendMode blendMode) noexcept
+{
+    typename packed_color::packed_type& outTexel = pTexture->raw_texel<typename packed_color::packed_type>(index);
+
+    // Packing clamps each channel to its representable range
+    outTexel = packed_color::pack(blend_pixel(rgba, packed_color::unpack(outTexel), blendMode));
+}
+
+
+
+/*-------------------------------------
+ * Encode a pixel into sRGB and place it onto a texture
+-------------------------------------*/
+template <typename color_type>
+inline void assign_srgb_pixel(
+    ptrdiff_t index,
+    const math::vec4& rgba,
+    SL_Texture* pTexture) noexcept
+{
+    const SL_ColorRGBA8&& srgb = sl_linear_to_srgb(rgba);
+    pTexture->raw_texel<color_type>(index) = *reinterpret_cast<const color_type*>(&srgb);
+}
+
+
+
+/*-------------------------------------
+ * Place an alpha-blended sRGB pixel onto a texture. Blending happens in
+ * linear space.
+-------------------------------------*/
+template <typename color_type>
+inline void assign_alpha_srgb_pixel(
+    ptrdiff_t index,
+    const math::vec4& rgba,
+    SL_Texture* pTexture,
+    const SL_BlendMode blendMode) noexcept
+{
+    color_type& outTexel = pTexture->raw_texel<color_type>(index);
+
+    const SL_ColorRGBA8&& srgb = sl_linear_to_srgb(blend_pixel(rgba, sl_srgb_to_linear(outTexel), blendMode));
+    outTexel = *reinterpret_cast<const color_type*>(&srgb);
+}
+
+
+
+/*-------------------------------------
+ * Place a pixel onto a texture of any color type
+-------------------------------------*/
+inline void assign_texel(
+    ptrdiff_t index,
+    const math::vec4& rgba,
+    SL_Texture* pTexture) noexcept
+{
+    const SL_ColorDataType type = pTexture->type();
+
+    switch (type)
+    {
+        case SL_COLOR_R_8U:        assign_pixel<SL_ColorR8>(index, rgba, pTexture); break;
+        case SL_COLOR_RG_8U:       assign_pixel<SL_ColorRG8>(index, rgba, pTexture); break;
+        case SL_COLOR_RGB_8U:      assign_pixel<SL_ColorRGB8>(index, rgba, pTexture); break;
+        case SL_COLOR_RGBA_8U:     assign_pixel<SL_ColorRGBA8>(index, rgba, pTexture); break;
+
+        case SL_COLOR_R_16U:       assign_pixel<SL_ColorR16>(index, rgba, pTexture); break;
+        case SL_COLOR_RG_16U:      assign_pixel<SL_ColorRG16>(index, rgba, pTexture); break;
+        case SL_COLOR_RGB_16U:     assign_pixel<SL_ColorRGB16>(index, rgba, pTexture); break;
+        case SL_COLOR_RGBA_16U:    assign_pixel<SL_ColorRGBA16>(index, rgba, pTexture); break;
+
+        case SL_COLOR_R_32U:       assign_pixel<SL_ColorR32>(index, rgba, pTexture); break;
+        case SL_COLOR_RG_32U:      assign_pixel<SL_ColorRG32>(index, rgba, pTexture); break;
+        case SL_COLOR_RGB_32U:     assign_pixel<SL_ColorRGB32>(index, rgba, pTexture); break;
+        case SL_COLOR_RGBA_32U:    assign_pixel<SL_ColorRGBA32>(index, rgba, pTexture); break;
+
+        case SL_COLOR_R_64U:       assign_pixel<SL_ColorR64>(index, rgba, pTexture); break;
+        case SL_COLOR_RG_64U:      assign_pixel<SL_ColorRG64>(index, rgba, pTexture); break;
+        case SL_COLOR_RGB_64U:     assign_pixel<SL_ColorRGB64>(index, rgba, pTexture); break;
+        case SL_COLOR_RGBA_64U:    assign_pixel<SL_ColorRGBA64>(index, rgba, pTexture); break;
+
+        case SL_COLOR_R_HALF:      assign_half_pixel<SL_ColorRh>(index, rgba, pTexture); break;
+        case SL_COLOR_RG_HALF:     assign_half_pixel<SL_ColorRGh>(index, rgba, pTexture); break;
+        case SL_COLOR_RGB_HALF:    assign_half_pixel<SL_ColorRGBh>(index, rgba, pTexture); break;
+        case SL_COLOR_RGBA_HALF:   assign_half_pixel<SL_ColorRGBAh>(index, rgba, pTexture); break;
+
+        case SL_COLOR_R_FLOAT:     assign_pixel<SL_ColorRf>(index, rgba, pTexture); break;
+        case SL_COLOR_RG_FLOAT:    assign_pixel<SL_ColorRGf>(index, rgba, pTexture); break;
+        case SL_COLOR_RGB_FLOAT:   assign_pixel<SL_ColorRGBf>(index, rgba, pTexture); break;
+        case SL_COLOR_RGBA_FLOAT:  assign_pixel<SL_ColorRGBAf>(index, rgba, pTexture); break;
+
+        case SL_COLOR_R_DOUBLE:    assign_pixel<SL_ColorRd>(index, rgba, pTexture); break;
+        case SL_COLOR_RG_DOUBLE:   assign_pixel<SL_ColorRGd>(index, rgba, pTexture); break;
+        case SL_COLOR_RGB_DOUBLE:  assign_pixel<SL_ColorRGBd>(index, rgba, pTexture); break;
+        case SL_COLOR_RGBA_DOUBLE: assign_pixel<SL_ColorRGBAd>(index, rgba, pTexture); break;
+
+        case SL_COLOR_RGB_565:         assign_packed_pixel<SL_PackedColorRGB565>(index, rgba, pTexture); break;
+        case SL_COLOR_RGB10_A2:        assign_packed_pixel<SL_PackedColorRGB10A2>(index, rgba, pTexture); break;
+        case SL_COLOR_R11G11B10_FLOAT: assign_packed_pixel<SL_PackedColorR11G11B10F>(index, rgba, pTexture); break;
+
+        case SL_COLOR_SRGB_8U:         assign_srgb_pixel<SL_ColorRGB8>(index, rgba, pTexture); break;
+        case SL_COLOR_SRGBA_8U:        assign_srgb_pixel<SL_ColorRGBA8>(index, rgba, pTexture); break;
+
+        default:
+            LS_UNREACHABLE();
+    }
+}
+
+
+
+/*-------------------------------------
+ * Place an alpha-blended pixel onto a texture of any color type
+-------------------------------------*/
+inline void assign_alpha_texel(
+    ptrdiff_t index,
+    const math::vec4& rgba,
+    SL_Texture* pTexture,
+    const SL_BlendMode blendMode) noexcept
+{
+    const SL_ColorDataType type = pTexture->type();
+
+    switch (type)
+    {
+        case SL_COLOR_R_8U:        assign_alpha_pixel<SL_ColorR8>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RG_8U:       assign_alpha_pixel<SL_ColorRG8>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RGB_8U:      assign_alpha_pixel<SL_ColorRGB8>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RGBA_8U:     assign_alpha_pixel<SL_ColorRGBA8>(index, rgba, pTexture, blendMode); break;
+
+        case SL_COLOR_R_16U:       assign_alpha_pixel<SL_ColorR16>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RG_16U:      assign_alpha_pixel<SL_ColorRG16>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RGB_16U:     assign_alpha_pixel<SL_ColorRGB16>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RGBA_16U:    assign_alpha_pixel<SL_ColorRGBA16>(index, rgba, pTexture, blendMode); break;
+
+        case SL_COLOR_R_32U:       assign_alpha_pixel<SL_ColorR32>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RG_32U:      assign_alpha_pixel<SL_ColorRG32>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RGB_32U:     assign_alpha_pixel<SL_ColorRGB32>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RGBA_32U:    assign_alpha_pixel<SL_ColorRGBA32>(index, rgba, pTexture, blendMode); break;
+
+        case SL_COLOR_R_64U:       assign_alpha_pixel<SL_ColorR64>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RG_64U:      assign_alpha_pixel<SL_ColorRG64>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RGB_64U:     assign_alpha_pixel<SL_ColorRGB64>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RGBA_64U:    assign_alpha_pixel<SL_ColorRGBA64>(index, rgba, pTexture, blendMode); break;
+
+        case SL_COLOR_R_HALF:      assign_alpha_half_pixel<SL_ColorRh>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RG_HALF:     assign_alpha_half_pixel<SL_ColorRGh>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RGB_HALF:    assign_alpha_half_pixel<SL_ColorRGBh>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RGBA_HALF:   assign_alpha_half_pixel<SL_ColorRGBAh>(index, rgba, pTexture, blendMode); break;
+
+        case SL_COLOR_R_FLOAT:     assign_alpha_pixel<SL_ColorRf>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RG_FLOAT:    assign_alpha_pixel<SL_ColorRGf>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RGB_FLOAT:   assign_alpha_pixel<SL_ColorRGBf>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RGBA_FLOAT:  assign_alpha_pixel<SL_ColorRGBAf>(index, rgba, pTexture, blendMode); break;
+
+        case SL_COLOR_R_DOUBLE:    assign_alpha_pixel<SL_ColorRd>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RG_DOUBLE:   assign_alpha_pixel<SL_ColorRGd>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RGB_DOUBLE:  assign_alpha_pixel<SL_ColorRGBd>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RGBA_DOUBLE: assign_alpha_pixel<SL_ColorRGBAd>(index, rgba, pTexture, blendMode); break;
+
+        case SL_COLOR_RGB_565:         assign_alpha_packed_pixel<SL_PackedColorRGB565>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_RGB10_A2:        assign_alpha_packed_pixel<SL_PackedColorRGB10A2>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_R11G11B10_FLOAT: assign_alpha_packed_pixel<SL_PackedColorR11G11B10F>(index, rgba, pTexture, blendMode); break;
+
+        case SL_COLOR_SRGB_8U:         assign_alpha_srgb_pixel<SL_ColorRGB8>(index, rgba, pTexture, blendMode); break;
+        case SL_COLOR_SRGBA_8U:        assign_alpha_srgb_pixel<SL_ColorRGBA8>(index, rgba, pTexture, blendMode); break;
+
+        default:
+            LS_UNREACHABLE();
+    }
+}
+
+
+
 } // end anonymous namespace
 
 
@@ -289,7 +527,10 @@ SL_Framebuffer::~SL_Framebuffer() noexcept
 SL_Framebuffer::SL_Framebuffer() noexcept :
     mNumColors{0},
     mColors{nullptr},
-    mDepth{nullptr}
+    mDepth{nullptr},
+    mDamage{},
+    mDepthNear{-1.f},
+    mDepthFar{1.f}
 {}
 
 
@@ -311,11 +552,15 @@ SL_Framebuffer::SL_Framebuffer(const SL_Framebuffer& r) noexcept :
 SL_Framebuffer::SL_Framebuffer(SL_Framebuffer&& f) noexcept :
     mNumColors{f.mNumColors},
     mColors{f.mColors},
-    mDepth{f.mDepth}
+    mDepth{f.mDepth},
+    mDamage{f.mDamage},
+    mDepthNear{f.mDepthNear},
+    mDepthFar{f.mDepthFar}
 {
     f.mNumColors = 0;
     f.mColors = nullptr;
     f.mDepth = nullptr;
+    f.mDamage.clear();
 
 }
 
@@ -333,6 +578,9 @@ SL_Framebuffer& SL_Framebuffer::operator=(const SL_Framebuffer& f) noexcept
 
     terminate();
 
+    mDepthNear = f.mDepthNear;
+    mDepthFar = f.mDepthFar;
+
     if (f.mNumColors)
     {
         SL_Texture** pTextures = new SL_Texture*[f.mNumColors];
@@ -350,6 +598,7 @@ SL_Framebuffer& SL_Framebuffer::operator=(const SL_Framebuffer& f) noexcept
         mNumColors = f.mNumColors;
         mColors = pTextures;
         mDepth = f.mDepth;
+        mDamage = f.mDamage;
     }
 
     return *this;
@@ -378,6 +627,12 @@ SL_Framebuffer& SL_Framebuffer::operator=(SL_Framebuffer&& f) noexcept
     mDepth = f.mDepth;
     f.mDepth = nullptr;
 
+    mDamage = f.mDamage;
+    f.mDamage.clear();
+
+    mDepthNear = f.mDepthNear;
+    mDepthFar = f.mDepthFar;
+
     return *this;
 }
 
@@ -461,6 +716,22 @@ int SL_Framebuffer::attach_color_buffer(uint64_t index, SL_Texture& t) noexcept
 
 
 
+/*-------------------------------------
+ * Alias a window's backbuffer as a color attachment
+-------------------------------------*/
+int SL_Framebuffer::attach_color_buffer(uint64_t index, SL_WindowBuffer& w) noexcept
+{
+    // The backbuffer must be initialized so its shared memory exists
+    if (w.texture().data() == nullptr)
+    {
+        return -4;
+    }
+
+    return attach_color_buffer(index, w.texture());
+}
+
+
+
 /*-------------------------------------
  *
 -------------------------------------*/
@@ -551,6 +822,7 @@ int SL_Framebuffer::valid() const noexcept
     uint16_t width = mColors[0]->width();
     uint16_t height = mColors[0]->height();
     uint16_t depth = mColors[0]->depth();
+    SL_TexelOrder order = mColors[0]->texel_order();
 
     for (uint64_t i = 0; i < mNumColors; ++i)
     {
@@ -578,6 +850,11 @@ int SL_Framebuffer::valid() const noexcept
         {
             return -6;
         }
+
+        if (mColors[i]->texel_order() != order)
+        {
+            return -13;
+        }
     }
 
     if (!mDepth)
@@ -610,6 +887,11 @@ int SL_Framebuffer::valid() const noexcept
         return -12;
     }
 
+    if (mDepth->texel_order() != order)
+    {
+        return -13;
+    }
+
     return 0;
 }
 
@@ -629,6 +911,8 @@ void SL_Framebuffer::terminate() noexcept
     mNumColors = 0;
 
     mDepth = nullptr;
+
+    mDamage.clear();
 }
 
 
@@ -642,44 +926,8 @@ void SL_Framebuffer::put_pixel(
     uint16_t y,
     const math::vec4& rgba) noexcept
 {
-    SL_Texture* const      pTexture = mColors[targetId];
-    const SL_ColorDataType type     = pTexture->type();
-
-    switch (type)
-    {
-        case SL_COLOR_R_8U:        assign_pixel<SL_ColorR8>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RG_8U:       assign_pixel<SL_ColorRG8>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RGB_8U:      assign_pixel<SL_ColorRGB8>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RGBA_8U:     assign_pixel<SL_ColorRGBA8>(x, y, rgba, pTexture); break;
-
-        case SL_COLOR_R_16U:       assign_pixel<SL_ColorR16>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RG_16U:      assign_pixel<SL_ColorRG16>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RGB_16U:     assign_pixel<SL_ColorRGB16>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RGBA_16U:    assign_pixel<SL_ColorRGBA16>(x, y, rgba, pTexture); break;
-
-        case SL_COLOR_R_32U:       assign_pixel<SL_ColorR32>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RG_32U:      assign_pixel<SL_ColorRG32>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RGB_32U:     assign_pixel<SL_ColorRGB32>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RGBA_32U:    assign_pixel<SL_ColorRGBA32>(x, y, rgba, pTexture); break;
-
-        case SL_COLOR_R_64U:       assign_pixel<SL_ColorR64>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RG_64U:      assign_pixel<SL_ColorRG64>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RGB_64U:     assign_pixel<SL_ColorRGB64>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RGBA_64U:    assign_pixel<SL_ColorRGBA64>(x, y, rgba, pTexture); break;
-
-        case SL_COLOR_R_FLOAT:     assign_pixel<SL_ColorRf>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RG_FLOAT:    assign_pixel<SL_ColorRGf>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RGB_FLOAT:   assign_pixel<SL_ColorRGBf>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RGBA_FLOAT:  assign_pixel<SL_ColorRGBAf>(x, y, rgba, pTexture); break;
-
-        case SL_COLOR_R_DOUBLE:    assign_pixel<SL_ColorRd>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RG_DOUBLE:   assign_pixel<SL_ColorRGd>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RGB_DOUBLE:  assign_pixel<SL_ColorRGBd>(x, y, rgba, pTexture); break;
-        case SL_COLOR_RGBA_DOUBLE: assign_pixel<SL_ColorRGBAd>(x, y, rgba, pTexture); break;
-
-        default:
-            LS_UNREACHABLE();
-    }
+    SL_Texture* const pTexture = mColors[targetId];
+    assign_texel(pTexture->map_native_coordinate(x, y), rgba, pTexture);
 }
 
 
@@ -689,18 +937,26 @@ void SL_Framebuffer::put_pixel(
 -------------------------------------*/
 void SL_Framebuffer::put_pixel(SL_FboOutputMask outMask, SL_BlendMode blendMode, const SL_FragmentParam& fragParam) noexcept
 {
+    // All attachments share a size & texel order, so the texel index is only
+    // mapped once for every output.
+    const ptrdiff_t index = mColors[0]->map_native_coordinate(fragParam.coord.x, fragParam.coord.y);
+
     switch (outMask)
     {
-        case SL_FBO_OUTPUT_ATTACHMENT_0_1_2_3: this->put_pixel(3, fragParam.coord.x, fragParam.coord.y, fragParam.pOutputs[3]);
-        case SL_FBO_OUTPUT_ATTACHMENT_0_1_2:   this->put_pixel(2, fragParam.coord.x, fragParam.coord.y, fragParam.pOutputs[2]);
-        case SL_FBO_OUTPUT_ATTACHMENT_0_1:     this->put_pixel(1, fragParam.coord.x, fragParam.coord.y, fragParam.pOutputs[1]);
-        case SL_FBO_OUTPUT_ATTACHMENT_0:       this->put_pixel(0, fragParam.coord.x, fragParam.coord.y, fragParam.pOutputs[0]);
+        case SL_FBO_OUTPUT_ATTACHMENT_0_1_2_3: assign_texel(index, fragParam.pOutputs[3], mColors[3]);
+        case SL_FBO_OUTPUT_ATTACHMENT_0_1_2:   assign_texel(index, fragParam.pOutputs[2], mColors[2]);
+        case SL_FBO_OUTPUT_ATTACHMENT_0_1:     assign_texel(index, fragParam.pOutputs[1], mColors[1]);
+        case SL_FBO_OUTPUT_ATTACHMENT_0:       assign_texel(index, fragParam.pOutputs[0], mColors[0]);
             break;
 
-        case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0_1_2_3: this->put_alpha_pixel(3, fragParam.coord.x, fragParam.coord.y, fragParam.pOutputs[3], blendMode);
-        case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0_1_2:   this->put_alpha_pixel(2, fragParam.coord.x, fragParam.coord.y, fragParam.pOutputs[2], blendMode);
-        case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0_1:     this->put_alpha_pixel(1, fragParam.coord.x, fragParam.coord.y, fragParam.pOutputs[1], blendMode);
-        case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0:       this->put_alpha_pixel(0, fragParam.coord.x, fragParam.coord.y, fragParam.pOutputs[0], blendMode);
+        case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0_1_2_3: assign_alpha_texel(index, fragParam.pOutputs[3], mColors[3], blendMode);
+        case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0_1_2:   assign_alpha_texel(index, fragParam.pOutputs[2], mColors[2], blendMode);
+        case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0_1:     assign_alpha_texel(index, fragParam.pOutputs[1], mColors[1], blendMode);
+        case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0:       assign_alpha_texel(index, fragParam.pOutputs[0], mColors[0], blendMode);
+            break;
+
+        case SL_FBO_OUTPUT_WEIGHTED_OIT:
+            this->put_oit_pixel(fragParam);
             break;
 
         default:
@@ -720,44 +976,39 @@ void SL_Framebuffer::put_alpha_pixel(
     const math::vec4& colors,
     const SL_BlendMode blendMode) noexcept
 {
-    SL_Texture* const      pTexture = mColors[targetId];
-    const SL_ColorDataType type     = pTexture->type();
-
-    switch (type)
-    {
-        case SL_COLOR_R_8U:        assign_alpha_pixel<SL_ColorR8>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RG_8U:       assign_alpha_pixel<SL_ColorRG8>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RGB_8U:      assign_alpha_pixel<SL_ColorRGB8>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RGBA_8U:     assign_alpha_pixel<SL_ColorRGBA8>(x, y, colors, pTexture, blendMode); break;
-
-        case SL_COLOR_R_16U:       assign_alpha_pixel<SL_ColorR16>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RG_16U:      assign_alpha_pixel<SL_ColorRG16>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RGB_16U:     assign_alpha_pixel<SL_ColorRGB16>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RGBA_16U:    assign_alpha_pixel<SL_ColorRGBA16>(x, y, colors, pTexture, blendMode); break;
-
-        case SL_COLOR_R_32U:       assign_alpha_pixel<SL_ColorR32>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RG_32U:      assign_alpha_pixel<SL_ColorRG32>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RGB_32U:     assign_alpha_pixel<SL_ColorRGB32>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RGBA_32U:    assign_alpha_pixel<SL_ColorRGBA32>(x, y, colors, pTexture, blendMode); break;
-
-        case SL_COLOR_R_64U:       assign_alpha_pixel<SL_ColorR64>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RG_64U:      assign_alpha_pixel<SL_ColorRG64>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RGB_64U:     assign_alpha_pixel<SL_ColorRGB64>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RGBA_64U:    assign_alpha_pixel<SL_ColorRGBA64>(x, y, colors, pTexture, blendMode); break;
+    SL_Texture* const pTexture = mColors[targetId];
+    assign_alpha_texel(pTexture->map_native_coordinate(x, y), colors, pTexture, blendMode);
+}
 
-        case SL_COLOR_R_FLOAT:     assign_alpha_pixel<SL_ColorRf>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RG_FLOAT:    assign_alpha_pixel<SL_ColorRGf>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RGB_FLOAT:   assign_alpha_pixel<SL_ColorRGBf>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RGBA_FLOAT:  assign_alpha_pixel<SL_ColorRGBAf>(x, y, colors, pTexture, blendMode); break;
 
-        case SL_COLOR_R_DOUBLE:    assign_alpha_pixel<SL_ColorRd>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RG_DOUBLE:   assign_alpha_pixel<SL_ColorRGd>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RGB_DOUBLE:  assign_alpha_pixel<SL_ColorRGBd>(x, y, colors, pTexture, blendMode); break;
-        case SL_COLOR_RGBA_DOUBLE: assign_alpha_pixel<SL_ColorRGBAd>(x, y, colors, pTexture, blendMode); break;
 
-        default:
-            LS_UNREACHABLE();
-    }
+/*-------------------------------------
+ * Accumulate a pixel for weighted-blended OIT
+-------------------------------------*/
+void SL_Framebuffer::put_oit_pixel(const SL_FragmentParam& fragParam) noexcept
+{
+    LS_DEBUG_ASSERT(mNumColors >= SL_OIT_MIN_ATTACHMENTS);
+    LS_DEBUG_ASSERT(mColors[SL_OIT_ACCUMULATION]->type() == SL_COLOR_RGBA_FLOAT);
+    LS_DEBUG_ASSERT(mColors[SL_OIT_REVEALAGE]->type() == SL_COLOR_R_FLOAT);
+
+    const uint16_t    x     = fragParam.coord.x;
+    const uint16_t    y     = fragParam.coord.y;
+    const math::vec4& rgba  = fragParam.pOutputs[0];
+    const float       alpha = math::clamp(rgba[3], 0.f, 1.f);
+
+    // Depth-based weighting (McGuire & Bavoil) favors closer fragments. Both
+    // operations below are commutative, so primitives can arrive in any order.
+    // Depth is remapped so the near plane is 0 regardless of the projection.
+    const float z      = math::clamp((fragParam.coord.depth - mDepthNear) * math::rcp(mDepthFar - mDepthNear), 0.f, 1.f);
+    const float zInv   = 1.f - z;
+    const float weight = alpha * math::clamp(3.e3f * zInv * zInv * zInv, 1.e-2f, 3.e3f);
+
+    const ptrdiff_t      index   = mColors[SL_OIT_ACCUMULATION]->map_native_coordinate(x, y);
+    SL_ColorRGBAf* const pAccum  = &mColors[SL_OIT_ACCUMULATION]->raw_texel<SL_ColorRGBAf>(index);
+    SL_ColorRf* const    pReveal = &mColors[SL_OIT_REVEALAGE]->raw_texel<SL_ColorRf>(index);
+
+    *pAccum = math::fmadd(math::vec4{rgba[0], rgba[1], rgba[2], 1.f}, math::vec4{weight}, *pAccum);
+    pReveal->r *= 1.f - alpha;
 }
 
 
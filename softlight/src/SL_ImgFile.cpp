@@ -260,6 +260,11 @@ FREE_IMAGE_TYPE sl_color_to_freeimage(SL_ColorDataType type)
         case SL_COLOR_RGB_DOUBLE:
         case SL_COLOR_RGBA_DOUBLE:
             return FIT_DOUBLE;
+
+        // Half-float, compressed, packed, and sRGB images have no FreeImage
+        // equivalent.
+        default:
+            break;
     }
 
     return FIT_UNKNOWN;
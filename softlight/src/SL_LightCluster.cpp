@@ -0,0 +1,324 @@
+
+#include <utility> // std::move()
+
+#include "lightsky/utils/Assertions.h"
+#include "lightsky/utils/Copy.h" // fast_memcpy(), fast_memset()
+
+#include "lightsky/math/vec_utils.h"
+
+#include "softlight/SL_Camera.hpp"
+#include "softlight/SL_LightCluster.hpp"
+#include "softlight/SL_LightProcessor.hpp" // SL_PointLight
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions and namespaces
+-----------------------------------------------------------------------------*/
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_LightClusters Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Destructor
+-------------------------------------*/
+SL_LightClusters::~SL_LightClusters() noexcept
+{
+    terminate();
+}
+
+
+
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_LightClusters::SL_LightClusters() noexcept :
+    mProjection{1.f},
+    mNearPlane{1.f},
+    mFarPlane{2.f},
+    mSliceScale{0.f},
+    mSliceBias{0.f},
+    mWidth{0},
+    mHeight{0},
+    mTilesX{0},
+    mTilesY{0},
+    mNumSlices{0},
+    mMaxLights{0},
+    mCounts{nullptr},
+    mLightIds{nullptr}
+{}
+
+
+
+/*-------------------------------------
+ * Copy Constructor
+-------------------------------------*/
+SL_LightClusters::SL_LightClusters(const SL_LightClusters& c) noexcept :
+    SL_LightClusters{}
+{
+    *this = c;
+}
+
+
+
+/*-------------------------------------
+ * Move Constructor
+-------------------------------------*/
+SL_LightClusters::SL_LightClusters(SL_LightClusters&& c) noexcept :
+    SL_LightClusters{}
+{
+    *this = std::move(c);
+}
+
+
+
+/*-------------------------------------
+ * Copy Operator
+-------------------------------------*/
+SL_LightClusters& SL_LightClusters::operator=(const SL_LightClusters& c) noexcept
+{
+    if (this == &c)
+    {
+        return *this;
+    }
+
+    if (!c.mCounts || init(c.mTilesX, c.mTilesY, c.mNumSlices, c.mMaxLights) != 0)
+    {
+        terminate();
+        return *this;
+    }
+
+    mProjection = c.mProjection;
+    mNearPlane  = c.mNearPlane;
+    mFarPlane   = c.mFarPlane;
+    mSliceScale = c.mSliceScale;
+    mSliceBias  = c.mSliceBias;
+    mWidth      = c.mWidth;
+    mHeight     = c.mHeight;
+
+    ls::utils::fast_memcpy(mCounts.get(), c.mCounts.get(), sizeof(uint16_t) * num_clusters());
+    ls::utils::fast_memcpy(mLightIds.get(), c.mLightIds.get(), sizeof(uint16_t) * num_clusters() * mMaxLights);
+
+    return *this;
+}
+
+
+
+/*-------------------------------------
+ * Move Operator
+-------------------------------------*/
+SL_LightClusters& SL_LightClusters::operator=(SL_LightClusters&& c) noexcept
+{
+    if (this == &c)
+    {
+        return *this;
+    }
+
+    mProjection = c.mProjection;
+    mNearPlane  = c.mNearPlane;
+    mFarPlane   = c.mFarPlane;
+    mSliceScale = c.mSliceScale;
+    mSliceBias  = c.mSliceBias;
+    mWidth      = c.mWidth;
+    mHeight     = c.mHeight;
+    mTilesX     = c.mTilesX;
+    mTilesY     = c.mTilesY;
+    mNumSlices  = c.mNumSlices;
+    mMaxLights  = c.mMaxLights;
+    mCounts     = std::move(c.mCounts);
+    mLightIds   = std::move(c.mLightIds);
+
+    c.terminate();
+
+    return *this;
+}
+
+
+
+/*-------------------------------------
+ * Allocate the cluster grid
+-------------------------------------*/
+int SL_LightClusters::init(uint16_t tilesX, uint16_t tilesY, uint16_t numSlices, uint16_t maxLightsPerCluster) noexcept
+{
+    if (!tilesX || !tilesY || !numSlices || !maxLightsPerCluster)
+    {
+        return -1;
+    }
+
+    const size_t numClusters = (size_t)tilesX * (size_t)tilesY * (size_t)numSlices;
+
+    mCounts = ls::utils::make_unique_aligned_array<uint16_t>(numClusters);
+    mLightIds = ls::utils::make_unique_aligned_array<uint16_t>(numClusters * maxLightsPerCluster);
+
+    if (!mCounts || !mLightIds)
+    {
+        terminate();
+        return -2;
+    }
+
+    mTilesX    = tilesX;
+    mTilesY    = tilesY;
+    mNumSlices = numSlices;
+    mMaxLights = maxLightsPerCluster;
+
+    ls::utils::fast_memset(mCounts.get(), 0, sizeof(uint16_t) * numClusters);
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Release all resources
+-------------------------------------*/
+void SL_LightClusters::terminate() noexcept
+{
+    mProjection = math::mat4{1.f};
+    mNearPlane  = 1.f;
+    mFarPlane   = 2.f;
+    mSliceScale = 0.f;
+    mSliceBias  = 0.f;
+    mWidth      = 0;
+    mHeight     = 0;
+    mTilesX     = 0;
+    mTilesY     = 0;
+    mNumSlices  = 0;
+    mMaxLights  = 0;
+    mCounts.reset();
+    mLightIds.reset();
+}
+
+
+
+/*-------------------------------------
+ * Count the clusters which dropped lights
+-------------------------------------*/
+unsigned SL_LightClusters::num_overflowed_clusters() const noexcept
+{
+    const unsigned numClusters = mCounts ? num_clusters() : 0u;
+    unsigned numOverflowed = 0;
+
+    for (unsigned i = 0; i < numClusters; ++i)
+    {
+        numOverflowed += (mCounts[i] > mMaxLights) ? 1u : 0u;
+    }
+
+    return numOverflowed;
+}
+
+
+
+/*-------------------------------------
+ * Update the cluster frustum from a camera
+-------------------------------------*/
+void SL_LightClusters::update(const SL_Camera& cam, uint16_t fboW, uint16_t fboH) noexcept
+{
+    update(cam.get_proj_matrix(), cam.get_near_plane(), cam.get_far_plane(), fboW, fboH);
+}
+
+
+
+/*-------------------------------------
+ * Update the cluster frustum
+-------------------------------------*/
+void SL_LightClusters::update(const ls::math::mat4& projection, float zNear, float zFar, uint16_t fboW, uint16_t fboH) noexcept
+{
+    LS_DEBUG_ASSERT(zNear > 0.f && zFar > zNear);
+
+    mProjection = projection;
+    mNearPlane  = zNear;
+    mFarPlane   = zFar;
+    mWidth      = fboW;
+    mHeight     = fboH;
+
+    // Exponential slicing keeps each froxel roughly cube-shaped in view-space.
+    mSliceScale = (float)mNumSlices / std::log(zFar / zNear);
+    mSliceBias  = -std::log(zNear) * mSliceScale;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_ClusterProcessor Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Assign lights to clusters
+-------------------------------------*/
+void SL_ClusterProcessor::execute() noexcept
+{
+    SL_LightClusters& c = *mClusters;
+
+    const unsigned   numSlices = c.mNumSlices;
+    const unsigned   maxLights = c.mMaxLights;
+    const unsigned   numTiles  = (unsigned)c.mTilesX * (unsigned)c.mTilesY;
+    const math::vec4 tileScale = {
+        2.f / (float)c.mTilesX,
+        2.f / (float)c.mTilesY,
+        2.f / (float)c.mTilesX,
+        2.f / (float)c.mTilesY
+    };
+
+    math::vec4 planes[4];
+
+    for (unsigned tile = mThreadId; tile < numTiles; tile += mNumThreads)
+    {
+        const unsigned tileX    = tile % c.mTilesX;
+        const unsigned tileY    = tile / c.mTilesX;
+        uint16_t*      pCounts  = c.mCounts.get() + (size_t)tile * numSlices;
+        uint16_t*      pIds     = c.mLightIds.get() + (size_t)tile * numSlices * maxLights;
+
+        const math::vec4&& ndcRect = math::fmadd(
+            math::vec4{(float)tileX, (float)tileY, (float)(tileX+1u), (float)(tileY+1u)},
+            tileScale,
+            math::vec4{-1.f});
+
+        sl_extract_subfrustum_planes(c.mProjection, ndcRect, planes);
+
+        for (unsigned slice = 0; slice < numSlices; ++slice)
+        {
+            pCounts[slice] = 0;
+        }
+
+        for (uint32_t i = 0; i < mNumLights; ++i)
+        {
+            const math::vec4& light  = mLights[i].position;
+            const float       radius = light[3];
+            const math::vec4  center = {light[0], light[1], light[2], 1.f};
+
+            // Lights entirely behind the near plane or beyond the far plane
+            if (-(light[2] - radius) < c.mNearPlane || -(light[2] + radius) > c.mFarPlane)
+            {
+                continue;
+            }
+
+            if (math::dot(planes[0], center) < -radius
+            || math::dot(planes[1], center) < -radius
+            || math::dot(planes[2], center) < -radius
+            || math::dot(planes[3], center) < -radius)
+            {
+                continue;
+            }
+
+            // The light's depth extents map to a contiguous range of slices
+            const unsigned slice0 = c.slice_for_depth(light[2] + radius);
+            const unsigned slice1 = c.slice_for_depth(light[2] - radius);
+
+            // Overflowing lights are still counted so they can be reported.
+            // Light indices are limited to 16 bits so counts can't wrap.
+            for (unsigned slice = slice0; slice <= slice1; ++slice)
+            {
+                const unsigned count = pCounts[slice];
+
+                if (count < maxLights)
+                {
+                    pIds[slice * maxLights + count] = (uint16_t)i;
+                }
+
+                pCounts[slice] = (uint16_t)(count + 1u);
+            }
+        }
+    }
+}
@@ -0,0 +1,266 @@
+
+#include <limits> // std::numeric_limits
+
+#include "lightsky/utils/Assertions.h"
+
+#include "lightsky/math/mat4.h"
+#include "lightsky/math/scalar_utils.h"
+#include "lightsky/math/vec_utils.h"
+
+#include "softlight/SL_Camera.hpp" // sl_extract_subfrustum_planes()
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_LightProcessor.hpp"
+#include "softlight/SL_Setup.hpp" // SL_AlignedVector
+#include "softlight/SL_Texture.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions and namespaces
+-----------------------------------------------------------------------------*/
+namespace math = ls::math;
+
+namespace
+{
+
+
+
+/*-------------------------------------
+ * Read an albedo texel as a normalized float
+-------------------------------------*/
+template <typename color_type>
+inline LS_INLINE math::vec4 _sl_load_albedo(const color_type& c) noexcept;
+
+template <>
+inline LS_INLINE math::vec4 _sl_load_albedo<SL_ColorRGBA8>(const SL_ColorRGBA8& c) noexcept
+{
+    return color_cast<float, uint8_t>(c);
+}
+
+template <>
+inline LS_INLINE math::vec4 _sl_load_albedo<SL_ColorRGBAf>(const SL_ColorRGBAf& c) noexcept
+{
+    return c;
+}
+
+
+
+/*-------------------------------------
+ * Convert a lit color into the output format
+-------------------------------------*/
+template <typename color_type>
+inline LS_INLINE color_type _sl_store_lit(const math::vec4& c) noexcept;
+
+template <>
+inline LS_INLINE SL_ColorRGBA8 _sl_store_lit<SL_ColorRGBA8>(const math::vec4& c) noexcept
+{
+    return color_cast<uint8_t, float>(math::clamp(c, math::vec4{0.f}, math::vec4{1.f}));
+}
+
+template <>
+inline LS_INLINE SL_ColorRGBAf _sl_store_lit<SL_ColorRGBAf>(const math::vec4& c) noexcept
+{
+    return c;
+}
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_LightProcessor Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Per-tile light culling
+-------------------------------------*/
+unsigned SL_LightProcessor::cull_lights(
+    uint16_t x0,
+    uint16_t y0,
+    uint16_t x1,
+    uint16_t y1,
+    uint16_t* pOutLightIds) const noexcept
+{
+    float zMin = std::numeric_limits<float>::max();
+    float zMax = -std::numeric_limits<float>::max();
+
+    // Depth bounds come directly from the G-Buffer. Empty pixels are ignored
+    // so tiles along a silhouette don't stretch to the far plane.
+    for (uint16_t y = y0; y < y1; ++y)
+    {
+        const SL_ColorRGBAf* pPos = mPositions->row_pointer<SL_ColorRGBAf>(y);
+
+        for (uint16_t x = x0; x < x1; ++x)
+        {
+            if (pPos[x][3] != 0.f)
+            {
+                zMin = math::min(zMin, pPos[x][2]);
+                zMax = math::max(zMax, pPos[x][2]);
+            }
+        }
+    }
+
+    if (zMin > zMax)
+    {
+        return 0;
+    }
+
+    const float wInv = 2.f * math::rcp((float)mBackBuffer->width());
+    const float hInv = 2.f * math::rcp((float)mBackBuffer->height());
+
+    const math::vec4&& ndcRect = math::fmadd(
+        math::vec4{(float)x0, (float)y0, (float)x1, (float)y1},
+        math::vec4{wInv, hInv, wInv, hInv},
+        math::vec4{-1.f});
+
+    math::vec4 planes[4];
+    sl_extract_subfrustum_planes(*mProjection, ndcRect, planes);
+
+    unsigned numVisible = 0;
+
+    for (uint32_t i = 0; i < mNumLights; ++i)
+    {
+        const math::vec4& light  = mLights[i].position;
+        const float       radius = light[3];
+        const math::vec4  center = {light[0], light[1], light[2], 1.f};
+
+        if (light[2] - radius > zMax || light[2] + radius < zMin)
+        {
+            continue;
+        }
+
+        if (math::dot(planes[0], center) < -radius
+        || math::dot(planes[1], center) < -radius
+        || math::dot(planes[2], center) < -radius
+        || math::dot(planes[3], center) < -radius)
+        {
+            continue;
+        }
+
+        pOutLightIds[numVisible++] = (uint16_t)i;
+    }
+
+    return numVisible;
+}
+
+
+
+/*-------------------------------------
+ * Tiled light accumulation
+-------------------------------------*/
+template <typename albedo_type, typename out_type>
+void SL_LightProcessor::shade_tiles() noexcept
+{
+    const uint16_t w      = mBackBuffer->width();
+    const uint16_t h      = mBackBuffer->height();
+    const unsigned tilesX = (w + SL_LIGHT_TILE_SIZE - 1u) >> SL_LIGHT_TILE_SHIFTS;
+    const unsigned tilesY = (h + SL_LIGHT_TILE_SIZE - 1u) >> SL_LIGHT_TILE_SHIFTS;
+    const unsigned numTiles = tilesX * tilesY;
+    const math::vec4 ambient = *mAmbient;
+
+    // Every light may touch a single tile, so the list is sized to hold all
+    // of them rather than dropping lights in dense areas.
+    SL_AlignedVector<uint16_t> lightIds;
+    lightIds.resize(mNumLights);
+
+    // Tiles are interleaved between threads to balance dense and sparse
+    // regions of the screen.
+    for (unsigned tile = mThreadId; tile < numTiles; tile += mNumThreads)
+    {
+        const uint16_t x0 = (uint16_t)((tile % tilesX) << SL_LIGHT_TILE_SHIFTS);
+        const uint16_t y0 = (uint16_t)((tile / tilesX) << SL_LIGHT_TILE_SHIFTS);
+        const uint16_t x1 = (uint16_t)math::min<unsigned>(x0 + SL_LIGHT_TILE_SIZE, w);
+        const uint16_t y1 = (uint16_t)math::min<unsigned>(y0 + SL_LIGHT_TILE_SIZE, h);
+
+        const unsigned numLights = cull_lights(x0, y0, x1, y1, lightIds.data());
+
+        for (uint16_t y = y0; y < y1; ++y)
+        {
+            const albedo_type*   pAlbedo = mAlbedo->row_pointer<albedo_type>(y);
+            const SL_ColorRGBAf* pNorm   = mNormals->row_pointer<SL_ColorRGBAf>(y);
+            const SL_ColorRGBAf* pPos    = mPositions->row_pointer<SL_ColorRGBAf>(y);
+            out_type*            pOut    = mBackBuffer->row_pointer<out_type>(y);
+
+            for (uint16_t x = x0; x < x1; ++x)
+            {
+                const math::vec4&& albedo = _sl_load_albedo<albedo_type>(pAlbedo[x]);
+
+                if (pPos[x][3] == 0.f)
+                {
+                    pOut[x] = _sl_store_lit<out_type>(albedo);
+                    continue;
+                }
+
+                const math::vec4 pos  = {pPos[x][0], pPos[x][1], pPos[x][2], 0.f};
+                const math::vec4 norm = {pNorm[x][0], pNorm[x][1], pNorm[x][2], 0.f};
+                math::vec4 accum = ambient;
+
+                for (unsigned i = 0; i < numLights; ++i)
+                {
+                    const SL_PointLight& light = mLights[lightIds[i]];
+                    const float radius2 = light.position[3] * light.position[3];
+                    const math::vec4 l = math::vec4{light.position[0], light.position[1], light.position[2], 0.f} - pos;
+                    const float dist2 = math::dot(l, l);
+
+                    if (dist2 >= radius2)
+                    {
+                        continue;
+                    }
+
+                    const float dist    = math::fast_sqrt(dist2);
+                    const float nDotL   = math::max(0.f, math::dot(norm, l) * math::rcp(math::max(dist, 1.e-6f)));
+                    const float falloff = 1.f - dist2 * math::rcp(radius2);
+
+                    accum += light.color * (light.color[3] * nDotL * falloff * falloff);
+                }
+
+                math::vec4&& lit = albedo * accum;
+                lit[3] = albedo[3];
+
+                pOut[x] = _sl_store_lit<out_type>(lit);
+            }
+        }
+    }
+}
+
+
+
+template void SL_LightProcessor::shade_tiles<SL_ColorRGBA8, SL_ColorRGBA8>() noexcept;
+template void SL_LightProcessor::shade_tiles<SL_ColorRGBA8, SL_ColorRGBAf>() noexcept;
+template void SL_LightProcessor::shade_tiles<SL_ColorRGBAf, SL_ColorRGBA8>() noexcept;
+template void SL_LightProcessor::shade_tiles<SL_ColorRGBAf, SL_ColorRGBAf>() noexcept;
+
+
+
+/*-------------------------------------
+ * Run the lighting pass
+-------------------------------------*/
+void SL_LightProcessor::execute() noexcept
+{
+    LS_DEBUG_ASSERT(mNormals->type() == SL_COLOR_RGBA_FLOAT);
+    LS_DEBUG_ASSERT(mPositions->type() == SL_COLOR_RGBA_FLOAT);
+
+    if (mAlbedo->type() == SL_COLOR_RGBA_8U)
+    {
+        switch (mBackBuffer->type())
+        {
+            case SL_COLOR_RGBA_8U:    shade_tiles<SL_ColorRGBA8, SL_ColorRGBA8>(); break;
+            case SL_COLOR_RGBA_FLOAT: shade_tiles<SL_ColorRGBA8, SL_ColorRGBAf>(); break;
+            default:
+                LS_DEBUG_ASSERT(false);
+                LS_UNREACHABLE();
+        }
+    }
+    else
+    {
+        switch (mBackBuffer->type())
+        {
+            case SL_COLOR_RGBA_8U:    shade_tiles<SL_ColorRGBAf, SL_ColorRGBA8>(); break;
+            case SL_COLOR_RGBA_FLOAT: shade_tiles<SL_ColorRGBAf, SL_ColorRGBAf>(); break;
+            default:
+                LS_DEBUG_ASSERT(false);
+                LS_UNREACHABLE();
+        }
+    }
+}
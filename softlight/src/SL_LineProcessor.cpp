@@ -6,6 +6,8 @@
 #include "softlight/SL_IndexBuffer.hpp"
 #include "softlight/SL_LineProcessor.hpp"
 #include "softlight/SL_LineRasterizer.hpp"
+#include "softlight/SL_PipelineStatistics.hpp"
+#include "softlight/SL_Profiler.hpp"
 #include "softlight/SL_Shader.hpp"
 #include "softlight/SL_ShaderUtil.hpp" // SL_BinCounter
 #include "softlight/SL_VertexArray.hpp"
@@ -212,10 +214,14 @@ void SL_LineProcessor::push_bin(size_t primIndex, const math::vec4& viewportDims
     const float fboW = viewportDims[0]+viewportDims[2];
     const float fboH = viewportDims[1]+viewportDims[3];
 
-    int isPrimHidden = (bboxMaxX < viewportDims[0] || bboxMaxY < viewportDims[1] || fboW < bboxMinX || fboH < bboxMinY);
-    isPrimHidden = isPrimHidden || (bboxMaxX-bboxMinX < 1.f) || (bboxMaxY-bboxMinY < 1.f);
+    const int isPrimOutside = (bboxMaxX < viewportDims[0] || bboxMaxY < viewportDims[1] || fboW < bboxMinX || fboH < bboxMinY)
+        || (mDirtyRegion && is_outside_dirty_region(bboxMinX, bboxMinY, bboxMaxX, bboxMaxY));
+    const int isPrimHidden = isPrimOutside || (bboxMaxX-bboxMinX < 1.f) || (bboxMaxY-bboxMinY < 1.f);
     if (LS_UNLIKELY(isPrimHidden))
     {
+        SL_PipelineStatistics& stats = mStats[mThreadId];
+        stats.primsCulledFrustum += isPrimOutside;
+        stats.primsCulledZeroArea += !isPrimOutside;
         return;
     }
 
@@ -273,6 +279,9 @@ void SL_LineProcessor::process_verts(
     params.pVao       = &vao;
     params.pVbo       = &mContext->vbo(vao.get_vertex_buffer());
 
+    uint64_t numSubmitted = 0;
+    uint64_t numOutside   = 0;
+
     #if SL_VERTEX_CACHING_ENABLED
         size_t begin;
         size_t end;
@@ -294,6 +303,7 @@ void SL_LineProcessor::process_verts(
     {
         const size_t index0 = i;
         const size_t index1 = i + 1;
+        ++numSubmitted;
 
         #if SL_VERTEX_CACHING_ENABLED
             const size_t vertId0 = usingIndices ? pIbo->index(index0) : index0;
@@ -319,7 +329,21 @@ void SL_LineProcessor::process_verts(
 
             push_bin(i, viewportDims, pVert0, pVert1);
         }
+        else
+        {
+            ++numOutside;
+        }
     }
+
+    SL_PipelineStatistics& stats = mStats[mThreadId];
+    stats.primsSubmitted     += numSubmitted;
+    stats.primsCulledFrustum += numOutside;
+
+    #if SL_VERTEX_CACHING_ENABLED
+        stats.verticesShaded += ptvCache.num_shaded();
+    #else
+        stats.verticesShaded += numSubmitted * 2u;
+    #endif
 }
 
 
@@ -334,18 +358,22 @@ void SL_LineProcessor::execute() noexcept
     const math::mat4&&      scissorMat   = viewState.scissor_matrix(fboDims[2], fboDims[3]);
     const math::vec4&&      viewportDims = viewState.viewport_rect(fboDims[2], fboDims[3]);
 
-    if (mNumInstances == 1)
     {
-        for (size_t i = 0; i < mNumMeshes; ++i)
+        SL_PROFILE_SCOPE(SL_PROFILE_VERTEX, mThreadId);
+
+        if (mNumInstances == 1)
         {
-            process_verts(mMeshes[i], 0, scissorMat, viewportDims);
+            for (size_t i = 0; i < mNumMeshes; ++i)
+            {
+                process_verts(mMeshes[i], 0, scissorMat, viewportDims);
+            }
         }
-    }
-    else
-    {
-        for (size_t i = 0; i < mNumInstances; ++i)
+        else
         {
-            process_verts(mMeshes[0], i, scissorMat, viewportDims);
+            for (size_t i = 0; i < mNumInstances; ++i)
+            {
+                process_verts(mMeshes[0], i, scissorMat, viewportDims);
+            }
         }
     }
 
@@ -7,7 +7,9 @@
 #include "lightsky/math/vec_utils.h"
 
 #include "softlight/SL_LineRasterizer.hpp"
+#include "softlight/SL_DamageRegion.hpp"
 #include "softlight/SL_Framebuffer.hpp" // SL_Framebuffer
+#include "softlight/SL_PipelineStatistics.hpp"
 #include "softlight/SL_ViewportState.hpp"
 #include "softlight/SL_Shader.hpp" // SL_FragmentShader
 #include "softlight/SL_Texture.hpp"
@@ -175,9 +177,9 @@ void SL_LineRasterizer::render_line(
     constexpr DepthCmpFunc  depthCmp    = {};
     const SL_FragmentShader fragShader  = mShader->mFragShader;
     const SL_BlendMode      blendMode   = fragShader.blend;
-    const bool              blend       = blendMode != SL_BLEND_OFF;
     const uint32_t          numVaryings = fragShader.numVaryings;
     const uint32_t          numOutputs  = fragShader.numOutputs;
+    const SL_FboOutputMask  fboOutMask  = sl_calc_fbo_out_mask(numOutputs, blendMode != SL_BLEND_OFF, blendMode == SL_BLEND_WEIGHTED_OIT);
     const bool              depthMask   = fragShader.depthMask == SL_DEPTH_MASK_ON;
     const auto              shader      = fragShader.shader;
     const SL_UniformBuffer* pUniforms   = mShader->mUniforms;
@@ -216,6 +218,9 @@ void SL_LineRasterizer::render_line(
     SL_FragmentParam fragParams;
     fragParams.pUniforms = pUniforms;
 
+    uint32_t numShaded = 0;
+    uint32_t numWritten = 0;
+
     for (int32_t i = 0; i <= istep; ++i, x += dx, y += dy)
     {
         const float      xf      = math::float_cast<float, fixed_type>(x);
@@ -227,7 +232,12 @@ void SL_LineRasterizer::render_line(
         const float      interp  = (currLen*dist);
         const float      z       = math::mix(z0, z1, interp);
 
-        if (!depthCmp(z, (float)depthBuf->raw_texel<depth_type>((uint16_t)xi, (uint16_t)yi)))
+        if (!depthCmp(z, (float)depthBuf->native_texel<depth_type>((uint16_t)xi, (uint16_t)yi)))
+        {
+            continue;
+        }
+
+        if (mDirtyRegion && !mDirtyRegion->contains(xi, yi))
         {
             continue;
         }
@@ -239,30 +249,12 @@ void SL_LineRasterizer::render_line(
         fragParams.coord.depth = z;
         const uint_fast32_t haveOutputs = shader(fragParams);
 
-        if (blend)
-        {
-            // branchless select
-            switch (-haveOutputs & numOutputs)
-            {
-                case 4: fbo->put_alpha_pixel(3, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[3], blendMode);
-                case 3: fbo->put_alpha_pixel(2, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[2], blendMode);
-                case 2: fbo->put_alpha_pixel(1, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[1], blendMode);
-                case 1: fbo->put_alpha_pixel(0, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[0], blendMode);
-                //case 1: fbo->put_pixel(0, fragParams.coord.x, fragParams.coord.y, math::vec4{1.f, 0, 1.f, 1.f});
-            }
+        ++numShaded;
+        numWritten += !!haveOutputs;
 
-        }
-        else
+        if (haveOutputs)
         {
-            // branchless select
-            switch (-haveOutputs & numOutputs)
-            {
-                case 4: fbo->put_pixel(3, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[3]);
-                case 3: fbo->put_pixel(2, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[2]);
-                case 2: fbo->put_pixel(1, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[1]);
-                case 1: fbo->put_pixel(0, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[0]);
-                //case 1: fbo->put_pixel(0,fragParams.coord.x, fragParams.coord.y, math::vec4{1.f, 0, 1.f, 1.f});
-            }
+            fbo->put_pixel(fboOutMask, blendMode, fragParams);
         }
 
         if (haveOutputs && depthMask)
@@ -270,6 +262,11 @@ void SL_LineRasterizer::render_line(
             fbo->put_depth_pixel<depth_type>(fragParams.coord.x, fragParams.coord.y, (depth_type)fragParams.coord.depth);
         }
     }
+
+    mStats->fragsRasterized += (uint64_t)(istep + 1);
+    mStats->fragsShaded     += numShaded;
+    mStats->fragsDiscarded  += numShaded - numWritten;
+    mStats->pixelsWritten   += numWritten;
 }
 
 
@@ -1,5 +1,6 @@
 
 #include "softlight/SL_Material.hpp"
+#include "softlight/SL_Texture.hpp"
 
 
 
@@ -11,6 +12,7 @@ void sl_reset(SL_Material& m) noexcept
     for (unsigned i = SL_MaterialProperty::SL_MATERIAL_MAX_TEXTURES; i --> 0;)
     {
         m.pTextures[i] = nullptr;
+        m.layers[i] = 0;
     }
 
     m.ambient = SL_ColorRGBAf{0.f, 0.f, 0.f, 1.f};
@@ -42,6 +44,16 @@ SL_MaterialStatus validate(const SL_Material& m) noexcept
         }
     }
 
+    for (unsigned i = 0; i < SL_MaterialProperty::SL_MATERIAL_MAX_TEXTURES; ++i)
+    {
+        const SL_Texture* pTex = m.pTextures[i];
+
+        if (pTex && pTex->layout() == SL_TEX_LAYOUT_ARRAY && m.layers[i] >= pTex->depth())
+        {
+            return SL_MATERIAL_STATUS_INVALID_LAYER;
+        }
+    }
+
     if (m.ambient[0] < 0.f
     || m.ambient[1] < 0.f
     || m.ambient[2] < 0.f
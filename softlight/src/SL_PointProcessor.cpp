@@ -4,8 +4,10 @@
 #include "softlight/SL_Context.hpp"
 #include "softlight/SL_Framebuffer.hpp"
 #include "softlight/SL_IndexBuffer.hpp"
+#include "softlight/SL_PipelineStatistics.hpp"
 #include "softlight/SL_PointProcessor.hpp"
 #include "softlight/SL_PointRasterizer.hpp"
+#include "softlight/SL_Profiler.hpp"
 #include "softlight/SL_Shader.hpp"
 #include "softlight/SL_ShaderUtil.hpp" // SL_BinCounter
 #include "softlight/SL_VertexArray.hpp"
@@ -158,8 +160,10 @@ void SL_PointProcessor::push_bin(size_t primIndex, const ls::math::vec4& viewpor
     const float fboW = viewportDims[0]+viewportDims[2];
     const float fboH = viewportDims[1]+viewportDims[3];
 
-    if (LS_UNLIKELY(bboxMaxX < viewportDims[0] || bboxMaxY < viewportDims[1] || fboW < bboxMinX || fboH < bboxMinY))
+    if (LS_UNLIKELY(bboxMaxX < viewportDims[0] || bboxMaxY < viewportDims[1] || fboW < bboxMinX || fboH < bboxMinY
+    || (mDirtyRegion && is_outside_dirty_region(bboxMinX, bboxMinY, bboxMaxX, bboxMaxY))))
     {
+        ++mStats[mThreadId].primsCulledFrustum;
         return;
     }
 
@@ -214,6 +218,9 @@ void SL_PointProcessor::process_verts(
     params.pVao       = &vao;
     params.pVbo       = &mContext->vbo(vao.get_vertex_buffer());
 
+    uint64_t numSubmitted = 0;
+    uint64_t numOutside   = 0;
+
     #if SL_VERTEX_CACHING_ENABLED
         size_t begin;
         size_t end;
@@ -233,6 +240,8 @@ void SL_PointProcessor::process_verts(
 
     for (size_t i = begin; i < end; i += step)
     {
+        ++numSubmitted;
+
         #if SL_VERTEX_CACHING_ENABLED
             const size_t vertId = usingIndices ? pIbo->index(i) : i;
             ptvCache.query_and_update(vertId, scissorMat, pVert0);
@@ -250,7 +259,21 @@ void SL_PointProcessor::process_verts(
 
             push_bin(i, viewportDims, pVert0);
         }
+        else
+        {
+            ++numOutside;
+        }
     }
+
+    SL_PipelineStatistics& stats = mStats[mThreadId];
+    stats.primsSubmitted     += numSubmitted;
+    stats.primsCulledFrustum += numOutside;
+
+    #if SL_VERTEX_CACHING_ENABLED
+        stats.verticesShaded += ptvCache.num_shaded();
+    #else
+        stats.verticesShaded += numSubmitted;
+    #endif
 }
 
 
@@ -265,18 +288,22 @@ void SL_PointProcessor::execute() noexcept
     const math::mat4&&      scissorMat   = viewState.scissor_matrix(fboDims[2], fboDims[3]);
     const math::vec4&&      viewportDims = viewState.viewport_rect(fboDims[2], fboDims[3]);
 
-    if (mNumInstances == 1)
     {
-        for (size_t i = 0; i < mNumMeshes; ++i)
+        SL_PROFILE_SCOPE(SL_PROFILE_VERTEX, mThreadId);
+
+        if (mNumInstances == 1)
         {
-            process_verts(mMeshes[i], 0, scissorMat, viewportDims);
+            for (size_t i = 0; i < mNumMeshes; ++i)
+            {
+                process_verts(mMeshes[i], 0, scissorMat, viewportDims);
+            }
         }
-    }
-    else
-    {
-        for (size_t i = 0; i < mNumInstances; ++i)
+        else
         {
-            process_verts(mMeshes[0], i, scissorMat, viewportDims);
+            for (size_t i = 0; i < mNumInstances; ++i)
+            {
+                process_verts(mMeshes[0], i, scissorMat, viewportDims);
+            }
         }
     }
 
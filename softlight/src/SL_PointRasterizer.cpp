@@ -2,7 +2,9 @@
 #include "lightsky/math/half.h"
 
 #include "softlight/SL_PointRasterizer.hpp"
+#include "softlight/SL_DamageRegion.hpp"
 #include "softlight/SL_Framebuffer.hpp" // SL_Framebuffer
+#include "softlight/SL_PipelineStatistics.hpp"
 #include "softlight/SL_Shader.hpp" // SL_FragmentShader
 #include "softlight/SL_Texture.hpp"
 #include "softlight/SL_ViewportState.hpp"
@@ -33,7 +35,7 @@ void SL_PointRasterizer::render_point(const uint32_t binId, SL_Framebuffer* cons
     const bool              depthMask   = fragShader.depthMask == SL_DEPTH_MASK_ON;
     const auto              pShader     = fragShader.shader;
     const SL_BlendMode      blendMode   = fragShader.blend;
-    const bool              blend       = blendMode != SL_BLEND_OFF;
+    const SL_FboOutputMask  fboOutMask  = sl_calc_fbo_out_mask(numOutputs, blendMode != SL_BLEND_OFF, blendMode == SL_BLEND_WEIGHTED_OIT);
     const math::vec4        screenCoord = mBins[binId].mScreenCoords[0];
     const math::vec4        fragCoord   {screenCoord[0], screenCoord[1], screenCoord[2], 1.f};
     const SL_Texture*       pDepthBuf   = fbo->get_depth_buffer();
@@ -44,12 +46,19 @@ void SL_PointRasterizer::render_point(const uint32_t binId, SL_Framebuffer* cons
         return;
     }
 
+    if (mDirtyRegion && !mDirtyRegion->contains((int32_t)fragCoord[0], (int32_t)fragCoord[1]))
+    {
+        return;
+    }
+
     fragParams.coord.x = (uint16_t)fragCoord[0];
     fragParams.coord.y = (uint16_t)fragCoord[1];
     fragParams.coord.depth = fragCoord[2];
     fragParams.pUniforms = pUniforms;
 
-    if (!depthCmp(fragCoord[2], (float)pDepthBuf->raw_texel<depth_type>(fragParams.coord.x, fragParams.coord.y)))
+    ++mStats->fragsRasterized;
+
+    if (!depthCmp(fragCoord[2], (float)pDepthBuf->native_texel<depth_type>(fragParams.coord.x, fragParams.coord.y)))
     {
         return;
     }
@@ -61,30 +70,13 @@ void SL_PointRasterizer::render_point(const uint32_t binId, SL_Framebuffer* cons
 
     const uint_fast32_t haveOutputs = pShader(fragParams);
 
-    if (blend)
-    {
-        // branchless select
-        switch (-haveOutputs & numOutputs)
-        {
-            case 4: fbo->put_alpha_pixel(3, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[3], blendMode);
-            case 3: fbo->put_alpha_pixel(2, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[2], blendMode);
-            case 2: fbo->put_alpha_pixel(1, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[1], blendMode);
-            case 1: fbo->put_alpha_pixel(0, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[0], blendMode);
-            //case 1: fbo->put_pixel(0, fragParams.coord.x, fragParams.coord.y, math::vec4{1.f, 0.f, 1.f, 1.f});
-        }
+    ++mStats->fragsShaded;
+    mStats->fragsDiscarded += !haveOutputs;
+    mStats->pixelsWritten  += !!haveOutputs;
 
-    }
-    else
+    if (haveOutputs)
     {
-        // branchless select
-        switch (-haveOutputs & numOutputs)
-        {
-            case 4: fbo->put_pixel(3, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[3]);
-            case 3: fbo->put_pixel(2, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[2]);
-            case 2: fbo->put_pixel(1, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[1]);
-            case 1: fbo->put_pixel(0, fragParams.coord.x, fragParams.coord.y, fragParams.pOutputs[0]);
-            //case 1: fbo->put_pixel(0, fragParams.coord.x, fragParams.coord.y, math::vec4{1.f, 0.f, 1.f, 1.f});
-        }
+        fbo->put_pixel(fboOutMask, blendMode, fragParams);
     }
 
     if (haveOutputs && depthMask)
@@ -7,14 +7,22 @@
 #include "lightsky/utils/Log.h"
 #include "lightsky/utils/WorkerThread.hpp"
 
+#include "lightsky/math/mat4.h"
 #include "lightsky/math/vec4.h"
 
 #include "softlight/SL_BlitProcesor.hpp"
+#include "softlight/SL_CompositeProcessor.hpp"
+#include "softlight/SL_Context.hpp" // SL_Context::dirty_region()
+#include "softlight/SL_CpuTopology.hpp"
 #include "softlight/SL_FragmentProcessor.hpp"
 #include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_LightCluster.hpp"
+#include "softlight/SL_LightProcessor.hpp"
 #include "softlight/SL_ProcessorPool.hpp"
+#include "softlight/SL_Profiler.hpp"
 #include "softlight/SL_ShaderProcessor.hpp"
 #include "softlight/SL_ShaderUtil.hpp" // SL_FragmentBin
+#include "softlight/SL_VolumeRendering.hpp"
 
 
 
@@ -25,6 +33,31 @@ class SL_Framebuffer;
 
 
 
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+
+
+/*-------------------------------------
+ * Reset the pipeline statistics of each thread
+-------------------------------------*/
+inline void _sl_reset_thread_stats(SL_PipelineStatistics* pStats, unsigned numThreads) noexcept
+{
+    for (unsigned i = 0; i < numThreads; ++i)
+    {
+        sl_reset_pipeline_statistics(pStats[i]);
+    }
+}
+
+
+
+} // end anonymous namespace
+
+
+
 /*-----------------------------------------------------------------------------
  * SL_ProcessorPool Class
 -----------------------------------------------------------------------------*/
@@ -53,10 +86,15 @@ SL_ProcessorPool::SL_ProcessorPool(unsigned numThreads) noexcept :
     mFragBins{ls::utils::make_unique_aligned_array<SL_FragmentBin>(SL_SHADER_MAX_BINNED_PRIMS)},
     mFragQueues{ls::utils::make_unique_aligned_array<SL_FragCoord>(numThreads)},
     mWorkers{numThreads > 1 ? ls::utils::make_unique_aligned_array<SL_ProcessorPool::ThreadedWorker>(numThreads - 1) : nullptr},
-    mNumThreads{numThreads}
+    mStats{ls::utils::make_unique_aligned_array<SL_PipelineStatistics>(numThreads)},
+    mRetiredStats{},
+    mNumThreads{numThreads},
+    mPlacement{SL_THREAD_PLACEMENT_NONE}
 {
     LS_ASSERT(numThreads > 0);
 
+    _sl_reset_thread_stats(mStats.get(), numThreads);
+
     ls::utils::set_thread_affinity(ls::utils::get_thread_id(), 0);
 
     for (unsigned i = 0; i < numThreads-1u; ++i)
@@ -90,8 +128,13 @@ SL_ProcessorPool::SL_ProcessorPool(const SL_ProcessorPool& p) noexcept :
     mFragBins{ls::utils::make_unique_aligned_array<SL_FragmentBin>(SL_SHADER_MAX_BINNED_PRIMS)},
     mFragQueues{ls::utils::make_unique_aligned_array<SL_FragCoord>(p.mNumThreads)},
     mWorkers{p.mNumThreads > 1 ? ls::utils::make_unique_aligned_array<SL_ProcessorPool::ThreadedWorker>(p.mNumThreads - 1) : nullptr},
-    mNumThreads{p.mNumThreads}
+    mStats{ls::utils::make_unique_aligned_array<SL_PipelineStatistics>(p.mNumThreads)},
+    mRetiredStats{},
+    mNumThreads{p.mNumThreads},
+    mPlacement{p.mPlacement}
 {
+    _sl_reset_thread_stats(mStats.get(), p.mNumThreads);
+
     ls::utils::set_thread_affinity(ls::utils::get_thread_id(), 0);
 
     for (unsigned i = 0; i < p.mNumThreads-1u; ++i)
@@ -99,6 +142,7 @@ SL_ProcessorPool::SL_ProcessorPool(const SL_ProcessorPool& p) noexcept :
         new (&mWorkers[i]) ThreadedWorker{i+1};
     }
 
+    apply_placement();
     clear_fragment_bins();
 }
 
@@ -116,9 +160,14 @@ SL_ProcessorPool::SL_ProcessorPool(SL_ProcessorPool&& p) noexcept :
     mFragBins{std::move(p.mFragBins)},
     mFragQueues{std::move(p.mFragQueues)},
     mWorkers{std::move(p.mWorkers)},
-    mNumThreads{p.mNumThreads}
+    mStats{std::move(p.mStats)},
+    mRetiredStats{p.mRetiredStats},
+    mNumThreads{p.mNumThreads},
+    mPlacement{p.mPlacement}
 {
     p.mNumThreads = 1;
+    p.mPlacement = SL_THREAD_PLACEMENT_NONE;
+    sl_reset_pipeline_statistics(p.mRetiredStats);
 }
 
 
@@ -128,12 +177,12 @@ SL_ProcessorPool::SL_ProcessorPool(SL_ProcessorPool&& p) noexcept :
 --------------------------------------*/
 SL_ProcessorPool& SL_ProcessorPool::operator=(const SL_ProcessorPool& p) noexcept
 {
-    if (this == &p || concurrency() == p.concurrency())
+    if (this == &p || (concurrency() == p.concurrency() && placement() == p.placement()))
     {
         return *this;
     }
 
-    concurrency(p.concurrency());
+    concurrency(p.concurrency(), p.placement());
 
     return *this;
 }
@@ -165,9 +214,16 @@ SL_ProcessorPool& SL_ProcessorPool::operator=(SL_ProcessorPool&& p) noexcept
 
     mWorkers = std::move(p.mWorkers);
 
+    mStats = std::move(p.mStats);
+    mRetiredStats = p.mRetiredStats;
+    sl_reset_pipeline_statistics(p.mRetiredStats);
+
     mNumThreads = p.mNumThreads;
     p.mNumThreads = 1;
 
+    mPlacement = p.mPlacement;
+    p.mPlacement = SL_THREAD_PLACEMENT_NONE;
+
     return *this;
 }
 
@@ -240,6 +296,98 @@ void SL_ProcessorPool::wait() noexcept
 
 
 
+/*-------------------------------------
+ * Sum the statistics of all threads
+-------------------------------------*/
+SL_PipelineStatistics SL_ProcessorPool::statistics() const noexcept
+{
+    SL_PipelineStatistics ret = mRetiredStats;
+
+    if (mStats.get())
+    {
+        for (unsigned i = 0; i < mNumThreads; ++i)
+        {
+            sl_accumulate_pipeline_statistics(ret, mStats[i]);
+        }
+    }
+
+    // Depth-test failures are derived rather than counted by each
+    // rasterizer. Every rasterized fragment is either shaded or rejected by
+    // the depth test.
+    ret.fragsDepthFailed = ret.fragsRasterized - ret.fragsShaded;
+
+    return ret;
+}
+
+
+
+/*--------------------------------------
+ * Pin all threads to their CPUs
+--------------------------------------*/
+unsigned SL_ProcessorPool::apply_placement() noexcept
+{
+    SL_AlignedVector<uint16_t> cpuIds(mNumThreads);
+    SL_CpuTopology topology;
+    unsigned numPinned = 0;
+    std::atomic_uint numFailures{0};
+
+    if (mPlacement != SL_THREAD_PLACEMENT_NONE)
+    {
+        topology.load();
+        numPinned = topology.placement(mPlacement, mNumThreads, cpuIds.data());
+    }
+
+    // Without a placement, the main thread remains on CPU 0
+    if (!numPinned)
+    {
+        return 0;
+    }
+
+    if (sl_pin_current_thread(cpuIds[0]) != 0)
+    {
+        numFailures.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    SL_ShaderProcessor task;
+    task.mType = SL_AFFINITY_PROCESSOR;
+    task.mAffinity.mNumFailures = &numFailures;
+
+    for (unsigned threadId = 0; threadId < mNumThreads-1u; ++threadId)
+    {
+        task.mAffinity.mCpuId = cpuIds[threadId+1u];
+
+        SL_ProcessorPool::ThreadedWorker& worker = mWorkers[threadId];
+        worker.busy_waiting(false);
+        worker.push(task);
+    }
+
+    flush();
+    wait();
+
+    const unsigned numFailed = numFailures.load(std::memory_order_relaxed);
+    if (numFailed)
+    {
+        LS_LOG_ERR(
+            "Unable to pin ", numFailed, " of ", mNumThreads, " rendering threads using the \"",
+            sl_thread_placement_name(mPlacement), "\" placement.");
+    }
+
+    return numFailed;
+}
+
+
+
+/*--------------------------------------
+ * Set the number of threads and their placement
+--------------------------------------*/
+unsigned SL_ProcessorPool::concurrency(unsigned inNumThreads, SL_ThreadPlacement placement) noexcept
+{
+    mPlacement = placement;
+    return concurrency(inNumThreads);
+}
+
+
+
 /*--------------------------------------
  * Set the number of threads
 --------------------------------------*/
@@ -259,6 +407,11 @@ unsigned SL_ProcessorPool::concurrency(unsigned inNumThreads) noexcept
     mFragBins = ls::utils::make_unique_aligned_array<SL_FragmentBin>(SL_SHADER_MAX_BINNED_PRIMS);
     mFragQueues = ls::utils::make_unique_aligned_array<SL_FragCoord>(inNumThreads);
 
+    // Keep the counters monotonic so active queries remain valid
+    mRetiredStats = statistics();
+    mStats = ls::utils::make_unique_aligned_array<SL_PipelineStatistics>(inNumThreads);
+    _sl_reset_thread_stats(mStats.get(), inNumThreads);
+
     mWorkers.reset();
     if (inNumThreads > 1)
     {
@@ -273,11 +426,13 @@ unsigned SL_ProcessorPool::concurrency(unsigned inNumThreads) noexcept
     }
 
     mNumThreads = inNumThreads;
+    apply_placement();
     clear_fragment_bins();
 
     LS_LOG_MSG(
         "Rendering threads updated:"
         "\n\tThread Count:       ", inNumThreads,
+        "\n\tThread Placement:   ", sl_thread_placement_name(mPlacement),
         "\n\tBytes per Task:     ", sizeof(SL_ShaderProcessor),
         "\n\tBytes of Task Pool: ", sizeof(SL_ProcessorPool),
         "\n\tVertex Task Size:   ", sizeof(SL_VertexProcessor),
@@ -294,6 +449,9 @@ unsigned SL_ProcessorPool::concurrency(unsigned inNumThreads) noexcept
 -------------------------------------*/
 void SL_ProcessorPool::run_shader_processors(const SL_Context& c, const SL_Mesh& m, size_t numInstances, const SL_Shader& s, SL_Framebuffer& fbo) noexcept
 {
+    // The main thread processes vertices using the last thread ID.
+    SL_PROFILE_SCOPE(SL_PROFILE_DRAW, mNumThreads-1u);
+
     // Reserve enough space for each thread to contain all triangles
     mFragSemaphore->count.store(0);
     mShadingSemaphore->count.store(mNumThreads);
@@ -320,6 +478,8 @@ void SL_ProcessorPool::run_shader_processors(const SL_Context& c, const SL_Mesh&
     vertTask->mTempBinIds     = mTempBinIds.get();
     vertTask->mFragBins       = mFragBins.get();
     vertTask->mFragQueues     = mFragQueues.get();
+    vertTask->mStats          = mStats.get();
+    vertTask->mDirtyRegion    = c.dirty_region();
 
     // Divide all vertex processing amongst the available worker threads. Let
     // The threads work out between themselves how to partition the data.
@@ -350,6 +510,9 @@ void SL_ProcessorPool::run_shader_processors(const SL_Context& c, const SL_Mesh&
 -------------------------------------*/
 void SL_ProcessorPool::run_shader_processors(const SL_Context& c, const SL_Mesh* meshes, size_t numMeshes, const SL_Shader& s, SL_Framebuffer& fbo) noexcept
 {
+    // The main thread processes vertices using the last thread ID.
+    SL_PROFILE_SCOPE(SL_PROFILE_DRAW, mNumThreads-1u);
+
     // Reserve enough space for each thread to contain all triangles
     mFragSemaphore->count.store(0);
     mShadingSemaphore->count.store(mNumThreads);
@@ -376,6 +539,8 @@ void SL_ProcessorPool::run_shader_processors(const SL_Context& c, const SL_Mesh*
     vertTask->mTempBinIds     = mTempBinIds.get();
     vertTask->mFragBins       = mFragBins.get();
     vertTask->mFragQueues     = mFragQueues.get();
+    vertTask->mStats          = mStats.get();
+    vertTask->mDirtyRegion    = c.dirty_region();
 
     // Divide all vertex processing amongst the available worker threads. Let
     // The threads work out between themselves how to partition the data.
@@ -424,8 +589,16 @@ void SL_ProcessorPool::run_blit_processors(
     uint16_t dstX0,
     uint16_t dstY0,
     uint16_t dstX1,
-    uint16_t dstY1) noexcept
+    uint16_t dstY1,
+    const SL_ToneMap* toneMap) noexcept
 {
+    // Compressed sources, and destinations with half-float, packed, sRGB,
+    // or compressed texels have no conversion routines.
+    if (!SL_BlitProcessor::is_blittable(inTex->type(), outTex->type()))
+    {
+        return;
+    }
+
     SL_ShaderProcessor processor;
     processor.mType = SL_BLIT_PROCESSOR;
 
@@ -442,6 +615,7 @@ void SL_ProcessorPool::run_blit_processors(
     blitter.dstY1             = dstY1;
     blitter.mTexture          = inTex;
     blitter.mBackBuffer       = outTex;
+    blitter.mToneMap          = toneMap;
 
     // Process most of the rendering on other threads first.
     for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
@@ -466,7 +640,7 @@ void SL_ProcessorPool::run_blit_processors(
 /*-------------------------------------
  * Clear a framebuffer's attachment across threads
 -------------------------------------*/
-void SL_ProcessorPool::run_clear_processors(const void* inColor, SL_Texture* outTex) noexcept
+void SL_ProcessorPool::run_clear_processors(const void* inColor, SL_Texture* outTex, const SL_DamageRegion* region) noexcept
 {
     SL_ShaderProcessor processor;
     processor.mType = SL_CLEAR_PROCESSOR;
@@ -474,6 +648,7 @@ void SL_ProcessorPool::run_clear_processors(const void* inColor, SL_Texture* out
     SL_ClearProcessor& blitter = processor.mClear;
     blitter.mThreadId         = 0;
     blitter.mNumThreads       = (uint16_t)mNumThreads;
+    blitter.mRegion           = region;
     blitter.mTexture          = inColor;
     blitter.mBackBuffer       = outTex;
 
@@ -500,7 +675,7 @@ void SL_ProcessorPool::run_clear_processors(const void* inColor, SL_Texture* out
 /*-------------------------------------
  * Clear a framebuffer across threads
 -------------------------------------*/
-void SL_ProcessorPool::run_clear_processors(const void* inColor, const void* depth, SL_Texture* colorBuf, SL_Texture* depthBuf) noexcept
+void SL_ProcessorPool::run_clear_processors(const void* inColor, const void* depth, SL_Texture* colorBuf, SL_Texture* depthBuf, const SL_DamageRegion* region) noexcept
 {
     SL_ShaderProcessor processor;
     processor.mType = SL_CLEAR_PROCESSOR;
@@ -508,6 +683,7 @@ void SL_ProcessorPool::run_clear_processors(const void* inColor, const void* dep
     SL_ClearProcessor& blitter = processor.mClear;
     blitter.mThreadId         = 0;
     blitter.mNumThreads       = (uint16_t)mNumThreads;
+    blitter.mRegion           = region;
 
     // Process most of the rendering on other threads first.
     for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
@@ -546,7 +722,7 @@ void SL_ProcessorPool::run_clear_processors(const void* inColor, const void* dep
 /*-------------------------------------
  * Clear a framebuffer across threads (2 attachments)
 -------------------------------------*/
-void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 2>& inColors, const void* depth, const std::array<SL_Texture*, 2>& colorBufs, SL_Texture* depthBuf) noexcept
+void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 2>& inColors, const void* depth, const std::array<SL_Texture*, 2>& colorBufs, SL_Texture* depthBuf, const SL_DamageRegion* region) noexcept
 {
     SL_ShaderProcessor processor;
     processor.mType = SL_CLEAR_PROCESSOR;
@@ -554,6 +730,7 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 2>& in
     SL_ClearProcessor& blitter = processor.mClear;
     blitter.mThreadId         = 0;
     blitter.mNumThreads       = (uint16_t)mNumThreads;
+    blitter.mRegion           = region;
 
     // Process most of the rendering on other threads first.
     for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
@@ -600,7 +777,7 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 2>& in
 /*-------------------------------------
  * Clear a framebuffer across threads (3 attachments)
 -------------------------------------*/
-void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 3>& inColors, const void* depth, const std::array<SL_Texture*, 3>& colorBufs, SL_Texture* depthBuf) noexcept
+void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 3>& inColors, const void* depth, const std::array<SL_Texture*, 3>& colorBufs, SL_Texture* depthBuf, const SL_DamageRegion* region) noexcept
 {
     SL_ShaderProcessor processor;
     processor.mType = SL_CLEAR_PROCESSOR;
@@ -608,6 +785,7 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 3>& in
     SL_ClearProcessor& blitter = processor.mClear;
     blitter.mThreadId         = 0;
     blitter.mNumThreads       = (uint16_t)mNumThreads;
+    blitter.mRegion           = region;
 
     // Process most of the rendering on other threads first.
     for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
@@ -662,7 +840,7 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 3>& in
 /*-------------------------------------
  * Clear a framebuffer across threads (4 attachments)
 -------------------------------------*/
-void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 4>& inColors, const void* depth, const std::array<SL_Texture*, 4>& colorBufs, SL_Texture* depthBuf) noexcept
+void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 4>& inColors, const void* depth, const std::array<SL_Texture*, 4>& colorBufs, SL_Texture* depthBuf, const SL_DamageRegion* region) noexcept
 {
     SL_ShaderProcessor processor;
     processor.mType = SL_CLEAR_PROCESSOR;
@@ -670,6 +848,7 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 4>& in
     SL_ClearProcessor& blitter = processor.mClear;
     blitter.mThreadId         = 0;
     blitter.mNumThreads       = (uint16_t)mNumThreads;
+    blitter.mRegion           = region;
 
     // Process most of the rendering on other threads first.
     for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
@@ -726,3 +905,190 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 4>& in
     // Each thread should now pause except for the main thread.
     wait();
 }
+
+
+
+/*-------------------------------------
+ * Run the tiled deferred lighting pass across threads
+-------------------------------------*/
+void SL_ProcessorPool::run_light_processors(
+    const SL_PointLight* lights,
+    uint32_t numLights,
+    const ls::math::mat4_t<float>& projection,
+    const ls::math::vec4_t<float>& ambient,
+    const SL_Framebuffer& gbuffer,
+    SL_Texture* outTex) noexcept
+{
+    SL_ShaderProcessor processor;
+    processor.mType = SL_LIGHT_PROCESSOR;
+
+    SL_LightProcessor& lighting = processor.mLighting;
+    lighting.mThreadId          = 0;
+    lighting.mNumThreads        = (uint16_t)mNumThreads;
+    lighting.mNumLights         = numLights;
+    lighting.mLights            = lights;
+    lighting.mProjection        = &projection;
+    lighting.mAmbient           = &ambient;
+    lighting.mAlbedo            = gbuffer.get_color_buffer(SL_GBUFFER_ALBEDO);
+    lighting.mNormals           = gbuffer.get_color_buffer(SL_GBUFFER_NORMAL);
+    lighting.mPositions         = gbuffer.get_color_buffer(SL_GBUFFER_POSITION);
+    lighting.mBackBuffer        = outTex;
+
+    // Process most of the rendering on other threads first.
+    for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
+    {
+        lighting.mThreadId = threadId;
+
+        SL_ProcessorPool::ThreadedWorker& worker = mWorkers[threadId];
+        worker.busy_waiting(false);
+        worker.push(processor);
+    }
+
+    flush();
+    lighting.mThreadId = (uint16_t)(mNumThreads - 1u);
+    lighting.execute();
+
+    // Each thread should now pause except for the main thread.
+    wait();
+}
+
+
+
+/*-------------------------------------
+ * Assign lights to clusters across threads
+-------------------------------------*/
+void SL_ProcessorPool::run_cluster_processors(SL_LightClusters& clusters, const SL_PointLight* lights, uint32_t numLights) noexcept
+{
+    SL_ShaderProcessor processor;
+    processor.mType = SL_CLUSTER_PROCESSOR;
+
+    SL_ClusterProcessor& clusterer = processor.mClusterer;
+    clusterer.mThreadId            = 0;
+    clusterer.mNumThreads          = (uint16_t)mNumThreads;
+    clusterer.mNumLights           = numLights;
+    clusterer.mLights              = lights;
+    clusterer.mClusters            = &clusters;
+
+    // Process most of the rendering on other threads first.
+    for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
+    {
+        clusterer.mThreadId = threadId;
+
+        SL_ProcessorPool::ThreadedWorker& worker = mWorkers[threadId];
+        worker.busy_waiting(false);
+        worker.push(processor);
+    }
+
+    flush();
+    clusterer.mThreadId = (uint16_t)(mNumThreads - 1u);
+    clusterer.execute();
+
+    // Each thread should now pause except for the main thread.
+    wait();
+}
+
+
+
+/*-------------------------------------
+ * Resolve weighted-blended transparency across threads
+-------------------------------------*/
+void SL_ProcessorPool::run_composite_processors(const SL_Texture* accum, const SL_Texture* revealage, SL_Texture* outTex) noexcept
+{
+    SL_ShaderProcessor processor;
+    processor.mType = SL_COMPOSITE_PROCESSOR;
+
+    SL_CompositeProcessor& composite = processor.mComposite;
+    composite.mThreadId              = 0;
+    composite.mNumThreads            = (uint16_t)mNumThreads;
+    composite.mAccum                 = accum;
+    composite.mRevealage             = revealage;
+    composite.mBackBuffer            = outTex;
+
+    // Process most of the rendering on other threads first.
+    for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
+    {
+        composite.mThreadId = threadId;
+
+        SL_ProcessorPool::ThreadedWorker& worker = mWorkers[threadId];
+        worker.busy_waiting(false);
+        worker.push(processor);
+    }
+
+    flush();
+    composite.mThreadId = (uint16_t)(mNumThreads - 1u);
+    composite.execute();
+
+    // Each thread should now pause except for the main thread.
+    wait();
+}
+
+
+
+/*-------------------------------------
+ * Build a volume's brick grid across threads
+-------------------------------------*/
+void SL_ProcessorPool::run_volume_processors(const SL_Texture& volume, SL_VolumeBricks& bricks, SL_TexelOrder texelOrder) noexcept
+{
+    SL_ShaderProcessor processor;
+    processor.mType = SL_VOLUME_PROCESSOR;
+
+    SL_VolumeProcessor& volumeProcessor = processor.mVolume;
+    volumeProcessor.mThreadId           = 0;
+    volumeProcessor.mNumThreads         = (uint16_t)mNumThreads;
+    volumeProcessor.mTexelOrder         = texelOrder;
+    volumeProcessor.mVolume             = &volume;
+    volumeProcessor.mBricks             = &bricks;
+
+    // Process most of the bricks on other threads first.
+    for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
+    {
+        volumeProcessor.mThreadId = threadId;
+
+        SL_ProcessorPool::ThreadedWorker& worker = mWorkers[threadId];
+        worker.busy_waiting(false);
+        worker.push(processor);
+    }
+
+    flush();
+    volumeProcessor.mThreadId = (uint16_t)(mNumThreads - 1u);
+    volumeProcessor.execute();
+
+    // Each thread should now pause except for the main thread.
+    wait();
+}
+
+
+
+/*-------------------------------------
+ * Upload and convert texels across threads
+-------------------------------------*/
+void SL_ProcessorPool::run_tex_upload_processors(const void* pTexels, SL_ColorDataType srcType, SL_TexelOrder srcOrder, SL_Texture& outTex) noexcept
+{
+    SL_ShaderProcessor processor;
+    processor.mType = SL_TEX_UPLOAD_PROCESSOR;
+
+    SL_TexUploadProcessor& uploader = processor.mTexUpload;
+    uploader.mThreadId              = 0;
+    uploader.mNumThreads            = (uint16_t)mNumThreads;
+    uploader.mSrcType               = srcType;
+    uploader.mSrcOrder              = srcOrder;
+    uploader.mSrcTexels             = pTexels;
+    uploader.mTexture               = &outTex;
+
+    // Process most of the texels on other threads first.
+    for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
+    {
+        uploader.mThreadId = threadId;
+
+        SL_ProcessorPool::ThreadedWorker& worker = mWorkers[threadId];
+        worker.busy_waiting(false);
+        worker.push(processor);
+    }
+
+    flush();
+    uploader.mThreadId = (uint16_t)(mNumThreads - 1u);
+    uploader.execute();
+
+    // Each thread should now pause except for the main thread.
+    wait();
+}
@@ -0,0 +1,327 @@
+
+#include "softlight/SL_Profiler.hpp"
+
+#if SL_PROFILING_ENABLED
+    #include <atomic>
+    #include <chrono>
+    #include <fstream>
+    #include <iomanip> // std::setprecision
+    #include <memory> // std::unique_ptr
+    #include <new> // std::nothrow
+#endif /* SL_PROFILING_ENABLED */
+
+
+
+/*-----------------------------------------------------------------------------
+ * Stage Names
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Retrieve a human-readable name for a pipeline stage
+-------------------------------------*/
+const char* sl_profile_stage_name(SL_ProfileStage stage) noexcept
+{
+    switch (stage)
+    {
+        case SL_PROFILE_DRAW:         return "draw";
+        case SL_PROFILE_VERTEX:       return "vertex";
+        case SL_PROFILE_CLIP:         return "clip";
+        case SL_PROFILE_FLUSH:        return "flush_rasterizer";
+        case SL_PROFILE_BIN_SORT:     return "bin_sort";
+        case SL_PROFILE_RASTER:       return "raster";
+        case SL_PROFILE_BARRIER_WAIT: return "barrier_wait";
+        case SL_PROFILE_BLIT:         return "blit";
+        case SL_PROFILE_CLEAR:        return "clear";
+
+        default:
+            break;
+    }
+
+    return "unknown";
+}
+
+
+
+#if SL_PROFILING_ENABLED
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helpers
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+
+
+/*-------------------------------------
+ * Per-thread event storage, padded to avoid false sharing between threads.
+-------------------------------------*/
+struct alignas(64) _SL_ProfileThread
+{
+    std::unique_ptr<SL_ProfileEvent[]> events;
+    uint64_t numEvents;
+    uint64_t numDropped;
+};
+
+_SL_ProfileThread _slProfileThreads[SL_PROFILER_MAX_THREADS];
+
+std::atomic<bool> _slProfileActive{false};
+
+std::chrono::steady_clock::time_point _slProfileStart;
+
+thread_local SL_ProfileTotal* _slRunningTotal = nullptr;
+
+
+
+/*-------------------------------------
+ * Add an event to the buffer of the thread which recorded it
+-------------------------------------*/
+void _sl_profiler_push(const SL_ProfileEvent& e) noexcept
+{
+    if (e.threadId >= SL_PROFILER_MAX_THREADS)
+    {
+        return;
+    }
+
+    _SL_ProfileThread& t = _slProfileThreads[e.threadId];
+
+    if (!t.events || t.numEvents >= SL_PROFILER_MAX_EVENTS)
+    {
+        ++t.numDropped;
+        return;
+    }
+
+    t.events[t.numEvents++] = e;
+}
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Profiler Control
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Begin recording events
+-------------------------------------*/
+int sl_profiler_begin(unsigned numThreads) noexcept
+{
+    if (!numThreads || numThreads > SL_PROFILER_MAX_THREADS)
+    {
+        return -1;
+    }
+
+    for (unsigned threadId = 0; threadId < SL_PROFILER_MAX_THREADS; ++threadId)
+    {
+        _SL_ProfileThread& t = _slProfileThreads[threadId];
+
+        if (threadId >= numThreads)
+        {
+            t.events.reset();
+        }
+        else if (!t.events)
+        {
+            t.events.reset(new(std::nothrow) SL_ProfileEvent[SL_PROFILER_MAX_EVENTS]);
+            if (!t.events)
+            {
+                sl_profiler_terminate();
+                return -1;
+            }
+        }
+
+        t.numEvents = 0;
+        t.numDropped = 0;
+    }
+
+    _slProfileStart = std::chrono::steady_clock::now();
+    _slProfileActive.store(true, std::memory_order_release);
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Stop recording events
+-------------------------------------*/
+void sl_profiler_end() noexcept
+{
+    _slProfileActive.store(false, std::memory_order_release);
+}
+
+
+
+/*-------------------------------------
+ * Free all event buffers
+-------------------------------------*/
+void sl_profiler_terminate() noexcept
+{
+    sl_profiler_end();
+
+    for (_SL_ProfileThread& t : _slProfileThreads)
+    {
+        t.events.reset();
+        t.numEvents = 0;
+        t.numDropped = 0;
+    }
+}
+
+
+
+/*-------------------------------------
+ * Check if events are being recorded
+-------------------------------------*/
+bool sl_profiler_active() noexcept
+{
+    return _slProfileActive.load(std::memory_order_relaxed);
+}
+
+
+
+/*-------------------------------------
+ * Current time since the start of recording
+-------------------------------------*/
+uint64_t sl_profiler_time() noexcept
+{
+    const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - _slProfileStart;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+
+
+/*-------------------------------------
+ * Add an event to a thread's buffer
+-------------------------------------*/
+void sl_profiler_record(SL_ProfileStage stage, uint16_t threadId, uint64_t beginTime, uint64_t endTime) noexcept
+{
+    _sl_profiler_push(SL_ProfileEvent{beginTime, endTime, stage, threadId, SL_PROFILE_EVENT_SPAN});
+}
+
+
+
+/*-------------------------------------
+ * Add an accumulated event to a thread's buffer
+-------------------------------------*/
+void sl_profiler_record_total(SL_ProfileStage stage, uint16_t threadId, uint64_t sampleTime, uint64_t totalTime) noexcept
+{
+    _sl_profiler_push(SL_ProfileEvent{sampleTime, sampleTime + totalTime, stage, threadId, SL_PROFILE_EVENT_TOTAL});
+}
+
+
+
+/*-------------------------------------
+ * Accumulator timing the calling thread
+-------------------------------------*/
+SL_ProfileTotal*& sl_profiler_running_total() noexcept
+{
+    return _slRunningTotal;
+}
+
+
+
+/*-------------------------------------
+ * Count the number of recorded events
+-------------------------------------*/
+uint64_t sl_profiler_num_events() noexcept
+{
+    uint64_t numEvents = 0;
+
+    for (const _SL_ProfileThread& t : _slProfileThreads)
+    {
+        numEvents += t.numEvents;
+    }
+
+    return numEvents;
+}
+
+
+
+/*-------------------------------------
+ * Count the number of dropped events
+-------------------------------------*/
+uint64_t sl_profiler_num_dropped() noexcept
+{
+    uint64_t numDropped = 0;
+
+    for (const _SL_ProfileThread& t : _slProfileThreads)
+    {
+        numDropped += t.numDropped;
+    }
+
+    return numDropped;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Trace Export
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Save events in the Chrome trace_event format
+-------------------------------------*/
+int sl_profiler_save_trace(const char* const pFilename) noexcept
+{
+    if (!sl_profiler_num_events())
+    {
+        return -1;
+    }
+
+    std::ofstream f{pFilename, std::ofstream::out | std::ofstream::binary};
+    if (!f.good())
+    {
+        return -2;
+    }
+
+    // Timestamps are written in microseconds, as required by the format.
+    f << std::fixed << std::setprecision(3);
+    f << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    bool firstEvent = true;
+
+    for (uint16_t threadId = 0; threadId < SL_PROFILER_MAX_THREADS; ++threadId)
+    {
+        const _SL_ProfileThread& t = _slProfileThreads[threadId];
+        if (!t.numEvents)
+        {
+            continue;
+        }
+
+        f << (firstEvent ? "\n" : ",\n");
+        f << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << threadId
+          << ",\"args\":{\"name\":\"SL Thread " << threadId << "\"}}";
+        firstEvent = false;
+
+        for (uint64_t i = 0; i < t.numEvents; ++i)
+        {
+            const SL_ProfileEvent& e = t.events[i];
+
+            // Accumulated time is spread across other events on the same
+            // thread, so it's shown as a per-thread counter (in microseconds)
+            // instead of a span which would overlap them.
+            if (e.type == SL_PROFILE_EVENT_TOTAL)
+            {
+                f << ",\n{\"name\":\"" << sl_profile_stage_name(e.stage)
+                  << "\",\"cat\":\"softlight\",\"ph\":\"C\",\"pid\":0,\"tid\":" << e.threadId
+                  << ",\"id\":" << e.threadId
+                  << ",\"ts\":" << ((double)e.beginTime * 1.0e-3)
+                  << ",\"args\":{\"us\":" << ((double)(e.endTime - e.beginTime) * 1.0e-3) << "}}";
+                continue;
+            }
+
+            f << ",\n{\"name\":\"" << sl_profile_stage_name(e.stage)
+              << "\",\"cat\":\"softlight\",\"ph\":\"X\",\"pid\":0,\"tid\":" << e.threadId
+              << ",\"ts\":" << ((double)e.beginTime * 1.0e-3)
+              << ",\"dur\":" << ((double)(e.endTime - e.beginTime) * 1.0e-3)
+              << '}';
+        }
+    }
+
+    f << "\n]}\n";
+    f.close();
+
+    return f.fail() ? -3 : 0;
+}
+
+
+
+#endif /* SL_PROFILING_ENABLED */
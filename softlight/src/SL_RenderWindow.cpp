@@ -3,6 +3,9 @@
 
 #include "lightsky/setup/OS.h" // OS detection
 
+#include "softlight/SL_RenderWindowHeadless.hpp"
+#include "softlight/SL_WindowBuffer.hpp"
+
 #ifdef LS_OS_WINDOWS
     #include "softlight/SL_RenderWindowWin32.hpp"
 #elif defined(SL_PREFER_COCOA)
@@ -27,7 +30,9 @@ SL_RenderWindow::~SL_RenderWindow() noexcept
  * Constructor
 -------------------------------------*/
 SL_RenderWindow::SL_RenderWindow() noexcept :
-  mCurrentState{WindowStateInfo::WINDOW_CLOSED}
+  mCurrentState{WindowStateInfo::WINDOW_CLOSED},
+  mPresentsQueued{0},
+  mPresentsCompleted{0}
 {}
 
 
@@ -36,7 +41,9 @@ SL_RenderWindow::SL_RenderWindow() noexcept :
  * Copy Constructor
 -------------------------------------*/
 SL_RenderWindow::SL_RenderWindow(const SL_RenderWindow& rw) noexcept :
-  mCurrentState{rw.mCurrentState}
+  mCurrentState{rw.mCurrentState},
+  mPresentsQueued{0},
+  mPresentsCompleted{0}
 {}
 
 
@@ -45,9 +52,13 @@ SL_RenderWindow::SL_RenderWindow(const SL_RenderWindow& rw) noexcept :
  * Move Constructor
 -------------------------------------*/
 SL_RenderWindow::SL_RenderWindow(SL_RenderWindow&& rw) noexcept :
-  mCurrentState{rw.mCurrentState}
+  mCurrentState{rw.mCurrentState},
+  mPresentsQueued{rw.mPresentsQueued},
+  mPresentsCompleted{rw.mPresentsCompleted}
 {
   rw.mCurrentState = WindowStateInfo::WINDOW_CLOSED;
+  rw.mPresentsQueued = 0;
+  rw.mPresentsCompleted = 0;
 }
 
 
@@ -58,6 +69,8 @@ SL_RenderWindow::SL_RenderWindow(SL_RenderWindow&& rw) noexcept :
 SL_RenderWindow& SL_RenderWindow::operator=(const SL_RenderWindow& rw) noexcept
 {
   mCurrentState = rw.mCurrentState;
+  mPresentsQueued = 0;
+  mPresentsCompleted = 0;
   return *this;
 }
 
@@ -70,6 +83,13 @@ SL_RenderWindow& SL_RenderWindow::operator=(SL_RenderWindow&& rw) noexcept
 {
   mCurrentState = rw.mCurrentState;
   rw.mCurrentState = WindowStateInfo::WINDOW_CLOSED;
+
+  mPresentsQueued = rw.mPresentsQueued;
+  rw.mPresentsQueued = 0;
+
+  mPresentsCompleted = rw.mPresentsCompleted;
+  rw.mPresentsCompleted = 0;
+
   return *this;
 }
 
@@ -94,3 +114,59 @@ ls::utils::Pointer<SL_RenderWindow> SL_RenderWindow::create() noexcept
         #error "Window buffer backend not implemented for this platform."
     #endif
 }
+
+
+
+/*-------------------------------------
+ * Headless Instance Creation
+-------------------------------------*/
+ls::utils::Pointer<SL_RenderWindow> SL_RenderWindow::create_headless() noexcept
+{
+    return ls::utils::Pointer<SL_RenderWindow>{new SL_RenderWindowHeadless{}};
+}
+
+
+
+/*-------------------------------------
+ * Present the damaged regions of a window buffer
+-------------------------------------*/
+void SL_RenderWindow::render_damage(SL_WindowBuffer& buffer) noexcept
+{
+    if (!buffer.damage().empty())
+    {
+        render(buffer);
+        buffer.damage().clear();
+    }
+}
+
+
+
+/*-------------------------------------
+ * Present a window buffer (synchronous fallback)
+-------------------------------------*/
+uint64_t SL_RenderWindow::present(SL_WindowBuffer& buffer) noexcept
+{
+    render(buffer);
+
+    mPresentsCompleted = ++mPresentsQueued;
+    return mPresentsQueued;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the last frame which has been presented
+-------------------------------------*/
+uint64_t SL_RenderWindow::presents_completed() noexcept
+{
+    return mPresentsCompleted;
+}
+
+
+
+/*-------------------------------------
+ * Wait for a frame to finish presenting
+-------------------------------------*/
+void SL_RenderWindow::wait_for_present(uint64_t) noexcept
+{
+}
@@ -0,0 +1,402 @@
+
+#include <new> // std::nothrow
+#include <utility> // std::move()
+
+#include "lightsky/utils/Assertions.h"
+
+#include "softlight/SL_RenderWindowHeadless.hpp"
+#include "softlight/SL_WindowBuffer.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_RenderWindowHeadless Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Destructor
+-------------------------------------*/
+SL_RenderWindowHeadless::~SL_RenderWindowHeadless() noexcept
+{
+    destroy();
+}
+
+
+
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_RenderWindowHeadless::SL_RenderWindowHeadless() noexcept :
+    SL_RenderWindow{},
+    mWidth{0},
+    mHeight{0},
+    mX{0},
+    mY{0},
+    mKeysRepeat{false},
+    mCaptureMouse{false},
+    mLastFrame{nullptr}
+{}
+
+
+
+/*-------------------------------------
+ * Copy Constructor
+-------------------------------------*/
+SL_RenderWindowHeadless::SL_RenderWindowHeadless(const SL_RenderWindowHeadless& rw) noexcept :
+    SL_RenderWindow{rw},
+    mWidth{rw.mWidth},
+    mHeight{rw.mHeight},
+    mX{rw.mX},
+    mY{rw.mY},
+    mKeysRepeat{rw.mKeysRepeat},
+    mCaptureMouse{rw.mCaptureMouse},
+    mLastFrame{nullptr}
+{}
+
+
+
+/*-------------------------------------
+ * Move Constructor
+-------------------------------------*/
+SL_RenderWindowHeadless::SL_RenderWindowHeadless(SL_RenderWindowHeadless&& rw) noexcept :
+    SL_RenderWindow{std::move(rw)},
+    mWidth{rw.mWidth},
+    mHeight{rw.mHeight},
+    mX{rw.mX},
+    mY{rw.mY},
+    mKeysRepeat{rw.mKeysRepeat},
+    mCaptureMouse{rw.mCaptureMouse},
+    mLastFrame{rw.mLastFrame}
+{
+    rw.mWidth = 0;
+    rw.mHeight = 0;
+    rw.mX = 0;
+    rw.mY = 0;
+    rw.mKeysRepeat = false;
+    rw.mCaptureMouse = false;
+    rw.mLastFrame = nullptr;
+}
+
+
+
+/*-------------------------------------
+ * Copy Operator
+-------------------------------------*/
+SL_RenderWindowHeadless& SL_RenderWindowHeadless::operator=(const SL_RenderWindowHeadless& rw) noexcept
+{
+    if (this != &rw)
+    {
+        SL_RenderWindow::operator=(rw);
+
+        mWidth = rw.mWidth;
+        mHeight = rw.mHeight;
+        mX = rw.mX;
+        mY = rw.mY;
+        mKeysRepeat = rw.mKeysRepeat;
+        mCaptureMouse = rw.mCaptureMouse;
+        mLastFrame = nullptr;
+    }
+
+    return *this;
+}
+
+
+
+/*-------------------------------------
+ * Move Operator
+-------------------------------------*/
+SL_RenderWindowHeadless& SL_RenderWindowHeadless::operator=(SL_RenderWindowHeadless&& rw) noexcept
+{
+    if (this != &rw)
+    {
+        SL_RenderWindow::operator=(std::move(rw));
+
+        mWidth = rw.mWidth;
+        rw.mWidth = 0;
+
+        mHeight = rw.mHeight;
+        rw.mHeight = 0;
+
+        mX = rw.mX;
+        rw.mX = 0;
+
+        mY = rw.mY;
+        rw.mY = 0;
+
+        mKeysRepeat = rw.mKeysRepeat;
+        rw.mKeysRepeat = false;
+
+        mCaptureMouse = rw.mCaptureMouse;
+        rw.mCaptureMouse = false;
+
+        mLastFrame = rw.mLastFrame;
+        rw.mLastFrame = nullptr;
+    }
+
+    return *this;
+}
+
+
+
+/*-------------------------------------
+ * Set the window title (no-op)
+-------------------------------------*/
+int SL_RenderWindowHeadless::set_title(const char* const) noexcept
+{
+    return valid() ? 0 : -1;
+}
+
+
+
+/*-------------------------------------
+ * Window Initialization
+-------------------------------------*/
+int SL_RenderWindowHeadless::init(unsigned width, unsigned height) noexcept
+{
+    if (valid())
+    {
+        return -1;
+    }
+
+    if (!width || !height)
+    {
+        return -2;
+    }
+
+    mWidth = width;
+    mHeight = height;
+    mCurrentState = WindowStateInfo::WINDOW_STARTED;
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Window Destruction
+-------------------------------------*/
+int SL_RenderWindowHeadless::destroy() noexcept
+{
+    mCurrentState = WindowStateInfo::WINDOW_CLOSED;
+    mPresentsQueued = 0;
+    mPresentsCompleted = 0;
+
+    mWidth = 0;
+    mHeight = 0;
+    mX = 0;
+    mY = 0;
+    mKeysRepeat = false;
+    mCaptureMouse = false;
+    mLastFrame = nullptr;
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Set the window size
+-------------------------------------*/
+bool SL_RenderWindowHeadless::set_size(unsigned width, unsigned height) noexcept
+{
+    if (!valid() || !width || !height)
+    {
+        return false;
+    }
+
+    mWidth = width;
+    mHeight = height;
+
+    return true;
+}
+
+
+
+/*-------------------------------------
+ * Set the window position
+-------------------------------------*/
+bool SL_RenderWindowHeadless::set_position(int x, int y) noexcept
+{
+    if (!valid())
+    {
+        return false;
+    }
+
+    mX = x;
+    mY = y;
+
+    return true;
+}
+
+
+
+/*-------------------------------------
+ * Create a copy of the current window
+-------------------------------------*/
+SL_RenderWindow* SL_RenderWindowHeadless::clone() const noexcept
+{
+    const SL_RenderWindowHeadless& self = *this; // nullptr check
+
+    SL_RenderWindowHeadless* pWindow = new(std::nothrow) SL_RenderWindowHeadless(self);
+
+    return pWindow;
+}
+
+
+
+/*-------------------------------------
+ * Check if the window was initialized
+-------------------------------------*/
+bool SL_RenderWindowHeadless::valid() const noexcept
+{
+    return mWidth != 0 && mHeight != 0;
+}
+
+
+
+/*-------------------------------------
+ * Update the window state (no events are generated)
+-------------------------------------*/
+void SL_RenderWindowHeadless::update() noexcept
+{
+}
+
+
+
+/*-------------------------------------
+ * Pause the window
+-------------------------------------*/
+bool SL_RenderWindowHeadless::pause() noexcept
+{
+    if (!valid())
+    {
+        return false;
+    }
+
+    switch (mCurrentState)
+    {
+        case WindowStateInfo::WINDOW_STARTED:
+        case WindowStateInfo::WINDOW_RUNNING:
+        case WindowStateInfo::WINDOW_PAUSED:
+        case WindowStateInfo::WINDOW_CLOSING:
+            mCurrentState = WindowStateInfo::WINDOW_PAUSED;
+            break;
+
+        case WindowStateInfo::WINDOW_CLOSED:
+        case WindowStateInfo::WINDOW_STARTING:
+            LS_ASSERT(false); // fail in case of error
+            break;
+    }
+
+    return true;
+}
+
+
+
+/*-------------------------------------
+ * Run the window
+-------------------------------------*/
+bool SL_RenderWindowHeadless::run() noexcept
+{
+    if (!valid())
+    {
+        return false;
+    }
+
+    switch (mCurrentState)
+    {
+        case WindowStateInfo::WINDOW_STARTED:
+        case WindowStateInfo::WINDOW_CLOSING:
+        case WindowStateInfo::WINDOW_RUNNING:
+        case WindowStateInfo::WINDOW_PAUSED:
+            mCurrentState = WindowStateInfo::WINDOW_RUNNING;
+            break;
+
+        case WindowStateInfo::WINDOW_CLOSED:
+        case WindowStateInfo::WINDOW_STARTING:
+            LS_ASSERT(false); // fail in case of error
+            break;
+    }
+
+    return true;
+}
+
+
+
+/*-------------------------------------
+ * Check for events
+-------------------------------------*/
+bool SL_RenderWindowHeadless::has_event() const noexcept
+{
+    return false;
+}
+
+
+
+/*-------------------------------------
+ * Peek at the next event
+-------------------------------------*/
+bool SL_RenderWindowHeadless::peek_event(SL_WindowEvent* const) noexcept
+{
+    return false;
+}
+
+
+
+/*-------------------------------------
+ * Remove the next event
+-------------------------------------*/
+bool SL_RenderWindowHeadless::pop_event(SL_WindowEvent* const) noexcept
+{
+    return false;
+}
+
+
+
+/*-------------------------------------
+ * Enable/Disable keyboard repeat
+-------------------------------------*/
+bool SL_RenderWindowHeadless::set_keys_repeat(bool doKeysRepeat) noexcept
+{
+    mKeysRepeat = doKeysRepeat;
+    return true;
+}
+
+
+
+/*-------------------------------------
+ * "Present" a window buffer by keeping a reference to it
+-------------------------------------*/
+void SL_RenderWindowHeadless::render(SL_WindowBuffer& buffer) noexcept
+{
+    LS_DEBUG_ASSERT(valid());
+    mLastFrame = &buffer;
+}
+
+
+
+/*-------------------------------------
+ * Mouse Capture
+-------------------------------------*/
+void SL_RenderWindowHeadless::set_mouse_capture(bool isCaptured) noexcept
+{
+    mCaptureMouse = isCaptured;
+}
+
+
+
+/*-------------------------------------
+ * Display DPI
+-------------------------------------*/
+unsigned SL_RenderWindowHeadless::dpi() const noexcept
+{
+    return 96u;
+}
+
+
+
+/*-------------------------------------
+ * Clipboard request (no-op)
+-------------------------------------*/
+void SL_RenderWindowHeadless::request_clipboard() const noexcept
+{
+}
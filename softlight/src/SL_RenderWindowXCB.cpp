@@ -101,7 +101,8 @@ SL_RenderWindowXCB::SL_RenderWindowXCB() noexcept :
     mMouseY{0},
     mKeysRepeat{true},
     mCaptureMouse{false},
-    mClipboard{nullptr}
+    mClipboard{nullptr},
+    mPresentSequences{0}
 {}
 
 
@@ -137,8 +138,11 @@ SL_RenderWindowXCB::SL_RenderWindowXCB(SL_RenderWindowXCB&& rw) noexcept :
     mMouseY{rw.mMouseY},
     mKeysRepeat{rw.mKeysRepeat},
     mCaptureMouse{rw.mCaptureMouse},
-    mClipboard{rw.mClipboard}
+    mClipboard{rw.mClipboard},
+    mPresentSequences{0}
 {
+    utils::fast_memcpy(mPresentSequences, rw.mPresentSequences, sizeof(mPresentSequences));
+
     rw.mDisplay = nullptr;
     rw.mConnection = nullptr;
     rw.mWindow = 0;
@@ -253,6 +257,8 @@ SL_RenderWindowXCB& SL_RenderWindowXCB::operator=(SL_RenderWindowXCB&& rw) noexc
     mClipboard = rw.mClipboard;
     rw.mClipboard = nullptr;
 
+    utils::fast_memcpy(mPresentSequences, rw.mPresentSequences, sizeof(mPresentSequences));
+
     return *this;
 }
 
@@ -526,6 +532,9 @@ int SL_RenderWindowXCB::destroy() noexcept
         mClipboard = nullptr;
     }
 
+    // Pending frames are discarded with the connection
+    mPresentsCompleted = mPresentsQueued;
+
     mCurrentState = WindowStateInfo::WINDOW_CLOSED;
 
     return 0;
@@ -1136,6 +1145,153 @@ void SL_RenderWindowXCB::render(SL_WindowBuffer& buffer) noexcept
 
 
 
+/*-------------------------------------
+ * Present the damaged regions of a window buffer
+-------------------------------------*/
+void SL_RenderWindowXCB::render_damage(SL_WindowBuffer& buffer) noexcept
+{
+    LS_ASSERT(this->valid());
+    LS_ASSERT(buffer.native_handle() != nullptr);
+
+    SL_DamageRegion& damage = buffer.damage();
+    const uint32_t w = (uint32_t)buffer.width();
+    const uint32_t h = (uint32_t)buffer.height();
+
+    #if SL_ENABLE_XSHM != 0
+        xcb_shm_segment_info_t* pShmInfo = (xcb_shm_segment_info_t*)((SL_WindowBufferXCB*)&buffer)->mShmInfo;
+    #endif
+
+    damage.clip((int32_t)w, (int32_t)h);
+
+    for (unsigned i = 0; i < damage.num_rects(); ++i)
+    {
+        const ls::math::vec4_t<int32_t>& r = damage.rect(i);
+
+        #if SL_ENABLE_XSHM != 0
+            xcb_shm_put_image(
+                mConnection,
+                mWindow,
+                mContext,
+                (uint16_t)w,
+                (uint16_t)h,
+                (uint16_t)r[0], (uint16_t)r[1],
+                (uint16_t)r[2],
+                (uint16_t)r[3],
+                (int16_t)r[0], (int16_t)r[1],
+                24,
+                XCB_IMAGE_FORMAT_Z_PIXMAP,
+                0,
+                pShmInfo->shmseg,
+                0
+            );
+        #else
+            // Rows of a sub-image must be uploaded one at a time since the
+            // buffer's stride differs from the rectangle's
+            for (int32_t y = r[1]; y < r[1] + r[3]; ++y)
+            {
+                xcb_put_image(
+                    mConnection,
+                    XCB_IMAGE_FORMAT_Z_PIXMAP,
+                    mWindow,
+                    mContext,
+                    (uint16_t)r[2],
+                    1,
+                    (int16_t)r[0], (int16_t)y,
+                    0, 24,
+                    sizeof(SL_ColorRGBA8)*(uint32_t)r[2],
+                    reinterpret_cast<const uint8_t*>(buffer.buffer() + w*(uint32_t)y + (uint32_t)r[0])
+                );
+            }
+        #endif /* SL_ENABLE_XSHM */
+    }
+
+    xcb_flush(mConnection);
+
+    damage.clear();
+}
+
+
+
+/*-------------------------------------
+ * Asynchronously present a window buffer
+-------------------------------------*/
+uint64_t SL_RenderWindowXCB::present(SL_WindowBuffer& buffer) noexcept
+{
+    #if SL_ENABLE_XSHM != 0
+        // Make room for another sequence number
+        if (mPresentsQueued - presents_completed() >= SL_XCB_MAX_PENDING_PRESENTS)
+        {
+            wait_for_present(mPresentsQueued + 1u - SL_XCB_MAX_PENDING_PRESENTS);
+        }
+
+        render(buffer);
+
+        // The X server processes requests in order, so shared memory has
+        // been read once a reply to any later request is available.
+        const uint64_t serial = ++mPresentsQueued;
+        mPresentSequences[serial % SL_XCB_MAX_PENDING_PRESENTS] = xcb_get_input_focus(mConnection).sequence;
+        xcb_flush(mConnection);
+
+        return serial;
+    #else
+        // xcb_put_image() copies the image before returning
+        return SL_RenderWindow::present(buffer);
+    #endif /* SL_ENABLE_XSHM */
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the last frame which has been presented
+-------------------------------------*/
+uint64_t SL_RenderWindowXCB::presents_completed() noexcept
+{
+    #if SL_ENABLE_XSHM != 0
+        while (mConnection && mPresentsCompleted < mPresentsQueued)
+        {
+            void* pReply = nullptr;
+            xcb_generic_error_t* pError = nullptr;
+            const unsigned sequence = mPresentSequences[(mPresentsCompleted + 1u) % SL_XCB_MAX_PENDING_PRESENTS];
+
+            if (!xcb_poll_for_reply(mConnection, sequence, &pReply, &pError))
+            {
+                break;
+            }
+
+            free(pReply);
+            free(pError);
+            ++mPresentsCompleted;
+        }
+    #endif /* SL_ENABLE_XSHM */
+
+    return mPresentsCompleted;
+}
+
+
+
+/*-------------------------------------
+ * Wait for a frame to finish presenting
+-------------------------------------*/
+void SL_RenderWindowXCB::wait_for_present(uint64_t serial) noexcept
+{
+    #if SL_ENABLE_XSHM != 0
+        serial = serial < mPresentsQueued ? serial : mPresentsQueued;
+
+        while (mConnection && mPresentsCompleted < serial)
+        {
+            xcb_get_input_focus_cookie_t cookie;
+            cookie.sequence = mPresentSequences[(mPresentsCompleted + 1u) % SL_XCB_MAX_PENDING_PRESENTS];
+
+            free(xcb_get_input_focus_reply(mConnection, cookie, nullptr));
+            ++mPresentsCompleted;
+        }
+    #else
+        (void)serial;
+    #endif /* SL_ENABLE_XSHM */
+}
+
+
+
 /*-------------------------------------
  * Mouse Grabbing
 -------------------------------------*/
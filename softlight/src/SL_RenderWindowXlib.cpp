@@ -69,6 +69,18 @@ bool _xlib_get_position(_XDisplay* const pDisplay, const unsigned long window, i
 
 
 
+/*-------------------------------------
+ * Check for the completion of a shared-memory image
+-------------------------------------*/
+#if SL_ENABLE_XSHM != 0
+Bool _xshm_completion_predicate(Display*, XEvent* pEvent, XPointer pEventType)
+{
+    return pEvent->type == *reinterpret_cast<const int*>(pEventType) ? True : False;
+}
+#endif /* SL_ENABLE_XSHM */
+
+
+
 } // end anonymous namespace
 
 
@@ -106,7 +118,8 @@ SL_RenderWindowXlib::SL_RenderWindowXlib() noexcept :
     mMouseY{0},
     mKeysRepeat{true},
     mCaptureMouse{false},
-    mClipboard{nullptr}
+    mClipboard{nullptr},
+    mShmCompletionType{-1}
 {
     ls::utils::runtime_assert(XInitThreads() != False, ls::utils::LS_WARNING, "Unable to initialize Xlib for threading.");
 }
@@ -141,7 +154,8 @@ SL_RenderWindowXlib::SL_RenderWindowXlib(SL_RenderWindowXlib&& rw) noexcept :
     mMouseY{rw.mMouseY},
     mKeysRepeat{rw.mKeysRepeat},
     mCaptureMouse{rw.mCaptureMouse},
-    mClipboard{rw.mClipboard}
+    mClipboard{rw.mClipboard},
+    mShmCompletionType{rw.mShmCompletionType}
 {
     rw.mDisplay = nullptr;
     rw.mWindow = None;
@@ -156,6 +170,7 @@ SL_RenderWindowXlib::SL_RenderWindowXlib(SL_RenderWindowXlib&& rw) noexcept :
     rw.mKeysRepeat = true;
     rw.mCaptureMouse = false;
     rw.mClipboard = nullptr;
+    rw.mShmCompletionType = -1;
 }
 
 
@@ -245,6 +260,9 @@ SL_RenderWindowXlib& SL_RenderWindowXlib::operator=(SL_RenderWindowXlib&& rw) no
     mClipboard = rw.mClipboard;
     rw.mClipboard = nullptr;
 
+    mShmCompletionType = rw.mShmCompletionType;
+    rw.mShmCompletionType = -1;
+
     return *this;
 }
 
@@ -366,6 +384,11 @@ int SL_RenderWindowXlib::init(unsigned width, unsigned height) noexcept
             errCode = -1;
             return windowError("\tUnable to connect to the X server.");
         }
+
+        #if SL_ENABLE_XSHM != 0
+            mShmCompletionType = XShmGetEventBase(pDisplay) + ShmCompletion;
+        #endif
+
         LS_LOG_MSG("\tDone.");
     }
     {
@@ -526,6 +549,10 @@ int SL_RenderWindowXlib::destroy() noexcept
         mDisplay = nullptr;
     }
 
+    // Pending frames are discarded with the connection
+    mShmCompletionType = -1;
+    mPresentsCompleted = mPresentsQueued;
+
     mCurrentState = WindowStateInfo::WINDOW_CLOSED;
 
     return 0;
@@ -677,6 +704,14 @@ void SL_RenderWindowXlib::update() noexcept
             // Perform a blocking event check while the window is paused.
             evtStatus = XNextEvent(mDisplay, mLastEvent);
 
+            // Presentation events are consumed here so they don't stall
+            // anything waiting on the swap chain.
+            if (mLastEvent->type == mShmCompletionType)
+            {
+                ++mPresentsCompleted;
+                mLastEvent->type = None;
+            }
+
             // Ignore when the mouse goes to the center of the window when
             // mouse capturing is enabled. The center of the window is where
             // the mouse is supposed to rest but resetting the mouse position
@@ -1124,6 +1159,131 @@ void SL_RenderWindowXlib::render(SL_WindowBuffer& buffer) noexcept
 
 
 
+/*-------------------------------------
+ * Present the damaged regions of a window buffer
+-------------------------------------*/
+void SL_RenderWindowXlib::render_damage(SL_WindowBuffer& buffer) noexcept
+{
+    LS_ASSERT(this->valid());
+    LS_ASSERT(buffer.native_handle() != nullptr);
+
+    SL_DamageRegion& damage = buffer.damage();
+    damage.clip((int32_t)buffer.width(), (int32_t)buffer.height());
+
+    for (unsigned i = 0; i < damage.num_rects(); ++i)
+    {
+        const ls::math::vec4_t<int32_t>& r = damage.rect(i);
+
+        #if SL_ENABLE_XSHM != 0
+            XShmPutImage(
+                mDisplay,
+                mWindow,
+                DefaultGC(mDisplay, DefaultScreen(mDisplay)),
+                reinterpret_cast<XImage*>(buffer.native_handle()),
+                r[0], r[1],
+                r[0], r[1],
+                (unsigned)r[2],
+                (unsigned)r[3],
+                False
+            );
+        #else
+            XPutImage(
+                mDisplay,
+                mWindow,
+                DefaultGC(mDisplay, DefaultScreen(mDisplay)),
+                reinterpret_cast<XImage*>(buffer.native_handle()),
+                r[0], r[1],
+                r[0], r[1],
+                (unsigned)r[2],
+                (unsigned)r[3]
+            );
+        #endif /* SL_ENABLE_XSHM */
+    }
+
+    damage.clear();
+}
+
+
+
+/*-------------------------------------
+ * Asynchronously present a window buffer
+-------------------------------------*/
+uint64_t SL_RenderWindowXlib::present(SL_WindowBuffer& buffer) noexcept
+{
+    #if SL_ENABLE_XSHM != 0
+        LS_ASSERT(this->valid());
+        LS_ASSERT(buffer.native_handle() != nullptr);
+
+        // The X server sends a completion event once it finishes reading
+        // from shared memory. Completion events arrive in order.
+        XShmPutImage(
+            mDisplay,
+            mWindow,
+            DefaultGC(mDisplay, DefaultScreen(mDisplay)),
+            reinterpret_cast<XImage*>(buffer.native_handle()),
+            0, 0,
+            0, 0,
+            width(),
+            height(),
+            True
+        );
+
+        XFlush(mDisplay);
+
+        return ++mPresentsQueued;
+    #else
+        // XPutImage() copies the image before returning
+        return SL_RenderWindow::present(buffer);
+    #endif /* SL_ENABLE_XSHM */
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the last frame which has been presented
+-------------------------------------*/
+uint64_t SL_RenderWindowXlib::presents_completed() noexcept
+{
+    #if SL_ENABLE_XSHM != 0
+        if (mDisplay)
+        {
+            XEvent evt;
+            while (mPresentsCompleted < mPresentsQueued && XCheckTypedEvent(mDisplay, mShmCompletionType, &evt))
+            {
+                ++mPresentsCompleted;
+            }
+        }
+    #endif /* SL_ENABLE_XSHM */
+
+    return mPresentsCompleted;
+}
+
+
+
+/*-------------------------------------
+ * Wait for a frame to finish presenting
+-------------------------------------*/
+void SL_RenderWindowXlib::wait_for_present(uint64_t serial) noexcept
+{
+    #if SL_ENABLE_XSHM != 0
+        serial = serial < mPresentsQueued ? serial : mPresentsQueued;
+
+        if (mDisplay)
+        {
+            XEvent evt;
+            while (mPresentsCompleted < serial)
+            {
+                XIfEvent(mDisplay, &evt, &_xshm_completion_predicate, reinterpret_cast<XPointer>(&mShmCompletionType));
+                ++mPresentsCompleted;
+            }
+        }
+    #else
+        (void)serial;
+    #endif /* SL_ENABLE_XSHM */
+}
+
+
+
 /*-------------------------------------
  * Mouse Grabbing
 -------------------------------------*/
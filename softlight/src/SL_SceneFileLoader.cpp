@@ -139,6 +139,8 @@ SL_SceneLoadOpts sl_default_scene_load_opts() noexcept
     opts.genFlatNormals = false;
     opts.genSmoothNormals = true;
     opts.genTangents = false;
+    opts.compressTextures = false;
+    opts.swizzleTextures = false;
 
     return opts;
 }
@@ -1027,8 +1029,31 @@ SL_Texture* SL_SceneFileLoader::load_texture_at_path(const std::string& path, SL
     SL_SceneGraph& graph = mPreloader.mSceneData;
     const size_t loadedTexture = graph.mContext.create_texture();
     SL_Texture& t = graph.mContext.texture(loadedTexture);
+    int retCode;
 
-    if (t.init(imgLoader) != 0)
+    if (mPreloader.mLoadOpts.compressTextures)
+    {
+        switch (imgLoader.format())
+        {
+            case SL_COLOR_R_8U:    retCode = t.init_compressed(imgLoader, SL_COLOR_BC4_R);    break;
+            case SL_COLOR_RG_8U:   retCode = t.init_compressed(imgLoader, SL_COLOR_BC5_RG);   break;
+            case SL_COLOR_RGB_8U:  retCode = t.init_compressed(imgLoader, SL_COLOR_BC1_RGBA); break;
+            case SL_COLOR_RGBA_8U: retCode = t.init_compressed(imgLoader, SL_COLOR_BC3_RGBA); break;
+            default:
+                retCode = t.init(imgLoader);
+        }
+    }
+    else if (mPreloader.mLoadOpts.swizzleTextures
+    && t.init(imgLoader.format(), (uint16_t)imgLoader.width(), (uint16_t)imgLoader.height(), (uint16_t)imgLoader.depth(), SL_TexelOrder::SL_TEXELS_SWIZZLED) == 0)
+    {
+        retCode = graph.mContext.upload_texture(t, imgLoader.data(), imgLoader.format(), SL_TexelOrder::SL_TEXELS_ORDERED);
+    }
+    else
+    {
+        retCode = t.init(imgLoader);
+    }
+
+    if (retCode != 0)
     {
         graph.mContext.destroy_texture(loadedTexture);
         return nullptr;
@@ -83,6 +83,30 @@ SL_ShaderProcessor::SL_ShaderProcessor(const SL_ShaderProcessor& sp) noexcept :
         case SL_CLEAR_PROCESSOR:
             mClear = sp.mClear;
             break;
+
+        case SL_LIGHT_PROCESSOR:
+            mLighting = sp.mLighting;
+            break;
+
+        case SL_CLUSTER_PROCESSOR:
+            mClusterer = sp.mClusterer;
+            break;
+
+        case SL_COMPOSITE_PROCESSOR:
+            mComposite = sp.mComposite;
+            break;
+
+        case SL_VOLUME_PROCESSOR:
+            mVolume = sp.mVolume;
+            break;
+
+        case SL_TEX_UPLOAD_PROCESSOR:
+            mTexUpload = sp.mTexUpload;
+            break;
+
+        case SL_AFFINITY_PROCESSOR:
+            mAffinity = sp.mAffinity;
+            break;
     }
 }
 
@@ -115,6 +139,30 @@ SL_ShaderProcessor::SL_ShaderProcessor(SL_ShaderProcessor&& sp) noexcept :
         case SL_CLEAR_PROCESSOR:
             mClear = sp.mClear;
             break;
+
+        case SL_LIGHT_PROCESSOR:
+            mLighting = sp.mLighting;
+            break;
+
+        case SL_CLUSTER_PROCESSOR:
+            mClusterer = sp.mClusterer;
+            break;
+
+        case SL_COMPOSITE_PROCESSOR:
+            mComposite = sp.mComposite;
+            break;
+
+        case SL_VOLUME_PROCESSOR:
+            mVolume = sp.mVolume;
+            break;
+
+        case SL_TEX_UPLOAD_PROCESSOR:
+            mTexUpload = sp.mTexUpload;
+            break;
+
+        case SL_AFFINITY_PROCESSOR:
+            mAffinity = sp.mAffinity;
+            break;
     }
 }
 
@@ -150,6 +198,30 @@ SL_ShaderProcessor& SL_ShaderProcessor::operator=(const SL_ShaderProcessor& sp)
             case SL_CLEAR_PROCESSOR:
                 mClear = sp.mClear;
                 break;
+
+            case SL_LIGHT_PROCESSOR:
+                mLighting = sp.mLighting;
+                break;
+
+            case SL_CLUSTER_PROCESSOR:
+                mClusterer = sp.mClusterer;
+                break;
+
+            case SL_COMPOSITE_PROCESSOR:
+                mComposite = sp.mComposite;
+                break;
+
+            case SL_VOLUME_PROCESSOR:
+                mVolume = sp.mVolume;
+                break;
+
+            case SL_TEX_UPLOAD_PROCESSOR:
+                mTexUpload = sp.mTexUpload;
+                break;
+
+            case SL_AFFINITY_PROCESSOR:
+                mAffinity = sp.mAffinity;
+                break;
         }
     }
 
@@ -188,6 +260,30 @@ SL_ShaderProcessor& SL_ShaderProcessor::operator=(SL_ShaderProcessor&& sp) noexc
             case SL_CLEAR_PROCESSOR:
                 mClear = sp.mClear;
                 break;
+
+            case SL_LIGHT_PROCESSOR:
+                mLighting = sp.mLighting;
+                break;
+
+            case SL_CLUSTER_PROCESSOR:
+                mClusterer = sp.mClusterer;
+                break;
+
+            case SL_COMPOSITE_PROCESSOR:
+                mComposite = sp.mComposite;
+                break;
+
+            case SL_VOLUME_PROCESSOR:
+                mVolume = sp.mVolume;
+                break;
+
+            case SL_TEX_UPLOAD_PROCESSOR:
+                mTexUpload = sp.mTexUpload;
+                break;
+
+            case SL_AFFINITY_PROCESSOR:
+                mAffinity = sp.mAffinity;
+                break;
         }
     }
 
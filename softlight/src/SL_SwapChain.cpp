@@ -0,0 +1,314 @@
+
+#include <utility> // std::move()
+
+#include "lightsky/utils/Assertions.h"
+
+#include "softlight/SL_RenderWindow.hpp"
+#include "softlight/SL_SwapChain.hpp"
+#include "softlight/SL_WindowBuffer.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+
+
+/*-------------------------------------
+ * Reset a frame's timestamps
+-------------------------------------*/
+inline void _sl_reset_frame_timing(SL_FrameTiming& timing) noexcept
+{
+    timing.serial = 0;
+    timing.queuedTime = std::chrono::steady_clock::time_point{};
+    timing.presentedTime = std::chrono::steady_clock::time_point{};
+}
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_SwapChain Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Destructor
+-------------------------------------*/
+SL_SwapChain::~SL_SwapChain() noexcept
+{
+    terminate();
+}
+
+
+
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_SwapChain::SL_SwapChain() noexcept :
+    mWindow{nullptr},
+    mNumBuffers{0},
+    mBackBuffer{0},
+    mBuffers{},
+    mTimings{},
+    mLastPresented{}
+{
+    for (SL_FrameTiming& timing : mTimings)
+    {
+        _sl_reset_frame_timing(timing);
+    }
+
+    _sl_reset_frame_timing(mLastPresented);
+}
+
+
+
+/*-------------------------------------
+ * Move Constructor
+-------------------------------------*/
+SL_SwapChain::SL_SwapChain(SL_SwapChain&& sc) noexcept :
+    SL_SwapChain{}
+{
+    *this = std::move(sc);
+}
+
+
+
+/*-------------------------------------
+ * Move Operator
+-------------------------------------*/
+SL_SwapChain& SL_SwapChain::operator=(SL_SwapChain&& sc) noexcept
+{
+    if (this != &sc)
+    {
+        terminate();
+
+        mWindow = sc.mWindow;
+        sc.mWindow = nullptr;
+
+        mNumBuffers = sc.mNumBuffers;
+        sc.mNumBuffers = 0;
+
+        mBackBuffer = sc.mBackBuffer;
+        sc.mBackBuffer = 0;
+
+        for (unsigned i = 0; i < SL_SWAP_CHAIN_MAX_BUFFERS; ++i)
+        {
+            mBuffers[i] = std::move(sc.mBuffers[i]);
+            mTimings[i] = sc.mTimings[i];
+            _sl_reset_frame_timing(sc.mTimings[i]);
+        }
+
+        mLastPresented = sc.mLastPresented;
+        _sl_reset_frame_timing(sc.mLastPresented);
+    }
+
+    return *this;
+}
+
+
+
+/*-------------------------------------
+ * Initialize all window buffers
+-------------------------------------*/
+int SL_SwapChain::init(SL_RenderWindow& window, unsigned numBuffers, unsigned width, unsigned height) noexcept
+{
+    if (!numBuffers || numBuffers > SL_SWAP_CHAIN_MAX_BUFFERS)
+    {
+        return -1;
+    }
+
+    if (!window.valid())
+    {
+        return -2;
+    }
+
+    terminate();
+
+    mWindow = &window;
+    mNumBuffers = numBuffers;
+
+    for (unsigned i = 0; i < numBuffers; ++i)
+    {
+        mBuffers[i] = SL_WindowBuffer::create(window);
+        if (!mBuffers[i].get())
+        {
+            terminate();
+            return -3;
+        }
+
+        if (mBuffers[i]->init(window, width, height) != 0)
+        {
+            terminate();
+            return -4;
+        }
+    }
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Resize all window buffers
+-------------------------------------*/
+int SL_SwapChain::resize(unsigned width, unsigned height) noexcept
+{
+    if (!mWindow)
+    {
+        return -1;
+    }
+
+    // Shared memory cannot be released while the windowing system reads it
+    wait_idle();
+
+    for (unsigned i = 0; i < mNumBuffers; ++i)
+    {
+        mBuffers[i]->terminate();
+
+        if (mBuffers[i]->init(*mWindow, width, height) != 0)
+        {
+            return -2;
+        }
+    }
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Release all resources
+-------------------------------------*/
+void SL_SwapChain::terminate() noexcept
+{
+    if (mWindow)
+    {
+        wait_idle();
+    }
+
+    for (unsigned i = 0; i < SL_SWAP_CHAIN_MAX_BUFFERS; ++i)
+    {
+        if (mBuffers[i].get())
+        {
+            mBuffers[i]->terminate();
+            mBuffers[i].reset();
+        }
+
+        _sl_reset_frame_timing(mTimings[i]);
+    }
+
+    _sl_reset_frame_timing(mLastPresented);
+
+    mWindow = nullptr;
+    mNumBuffers = 0;
+    mBackBuffer = 0;
+}
+
+
+
+/*-------------------------------------
+ * Record the completion of any presented frames
+-------------------------------------*/
+void SL_SwapChain::update_timings() noexcept
+{
+    const uint64_t completed = mWindow->presents_completed();
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    for (unsigned i = 0; i < mNumBuffers; ++i)
+    {
+        SL_FrameTiming& timing = mTimings[i];
+
+        if (timing.serial
+        && timing.serial <= completed
+        && timing.presentedTime == std::chrono::steady_clock::time_point{})
+        {
+            timing.presentedTime = now;
+
+            if (timing.serial > mLastPresented.serial)
+            {
+                mLastPresented = timing;
+            }
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the next buffer to render into
+-------------------------------------*/
+SL_WindowBuffer& SL_SwapChain::back_buffer() noexcept
+{
+    LS_DEBUG_ASSERT(mWindow != nullptr);
+
+    const uint64_t serial = mTimings[mBackBuffer].serial;
+
+    if (serial > mWindow->presents_completed())
+    {
+        mWindow->wait_for_present(serial);
+    }
+
+    update_timings();
+
+    return *mBuffers[mBackBuffer];
+}
+
+
+
+/*-------------------------------------
+ * Queue the back buffer for presentation
+-------------------------------------*/
+uint64_t SL_SwapChain::present() noexcept
+{
+    LS_DEBUG_ASSERT(mWindow != nullptr);
+
+    SL_FrameTiming& timing = mTimings[mBackBuffer];
+
+    timing.queuedTime = std::chrono::steady_clock::now();
+    timing.presentedTime = std::chrono::steady_clock::time_point{};
+    timing.serial = mWindow->present(*mBuffers[mBackBuffer]);
+
+    mBackBuffer = (mBackBuffer + 1u) % mNumBuffers;
+
+    update_timings();
+
+    return timing.serial;
+}
+
+
+
+/*-------------------------------------
+ * Wait for all queued frames to be presented
+-------------------------------------*/
+void SL_SwapChain::wait_idle() noexcept
+{
+    uint64_t serial = 0;
+
+    for (unsigned i = 0; i < mNumBuffers; ++i)
+    {
+        serial = mTimings[i].serial > serial ? mTimings[i].serial : serial;
+    }
+
+    mWindow->wait_for_present(serial);
+    update_timings();
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the timestamps of the most recently presented frame
+-------------------------------------*/
+const SL_FrameTiming& SL_SwapChain::last_presented_frame() noexcept
+{
+    if (mWindow)
+    {
+        update_timings();
+    }
+
+    return mLastPresented;
+}
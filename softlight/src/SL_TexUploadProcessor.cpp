@@ -0,0 +1,299 @@
+
+#include "lightsky/utils/Assertions.h"
+#include "lightsky/utils/Copy.h" // fast_memcpy()
+
+#include "lightsky/math/scalar_utils.h"
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_TexUploadProcessor.hpp"
+#include "softlight/SL_Texture.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions and namespaces
+-----------------------------------------------------------------------------*/
+namespace math = ls::math;
+
+namespace
+{
+
+
+
+// Uncompressed color types are grouped by channel count, with the element
+// types listed in the same order for each group.
+static_assert(SL_COLOR_RG_8U - SL_COLOR_R_8U == 7, "Unexpected SL_ColorDataType layout.");
+static_assert(SL_COLOR_RGBA_DOUBLE - SL_COLOR_R_8U == 27, "Unexpected SL_ColorDataType layout.");
+
+
+
+/*-------------------------------------
+ * Retrieve the single-channel type matching a color's elements
+-------------------------------------*/
+inline LS_INLINE SL_ColorDataType _sl_element_type(SL_ColorDataType type) noexcept
+{
+    return (SL_ColorDataType)((unsigned)type % 7u);
+}
+
+
+
+/*-------------------------------------
+ * Check if a color's elements can be converted during an upload
+-------------------------------------*/
+inline LS_INLINE bool _sl_is_convertible_element(SL_ColorDataType type) noexcept
+{
+    switch (_sl_element_type(type))
+    {
+        case SL_COLOR_R_8U:
+        case SL_COLOR_R_16U:
+        case SL_COLOR_R_32U:
+        case SL_COLOR_R_FLOAT:
+            return true;
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+
+
+/*-------------------------------------
+ * Index of the first texel in a span
+-------------------------------------*/
+inline LS_INLINE ptrdiff_t _sl_span_index(const SL_Texture& tex, SL_TexelOrder order, uint_fast32_t x, uint_fast32_t y, uint_fast32_t z) noexcept
+{
+    if (order == SL_TexelOrder::SL_TEXELS_ORDERED)
+    {
+        return tex.map_coordinate<SL_TexelOrder::SL_TEXELS_ORDERED>(x, y, z);
+    }
+
+    // 2D textures are sampled with a 2D swizzle
+    return (tex.depth() > 1)
+        ? tex.map_coordinate<SL_TexelOrder::SL_TEXELS_SWIZZLED>(x, y, z)
+        : tex.map_coordinate<SL_TexelOrder::SL_TEXELS_SWIZZLED>(x, y);
+}
+
+
+
+/*-------------------------------------
+ * Copy texels of identical formats
+-------------------------------------*/
+struct SL_TexelCopy
+{
+    size_t bytesPerTexel;
+
+    inline LS_INLINE void operator()(void* pDst, const void* pSrc, unsigned count) const noexcept
+    {
+        ls::utils::fast_memcpy(pDst, pSrc, bytesPerTexel * count);
+    }
+};
+
+
+
+/*-------------------------------------
+ * Convert texels between element types
+-------------------------------------*/
+template <template <typename> class color_type, typename dst_type, typename src_type>
+struct SL_TexelConvert
+{
+    inline LS_INLINE void operator()(void* pDst, const void* pSrc, unsigned count) const noexcept
+    {
+        color_type<dst_type>* const       pOut = reinterpret_cast<color_type<dst_type>*>(pDst);
+        const color_type<src_type>* const pIn  = reinterpret_cast<const color_type<src_type>*>(pSrc);
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            pOut[i] = color_cast<dst_type, src_type>(pIn[i]);
+        }
+    }
+};
+
+
+
+/*-------------------------------------
+ * Normalize 8-bit texels using the batch conversion routines
+-------------------------------------*/
+template <template <typename> class color_type>
+struct SL_TexelConvert<color_type, float, uint8_t>
+{
+    inline LS_INLINE void operator()(void* pDst, const void* pSrc, unsigned count) const noexcept
+    {
+        constexpr unsigned numElements = sizeof(color_type<float>) / sizeof(float);
+        sl_convert_u8_to_float(reinterpret_cast<const uint8_t*>(pSrc), reinterpret_cast<float*>(pDst), count * numElements);
+    }
+};
+
+
+
+template <template <typename> class color_type>
+struct SL_TexelConvert<color_type, uint8_t, float>
+{
+    inline LS_INLINE void operator()(void* pDst, const void* pSrc, unsigned count) const noexcept
+    {
+        constexpr unsigned numElements = sizeof(color_type<float>) / sizeof(float);
+        sl_convert_float_to_u8(reinterpret_cast<const float*>(pSrc), reinterpret_cast<uint8_t*>(pDst), count * numElements);
+    }
+};
+
+
+
+/*-------------------------------------
+ * Dispatch based on the destination's element type
+-------------------------------------*/
+template <template <typename> class color_type, typename src_type>
+void _sl_upload_to_element(SL_TexUploadProcessor& p, SL_ColorDataType dstType) noexcept
+{
+    switch (_sl_element_type(dstType))
+    {
+        case SL_COLOR_R_8U:    p.upload_spans(SL_TexelConvert<color_type, uint8_t, src_type>{});  break;
+        case SL_COLOR_R_16U:   p.upload_spans(SL_TexelConvert<color_type, uint16_t, src_type>{}); break;
+        case SL_COLOR_R_32U:   p.upload_spans(SL_TexelConvert<color_type, uint32_t, src_type>{}); break;
+        case SL_COLOR_R_FLOAT: p.upload_spans(SL_TexelConvert<color_type, float, src_type>{});    break;
+
+        default:
+            LS_DEBUG_ASSERT(false);
+            LS_UNREACHABLE();
+    }
+}
+
+
+
+/*-------------------------------------
+ * Dispatch based on the source's element type
+-------------------------------------*/
+template <template <typename> class color_type>
+void _sl_upload_from_element(SL_TexUploadProcessor& p, SL_ColorDataType dstType) noexcept
+{
+    switch (_sl_element_type(p.mSrcType))
+    {
+        case SL_COLOR_R_8U:    _sl_upload_to_element<color_type, uint8_t>(p, dstType);  break;
+        case SL_COLOR_R_16U:   _sl_upload_to_element<color_type, uint16_t>(p, dstType); break;
+        case SL_COLOR_R_32U:   _sl_upload_to_element<color_type, uint32_t>(p, dstType); break;
+        case SL_COLOR_R_FLOAT: _sl_upload_to_element<color_type, float>(p, dstType);    break;
+
+        default:
+            LS_DEBUG_ASSERT(false);
+            LS_UNREACHABLE();
+    }
+}
+
+
+
+} // end anonymous namespace
+
+
+
+/*-------------------------------------
+ * Check if an upload can convert between two formats
+-------------------------------------*/
+bool sl_is_tex_upload_supported(SL_ColorDataType srcType, SL_ColorDataType dstType) noexcept
+{
+    if (srcType >= SL_COLOR_INVALID || dstType >= SL_COLOR_INVALID)
+    {
+        return false;
+    }
+
+    if (sl_is_compressed_color(srcType) || sl_is_compressed_color(dstType))
+    {
+        return false;
+    }
+
+    if (srcType == dstType)
+    {
+        return true;
+    }
+
+    // Packed and sRGB colors can only be copied
+    if (sl_is_packed_color(srcType) || sl_is_packed_color(dstType) || sl_is_srgb_color(srcType) || sl_is_srgb_color(dstType))
+    {
+        return false;
+    }
+
+    return sl_elements_per_color(srcType) == sl_elements_per_color(dstType)
+        && _sl_is_convertible_element(srcType)
+        && _sl_is_convertible_element(dstType);
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_TexUploadProcessor Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Copy all bands assigned to this thread
+-------------------------------------*/
+template <class ConvertFunc>
+void SL_TexUploadProcessor::upload_spans(const ConvertFunc& convert) noexcept
+{
+    SL_Texture&         tex      = *mTexture;
+    const uint_fast32_t w        = tex.width();
+    const uint_fast32_t h        = tex.height();
+    const uint_fast32_t d        = tex.depth();
+    const SL_TexelOrder srcOrder = mSrcOrder;
+    const SL_TexelOrder dstOrder = tex.texel_order();
+    const size_t        srcBpp   = sl_bytes_per_color(mSrcType);
+    const size_t        dstBpp   = tex.bpp();
+
+    const unsigned char* const pSrc = reinterpret_cast<const unsigned char*>(mSrcTexels);
+    unsigned char* const       pDst = reinterpret_cast<unsigned char*>(tex.data());
+
+    const uint_fast32_t bandsPerSlice = (h + SL_TEXELS_PER_CHUNK - 1u) >> SL_TEXEL_SHIFTS_PER_CHUNK;
+    const uint_fast32_t numBands      = bandsPerSlice * d;
+    const uint_fast32_t spanW         = w & ~(uint_fast32_t)(SL_TEXELS_PER_CHUNK - 1u);
+
+    for (uint_fast32_t band = mThreadId; band < numBands; band += mNumThreads)
+    {
+        const uint_fast32_t z  = band / bandsPerSlice;
+        const uint_fast32_t y0 = (band % bandsPerSlice) << SL_TEXEL_SHIFTS_PER_CHUNK;
+        const uint_fast32_t y1 = math::min<uint_fast32_t>(y0 + SL_TEXELS_PER_CHUNK, h);
+
+        for (uint_fast32_t y = y0; y < y1; ++y)
+        {
+            uint_fast32_t x = 0;
+
+            for (; x < spanW; x += SL_TEXELS_PER_CHUNK)
+            {
+                const ptrdiff_t srcId = _sl_span_index(tex, srcOrder, x, y, z);
+                const ptrdiff_t dstId = _sl_span_index(tex, dstOrder, x, y, z);
+                convert(pDst + dstBpp * dstId, pSrc + srcBpp * srcId, SL_TEXELS_PER_CHUNK);
+            }
+
+            for (; x < w; ++x)
+            {
+                const ptrdiff_t srcId = _sl_span_index(tex, srcOrder, x, y, z);
+                const ptrdiff_t dstId = _sl_span_index(tex, dstOrder, x, y, z);
+                convert(pDst + dstBpp * dstId, pSrc + srcBpp * srcId, 1);
+            }
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Upload texels, converting their format if needed
+-------------------------------------*/
+void SL_TexUploadProcessor::execute() noexcept
+{
+    const SL_ColorDataType dstType = mTexture->type();
+
+    if (mSrcType == dstType)
+    {
+        upload_spans(SL_TexelCopy{mTexture->bpp()});
+        return;
+    }
+
+    switch (sl_elements_per_color(dstType))
+    {
+        case 1: _sl_upload_from_element<SL_ColorRType>(*this, dstType);    break;
+        case 2: _sl_upload_from_element<SL_ColorRGType>(*this, dstType);   break;
+        case 3: _sl_upload_from_element<SL_ColorRGBType>(*this, dstType);  break;
+        case 4: _sl_upload_from_element<SL_ColorRGBAType>(*this, dstType); break;
+
+        default:
+            LS_DEBUG_ASSERT(false);
+            LS_UNREACHABLE();
+    }
+}
@@ -14,7 +14,9 @@
 #include "lightsky/utils/Pointer.h" // aligned allocation
 
 #include "softlight/SL_ImgFile.hpp"
+#include "softlight/SL_TexUploadProcessor.hpp"
 #include "softlight/SL_Texture.hpp"
+#include "softlight/SL_TextureCompression.hpp"
 
 
 
@@ -24,9 +26,19 @@
 namespace
 {
 /*-------------------------------------
- *
+ * Compressed textures store 4x4 blocks rather than texels
 -------------------------------------*/
-char* _sl_allocate_texture(size_t w, size_t h, size_t d, size_t bpt) noexcept
+inline size_t _sl_storage_dimension(SL_ColorDataType type, size_t numTexels) noexcept
+{
+    return sl_is_compressed_color(type) ? ((numTexels + SL_TEXELS_PER_BLOCK_SIDE - 1u) >> SL_TEXEL_SHIFTS_PER_BLOCK) : numTexels;
+}
+
+
+
+/*-------------------------------------
+ * Number of bytes allocated for a texture's storage
+-------------------------------------*/
+inline size_t _sl_texture_bytes(size_t w, size_t h, size_t d, size_t bpt) noexcept
 {
     // Z-ordered textures need to be padded if they are not divisible by SL_TEXELS_PER_CHUNK
     w = w + (SL_TEXELS_PER_CHUNK - (w % SL_TEXELS_PER_CHUNK));
@@ -37,7 +49,18 @@ char* _sl_allocate_texture(size_t w, size_t h, size_t d, size_t bpt) noexcept
     const size_t numBytes     = w * h * d * bpt;
     const size_t maxRemaining = 4 * bpt;
     const size_t texAlignment = maxRemaining - (numBytes % maxRemaining);
-    size_t numAlignedBytes    = numBytes + texAlignment;
+
+    return numBytes + texAlignment;
+}
+
+
+
+/*-------------------------------------
+ *
+-------------------------------------*/
+char* _sl_allocate_texture(size_t w, size_t h, size_t d, size_t bpt) noexcept
+{
+    const size_t numAlignedBytes = _sl_texture_bytes(w, h, d, bpt);
 
     #if defined(LS_OS_WINDOWS)
         char* const pTexels = (char*)ls::utils::aligned_malloc(numAlignedBytes);
@@ -65,16 +88,7 @@ char* _sl_copy_texture(size_t w, size_t h, size_t d, size_t bpt, const char* pDa
         return nullptr;
     }
 
-    // Z-ordered textures need to be padded if they are not divisible by SL_TEXELS_PER_CHUNK
-    w = w + (SL_TEXELS_PER_CHUNK - (w % SL_TEXELS_PER_CHUNK));
-    h = h + (SL_TEXELS_PER_CHUNK - (h % SL_TEXELS_PER_CHUNK));
-    d = d + (SL_TEXELS_PER_CHUNK - (d % SL_TEXELS_PER_CHUNK));
-
-    // 8 pixels can be acquired at a time
-    const size_t numBytes     = w * h * d * bpt;
-    const size_t maxRemaining = 4 * bpt;
-    const size_t texAlignment = maxRemaining - (numBytes % maxRemaining);
-    size_t numAlignedBytes    = numBytes + texAlignment;
+    const size_t numAlignedBytes = _sl_texture_bytes(w, h, d, bpt);
 
     #if defined(LS_OS_WINDOWS)
         char* const pTexels = (char*)ls::utils::aligned_malloc(numAlignedBytes);
@@ -93,6 +107,41 @@ char* _sl_copy_texture(size_t w, size_t h, size_t d, size_t bpt, const char* pDa
 
 
 
+/*-------------------------------------
+ * Copy a square region of an image into one layer of a texture
+-------------------------------------*/
+template <SL_TexelOrder order>
+void _sl_copy_texture_layer(
+    SL_Texture& tex,
+    uint16_t layer,
+    const SL_ImgFile& imgFile,
+    size_t srcX,
+    size_t srcY,
+    bool rotate180) noexcept
+{
+    const size_t         bpt    = tex.bpp();
+    const size_t         imgW   = imgFile.width();
+    const uint16_t       w      = tex.width();
+    const uint16_t       h      = tex.height();
+    const unsigned char* pInTex = reinterpret_cast<const unsigned char*>(imgFile.data());
+    char*                pOut   = reinterpret_cast<char*>(tex.data());
+
+    for (uint16_t y = 0; y < h; ++y)
+    {
+        const size_t inY = srcY + (rotate180 ? (size_t)(h-1u-y) : (size_t)y);
+
+        for (uint16_t x = 0; x < w; ++x)
+        {
+            const size_t inX = srcX + (rotate180 ? (size_t)(w-1u-x) : (size_t)x);
+            const ptrdiff_t index = tex.map_layer_coordinate<order>(x, y, layer);
+
+            ls::utils::fast_memcpy(pOut + index * bpt, pInTex + (inX + imgW * inY) * bpt, bpt);
+        }
+    }
+}
+
+
+
 } // end anonymous namespace
 
 
@@ -117,6 +166,8 @@ SL_Texture::SL_Texture() noexcept :
     mType{SL_COLOR_RGB_DEFAULT},
     mBytesPerTexel{0},
     mNumChannels{0},
+    mLayout{SL_TEX_LAYOUT_VOLUME},
+    mTexelOrder{SL_TexelOrder::SL_TEXELS_ORDERED},
     mTexels{nullptr}
 {}
 
@@ -132,7 +183,9 @@ SL_Texture::SL_Texture(const SL_Texture& r) noexcept :
     mType{r.mType},
     mBytesPerTexel{r.mBytesPerTexel},
     mNumChannels{r.mNumChannels},
-    mTexels{_sl_copy_texture(r.mWidth, r.mHeight, r.mDepth, r.mBytesPerTexel, r.mTexels)}
+    mLayout{r.mLayout},
+    mTexelOrder{r.mTexelOrder},
+    mTexels{_sl_copy_texture(_sl_storage_dimension(r.mType, r.mWidth), _sl_storage_dimension(r.mType, r.mHeight), r.mDepth, r.mBytesPerTexel, r.mTexels)}
 {}
 
 
@@ -147,6 +200,8 @@ SL_Texture::SL_Texture(SL_Texture&& r) noexcept :
     mType{r.mType},
     mBytesPerTexel{r.mBytesPerTexel},
     mNumChannels{r.mNumChannels},
+    mLayout{r.mLayout},
+    mTexelOrder{r.mTexelOrder},
     mTexels{r.mTexels}
 {
     r.mWidth = 0;
@@ -155,6 +210,8 @@ SL_Texture::SL_Texture(SL_Texture&& r) noexcept :
     r.mType = SL_COLOR_RGB_DEFAULT;
     r.mBytesPerTexel = 0;
     r.mNumChannels = 0;
+    r.mLayout = SL_TEX_LAYOUT_VOLUME;
+    r.mTexelOrder = SL_TexelOrder::SL_TEXELS_ORDERED;
     r.mTexels = nullptr;
 }
 
@@ -179,7 +236,9 @@ SL_Texture& SL_Texture::operator=(const SL_Texture& r) noexcept
     mType = r.mType;
     mBytesPerTexel = r.mBytesPerTexel;
     mNumChannels = r.mNumChannels;
-    mTexels = _sl_copy_texture(r.mWidth, r.mHeight, r.mDepth, r.mBytesPerTexel, r.mTexels);
+    mLayout = r.mLayout;
+    mTexelOrder = r.mTexelOrder;
+    mTexels = _sl_copy_texture(_sl_storage_dimension(r.mType, r.mWidth), _sl_storage_dimension(r.mType, r.mHeight), r.mDepth, r.mBytesPerTexel, r.mTexels);
 
     return *this;
 }
@@ -213,6 +272,12 @@ SL_Texture& SL_Texture::operator=(SL_Texture&& r) noexcept
     mNumChannels = r.mNumChannels;
     r.mNumChannels = 0;
 
+    mLayout = r.mLayout;
+    r.mLayout = SL_TEX_LAYOUT_VOLUME;
+
+    mTexelOrder = r.mTexelOrder;
+    r.mTexelOrder = SL_TexelOrder::SL_TEXELS_ORDERED;
+
     mBytesPerTexel = r.mBytesPerTexel;
     r.mBytesPerTexel = 0;
 
@@ -227,14 +292,21 @@ SL_Texture& SL_Texture::operator=(SL_Texture&& r) noexcept
 /*-------------------------------------
  *
 -------------------------------------*/
-int SL_Texture::init(SL_ColorDataType type, uint16_t w, uint16_t h, uint16_t d) noexcept
+int SL_Texture::init(SL_ColorDataType type, uint16_t w, uint16_t h, uint16_t d, SL_TexelOrder texelOrder) noexcept
 {
     LS_DEBUG_ASSERT(w > 0);
     LS_DEBUG_ASSERT(h > 0);
     LS_DEBUG_ASSERT(d > 0);
 
+    // Swizzled rows must contain a whole number of chunks
+    if (texelOrder == SL_TexelOrder::SL_TEXELS_SWIZZLED
+    && (sl_is_compressed_color(type) || (w & (SL_TEXELS_PER_CHUNK-1u)) || (h & (SL_TEXELS_PER_CHUNK-1u))))
+    {
+        return -2;
+    }
+
     const size_t bpt = sl_bytes_per_color(type);
-    char* pData = _sl_allocate_texture(w, h, d, bpt);
+    char* pData = _sl_allocate_texture(_sl_storage_dimension(type, w), _sl_storage_dimension(type, h), d, bpt);
 
     if (!pData)
     {
@@ -252,6 +324,8 @@ int SL_Texture::init(SL_ColorDataType type, uint16_t w, uint16_t h, uint16_t d)
     mType          = type;
     mBytesPerTexel = (uint16_t)bpt;
     mNumChannels   = (uint16_t)sl_elements_per_color(type);
+    mLayout        = SL_TEX_LAYOUT_VOLUME;
+    mTexelOrder    = texelOrder;
     mTexels        = pData;
 
     return 0;
@@ -283,7 +357,14 @@ int SL_Texture::init(const SL_ImgFile& imgFile, SL_TexelOrder texelOrder) noexce
         return -3;
     }
 
-    int retCode = this->init(imgFile.format(), (uint16_t)dimens[0], (uint16_t)dimens[1], (uint16_t)dimens[2]);
+    // Swizzled rows must contain a whole number of chunks
+    if (texelOrder == SL_TexelOrder::SL_TEXELS_SWIZZLED
+    && ((dimens[0] & (SL_TEXELS_PER_CHUNK-1u)) || (dimens[1] & (SL_TEXELS_PER_CHUNK-1u))))
+    {
+        return -5;
+    }
+
+    int retCode = this->init(imgFile.format(), (uint16_t)dimens[0], (uint16_t)dimens[1], (uint16_t)dimens[2], texelOrder);
 
     if (retCode == 0)
     {
@@ -291,19 +372,10 @@ int SL_Texture::init(const SL_ImgFile& imgFile, SL_TexelOrder texelOrder) noexce
 
         if (texelOrder == SL_TexelOrder::SL_TEXELS_SWIZZLED)
         {
-            const size_t bytesPerColor = mBytesPerTexel;
-
-            for (uint16_t z = 0; z < mDepth; ++z)
+            if (upload(pInTex, imgFile.format(), SL_TexelOrder::SL_TEXELS_ORDERED) != 0)
             {
-                for (uint16_t y = 0; y < mHeight; ++y)
-                {
-                    for (uint16_t x = 0; x < mWidth; ++x)
-                    {
-                        const ptrdiff_t index = x + mWidth * (y + mHeight * z);
-                        const ptrdiff_t offset = bytesPerColor * index;
-                        set_texel<SL_TexelOrder::SL_TEXELS_SWIZZLED>(x, y, z, pInTex + offset);
-                    }
-                }
+                terminate();
+                retCode = -4;
             }
         }
         else
@@ -317,17 +389,280 @@ int SL_Texture::init(const SL_ImgFile& imgFile, SL_TexelOrder texelOrder) noexce
 
 
 
+/*-------------------------------------
+ *
+-------------------------------------*/
+int SL_Texture::init_compressed(const SL_ImgFile& imgFile, SL_ColorDataType compressedType) noexcept
+{
+    if (!imgFile.data())
+    {
+        return -1;
+    }
+
+    if (this->data())
+    {
+        return -2;
+    }
+
+    const size_t* const dimens = imgFile.size();
+
+    if (dimens[0] > std::numeric_limits<uint16_t>::max()
+    || dimens[1] > std::numeric_limits<uint16_t>::max()
+    || dimens[2] != 1)
+    {
+        return -3;
+    }
+
+    if (!sl_is_compressed_color(compressedType))
+    {
+        return -4;
+    }
+
+    int retCode = this->init(compressedType, (uint16_t)dimens[0], (uint16_t)dimens[1], 1);
+
+    if (retCode == 0 && sl_encode_texture(imgFile.data(), imgFile.format(), *this) != 0)
+    {
+        terminate();
+        retCode = -5;
+    }
+
+    return retCode;
+}
+
+
+
+/*-------------------------------------
+ *
+-------------------------------------*/
+int SL_Texture::init_cube(SL_ColorDataType type, uint16_t faceSize) noexcept
+{
+    // Compressed blocks are addressed without a layer
+    if (sl_is_compressed_color(type))
+    {
+        return -2;
+    }
+
+    const int retCode = this->init(type, faceSize, faceSize, SL_CUBE_FACE_COUNT);
+
+    if (retCode == 0)
+    {
+        mLayout = SL_TEX_LAYOUT_CUBE;
+    }
+
+    return retCode;
+}
+
+
+
+/*-------------------------------------
+ *
+-------------------------------------*/
+int SL_Texture::init_cube(const SL_ImgFile* const pFaces[SL_CUBE_FACE_COUNT], SL_TexelOrder texelOrder) noexcept
+{
+    for (unsigned i = 0; i < SL_CUBE_FACE_COUNT; ++i)
+    {
+        if (!pFaces[i] || !pFaces[i]->data())
+        {
+            return -1;
+        }
+    }
+
+    if (this->data())
+    {
+        return -2;
+    }
+
+    const size_t faceSize = pFaces[0]->width();
+
+    for (unsigned i = 0; i < SL_CUBE_FACE_COUNT; ++i)
+    {
+        if (pFaces[i]->width() != faceSize
+        || pFaces[i]->height() != faceSize
+        || pFaces[i]->depth() != 1
+        || pFaces[i]->format() != pFaces[0]->format()
+        || faceSize > std::numeric_limits<uint16_t>::max())
+        {
+            return -3;
+        }
+    }
+
+    int retCode = this->init_cube(pFaces[0]->format(), (uint16_t)faceSize);
+
+    if (retCode == 0)
+    {
+        for (uint16_t face = 0; face < SL_CUBE_FACE_COUNT; ++face)
+        {
+            if (texelOrder == SL_TexelOrder::SL_TEXELS_SWIZZLED)
+            {
+                _sl_copy_texture_layer<SL_TexelOrder::SL_TEXELS_SWIZZLED>(*this, face, *pFaces[face], 0, 0, false);
+            }
+            else
+            {
+                _sl_copy_texture_layer<SL_TexelOrder::SL_TEXELS_ORDERED>(*this, face, *pFaces[face], 0, 0, false);
+            }
+        }
+
+        mTexelOrder = texelOrder;
+    }
+
+    return retCode;
+}
+
+
+
+/*-------------------------------------
+ *
+-------------------------------------*/
+int SL_Texture::init_cube_cross(const SL_ImgFile& imgFile, SL_TexelOrder texelOrder) noexcept
+{
+    // Face positions, in units of faces, from the bottom-left corner of the
+    // image (images are stored bottom-up). The -Z face of a vertical cross is
+    // stored upside-down.
+    //                                           +X      -X      +Y      -Y      +Z      -Z
+    static constexpr uint8_t horizCross[][2] = {{2, 1}, {0, 1}, {1, 2}, {1, 0}, {1, 1}, {3, 1}};
+    static constexpr uint8_t vertCross[][2]  = {{2, 2}, {0, 2}, {1, 3}, {1, 1}, {1, 2}, {1, 0}};
+
+    if (!imgFile.data())
+    {
+        return -1;
+    }
+
+    if (this->data())
+    {
+        return -2;
+    }
+
+    const size_t w = imgFile.width();
+    const size_t h = imgFile.height();
+    const uint8_t (*pPositions)[2];
+    size_t faceSize;
+
+    if (w*3u == h*4u)
+    {
+        faceSize = w / 4u;
+        pPositions = horizCross;
+    }
+    else if (w*4u == h*3u)
+    {
+        faceSize = w / 3u;
+        pPositions = vertCross;
+    }
+    else
+    {
+        return -3;
+    }
+
+    if (!faceSize || imgFile.depth() != 1 || faceSize > std::numeric_limits<uint16_t>::max())
+    {
+        return -3;
+    }
+
+    int retCode = this->init_cube(imgFile.format(), (uint16_t)faceSize);
+
+    if (retCode == 0)
+    {
+        for (uint16_t face = 0; face < SL_CUBE_FACE_COUNT; ++face)
+        {
+            const size_t srcX      = pPositions[face][0] * faceSize;
+            const size_t srcY      = pPositions[face][1] * faceSize;
+            const bool   rotate180 = pPositions == vertCross && face == SL_CUBE_FACE_NEGATIVE_Z;
+
+            if (texelOrder == SL_TexelOrder::SL_TEXELS_SWIZZLED)
+            {
+                _sl_copy_texture_layer<SL_TexelOrder::SL_TEXELS_SWIZZLED>(*this, face, imgFile, srcX, srcY, rotate180);
+            }
+            else
+            {
+                _sl_copy_texture_layer<SL_TexelOrder::SL_TEXELS_ORDERED>(*this, face, imgFile, srcX, srcY, rotate180);
+            }
+        }
+
+        mTexelOrder = texelOrder;
+    }
+
+    return retCode;
+}
+
+
+
+/*-------------------------------------
+ *
+-------------------------------------*/
+int SL_Texture::init_array(SL_ColorDataType type, uint16_t w, uint16_t h, uint16_t numLayers) noexcept
+{
+    if (sl_is_compressed_color(type))
+    {
+        return -2;
+    }
+
+    const int retCode = this->init(type, w, h, numLayers);
+
+    if (retCode == 0)
+    {
+        mLayout = SL_TEX_LAYOUT_ARRAY;
+    }
+
+    return retCode;
+}
+
+
+
+/*-------------------------------------
+ *
+-------------------------------------*/
+int SL_Texture::set_layer(uint16_t layer, const SL_ImgFile& imgFile, SL_TexelOrder texelOrder) noexcept
+{
+    if (!imgFile.data())
+    {
+        return -1;
+    }
+
+    if (!this->data() || mLayout == SL_TEX_LAYOUT_VOLUME || layer >= mDepth)
+    {
+        return -2;
+    }
+
+    if (imgFile.width() != mWidth
+    || imgFile.height() != mHeight
+    || imgFile.depth() != 1
+    || imgFile.format() != mType)
+    {
+        return -3;
+    }
+
+    if (texelOrder == SL_TexelOrder::SL_TEXELS_SWIZZLED)
+    {
+        _sl_copy_texture_layer<SL_TexelOrder::SL_TEXELS_SWIZZLED>(*this, layer, imgFile, 0, 0, false);
+    }
+    else
+    {
+        _sl_copy_texture_layer<SL_TexelOrder::SL_TEXELS_ORDERED>(*this, layer, imgFile, 0, 0, false);
+    }
+
+    return 0;
+}
+
+
+
 /*-------------------------------------
  *
 -------------------------------------*/
 void SL_Texture::terminate() noexcept
 {
+    // Decoded blocks may still reference this texture's memory
+    if (mTexels && sl_is_compressed_color(mType))
+    {
+        sl_invalidate_tex_block_caches();
+    }
+
     mWidth = 0;
     mHeight = 0;
     mDepth = 0;
     mType = SL_COLOR_RGB_DEFAULT;
     mBytesPerTexel = 0;
     mNumChannels = 0;
+    mLayout = SL_TEX_LAYOUT_VOLUME;
+    mTexelOrder = SL_TexelOrder::SL_TEXELS_ORDERED;
 
     #if defined(LS_OS_WINDOWS)
     ls::utils::aligned_free(mTexels);
@@ -337,3 +672,47 @@ void SL_Texture::terminate() noexcept
 
     mTexels = nullptr;
 }
+
+
+
+/*-------------------------------------
+ * Size of the texel storage, including padding
+-------------------------------------*/
+size_t SL_Texture::num_bytes() const noexcept
+{
+    if (!mTexels)
+    {
+        return 0;
+    }
+
+    return _sl_texture_bytes(_sl_storage_dimension(mType, mWidth), _sl_storage_dimension(mType, mHeight), mDepth, mBytesPerTexel);
+}
+
+
+
+/*-------------------------------------
+ * Copy and convert an entire image into the texture
+-------------------------------------*/
+int SL_Texture::upload(const void* pTexels, SL_ColorDataType srcType, SL_TexelOrder srcOrder) noexcept
+{
+    if (!pTexels || !mTexels || mLayout != SL_TEX_LAYOUT_VOLUME)
+    {
+        return -1;
+    }
+
+    if (!sl_is_tex_upload_supported(srcType, mType))
+    {
+        return -2;
+    }
+
+    SL_TexUploadProcessor uploader;
+    uploader.mThreadId   = 0;
+    uploader.mNumThreads = 1;
+    uploader.mSrcType    = srcType;
+    uploader.mSrcOrder   = srcOrder;
+    uploader.mSrcTexels  = pTexels;
+    uploader.mTexture    = this;
+    uploader.execute();
+
+    return 0;
+}
@@ -0,0 +1,551 @@
+
+#include <atomic>
+
+#include "lightsky/setup/Macros.h" // LS_UNLIKELY
+
+#include "lightsky/utils/Assertions.h" // LS_UNREACHABLE
+
+#include "lightsky/math/scalar_utils.h"
+
+#include "softlight/SL_Texture.hpp"
+#include "softlight/SL_TextureCompression.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions and namespaces
+-----------------------------------------------------------------------------*/
+namespace math = ls::math;
+
+namespace
+{
+
+
+
+/*-------------------------------------
+ * Global cache generation
+-------------------------------------*/
+std::atomic<uint32_t> gTexBlockGeneration{1u};
+
+
+
+/*-------------------------------------
+ * Expand an RGB565 color to RGBA8
+-------------------------------------*/
+inline SL_ColorRGBA8 _sl_unpack_565(uint_fast32_t c) noexcept
+{
+    const uint_fast32_t r = (c >> 11u) & 0x1Fu;
+    const uint_fast32_t g = (c >> 5u) & 0x3Fu;
+    const uint_fast32_t b = c & 0x1Fu;
+
+    return SL_ColorRGBA8{
+        (uint8_t)((r << 3u) | (r >> 2u)),
+        (uint8_t)((g << 2u) | (g >> 4u)),
+        (uint8_t)((b << 3u) | (b >> 2u)),
+        (uint8_t)255u
+    };
+}
+
+
+
+/*-------------------------------------
+ * Quantize an RGBA8 color to RGB565
+-------------------------------------*/
+inline uint16_t _sl_pack_565(const SL_ColorRGBA8& c) noexcept
+{
+    const uint_fast32_t r = ((uint_fast32_t)c[0] * 31u + 127u) / 255u;
+    const uint_fast32_t g = ((uint_fast32_t)c[1] * 63u + 127u) / 255u;
+    const uint_fast32_t b = ((uint_fast32_t)c[2] * 31u + 127u) / 255u;
+
+    return (uint16_t)((r << 11u) | (g << 5u) | b);
+}
+
+
+
+/*-------------------------------------
+ * Decode the color portion of a BC1/BC3 block
+-------------------------------------*/
+void _sl_decode_color_block(const uint8_t* pBlock, SL_ColorRGBA8* pOut, bool forceFourColors) noexcept
+{
+    const uint_fast32_t c0      = (uint_fast32_t)pBlock[0] | ((uint_fast32_t)pBlock[1] << 8u);
+    const uint_fast32_t c1      = (uint_fast32_t)pBlock[2] | ((uint_fast32_t)pBlock[3] << 8u);
+    const uint_fast32_t indices = (uint_fast32_t)pBlock[4]
+                                | ((uint_fast32_t)pBlock[5] << 8u)
+                                | ((uint_fast32_t)pBlock[6] << 16u)
+                                | ((uint_fast32_t)pBlock[7] << 24u);
+
+    SL_ColorRGBA8 palette[4];
+    palette[0] = _sl_unpack_565(c0);
+    palette[1] = _sl_unpack_565(c1);
+
+    if (forceFourColors || c0 > c1)
+    {
+        for (unsigned i = 0; i < 3; ++i)
+        {
+            palette[2][i] = (uint8_t)((2u * palette[0][i] + palette[1][i] + 1u) / 3u);
+            palette[3][i] = (uint8_t)((palette[0][i] + 2u * palette[1][i] + 1u) / 3u);
+        }
+
+        palette[2][3] = 255u;
+        palette[3][3] = 255u;
+    }
+    else
+    {
+        for (unsigned i = 0; i < 3; ++i)
+        {
+            palette[2][i] = (uint8_t)((palette[0][i] + palette[1][i]) >> 1u);
+        }
+
+        palette[2][3] = 255u;
+        palette[3] = SL_ColorRGBA8{0, 0, 0, 0};
+    }
+
+    for (unsigned i = 0; i < SL_TEXELS_PER_BLOCK; ++i)
+    {
+        pOut[i] = palette[(indices >> (2u * i)) & 0x03u];
+    }
+}
+
+
+
+/*-------------------------------------
+ * Decode a single-channel (BC4 or BC3 alpha) block
+-------------------------------------*/
+void _sl_decode_channel_block(const uint8_t* pBlock, SL_ColorRGBA8* pOut, unsigned channel) noexcept
+{
+    const uint_fast32_t a0 = pBlock[0];
+    const uint_fast32_t a1 = pBlock[1];
+
+    uint8_t palette[8];
+    palette[0] = (uint8_t)a0;
+    palette[1] = (uint8_t)a1;
+
+    if (a0 > a1)
+    {
+        for (uint_fast32_t k = 2; k < 8; ++k)
+        {
+            palette[k] = (uint8_t)(((8u - k) * a0 + (k - 1u) * a1 + 3u) / 7u);
+        }
+    }
+    else
+    {
+        for (uint_fast32_t k = 2; k < 6; ++k)
+        {
+            palette[k] = (uint8_t)(((6u - k) * a0 + (k - 1u) * a1 + 2u) / 5u);
+        }
+
+        palette[6] = 0u;
+        palette[7] = 255u;
+    }
+
+    uint_fast64_t bits = 0;
+    for (unsigned i = 0; i < 6; ++i)
+    {
+        bits |= (uint_fast64_t)pBlock[2+i] << (8u * i);
+    }
+
+    for (unsigned i = 0; i < SL_TEXELS_PER_BLOCK; ++i)
+    {
+        pOut[i][channel] = palette[(bits >> (3u * i)) & 0x07u];
+    }
+}
+
+
+
+/*-------------------------------------
+ * Encode the color portion of a BC1/BC3 block
+-------------------------------------*/
+void _sl_encode_color_block(const SL_ColorRGBA8* pTexels, uint8_t* pOut, bool allowTransparency) noexcept
+{
+    SL_ColorRGBA8 minColor{255, 255, 255, 255};
+    SL_ColorRGBA8 maxColor{0, 0, 0, 255};
+    bool haveTransparency = false;
+    bool haveOpaque = false;
+
+    // Bounding-box endpoint selection
+    for (unsigned i = 0; i < SL_TEXELS_PER_BLOCK; ++i)
+    {
+        if (allowTransparency && pTexels[i][3] < 128u)
+        {
+            haveTransparency = true;
+            continue;
+        }
+
+        haveOpaque = true;
+        for (unsigned c = 0; c < 3; ++c)
+        {
+            minColor[c] = math::min(minColor[c], pTexels[i][c]);
+            maxColor[c] = math::max(maxColor[c], pTexels[i][c]);
+        }
+    }
+
+    uint_fast32_t c0 = haveOpaque ? _sl_pack_565(maxColor) : 0u;
+    uint_fast32_t c1 = haveOpaque ? _sl_pack_565(minColor) : 0u;
+
+    // 4-color blocks require c0 > c1 while 3-color blocks (with a
+    // transparent index) require c0 <= c1.
+    if ((!haveTransparency && c0 < c1) || (haveTransparency && c0 > c1))
+    {
+        const uint_fast32_t temp = c0;
+        c0 = c1;
+        c1 = temp;
+    }
+
+    const SL_ColorRGBA8&& e0 = _sl_unpack_565(c0);
+    const SL_ColorRGBA8&& e1 = _sl_unpack_565(c1);
+    const int axis[3] = {(int)e1[0] - (int)e0[0], (int)e1[1] - (int)e0[1], (int)e1[2] - (int)e0[2]};
+    const int axisLen2 = axis[0]*axis[0] + axis[1]*axis[1] + axis[2]*axis[2];
+
+    // Palette order for projected positions along the e0->e1 axis
+    static constexpr uint_fast32_t fourColorIds[4] = {0u, 2u, 3u, 1u};
+    static constexpr uint_fast32_t threeColorIds[3] = {0u, 2u, 1u};
+
+    const int numSteps = haveTransparency ? 2 : 3;
+    uint_fast32_t indices = 0;
+
+    for (unsigned i = 0; i < SL_TEXELS_PER_BLOCK; ++i)
+    {
+        uint_fast32_t id;
+
+        if (haveTransparency && pTexels[i][3] < 128u)
+        {
+            id = 3u;
+        }
+        else if (axisLen2 == 0)
+        {
+            id = 0u;
+        }
+        else
+        {
+            const int proj = ((int)pTexels[i][0] - (int)e0[0]) * axis[0]
+                           + ((int)pTexels[i][1] - (int)e0[1]) * axis[1]
+                           + ((int)pTexels[i][2] - (int)e0[2]) * axis[2];
+            const int step = math::clamp<int>((proj * numSteps + (axisLen2 >> 1)) / axisLen2, 0, numSteps);
+
+            id = haveTransparency ? threeColorIds[step] : fourColorIds[step];
+        }
+
+        indices |= id << (2u * i);
+    }
+
+    pOut[0] = (uint8_t)(c0 & 0xFFu);
+    pOut[1] = (uint8_t)(c0 >> 8u);
+    pOut[2] = (uint8_t)(c1 & 0xFFu);
+    pOut[3] = (uint8_t)(c1 >> 8u);
+    pOut[4] = (uint8_t)(indices & 0xFFu);
+    pOut[5] = (uint8_t)((indices >> 8u) & 0xFFu);
+    pOut[6] = (uint8_t)((indices >> 16u) & 0xFFu);
+    pOut[7] = (uint8_t)((indices >> 24u) & 0xFFu);
+}
+
+
+
+/*-------------------------------------
+ * Encode a single-channel (BC4 or BC3 alpha) block
+-------------------------------------*/
+void _sl_encode_channel_block(const SL_ColorRGBA8* pTexels, uint8_t* pOut, unsigned channel) noexcept
+{
+    uint_fast32_t minVal = 255u;
+    uint_fast32_t maxVal = 0u;
+
+    for (unsigned i = 0; i < SL_TEXELS_PER_BLOCK; ++i)
+    {
+        minVal = math::min<uint_fast32_t>(minVal, pTexels[i][channel]);
+        maxVal = math::max<uint_fast32_t>(maxVal, pTexels[i][channel]);
+    }
+
+    // a0 > a1 selects the 8-value interpolation mode. Uniform blocks only
+    // need index 0.
+    const uint_fast32_t range = maxVal - minVal;
+    uint_fast64_t bits = 0;
+
+    if (range)
+    {
+        for (unsigned i = 0; i < SL_TEXELS_PER_BLOCK; ++i)
+        {
+            const uint_fast32_t step = (((uint_fast32_t)pTexels[i][channel] - minVal) * 7u + (range >> 1u)) / range;
+            const uint_fast64_t id = (step == 7u) ? 0u : ((step == 0u) ? 1u : (8u - step));
+
+            bits |= id << (3u * i);
+        }
+    }
+
+    pOut[0] = (uint8_t)maxVal;
+    pOut[1] = (uint8_t)minVal;
+
+    for (unsigned i = 0; i < 6; ++i)
+    {
+        pOut[2+i] = (uint8_t)((bits >> (8u * i)) & 0xFFu);
+    }
+}
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Block decoding
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * BC1 (RGB + 1-bit alpha)
+-------------------------------------*/
+void sl_decode_bc1_block(const void* pBlock, SL_ColorRGBA8* pOutTexels) noexcept
+{
+    _sl_decode_color_block(reinterpret_cast<const uint8_t*>(pBlock), pOutTexels, false);
+}
+
+
+
+/*-------------------------------------
+ * BC3 (RGB + interpolated alpha)
+-------------------------------------*/
+void sl_decode_bc3_block(const void* pBlock, SL_ColorRGBA8* pOutTexels) noexcept
+{
+    const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(pBlock);
+
+    _sl_decode_color_block(pBytes+8, pOutTexels, true);
+    _sl_decode_channel_block(pBytes, pOutTexels, 3);
+}
+
+
+
+/*-------------------------------------
+ * BC4 (R)
+-------------------------------------*/
+void sl_decode_bc4_block(const void* pBlock, SL_ColorRGBA8* pOutTexels) noexcept
+{
+    for (unsigned i = 0; i < SL_TEXELS_PER_BLOCK; ++i)
+    {
+        pOutTexels[i] = SL_ColorRGBA8{0, 0, 0, 255};
+    }
+
+    _sl_decode_channel_block(reinterpret_cast<const uint8_t*>(pBlock), pOutTexels, 0);
+}
+
+
+
+/*-------------------------------------
+ * BC5 (RG)
+-------------------------------------*/
+void sl_decode_bc5_block(const void* pBlock, SL_ColorRGBA8* pOutTexels) noexcept
+{
+    const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(pBlock);
+
+    for (unsigned i = 0; i < SL_TEXELS_PER_BLOCK; ++i)
+    {
+        pOutTexels[i] = SL_ColorRGBA8{0, 0, 0, 255};
+    }
+
+    _sl_decode_channel_block(pBytes, pOutTexels, 0);
+    _sl_decode_channel_block(pBytes+8, pOutTexels, 1);
+}
+
+
+
+/*-------------------------------------
+ * Generic block decoding
+-------------------------------------*/
+void sl_decode_block(SL_ColorDataType type, const void* pBlock, SL_ColorRGBA8* pOutTexels) noexcept
+{
+    switch (type)
+    {
+        case SL_COLOR_BC1_RGBA: sl_decode_bc1_block(pBlock, pOutTexels); break;
+        case SL_COLOR_BC3_RGBA: sl_decode_bc3_block(pBlock, pOutTexels); break;
+        case SL_COLOR_BC4_R:    sl_decode_bc4_block(pBlock, pOutTexels); break;
+        case SL_COLOR_BC5_RG:   sl_decode_bc5_block(pBlock, pOutTexels); break;
+
+        default:
+            LS_UNREACHABLE();
+    }
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Block encoding
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * BC1 (RGB + 1-bit alpha)
+-------------------------------------*/
+void sl_encode_bc1_block(const SL_ColorRGBA8* pTexels, void* pOutBlock) noexcept
+{
+    _sl_encode_color_block(pTexels, reinterpret_cast<uint8_t*>(pOutBlock), true);
+}
+
+
+
+/*-------------------------------------
+ * BC3 (RGB + interpolated alpha)
+-------------------------------------*/
+void sl_encode_bc3_block(const SL_ColorRGBA8* pTexels, void* pOutBlock) noexcept
+{
+    uint8_t* pBytes = reinterpret_cast<uint8_t*>(pOutBlock);
+
+    _sl_encode_channel_block(pTexels, pBytes, 3);
+    _sl_encode_color_block(pTexels, pBytes+8, false);
+}
+
+
+
+/*-------------------------------------
+ * BC4 (R)
+-------------------------------------*/
+void sl_encode_bc4_block(const SL_ColorRGBA8* pTexels, void* pOutBlock) noexcept
+{
+    _sl_encode_channel_block(pTexels, reinterpret_cast<uint8_t*>(pOutBlock), 0);
+}
+
+
+
+/*-------------------------------------
+ * BC5 (RG)
+-------------------------------------*/
+void sl_encode_bc5_block(const SL_ColorRGBA8* pTexels, void* pOutBlock) noexcept
+{
+    uint8_t* pBytes = reinterpret_cast<uint8_t*>(pOutBlock);
+
+    _sl_encode_channel_block(pTexels, pBytes, 0);
+    _sl_encode_channel_block(pTexels, pBytes+8, 1);
+}
+
+
+
+/*-------------------------------------
+ * Compress an entire image
+-------------------------------------*/
+int sl_encode_texture(const void* pTexels, SL_ColorDataType srcType, SL_Texture& outTex) noexcept
+{
+    unsigned numChannels;
+
+    switch (srcType)
+    {
+        case SL_COLOR_R_8U:    numChannels = 1; break;
+        case SL_COLOR_RG_8U:   numChannels = 2; break;
+        case SL_COLOR_RGB_8U:  numChannels = 3; break;
+        case SL_COLOR_RGBA_8U: numChannels = 4; break;
+
+        default:
+            return -1;
+    }
+
+    const SL_ColorDataType outType = outTex.type();
+
+    if (!sl_is_compressed_color(outType))
+    {
+        return -2;
+    }
+
+    const uint8_t* pSrc       = reinterpret_cast<const uint8_t*>(pTexels);
+    uint8_t*       pDst       = reinterpret_cast<uint8_t*>(outTex.data());
+    const unsigned w          = outTex.width();
+    const unsigned h          = outTex.height();
+    const unsigned blocksX    = (w + SL_TEXELS_PER_BLOCK_SIDE - 1u) >> SL_TEXEL_SHIFTS_PER_BLOCK;
+    const unsigned blocksY    = (h + SL_TEXELS_PER_BLOCK_SIDE - 1u) >> SL_TEXEL_SHIFTS_PER_BLOCK;
+    const size_t   blockBytes = outTex.bpp();
+
+    SL_ColorRGBA8 block[SL_TEXELS_PER_BLOCK];
+
+    for (unsigned by = 0; by < blocksY; ++by)
+    {
+        for (unsigned bx = 0; bx < blocksX; ++bx)
+        {
+            // Edge blocks replicate the last row/column of the image
+            for (unsigned i = 0; i < SL_TEXELS_PER_BLOCK; ++i)
+            {
+                const unsigned x = math::min<unsigned>((bx << SL_TEXEL_SHIFTS_PER_BLOCK) + (i & 3u), w - 1u);
+                const unsigned y = math::min<unsigned>((by << SL_TEXEL_SHIFTS_PER_BLOCK) + (i >> 2u), h - 1u);
+                const uint8_t* pTexel = pSrc + ((size_t)x + (size_t)w * (size_t)y) * numChannels;
+
+                block[i] = SL_ColorRGBA8{0, 0, 0, 255};
+                for (unsigned c = 0; c < numChannels; ++c)
+                {
+                    block[i][c] = pTexel[c];
+                }
+            }
+
+            uint8_t* pBlock = pDst + ((size_t)bx + (size_t)blocksX * (size_t)by) * blockBytes;
+
+            switch (outType)
+            {
+                case SL_COLOR_BC1_RGBA: sl_encode_bc1_block(block, pBlock); break;
+                case SL_COLOR_BC3_RGBA: sl_encode_bc3_block(block, pBlock); break;
+                case SL_COLOR_BC4_R:    sl_encode_bc4_block(block, pBlock); break;
+                case SL_COLOR_BC5_RG:   sl_encode_bc5_block(block, pBlock); break;
+
+                default:
+                    LS_UNREACHABLE();
+            }
+        }
+    }
+
+    sl_invalidate_tex_block_caches();
+
+    return 0;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_TexBlockCache Structure
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Retrieve a decoded block
+-------------------------------------*/
+const SL_ColorRGBA8* SL_TexBlockCache::fetch(SL_ColorDataType type, const void* pBlock, uint32_t blockBytes) noexcept
+{
+    const uint32_t generation = gTexBlockGeneration.load(std::memory_order_relaxed);
+
+    if (LS_UNLIKELY(generation != mGeneration))
+    {
+        for (unsigned i = 0; i < SL_TEX_BLOCK_CACHE_ENTRIES; ++i)
+        {
+            mKeys[i] = nullptr;
+        }
+
+        mGeneration = generation;
+    }
+
+    const uintptr_t slot = ((uintptr_t)pBlock / blockBytes) & (SL_TEX_BLOCK_CACHE_ENTRIES - 1u);
+
+    if (mKeys[slot] != pBlock)
+    {
+        sl_decode_block(type, pBlock, mTexels[slot]);
+        mKeys[slot] = pBlock;
+    }
+
+    return mTexels[slot];
+}
+
+
+
+/*-------------------------------------
+ * Per-thread block cache
+-------------------------------------*/
+SL_TexBlockCache& sl_tex_block_cache() noexcept
+{
+    static thread_local SL_TexBlockCache cache{};
+    return cache;
+}
+
+
+
+/*-------------------------------------
+ * Invalidate all block caches
+-------------------------------------*/
+void sl_invalidate_tex_block_caches() noexcept
+{
+    gTexBlockGeneration.fetch_add(1u, std::memory_order_relaxed);
+}
+
+
+
+/*-------------------------------------
+ * Load a single texel from a compressed texture
+-------------------------------------*/
+SL_ColorRGBA8 sl_fetch_compressed_texel(const SL_Texture& tex, uint16_t x, uint16_t y) noexcept
+{
+    const SL_ColorRGBA8* pTexels = sl_tex_block_cache().fetch(tex.type(), tex.block_pointer(x, y), tex.bpp());
+    return pTexels[(x & (SL_TEXELS_PER_BLOCK_SIDE-1u)) + ((y & (SL_TEXELS_PER_BLOCK_SIDE-1u)) << SL_TEXEL_SHIFTS_PER_BLOCK)];
+}
@@ -4,6 +4,8 @@
 #include "softlight/SL_Context.hpp"
 #include "softlight/SL_Framebuffer.hpp"
 #include "softlight/SL_IndexBuffer.hpp"
+#include "softlight/SL_PipelineStatistics.hpp"
+#include "softlight/SL_Profiler.hpp"
 #include "softlight/SL_Shader.hpp"
 #include "softlight/SL_ShaderUtil.hpp" // SL_BinCounter
 #include "softlight/SL_TriProcessor.hpp"
@@ -508,6 +510,13 @@ void SL_TriProcessor::push_bin(size_t primIndex, const SL_TransformedVert& a, co
     const int isPrimHidden = (bboxMaxX-bboxMinX < 1.f) || (bboxMaxY-bboxMinY < 1.f);
     if (LS_UNLIKELY(isPrimHidden))
     {
+        ++mStats[mThreadId].primsCulledZeroArea;
+        return;
+    }
+
+    if (mDirtyRegion && is_outside_dirty_region(bboxMinX, bboxMinY, bboxMaxX, bboxMaxY))
+    {
+        ++mStats[mThreadId].primsCulledFrustum;
         return;
     }
 
@@ -706,6 +715,7 @@ void SL_TriProcessor::clip_and_process_tris(
 
         if (!numNewVerts)
         {
+            ++mStats[mThreadId].primsCulledFrustum;
             return;
         }
 
@@ -721,10 +731,12 @@ void SL_TriProcessor::clip_and_process_tris(
 
     if (numTotalVerts < 3)
     {
+        ++mStats[mThreadId].primsCulledFrustum;
         return;
     }
 
     LS_DEBUG_ASSERT(numTotalVerts <= numTempVerts);
+    mStats[mThreadId].clipOutputPrims += numTotalVerts-2;
 
     switch (numTotalVerts)
     {
@@ -791,6 +803,14 @@ void SL_TriProcessor::process_verts(
     params.pVao       = &vao;
     params.pVbo       = &mContext->vbo(vao.get_vertex_buffer());
 
+    uint64_t numSubmitted = 0;
+    uint64_t numBackfaces = 0;
+    uint64_t numOutside   = 0;
+    uint64_t numClipped   = 0;
+
+    // Clipping runs per-primitive, so only its total time is recorded
+    SL_PROFILE_TOTAL(clipTime, SL_PROFILE_CLIP, mThreadId);
+
     #if SL_VERTEX_CACHING_ENABLED
         size_t begin;
         size_t end;
@@ -811,6 +831,7 @@ void SL_TriProcessor::process_verts(
     for (size_t i = begin; i < end; i += step)
     {
         const math::vec4_t<size_t>&& vertId = usingIndices ? get_next_vertex3(pIbo, i) : math::vec4_t<size_t>{i+0, i+1, i+2, i+3};
+        ++numSubmitted;
 
         #if SL_VERTEX_CACHING_ENABLED
             ptvCache.query_and_update(vertId[0], scissorMat, pVert0);
@@ -844,6 +865,7 @@ void SL_TriProcessor::process_verts(
             //|| (cullMode == SL_CULL_FRONT_FACE && det > 0.f))
             if (culled)
             {
+                ++numBackfaces;
                 continue;
             }
         }
@@ -858,10 +880,14 @@ void SL_TriProcessor::process_verts(
         }
         else if (visStatus == SL_TRIANGLE_PARTIALLY_VISIBLE)
         {
+            ++numClipped;
+            SL_PROFILE_TOTAL_BEGIN(clipTime);
             clip_and_process_tris(i, viewportDims, pVert0, pVert1, pVert2);
+            SL_PROFILE_TOTAL_END(clipTime);
         }
         else
         {
+            ++numOutside;
             continue;
         }
 
@@ -872,6 +898,18 @@ void SL_TriProcessor::process_verts(
             }
         #endif
     }
+
+    SL_PipelineStatistics& stats = mStats[mThreadId];
+    stats.primsSubmitted      += numSubmitted;
+    stats.primsCulledBackface += numBackfaces;
+    stats.primsCulledFrustum  += numOutside;
+    stats.primsClipped        += numClipped;
+
+    #if SL_VERTEX_CACHING_ENABLED
+        stats.verticesShaded += ptvCache.num_shaded();
+    #else
+        stats.verticesShaded += numSubmitted * 3u;
+    #endif
 }
 
 
@@ -891,18 +929,22 @@ void SL_TriProcessor::execute() noexcept
     const math::mat4&&      scissorMat   = viewState.scissor_matrix(fboDims[2], fboDims[3]);
     const math::vec4&&      viewportDims = viewState.viewport_rect(fboDims[2], fboDims[3]);
 
-    if (mNumInstances == 1)
     {
-        for (size_t i = 0; i < mNumMeshes; ++i)
+        SL_PROFILE_SCOPE(SL_PROFILE_VERTEX, mThreadId);
+
+        if (mNumInstances == 1)
         {
-            process_verts(mMeshes[i], 0, scissorMat, viewportDims);
+            for (size_t i = 0; i < mNumMeshes; ++i)
+            {
+                process_verts(mMeshes[i], 0, scissorMat, viewportDims);
+            }
         }
-    }
-    else
-    {
-        for (size_t i = 0; i < mNumInstances; ++i)
+        else
         {
-            process_verts(mMeshes[0], i, scissorMat, viewportDims);
+            for (size_t i = 0; i < mNumInstances; ++i)
+            {
+                process_verts(mMeshes[0], i, scissorMat, viewportDims);
+            }
         }
     }
 
@@ -12,7 +12,9 @@
 #include "lightsky/math/mat_utils.h"
 
 #include "softlight/SL_TriRasterizer.hpp"
+#include "softlight/SL_DamageRegion.hpp"
 #include "softlight/SL_Framebuffer.hpp" // SL_Framebuffer
+#include "softlight/SL_PipelineStatistics.hpp"
 #include "softlight/SL_ScanlineBounds.hpp"
 #include "softlight/SL_Shader.hpp" // SL_FragmentShader
 #include "softlight/SL_ShaderProcessor.hpp" // SL_FragmentBin
@@ -285,6 +287,41 @@ inline LS_INLINE math::vec4 _sl_get_depth_texel4(const depth_type* pDepth)
 
 
 
+/*--------------------------------------
+ * Pointer increment when a scalar depth loop reaches the end of a chunk
+--------------------------------------*/
+inline LS_INLINE ptrdiff_t _sl_depth_chunk_jump(const SL_Texture* pDepth) noexcept
+{
+    return (pDepth->texel_order() == SL_TexelOrder::SL_TEXELS_SWIZZLED)
+        ? (ptrdiff_t)(SL_TEXELS_PER_CHUNK * SL_TEXELS_PER_CHUNK - (SL_TEXELS_PER_CHUNK - 1u))
+        : (ptrdiff_t)1;
+}
+
+
+
+/*--------------------------------------
+ * SIMD depth loops start on a chunk boundary in swizzled depth buffers, so
+ * each group of 4 texels is loaded from a single chunk row.
+--------------------------------------*/
+inline LS_INLINE int32_t _sl_depth_align_mask(const SL_Texture* pDepth) noexcept
+{
+    return (pDepth->texel_order() == SL_TexelOrder::SL_TEXELS_SWIZZLED) ? ~(int32_t)(SL_TEXELS_PER_CHUNK - 1u) : ~(int32_t)0;
+}
+
+
+
+/*--------------------------------------
+ * Pointer increment after loading 4 depth texels
+--------------------------------------*/
+inline LS_INLINE ptrdiff_t _sl_depth_step4(const SL_Texture* pDepth) noexcept
+{
+    return (pDepth->texel_order() == SL_TexelOrder::SL_TEXELS_SWIZZLED)
+        ? (ptrdiff_t)(SL_TEXELS_PER_CHUNK * SL_TEXELS_PER_CHUNK)
+        : (ptrdiff_t)4;
+}
+
+
+
 } // end anonymous namespace
 
 
@@ -301,7 +338,7 @@ void SL_TriRasterizer::flush_scanlines(const SL_FragmentBin* pBin, uint32_t xMin
 {
     constexpr DepthCmpFunc   depthCmpFunc;
     const SL_FragmentShader& fragShader    = mShader->mFragShader;
-    const SL_FboOutputMask   fboOutMask    = sl_calc_fbo_out_mask(fragShader.numOutputs, fragShader.blend != SL_BLEND_OFF);
+    const SL_FboOutputMask   fboOutMask    = sl_calc_fbo_out_mask(fragShader.numOutputs, fragShader.blend != SL_BLEND_OFF, fragShader.blend == SL_BLEND_WEIGHTED_OIT);
     const bool               haveDepthMask = fragShader.depthMask == SL_DEPTH_MASK_ON;
 
     SL_FragmentParam fragParams;
@@ -311,7 +348,9 @@ void SL_TriRasterizer::flush_scanlines(const SL_FragmentBin* pBin, uint32_t xMin
     const float yf = (float)y;
     uint32_t x = xMin;
 
-    depth_type*       pDepthBuf   = mFbo->get_depth_buffer()->row_pointer<depth_type>((uint16_t)y) + xMin;
+    SL_Texture*       pDepthTex   = mFbo->get_depth_buffer();
+    depth_type*       pDepthBuf   = pDepthTex->native_texel_pointer<depth_type>((uint16_t)xMin, (uint16_t)y);
+    const ptrdiff_t   chunkJump   = _sl_depth_chunk_jump(pDepthTex);
 
     const math::vec4* pPoints     = pBin->mScreenCoords;
     const math::vec4  depth       {pPoints[0][2], pPoints[1][2], pPoints[2][2], 0.f};
@@ -321,6 +360,9 @@ void SL_TriRasterizer::flush_scanlines(const SL_FragmentBin* pBin, uint32_t xMin
     const math::vec4&& bcY = math::fmadd(bcClipSpace[1], math::vec4{yf}, bcClipSpace[2]);
     math::vec4&& bcX = math::fmadd(bcClipSpace[0], math::vec4{(float)xMin}, bcY);
 
+    uint32_t numShaded = 0;
+    uint32_t numWritten = 0;
+
     do
     {
         // calculate barycentric coordinates
@@ -328,7 +370,7 @@ void SL_TriRasterizer::flush_scanlines(const SL_FragmentBin* pBin, uint32_t xMin
         const float          z         = math::dot(depth, bcX);
         const int_fast32_t&& depthTest = depthCmpFunc(z, d);
 
-        if (LS_LIKELY(depthTest))
+        if (LS_LIKELY(depthTest) && (LS_LIKELY(mDirtyRegion == nullptr) || mDirtyRegion->contains((int32_t)x, (int32_t)y)))
         {
             fragParams.coord.x = (uint16_t)x;
             fragParams.coord.depth = z;
@@ -338,10 +380,12 @@ void SL_TriRasterizer::flush_scanlines(const SL_FragmentBin* pBin, uint32_t xMin
             const math::vec4&& bc = (bcX * homogenous) * persp;
 
             interpolate_tri_varyings(bc.v, fragShader.numVaryings, pBin->mVaryings, fragParams.pVaryings);
+            ++numShaded;
 
             if (LS_LIKELY(fragShader.shader(fragParams)))
             {
                 mFbo->put_pixel(fboOutMask, fragShader.blend, fragParams);
+                ++numWritten;
 
                 if (LS_LIKELY(haveDepthMask))
                 {
@@ -351,9 +395,14 @@ void SL_TriRasterizer::flush_scanlines(const SL_FragmentBin* pBin, uint32_t xMin
         }
 
         bcX += bcClipSpace[0];
-        ++pDepthBuf;
         ++x;
+        pDepthBuf += (x & (SL_TEXELS_PER_CHUNK-1u)) ? 1 : chunkJump;
     } while (x < xMax);
+
+    mStats->fragsRasterized += xMax - xMin;
+    mStats->fragsShaded     += numShaded;
+    mStats->fragsDiscarded  += numShaded - numWritten;
+    mStats->pixelsWritten   += numWritten;
 }
 
 
@@ -478,31 +527,48 @@ void SL_TriRasterizer::flush_fragments(
 {
     const SL_UniformBuffer*  pUniforms     = mShader->mUniforms;
     const SL_FragmentShader& fragShader    = mShader->mFragShader;
-    const SL_FboOutputMask   fboOutMask    = sl_calc_fbo_out_mask(fragShader.numOutputs, (fragShader.blend != SL_BLEND_OFF));
+    const SL_FboOutputMask   fboOutMask    = sl_calc_fbo_out_mask(fragShader.numOutputs, (fragShader.blend != SL_BLEND_OFF), (fragShader.blend == SL_BLEND_WEIGHTED_OIT));
     const int_fast32_t       haveDepthMask = fragShader.depthMask == SL_DEPTH_MASK_ON;
     SL_Texture* const        pDepthBuf     = mFbo->get_depth_buffer();
+    const SL_DamageRegion*   pDirty        = mDirtyRegion;
 
     SL_FragmentParam fragParams;
     fragParams.pUniforms = pUniforms;
 
+    uint32_t numShaded = 0;
+    uint32_t numWritten = 0;
+
     for (uint32_t i = 0; i < numQueuedFrags; ++i)
     {
         const math::vec4& bc = outCoords->bc[i];
         fragParams.coord = outCoords->coord[i];
 
+        // Blended fragments between the rectangles of a dirty region would
+        // otherwise accumulate over texels which are never cleared.
+        if (LS_UNLIKELY(pDirty != nullptr) && !pDirty->contains(fragParams.coord.x, fragParams.coord.y))
+        {
+            continue;
+        }
+
+        ++numShaded;
         interpolate_tri_varyings(bc.v, fragShader.numVaryings, pBin->mVaryings, fragParams.pVaryings);
         const bool haveOutputs = fragShader.shader(fragParams);
 
         if (LS_LIKELY(haveOutputs != false))
         {
             mFbo->put_pixel(fboOutMask, fragShader.blend, fragParams);
+            ++numWritten;
 
             if (LS_LIKELY(haveDepthMask != 0))
             {
-                pDepthBuf->raw_texel<depth_type>(fragParams.coord.x, fragParams.coord.y) = (depth_type)fragParams.coord.depth;
+                pDepthBuf->native_texel<depth_type>(fragParams.coord.x, fragParams.coord.y) = (depth_type)fragParams.coord.depth;
             }
         }
     }
+
+    mStats->fragsShaded    += numShaded;
+    mStats->fragsDiscarded += numShaded - numWritten;
+    mStats->pixelsWritten  += numWritten;
 }
 
 
@@ -528,6 +594,7 @@ void SL_TriRasterizer::render_wireframe(const SL_Texture* depthBuffer) const noe
     const int32_t         yOffset      = (int32_t)mThreadId;
     const int32_t         increment    = (int32_t)mNumProcessors;
     SL_ScanlineBounds     scanline;
+    uint64_t              numRasterized = 0;
 
     for (uint32_t i = 0; i < numBins; ++i)
     {
@@ -561,8 +628,6 @@ void SL_TriRasterizer::render_wireframe(const SL_Texture* depthBuffer) const noe
             const int32_t d0 = math::max(math::abs(xMinMax0[0]-xMinMax1[0]), 1);
             const int32_t d1 = math::max(math::abs(xMinMax0[1]-xMinMax1[1]), 1);
 
-            const depth_type* const pDepth = depthBuffer->row_pointer<depth_type>(y);
-
             for (int32_t ix = 0, x = xMinMax0[0]; x < xMinMax0[1]; ++ix, ++x)
             {
                 // skip to the start of the next horizontal edge
@@ -572,11 +637,13 @@ void SL_TriRasterizer::render_wireframe(const SL_Texture* depthBuffer) const noe
                     continue;
                 }
 
+                ++numRasterized;
+
                 // calculate barycentric coordinates
                 const float   xf = (float)x;
                 math::vec4&&  bc = math::fmadd(bcClipSpace[0], math::vec4{xf, xf, xf, 0.f}, bcY);
                 const float   z  = math::dot(depth, bc);
-                const float   d  = _sl_get_depth_texel<depth_type>(pDepth+x);
+                const float   d  = _sl_get_depth_texel<depth_type>(depthBuffer->native_texel_pointer<depth_type>((uint16_t)x, (uint16_t)y));
 
                 const int_fast32_t&& depthTest = depthCmpFunc(z, d);
 
@@ -607,6 +674,8 @@ void SL_TriRasterizer::render_wireframe(const SL_Texture* depthBuffer) const noe
             flush_fragments<depth_type>(pBin, numQueuedFrags, outCoords);
         }
     }
+
+    mStats->fragsRasterized += numRasterized;
 }
 
 
@@ -654,7 +723,9 @@ void SL_TriRasterizer::render_triangle(const SL_Texture* depthBuffer) const noex
     SL_FragCoord*         outCoords    = mQueues;
     const int32_t         yOffset      = (int32_t)mThreadId;
     const int32_t         increment    = (int32_t)mNumProcessors;
+    const ptrdiff_t       chunkJump    = _sl_depth_chunk_jump(depthBuffer);
     SL_ScanlineBounds     scanline;
+    uint64_t              numRasterized = 0;
 
     for (uint32_t i = 0; i < numBins; ++i)
     {
@@ -698,9 +769,11 @@ void SL_TriRasterizer::render_triangle(const SL_Texture* depthBuffer) const noex
                 continue;
             }
 
+            numRasterized += (uint64_t)(xMax - x);
+
             math::vec4&& xf{(float)x};
             math::vec4&& bcX = math::fmadd(bcClipSpace[0], xf, bcY);
-            const depth_type* pDepth = depthBuffer->row_pointer<depth_type>(y) + x;
+            const depth_type* pDepth = depthBuffer->native_texel_pointer<depth_type>((uint16_t)x, (uint16_t)y);
 
             do
             {
@@ -731,7 +804,10 @@ void SL_TriRasterizer::render_triangle(const SL_Texture* depthBuffer) const noex
 
                 bcX += bcClipSpace[0];
                 ++x;
-                ++pDepth;
+
+                // Swizzled depth buffers jump to the next chunk of the row
+                // once every SL_TEXELS_PER_CHUNK texels.
+                pDepth += (x & (SL_TEXELS_PER_CHUNK-1u)) ? 1 : chunkJump;
             } while (LS_UNLIKELY(x < xMax));
 
             y -= increment;
@@ -743,6 +819,8 @@ void SL_TriRasterizer::render_triangle(const SL_Texture* depthBuffer) const noex
             flush_fragments<depth_type>(pBin, numQueuedFrags, outCoords);
         }
     }
+
+    mStats->fragsRasterized += numRasterized;
 }
 
 
@@ -831,7 +909,10 @@ void SL_TriRasterizer::render_triangle_simd(const SL_Texture* depthBuffer) const
     SL_FragCoord*     outCoords    = mQueues;
     const int32_t     yOffset      = (int32_t)mThreadId;
     const int32_t     increment    = (int32_t)mNumProcessors;
+    const int32_t     xAlignMask   = _sl_depth_align_mask(depthBuffer);
+    const ptrdiff_t   depthStep    = _sl_depth_step4(depthBuffer);
     SL_ScanlineBounds scanline;
+    uint64_t          numRasterized = 0;
 
     for (uint32_t i = 0; i < numBins; ++i)
     {
@@ -881,10 +962,13 @@ void SL_TriRasterizer::render_triangle_simd(const SL_Texture* depthBuffer) const
                 continue;
             }
 
+            numRasterized += (uint64_t)(_mm_cvtsi128_si32(xMax) - _mm_cvtsi128_si32(xMin));
+
             const int32_t     y16    = y << 16;
-            const depth_type* pDepth = depthBuffer->row_pointer<depth_type>((uintptr_t)y) + _mm_cvtsi128_si32(xMin);
+            const int32_t     xStart = _mm_cvtsi128_si32(xMin) & xAlignMask;
+            const depth_type* pDepth = depthBuffer->native_texel_pointer<depth_type>((uint16_t)xStart, (uint16_t)y);
             const __m128      bcY    = _mm_fmadd_ps(bcClipSpace1, yf, bcClipSpace2);
-            __m128i           x4     = _mm_add_epi32(_mm_set_epi32(3, 2, 1, 0), xMin);
+            __m128i           x4     = _mm_add_epi32(_mm_set_epi32(3, 2, 1, 0), _mm_set1_epi32(xStart));
             const __m128i     xMax4  = xMax;
 
             __m128 bc[4];
@@ -898,7 +982,7 @@ void SL_TriRasterizer::render_triangle_simd(const SL_Texture* depthBuffer) const
             do
             {
                 // calculate barycentric coordinates and perform a depth test
-                const __m128  xBound    = _mm_castsi128_ps(_mm_cmplt_epi32(x4, xMax4));
+                const __m128  xBound    = _mm_castsi128_ps(_mm_andnot_si128(_mm_cmplt_epi32(x4, xMin), _mm_cmplt_epi32(x4, xMax4)));
                 const __m128  z         = _sl_mul_vec4_mat4_ps(depth, bc);
                 const __m128  d         = _sl_get_depth_texel4<depth_type>(pDepth).simd;
                 const int32_t depthTest = _mm_movemask_ps(_mm_and_ps(xBound, depthCmpFunc(z, d)));
@@ -971,7 +1055,7 @@ void SL_TriRasterizer::render_triangle_simd(const SL_Texture* depthBuffer) const
 
                 x4 = _mm_add_epi32(x4, _mm_set1_epi32(4));
 
-                pDepth += 4;
+                pDepth += depthStep;
             }
             while (_mm_movemask_epi8(_mm_cmplt_epi32(x4, xMax4)));
 
@@ -984,6 +1068,8 @@ void SL_TriRasterizer::render_triangle_simd(const SL_Texture* depthBuffer) const
             flush_fragments<depth_type>(pBin, numQueuedFrags, outCoords);
         }
     }
+
+    mStats->fragsRasterized += numRasterized;
 }
 
 
@@ -1015,7 +1101,10 @@ void SL_TriRasterizer::render_triangle_simd(const SL_Texture* depthBuffer) const
     SL_FragCoord*     outCoords    = mQueues;
     const int32_t     yOffset      = (int32_t)mThreadId;
     const int32_t     increment    = (int32_t)mNumProcessors;
+    const int32_t     xAlignMask   = _sl_depth_align_mask(depthBuffer);
+    const ptrdiff_t   depthStep    = _sl_depth_step4(depthBuffer);
     SL_ScanlineBounds scanline;
+    uint64_t          numRasterized = 0;
 
     for (uint32_t i = 0; i < numBins; ++i)
     {
@@ -1055,9 +1144,13 @@ void SL_TriRasterizer::render_triangle_simd(const SL_Texture* depthBuffer) const
 
             if (LS_UNLIKELY(xMin < xMax))
             {
-                const depth_type*  pDepth = depthBuffer->row_pointer<depth_type>((uintptr_t)y) + xMin;
+                numRasterized += (uint64_t)(xMax - xMin);
+
+                const int32_t      xStart = xMin & xAlignMask;
+                const depth_type*  pDepth = depthBuffer->native_texel_pointer<depth_type>((uint16_t)xStart, (uint16_t)y);
                 const math::vec4&& bcY    = math::fmadd(bcClipSpace[1], math::vec4{yf}, bcClipSpace[2]);
-                math::vec4i&&      x4     = math::vec4i{0, 1, 2, 3} + xMin;
+                math::vec4i&&      x4     = math::vec4i{0, 1, 2, 3} + xStart;
+                const math::vec4i  xMin4  {xMin};
                 const math::vec4i  xMax4  {xMax};
                 math::mat4&&       bc     = math::outer((math::vec4)x4, bcClipSpace[0]) + bcY;
                 const math::vec4&& bcX    = bcClipSpace[0] * 4.f;
@@ -1066,14 +1159,15 @@ void SL_TriRasterizer::render_triangle_simd(const SL_Texture* depthBuffer) const
                 {
                     // calculate barycentric coordinates and perform a depth test
                     const math::vec4i&& xBound = _sl_cmp_vec4_lt(x4, xMax4);
+                    const math::vec4i&& xLower = _sl_cmp_vec4_lt(x4, xMin4);
                     const math::vec4&&  d      = _sl_get_depth_texel4<depth_type>(pDepth);
                     const math::vec4&&  z      = depth * bc;
 
                     math::vec4i&& storeMask4 = depthCmpFunc(z, d);
-                    storeMask4[0] &= xBound[0];
-                    storeMask4[1] &= xBound[1];
-                    storeMask4[2] &= xBound[2];
-                    storeMask4[3] &= xBound[3];
+                    storeMask4[0] &= xBound[0] & ~xLower[0];
+                    storeMask4[1] &= xBound[1] & ~xLower[1];
+                    storeMask4[2] &= xBound[2] & ~xLower[2];
+                    storeMask4[3] &= xBound[3] & ~xLower[3];
 
                     if (LS_LIKELY(storeMask4 != 0))
                     {
@@ -1119,7 +1213,7 @@ void SL_TriRasterizer::render_triangle_simd(const SL_Texture* depthBuffer) const
                         }
                     }
 
-                    pDepth += 4;
+                    pDepth += depthStep;
                     bc += bcX;
                     x4 += 4;
                 }
@@ -1135,6 +1229,8 @@ void SL_TriRasterizer::render_triangle_simd(const SL_Texture* depthBuffer) const
             flush_fragments<depth_type>(pBin, numQueuedFrags, outCoords);
         }
     }
+
+    mStats->fragsRasterized += numRasterized;
 }
 
 
@@ -8,7 +8,8 @@
 -------------------------------------*/
 SL_PTVCache::SL_PTVCache(const SL_PTVCache& ptv) noexcept :
     mParam{ptv.mParam},
-    mShader{ptv.mShader}
+    mShader{ptv.mShader},
+    mNumShaded{ptv.mNumShaded}
 {
     for (size_t i = 0; i < PTV_CACHE_SIZE; ++i)
     {
@@ -24,7 +25,8 @@ SL_PTVCache::SL_PTVCache(const SL_PTVCache& ptv) noexcept :
 -------------------------------------*/
 SL_PTVCache::SL_PTVCache(SL_PTVCache&& ptv) noexcept :
     mParam{ptv.mParam},
-    mShader{ptv.mShader}
+    mShader{ptv.mShader},
+    mNumShaded{ptv.mNumShaded}
 {
     for (size_t i = 0; i < PTV_CACHE_SIZE; ++i)
     {
@@ -42,6 +44,7 @@ SL_PTVCache& SL_PTVCache::operator=(const SL_PTVCache& ptv) noexcept
 {
     mParam = ptv.mParam;
     mShader = ptv.mShader;
+    mNumShaded = ptv.mNumShaded;
 
     for (size_t i = 0; i < PTV_CACHE_SIZE; ++i)
     {
@@ -61,6 +64,7 @@ SL_PTVCache& SL_PTVCache::operator=(SL_PTVCache&& ptv) noexcept
 {
     mParam = ptv.mParam;
     mShader = ptv.mShader;
+    mNumShaded = ptv.mNumShaded;
 
     for (size_t i = 0; i < PTV_CACHE_SIZE; ++i)
     {
@@ -80,6 +84,7 @@ void SL_PTVCache::reset(ls::math::vec4_t<float> (*pShader)(SL_VertexParam&), SL_
 {
     mParam = &inParam;
     mShader = pShader;
+    mNumShaded = 0;
 
     for (size_t& index : mIndices)
     {
@@ -4,8 +4,11 @@
 #include "lightsky/utils/Sort.hpp" // utils::sort_radix
 
 #include "softlight/SL_Context.hpp"
+#include "softlight/SL_DamageRegion.hpp"
 #include "softlight/SL_LineRasterizer.hpp"
+#include "softlight/SL_PipelineStatistics.hpp"
 #include "softlight/SL_PointRasterizer.hpp"
+#include "softlight/SL_Profiler.hpp"
 #include "softlight/SL_Shader.hpp" // SL_Shader
 #include "softlight/SL_ShaderUtil.hpp" // SL_BinCounter, SL_BinCounterAtomic
 #include "softlight/SL_TriRasterizer.hpp"
@@ -20,6 +23,27 @@ namespace utils = ls::utils;
 /*-----------------------------------------------------------------------------
  * SL_VertexProcessor Class
 -----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Determine if a primitive's screen-space bounds miss every rectangle of the
+ * dirty region
+-------------------------------------*/
+bool SL_VertexProcessor::is_outside_dirty_region(float bboxMinX, float bboxMinY, float bboxMaxX, float bboxMaxY) const noexcept
+{
+    for (unsigned i = 0; i < mDirtyRegion->num_rects(); ++i)
+    {
+        const math::vec4&& r = (math::vec4)mDirtyRegion->rect(i);
+
+        if (bboxMaxX >= r[0] && bboxMaxY >= r[1] && bboxMinX <= r[0]+r[2] && bboxMinY <= r[1]+r[3])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
 /*-------------------------------------
  * Execute the rasterizer
 -------------------------------------*/
@@ -36,10 +60,20 @@ void SL_VertexProcessor::flush_rasterizer() const noexcept
     uint_fast64_t         maxElements;
     int_fast64_t          syncPoint2;
 
+    SL_PROFILE_SCOPE(SL_PROFILE_FLUSH, mThreadId);
+
     // Sort the bins based on their depth.
     if (LS_UNLIKELY(tileId == numThreads-1u))
     {
-        maxElements = math::min<uint64_t>(mBinsUsed->count.load(std::memory_order_consume), SL_SHADER_MAX_BINNED_PRIMS);
+        SL_PROFILE_SCOPE(SL_PROFILE_BIN_SORT, mThreadId);
+
+        const uint64_t binsUsed = mBinsUsed->count.load(std::memory_order_consume);
+        maxElements = math::min<uint64_t>(binsUsed, SL_SHADER_MAX_BINNED_PRIMS);
+
+        // Only the thread which sorts the bins records them.
+        SL_PipelineStatistics& stats = mStats[mThreadId];
+        stats.binsFlushed += maxElements;
+        stats.binOverflows += binsUsed > SL_SHADER_MAX_BINNED_PRIMS;
 
         // Try to perform depth sorting once, and only once, per opaque draw
         // call to reduce depth-buffer access during rasterization. Sorting
@@ -48,8 +82,11 @@ void SL_VertexProcessor::flush_rasterizer() const noexcept
         const bool canDepthSort = maxElements < SL_SHADER_MAX_BINNED_PRIMS;
 
         // Blended fragments get sorted by their primitive index for
-        // consistency.
-        if (LS_UNLIKELY(mShader->fragment_shader().blend != SL_BLEND_OFF))
+        // consistency. Weighted OIT is order-independent and can take the
+        // depth-sorted path instead.
+        const SL_BlendMode blendMode = mShader->fragment_shader().blend;
+
+        if (LS_UNLIKELY(blendMode != SL_BLEND_OFF && blendMode != SL_BLEND_WEIGHTED_OIT))
         {
             utils::sort_radix<SL_BinCounter<uint32_t>>(mBinIds, mTempBinIds, maxElements, [&](const SL_BinCounter<uint32_t>& val) noexcept->unsigned long long
             {
@@ -72,6 +109,8 @@ void SL_VertexProcessor::flush_rasterizer() const noexcept
     }
     else
     {
+        SL_PROFILE_SCOPE(SL_PROFILE_BARRIER_WAIT, mThreadId);
+
         do
         {
             int_fast64_t activeProcCount = mFragProcessors->count.load(std::memory_order_relaxed);
@@ -121,8 +160,13 @@ void SL_VertexProcessor::flush_rasterizer() const noexcept
     rasterizer.mBinIds = mBinIds;
     rasterizer.mBins = mFragBins;
     rasterizer.mQueues = mFragQueues + mThreadId;
+    rasterizer.mStats = mStats + mThreadId;
+    rasterizer.mDirtyRegion = mDirtyRegion;
 
-    rasterizer.execute();
+    {
+        SL_PROFILE_SCOPE(SL_PROFILE_RASTER, mThreadId);
+        rasterizer.execute();
+    }
 
     // Indicate to all threads we can now process more vertices
     syncPoint2 = mFragProcessors->count.fetch_add(1, std::memory_order_acq_rel);
@@ -135,6 +179,7 @@ void SL_VertexProcessor::flush_rasterizer() const noexcept
     }
 
     // Wait for the last thread to reset the number of available bins.
+    SL_PROFILE_SCOPE(SL_PROFILE_BARRIER_WAIT, mThreadId);
     int_fast64_t shouldContinue;
     currentIters = 1;
 
@@ -0,0 +1,130 @@
+#include <limits> // std::numeric_limits
+
+#include "lightsky/utils/Assertions.h"
+
+#include "lightsky/math/scalar_utils.h"
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_Texture.hpp"
+#include "softlight/SL_VolumeProcessor.hpp"
+#include "softlight/SL_VolumeRendering.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions and namespaces
+-----------------------------------------------------------------------------*/
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_VolumeProcessor Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Min/Max reduction of each brick
+-------------------------------------*/
+template <typename data_type, SL_TexelOrder order>
+void SL_VolumeProcessor::reduce_bricks() noexcept
+{
+    SL_VolumeBricks&  bricks    = *mBricks;
+    const SL_Texture& tex       = *mVolume;
+    const int         brickSize = (int)bricks.mBrickSize;
+    const int         w         = (int)tex.width();
+    const int         h         = (int)tex.height();
+    const int         d         = (int)tex.depth();
+    const unsigned    numBricks = bricks.num_bricks();
+    const data_type*  pTexels   = reinterpret_cast<const data_type*>(tex.data());
+
+    for (unsigned brickId = mThreadId; brickId < numBricks; brickId += mNumThreads)
+    {
+        const int bx = (int)(brickId % bricks.mBricksX);
+        const int by = (int)((brickId / bricks.mBricksX) % bricks.mBricksY);
+        const int bz = (int)(brickId / ((unsigned)bricks.mBricksX * (unsigned)bricks.mBricksY));
+
+        // Include a border of one texel to account for filtering
+        const int x0 = math::max(bx * brickSize - 1, 0);
+        const int y0 = math::max(by * brickSize - 1, 0);
+        const int z0 = math::max(bz * brickSize - 1, 0);
+        const int x1 = math::min((bx+1) * brickSize, w-1);
+        const int y1 = math::min((by+1) * brickSize, h-1);
+        const int z1 = math::min((bz+1) * brickSize, d-1);
+
+        data_type lo = std::numeric_limits<data_type>::max();
+        data_type hi = std::numeric_limits<data_type>::lowest();
+
+        for (int z = z0; z <= z1; ++z)
+        {
+            for (int y = y0; y <= y1; ++y)
+            {
+                if (order == SL_TEXELS_ORDERED)
+                {
+                    // Rows are contiguous, letting the compiler vectorize
+                    // the reduction.
+                    const data_type* pRow = pTexels + tex.map_coordinate<order>(0, y, z);
+
+                    for (int x = x0; x <= x1; ++x)
+                    {
+                        lo = math::min(lo, pRow[x]);
+                        hi = math::max(hi, pRow[x]);
+                    }
+                }
+                else
+                {
+                    for (int x = x0; x <= x1; ++x)
+                    {
+                        const data_type t = pTexels[tex.map_coordinate<order>(x, y, z)];
+                        lo = math::min(lo, t);
+                        hi = math::max(hi, t);
+                    }
+                }
+            }
+        }
+
+        bricks.mRanges[brickId] = SL_VolumeBrickRange{(float)lo, (float)hi};
+    }
+}
+
+
+
+template void SL_VolumeProcessor::reduce_bricks<uint8_t, SL_TEXELS_ORDERED>() noexcept;
+template void SL_VolumeProcessor::reduce_bricks<uint8_t, SL_TEXELS_SWIZZLED>() noexcept;
+template void SL_VolumeProcessor::reduce_bricks<uint16_t, SL_TEXELS_ORDERED>() noexcept;
+template void SL_VolumeProcessor::reduce_bricks<uint16_t, SL_TEXELS_SWIZZLED>() noexcept;
+template void SL_VolumeProcessor::reduce_bricks<uint32_t, SL_TEXELS_ORDERED>() noexcept;
+template void SL_VolumeProcessor::reduce_bricks<uint32_t, SL_TEXELS_SWIZZLED>() noexcept;
+template void SL_VolumeProcessor::reduce_bricks<float, SL_TEXELS_ORDERED>() noexcept;
+template void SL_VolumeProcessor::reduce_bricks<float, SL_TEXELS_SWIZZLED>() noexcept;
+
+
+
+/*-------------------------------------
+ * Build the brick grid
+-------------------------------------*/
+void SL_VolumeProcessor::execute() noexcept
+{
+    const bool swizzled = mTexelOrder == SL_TEXELS_SWIZZLED;
+
+    switch (mVolume->type())
+    {
+        case SL_COLOR_R_8U:
+            swizzled ? reduce_bricks<uint8_t, SL_TEXELS_SWIZZLED>() : reduce_bricks<uint8_t, SL_TEXELS_ORDERED>();
+            break;
+
+        case SL_COLOR_R_16U:
+            swizzled ? reduce_bricks<uint16_t, SL_TEXELS_SWIZZLED>() : reduce_bricks<uint16_t, SL_TEXELS_ORDERED>();
+            break;
+
+        case SL_COLOR_R_32U:
+            swizzled ? reduce_bricks<uint32_t, SL_TEXELS_SWIZZLED>() : reduce_bricks<uint32_t, SL_TEXELS_ORDERED>();
+            break;
+
+        case SL_COLOR_R_FLOAT:
+            swizzled ? reduce_bricks<float, SL_TEXELS_SWIZZLED>() : reduce_bricks<float, SL_TEXELS_ORDERED>();
+            break;
+
+        default:
+            LS_DEBUG_ASSERT(false);
+            LS_UNREACHABLE();
+    }
+}
@@ -0,0 +1,190 @@
+
+#include <limits> // std::numeric_limits
+#include <utility> // std::move()
+
+#include "lightsky/utils/Copy.h" // fast_memcpy()
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_VolumeRendering.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_VolumeBricks Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Destructor
+-------------------------------------*/
+SL_VolumeBricks::~SL_VolumeBricks() noexcept
+{
+    terminate();
+}
+
+
+
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_VolumeBricks::SL_VolumeBricks() noexcept :
+    mScaleX{0.f},
+    mScaleY{0.f},
+    mScaleZ{0.f},
+    mBrickSize{0},
+    mBricksX{0},
+    mBricksY{0},
+    mBricksZ{0},
+    mRanges{nullptr}
+{}
+
+
+
+/*-------------------------------------
+ * Copy Constructor
+-------------------------------------*/
+SL_VolumeBricks::SL_VolumeBricks(const SL_VolumeBricks& b) noexcept :
+    SL_VolumeBricks{}
+{
+    *this = b;
+}
+
+
+
+/*-------------------------------------
+ * Move Constructor
+-------------------------------------*/
+SL_VolumeBricks::SL_VolumeBricks(SL_VolumeBricks&& b) noexcept :
+    SL_VolumeBricks{}
+{
+    *this = std::move(b);
+}
+
+
+
+/*-------------------------------------
+ * Copy Operator
+-------------------------------------*/
+SL_VolumeBricks& SL_VolumeBricks::operator=(const SL_VolumeBricks& b) noexcept
+{
+    if (this == &b)
+    {
+        return *this;
+    }
+
+    if (!b.mRanges)
+    {
+        terminate();
+        return *this;
+    }
+
+    mRanges = ls::utils::make_unique_aligned_array<SL_VolumeBrickRange>(b.num_bricks());
+    if (!mRanges)
+    {
+        terminate();
+        return *this;
+    }
+
+    mScaleX    = b.mScaleX;
+    mScaleY    = b.mScaleY;
+    mScaleZ    = b.mScaleZ;
+    mBrickSize = b.mBrickSize;
+    mBricksX   = b.mBricksX;
+    mBricksY   = b.mBricksY;
+    mBricksZ   = b.mBricksZ;
+
+    ls::utils::fast_memcpy(mRanges.get(), b.mRanges.get(), sizeof(SL_VolumeBrickRange) * num_bricks());
+
+    return *this;
+}
+
+
+
+/*-------------------------------------
+ * Move Operator
+-------------------------------------*/
+SL_VolumeBricks& SL_VolumeBricks::operator=(SL_VolumeBricks&& b) noexcept
+{
+    if (this == &b)
+    {
+        return *this;
+    }
+
+    mScaleX    = b.mScaleX;
+    mScaleY    = b.mScaleY;
+    mScaleZ    = b.mScaleZ;
+    mBrickSize = b.mBrickSize;
+    mBricksX   = b.mBricksX;
+    mBricksY   = b.mBricksY;
+    mBricksZ   = b.mBricksZ;
+    mRanges    = std::move(b.mRanges);
+
+    b.terminate();
+
+    return *this;
+}
+
+
+
+/*-------------------------------------
+ * Allocate the brick grid
+-------------------------------------*/
+int SL_VolumeBricks::init(uint16_t volumeW, uint16_t volumeH, uint16_t volumeD, uint16_t brickSize) noexcept
+{
+    if (!volumeW || !volumeH || !volumeD || !brickSize)
+    {
+        return -1;
+    }
+
+    const uint16_t bricksX = (uint16_t)((volumeW + brickSize - 1u) / brickSize);
+    const uint16_t bricksY = (uint16_t)((volumeH + brickSize - 1u) / brickSize);
+    const uint16_t bricksZ = (uint16_t)((volumeD + brickSize - 1u) / brickSize);
+
+    mRanges = ls::utils::make_unique_aligned_array<SL_VolumeBrickRange>((size_t)bricksX * (size_t)bricksY * (size_t)bricksZ);
+    if (!mRanges)
+    {
+        terminate();
+        return -2;
+    }
+
+    mScaleX    = (float)volumeW / (float)brickSize;
+    mScaleY    = (float)volumeH / (float)brickSize;
+    mScaleZ    = (float)volumeD / (float)brickSize;
+    mBrickSize = brickSize;
+    mBricksX   = bricksX;
+    mBricksY   = bricksY;
+    mBricksZ   = bricksZ;
+
+    // Nothing can be skipped until the bricks have been built
+    for (unsigned i = 0; i < num_bricks(); ++i)
+    {
+        mRanges[i] = SL_VolumeBrickRange{-std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+    }
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Allocate the brick grid for a texture
+-------------------------------------*/
+int SL_VolumeBricks::init(const SL_Texture& volume, uint16_t brickSize) noexcept
+{
+    return init(volume.width(), volume.height(), volume.depth(), brickSize);
+}
+
+
+
+/*-------------------------------------
+ * Release all resources
+-------------------------------------*/
+void SL_VolumeBricks::terminate() noexcept
+{
+    mScaleX    = 0.f;
+    mScaleY    = 0.f;
+    mScaleZ    = 0.f;
+    mBrickSize = 0;
+    mBricksX   = 0;
+    mBricksY   = 0;
+    mBricksZ   = 0;
+    mRanges.reset();
+}
@@ -12,7 +12,9 @@
     #include "softlight/SL_WindowBufferXlib.hpp"
 #endif
 
+#include "softlight/SL_RenderWindowHeadless.hpp"
 #include "softlight/SL_WindowBuffer.hpp"
+#include "softlight/SL_WindowBufferHeadless.hpp"
 
 
 
@@ -28,7 +30,9 @@ SL_WindowBuffer::~SL_WindowBuffer() noexcept
 /*-------------------------------------
  * Constructor
 -------------------------------------*/
-SL_WindowBuffer::SL_WindowBuffer() noexcept
+SL_WindowBuffer::SL_WindowBuffer() noexcept :
+    mTexture{},
+    mDamage{}
 {
 }
 
@@ -38,8 +42,11 @@ SL_WindowBuffer::SL_WindowBuffer() noexcept
  * Move Constructor
 -------------------------------------*/
 SL_WindowBuffer::SL_WindowBuffer(SL_WindowBuffer&& wb) noexcept :
-    mTexture{std::move(wb.mTexture)}
-{}
+    mTexture{std::move(wb.mTexture)},
+    mDamage{wb.mDamage}
+{
+    wb.mDamage.clear();
+}
 
 
 
@@ -49,6 +56,10 @@ SL_WindowBuffer::SL_WindowBuffer(SL_WindowBuffer&& wb) noexcept :
 SL_WindowBuffer& SL_WindowBuffer::operator=(SL_WindowBuffer&& wb) noexcept
 {
     mTexture = std::move(wb.mTexture);
+
+    mDamage = wb.mDamage;
+    wb.mDamage.clear();
+
     return *this;
 }
 
@@ -73,3 +84,18 @@ ls::utils::Pointer<SL_WindowBuffer> SL_WindowBuffer::create() noexcept
         #error "Window buffer backend not implemented for this platform."
     #endif
 }
+
+
+
+/*-------------------------------------
+ * Instance Creation for a Window
+-------------------------------------*/
+ls::utils::Pointer<SL_WindowBuffer> SL_WindowBuffer::create(const SL_RenderWindow& window) noexcept
+{
+    if (dynamic_cast<const SL_RenderWindowHeadless*>(&window) != nullptr)
+    {
+        return ls::utils::Pointer<SL_WindowBuffer>{new SL_WindowBufferHeadless{}};
+    }
+
+    return SL_WindowBuffer::create();
+}
@@ -0,0 +1,102 @@
+
+#include <utility> // std::move()
+
+#include "softlight/SL_RenderWindow.hpp"
+#include "softlight/SL_WindowBufferHeadless.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_WindowBufferHeadless Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Destructor
+-------------------------------------*/
+SL_WindowBufferHeadless::~SL_WindowBufferHeadless() noexcept
+{
+    terminate();
+}
+
+
+
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_WindowBufferHeadless::SL_WindowBufferHeadless() noexcept :
+    SL_WindowBuffer{},
+    mWindow{nullptr}
+{}
+
+
+
+/*-------------------------------------
+ * Move Constructor
+-------------------------------------*/
+SL_WindowBufferHeadless::SL_WindowBufferHeadless(SL_WindowBufferHeadless&& wb) noexcept :
+    SL_WindowBuffer{std::move(wb)},
+    mWindow{wb.mWindow}
+{
+    wb.mWindow = nullptr;
+}
+
+
+
+/*-------------------------------------
+ * Move Operator
+-------------------------------------*/
+SL_WindowBufferHeadless& SL_WindowBufferHeadless::operator=(SL_WindowBufferHeadless&& wb) noexcept
+{
+    if (this != &wb)
+    {
+        SL_WindowBuffer::operator=(std::move(wb));
+
+        mWindow = wb.mWindow;
+        wb.mWindow = nullptr;
+    }
+
+    return *this;
+}
+
+
+
+/*-------------------------------------
+ * Allocate the backbuffer
+-------------------------------------*/
+int SL_WindowBufferHeadless::init(SL_RenderWindow& win, unsigned width, unsigned height) noexcept
+{
+    if (mWindow)
+    {
+        return 0;
+    }
+
+    if (!win.valid())
+    {
+        return -1;
+    }
+
+    if (mTexture.init(SL_COLOR_RGBA_8U, width, height, 1) != 0)
+    {
+        return -2;
+    }
+
+    mWindow = &win;
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Release the backbuffer
+-------------------------------------*/
+int SL_WindowBufferHeadless::terminate() noexcept
+{
+    if (mWindow)
+    {
+        mTexture.terminate();
+        mDamage.clear();
+        mWindow = nullptr;
+    }
+
+    return 0;
+}
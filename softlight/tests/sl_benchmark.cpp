@@ -0,0 +1,545 @@
+// Headless rendering benchmark.
+//
+// Usage: sl_benchmark [scene file] [frame count] [thread count] [PPM prefix] [capture file]
+//
+// A scene is rendered along a fixed orbit around its bounds using a headless
+// window, so timings can be gathered on machines without a display. Each
+// frame's time is printed in milliseconds, followed by a summary. If a PPM
+// prefix is given, every frame is also saved to "<prefix>_<frame>.ppm". Pass
+// "-" to skip saving images. If a capture file is given, the first frame is
+// recorded and saved for use with sl_replay. If the thread count is "auto",
+// SL_Context::calibrate_threads() picks the fastest thread count and CPU
+// placement using the first frame of the orbit before rendering begins.
+//
+// When built with SL_PROFILING_ENABLED, per-thread pipeline timings are saved
+// as a Chrome trace to SL_BENCHMARK_TRACE_FILE.
+//
+// Meshes are expected to contain positions, UVs, and normals.
+
+#include <algorithm> // std::sort()
+#include <chrono>
+#include <cstddef> // offsetof()
+#include <cstdlib> // std::strtoul()
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lightsky/math/vec_utils.h"
+#include "lightsky/math/mat_utils.h"
+
+#include "lightsky/utils/Assertions.h"
+#include "lightsky/utils/Pointer.h"
+
+#include "softlight/SL_BoundingBox.hpp"
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_FrameCapture.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_ImgFilePPM.hpp"
+#include "softlight/SL_Material.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_Profiler.hpp"
+#include "softlight/SL_RenderWindow.hpp"
+#include "softlight/SL_Sampler.hpp"
+#include "softlight/SL_SceneFileLoader.hpp"
+#include "softlight/SL_SceneGraph.hpp"
+#include "softlight/SL_Shader.hpp"
+#include "softlight/SL_Texture.hpp"
+#include "softlight/SL_UniformBuffer.hpp"
+#include "softlight/SL_VertexArray.hpp"
+#include "softlight/SL_VertexBuffer.hpp"
+#include "softlight/SL_WindowBuffer.hpp"
+
+namespace math = ls::math;
+namespace utils = ls::utils;
+
+
+
+#ifndef IMAGE_WIDTH
+    #define IMAGE_WIDTH 1280
+#endif /* IMAGE_WIDTH */
+
+#ifndef IMAGE_HEIGHT
+    #define IMAGE_HEIGHT 720
+#endif /* IMAGE_HEIGHT */
+
+#ifndef SL_TEST_MAX_THREADS
+    #define SL_TEST_MAX_THREADS (ls::math::max<unsigned>(std::thread::hardware_concurrency(), 2u) - 1u)
+#endif /* SL_TEST_MAX_THREADS */
+
+#ifndef SL_BENCHMARK_SCENE_FILE
+    #define SL_BENCHMARK_SCENE_FILE "testdata/sibenik/sibenik.obj"
+#endif /* SL_BENCHMARK_SCENE_FILE */
+
+#ifndef SL_BENCHMARK_FRAMES
+    #define SL_BENCHMARK_FRAMES 300
+#endif /* SL_BENCHMARK_FRAMES */
+
+#ifndef SL_BENCHMARK_TRACE_FILE
+    #define SL_BENCHMARK_TRACE_FILE "sl_benchmark_trace.json"
+#endif /* SL_BENCHMARK_TRACE_FILE */
+
+
+
+/*-----------------------------------------------------------------------------
+ * Shader to display vertices with positions, UVs, normals, and a texture
+-----------------------------------------------------------------------------*/
+struct BenchmarkUniforms
+{
+    const SL_Texture* pTexture;
+    SL_ColorRGBAf     diffuse;
+    math::vec4        lightPos;
+    math::mat4        modelMatrix;
+    math::mat4        mvpMatrix;
+};
+
+
+
+/*--------------------------------------
+ * Vertex Shader
+--------------------------------------*/
+math::vec4 _benchmark_vert_shader(SL_VertexParam& param)
+{
+    const BenchmarkUniforms* pUniforms = param.pUniforms->as<BenchmarkUniforms>();
+    const math::vec3&        vert      = *(param.pVbo->element<const math::vec3>(param.pVao->offset(0, param.vertId)));
+    const math::vec2&        uv        = *(param.pVbo->element<const math::vec2>(param.pVao->offset(1, param.vertId)));
+    const math::vec3&        norm      = *(param.pVbo->element<const math::vec3>(param.pVao->offset(2, param.vertId)));
+
+    param.pVaryings[0] = pUniforms->modelMatrix * math::vec4{vert[0], vert[1], vert[2], 1.f};
+    param.pVaryings[1] = math::vec4{uv.v[0], uv.v[1], 0.f, 0.f};
+    param.pVaryings[2] = math::normalize(pUniforms->modelMatrix * math::vec4{norm[0], norm[1], norm[2], 0.f});
+
+    return pUniforms->mvpMatrix * math::vec4{vert[0], vert[1], vert[2], 1.f};
+}
+
+
+
+SL_VertexShader benchmark_vert_shader()
+{
+    SL_VertexShader shader;
+    shader.numVaryings = 3;
+    shader.cullMode    = SL_CULL_BACK_FACE;
+    shader.shader      = _benchmark_vert_shader;
+
+    return shader;
+}
+
+
+
+/*--------------------------------------
+ * Fragment Shader
+--------------------------------------*/
+bool _benchmark_frag_shader(SL_FragmentParam& fragParams)
+{
+    const BenchmarkUniforms* pUniforms = fragParams.pUniforms->as<BenchmarkUniforms>();
+    const math::vec4         pos       = fragParams.pVaryings[0];
+    const math::vec4         uv        = fragParams.pVaryings[1];
+    const math::vec4         norm      = math::normalize(fragParams.pVaryings[2]);
+    const SL_Texture*        pTexture  = pUniforms->pTexture;
+    math::vec4               pixel     = pUniforms->diffuse;
+
+    if (pTexture)
+    {
+        if (pTexture->channels() == 3)
+        {
+            const math::vec3_t<uint8_t>&& pixel8 = sl_sample_nearest<math::vec3_t<uint8_t>, SL_WrapMode::REPEAT>(*pTexture, uv[0], uv[1]);
+            pixel = color_cast<float, uint8_t>(math::vec4_t<uint8_t>{pixel8[0], pixel8[1], pixel8[2], 255});
+        }
+        else
+        {
+            pixel = color_cast<float, uint8_t>(sl_sample_nearest<math::vec4_t<uint8_t>, SL_WrapMode::REPEAT>(*pTexture, uv[0], uv[1]));
+        }
+    }
+
+    const math::vec4&& lightDir   = math::normalize(pUniforms->lightPos - pos);
+    const float        lightAngle = math::max(0.25f + math::dot(lightDir, norm) * 0.75f, 0.f);
+
+    fragParams.pOutputs[0] = math::min(pixel * lightAngle, math::vec4{1.f});
+
+    return true;
+}
+
+
+
+SL_FragmentShader benchmark_frag_shader()
+{
+    SL_FragmentShader shader;
+    shader.numVaryings = 3;
+    shader.numOutputs  = 1;
+    shader.blend       = SL_BLEND_OFF;
+    shader.depthTest   = SL_DEPTH_TEST_GREATER_EQUAL;
+    shader.depthMask   = SL_DEPTH_MASK_ON;
+    shader.shader      = _benchmark_frag_shader;
+
+    return shader;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Create the context for a benchmark scene
+-----------------------------------------------------------------------------*/
+utils::Pointer<SL_SceneGraph> benchmark_create_context(const char* pSceneFile, unsigned numThreads)
+{
+    int retCode = 0;
+
+    SL_SceneFileLoader meshLoader;
+    utils::Pointer<SL_SceneGraph> pGraph{new SL_SceneGraph{}};
+    SL_Context& context = pGraph->mContext;
+
+    size_t fboId   = context.create_framebuffer();
+    size_t texId   = context.create_texture();
+    size_t depthId = context.create_texture();
+
+    context.num_threads(numThreads);
+
+    SL_Texture& tex = context.texture(texId);
+    retCode = tex.init(SL_ColorDataType::SL_COLOR_RGB_8U, IMAGE_WIDTH, IMAGE_HEIGHT, 1);
+    LS_ASSERT(retCode == 0);
+
+    SL_Texture& depth = context.texture(depthId);
+    retCode = depth.init(SL_ColorDataType::SL_COLOR_R_FLOAT, IMAGE_WIDTH, IMAGE_HEIGHT, 1);
+    LS_ASSERT(retCode == 0);
+
+    SL_Framebuffer& fbo = context.framebuffer(fboId);
+    retCode = fbo.reserve_color_buffers(1);
+    LS_ASSERT(retCode == 0);
+
+    retCode = fbo.attach_color_buffer(0, tex);
+    LS_ASSERT(retCode == 0);
+
+    retCode = fbo.attach_depth_buffer(depth);
+    LS_ASSERT(retCode == 0);
+
+    retCode = fbo.valid();
+    LS_ASSERT(retCode == 0);
+
+    if (!meshLoader.load(pSceneFile))
+    {
+        std::cerr << "Unable to load the scene file " << pSceneFile << std::endl;
+        return utils::Pointer<SL_SceneGraph>{nullptr};
+    }
+
+    retCode = (int)pGraph->import(meshLoader.data());
+    LS_ASSERT(retCode == 0);
+
+    pGraph->update();
+
+    size_t uboId = context.create_ubo();
+    BenchmarkUniforms* pUniforms = context.ubo(uboId).as<BenchmarkUniforms>();
+    pUniforms->pTexture = nullptr;
+    pUniforms->diffuse  = SL_ColorRGBAf{1.f};
+    pUniforms->lightPos = math::vec4{0.f};
+
+    size_t shaderId = context.create_shader(benchmark_vert_shader(), benchmark_frag_shader(), uboId);
+    LS_ASSERT(shaderId == 0);
+
+    (void)shaderId;
+    (void)retCode;
+
+    return pGraph;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Calculate the world-space bounds of all meshes in a scene
+-----------------------------------------------------------------------------*/
+void benchmark_scene_bounds(const SL_SceneGraph& graph, math::vec4& outMin, math::vec4& outMax)
+{
+    outMin = math::vec4{std::numeric_limits<float>::max()};
+    outMax = math::vec4{-std::numeric_limits<float>::max()};
+
+    for (const SL_SceneNode& n : graph.mNodes)
+    {
+        if (n.type != NODE_TYPE_MESH)
+        {
+            continue;
+        }
+
+        const math::mat4& modelMat = graph.mModelMatrices[n.nodeId];
+        const size_t numNodeMeshes = graph.mNumNodeMeshes[n.dataId];
+        const utils::Pointer<size_t[]>& meshIds = graph.mNodeMeshes[n.dataId];
+
+        for (size_t meshId = 0; meshId < numNodeMeshes; ++meshId)
+        {
+            const SL_BoundingBox& box = graph.mMeshBounds[meshIds[meshId]];
+            outMin = math::min(outMin, box.min_point(modelMat));
+            outMax = math::max(outMax, box.max_point(modelMat));
+        }
+    }
+
+    if (outMin[0] > outMax[0])
+    {
+        outMin = math::vec4{-1.f};
+        outMax = math::vec4{1.f};
+    }
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Camera orbiting the scene, one revolution over all frames
+-----------------------------------------------------------------------------*/
+math::vec3 benchmark_camera_position(const math::vec4& center, float radius, unsigned frame, unsigned numFrames)
+{
+    const float angle = LS_TWO_PI * (float)frame / (float)numFrames;
+
+    return math::vec3{
+        center[0] + radius * math::cos(angle),
+        center[1] + radius * 0.25f,
+        center[2] + radius * math::sin(angle)
+    };
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Render a scene
+-----------------------------------------------------------------------------*/
+void benchmark_render(SL_SceneGraph* pGraph, const math::mat4& vpMatrix)
+{
+    SL_Context&        context   = pGraph->mContext;
+    BenchmarkUniforms* pUniforms = context.ubo(0).as<BenchmarkUniforms>();
+
+    for (SL_SceneNode& n : pGraph->mNodes)
+    {
+        if (n.type != NODE_TYPE_MESH)
+        {
+            continue;
+        }
+
+        const math::mat4& modelMat = pGraph->mModelMatrices[n.nodeId];
+        const size_t numNodeMeshes = pGraph->mNumNodeMeshes[n.dataId];
+        const utils::Pointer<size_t[]>& meshIds = pGraph->mNodeMeshes[n.dataId];
+
+        pUniforms->modelMatrix = modelMat;
+        pUniforms->mvpMatrix   = vpMatrix * modelMat;
+
+        for (size_t meshId = 0; meshId < numNodeMeshes; ++meshId)
+        {
+            const SL_Mesh&     m        = pGraph->mMeshes[meshIds[meshId]];
+            const SL_Material& material = pGraph->mMaterials[m.materialId];
+
+            pUniforms->pTexture = material.pTextures[SL_MATERIAL_TEXTURE_DIFFUSE];
+            pUniforms->diffuse  = material.diffuse;
+
+            context.draw(m, 0, 0);
+        }
+    }
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Workload used to calibrate the thread count
+-----------------------------------------------------------------------------*/
+struct BenchmarkCalibration
+{
+    SL_SceneGraph* pGraph;
+    math::mat4 vpMatrix;
+};
+
+
+
+void benchmark_calibrate_frame(SL_Context& context, void* pUserData)
+{
+    const BenchmarkCalibration* pCalibration = reinterpret_cast<const BenchmarkCalibration*>(pUserData);
+
+    context.clear_framebuffer(0, 0, SL_ColorRGBAd{0.6, 0.6, 0.6, 1.0}, 0.0);
+    benchmark_render(pCalibration->pGraph, pCalibration->vpMatrix);
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Main
+-----------------------------------------------------------------------------*/
+int main(int argc, char** argv)
+{
+    const char* const pSceneFile  = (argc > 1) ? argv[1] : SL_BENCHMARK_SCENE_FILE;
+    const unsigned    numFrames   = (argc > 2) ? (unsigned)std::strtoul(argv[2], nullptr, 10) : (unsigned)SL_BENCHMARK_FRAMES;
+    const bool        autoThreads = (argc > 3) && std::string{argv[3]} == "auto";
+    const unsigned    numThreads  = autoThreads ? 1u : ((argc > 3) ? (unsigned)std::strtoul(argv[3], nullptr, 10) : (unsigned)SL_TEST_MAX_THREADS);
+    const char* const pPpmPrefix  = (argc > 4 && std::string{argv[4]} != "-") ? argv[4] : nullptr;
+    const char* const pCapture    = (argc > 5) ? argv[5] : nullptr;
+
+    if (!numFrames || !numThreads)
+    {
+        std::cerr << "Usage: " << argv[0] << " [scene file] [frame count] [thread count|auto] [PPM prefix] [capture file]" << std::endl;
+        return -1;
+    }
+
+    utils::Pointer<SL_RenderWindow> pWindow{SL_RenderWindow::create_headless()};
+    utils::Pointer<SL_WindowBuffer> pRenderBuf{nullptr};
+
+    if (pWindow->init(IMAGE_WIDTH, IMAGE_HEIGHT) != 0 || !pWindow->run())
+    {
+        std::cerr << "Unable to initialize a headless window." << std::endl;
+        return -2;
+    }
+
+    pRenderBuf = SL_WindowBuffer::create(*pWindow);
+    if (pRenderBuf->init(*pWindow, IMAGE_WIDTH, IMAGE_HEIGHT) != 0)
+    {
+        std::cerr << "Unable to initialize a headless window buffer." << std::endl;
+        pWindow->destroy();
+        return -3;
+    }
+
+    utils::Pointer<SL_SceneGraph> pGraph{benchmark_create_context(pSceneFile, numThreads)};
+    if (!pGraph.get())
+    {
+        pRenderBuf->terminate();
+        pWindow->destroy();
+        return -4;
+    }
+
+    SL_Context&  context = pGraph->mContext;
+    SL_Texture&  tex     = context.texture(0);
+    math::vec4   boundsMin, boundsMax;
+
+    benchmark_scene_bounds(*pGraph, boundsMin, boundsMax);
+
+    const math::vec4   center     = (boundsMin + boundsMax) * 0.5f;
+    const float        radius     = math::max(math::length(boundsMax - boundsMin) * 0.5f, 0.01f);
+    const math::mat4&& projMatrix = math::infinite_perspective(LS_DEG2RAD(60.f), (float)IMAGE_WIDTH/(float)IMAGE_HEIGHT, 0.01f);
+
+    context.ubo(0).as<BenchmarkUniforms>()->lightPos = center + math::vec4{0.f, radius, 0.f, 0.f};
+
+    if (autoThreads)
+    {
+        const math::vec3&& camPos = benchmark_camera_position(center, radius, 0, numFrames);
+        const math::vec3   target = math::vec3{center[0], center[1], center[2]};
+
+        BenchmarkCalibration calibration;
+        calibration.pGraph   = pGraph.get();
+        calibration.vpMatrix = projMatrix * math::look_at(camPos, target, math::vec3{0.f, 1.f, 0.f});
+
+        context.calibrate_threads(&benchmark_calibrate_frame, &calibration);
+    }
+
+    std::vector<double> frameTimes;
+    frameTimes.reserve(numFrames);
+
+    std::cout
+        << "Rendering " << numFrames << " frames of " << pSceneFile
+        << " at " << IMAGE_WIDTH << 'x' << IMAGE_HEIGHT
+        << " with " << context.num_threads() << " threads (placement: "
+        << sl_thread_placement_name(context.thread_placement()) << ")." << std::endl;
+
+    // No-op unless profiling was enabled at compile-time
+    sl_profiler_begin(context.num_threads());
+
+    const SL_CaptureTextureSlot textureSlot{0, (uint32_t)offsetof(BenchmarkUniforms, pTexture)};
+
+    SL_FrameCapture capture;
+    if (pCapture && context.begin_capture(capture, &textureSlot, 1) != 0)
+    {
+        std::cerr << "Unable to begin a frame capture." << std::endl;
+        pCapture = nullptr;
+    }
+
+    SL_PipelineQuery query;
+    context.begin_query(query);
+
+    for (unsigned i = 0; i < numFrames; ++i)
+    {
+        const math::vec3&& camPos     = benchmark_camera_position(center, radius, i, numFrames);
+        const math::vec3   target     = math::vec3{center[0], center[1], center[2]};
+        const math::mat4&& viewMatrix = math::look_at(camPos, target, math::vec3{0.f, 1.f, 0.f});
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        context.clear_framebuffer(0, 0, SL_ColorRGBAd{0.6, 0.6, 0.6, 1.0}, 0.0);
+        benchmark_render(pGraph.get(), projMatrix * viewMatrix);
+        context.blit(*pRenderBuf, 0);
+        pWindow->render(*pRenderBuf);
+
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        const double ms = std::chrono::duration<double, std::milli>{end - start}.count();
+
+        frameTimes.push_back(ms);
+        std::cout << "frame " << i << ": " << ms << " ms" << std::endl;
+
+        if (pCapture && capture.recording())
+        {
+            context.end_capture();
+
+            if (capture.save(pCapture) == 0)
+            {
+                std::cout << "Saved " << capture.num_commands() << " commands to " << pCapture << std::endl;
+            }
+            else
+            {
+                std::cerr << "Unable to save " << pCapture << std::endl;
+            }
+        }
+
+        if (pPpmPrefix)
+        {
+            const std::string fileName = std::string{pPpmPrefix} + '_' + std::to_string(i) + ".ppm";
+            if (sl_img_save_ppm(tex.width(), tex.height(), reinterpret_cast<const SL_ColorRGB8*>(tex.data()), fileName.c_str()) != 0)
+            {
+                std::cerr << "Unable to save " << fileName << std::endl;
+            }
+        }
+    }
+
+    context.end_query(query);
+
+    if (sl_profiler_active())
+    {
+        sl_profiler_end();
+
+        if (sl_profiler_save_trace(SL_BENCHMARK_TRACE_FILE) == 0)
+        {
+            std::cout
+                << "Saved " << sl_profiler_num_events() << " pipeline events to " << SL_BENCHMARK_TRACE_FILE
+                << " (" << sl_profiler_num_dropped() << " dropped)." << std::endl;
+        }
+        else
+        {
+            std::cerr << "Unable to save " << SL_BENCHMARK_TRACE_FILE << std::endl;
+        }
+
+        sl_profiler_terminate();
+    }
+
+    double totalMs = 0.0;
+    for (double ms : frameTimes)
+    {
+        totalMs += ms;
+    }
+
+    std::sort(frameTimes.begin(), frameTimes.end());
+
+    std::cout
+        << "Rendered " << numFrames << " frames in " << (totalMs * 0.001) << " seconds.\n"
+        << "    min:    " << frameTimes.front() << " ms\n"
+        << "    median: " << frameTimes[frameTimes.size() / 2] << " ms\n"
+        << "    p99:    " << frameTimes[(frameTimes.size() * 99) / 100] << " ms\n"
+        << "    max:    " << frameTimes.back() << " ms\n"
+        << "    mean:   " << (totalMs / (double)numFrames) << " ms ("
+        << (1000.0 * (double)numFrames / totalMs) << " fps)" << std::endl;
+
+    const SL_PipelineStatistics& stats = query.result;
+    std::cout
+        << "Pipeline statistics:\n"
+        << "    vertices shaded:     " << stats.verticesShaded << '\n'
+        << "    prims submitted:     " << stats.primsSubmitted << '\n'
+        << "    prims culled:        " << stats.primsCulledBackface << " backface, "
+                                      << stats.primsCulledFrustum << " frustum, "
+                                      << stats.primsCulledZeroArea << " zero-area\n"
+        << "    prims clipped:       " << stats.primsClipped << " (" << stats.clipOutputPrims << " output)\n"
+        << "    bins flushed:        " << stats.binsFlushed << " (" << stats.binOverflows << " overflows)\n"
+        << "    frags rasterized:    " << stats.fragsRasterized << '\n'
+        << "    frags depth-failed:  " << stats.fragsDepthFailed << '\n'
+        << "    frags shaded:        " << stats.fragsShaded << " (" << stats.fragsDiscarded << " discarded)\n"
+        << "    pixels written:      " << stats.pixelsWritten << std::endl;
+
+    pRenderBuf->terminate();
+
+    return pWindow->destroy();
+}
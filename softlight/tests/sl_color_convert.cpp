@@ -1,6 +1,9 @@
 
 
+#include <cmath> // std::fabs()
+#include <cstdint>
 #include <iostream>
+#include <vector>
 
 #include "lightsky/math/half.h"
 #include "softlight/SL_Color.hpp"
@@ -39,6 +42,240 @@ void run_tests() noexcept
 
 
 
+/*-----------------------------------------------------------------------------
+ * Batch conversion checks
+ *
+ * Every batch function is compared against its per-color equivalent. Counts
+ * cover the empty span, each SIMD width, and odd sizes which finish in the
+ * scalar loop. One extra color past the end of each output span must remain
+ * untouched.
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+constexpr size_t MAX_TEST_COLORS = 37;
+
+unsigned gNumErrors = 0;
+
+
+
+/*-------------------------------------
+ * Deterministic test values
+-------------------------------------*/
+uint32_t gRandState = 0x2545F491u;
+
+// Values which scale to exactly k+0.5 for an even k. Rounding half up gives
+// k+1, while rounding to the nearest even integer would give k.
+const float TEST_HALFWAY_VALUES[] = {
+    0.00196078443f,
+    0.00980392192f,
+    0.0176470596f,
+    0.0254901964f,
+    0.0333333351f
+};
+
+constexpr size_t TEST_NUM_HALFWAY_VALUES = sizeof(TEST_HALFWAY_VALUES) / sizeof(TEST_HALFWAY_VALUES[0]);
+
+float next_float(float minVal, float maxVal) noexcept
+{
+    gRandState = gRandState * 1664525u + 1013904223u;
+    return minVal + (maxVal - minVal) * ((float)(gRandState >> 8u) * (1.f / 16777216.f));
+}
+
+
+
+/*-------------------------------------
+ * Report a mismatch
+-------------------------------------*/
+void check(bool passed, const char* name, size_t count, size_t index) noexcept
+{
+    if (!passed)
+    {
+        std::cerr << "Mismatch in " << name << " (count " << count << ", index " << index << ')' << std::endl;
+        ++gNumErrors;
+    }
+}
+
+
+
+inline bool near_value(float a, float b, float epsilon) noexcept
+{
+    return std::fabs(a - b) <= epsilon;
+}
+
+
+
+// Hues of 0 and 360 degrees are equivalent
+inline bool near_hue(float a, float b) noexcept
+{
+    const float d = std::fabs(a - b);
+    return d <= 1.e-2f || std::fabs(d - 360.f) <= 1.e-2f;
+}
+
+
+
+/*-------------------------------------
+ * 8-bit <-> float
+-------------------------------------*/
+void test_u8_float(size_t count) noexcept
+{
+    const size_t numElements = count * 4u;
+    std::vector<uint8_t> bytes(numElements + 1u);
+    std::vector<float> floats(numElements + 1u);
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        bytes[i] = (uint8_t)(i * 37u + count);
+    }
+
+    floats[numElements] = -1.f;
+    sl_convert_u8_to_float(bytes.data(), floats.data(), numElements);
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        const float expected = color_cast<float, uint8_t>(SL_ColorRType<uint8_t>{bytes[i]}).r;
+        check(near_value(floats[i], expected, 1.e-6f), "sl_convert_u8_to_float", count, i);
+    }
+    check(floats[numElements] == -1.f, "sl_convert_u8_to_float (overrun)", count, numElements);
+
+    // Mix in out-of-range and halfway values so the SIMD and scalar loops
+    // are both checked for clamping and rounding.
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        floats[i] = (i % 3u) ? next_float(-0.25f, 1.25f) : TEST_HALFWAY_VALUES[(i / 3u) % TEST_NUM_HALFWAY_VALUES];
+    }
+
+    bytes[numElements] = 0xA5u;
+    sl_convert_float_to_u8(floats.data(), bytes.data(), numElements);
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        // color_cast() truncates while the batch conversion rounds half up
+        const unsigned expected = (unsigned)(ls::math::clamp(floats[i], 0.f, 1.f) * 255.f + 0.5f);
+        check(bytes[i] == expected, "sl_convert_float_to_u8", count, i);
+    }
+    check(bytes[numElements] == 0xA5u, "sl_convert_float_to_u8 (overrun)", count, numElements);
+}
+
+
+
+/*-------------------------------------
+ * Adding and dropping alpha
+-------------------------------------*/
+void test_channels(size_t count) noexcept
+{
+    std::vector<SL_ColorRGB8> rgb8(count + 1u);
+    std::vector<SL_ColorRGBA8> rgba8(count + 1u);
+    std::vector<SL_ColorRGBf> rgbf(count + 1u);
+    std::vector<SL_ColorRGBAf> rgbaf(count + 1u);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        rgb8[i] = SL_ColorRGB8{(uint8_t)(i * 3u), (uint8_t)(i * 3u + 1u), (uint8_t)(i * 3u + 2u)};
+        rgbf[i] = SL_ColorRGBf{next_float(0.f, 1.f), next_float(0.f, 1.f), next_float(0.f, 1.f)};
+    }
+
+    rgba8[count] = SL_ColorRGBA8{1, 2, 3, 4};
+    rgbaf[count] = SL_ColorRGBAf{-1.f, -2.f, -3.f, -4.f};
+    sl_convert_rgb_to_rgba(rgb8.data(), rgba8.data(), count, 200u);
+    sl_convert_rgb_to_rgba(rgbf.data(), rgbaf.data(), count, 0.5f);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        check(rgba8[i] == SL_ColorRGBA8{rgb8[i][0], rgb8[i][1], rgb8[i][2], 200u}, "sl_convert_rgb_to_rgba (8-bit)", count, i);
+        check(rgbaf[i] == SL_ColorRGBAf{rgbf[i][0], rgbf[i][1], rgbf[i][2], 0.5f}, "sl_convert_rgb_to_rgba (float)", count, i);
+    }
+    check(rgba8[count] == SL_ColorRGBA8{1, 2, 3, 4}, "sl_convert_rgb_to_rgba (8-bit overrun)", count, count);
+    check(rgbaf[count] == SL_ColorRGBAf{-1.f, -2.f, -3.f, -4.f}, "sl_convert_rgb_to_rgba (float overrun)", count, count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        rgba8[i][3] = (uint8_t)i;
+        rgbaf[i][3] = next_float(0.f, 1.f);
+        rgb8[i] = SL_ColorRGB8{0, 0, 0};
+        rgbf[i] = SL_ColorRGBf{0.f, 0.f, 0.f};
+    }
+
+    rgb8[count] = SL_ColorRGB8{1, 2, 3};
+    rgbf[count] = SL_ColorRGBf{-1.f, -2.f, -3.f};
+    sl_convert_rgba_to_rgb(rgba8.data(), rgb8.data(), count);
+    sl_convert_rgba_to_rgb(rgbaf.data(), rgbf.data(), count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        check(rgb8[i] == SL_ColorRGB8{rgba8[i][0], rgba8[i][1], rgba8[i][2]}, "sl_convert_rgba_to_rgb (8-bit)", count, i);
+        check(rgbf[i] == SL_ColorRGBf{rgbaf[i][0], rgbaf[i][1], rgbaf[i][2]}, "sl_convert_rgba_to_rgb (float)", count, i);
+    }
+    check(rgb8[count] == SL_ColorRGB8{1, 2, 3}, "sl_convert_rgba_to_rgb (8-bit overrun)", count, count);
+    check(rgbf[count] == SL_ColorRGBf{-1.f, -2.f, -3.f}, "sl_convert_rgba_to_rgb (float overrun)", count, count);
+}
+
+
+
+/*-------------------------------------
+ * RGB <-> HSV/HSL
+ *
+ * hsv_cast() and hsl_cast() expect RGB channels in the range [-1, 1].
+-------------------------------------*/
+void test_hsv_hsl(size_t count) noexcept
+{
+    std::vector<SL_ColorRGBf> rgb(count + 1u);
+    std::vector<SL_ColorRGBf> outRgb(count + 1u);
+    std::vector<SL_ColorTypeHSVf> hsv(count + 1u);
+    std::vector<SL_ColorTypeHSLf> hsl(count + 1u);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        rgb[i] = SL_ColorRGBf{next_float(0.05f, 0.95f), next_float(0.05f, 0.95f), next_float(0.05f, 0.95f)};
+    }
+
+    hsv[count] = SL_ColorTypeHSVf{-1.f, -1.f, -1.f};
+    hsl[count] = SL_ColorTypeHSLf{-1.f, -1.f, -1.f};
+    sl_convert_rgb_to_hsv(rgb.data(), hsv.data(), count);
+    sl_convert_rgb_to_hsl(rgb.data(), hsl.data(), count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const SL_ColorRGBf c = SL_ColorRGBf{2.f*rgb[i][0] - 1.f, 2.f*rgb[i][1] - 1.f, 2.f*rgb[i][2] - 1.f};
+        const SL_ColorTypeHSVf expectedHsv = hsv_cast<float>(c);
+        const SL_ColorTypeHSLf expectedHsl = hsl_cast<float>(c);
+
+        check(near_hue(hsv[i].h, expectedHsv.h) && near_value(hsv[i].s, expectedHsv.s, 1.e-4f) && near_value(hsv[i].v, expectedHsv.v, 1.e-4f), "sl_convert_rgb_to_hsv", count, i);
+        check(near_hue(hsl[i].h, expectedHsl.h) && near_value(hsl[i].s, expectedHsl.s, 1.e-4f) && near_value(hsl[i].l, expectedHsl.l, 1.e-4f), "sl_convert_rgb_to_hsl", count, i);
+    }
+    check(hsv[count].h == -1.f && hsv[count].s == -1.f && hsv[count].v == -1.f, "sl_convert_rgb_to_hsv (overrun)", count, count);
+    check(hsl[count].h == -1.f && hsl[count].s == -1.f && hsl[count].l == -1.f, "sl_convert_rgb_to_hsl (overrun)", count, count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        hsv[i] = SL_ColorTypeHSVf{next_float(0.f, 360.f), next_float(0.f, 1.f), next_float(0.f, 1.f)};
+        hsl[i] = SL_ColorTypeHSLf{next_float(0.f, 360.f), next_float(0.f, 1.f), next_float(0.f, 1.f)};
+    }
+
+    outRgb[count] = SL_ColorRGBf{-1.f, -1.f, -1.f};
+    sl_convert_hsv_to_rgb(hsv.data(), outRgb.data(), count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const SL_ColorRGBf expected = rgb_cast<float>(hsv[i]);
+        check(near_value(outRgb[i][0], expected[0], 1.e-4f) && near_value(outRgb[i][1], expected[1], 1.e-4f) && near_value(outRgb[i][2], expected[2], 1.e-4f), "sl_convert_hsv_to_rgb", count, i);
+    }
+    check(outRgb[count] == SL_ColorRGBf{-1.f, -1.f, -1.f}, "sl_convert_hsv_to_rgb (overrun)", count, count);
+
+    sl_convert_hsl_to_rgb(hsl.data(), outRgb.data(), count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const SL_ColorRGBf expected = rgb_cast<float>(hsl[i]);
+        check(near_value(outRgb[i][0], expected[0], 1.e-4f) && near_value(outRgb[i][1], expected[1], 1.e-4f) && near_value(outRgb[i][2], expected[2], 1.e-4f), "sl_convert_hsl_to_rgb", count, i);
+    }
+    check(outRgb[count] == SL_ColorRGBf{-1.f, -1.f, -1.f}, "sl_convert_hsl_to_rgb (overrun)", count, count);
+}
+
+} // end anonymous namespace
+
+
+
 /*-----------------------------------------------------------------------------
  * Main (for testing only)
  *
@@ -50,6 +287,15 @@ int main()
     run_tests<float>();
     run_tests<double>();
 
-    return 0;
+    for (size_t count = 0; count <= MAX_TEST_COLORS; ++count)
+    {
+        test_u8_float(count);
+        test_channels(count);
+        test_hsv_hsl(count);
+    }
+
+    std::cout << "Batch conversion mismatches: " << gNumErrors << std::endl;
+
+    return gNumErrors ? -1 : 0;
 }
 
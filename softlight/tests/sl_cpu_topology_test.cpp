@@ -0,0 +1,132 @@
+
+#include <cstdint>
+#include <iostream>
+
+#include "softlight/SL_CpuTopology.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Test Topology
+ *
+ * Two NUMA nodes, each with one package of two cores and two hardware
+ * threads per core. CPUs are numbered the way Linux enumerates them, with
+ * the first hardware thread of every core listed before any SMT sibling.
+ * Entries are shuffled so placement cannot depend on their order.
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+const SL_CpuInfo TEST_CPUS[] = {
+    // cpuId, coreId, packageId, numaNode, smtIndex
+    {5, 1, 0, 0, 1},
+    {2, 0, 1, 1, 0},
+    {0, 0, 0, 0, 0},
+    {7, 1, 1, 1, 1},
+    {3, 1, 1, 1, 0},
+    {4, 0, 0, 0, 1},
+    {6, 0, 1, 1, 1},
+    {1, 1, 0, 0, 0}
+};
+
+constexpr unsigned TEST_NUM_CPUS = sizeof(TEST_CPUS) / sizeof(TEST_CPUS[0]);
+
+// Every core of every node before any SMT sibling
+const uint16_t TEST_CORES_ORDER[TEST_NUM_CPUS] = {0, 1, 2, 3, 4, 5, 6, 7};
+
+// Both hardware threads of a core before moving to the next core
+const uint16_t TEST_SMT_ORDER[TEST_NUM_CPUS] = {0, 4, 1, 5, 2, 6, 3, 7};
+
+// Alternate nodes one core at a time
+const uint16_t TEST_NODES_ORDER[TEST_NUM_CPUS] = {0, 2, 1, 3, 4, 6, 5, 7};
+
+unsigned gNumErrors = 0;
+
+
+
+/*-------------------------------------
+ * Compare a placement against its expected CPU order
+-------------------------------------*/
+void _sl_check_placement(const SL_CpuTopology& topology, SL_ThreadPlacement placement, const uint16_t* pExpected, unsigned numThreads) noexcept
+{
+    uint16_t cpuIds[TEST_NUM_CPUS * 2];
+
+    const unsigned numPlaced = topology.placement(placement, numThreads, cpuIds);
+    if (numPlaced != numThreads)
+    {
+        std::cerr
+            << "Placement \"" << sl_thread_placement_name(placement) << "\" assigned " << numPlaced
+            << " of " << numThreads << " threads." << std::endl;
+        ++gNumErrors;
+        return;
+    }
+
+    // CPUs are reused in the same order once each has a thread
+    for (unsigned i = 0; i < numThreads; ++i)
+    {
+        const uint16_t expected = pExpected[i % TEST_NUM_CPUS];
+
+        if (cpuIds[i] != expected)
+        {
+            std::cerr
+                << "Placement \"" << sl_thread_placement_name(placement) << "\": thread " << i
+                << " expected CPU " << expected << " but got " << cpuIds[i] << '.' << std::endl;
+            ++gNumErrors;
+            return;
+        }
+    }
+}
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Main
+-----------------------------------------------------------------------------*/
+int main()
+{
+    const SL_CpuTopology topology{TEST_CPUS, TEST_NUM_CPUS};
+
+    if (topology.num_cpus() != TEST_NUM_CPUS
+    || topology.num_cores() != 4
+    || topology.num_packages() != 2
+    || topology.num_nodes() != 2)
+    {
+        std::cerr
+            << "Unexpected topology: " << topology.num_cpus() << " CPUs, " << topology.num_cores()
+            << " cores, " << topology.num_packages() << " packages, " << topology.num_nodes()
+            << " nodes." << std::endl;
+        return -1;
+    }
+
+    _sl_check_placement(topology, SL_THREAD_PLACEMENT_CORES, TEST_CORES_ORDER, 3);
+    _sl_check_placement(topology, SL_THREAD_PLACEMENT_CORES, TEST_CORES_ORDER, TEST_NUM_CPUS);
+    _sl_check_placement(topology, SL_THREAD_PLACEMENT_CORES, TEST_CORES_ORDER, TEST_NUM_CPUS*2);
+
+    _sl_check_placement(topology, SL_THREAD_PLACEMENT_SMT, TEST_SMT_ORDER, 3);
+    _sl_check_placement(topology, SL_THREAD_PLACEMENT_SMT, TEST_SMT_ORDER, TEST_NUM_CPUS);
+    _sl_check_placement(topology, SL_THREAD_PLACEMENT_SMT, TEST_SMT_ORDER, TEST_NUM_CPUS*2);
+
+    _sl_check_placement(topology, SL_THREAD_PLACEMENT_NODES, TEST_NODES_ORDER, 3);
+    _sl_check_placement(topology, SL_THREAD_PLACEMENT_NODES, TEST_NODES_ORDER, TEST_NUM_CPUS);
+    _sl_check_placement(topology, SL_THREAD_PLACEMENT_NODES, TEST_NODES_ORDER, TEST_NUM_CPUS*2);
+
+    // Threads without a placement are left to the OS
+    uint16_t cpuId = 0;
+    if (topology.placement(SL_THREAD_PLACEMENT_NONE, 1, &cpuId) != 0)
+    {
+        std::cerr << "Threads should not be placed without a placement." << std::endl;
+        ++gNumErrors;
+    }
+
+    if (gNumErrors)
+    {
+        std::cerr << "CPU topology test failed with " << gNumErrors << " errors." << std::endl;
+        return -2;
+    }
+
+    std::cout << "CPU topology test passed." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+
+#include <cstdint>
+#include <iostream>
+
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_DamageRegion.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Damage Region Checks
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+enum : int32_t
+{
+    TEST_FBO_SIZE = 64
+};
+
+unsigned gNumErrors = 0;
+
+
+
+/*-------------------------------------
+ * Report a mismatched value
+-------------------------------------*/
+void _sl_expect(const char* pName, uint64_t expected, uint64_t actual) noexcept
+{
+    if (expected != actual)
+    {
+        std::cerr << pName << ": expected " << expected << " but got " << actual << '.' << std::endl;
+        ++gNumErrors;
+    }
+}
+
+
+
+/*-------------------------------------
+ * Search for a rectangle, as merging does not preserve their order
+-------------------------------------*/
+void _sl_expect_rect(const char* pName, const SL_DamageRegion& region, const math::vec4_t<int32_t>& r) noexcept
+{
+    for (unsigned i = 0; i < region.num_rects(); ++i)
+    {
+        const math::vec4_t<int32_t>& test = region.rect(i);
+
+        if (test[0] == r[0] && test[1] == r[1] && test[2] == r[2] && test[3] == r[3])
+        {
+            return;
+        }
+    }
+
+    std::cerr << pName << ": missing rectangle {" << r[0] << ", " << r[1] << ", " << r[2] << ", " << r[3] << "}." << std::endl;
+    ++gNumErrors;
+}
+
+
+
+/*-------------------------------------
+ * Overlapping and adjacent rectangles are merged
+-------------------------------------*/
+void _sl_check_merging() noexcept
+{
+    SL_DamageRegion region;
+
+    // Empty rectangles are ignored
+    region.add(0, 0, 0, 10);
+    region.add(0, 0, 10, -1);
+    _sl_expect("Empty rectangle count", 0, region.num_rects());
+
+    // Half of each rectangle overlaps the other
+    region.add(0, 0, 10, 10);
+    region.add(5, 0, 10, 10);
+    _sl_expect("Overlapping rectangle count", 1, region.num_rects());
+    _sl_expect_rect("Overlapping rectangles", region, math::vec4_t<int32_t>{0, 0, 15, 10});
+
+    // Contained rectangles add nothing
+    region.add(2, 2, 3, 3);
+    _sl_expect("Contained rectangle count", 1, region.num_rects());
+    _sl_expect_rect("Contained rectangle", region, math::vec4_t<int32_t>{0, 0, 15, 10});
+
+    // Adjacent rectangles of the same height waste no pixels
+    region.add(15, 0, 5, 10);
+    _sl_expect("Adjacent rectangle count", 1, region.num_rects());
+    _sl_expect_rect("Adjacent rectangles", region, math::vec4_t<int32_t>{0, 0, 20, 10});
+
+    // Distant rectangles remain separate
+    region.add(50, 50, 4, 4);
+    _sl_expect("Distant rectangle count", 2, region.num_rects());
+    _sl_expect("Distant rectangle area", 20*10 + 4*4, region.area());
+
+    // A merged rectangle absorbs any others it now overlaps
+    region.clear();
+    region.add(0, 0, 4, 4);
+    region.add(8, 0, 4, 4);
+    _sl_expect("Separated rectangle count", 2, region.num_rects());
+
+    region.add(4, 0, 4, 4);
+    _sl_expect("Bridged rectangle count", 1, region.num_rects());
+    _sl_expect_rect("Bridged rectangles", region, math::vec4_t<int32_t>{0, 0, 12, 4});
+
+    // Regions merge the same way as rectangles
+    SL_DamageRegion other;
+    other.add(10, 0, 6, 4);
+    other.add(40, 40, 2, 2);
+
+    region.add(other);
+    region.add(region);
+    _sl_expect("Merged region count", 2, region.num_rects());
+    _sl_expect_rect("Merged region", region, math::vec4_t<int32_t>{0, 0, 16, 4});
+    _sl_expect_rect("Merged region", region, math::vec4_t<int32_t>{40, 40, 2, 2});
+}
+
+
+
+/*-------------------------------------
+ * Rectangles are coalesced once the limit is reached
+-------------------------------------*/
+void _sl_check_coalescing() noexcept
+{
+    SL_DamageRegion region;
+
+    // Single pixels along a row, too far apart to merge
+    for (int32_t i = 0; i < (int32_t)SL_DAMAGE_MAX_RECTS; ++i)
+    {
+        region.add(i*4, 0, 1, 1);
+    }
+
+    _sl_expect("Rectangles before the limit", SL_DAMAGE_MAX_RECTS, region.num_rects());
+
+    // The new pixel joins its nearest neighbor
+    const int32_t last = (int32_t)SL_DAMAGE_MAX_RECTS * 4;
+    region.add(last, 0, 1, 1);
+
+    _sl_expect("Rectangles at the limit", SL_DAMAGE_MAX_RECTS, region.num_rects());
+    _sl_expect_rect("Coalesced rectangle", region, math::vec4_t<int32_t>{last-4, 0, 5, 1});
+
+    // Every damaged pixel remains covered no matter how many are added
+    for (int32_t y = 0; y < TEST_FBO_SIZE; y += 3)
+    {
+        for (int32_t x = (y % 2); x < TEST_FBO_SIZE; x += 7)
+        {
+            region.add(x, y, 1, 1);
+
+            if (region.num_rects() > SL_DAMAGE_MAX_RECTS)
+            {
+                std::cerr << "Damage region exceeded " << SL_DAMAGE_MAX_RECTS << " rectangles." << std::endl;
+                ++gNumErrors;
+                return;
+            }
+        }
+    }
+
+    for (int32_t i = 0; i <= (int32_t)SL_DAMAGE_MAX_RECTS; ++i)
+    {
+        if (!region.contains(i*4, 0))
+        {
+            std::cerr << "Coalescing lost the pixel at (" << (i*4) << ", 0)." << std::endl;
+            ++gNumErrors;
+        }
+    }
+
+    for (int32_t y = 0; y < TEST_FBO_SIZE; y += 3)
+    {
+        for (int32_t x = (y % 2); x < TEST_FBO_SIZE; x += 7)
+        {
+            if (!region.contains(x, y))
+            {
+                std::cerr << "Coalescing lost the pixel at (" << x << ", " << y << ")." << std::endl;
+                ++gNumErrors;
+                return;
+            }
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Rectangles are clipped to the framebuffer bounds
+-------------------------------------*/
+void _sl_check_clipping() noexcept
+{
+    SL_DamageRegion region;
+
+    region.add(-5, -5, 10, 10);
+    region.add(TEST_FBO_SIZE-4, TEST_FBO_SIZE-4, 10, 10);
+    region.add(TEST_FBO_SIZE+10, 0, 5, 5);
+    region.add(0, -20, 5, 5);
+    region.add(20, 20, 8, 8);
+    _sl_expect("Unclipped rectangle count", 5, region.num_rects());
+
+    region.clip(TEST_FBO_SIZE, TEST_FBO_SIZE);
+    _sl_expect("Clipped rectangle count", 3, region.num_rects());
+    _sl_expect_rect("Clipped top-left rectangle", region, math::vec4_t<int32_t>{0, 0, 5, 5});
+    _sl_expect_rect("Clipped bottom-right rectangle", region, math::vec4_t<int32_t>{TEST_FBO_SIZE-4, TEST_FBO_SIZE-4, 4, 4});
+    _sl_expect_rect("Unclipped rectangle", region, math::vec4_t<int32_t>{20, 20, 8, 8});
+    _sl_expect("Clipped area", 5*5 + 4*4 + 8*8, region.area());
+
+    const math::vec4_t<int32_t>&& bounds = region.bounds();
+    _sl_expect("Clipped bounds x", 0, bounds[0]);
+    _sl_expect("Clipped bounds y", 0, bounds[1]);
+    _sl_expect("Clipped bounds width", TEST_FBO_SIZE, bounds[2]);
+    _sl_expect("Clipped bounds height", TEST_FBO_SIZE, bounds[3]);
+
+    // Clipping to an empty framebuffer removes everything
+    region.clip(0, 0);
+    _sl_expect("Rectangles clipped to nothing", 0, region.num_rects());
+
+    if (!region.empty())
+    {
+        std::cerr << "A region clipped to nothing should be empty." << std::endl;
+        ++gNumErrors;
+    }
+}
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Main
+-----------------------------------------------------------------------------*/
+int main()
+{
+    _sl_check_merging();
+    _sl_check_coalescing();
+    _sl_check_clipping();
+
+    if (gNumErrors)
+    {
+        std::cerr << "Damage region test failed with " << gNumErrors << " errors." << std::endl;
+        return -1;
+    }
+
+    std::cout << "Damage region test passed." << std::endl;
+
+    return 0;
+}
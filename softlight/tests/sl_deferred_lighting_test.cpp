@@ -0,0 +1,451 @@
+// Tiled deferred lighting example with many point lights.
+
+#include <thread>
+
+#include "lightsky/math/vec_utils.h"
+#include "lightsky/math/mat_utils.h"
+
+#include "lightsky/utils/Log.h"
+#include "lightsky/utils/StringUtils.h"
+#include "lightsky/utils/Time.hpp"
+#include "lightsky/utils/Tuple.h"
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_KeySym.hpp"
+#include "softlight/SL_LightProcessor.hpp"
+#include "softlight/SL_Material.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_RenderWindow.hpp"
+#include "softlight/SL_Sampler.hpp"
+#include "softlight/SL_SceneFileLoader.hpp"
+#include "softlight/SL_Shader.hpp"
+#include "softlight/SL_Texture.hpp"
+#include "softlight/SL_Transform.hpp"
+#include "softlight/SL_UniformBuffer.hpp"
+#include "softlight/SL_VertexArray.hpp"
+#include "softlight/SL_VertexBuffer.hpp"
+#include "softlight/SL_WindowBuffer.hpp"
+#include "softlight/SL_WindowEvent.hpp"
+
+namespace math = ls::math;
+namespace utils = ls::utils;
+
+
+
+#ifndef IMAGE_WIDTH
+    #define IMAGE_WIDTH 1280
+#endif /* IMAGE_WIDTH */
+
+#ifndef IMAGE_HEIGHT
+    #define IMAGE_HEIGHT 720
+#endif /* IMAGE_HEIGHT */
+
+#ifndef SL_TEST_MAX_THREADS
+    #define SL_TEST_MAX_THREADS (ls::math::max<unsigned>(std::thread::hardware_concurrency(), 2u) - 1u)
+#endif /* SL_TEST_MAX_THREADS */
+
+#ifndef SL_TEST_NUM_LIGHTS
+    #define SL_TEST_NUM_LIGHTS 512
+#endif /* SL_TEST_NUM_LIGHTS */
+
+#ifndef SL_BENCHMARK_SCENE
+    #define SL_BENCHMARK_SCENE 0
+#endif /* SL_BENCHMARK_SCENE */
+
+enum : size_t
+{
+    GBUFFER_FBO_ID  = 0,
+    DEPTH_TEX_ID    = 0,
+    ALBEDO_TEX_ID   = 1,
+    NORMAL_TEX_ID   = 2,
+    POSITION_TEX_ID = 3,
+    LIT_TEX_ID      = 4
+};
+
+
+
+/*-----------------------------------------------------------------------------
+ * Shader to write view-space data into a G-Buffer
+-----------------------------------------------------------------------------*/
+struct GBufferUniforms
+{
+    math::mat4        mvMatrix;
+    math::mat4        mvpMatrix;
+    const SL_Texture* pTexture;
+};
+
+
+
+/*--------------------------------------
+ * Vertex Shader
+--------------------------------------*/
+math::vec4 _gbuffer_vert_shader(SL_VertexParam& param)
+{
+    typedef utils::Tuple<math::vec3, math::vec2, math::vec3> Vertex;
+    const GBufferUniforms* pUniforms = param.pUniforms->as<GBufferUniforms>();
+    const Vertex*          v         = param.pVbo->element<const Vertex>(param.pVao->offset(0, param.vertId));
+    const math::vec4&&     vert      = math::vec4_cast(v->const_element<0>(), 1.f);
+    const math::vec4&&     uv        = math::vec4_cast(v->const_element<1>(), 0.f, 0.f);
+    const math::vec4&&     norm      = math::vec4_cast(v->const_element<2>(), 0.f);
+
+    param.pVaryings[0] = pUniforms->mvMatrix * vert;
+    param.pVaryings[1] = uv;
+    param.pVaryings[2] = pUniforms->mvMatrix * norm;
+
+    return pUniforms->mvpMatrix * vert;
+}
+
+
+
+SL_VertexShader gbuffer_vert_shader()
+{
+    SL_VertexShader shader;
+    shader.numVaryings = 3;
+    shader.cullMode    = SL_CULL_BACK_FACE;
+    shader.shader      = _gbuffer_vert_shader;
+
+    return shader;
+}
+
+
+
+/*--------------------------------------
+ * Fragment Shader
+--------------------------------------*/
+bool _gbuffer_frag_shader(SL_FragmentParam& fragParams)
+{
+    const GBufferUniforms*  pUniforms = fragParams.pUniforms->as<GBufferUniforms>();
+    const SL_Texture*       albedo    = pUniforms->pTexture;
+    const math::vec4&       pos       = fragParams.pVaryings[0];
+    const math::vec4&       uv        = fragParams.pVaryings[1];
+    const math::vec4&&      norm      = math::normalize(fragParams.pVaryings[2]);
+    math::vec3_t<uint8_t>&& pixel8    = sl_sample_nearest<SL_ColorRGB8, SL_WrapMode::EDGE>(*albedo, uv[0], uv[1]);
+
+    fragParams.pOutputs[SL_GBUFFER_ALBEDO]   = color_cast<float, uint8_t>(math::vec4_cast<uint8_t>(pixel8, 255));
+    fragParams.pOutputs[SL_GBUFFER_NORMAL]   = norm;
+    fragParams.pOutputs[SL_GBUFFER_POSITION] = math::vec4{pos[0], pos[1], pos[2], 1.f};
+
+    return true;
+}
+
+
+
+SL_FragmentShader gbuffer_frag_shader()
+{
+    SL_FragmentShader shader;
+    shader.numVaryings = 3;
+    shader.numOutputs  = 3;
+    shader.blend       = SL_BLEND_OFF;
+    shader.depthTest   = SL_DEPTH_TEST_GREATER_EQUAL;
+    shader.depthMask   = SL_DEPTH_MASK_ON;
+    shader.shader      = _gbuffer_frag_shader;
+
+    return shader;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Create the context for a demo scene
+-----------------------------------------------------------------------------*/
+utils::Pointer<SL_SceneGraph> deferred_test_create_context()
+{
+    int retCode = 0;
+
+    SL_SceneFileLoader meshLoader;
+    utils::Pointer<SL_SceneGraph> pGraph{new SL_SceneGraph{}};
+    SL_Context& context = pGraph->mContext;
+
+    size_t depthId  = context.create_texture();
+    size_t albedoId = context.create_texture();
+    size_t normId   = context.create_texture();
+    size_t posId    = context.create_texture();
+    size_t litId    = context.create_texture();
+    size_t fboId    = context.create_framebuffer();
+
+    retCode = context.texture(depthId).init(SL_ColorDataType::SL_COLOR_R_16U, IMAGE_WIDTH, IMAGE_HEIGHT, 1);
+    assert(retCode == 0);
+
+    retCode = context.texture(albedoId).init(SL_ColorDataType::SL_COLOR_RGBA_8U, IMAGE_WIDTH, IMAGE_HEIGHT, 1);
+    assert(retCode == 0);
+
+    retCode = context.texture(normId).init(SL_ColorDataType::SL_COLOR_RGBA_FLOAT, IMAGE_WIDTH, IMAGE_HEIGHT, 1);
+    assert(retCode == 0);
+
+    retCode = context.texture(posId).init(SL_ColorDataType::SL_COLOR_RGBA_FLOAT, IMAGE_WIDTH, IMAGE_HEIGHT, 1);
+    assert(retCode == 0);
+
+    retCode = context.texture(litId).init(SL_ColorDataType::SL_COLOR_RGBA_8U, IMAGE_WIDTH, IMAGE_HEIGHT, 1);
+    assert(retCode == 0);
+
+    SL_Framebuffer& fbo = context.framebuffer(fboId);
+    retCode = fbo.reserve_color_buffers(3);
+    assert(retCode == 0);
+
+    retCode = fbo.attach_color_buffer(SL_GBUFFER_ALBEDO, context.texture(albedoId));
+    assert(retCode == 0);
+
+    retCode = fbo.attach_color_buffer(SL_GBUFFER_NORMAL, context.texture(normId));
+    assert(retCode == 0);
+
+    retCode = fbo.attach_color_buffer(SL_GBUFFER_POSITION, context.texture(posId));
+    assert(retCode == 0);
+
+    retCode = fbo.attach_depth_buffer(context.texture(depthId));
+    assert(retCode == 0);
+
+    retCode = fbo.valid();
+    assert(retCode == 0);
+
+    retCode = meshLoader.load("testdata/african_head/african_head.obj");
+    assert(retCode != 0);
+
+    retCode = (int)pGraph->import(meshLoader.data());
+    assert(retCode == 0);
+
+    // Always make sure the scene graph is updated before rendering
+    pGraph->mCurrentTransforms[1].move(math::vec3{0.f, 30.f, 0.f});
+    pGraph->mCurrentTransforms[1].scale(math::vec3{5.f});
+    pGraph->update();
+
+    size_t uboId = context.create_ubo();
+    GBufferUniforms* pUniforms = context.ubo(uboId).as<GBufferUniforms>();
+    pUniforms->mvMatrix = math::mat4{1.f};
+    pUniforms->mvpMatrix = math::mat4{1.f};
+
+    size_t testShaderId = context.create_shader(gbuffer_vert_shader(), gbuffer_frag_shader(), uboId);
+    assert(testShaderId == 0);
+    (void)testShaderId;
+
+    (void)retCode;
+
+    return pGraph;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Scatter lights around the scene
+-----------------------------------------------------------------------------*/
+void deferred_test_init_lights(SL_PointLight* pLights, size_t numLights)
+{
+    for (size_t i = 0; i < numLights; ++i)
+    {
+        const float t = (float)i / (float)numLights;
+        const float angle = t * LS_TWO_PI * 7.f;
+
+        pLights[i].position = math::vec4{
+            math::cos(angle) * (10.f + 30.f * t),
+            5.f + 50.f * t,
+            math::sin(angle) * (10.f + 30.f * t),
+            8.f
+        };
+
+        pLights[i].color = math::vec4{
+            0.5f + 0.5f * math::cos(angle),
+            0.5f + 0.5f * math::sin(angle * 0.5f),
+            0.5f + 0.5f * math::sin(angle),
+            1.f
+        };
+    }
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Render a scene into the G-Buffer
+-----------------------------------------------------------------------------*/
+void deferred_test_render(SL_SceneGraph* pGraph, const math::mat4& projectionMat, const math::mat4& viewMat)
+{
+    const math::mat4&& vpMatrix  = projectionMat * viewMat;
+    SL_Context&        context   = pGraph->mContext;
+    GBufferUniforms*   pUniforms = context.ubo(0).as<GBufferUniforms>();
+
+    for (size_t i = 1; i < pGraph->mNodes.size(); ++i)
+    {
+        SL_SceneNode& n = pGraph->mNodes[i];
+
+        // Only mesh nodes should be sent for rendering.
+        if (n.type != NODE_TYPE_MESH)
+        {
+            continue;
+        }
+
+        const math::mat4& modelMat = pGraph->mModelMatrices[n.nodeId];
+        const size_t numNodeMeshes = pGraph->mNumNodeMeshes[n.dataId];
+        const utils::Pointer<size_t[]>& meshIds = pGraph->mNodeMeshes[n.dataId];
+
+        pUniforms->mvMatrix  = viewMat * modelMat;
+        pUniforms->mvpMatrix = vpMatrix * modelMat;
+
+        for (size_t meshId = 0; meshId < numNodeMeshes; ++meshId)
+        {
+            const size_t       nodeMeshId = meshIds[meshId];
+            const SL_Mesh&     m          = pGraph->mMeshes[nodeMeshId];
+            const SL_Material& material   = pGraph->mMaterials[m.materialId];
+            pUniforms->pTexture = material.pTextures[SL_MATERIAL_TEXTURE_AMBIENT];
+
+            context.draw(m, 0, GBUFFER_FBO_ID);
+        }
+    }
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Render a scene
+-----------------------------------------------------------------------------*/
+int main()
+{
+    int retCode = 0;
+    (void)retCode;
+
+    utils::Pointer<SL_RenderWindow> pWindow{std::move(SL_RenderWindow::create())};
+    utils::Pointer<SL_WindowBuffer> pRenderBuf{SL_WindowBuffer::create()};
+    if (pWindow->init(IMAGE_WIDTH, IMAGE_HEIGHT))
+    {
+        LS_LOG_ERR("Unable to initialize a window.");
+        return -1;
+    }
+    else if (!pWindow->run())
+    {
+        LS_LOG_ERR("Unable to run the test window!");
+        pWindow->destroy();
+        return -2;
+    }
+    else if (pRenderBuf->init(*pWindow, pWindow->width(), pWindow->height()) != 0 || pWindow->set_title("Deferred Lighting Test") != 0)
+    {
+        LS_LOG_ERR("Unable to resize the test window buffer!");
+        pWindow->destroy();
+        return -3;
+    }
+
+    pWindow->set_keys_repeat(false); // text mode
+    pWindow->set_mouse_capture(false);
+
+    utils::Pointer<SL_SceneGraph>  pGraph{std::move(deferred_test_create_context())};
+    utils::Pointer<SL_PointLight[]> pLights{new SL_PointLight[SL_TEST_NUM_LIGHTS]};
+    utils::Pointer<SL_PointLight[]> pViewLights{new SL_PointLight[SL_TEST_NUM_LIGHTS]};
+    ls::utils::Clock<float>        timer;
+    SL_Transform                   viewMatrix;
+    SL_WindowEvent                 evt;
+    math::mat4         projMatrix     = math::infinite_perspective(LS_DEG2RAD(80.f), (float)pWindow->width()/(float)pWindow->height(), 0.01f);
+    const math::vec4   ambient        = math::vec4{0.05f, 0.05f, 0.05f, 1.f};
+    SL_Context&        context        = pGraph->mContext;
+    int                shouldQuit     = 0;
+    int                numFrames      = 0;
+    int                totalFrames    = 0;
+    float              secondsCounter = 0.f;
+    float              tickTime       = 0.f;
+
+    deferred_test_init_lights(pLights.get(), SL_TEST_NUM_LIGHTS);
+
+    viewMatrix.type(SL_TransformType::SL_TRANSFORM_TYPE_VIEW_ARC_LOCKED_Y);
+    viewMatrix.look_at(math::vec3{10.f, 30.f, 70.f}, math::vec3{0.f, 20.f, 0.f}, math::vec3{0.f, 1.f, 0.f});
+    viewMatrix.apply_transform();
+
+    timer.start();
+
+    context.num_threads(SL_TEST_MAX_THREADS);
+
+    while (!shouldQuit)
+    {
+        pWindow->update();
+
+        if (pWindow->has_event())
+        {
+            pWindow->pop_event(&evt);
+
+            if (evt.type == SL_WinEventType::WIN_EVENT_RESIZED)
+            {
+                std::cout<< "Window resized: " << evt.window.width << 'x' << evt.window.height << std::endl;
+                pRenderBuf->terminate();
+                pRenderBuf->init(*pWindow, pWindow->width(), pWindow->height());
+
+                for (size_t texId = DEPTH_TEX_ID; texId <= LIT_TEX_ID; ++texId)
+                {
+                    context.texture(texId).init(context.texture(texId).type(), (uint16_t)pWindow->width(), (uint16_t)pWindow->height());
+                }
+
+                projMatrix = math::infinite_perspective(LS_DEG2RAD(80.f), (float)pWindow->width()/(float)pWindow->height(), 0.01f);
+            }
+            else if (evt.type == SL_WinEventType::WIN_EVENT_KEY_UP)
+            {
+                const SL_KeySymbol keySym = evt.keyboard.keysym;
+                if (keySym == SL_KeySymbol::KEY_SYM_ESCAPE)
+                {
+                    LS_LOG_MSG("Escape button pressed. Exiting.");
+                    shouldQuit = true;
+                }
+            }
+            else if (evt.type == SL_WinEventType::WIN_EVENT_CLOSING)
+            {
+                LS_LOG_MSG("Window close event caught. Exiting.");
+                shouldQuit = true;
+            }
+        }
+        else
+        {
+            timer.tick();
+            tickTime = timer.tick_time().count();
+            secondsCounter += tickTime;
+
+            viewMatrix.rotate(math::vec3{-0.5f*tickTime, 0.f, 0.f});
+            viewMatrix.apply_transform();
+
+            const math::mat4& viewMat = viewMatrix.transform();
+            for (size_t i = 0; i < SL_TEST_NUM_LIGHTS; ++i)
+            {
+                const math::vec4& p = pLights[i].position;
+                const math::vec4&& viewPos = viewMat * math::vec4{p[0], p[1], p[2], 1.f};
+                pViewLights[i].position = math::vec4{viewPos[0], viewPos[1], viewPos[2], p[3]};
+                pViewLights[i].color = pLights[i].color;
+            }
+
+            constexpr std::array<size_t, 3> attachIds{SL_GBUFFER_ALBEDO, SL_GBUFFER_NORMAL, SL_GBUFFER_POSITION};
+            constexpr std::array<SL_ColorRGBAd, 3> colors{
+                SL_ColorRGBAd{0.0, 0.0, 0.0, 1.0},
+                SL_ColorRGBAd{0.0, 0.0, 0.0, 0.0},
+                SL_ColorRGBAd{0.0, 0.0, 0.0, 0.0}
+            };
+            context.clear_framebuffer(GBUFFER_FBO_ID, attachIds, colors, 0.0);
+
+            deferred_test_render(pGraph.get(), projMatrix, viewMat);
+
+            retCode = context.draw_lights(GBUFFER_FBO_ID, LIT_TEX_ID, pViewLights.get(), SL_TEST_NUM_LIGHTS, projMatrix, ambient);
+            assert(retCode == 0);
+
+            context.blit(*pRenderBuf, LIT_TEX_ID);
+            pWindow->render(*pRenderBuf);
+
+            ++numFrames;
+            ++totalFrames;
+
+            if (secondsCounter >= 1.f)
+            {
+                LS_LOG_MSG("FPS: ", utils::to_str((float)numFrames / secondsCounter));
+                numFrames = 0;
+                secondsCounter = 0.f;
+            }
+
+            #if SL_BENCHMARK_SCENE
+                if (totalFrames >= 3600)
+                {
+                    shouldQuit = true;
+                }
+            #endif
+        }
+
+        // All events handled. Now check on the state of the window.
+        if (pWindow->state() == WindowStateInfo::WINDOW_CLOSING)
+        {
+            LS_LOG_MSG("Window close state encountered. Exiting.");
+            shouldQuit = true;
+        }
+    }
+
+    pRenderBuf->terminate();
+    return pWindow->destroy();
+}
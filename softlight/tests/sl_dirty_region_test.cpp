@@ -0,0 +1,234 @@
+
+#include <iostream>
+
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_DamageRegion.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_Shader.hpp"
+#include "softlight/SL_Texture.hpp"
+#include "softlight/SL_VertexArray.hpp"
+#include "softlight/SL_VertexBuffer.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Test Constants
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+enum : uint16_t
+{
+    TEST_FBO_SIZE = 64
+};
+
+// Two rectangles in opposite corners of the framebuffer. Their bounding
+// rectangle covers the entire framebuffer.
+const math::vec4_t<int32_t> TEST_RECTS[2] = {
+    {0,  0,  8, 8},
+    {56, 56, 8, 8}
+};
+
+const SL_ColorRGBA8 TEST_BACKGROUND{0, 0, 255, 255};
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Shader to additively blend a full-screen triangle
+-----------------------------------------------------------------------------*/
+/*--------------------------------------
+ * Vertex Shader
+--------------------------------------*/
+math::vec4 _fullscreen_vert_shader_impl(SL_VertexParam& param)
+{
+    return *(param.pVbo->element<const math::vec4>(param.pVao->offset(0, param.vertId)));
+}
+
+
+
+SL_VertexShader fullscreen_vert_shader()
+{
+    SL_VertexShader shader;
+    shader.numVaryings = 0;
+    shader.cullMode = SL_CULL_OFF;
+    shader.shader = _fullscreen_vert_shader_impl;
+
+    return shader;
+}
+
+
+
+/*--------------------------------------
+ * Fragment Shader
+--------------------------------------*/
+bool _fullscreen_frag_shader_impl(SL_FragmentParam& fragParam)
+{
+    fragParam.pOutputs[0] = math::vec4{0.25f, 0.f, 0.f, 1.f};
+    return true;
+}
+
+
+
+SL_FragmentShader fullscreen_frag_shader()
+{
+    SL_FragmentShader shader;
+    shader.numVaryings = 0;
+    shader.numOutputs = 1;
+    shader.blend = SL_BLEND_ADDITIVE;
+    shader.depthMask = SL_DEPTH_MASK_OFF;
+    shader.depthTest = SL_DEPTH_TEST_OFF;
+    shader.shader = _fullscreen_frag_shader_impl;
+
+    return shader;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Test Functions
+-----------------------------------------------------------------------------*/
+/*--------------------------------------
+ * Determine if a pixel lies within one of the test rectangles
+--------------------------------------*/
+bool is_in_test_rects(int32_t x, int32_t y)
+{
+    for (const math::vec4_t<int32_t>& r : TEST_RECTS)
+    {
+        if (x >= r[0] && y >= r[1] && x < r[0]+r[2] && y < r[1]+r[3])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+/*--------------------------------------
+ * Main
+--------------------------------------*/
+int main()
+{
+    int retCode = 0;
+    SL_Context context;
+
+    context.num_threads(4);
+
+    const size_t fboId = context.create_framebuffer();
+    const size_t texId = context.create_texture();
+    const size_t depthId = context.create_texture();
+    const size_t vaoId = context.create_vao();
+    const size_t vboId = context.create_vbo();
+    const size_t shaderId = context.create_shader(fullscreen_vert_shader(), fullscreen_frag_shader());
+
+    const math::vec4 verts[3] = {
+        {-1.f, -1.f, 0.f, 1.f},
+        { 3.f, -1.f, 0.f, 1.f},
+        {-1.f,  3.f, 0.f, 1.f}
+    };
+
+    SL_VertexBuffer& vbo = context.vbo(vboId);
+    if (vbo.init(sizeof(verts)) != 0)
+    {
+        std::cerr << "Unable to initialize a VBO." << std::endl;
+        return -1;
+    }
+    vbo.assign(verts, 0, sizeof(verts));
+
+    SL_VertexArray& vao = context.vao(vaoId);
+    vao.set_vertex_buffer(vboId);
+    if (vao.set_num_bindings(1) != 1)
+    {
+        std::cerr << "Unable to set the number of VAO bindings." << std::endl;
+        return -2;
+    }
+    vao.set_binding(0, 0, sizeof(math::vec4), SL_Dimension::VERTEX_DIMENSION_4, SL_DataType::VERTEX_DATA_FLOAT);
+
+    SL_Texture& tex = context.texture(texId);
+    SL_Texture& depth = context.texture(depthId);
+    if (tex.init(SL_COLOR_RGBA_8U, TEST_FBO_SIZE, TEST_FBO_SIZE, 1) != 0
+    || depth.init(SL_COLOR_R_FLOAT, TEST_FBO_SIZE, TEST_FBO_SIZE, 1) != 0)
+    {
+        std::cerr << "Unable to initialize the framebuffer attachments." << std::endl;
+        return -3;
+    }
+
+    SL_Framebuffer& fbo = context.framebuffer(fboId);
+    if (fbo.reserve_color_buffers(1) != 0
+    || fbo.attach_color_buffer(0, tex) != 0
+    || fbo.attach_depth_buffer(depth) != 0)
+    {
+        std::cerr << "Unable to initialize a framebuffer." << std::endl;
+        return -4;
+    }
+
+    context.clear_framebuffer(fboId, 0, math::vec4_t<double>{0.0, 0.0, 1.0, 1.0}, 0.0);
+
+    SL_DamageRegion dirty;
+    dirty.add(TEST_RECTS[0]);
+    dirty.add(TEST_RECTS[1]);
+
+    if (dirty.num_rects() != 2)
+    {
+        std::cerr << "Distant rectangles should not be merged: " << dirty.num_rects() << std::endl;
+        return -5;
+    }
+
+    SL_Mesh m;
+    m.vaoId = vaoId;
+    m.elementBegin = 0;
+    m.elementEnd = 3;
+    m.mode = RENDER_MODE_TRIANGLES;
+    m.materialId = (uint32_t)-1;
+
+    context.set_dirty_region(dirty);
+    context.clear_color_buffer(fboId, 0, math::vec4_t<double>{0.0, 0.0, 0.0, 0.0});
+    context.draw(m, shaderId, fboId);
+    context.draw(m, shaderId, fboId);
+    context.clear_dirty_region();
+
+    unsigned numErrors = 0;
+
+    for (uint16_t y = 0; y < TEST_FBO_SIZE; ++y)
+    {
+        for (uint16_t x = 0; x < TEST_FBO_SIZE; ++x)
+        {
+            const SL_ColorRGBA8 c = tex.texel<SL_ColorRGBA8>(x, y);
+
+            if (is_in_test_rects(x, y))
+            {
+                if (c[0] == 0 || c[2] != 0)
+                {
+                    std::cerr << "Pixel (" << x << ", " << y << ") inside the dirty region was not redrawn." << std::endl;
+                    ++numErrors;
+                }
+            }
+            else if (c != TEST_BACKGROUND)
+            {
+                std::cerr << "Pixel (" << x << ", " << y << ") outside the dirty region was modified." << std::endl;
+                ++numErrors;
+            }
+        }
+    }
+
+    if (numErrors)
+    {
+        std::cerr << "Dirty region test failed with " << numErrors << " errors." << std::endl;
+        retCode = -6;
+    }
+    else
+    {
+        std::cout << "Dirty region test passed." << std::endl;
+    }
+
+    return retCode;
+}
@@ -0,0 +1,270 @@
+
+#include <cstdio> // std::remove()
+#include <iostream>
+
+#include "lightsky/math/vec3.h"
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_FrameCapture.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_IndexBuffer.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_Shader.hpp"
+#include "softlight/SL_Texture.hpp"
+#include "softlight/SL_UniformBuffer.hpp"
+#include "softlight/SL_VertexArray.hpp"
+#include "softlight/SL_VertexBuffer.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Test Constants
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+enum : uint16_t
+{
+    TEST_FBO_SIZE = 64,
+    TEST_NUM_INSTANCES = 2
+};
+
+constexpr const char* TEST_CAPTURE_FILE = "sl_frame_capture_test.slfc";
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Shader which transforms 3D positions by a scale and per-instance offset
+ * stored in its uniforms.
+-----------------------------------------------------------------------------*/
+/*--------------------------------------
+ * Vertex Shader
+--------------------------------------*/
+math::vec4 _capture_vert_shader_impl(SL_VertexParam& param)
+{
+    const math::vec4& transform = *param.pUniforms->as<math::vec4>();
+    const math::vec3& pos = *(param.pVbo->element<const math::vec3>(param.pVao->offset(0, param.vertId)));
+    const float offset = transform[2] * (float)param.instanceId;
+
+    param.pVaryings[0] = math::vec4{1.f};
+
+    return math::vec4{pos[0]*transform[0] + offset, pos[1]*transform[1], pos[2], 1.f};
+}
+
+
+
+SL_VertexShader capture_vert_shader()
+{
+    SL_VertexShader shader;
+    shader.numVaryings = 1;
+    shader.cullMode = SL_CULL_OFF;
+    shader.shader = _capture_vert_shader_impl;
+
+    return shader;
+}
+
+
+
+/*--------------------------------------
+ * Fragment Shader
+--------------------------------------*/
+bool _capture_frag_shader_impl(SL_FragmentParam& fragParam)
+{
+    // Matches the constant color of replays without application shaders
+    fragParam.pOutputs[0] = fragParam.pVaryings[0];
+    return true;
+}
+
+
+
+SL_FragmentShader capture_frag_shader()
+{
+    SL_FragmentShader shader;
+    shader.numVaryings = 1;
+    shader.numOutputs = 1;
+    shader.blend = SL_BLEND_OFF;
+    shader.depthMask = SL_DEPTH_MASK_OFF;
+    shader.depthTest = SL_DEPTH_TEST_OFF;
+    shader.shader = _capture_frag_shader_impl;
+
+    return shader;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Test Functions
+-----------------------------------------------------------------------------*/
+/*--------------------------------------
+ * Create a framebuffer and draw two instances of a scaled triangle while
+ * recording a capture.
+--------------------------------------*/
+int record_scene(SL_Context& context, SL_FrameCapture& capture)
+{
+    const size_t fboId = context.create_framebuffer();
+    const size_t texId = context.create_texture();
+    const size_t depthId = context.create_texture();
+    const size_t vaoId = context.create_vao();
+    const size_t vboId = context.create_vbo();
+    const size_t iboId = context.create_ibo();
+    const size_t uboId = context.create_ubo();
+    const size_t shaderId = context.create_shader(capture_vert_shader(), capture_frag_shader(), uboId);
+
+    const math::vec3 verts[4] = {
+        {-1.f, -1.f, 0.f},
+        { 1.f, -1.f, 0.f},
+        { 0.f,  1.f, 0.f},
+        {-1.f,  1.f, 0.f} // unused
+    };
+    const unsigned char indices[3] = {0, 1, 2};
+    const math::vec4 transform{0.25f, 0.5f, 0.5f, 0.f};
+
+    context.ubo(uboId).assign(&transform, 0);
+
+    if (context.vbo(vboId).init(sizeof(verts), verts) != 0
+    || context.ibo(iboId).init(3, VERTEX_DATA_BYTE, indices) != 0)
+    {
+        std::cerr << "Unable to initialize the vertex buffers." << std::endl;
+        return -1;
+    }
+
+    SL_VertexArray& vao = context.vao(vaoId);
+    vao.set_vertex_buffer(vboId);
+    vao.set_index_buffer(iboId);
+    if (vao.set_num_bindings(1) != 1)
+    {
+        std::cerr << "Unable to set the number of VAO bindings." << std::endl;
+        return -2;
+    }
+    vao.set_binding(0, 0, sizeof(math::vec3), VERTEX_DIMENSION_3, VERTEX_DATA_FLOAT);
+
+    if (context.texture(texId).init(SL_COLOR_RGBA_8U, TEST_FBO_SIZE, TEST_FBO_SIZE, 1) != 0
+    || context.texture(depthId).init(SL_COLOR_R_FLOAT, TEST_FBO_SIZE, TEST_FBO_SIZE, 1) != 0)
+    {
+        std::cerr << "Unable to initialize the framebuffer attachments." << std::endl;
+        return -3;
+    }
+
+    SL_Framebuffer& fbo = context.framebuffer(fboId);
+    if (fbo.reserve_color_buffers(1) != 0
+    || fbo.attach_color_buffer(0, context.texture(texId)) != 0
+    || fbo.attach_depth_buffer(context.texture(depthId)) != 0)
+    {
+        std::cerr << "Unable to initialize a framebuffer." << std::endl;
+        return -4;
+    }
+
+    SL_Mesh m;
+    m.vaoId = vaoId;
+    m.elementBegin = 0;
+    m.elementEnd = 3;
+    m.mode = RENDER_MODE_INDEXED_TRIANGLES;
+    m.materialId = (uint32_t)-1;
+
+    if (context.begin_capture(capture) != 0)
+    {
+        std::cerr << "Unable to begin a capture." << std::endl;
+        return -5;
+    }
+
+    context.clear_framebuffer(fboId, 0, math::vec4_t<double>{0.0, 0.0, 1.0, 1.0}, 0.0);
+    context.draw_instanced(m, TEST_NUM_INSTANCES, shaderId, fboId);
+    context.end_capture();
+
+    return 0;
+}
+
+
+
+/*--------------------------------------
+ * Main
+--------------------------------------*/
+int main()
+{
+    SL_Context context;
+    SL_FrameCapture capture;
+
+    context.num_threads(4);
+
+    int retCode = record_scene(context, capture);
+    if (retCode != 0)
+    {
+        return retCode;
+    }
+
+    retCode = capture.save(TEST_CAPTURE_FILE);
+    if (retCode != 0)
+    {
+        std::cerr << "Unable to save a capture: " << retCode << std::endl;
+        return -6;
+    }
+
+    SL_FrameCapture loaded;
+    retCode = loaded.load(TEST_CAPTURE_FILE);
+    std::remove(TEST_CAPTURE_FILE);
+
+    if (retCode != 0)
+    {
+        std::cerr << "Unable to load a capture: " << retCode << std::endl;
+        return -7;
+    }
+
+    if (loaded.num_commands() != capture.num_commands() || loaded.num_shaders() != capture.num_shaders())
+    {
+        std::cerr << "Loaded capture does not match the saved capture." << std::endl;
+        return -8;
+    }
+
+    // Replay without application shaders, relying on the recorded
+    // clip-space vertices.
+    SL_Context replayContext;
+    replayContext.num_threads(4);
+
+    retCode = loaded.instantiate(replayContext, nullptr, 0);
+    if (retCode != 0)
+    {
+        std::cerr << "Unable to instantiate a capture: " << retCode << std::endl;
+        return -9;
+    }
+
+    loaded.replay(replayContext);
+
+    const SL_Texture& expected = context.texture(0);
+    const SL_Texture& actual = replayContext.texture(0);
+    unsigned numCovered = 0;
+    unsigned numErrors = 0;
+
+    for (uint16_t y = 0; y < TEST_FBO_SIZE; ++y)
+    {
+        for (uint16_t x = 0; x < TEST_FBO_SIZE; ++x)
+        {
+            const SL_ColorRGBA8 a = expected.texel<SL_ColorRGBA8>(x, y);
+            const SL_ColorRGBA8 b = actual.texel<SL_ColorRGBA8>(x, y);
+
+            numCovered += a[0] == 255;
+
+            if (a != b)
+            {
+                ++numErrors;
+            }
+        }
+    }
+
+    if (!numCovered || numErrors)
+    {
+        std::cerr
+            << "Replayed capture does not match the original frame (" << numCovered
+            << " covered pixels, " << numErrors << " mismatched)." << std::endl;
+        return -10;
+    }
+
+    std::cout << "Frame capture round-trip test passed." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,139 @@
+
+#include <cmath> // std::isnan(), std::ldexp(), std::signbit()
+#include <iostream>
+#include <limits> // std::numeric_limits
+
+#include "lightsky/math/half.h"
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_Color.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Half-Float Conversion Checks
+ *
+ * Every value below is exactly representable as a half-float, so it must
+ * survive a store and load unchanged through both the scalar and vectorized
+ * (F16C or NEON) conversions.
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+const float TEST_VALUES[] = {
+    0.f,
+    -0.f,
+    1.f,
+    -2.5f,
+    65504.f,                    // largest finite half
+    -65504.f,
+    std::ldexp(1.f, -14),       // smallest normal half
+    std::ldexp(1.f, -24),       // smallest denormal half
+    -std::ldexp(1.f, -24),
+    std::ldexp(1023.f, -24),    // largest denormal half
+    std::ldexp(341.f, -24),
+    std::numeric_limits<float>::infinity(),
+    -std::numeric_limits<float>::infinity(),
+    std::numeric_limits<float>::quiet_NaN(),
+    -std::numeric_limits<float>::quiet_NaN(),
+    0.333251953125f             // 0x3555, all mantissa bits in use
+};
+
+constexpr unsigned TEST_NUM_VALUES = sizeof(TEST_VALUES) / sizeof(TEST_VALUES[0]);
+
+unsigned gNumErrors = 0;
+
+
+
+/*-------------------------------------
+ * Compare two floats, treating all NaNs as equal
+-------------------------------------*/
+bool _sl_floats_match(float expected, float actual) noexcept
+{
+    if (std::isnan(expected))
+    {
+        return std::isnan(actual);
+    }
+
+    return expected == actual && std::signbit(expected) == std::signbit(actual);
+}
+
+
+
+/*-------------------------------------
+ * Round-trip every test value through each channel of a color
+-------------------------------------*/
+template <unsigned num_channels>
+void _sl_check_round_trip() noexcept
+{
+    const math::half sentinel = (math::half)7.f;
+
+    for (unsigned i = 0; i < TEST_NUM_VALUES; ++i)
+    {
+        // Rotate the values so each appears in every channel
+        const math::vec4 src{
+            TEST_VALUES[(i+0) % TEST_NUM_VALUES],
+            TEST_VALUES[(i+1) % TEST_NUM_VALUES],
+            TEST_VALUES[(i+2) % TEST_NUM_VALUES],
+            TEST_VALUES[(i+3) % TEST_NUM_VALUES]
+        };
+
+        math::half texels[4] = {sentinel, sentinel, sentinel, sentinel};
+        sl_store_half_color<num_channels>(texels, src);
+
+        for (unsigned c = num_channels; c < 4; ++c)
+        {
+            if ((float)texels[c] != (float)sentinel)
+            {
+                std::cerr << num_channels << "-channel store wrote past the end of a texel." << std::endl;
+                ++gNumErrors;
+                return;
+            }
+        }
+
+        const math::vec4&& dst = sl_load_half_color<num_channels>(texels);
+
+        for (unsigned c = 0; c < 4; ++c)
+        {
+            const float expected = (c < num_channels) ? src[c] : 0.f;
+
+            // The vector and scalar conversions must agree
+            const float scalar = (c < num_channels) ? (float)(math::half)src[c] : 0.f;
+
+            if (!_sl_floats_match(expected, dst[c]) || !_sl_floats_match(expected, scalar))
+            {
+                std::cerr
+                    << num_channels << "-channel half conversion of channel " << c << ": expected "
+                    << expected << " but got " << dst[c] << " (scalar " << scalar << ")." << std::endl;
+                ++gNumErrors;
+            }
+        }
+    }
+}
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Main
+-----------------------------------------------------------------------------*/
+int main()
+{
+    _sl_check_round_trip<1>();
+    _sl_check_round_trip<2>();
+    _sl_check_round_trip<3>();
+    _sl_check_round_trip<4>();
+
+    if (gNumErrors)
+    {
+        std::cerr << "Half-float color test failed with " << gNumErrors << " errors." << std::endl;
+        return -1;
+    }
+
+    std::cout << "Half-float color test passed." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+
+#include <cmath> // std::sqrt()
+#include <iostream>
+#include <limits> // std::numeric_limits
+
+#include "lightsky/math/mat4.h"
+#include "lightsky/math/mat_utils.h"
+
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_LightCluster.hpp"
+#include "softlight/SL_LightProcessor.hpp" // SL_PointLight
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Test Constants
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+enum : uint16_t
+{
+    TEST_FBO_SIZE   = 64,
+    TEST_TILES      = 4,
+    TEST_SLICES     = 8,
+    TEST_MAX_LIGHTS = 2
+};
+
+constexpr float TEST_Z_NEAR = 0.1f;
+constexpr float TEST_Z_FAR  = 100.f;
+
+unsigned gNumErrors = 0;
+
+
+
+/*-------------------------------------
+ * Report a mismatched value
+-------------------------------------*/
+void _sl_expect(const char* pName, unsigned expected, unsigned actual) noexcept
+{
+    if (expected != actual)
+    {
+        std::cerr << pName << ": expected " << expected << " but got " << actual << '.' << std::endl;
+        ++gNumErrors;
+    }
+}
+
+
+
+/*-------------------------------------
+ * Depth slices are clamped to the grid
+-------------------------------------*/
+void _sl_check_slices(const SL_LightClusters& clusters) noexcept
+{
+    const float inf = std::numeric_limits<float>::infinity();
+    const unsigned lastSlice = TEST_SLICES - 1u;
+
+    _sl_expect("Near plane slice", 0, clusters.slice_for_depth(-TEST_Z_NEAR));
+    _sl_expect("Far plane slice", lastSlice, clusters.slice_for_depth(-TEST_Z_FAR));
+
+    // Out-of-range depths
+    _sl_expect("Camera-space origin slice", 0, clusters.slice_for_depth(0.f));
+    _sl_expect("Slice behind the camera", 0, clusters.slice_for_depth(1.f));
+    _sl_expect("Slice beyond the far plane", lastSlice, clusters.slice_for_depth(-TEST_Z_FAR * 1000.f));
+    _sl_expect("Slice at infinity", lastSlice, clusters.slice_for_depth(-inf));
+
+    // Slices are exponentially distributed between the near & far planes,
+    // placing the geometric mean of the planes halfway through the grid.
+    const unsigned midSlice = clusters.slice_for_depth(-std::sqrt(TEST_Z_NEAR * TEST_Z_FAR));
+    if (midSlice != TEST_SLICES/2u && midSlice != TEST_SLICES/2u - 1u)
+    {
+        std::cerr << "Midpoint slice should be near " << TEST_SLICES/2u << " but got " << midSlice << '.' << std::endl;
+        ++gNumErrors;
+    }
+
+    unsigned prevSlice = 0;
+    for (float d = TEST_Z_NEAR; d <= TEST_Z_FAR; d *= 1.25f)
+    {
+        const unsigned slice = clusters.slice_for_depth(-d);
+        if (slice < prevSlice)
+        {
+            std::cerr << "Slices should increase with depth: " << slice << " follows " << prevSlice << '.' << std::endl;
+            ++gNumErrors;
+            break;
+        }
+
+        prevSlice = slice;
+    }
+}
+
+
+
+/*-------------------------------------
+ * Cluster indices are clamped to the grid
+-------------------------------------*/
+void _sl_check_indices(const SL_LightClusters& clusters) noexcept
+{
+    const unsigned lastCluster = clusters.num_clusters() - 1u;
+
+    _sl_expect("First cluster", 0, clusters.cluster_index(0, 0, -TEST_Z_NEAR));
+    _sl_expect("Last cluster", lastCluster, clusters.cluster_index(TEST_FBO_SIZE-1, TEST_FBO_SIZE-1, -TEST_Z_FAR));
+
+    // Coordinates on or beyond the framebuffer edge
+    _sl_expect("Cluster at the framebuffer edge", lastCluster, clusters.cluster_index(TEST_FBO_SIZE, TEST_FBO_SIZE, -TEST_Z_FAR));
+    _sl_expect("Cluster beyond the framebuffer", lastCluster, clusters.cluster_index(UINT16_MAX, UINT16_MAX, -TEST_Z_FAR * 2.f));
+}
+
+
+
+/*-------------------------------------
+ * Clusters keep the first lights which fit and count the remainder
+-------------------------------------*/
+void _sl_check_overflow(SL_Context& context, SL_LightClusters& clusters) noexcept
+{
+    SL_PointLight lights[6];
+
+    // Five overlapping lights at the center of the screen
+    for (unsigned i = 0; i < 5; ++i)
+    {
+        lights[i].position = math::vec4{0.f, 0.f, -10.f, 1.f};
+        lights[i].color = math::vec4{1.f};
+    }
+
+    // Beyond the far plane
+    lights[5].position = math::vec4{0.f, 0.f, -TEST_Z_FAR * 2.f, 1.f};
+    lights[5].color = math::vec4{1.f};
+
+    if (context.build_light_clusters(clusters, lights, 6) != 0)
+    {
+        std::cerr << "Unable to build light clusters." << std::endl;
+        ++gNumErrors;
+        return;
+    }
+
+    unsigned numLights = 0;
+    const unsigned centerId = clusters.cluster_index(TEST_FBO_SIZE/2, TEST_FBO_SIZE/2, -10.f);
+    const uint16_t* pIds = clusters.lights(centerId, numLights);
+
+    _sl_expect("Center cluster lights", TEST_MAX_LIGHTS, numLights);
+    _sl_expect("Center cluster dropped lights", 5u - TEST_MAX_LIGHTS, clusters.num_dropped_lights(centerId));
+
+    for (unsigned i = 0; i < numLights; ++i)
+    {
+        _sl_expect("Center cluster light index", i, pIds[i]);
+    }
+
+    const unsigned cornerId = clusters.cluster_index(0, 0, -10.f);
+    clusters.lights(cornerId, numLights);
+
+    _sl_expect("Corner cluster lights", 0, numLights);
+    _sl_expect("Corner cluster dropped lights", 0, clusters.num_dropped_lights(cornerId));
+
+    if (!clusters.num_overflowed_clusters())
+    {
+        std::cerr << "Overflowed clusters were not reported." << std::endl;
+        ++gNumErrors;
+    }
+
+    // The distant light reaches no cluster
+    for (unsigned c = 0; c < clusters.num_clusters(); ++c)
+    {
+        pIds = clusters.lights(c, numLights);
+
+        for (unsigned i = 0; i < numLights; ++i)
+        {
+            if (pIds[i] == 5)
+            {
+                std::cerr << "A light beyond the far plane was assigned to cluster " << c << '.' << std::endl;
+                ++gNumErrors;
+                return;
+            }
+        }
+    }
+}
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Main
+-----------------------------------------------------------------------------*/
+int main()
+{
+    SL_Context context;
+    SL_LightClusters clusters;
+
+    context.num_threads(2);
+
+    if (clusters.init(TEST_TILES, TEST_TILES, TEST_SLICES, TEST_MAX_LIGHTS) != 0)
+    {
+        std::cerr << "Unable to initialize light clusters." << std::endl;
+        return -1;
+    }
+
+    const math::mat4&& projection = math::perspective(LS_DEG2RAD(60.f), 1.f, TEST_Z_NEAR, TEST_Z_FAR);
+    clusters.update(projection, TEST_Z_NEAR, TEST_Z_FAR, TEST_FBO_SIZE, TEST_FBO_SIZE);
+
+    _sl_check_slices(clusters);
+    _sl_check_indices(clusters);
+    _sl_check_overflow(context, clusters);
+
+    if (gNumErrors)
+    {
+        std::cerr << "Light cluster test failed with " << gNumErrors << " errors." << std::endl;
+        return -2;
+    }
+
+    std::cout << "Light cluster test passed." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,882 @@
+
+// Microbenchmarks for core pipeline kernels.
+//
+// Usage: sl_microbench [output JSON] [baseline JSON] [tolerance %]
+//
+// Each kernel is run single-threaded on synthetic, deterministic inputs and
+// its median time per item (sample, texel, triangle, element) is printed.
+// Results are written as JSON to the output file, or to stdout if the output
+// is "-" or omitted. Progress and comparison reports are printed to stderr
+// so stdout only contains JSON. If a baseline file produced by a previous
+// run is given, each result is compared against it and the program returns
+// a non-zero exit code if any kernel slowed down by more than the tolerance
+// (default 10%).
+//
+// Kernels which are internal to the pipeline (varying interpolation, the
+// clipper, and the triangle rasterizer) are measured through draw calls
+// designed to isolate them.
+
+#include <algorithm> // std::copy(), std::sort()
+#include <chrono>
+#include <cstdlib> // std::strtod()
+#include <cstring> // std::memset()
+#include <fstream>
+#include <iomanip> // std::setprecision
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "lightsky/math/vec4.h"
+#include "lightsky/utils/Sort.hpp" // utils::sort_radix
+
+#include "softlight/SL_BlitProcesor.hpp"
+#include "softlight/SL_ClearProcesor.hpp"
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_Octree.hpp"
+#include "softlight/SL_Sampler.hpp"
+#include "softlight/SL_Shader.hpp"
+#include "softlight/SL_ShaderUtil.hpp" // SL_BinCounter
+#include "softlight/SL_Swizzle.hpp"
+#include "softlight/SL_Texture.hpp"
+#include "softlight/SL_VertexArray.hpp"
+#include "softlight/SL_VertexBuffer.hpp"
+
+namespace math = ls::math;
+namespace utils = ls::utils;
+
+
+
+#ifndef SL_MICROBENCH_SAMPLES
+    #define SL_MICROBENCH_SAMPLES 15
+#endif /* SL_MICROBENCH_SAMPLES */
+
+// Minimum duration of each sample, in nanoseconds
+#ifndef SL_MICROBENCH_SAMPLE_TIME
+    #define SL_MICROBENCH_SAMPLE_TIME 2000000.0
+#endif /* SL_MICROBENCH_SAMPLE_TIME */
+
+#ifndef SL_MICROBENCH_TOLERANCE
+    #define SL_MICROBENCH_TOLERANCE 10.0
+#endif /* SL_MICROBENCH_TOLERANCE */
+
+#ifndef SL_MICROBENCH_TEX_SIZE
+    #define SL_MICROBENCH_TEX_SIZE 512
+#endif /* SL_MICROBENCH_TEX_SIZE */
+
+#ifndef SL_MICROBENCH_FBO_SIZE
+    #define SL_MICROBENCH_FBO_SIZE 512
+#endif /* SL_MICROBENCH_FBO_SIZE */
+
+#ifndef SL_MICROBENCH_RNG_SEED
+    #define SL_MICROBENCH_RNG_SEED 0x534C4D42u
+#endif /* SL_MICROBENCH_RNG_SEED */
+
+
+
+/*-----------------------------------------------------------------------------
+ * Benchmark harness
+-----------------------------------------------------------------------------*/
+struct MicrobenchResult
+{
+    std::string name;
+    uint64_t    items;
+    uint64_t    iterations;
+    double      nsPerItem;
+};
+
+
+
+// Results are accumulated here so the compiler cannot discard benchmarks
+volatile float _microbenchSink = 0.f;
+
+
+
+/*--------------------------------------
+ * Time a kernel. "func" must process "numItems" items per call.
+--------------------------------------*/
+template <typename Func>
+MicrobenchResult microbench_run(const std::string& name, uint64_t numItems, Func&& func)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // Warm up caches, then estimate how many calls fill a sample
+    func();
+
+    uint64_t iterations = 1;
+    for (;;)
+    {
+        const Clock::time_point start = Clock::now();
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            func();
+        }
+        const double ns = std::chrono::duration<double, std::nano>{Clock::now() - start}.count();
+
+        if (ns >= SL_MICROBENCH_SAMPLE_TIME || iterations >= (1ull << 30))
+        {
+            break;
+        }
+
+        iterations *= 2;
+    }
+
+    std::vector<double> samples;
+    samples.reserve(SL_MICROBENCH_SAMPLES);
+
+    for (unsigned s = 0; s < SL_MICROBENCH_SAMPLES; ++s)
+    {
+        const Clock::time_point start = Clock::now();
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            func();
+        }
+        samples.push_back(std::chrono::duration<double, std::nano>{Clock::now() - start}.count());
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    MicrobenchResult result;
+    result.name       = name;
+    result.items      = numItems;
+    result.iterations = iterations * SL_MICROBENCH_SAMPLES;
+    result.nsPerItem  = samples[samples.size() / 2] / (double)(iterations * numItems);
+
+    std::cerr << std::left << std::setw(40) << name << ' ' << result.nsPerItem << " ns/item" << std::endl;
+
+    return result;
+}
+
+
+
+/*--------------------------------------
+ * Initialize a texture with a repeating byte pattern. 0x3C produces small
+ * positive values for both half and single-precision floats.
+--------------------------------------*/
+int microbench_init_texture(SL_Texture& tex, SL_ColorDataType type, uint16_t w, uint16_t h)
+{
+    if (tex.init(type, w, h, 1) != 0)
+    {
+        return -1;
+    }
+
+    std::memset(tex.data(), 0x3C, tex.num_bytes());
+    return 0;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Texture sampling
+-----------------------------------------------------------------------------*/
+enum : unsigned
+{
+    MICROBENCH_NUM_UVS = 4096
+};
+
+
+
+/*-------------------------------------
+ * Time a sampling function over every coordinate. Each sampler returns its
+ * first channel as a float so all formats are summed the same way.
+-------------------------------------*/
+template <typename sampler_type>
+void microbench_sampler(std::vector<MicrobenchResult>& results, const std::string& name, SL_ColorDataType type, const std::vector<math::vec2>& uvs, sampler_type sampler)
+{
+    SL_Texture tex;
+    if (microbench_init_texture(tex, type, SL_MICROBENCH_TEX_SIZE, SL_MICROBENCH_TEX_SIZE) != 0)
+    {
+        std::cerr << "Unable to create a texture for " << name << std::endl;
+        return;
+    }
+
+    results.push_back(microbench_run(name, uvs.size(), [&]()->void
+    {
+        float sum = 0.f;
+
+        for (const math::vec2& uv : uvs)
+        {
+            sum += sampler(tex, uv[0], uv[1]);
+        }
+
+        _microbenchSink = _microbenchSink + sum;
+    }));
+}
+
+
+
+/*-------------------------------------
+ * Uncompressed color types
+-------------------------------------*/
+template <typename color_type, class WrapMode>
+void microbench_sampler_wrap(std::vector<MicrobenchResult>& results, const std::string& wrap, const std::string& format, SL_ColorDataType type, const std::vector<math::vec2>& uvs)
+{
+    microbench_sampler(results, "sample_nearest_" + wrap + '_' + format, type, uvs, [](const SL_Texture& tex, float u, float v)->float
+    {
+        return (float)sl_sample_nearest<color_type, WrapMode>(tex, u, v)[0];
+    });
+
+    microbench_sampler(results, "sample_bilinear_" + wrap + '_' + format, type, uvs, [](const SL_Texture& tex, float u, float v)->float
+    {
+        return (float)sl_sample_bilinear<color_type, WrapMode>(tex, u, v)[0];
+    });
+}
+
+
+
+template <typename color_type>
+void microbench_sampler_format(std::vector<MicrobenchResult>& results, const std::string& format, SL_ColorDataType type, const std::vector<math::vec2>& uvs)
+{
+    microbench_sampler_wrap<color_type, SL_WrapMode::EDGE>(results,   "edge",   format, type, uvs);
+    microbench_sampler_wrap<color_type, SL_WrapMode::BORDER>(results, "border", format, type, uvs);
+    microbench_sampler_wrap<color_type, SL_WrapMode::REPEAT>(results, "repeat", format, type, uvs);
+}
+
+
+
+/*-------------------------------------
+ * Packed color types, unpacked to floats while filtering
+-------------------------------------*/
+template <class packed_color, class WrapMode>
+void microbench_packed_sampler_wrap(std::vector<MicrobenchResult>& results, const std::string& wrap, const std::string& format, SL_ColorDataType type, const std::vector<math::vec2>& uvs)
+{
+    microbench_sampler(results, "sample_nearest_" + wrap + '_' + format, type, uvs, [](const SL_Texture& tex, float u, float v)->float
+    {
+        return sl_sample_packed_nearest<packed_color, WrapMode>(tex, u, v)[0];
+    });
+
+    microbench_sampler(results, "sample_bilinear_" + wrap + '_' + format, type, uvs, [](const SL_Texture& tex, float u, float v)->float
+    {
+        return sl_sample_packed_bilinear<packed_color, WrapMode>(tex, u, v)[0];
+    });
+}
+
+
+
+template <class packed_color>
+void microbench_packed_sampler_format(std::vector<MicrobenchResult>& results, const std::string& format, SL_ColorDataType type, const std::vector<math::vec2>& uvs)
+{
+    microbench_packed_sampler_wrap<packed_color, SL_WrapMode::EDGE>(results,   "edge",   format, type, uvs);
+    microbench_packed_sampler_wrap<packed_color, SL_WrapMode::BORDER>(results, "border", format, type, uvs);
+    microbench_packed_sampler_wrap<packed_color, SL_WrapMode::REPEAT>(results, "repeat", format, type, uvs);
+}
+
+
+
+/*-------------------------------------
+ * sRGB color types, decoded to linear space while filtering
+-------------------------------------*/
+template <typename color_type, class WrapMode>
+void microbench_srgb_sampler_wrap(std::vector<MicrobenchResult>& results, const std::string& wrap, const std::string& format, SL_ColorDataType type, const std::vector<math::vec2>& uvs)
+{
+    microbench_sampler(results, "sample_nearest_" + wrap + '_' + format, type, uvs, [](const SL_Texture& tex, float u, float v)->float
+    {
+        return sl_sample_srgb_nearest<color_type, WrapMode>(tex, u, v)[0];
+    });
+
+    microbench_sampler(results, "sample_bilinear_" + wrap + '_' + format, type, uvs, [](const SL_Texture& tex, float u, float v)->float
+    {
+        return sl_sample_srgb_bilinear<color_type, WrapMode>(tex, u, v)[0];
+    });
+}
+
+
+
+template <typename color_type>
+void microbench_srgb_sampler_format(std::vector<MicrobenchResult>& results, const std::string& format, SL_ColorDataType type, const std::vector<math::vec2>& uvs)
+{
+    microbench_srgb_sampler_wrap<color_type, SL_WrapMode::EDGE>(results,   "edge",   format, type, uvs);
+    microbench_srgb_sampler_wrap<color_type, SL_WrapMode::BORDER>(results, "border", format, type, uvs);
+    microbench_srgb_sampler_wrap<color_type, SL_WrapMode::REPEAT>(results, "repeat", format, type, uvs);
+}
+
+
+
+void microbench_samplers(std::vector<MicrobenchResult>& results)
+{
+    // Coordinates extend outside of [0, 1] to exercise each wrap mode
+    std::mt19937 rng{SL_MICROBENCH_RNG_SEED};
+    std::uniform_real_distribution<float> dist{-0.5f, 1.5f};
+    std::vector<math::vec2> uvs;
+    uvs.reserve(MICROBENCH_NUM_UVS);
+
+    for (unsigned i = 0; i < MICROBENCH_NUM_UVS; ++i)
+    {
+        const float u = dist(rng);
+        const float v = dist(rng);
+        uvs.push_back(math::vec2{u, v});
+    }
+
+    microbench_sampler_format<SL_ColorR8>(results,    "r8",     SL_COLOR_R_8U,       uvs);
+    microbench_sampler_format<SL_ColorRGB8>(results,  "rgb8",   SL_COLOR_RGB_8U,     uvs);
+    microbench_sampler_format<SL_ColorRGBA8>(results, "rgba8",  SL_COLOR_RGBA_8U,    uvs);
+    microbench_sampler_format<SL_ColorRf>(results,    "rf",     SL_COLOR_R_FLOAT,    uvs);
+    microbench_sampler_format<SL_ColorRGBAf>(results, "rgbaf",  SL_COLOR_RGBA_FLOAT, uvs);
+    microbench_sampler_format<SL_ColorRh>(results,    "rh",     SL_COLOR_R_HALF,     uvs);
+    microbench_sampler_format<SL_ColorRGBAh>(results, "rgbah",  SL_COLOR_RGBA_HALF,  uvs);
+
+    microbench_packed_sampler_format<SL_PackedColorRGB565>(results,     "rgb565",     SL_COLOR_RGB_565,         uvs);
+    microbench_packed_sampler_format<SL_PackedColorRGB10A2>(results,    "rgb10a2",    SL_COLOR_RGB10_A2,        uvs);
+    microbench_packed_sampler_format<SL_PackedColorR11G11B10F>(results, "r11g11b10f", SL_COLOR_R11G11B10_FLOAT, uvs);
+
+    microbench_srgb_sampler_format<SL_ColorRGB8>(results,  "srgb8",  SL_COLOR_SRGB_8U,  uvs);
+    microbench_srgb_sampler_format<SL_ColorRGBA8>(results, "srgba8", SL_COLOR_SRGBA_8U, uvs);
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Blitting and clearing
+-----------------------------------------------------------------------------*/
+struct MicrobenchFormat
+{
+    const char*      pName;
+    SL_ColorDataType type;
+};
+
+
+
+void microbench_blits(std::vector<MicrobenchResult>& results)
+{
+    const MicrobenchFormat srcFormats[] = {
+        {"r8",         SL_COLOR_R_8U},
+        {"rgb8",       SL_COLOR_RGB_8U},
+        {"rgba8",      SL_COLOR_RGBA_8U},
+        {"rgbah",      SL_COLOR_RGBA_HALF},
+        {"rgbaf",      SL_COLOR_RGBA_FLOAT},
+        {"r11g11b10f", SL_COLOR_R11G11B10_FLOAT}
+    };
+
+    const MicrobenchFormat dstFormats[] = {
+        {"rgb8",  SL_COLOR_RGB_8U},
+        {"rgba8", SL_COLOR_RGBA_8U},
+        {"rgbaf", SL_COLOR_RGBA_FLOAT}
+    };
+
+    constexpr uint16_t texSize = SL_MICROBENCH_TEX_SIZE;
+
+    for (const MicrobenchFormat& src : srcFormats)
+    {
+        SL_Texture srcTex;
+        if (microbench_init_texture(srcTex, src.type, texSize, texSize) != 0)
+        {
+            continue;
+        }
+
+        for (const MicrobenchFormat& dst : dstFormats)
+        {
+            SL_Texture dstTex;
+            if (microbench_init_texture(dstTex, dst.type, texSize, texSize) != 0)
+            {
+                continue;
+            }
+
+            SL_BlitProcessor blitter;
+            blitter.mThreadId   = 0;
+            blitter.mNumThreads = 1;
+            blitter.srcX0       = 0;
+            blitter.srcY0       = 0;
+            blitter.srcX1       = texSize;
+            blitter.srcY1       = texSize;
+            blitter.dstX0       = 0;
+            blitter.dstY0       = 0;
+            blitter.dstX1       = texSize;
+            blitter.dstY1       = texSize;
+            blitter.mTexture    = &srcTex;
+            blitter.mBackBuffer = &dstTex;
+            blitter.mToneMap    = nullptr;
+
+            const std::string name = std::string{"blit_"} + src.pName + "_to_" + dst.pName;
+            results.push_back(microbench_run(name, (uint64_t)texSize * texSize, [&]()->void
+            {
+                blitter.execute();
+            }));
+        }
+    }
+}
+
+
+
+void microbench_clears(std::vector<MicrobenchResult>& results)
+{
+    const MicrobenchFormat formats[] = {
+        {"r8",    SL_COLOR_R_8U},
+        {"rf",    SL_COLOR_R_FLOAT},
+        {"rgb8",  SL_COLOR_RGB_8U},
+        {"rgba8", SL_COLOR_RGBA_8U},
+        {"rgbaf", SL_COLOR_RGBA_FLOAT}
+    };
+
+    constexpr uint16_t texSize = SL_MICROBENCH_TEX_SIZE;
+
+    for (const MicrobenchFormat& f : formats)
+    {
+        SL_Texture tex;
+        if (microbench_init_texture(tex, f.type, texSize, texSize) != 0)
+        {
+            continue;
+        }
+
+        const SL_GeneralColor color = sl_match_color_for_type(f.type, math::vec4_t<double>{0.25, 0.5, 0.75, 1.0});
+
+        SL_ClearProcessor clearer;
+        clearer.mThreadId   = 0;
+        clearer.mNumThreads = 1;
+        clearer.mTexture    = &color.color;
+        clearer.mBackBuffer = &tex;
+        clearer.mRegion     = nullptr;
+
+        results.push_back(microbench_run(std::string{"clear_"} + f.pName, (uint64_t)texSize * texSize, [&]()->void
+        {
+            clearer.execute();
+        }));
+    }
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Triangle rasterization, varying interpolation, and clipping
+-----------------------------------------------------------------------------*/
+enum : unsigned
+{
+    MICROBENCH_MAX_VARYINGS = 4
+};
+
+
+
+math::vec4 _microbench_vert_shader(SL_VertexParam& param)
+{
+    const math::vec4& pos = *param.pVbo->element<const math::vec4>(param.pVao->offset(0, param.vertId));
+
+    for (unsigned i = 0; i < MICROBENCH_MAX_VARYINGS; ++i)
+    {
+        param.pVaryings[i] = pos;
+    }
+
+    return pos;
+}
+
+
+
+bool _microbench_frag_shader(SL_FragmentParam& fragParams)
+{
+    fragParams.pOutputs[0] = math::vec4{1.f};
+    return true;
+}
+
+
+
+bool _microbench_frag_shader_varyings(SL_FragmentParam& fragParams)
+{
+    fragParams.pOutputs[0] = fragParams.pVaryings[0] + fragParams.pVaryings[1] + fragParams.pVaryings[2] + fragParams.pVaryings[3];
+    return true;
+}
+
+
+
+size_t microbench_create_shader(SL_Context& context, uint8_t numVaryings)
+{
+    SL_VertexShader vertShader;
+    vertShader.numVaryings = numVaryings;
+    vertShader.cullMode    = SL_CULL_OFF;
+    vertShader.shader      = _microbench_vert_shader;
+
+    SL_FragmentShader fragShader;
+    fragShader.numVaryings = numVaryings;
+    fragShader.numOutputs  = 1;
+    fragShader.blend       = SL_BLEND_OFF;
+    fragShader.depthTest   = SL_DEPTH_TEST_OFF;
+    fragShader.depthMask   = SL_DEPTH_MASK_OFF;
+    fragShader.shader      = numVaryings ? _microbench_frag_shader_varyings : _microbench_frag_shader;
+
+    return context.create_shader(vertShader, fragShader);
+}
+
+
+
+/*--------------------------------------
+ * Generate triangles in clip-space. Sizes are given in NDC units.
+--------------------------------------*/
+void microbench_gen_tris(std::vector<math::vec4>& outVerts, unsigned numTris, float w, float h, bool behindCamera)
+{
+    std::mt19937 rng{SL_MICROBENCH_RNG_SEED};
+    std::uniform_real_distribution<float> distX{-1.f, 1.f - w};
+    std::uniform_real_distribution<float> distY{-1.f, 1.f - h};
+
+    outVerts.clear();
+    outVerts.reserve(numTris * 3u);
+
+    for (unsigned i = 0; i < numTris; ++i)
+    {
+        const float x = distX(rng);
+        const float y = distY(rng);
+
+        // A vertex behind the camera forces the triangle through the clipper
+        outVerts.push_back(behindCamera ? math::vec4{x, y, 0.5f, -0.5f} : math::vec4{x, y, 0.5f, 1.f});
+        outVerts.push_back(math::vec4{x + w, y,     0.5f, 1.f});
+        outVerts.push_back(math::vec4{x,     y + h, 0.5f, 1.f});
+    }
+}
+
+
+
+void microbench_triangles(std::vector<MicrobenchResult>& results)
+{
+    struct TriDistribution
+    {
+        const char* pName;
+        unsigned    numTris;
+        float       w;
+        float       h;
+        bool        clipped;
+    };
+
+    // NDC units, a pixel is 2/SL_MICROBENCH_FBO_SIZE wide
+    constexpr float px = 2.f / (float)SL_MICROBENCH_FBO_SIZE;
+
+    const TriDistribution distributions[] = {
+        {"tiny",    16384, 2.f*px,  2.f*px,   false},
+        {"small",   4096,  16.f*px, 16.f*px,  false},
+        {"large",   16,    1.5f,    1.5f,     false},
+        {"sliver",  2048,  1.5f,    1.f*px,   false},
+        {"clipped", 2048,  32.f*px, 32.f*px,  true}
+    };
+
+    SL_Context context;
+    context.num_threads(1);
+
+    const size_t texId   = context.create_texture();
+    const size_t depthId = context.create_texture();
+    const size_t fboId   = context.create_framebuffer();
+    const size_t vboId   = context.create_vbo();
+    const size_t vaoId   = context.create_vao();
+
+    SL_Framebuffer& fbo = context.framebuffer(fboId);
+    if (microbench_init_texture(context.texture(texId), SL_COLOR_RGBA_8U, SL_MICROBENCH_FBO_SIZE, SL_MICROBENCH_FBO_SIZE) != 0
+    || microbench_init_texture(context.texture(depthId), SL_COLOR_R_FLOAT, SL_MICROBENCH_FBO_SIZE, SL_MICROBENCH_FBO_SIZE) != 0
+    || fbo.reserve_color_buffers(1) != 0
+    || fbo.attach_color_buffer(0, context.texture(texId)) != 0
+    || fbo.attach_depth_buffer(context.texture(depthId)) != 0)
+    {
+        std::cerr << "Unable to create a framebuffer for triangle benchmarks." << std::endl;
+        return;
+    }
+
+    const size_t shaderId         = microbench_create_shader(context, 0);
+    const size_t varyingsShaderId = microbench_create_shader(context, MICROBENCH_MAX_VARYINGS);
+
+    std::vector<math::vec4> verts;
+
+    for (const TriDistribution& d : distributions)
+    {
+        microbench_gen_tris(verts, d.numTris, d.w, d.h, d.clipped);
+
+        SL_VertexBuffer& vbo = context.vbo(vboId);
+        SL_VertexArray&  vao = context.vao(vaoId);
+
+        if (vbo.init(verts.size() * sizeof(math::vec4), verts.data()) != 0)
+        {
+            std::cerr << "Unable to create a VBO for " << d.pName << " triangles." << std::endl;
+            continue;
+        }
+
+        vao.set_vertex_buffer(vboId);
+        vao.set_num_bindings(1);
+        vao.set_binding(0, 0, sizeof(math::vec4), SL_Dimension::VERTEX_DIMENSION_4, SL_DataType::VERTEX_DATA_FLOAT);
+
+        SL_Mesh m;
+        m.vaoId        = vaoId;
+        m.elementBegin = 0;
+        m.elementEnd   = verts.size();
+        m.mode         = RENDER_MODE_TRIANGLES;
+        m.materialId   = 0;
+
+        results.push_back(microbench_run(std::string{"raster_tri_"} + d.pName, d.numTris, [&]()->void
+        {
+            context.draw(m, shaderId, fboId);
+        }));
+
+        // Varying interpolation is measured on the same triangles
+        if (!d.clipped)
+        {
+            results.push_back(microbench_run(std::string{"raster_tri_varyings_"} + d.pName, d.numTris, [&]()->void
+            {
+                context.draw(m, varyingsShaderId, fboId);
+            }));
+        }
+    }
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Texture swizzling
+-----------------------------------------------------------------------------*/
+void microbench_swizzle(std::vector<MicrobenchResult>& results)
+{
+    constexpr uint_fast32_t texSize = SL_MICROBENCH_TEX_SIZE;
+
+    results.push_back(microbench_run("swizzle_2d_index", (uint64_t)texSize * texSize, [&]()->void
+    {
+        uint_fast32_t sum = 0;
+
+        for (uint_fast32_t y = 0; y < texSize; ++y)
+        {
+            for (uint_fast32_t x = 0; x < texSize; ++x)
+            {
+                sum += sl_swizzle_2d_index<SL_TEXELS_PER_CHUNK, SL_TEXEL_SHIFTS_PER_CHUNK>(x, y, texSize);
+            }
+        }
+
+        _microbenchSink = _microbenchSink + (float)sum;
+    }));
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Radix sorting of fragment bins
+-----------------------------------------------------------------------------*/
+void microbench_bin_sort(std::vector<MicrobenchResult>& results)
+{
+    std::mt19937 rng{SL_MICROBENCH_RNG_SEED};
+    std::uniform_real_distribution<float> dist{0.f, 1.f};
+
+    // Keys match the depth sort performed by the vertex processors. Bins are
+    // only depth-sorted when they hold fewer than SL_SHADER_MAX_BINNED_PRIMS
+    // primitives, so use the largest count which takes that path.
+    constexpr uint32_t numElements = SL_SHADER_MAX_BINNED_PRIMS - 1u;
+
+    std::vector<float> depths;
+    std::vector<SL_BinCounter<uint32_t>> unsorted;
+    std::vector<SL_BinCounter<uint32_t>> binIds;
+    std::vector<SL_BinCounter<uint32_t>> tempIds;
+
+    depths.reserve(numElements);
+    unsorted.reserve(numElements);
+
+    for (uint32_t i = 0; i < numElements; ++i)
+    {
+        depths.push_back(dist(rng));
+        unsorted.push_back(SL_BinCounter<uint32_t>{i});
+    }
+
+    binIds = unsorted;
+    tempIds = unsorted;
+
+    results.push_back(microbench_run("radix_sort_bins", numElements, [&]()->void
+    {
+        std::copy(unsorted.begin(), unsorted.end(), binIds.begin());
+
+        utils::sort_radix<SL_BinCounter<uint32_t>>(binIds.data(), tempIds.data(), binIds.size(), [&](const SL_BinCounter<uint32_t>& val) noexcept->unsigned long long
+        {
+            return (unsigned long long) -(*reinterpret_cast<const int32_t*>(depths.data() + val.count));
+        });
+
+        _microbenchSink = _microbenchSink + (float)binIds[0].count;
+    }));
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Octree insertion and queries
+-----------------------------------------------------------------------------*/
+void microbench_octree(std::vector<MicrobenchResult>& results)
+{
+    typedef SL_Octree<uint32_t, 8> OctreeType;
+
+    constexpr unsigned numObjects = 4096;
+
+    std::mt19937 rng{SL_MICROBENCH_RNG_SEED};
+    std::uniform_real_distribution<float> distPos{-500.f, 500.f};
+    std::uniform_real_distribution<float> distRadius{0.5f, 8.f};
+    std::vector<math::vec4> objects;
+    objects.reserve(numObjects);
+
+    for (unsigned i = 0; i < numObjects; ++i)
+    {
+        const float x = distPos(rng);
+        const float y = distPos(rng);
+        const float z = distPos(rng);
+        objects.push_back(math::vec4{x, y, z, distRadius(rng)});
+    }
+
+    OctreeType octree{math::vec3{0.f, 0.f, 0.f}, 512.f};
+
+    results.push_back(microbench_run("octree_insert", numObjects, [&]()->void
+    {
+        octree.clear();
+
+        for (uint32_t i = 0; i < numObjects; ++i)
+        {
+            const math::vec4& o = objects[i];
+            octree.insert(math::vec3{o[0], o[1], o[2]}, o[3], i);
+        }
+    }));
+
+    results.push_back(microbench_run("octree_query", numObjects, [&]()->void
+    {
+        size_t sum = 0;
+
+        for (const math::vec4& o : objects)
+        {
+            const OctreeType* pNode = octree.find(math::vec3{o[0], o[1], o[2]});
+            sum += pNode ? pNode->size() : 0;
+        }
+
+        _microbenchSink = _microbenchSink + (float)sum;
+    }));
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * JSON input and output
+-----------------------------------------------------------------------------*/
+/*--------------------------------------
+ * Write results with one benchmark per line, so baselines can be read back
+ * without a full JSON parser.
+--------------------------------------*/
+void microbench_write_json(std::ostream& out, const std::vector<MicrobenchResult>& results)
+{
+    out << std::setprecision(6) << "{\n\"benchmarks\": [\n";
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const MicrobenchResult& r = results[i];
+        out << "{\"name\": \"" << r.name
+            << "\", \"items\": " << r.items
+            << ", \"iterations\": " << r.iterations
+            << ", \"ns_per_item\": " << r.nsPerItem
+            << (i + 1 < results.size() ? "},\n" : "}\n");
+    }
+
+    out << "]\n}\n";
+}
+
+
+
+/*--------------------------------------
+ * Read the "name" and "ns_per_item" fields written by microbench_write_json()
+--------------------------------------*/
+int microbench_read_json(const char* pFilename, std::map<std::string, double>& outResults)
+{
+    std::ifstream f{pFilename};
+    if (!f.good())
+    {
+        return -1;
+    }
+
+    const std::string nameKey = "\"name\": \"";
+    const std::string timeKey = "\"ns_per_item\": ";
+    std::string line;
+
+    while (std::getline(f, line))
+    {
+        const std::string::size_type namePos = line.find(nameKey);
+        const std::string::size_type timePos = line.find(timeKey);
+
+        if (namePos == std::string::npos || timePos == std::string::npos)
+        {
+            continue;
+        }
+
+        const std::string::size_type nameBegin = namePos + nameKey.size();
+        const std::string::size_type nameEnd   = line.find('"', nameBegin);
+        if (nameEnd == std::string::npos)
+        {
+            continue;
+        }
+
+        outResults[line.substr(nameBegin, nameEnd - nameBegin)] = std::strtod(line.c_str() + timePos + timeKey.size(), nullptr);
+    }
+
+    return outResults.empty() ? -2 : 0;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Main
+-----------------------------------------------------------------------------*/
+int main(int argc, char** argv)
+{
+    const std::string outFile   = (argc > 1) ? argv[1] : "-";
+    const char* const pBaseline = (argc > 2) ? argv[2] : nullptr;
+    const double      tolerance = (argc > 3) ? std::strtod(argv[3], nullptr) : SL_MICROBENCH_TOLERANCE;
+
+    if (tolerance <= 0.0)
+    {
+        std::cerr << "Usage: " << argv[0] << " [output JSON] [baseline JSON] [tolerance %]" << std::endl;
+        return -1;
+    }
+
+    std::map<std::string, double> baseline;
+    if (pBaseline && microbench_read_json(pBaseline, baseline) != 0)
+    {
+        std::cerr << "Unable to read the baseline file " << pBaseline << std::endl;
+        return -2;
+    }
+
+    std::vector<MicrobenchResult> results;
+
+    microbench_samplers(results);
+    microbench_blits(results);
+    microbench_clears(results);
+    microbench_triangles(results);
+    microbench_swizzle(results);
+    microbench_bin_sort(results);
+    microbench_octree(results);
+
+    if (outFile == "-")
+    {
+        microbench_write_json(std::cout, results);
+    }
+    else
+    {
+        std::ofstream f{outFile};
+        microbench_write_json(f, results);
+        f.close();
+
+        if (f.fail())
+        {
+            std::cerr << "Unable to write " << outFile << std::endl;
+            return -3;
+        }
+
+        std::cerr << "Saved " << results.size() << " results to " << outFile << std::endl;
+    }
+
+    if (!pBaseline)
+    {
+        return 0;
+    }
+
+    unsigned numRegressions = 0;
+
+    for (const MicrobenchResult& r : results)
+    {
+        const std::map<std::string, double>::const_iterator iter = baseline.find(r.name);
+        if (iter == baseline.end() || iter->second <= 0.0)
+        {
+            std::cerr << "No baseline for " << r.name << std::endl;
+            continue;
+        }
+
+        const double change = 100.0 * (r.nsPerItem - iter->second) / iter->second;
+        if (change > tolerance)
+        {
+            std::cerr << "REGRESSION " << r.name << ": " << iter->second << " -> " << r.nsPerItem << " ns/item (+" << change << "%)" << std::endl;
+            ++numRegressions;
+        }
+    }
+
+    std::cerr << numRegressions << " of " << results.size() << " kernels regressed by more than " << tolerance << "%." << std::endl;
+
+    return numRegressions ? -4 : 0;
+}
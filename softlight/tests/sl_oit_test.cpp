@@ -0,0 +1,374 @@
+
+#include <cmath> // std::abs()
+#include <iostream>
+
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_CompositeProcessor.hpp" // SL_OITAttachment
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_Shader.hpp"
+#include "softlight/SL_Texture.hpp"
+#include "softlight/SL_UniformBuffer.hpp"
+#include "softlight/SL_VertexArray.hpp"
+#include "softlight/SL_VertexBuffer.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Test Constants
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+enum : uint16_t
+{
+    TEST_FBO_SIZE = 32,
+    TEST_NUM_LAYERS = 2
+};
+
+// Per-layer uniforms. The depth of each full-screen layer is stored in the
+// first component of "depth".
+struct TestLayer
+{
+    math::vec4 color;
+    math::vec4 depth;
+};
+
+const math::vec4 TEST_BACKGROUND{0.f, 1.f, 0.f, 1.f};
+
+// Depth is only perturbed by the reciprocal used in the perspective divide
+constexpr float TEST_TOLERANCE = 2.e-3f;
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Shader to draw a full-screen, translucent layer
+-----------------------------------------------------------------------------*/
+/*--------------------------------------
+ * Vertex Shader
+--------------------------------------*/
+math::vec4 _layer_vert_shader_impl(SL_VertexParam& param)
+{
+    const TestLayer* pLayer = param.pUniforms->as<TestLayer>();
+    const math::vec4& pos = *(param.pVbo->element<const math::vec4>(param.pVao->offset(0, param.vertId)));
+
+    return math::vec4{pos[0], pos[1], pLayer->depth[0], 1.f};
+}
+
+
+
+SL_VertexShader layer_vert_shader()
+{
+    SL_VertexShader shader;
+    shader.numVaryings = 0;
+    shader.cullMode = SL_CULL_OFF;
+    shader.shader = _layer_vert_shader_impl;
+
+    return shader;
+}
+
+
+
+/*--------------------------------------
+ * Fragment Shader
+--------------------------------------*/
+bool _layer_frag_shader_impl(SL_FragmentParam& fragParam)
+{
+    fragParam.pOutputs[0] = fragParam.pUniforms->as<TestLayer>()->color;
+    return true;
+}
+
+
+
+SL_FragmentShader layer_frag_shader()
+{
+    SL_FragmentShader shader;
+    shader.numVaryings = 0;
+    shader.numOutputs = 1;
+    shader.blend = SL_BLEND_WEIGHTED_OIT;
+    shader.depthMask = SL_DEPTH_MASK_OFF;
+    shader.depthTest = SL_DEPTH_TEST_OFF;
+    shader.shader = _layer_frag_shader_impl;
+
+    return shader;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Test Functions
+-----------------------------------------------------------------------------*/
+/*--------------------------------------
+ * Objects used to render each layer
+--------------------------------------*/
+struct TestScene
+{
+    size_t fboId;
+    size_t outTexId;
+    size_t shaderIds[TEST_NUM_LAYERS];
+    size_t uboIds[TEST_NUM_LAYERS];
+    SL_Mesh mesh;
+};
+
+
+
+/*--------------------------------------
+ * Create an OIT framebuffer and a full-screen triangle
+--------------------------------------*/
+int init_scene(SL_Context& context, TestScene& scene)
+{
+    const size_t accumId = context.create_texture();
+    const size_t revealId = context.create_texture();
+    const size_t depthId = context.create_texture();
+    const size_t vaoId = context.create_vao();
+    const size_t vboId = context.create_vbo();
+
+    scene.fboId = context.create_framebuffer();
+    scene.outTexId = context.create_texture();
+
+    for (unsigned i = 0; i < TEST_NUM_LAYERS; ++i)
+    {
+        scene.uboIds[i] = context.create_ubo();
+        scene.shaderIds[i] = context.create_shader(layer_vert_shader(), layer_frag_shader(), scene.uboIds[i]);
+    }
+
+    const math::vec4 verts[3] = {
+        {-1.f, -1.f, 0.f, 1.f},
+        { 3.f, -1.f, 0.f, 1.f},
+        {-1.f,  3.f, 0.f, 1.f}
+    };
+
+    SL_VertexBuffer& vbo = context.vbo(vboId);
+    if (vbo.init(sizeof(verts)) != 0)
+    {
+        std::cerr << "Unable to initialize a VBO." << std::endl;
+        return -1;
+    }
+    vbo.assign(verts, 0, sizeof(verts));
+
+    SL_VertexArray& vao = context.vao(vaoId);
+    vao.set_vertex_buffer(vboId);
+    if (vao.set_num_bindings(1) != 1)
+    {
+        std::cerr << "Unable to set the number of VAO bindings." << std::endl;
+        return -2;
+    }
+    vao.set_binding(0, 0, sizeof(math::vec4), SL_Dimension::VERTEX_DIMENSION_4, SL_DataType::VERTEX_DATA_FLOAT);
+
+    if (context.texture(accumId).init(SL_COLOR_RGBA_FLOAT, TEST_FBO_SIZE, TEST_FBO_SIZE, 1) != 0
+    || context.texture(revealId).init(SL_COLOR_R_FLOAT, TEST_FBO_SIZE, TEST_FBO_SIZE, 1) != 0
+    || context.texture(depthId).init(SL_COLOR_R_FLOAT, TEST_FBO_SIZE, TEST_FBO_SIZE, 1) != 0
+    || context.texture(scene.outTexId).init(SL_COLOR_RGBA_FLOAT, TEST_FBO_SIZE, TEST_FBO_SIZE, 1) != 0)
+    {
+        std::cerr << "Unable to initialize the framebuffer attachments." << std::endl;
+        return -3;
+    }
+
+    SL_Framebuffer& fbo = context.framebuffer(scene.fboId);
+    if (fbo.reserve_color_buffers(SL_OIT_MIN_ATTACHMENTS) != 0
+    || fbo.attach_color_buffer(SL_OIT_ACCUMULATION, context.texture(accumId)) != 0
+    || fbo.attach_color_buffer(SL_OIT_REVEALAGE, context.texture(revealId)) != 0
+    || fbo.attach_depth_buffer(context.texture(depthId)) != 0)
+    {
+        std::cerr << "Unable to initialize a framebuffer." << std::endl;
+        return -4;
+    }
+
+    scene.mesh.vaoId = vaoId;
+    scene.mesh.elementBegin = 0;
+    scene.mesh.elementEnd = 3;
+    scene.mesh.mode = RENDER_MODE_TRIANGLES;
+    scene.mesh.materialId = (uint32_t)-1;
+
+    return 0;
+}
+
+
+
+/*--------------------------------------
+ * Draw translucent layers in the requested order, then composite them over
+ * the background.
+--------------------------------------*/
+int render_layers(
+    SL_Context& context,
+    const TestScene& scene,
+    const TestLayer* pLayers,
+    const unsigned* pOrder,
+    unsigned numLayers,
+    float zNear,
+    float zFar,
+    math::vec4& outColor)
+{
+    SL_Framebuffer& fbo = context.framebuffer(scene.fboId);
+    SL_Texture& outTex = context.texture(scene.outTexId);
+
+    fbo.depth_range(zNear, zFar);
+
+    context.clear_color_buffer(scene.fboId, SL_OIT_ACCUMULATION, math::vec4_t<double>{0.0, 0.0, 0.0, 0.0});
+    context.clear_color_buffer(scene.fboId, SL_OIT_REVEALAGE, math::vec4_t<double>{1.0, 1.0, 1.0, 1.0});
+    context.clear_depth_buffer(scene.fboId, 1.0);
+
+    SL_ColorRGBAf* pOut = reinterpret_cast<SL_ColorRGBAf*>(outTex.data());
+    for (unsigned i = 0; i < (unsigned)TEST_FBO_SIZE*TEST_FBO_SIZE; ++i)
+    {
+        pOut[i] = TEST_BACKGROUND;
+    }
+
+    for (unsigned i = 0; i < numLayers; ++i)
+    {
+        const unsigned layerId = pOrder[i];
+        context.ubo(scene.uboIds[layerId]).assign(pLayers + layerId, 0);
+        context.draw(scene.mesh, scene.shaderIds[layerId], scene.fboId);
+    }
+
+    if (context.composite_transparency(scene.fboId, scene.outTexId) != 0)
+    {
+        std::cerr << "Unable to composite transparent layers." << std::endl;
+        return -1;
+    }
+
+    // Every pixel is covered by the same layers
+    outColor = pOut[0];
+
+    for (unsigned i = 1; i < (unsigned)TEST_FBO_SIZE*TEST_FBO_SIZE; ++i)
+    {
+        for (unsigned c = 0; c < 4; ++c)
+        {
+            if (std::abs(pOut[i][c] - outColor[c]) > TEST_TOLERANCE)
+            {
+                std::cerr << "Pixel " << i << " does not match the rest of the image." << std::endl;
+                return -2;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+
+/*--------------------------------------
+ * Reference implementation of weighted-blended OIT
+--------------------------------------*/
+math::vec4 expected_color(const TestLayer* pLayers, unsigned numLayers, float zNear, float zFar)
+{
+    math::vec4 accum{0.f};
+    float revealage = 1.f;
+
+    for (unsigned i = 0; i < numLayers; ++i)
+    {
+        const math::vec4& c = pLayers[i].color;
+        const float z = math::clamp((pLayers[i].depth[0] - zNear) / (zFar - zNear), 0.f, 1.f);
+        const float w = c[3] * math::clamp(3.e3f * (1.f-z) * (1.f-z) * (1.f-z), 1.e-2f, 3.e3f);
+
+        accum += math::vec4{c[0], c[1], c[2], 1.f} * w;
+        revealage *= 1.f - c[3];
+    }
+
+    math::vec4 ret = math::mix(accum / accum[3], TEST_BACKGROUND, revealage);
+    ret[3] = 1.f;
+
+    return ret;
+}
+
+
+
+/*--------------------------------------
+ * Compare a composited color against the reference
+--------------------------------------*/
+bool check_color(const char* pName, const math::vec4& expected, const math::vec4& actual)
+{
+    for (unsigned c = 0; c < 4; ++c)
+    {
+        if (std::abs(expected[c] - actual[c]) > TEST_TOLERANCE)
+        {
+            std::cerr
+                << pName << ": expected (" << expected[0] << ", " << expected[1] << ", " << expected[2] << ", " << expected[3]
+                << ") but got (" << actual[0] << ", " << actual[1] << ", " << actual[2] << ", " << actual[3] << ")." << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+/*--------------------------------------
+ * Main
+--------------------------------------*/
+int main()
+{
+    SL_Context context;
+    TestScene scene;
+
+    context.num_threads(4);
+
+    int retCode = init_scene(context, scene);
+    if (retCode != 0)
+    {
+        return retCode;
+    }
+
+    // A red layer close to the camera and a blue layer further away. Both
+    // depths are expressed for OpenGL's [-1, 1] range.
+    TestLayer layers[TEST_NUM_LAYERS] = {
+        {math::vec4{1.f, 0.f, 0.f, 0.6f}, math::vec4{-0.5f, 0.f, 0.f, 0.f}},
+        {math::vec4{0.f, 0.f, 1.f, 0.4f}, math::vec4{ 0.5f, 0.f, 0.f, 0.f}}
+    };
+
+    const unsigned frontToBack[TEST_NUM_LAYERS] = {0, 1};
+    const unsigned backToFront[TEST_NUM_LAYERS] = {1, 0};
+    unsigned numErrors = 0;
+    math::vec4 color;
+
+    // A single layer reduces to regular alpha blending
+    const math::vec4&& single = math::mix(layers[0].color, TEST_BACKGROUND, 1.f - layers[0].color[3]);
+    if (render_layers(context, scene, layers, frontToBack, 1, -1.f, 1.f, color) != 0
+    || !check_color("Single layer", math::vec4{single[0], single[1], single[2], 1.f}, color))
+    {
+        ++numErrors;
+    }
+
+    const math::vec4&& expected = expected_color(layers, TEST_NUM_LAYERS, -1.f, 1.f);
+
+    if (render_layers(context, scene, layers, frontToBack, TEST_NUM_LAYERS, -1.f, 1.f, color) != 0
+    || !check_color("Front-to-back layers", expected, color))
+    {
+        ++numErrors;
+    }
+
+    if (render_layers(context, scene, layers, backToFront, TEST_NUM_LAYERS, -1.f, 1.f, color) != 0
+    || !check_color("Back-to-front layers", expected, color))
+    {
+        ++numErrors;
+    }
+
+    // The same layers using reversed-Z must receive the same weights, with
+    // the red layer still closest to the camera.
+    layers[0].depth[0] = 0.75f;
+    layers[1].depth[0] = 0.25f;
+
+    if (render_layers(context, scene, layers, backToFront, TEST_NUM_LAYERS, 1.f, 0.f, color) != 0
+    || !check_color("Reversed-Z layers", expected, color))
+    {
+        ++numErrors;
+    }
+
+    if (numErrors)
+    {
+        std::cerr << "OIT test failed with " << numErrors << " errors." << std::endl;
+        return -5;
+    }
+
+    std::cout << "OIT test passed." << std::endl;
+
+    return 0;
+}
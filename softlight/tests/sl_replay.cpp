@@ -0,0 +1,104 @@
+
+// Frame capture replay.
+//
+// Usage: sl_replay <capture file> [thread count] [iteration count]
+//
+// Loads a capture saved with SL_FrameCapture::save() (see sl_benchmark) and
+// replays it repeatedly into an offscreen context. Shader functions cannot be
+// stored in a capture, so draws replay the clip-space vertices recorded with
+// each draw through a pass-through vertex shader and a constant-color fragment
+// shader. Timings are useful for comparing changes to the pipeline against the
+// same workload, but do not include the cost of the original shaders.
+
+#include <algorithm> // std::sort()
+#include <chrono>
+#include <cstdlib> // std::strtoul()
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "lightsky/math/scalar_utils.h"
+
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_FrameCapture.hpp"
+
+
+
+#ifndef SL_TEST_MAX_THREADS
+    #define SL_TEST_MAX_THREADS (ls::math::max<unsigned>(std::thread::hardware_concurrency(), 2u) - 1u)
+#endif /* SL_TEST_MAX_THREADS */
+
+#ifndef SL_REPLAY_ITERATIONS
+    #define SL_REPLAY_ITERATIONS 100
+#endif /* SL_REPLAY_ITERATIONS */
+
+
+
+/*-----------------------------------------------------------------------------
+ * Main
+-----------------------------------------------------------------------------*/
+int main(int argc, char** argv)
+{
+    const char* const pCapture      = (argc > 1) ? argv[1] : nullptr;
+    const unsigned    numThreads    = (argc > 2) ? (unsigned)std::strtoul(argv[2], nullptr, 10) : (unsigned)SL_TEST_MAX_THREADS;
+    const unsigned    numIterations = (argc > 3) ? (unsigned)std::strtoul(argv[3], nullptr, 10) : (unsigned)SL_REPLAY_ITERATIONS;
+
+    if (!pCapture || !numThreads || !numIterations)
+    {
+        std::cerr << "Usage: " << argv[0] << " <capture file> [thread count] [iteration count]" << std::endl;
+        return -1;
+    }
+
+    SL_FrameCapture capture;
+    int retCode = capture.load(pCapture);
+    if (retCode != 0)
+    {
+        std::cerr << "Unable to load " << pCapture << " (error " << retCode << ")." << std::endl;
+        return -2;
+    }
+
+    SL_Context context;
+    context.num_threads(numThreads);
+
+    retCode = capture.instantiate(context, nullptr, 0);
+    if (retCode != 0)
+    {
+        std::cerr << "Unable to create the captured resources (error " << retCode << ")." << std::endl;
+        return -3;
+    }
+
+    std::cout
+        << "Replaying " << capture.num_commands() << " commands from " << pCapture
+        << ' ' << numIterations << " times with " << context.num_threads() << " threads." << std::endl;
+
+    // Warm up caches and the thread pool
+    capture.replay(context);
+
+    std::vector<double> times;
+    times.reserve(numIterations);
+
+    for (unsigned i = 0; i < numIterations; ++i)
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        capture.replay(context);
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        times.push_back(std::chrono::duration<double, std::milli>{end - start}.count());
+    }
+
+    double totalMs = 0.0;
+    for (double ms : times)
+    {
+        totalMs += ms;
+    }
+
+    std::sort(times.begin(), times.end());
+
+    std::cout
+        << "    min:    " << times.front() << " ms\n"
+        << "    median: " << times[times.size() / 2] << " ms\n"
+        << "    max:    " << times.back() << " ms\n"
+        << "    mean:   " << (totalMs / (double)numIterations) << " ms" << std::endl;
+
+    return 0;
+}
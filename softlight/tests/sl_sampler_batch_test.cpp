@@ -0,0 +1,256 @@
+
+#include <cstdint>
+#include <cstdlib> // std::abs()
+#include <iostream>
+#include <random>
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_Sampler.hpp"
+#include "softlight/SL_Texture.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Batch sampler checks
+ *
+ * Every batched sampler is compared against its scalar equivalent using
+ * random coordinates. Border-clamped lookups also use coordinates outside of
+ * [0, 1) so masked lanes are exercised. Filtered results may differ by one
+ * unit due to the order of floating-point operations.
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+enum : uint16_t
+{
+    TEST_TEX_SIZE_2D = 32,
+    TEST_TEX_SIZE_3D = 16,
+    TEST_TEX_DEPTH_3D = 8
+};
+
+constexpr unsigned TEST_NUM_ITERATIONS = 256;
+
+unsigned gNumErrors = 0;
+
+std::mt19937 gRandom{0x5EED};
+
+
+
+/*-------------------------------------
+ * Fill a texture with random bytes
+-------------------------------------*/
+int _sl_init_random_texture(SL_Texture& tex, SL_ColorDataType type, uint16_t w, uint16_t h, uint16_t d, SL_TexelOrder order) noexcept
+{
+    if (tex.init(type, w, h, d, order) != 0)
+    {
+        return -1;
+    }
+
+    std::uniform_int_distribution<int> dist{0, 255};
+    unsigned char* pTexels = reinterpret_cast<unsigned char*>(tex.data());
+    const size_t numBytes = (size_t)w * h * d * tex.bpp();
+
+    for (size_t i = 0; i < numBytes; ++i)
+    {
+        pTexels[i] = (unsigned char)dist(gRandom);
+    }
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Generate random texture coordinates
+-------------------------------------*/
+template <unsigned count>
+void _sl_random_coords(float (&coords)[count]) noexcept
+{
+    // Coordinates outside of [0, 1) check the clamping and wrapping of each
+    // mode, as well as the masking of border-clamped lanes.
+    std::uniform_real_distribution<float> dist{-0.5f, 1.5f};
+
+    for (float& c : coords)
+    {
+        c = dist(gRandom);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Compare a batch of texels against scalar results
+-------------------------------------*/
+template <typename color_type, unsigned count>
+void _sl_compare_texels(const char* pName, const color_type (&expected)[count], const color_type (&actual)[count], long tolerance) noexcept
+{
+    typedef typename color_type::value_type value_type;
+    constexpr unsigned numChannels = (unsigned)(sizeof(color_type) / sizeof(value_type));
+
+    for (unsigned lane = 0; lane < count; ++lane)
+    {
+        for (unsigned c = 0; c < numChannels; ++c)
+        {
+            const long a = (long)expected[lane][c];
+            const long b = (long)actual[lane][c];
+
+            if (std::abs(a - b) > tolerance)
+            {
+                std::cerr
+                    << pName << " (" << sizeof(color_type) << "-byte texels, " << count << " lanes): lane "
+                    << lane << ", channel " << c << " expected " << a << " but got " << b << std::endl;
+                ++gNumErrors;
+                return;
+            }
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Check the 2D batch samplers
+-------------------------------------*/
+template <typename color_type, class WrapMode, SL_TexelOrder order, unsigned count>
+void _sl_check_batch_2d(const SL_Texture& tex) noexcept
+{
+    float x[count];
+    float y[count];
+    color_type expected[count];
+    color_type actual[count];
+
+    for (unsigned i = 0; i < TEST_NUM_ITERATIONS; ++i)
+    {
+        _sl_random_coords<count>(x);
+        _sl_random_coords<count>(y);
+
+        for (unsigned lane = 0; lane < count; ++lane)
+        {
+            expected[lane] = sl_sample_nearest<color_type, WrapMode, order>(tex, x[lane], y[lane]);
+        }
+        sl_sample_nearest_batch<color_type, WrapMode, order, count>(tex, x, y, actual);
+        _sl_compare_texels<color_type, count>("sl_sample_nearest_batch", expected, actual, 0);
+
+        for (unsigned lane = 0; lane < count; ++lane)
+        {
+            expected[lane] = sl_sample_bilinear<color_type, WrapMode, order>(tex, x[lane], y[lane]);
+        }
+        sl_sample_bilinear_batch<color_type, WrapMode, order, count>(tex, x, y, actual);
+        _sl_compare_texels<color_type, count>("sl_sample_bilinear_batch", expected, actual, 1);
+
+        for (unsigned lane = 0; lane < count; ++lane)
+        {
+            expected[lane] = sl_sample_trilinear<color_type, WrapMode, order>(tex, x[lane], y[lane]);
+        }
+        sl_sample_trilinear_batch<color_type, WrapMode, order, count>(tex, x, y, actual);
+        _sl_compare_texels<color_type, count>("sl_sample_trilinear_batch", expected, actual, 1);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Check the 3D batch samplers
+-------------------------------------*/
+template <typename color_type, class WrapMode, SL_TexelOrder order, unsigned count>
+void _sl_check_batch_3d(const SL_Texture& tex) noexcept
+{
+    float x[count];
+    float y[count];
+    float z[count];
+    color_type expected[count];
+    color_type actual[count];
+
+    for (unsigned i = 0; i < TEST_NUM_ITERATIONS; ++i)
+    {
+        _sl_random_coords<count>(x);
+        _sl_random_coords<count>(y);
+        _sl_random_coords<count>(z);
+
+        for (unsigned lane = 0; lane < count; ++lane)
+        {
+            expected[lane] = sl_sample_nearest<color_type, WrapMode, order>(tex, x[lane], y[lane], z[lane]);
+        }
+        sl_sample_nearest_batch<color_type, WrapMode, order, count>(tex, x, y, z, actual);
+        _sl_compare_texels<color_type, count>("sl_sample_nearest_batch (3D)", expected, actual, 0);
+
+        for (unsigned lane = 0; lane < count; ++lane)
+        {
+            expected[lane] = sl_sample_bilinear<color_type, WrapMode, order>(tex, x[lane], y[lane], z[lane]);
+        }
+        sl_sample_bilinear_slice_batch<color_type, WrapMode, order, count>(tex, x, y, z, actual);
+        _sl_compare_texels<color_type, count>("sl_sample_bilinear_slice_batch", expected, actual, 1);
+
+        for (unsigned lane = 0; lane < count; ++lane)
+        {
+            expected[lane] = sl_sample_trilinear<color_type, WrapMode, order>(tex, x[lane], y[lane], z[lane]);
+        }
+        sl_sample_trilinear_batch<color_type, WrapMode, order, count>(tex, x, y, z, actual);
+        _sl_compare_texels<color_type, count>("sl_sample_trilinear_batch (3D)", expected, actual, 1);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Check all wrap modes and batch sizes for a single texel format
+-------------------------------------*/
+template <typename color_type, SL_TexelOrder order = SL_TexelOrder::SL_TEXELS_ORDERED>
+int _sl_check_format(SL_ColorDataType type) noexcept
+{
+    SL_Texture tex2d;
+    SL_Texture tex3d;
+
+    if (_sl_init_random_texture(tex2d, type, TEST_TEX_SIZE_2D, TEST_TEX_SIZE_2D, 1, order) != 0
+    || _sl_init_random_texture(tex3d, type, TEST_TEX_SIZE_3D, TEST_TEX_SIZE_3D, TEST_TEX_DEPTH_3D, order) != 0)
+    {
+        std::cerr << "Unable to initialize a texture of type " << (unsigned)type << '.' << std::endl;
+        return -1;
+    }
+
+    _sl_check_batch_2d<color_type, SL_WrapModeClampEdge,   order, 4>(tex2d);
+    _sl_check_batch_2d<color_type, SL_WrapModeClampBorder, order, 4>(tex2d);
+    _sl_check_batch_2d<color_type, SL_WrapModeRepeat,      order, 4>(tex2d);
+    _sl_check_batch_2d<color_type, SL_WrapModeClampEdge,   order, 8>(tex2d);
+    _sl_check_batch_2d<color_type, SL_WrapModeClampBorder, order, 8>(tex2d);
+    _sl_check_batch_2d<color_type, SL_WrapModeRepeat,      order, 8>(tex2d);
+
+    _sl_check_batch_3d<color_type, SL_WrapModeClampEdge,   order, 4>(tex3d);
+    _sl_check_batch_3d<color_type, SL_WrapModeClampBorder, order, 4>(tex3d);
+    _sl_check_batch_3d<color_type, SL_WrapModeRepeat,      order, 4>(tex3d);
+    _sl_check_batch_3d<color_type, SL_WrapModeClampEdge,   order, 8>(tex3d);
+    _sl_check_batch_3d<color_type, SL_WrapModeClampBorder, order, 8>(tex3d);
+    _sl_check_batch_3d<color_type, SL_WrapModeRepeat,      order, 8>(tex3d);
+
+    return 0;
+}
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Main
+-----------------------------------------------------------------------------*/
+int main()
+{
+    // 1-, 3-, 4-, and 8-byte texels cover each gather path.
+    if (_sl_check_format<SL_ColorR8>(SL_COLOR_R_8U) != 0
+    || _sl_check_format<SL_ColorRGB8>(SL_COLOR_RGB_8U) != 0
+    || _sl_check_format<SL_ColorRGBA8>(SL_COLOR_RGBA_8U) != 0
+    || _sl_check_format<SL_ColorRGBA8, SL_TexelOrder::SL_TEXELS_SWIZZLED>(SL_COLOR_RGBA_8U) != 0
+    || _sl_check_format<SL_ColorRGBA16>(SL_COLOR_RGBA_16U) != 0)
+    {
+        return -1;
+    }
+
+    if (gNumErrors)
+    {
+        std::cerr << "Batch sampler test failed with " << gNumErrors << " errors." << std::endl;
+        return -2;
+    }
+
+    std::cout << "Batch sampler test passed." << std::endl;
+
+    return 0;
+}
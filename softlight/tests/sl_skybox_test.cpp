@@ -72,13 +72,12 @@ math::vec4 _sky_vert_shader(SL_VertexParam& param)
 {
     const SkyUniforms* pUniforms = param.pUniforms->as<SkyUniforms>();
     const math::vec3   vert      = *(param.pVbo->element<const math::vec3>(param.pVao->offset(0, param.vertId)));
-    const math::vec3   uv        = *(param.pVbo->element<const math::vec3>(param.pVao->offset(1, param.vertId)));
 
     // too lazy to flip the cube vertices upside-down
     const math::vec4&& worldPos = pUniforms->vpMatrix * math::vec4_cast(vert, 1.f);
-    const math::vec4&& outUv    = math::vec4_cast(uv, 0.f);
 
-    param.pVaryings[0] = outUv;
+    // The cube's local-space vertices double as cube map directions
+    param.pVaryings[0] = math::vec4_cast(vert, 0.f);
 
     return math::vec4_cast(math::vec2_cast(worldPos), math::vec2{worldPos[3]});
 }
@@ -103,10 +102,10 @@ SL_VertexShader sky_vert_shader()
 bool _sky_frag_shader(SL_FragmentParam& fragParam)
 {
     const SkyUniforms* pUniforms = fragParam.pUniforms->as<SkyUniforms>();
-    const math::vec4&  uv        = fragParam.pVaryings[0];
+    const math::vec4&  dir       = fragParam.pVaryings[0];
     const SL_Texture*  cubeTex   = pUniforms->pCubeMap;
 
-    const math::vec3_t<uint8_t>&& albedo8 = sl_sample_bilinear<math::vec3_t<uint8_t>, SL_WrapMode::EDGE>(*cubeTex, uv[0], uv[1], uv[2]);
+    const math::vec3_t<uint8_t>&& albedo8 = sl_sample_cube_bilinear<math::vec3_t<uint8_t>, SL_TEXELS_SWIZZLED>(*cubeTex, dir[0], dir[1], dir[2]);
 
     // output composition
     fragParam.pOutputs[0] = color_cast<float, uint8_t>(math::vec4_cast<uint8_t>(albedo8, 255));
@@ -132,57 +131,33 @@ SL_FragmentShader sky_frag_shader()
 
 
 /*-------------------------------------
- * Read a volume file
+ * Read the faces of a cube map
 -------------------------------------*/
-int read_skybox_files(SL_SceneGraph& graph, const std::array<std::string, 6>& cubeFiles)
+int read_skybox_files(SL_SceneGraph& graph, const std::array<std::string, SL_CUBE_FACE_COUNT>& cubeFiles)
 {
-    SL_ImgFile loader;
-    size_t w = 0;
-    size_t h = 0;
-    size_t bpp = 0;
-    int iter = 1;
+    SL_ImgFile loaders[SL_CUBE_FACE_COUNT];
+    const SL_ImgFile* pFaces[SL_CUBE_FACE_COUNT];
 
-    const size_t texId = graph.mContext.create_texture();
-    SL_Texture& tex = graph.mContext.texture(texId);
-
-    for (const std::string& cubeFace : cubeFiles)
+    for (unsigned i = 0; i < SL_CUBE_FACE_COUNT; ++i)
     {
-        if (loader.load(cubeFace.c_str()) != SL_ImgFile::FILE_LOAD_SUCCESS)
+        if (loaders[i].load(cubeFiles[i].c_str()) != SL_ImgFile::FILE_LOAD_SUCCESS)
         {
-            std::cerr << "Unable to load the cube map face \"" << cubeFace.c_str() << "\"." << std::endl;
-            graph.mContext.destroy_texture(texId);
+            std::cerr << "Unable to load the cube map face \"" << cubeFiles[i].c_str() << "\"." << std::endl;
             return -1;
         }
 
-        if (iter == 1)
-        {
-            w = loader.width();
-            h = loader.height();
-            bpp = loader.bpp();
-            tex.init(SL_ColorDataType::SL_COLOR_RGB_8U, (uint16_t)w, (uint16_t)h, 6);
-        }
-        else
-        {
-            if (loader.width() != w
-            || loader.height() != h
-            || loader.bpp() != bpp)
-            {
-                std::cerr << "Image " << iter-1 << " contains incorrect image dimensions." << std::endl;
-                graph.mContext.destroy_texture(texId);
-                return -2;
-            }
-        }
-
-        tex.set_texels(0, 0, (uint16_t)(iter-1), (uint16_t)w, (uint16_t)h, 1, loader.data());
-        ++iter;
+        pFaces[i] = loaders + i;
     }
 
-    SL_ImgFile outImg;
-    outImg.load_memory_stream(tex.data(), tex.type(), tex.width(), tex.height()*tex.depth());
-    outImg.save("skybox.png", SL_ImgFileType::IMG_FILE_PNG);
+    const size_t texId = graph.mContext.create_texture();
+    SL_Texture& tex = graph.mContext.texture(texId);
 
-    //sl_img_save_ppm((uint16_t)w, (uint16_t)h*6, (const SL_ColorRGB8*)tex.data(), "skybox.ppm");
-    std::cout << "Successfully saved the image skybox.ppm" << std::endl;
+    if (tex.init_cube(pFaces, SL_TEXELS_SWIZZLED) != 0)
+    {
+        std::cerr << "Cube map faces must be square and share the same dimensions and format." << std::endl;
+        graph.mContext.destroy_texture(texId);
+        return -2;
+    }
 
     return 0;
 }
@@ -202,7 +177,7 @@ int scene_load_cube(SL_SceneGraph& graph)
 
     size_t vboId = context.create_vbo();
     SL_VertexBuffer& vbo = context.vbo(vboId);
-    retCode = vbo.init(numVerts*stride*2);
+    retCode = vbo.init(numVerts*stride);
     if (retCode != 0)
     {
         std::cerr << "Error while creating a VBO: " << retCode << std::endl;
@@ -212,8 +187,8 @@ int scene_load_cube(SL_SceneGraph& graph)
     size_t vaoId = context.create_vao();
     SL_VertexArray& vao = context.vao(vaoId);
     vao.set_vertex_buffer(vboId);
-    retCode = vao.set_num_bindings(2);
-    if (retCode != 2)
+    retCode = vao.set_num_bindings(1);
+    if (retCode != 1)
     {
         std::cerr << "Error while setting the number of VAO bindings: " << retCode << std::endl;
         abort();
@@ -274,62 +249,8 @@ int scene_load_cube(SL_SceneGraph& graph)
         vbo.assign(verts, numVboBytes, sizeof(verts));
         vao.set_binding(0, numVboBytes, stride, SL_Dimension::VERTEX_DIMENSION_3, SL_DataType::VERTEX_DATA_FLOAT);
         numVboBytes += sizeof(verts);
-    }
-    {
-        math::vec3 uvs[numVerts];
 
-        // front face
-        uvs[0] = math::vec3{0.f, 0.f, 0.f};
-        uvs[1] = math::vec3{1.f, 0.f, 0.f};
-        uvs[2] = math::vec3{1.f, 1.f, 0.f};
-        uvs[3] = math::vec3{1.f, 1.f, 0.f};
-        uvs[4] = math::vec3{0.f, 1.f, 0.f};
-        uvs[5] = math::vec3{0.f, 0.f, 0.f};
-
-        // right face
-        uvs[6]  = math::vec3{0.f, 0.f, 1.f/6.f};
-        uvs[7]  = math::vec3{1.f, 0.f, 1.f/6.f};
-        uvs[8]  = math::vec3{1.f, 1.f, 1.f/6.f};
-        uvs[9]  = math::vec3{1.f, 1.f, 1.f/6.f};
-        uvs[10] = math::vec3{0.f, 1.f, 1.f/6.f};
-        uvs[11] = math::vec3{0.f, 0.f, 1.f/6.f};
-
-        // back face
-        uvs[12] = math::vec3{0.f, 0.f, 2.f/6.f};
-        uvs[13] = math::vec3{1.f, 0.f, 2.f/6.f};
-        uvs[14] = math::vec3{1.f, 1.f, 2.f/6.f};
-        uvs[15] = math::vec3{1.f, 1.f, 2.f/6.f};
-        uvs[16] = math::vec3{0.f, 1.f, 2.f/6.f};
-        uvs[17] = math::vec3{0.f, 0.f, 2.f/6.f};
-
-        // left face
-        uvs[18] = math::vec3{0.f, 0.f, 3.f/6.f};
-        uvs[19] = math::vec3{1.f, 0.f, 3.f/6.f};
-        uvs[20] = math::vec3{1.f, 1.f, 3.f/6.f};
-        uvs[21] = math::vec3{1.f, 1.f, 3.f/6.f};
-        uvs[22] = math::vec3{0.f, 1.f, 3.f/6.f};
-        uvs[23] = math::vec3{0.f, 0.f, 3.f/6.f};
-
-        // bottom face
-        uvs[24] = math::vec3{0.f, 0.f, 4.f/6.f};
-        uvs[25] = math::vec3{1.f, 0.f, 4.f/6.f};
-        uvs[26] = math::vec3{1.f, 1.f, 4.f/6.f};
-        uvs[27] = math::vec3{1.f, 1.f, 4.f/6.f};
-        uvs[28] = math::vec3{0.f, 1.f, 4.f/6.f};
-        uvs[29] = math::vec3{0.f, 0.f, 4.f/6.f};
-
-        // top face
-        uvs[30] = math::vec3{0.f, 0.f, 5.f/6.f};
-        uvs[31] = math::vec3{1.f, 0.f, 5.f/6.f};
-        uvs[32] = math::vec3{1.f, 1.f, 5.f/6.f};
-        uvs[33] = math::vec3{1.f, 1.f, 5.f/6.f};
-        uvs[34] = math::vec3{0.f, 1.f, 5.f/6.f};
-        uvs[35] = math::vec3{0.f, 0.f, 5.f/6.f};
-        vbo.assign(uvs, numVboBytes, sizeof(uvs));
-        vao.set_binding(1, numVboBytes, stride, SL_Dimension::VERTEX_DIMENSION_3, SL_DataType::VERTEX_DATA_FLOAT);
-        numVboBytes += sizeof(uvs);
-
-        assert(numVboBytes == (numVerts * stride * 2));
+        assert(numVboBytes == (numVerts * stride));
     }
 
     graph.mMeshes.emplace_back(SL_Mesh());
@@ -383,16 +304,16 @@ utils::Pointer<SL_SceneGraph> init_sky_context()
     retCode = fbo.valid();
     assert(retCode == 0);
 
-    std::array<std::string, 6> files{
-        "testdata/skybox/front.jpg",
+    std::array<std::string, SL_CUBE_FACE_COUNT> files{
         "testdata/skybox/right.jpg",
-        "testdata/skybox/back.jpg",
         "testdata/skybox/left.jpg",
-        "testdata/skybox/bottom.jpg",
         "testdata/skybox/top.jpg",
+        "testdata/skybox/bottom.jpg",
+        "testdata/skybox/front.jpg",
+        "testdata/skybox/back.jpg",
     };
 
-    retCode = read_skybox_files(*pGraph, files); // creates volume at texture index 2-7
+    retCode = read_skybox_files(*pGraph, files); // creates a cube map at texture index 2
     assert(retCode == 0);
 
     retCode = scene_load_cube(*pGraph);
@@ -0,0 +1,134 @@
+
+#include <cmath> // std::abs()
+#include <cstdint>
+#include <iostream>
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_ColorSRGB.hpp"
+#include "softlight/SL_Sampler.hpp"
+#include "softlight/SL_Texture.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * sRGB Conversion Checks
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+unsigned gNumErrors = 0;
+
+
+
+/*-------------------------------------
+ * Every sRGB value survives a trip through linear space
+-------------------------------------*/
+void _sl_check_round_trip() noexcept
+{
+    float prevLinear = -1.f;
+
+    for (unsigned c = 0; c < 256; ++c)
+    {
+        const float linear = sl_srgb_to_linear((uint8_t)c);
+
+        if (linear <= prevLinear)
+        {
+            std::cerr << "sRGB value " << c << " does not decode to a larger linear value than " << (c-1u) << '.' << std::endl;
+            ++gNumErrors;
+        }
+
+        prevLinear = linear;
+
+        const unsigned scalar = sl_linear_to_srgb(linear);
+        if (scalar != c)
+        {
+            std::cerr << "sRGB value " << c << " round-trips to " << scalar << '.' << std::endl;
+            ++gNumErrors;
+        }
+
+        // The vectorized encoder must agree on every channel, while alpha is
+        // stored linearly.
+        const SL_ColorRGBA8&& rgba = sl_linear_to_srgb(math::vec4{linear, linear, linear, (float)c / 255.f});
+        for (unsigned i = 0; i < 4; ++i)
+        {
+            if (rgba[i] != c)
+            {
+                std::cerr << "sRGB value " << c << " round-trips to " << (unsigned)rgba[i] << " in channel " << i << '.' << std::endl;
+                ++gNumErrors;
+                break;
+            }
+        }
+    }
+
+    if (sl_srgb_to_linear((uint8_t)0) != 0.f || sl_srgb_to_linear((uint8_t)255) != 1.f)
+    {
+        std::cerr << "sRGB endpoints should decode to 0 and 1." << std::endl;
+        ++gNumErrors;
+    }
+}
+
+
+
+/*-------------------------------------
+ * Coordinates are scaled by the texture size, like sl_sample_bilinear()
+-------------------------------------*/
+int _sl_check_bilinear() noexcept
+{
+    SL_Texture tex;
+
+    if (tex.init(SL_COLOR_SRGBA_8U, 2, 1, 1) != 0)
+    {
+        std::cerr << "Unable to initialize an sRGB texture." << std::endl;
+        return -1;
+    }
+
+    tex.texel<SL_ColorRGBA8>(0, 0) = SL_ColorRGBA8{0, 0, 0, 255};
+    tex.texel<SL_ColorRGBA8>(1, 0) = SL_ColorRGBA8{255, 255, 255, 255};
+
+    // Blending happens between the linear values of each texel
+    const math::vec4&& mid = sl_sample_srgb_bilinear<SL_ColorRGBA8, SL_WrapModeClampEdge>(tex, 0.25f, 0.f);
+    if (std::abs(mid[0] - 0.5f) > 1.e-6f)
+    {
+        std::cerr << "sRGB bilinear sample between texels should be 0.5 but was " << mid[0] << '.' << std::endl;
+        ++gNumErrors;
+    }
+
+    // The last texel is not filtered past the texture's edge
+    const math::vec4&& edge = sl_sample_srgb_bilinear<SL_ColorRGBA8, SL_WrapModeClampEdge>(tex, 1.f, 0.f);
+    if (edge[0] != 1.f)
+    {
+        std::cerr << "sRGB bilinear sample at the texture edge should be 1 but was " << edge[0] << '.' << std::endl;
+        ++gNumErrors;
+    }
+
+    return 0;
+}
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Main
+-----------------------------------------------------------------------------*/
+int main()
+{
+    _sl_check_round_trip();
+
+    if (_sl_check_bilinear() != 0)
+    {
+        return -1;
+    }
+
+    if (gNumErrors)
+    {
+        std::cerr << "sRGB test failed with " << gNumErrors << " errors." << std::endl;
+        return -2;
+    }
+
+    std::cout << "sRGB test passed." << std::endl;
+
+    return 0;
+}
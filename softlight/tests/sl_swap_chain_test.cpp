@@ -0,0 +1,205 @@
+
+#include <cstdint>
+#include <iostream>
+#include <utility> // std::move()
+
+#include "softlight/SL_RenderWindowHeadless.hpp"
+#include "softlight/SL_SwapChain.hpp"
+#include "softlight/SL_WindowBuffer.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Swap Chain Checks
+ *
+ * Buffers are presented to a headless window, which completes each present
+ * immediately. Every buffer count must cycle through its buffers in order
+ * and report the serial number and timing of each frame.
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+enum : unsigned
+{
+    TEST_WIDTH  = 64,
+    TEST_HEIGHT = 48,
+
+    // Frames to present for each buffer count
+    TEST_NUM_CYCLES = 3
+};
+
+unsigned gNumErrors = 0;
+
+
+
+/*-------------------------------------
+ * Report a mismatched value
+-------------------------------------*/
+void _sl_expect(const char* pName, unsigned numBuffers, uint64_t expected, uint64_t actual) noexcept
+{
+    if (expected != actual)
+    {
+        std::cerr << pName << " (" << numBuffers << " buffers): expected " << expected << " but got " << actual << '.' << std::endl;
+        ++gNumErrors;
+    }
+}
+
+
+
+/*-------------------------------------
+ * Acquire and present several rounds of frames
+-------------------------------------*/
+void _sl_check_presents(SL_RenderWindowHeadless& window, SL_SwapChain& swapChain) noexcept
+{
+    const unsigned   numBuffers = swapChain.num_buffers();
+    SL_WindowBuffer* pBuffers[SL_SWAP_CHAIN_MAX_BUFFERS] = {nullptr};
+    uint64_t         prevSerial = window.presents_completed();
+
+    for (unsigned frame = 0; frame < numBuffers * TEST_NUM_CYCLES; ++frame)
+    {
+        const unsigned   bufferId = frame % numBuffers;
+        SL_WindowBuffer& buffer   = swapChain.back_buffer();
+
+        // The first round acquires each buffer once, later rounds must
+        // return them in the same order.
+        if (frame < numBuffers)
+        {
+            for (unsigned i = 0; i < frame; ++i)
+            {
+                if (pBuffers[i] == &buffer)
+                {
+                    std::cerr << "Buffer " << i << " was acquired twice in the first " << numBuffers << " frames." << std::endl;
+                    ++gNumErrors;
+                }
+            }
+
+            pBuffers[bufferId] = &buffer;
+        }
+        else if (pBuffers[bufferId] != &buffer)
+        {
+            std::cerr << "Frame " << frame << " should render into buffer " << bufferId << '.' << std::endl;
+            ++gNumErrors;
+        }
+
+        _sl_expect("Back buffer width", numBuffers, TEST_WIDTH, buffer.width());
+        _sl_expect("Back buffer height", numBuffers, TEST_HEIGHT, buffer.height());
+
+        buffer.buffer()[0][0] = (uint8_t)frame;
+
+        const uint64_t serial = swapChain.present();
+        _sl_expect("Present serial", numBuffers, prevSerial + 1u, serial);
+        prevSerial = serial;
+
+        if (window.last_frame() != &buffer || window.last_frame()->buffer()[0][0] != (uint8_t)frame)
+        {
+            std::cerr << "Frame " << frame << " was not presented to the window." << std::endl;
+            ++gNumErrors;
+        }
+
+        const SL_FrameTiming& timing = swapChain.frame_timing(bufferId);
+        _sl_expect("Frame timing serial", numBuffers, serial, timing.serial);
+
+        if (timing.presentedTime < timing.queuedTime)
+        {
+            std::cerr << "Frame " << frame << " was presented before it was queued." << std::endl;
+            ++gNumErrors;
+        }
+
+        _sl_expect("Last presented serial", numBuffers, serial, swapChain.last_presented_frame().serial);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Run a swap chain with a given number of buffers
+-------------------------------------*/
+void _sl_check_swap_chain(SL_RenderWindowHeadless& window, unsigned numBuffers) noexcept
+{
+    SL_SwapChain swapChain;
+
+    if (swapChain.init(window, numBuffers, TEST_WIDTH, TEST_HEIGHT) != 0)
+    {
+        std::cerr << "Unable to initialize a swap chain with " << numBuffers << " buffers." << std::endl;
+        ++gNumErrors;
+        return;
+    }
+
+    _sl_expect("Buffer count", numBuffers, numBuffers, swapChain.num_buffers());
+    _sl_check_presents(window, swapChain);
+
+    // All buffers must be resized
+    if (swapChain.resize(TEST_WIDTH/2, TEST_HEIGHT/2) != 0)
+    {
+        std::cerr << "Unable to resize a swap chain with " << numBuffers << " buffers." << std::endl;
+        ++gNumErrors;
+        return;
+    }
+
+    for (unsigned i = 0; i < numBuffers; ++i)
+    {
+        SL_WindowBuffer& buffer = swapChain.back_buffer();
+        _sl_expect("Resized buffer width", numBuffers, TEST_WIDTH/2, buffer.width());
+        _sl_expect("Resized buffer height", numBuffers, TEST_HEIGHT/2, buffer.height());
+        swapChain.present();
+    }
+
+    // Moving a swap chain transfers its buffers
+    SL_SwapChain moved{std::move(swapChain)};
+    _sl_expect("Moved buffer count", numBuffers, numBuffers, moved.num_buffers());
+    _sl_expect("Moved-from buffer count", numBuffers, 0, swapChain.num_buffers());
+
+    moved.wait_idle();
+    moved.terminate();
+    _sl_expect("Terminated buffer count", numBuffers, 0, moved.num_buffers());
+}
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Main
+-----------------------------------------------------------------------------*/
+int main()
+{
+    SL_RenderWindowHeadless window;
+    SL_SwapChain swapChain;
+
+    // Windows must be initialized before creating buffers for them
+    if (swapChain.init(window, 2, TEST_WIDTH, TEST_HEIGHT) != -2)
+    {
+        std::cerr << "Swap chains should not be created for an invalid window." << std::endl;
+        ++gNumErrors;
+    }
+
+    if (window.init(TEST_WIDTH, TEST_HEIGHT) != 0 || !window.run())
+    {
+        std::cerr << "Unable to initialize a headless window." << std::endl;
+        return -1;
+    }
+
+    if (swapChain.init(window, 0, TEST_WIDTH, TEST_HEIGHT) != -1
+    || swapChain.init(window, SL_SWAP_CHAIN_MAX_BUFFERS+1, TEST_WIDTH, TEST_HEIGHT) != -1)
+    {
+        std::cerr << "Swap chains must have between 1 and " << SL_SWAP_CHAIN_MAX_BUFFERS << " buffers." << std::endl;
+        ++gNumErrors;
+    }
+
+    for (unsigned numBuffers = 1; numBuffers <= SL_SWAP_CHAIN_MAX_BUFFERS; ++numBuffers)
+    {
+        _sl_check_swap_chain(window, numBuffers);
+    }
+
+    window.destroy();
+
+    if (gNumErrors)
+    {
+        std::cerr << "Swap chain test failed with " << gNumErrors << " errors." << std::endl;
+        return -2;
+    }
+
+    std::cout << "Swap chain test passed." << std::endl;
+
+    return 0;
+}
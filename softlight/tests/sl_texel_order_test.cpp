@@ -0,0 +1,251 @@
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_ImgFile.hpp"
+#include "softlight/SL_Sampler.hpp"
+#include "softlight/SL_Texture.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Texel order checks
+ *
+ * The same image is loaded into an ordered and a swizzled texture. Every
+ * accessor and sampler must return identical results for both, as only the
+ * arrangement of texels in memory differs.
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+enum : uint16_t
+{
+    TEST_TEX_SIZE = 24,
+
+    // Swizzled images must be a multiple of SL_TEXELS_PER_CHUNK
+    TEST_UNALIGNED_SIZE = 6
+};
+
+constexpr unsigned TEST_NUM_SAMPLES = 1024;
+
+unsigned gNumErrors = 0;
+
+std::mt19937 gRandom{0x5EED};
+
+
+
+/*-------------------------------------
+ * Compare two texels
+-------------------------------------*/
+bool _sl_texels_differ(const SL_ColorRGBA8& a, const SL_ColorRGBA8& b) noexcept
+{
+    return a[0] != b[0] || a[1] != b[1] || a[2] != b[2] || a[3] != b[3];
+}
+
+
+
+/*-------------------------------------
+ * Report a mismatched texel
+-------------------------------------*/
+void _sl_report(const char* pName, float x, float y, const SL_ColorRGBA8& a, const SL_ColorRGBA8& b) noexcept
+{
+    std::cerr
+        << pName << " at (" << x << ", " << y << "): ("
+        << (unsigned)a[0] << ", " << (unsigned)a[1] << ", " << (unsigned)a[2] << ", " << (unsigned)a[3] << ") != ("
+        << (unsigned)b[0] << ", " << (unsigned)b[1] << ", " << (unsigned)b[2] << ", " << (unsigned)b[3] << ")."
+        << std::endl;
+    ++gNumErrors;
+}
+
+
+
+/*-------------------------------------
+ * Direct texel access
+-------------------------------------*/
+void _sl_check_texels(const SL_ColorRGBA8* pImage, const SL_Texture& ordered, const SL_Texture& swizzled) noexcept
+{
+    for (uint16_t y = 0; y < TEST_TEX_SIZE; ++y)
+    {
+        for (uint16_t x = 0; x < TEST_TEX_SIZE; ++x)
+        {
+            const SL_ColorRGBA8& expected = pImage[x + y*TEST_TEX_SIZE];
+
+            const SL_ColorRGBA8 a = ordered.texel<SL_ColorRGBA8, SL_TexelOrder::SL_TEXELS_ORDERED>(x, y);
+            const SL_ColorRGBA8 b = swizzled.texel<SL_ColorRGBA8, SL_TexelOrder::SL_TEXELS_SWIZZLED>(x, y);
+            const SL_ColorRGBA8 c = ordered.native_texel<SL_ColorRGBA8>(x, y);
+            const SL_ColorRGBA8 d = swizzled.native_texel<SL_ColorRGBA8>(x, y);
+
+            if (_sl_texels_differ(expected, a))
+            {
+                _sl_report("Ordered texel", x, y, expected, a);
+                return;
+            }
+
+            if (_sl_texels_differ(expected, b))
+            {
+                _sl_report("Swizzled texel", x, y, expected, b);
+                return;
+            }
+
+            if (_sl_texels_differ(expected, c))
+            {
+                _sl_report("Ordered native texel", x, y, expected, c);
+                return;
+            }
+
+            if (_sl_texels_differ(expected, d))
+            {
+                _sl_report("Swizzled native texel", x, y, expected, d);
+                return;
+            }
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Sample both textures at the same coordinates
+-------------------------------------*/
+template <class WrapMode>
+void _sl_check_samplers(const SL_Texture& ordered, const SL_Texture& swizzled) noexcept
+{
+    constexpr SL_TexelOrder ORDERED  = SL_TexelOrder::SL_TEXELS_ORDERED;
+    constexpr SL_TexelOrder SWIZZLED = SL_TexelOrder::SL_TEXELS_SWIZZLED;
+
+    std::uniform_real_distribution<float> dist{-0.5f, 1.5f};
+
+    for (unsigned i = 0; i < TEST_NUM_SAMPLES; ++i)
+    {
+        const float x = dist(gRandom);
+        const float y = dist(gRandom);
+
+        const SL_ColorRGBA8 a = sl_sample_nearest<SL_ColorRGBA8, WrapMode, ORDERED>(ordered, x, y);
+        const SL_ColorRGBA8 b = sl_sample_nearest<SL_ColorRGBA8, WrapMode, SWIZZLED>(swizzled, x, y);
+
+        if (_sl_texels_differ(a, b))
+        {
+            _sl_report("sl_sample_nearest", x, y, a, b);
+            return;
+        }
+
+        const SL_ColorRGBA8 c = sl_sample_bilinear<SL_ColorRGBA8, WrapMode, ORDERED>(ordered, x, y);
+        const SL_ColorRGBA8 d = sl_sample_bilinear<SL_ColorRGBA8, WrapMode, SWIZZLED>(swizzled, x, y);
+
+        if (_sl_texels_differ(c, d))
+        {
+            _sl_report("sl_sample_bilinear", x, y, c, d);
+            return;
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Images are only swizzled if they fill whole chunks
+-------------------------------------*/
+int _sl_check_image_files(const SL_ColorRGBA8* pImage) noexcept
+{
+    SL_ImgFile img;
+
+    if (img.load_memory_stream(pImage, SL_COLOR_RGBA_8U, TEST_TEX_SIZE, TEST_TEX_SIZE) != SL_ImgFile::FILE_LOAD_SUCCESS)
+    {
+        std::cerr << "Unable to load an image from memory." << std::endl;
+        return -1;
+    }
+
+    SL_Texture ordered;
+    SL_Texture swizzled;
+
+    if (ordered.init(img, SL_TexelOrder::SL_TEXELS_ORDERED) != 0
+    || swizzled.init(img, SL_TexelOrder::SL_TEXELS_SWIZZLED) != 0)
+    {
+        std::cerr << "Unable to initialize textures from an image." << std::endl;
+        return -2;
+    }
+
+    _sl_check_samplers<SL_WrapModeRepeat>(ordered, swizzled);
+
+    SL_ImgFile unaligned;
+
+    if (unaligned.load_memory_stream(pImage, SL_COLOR_RGBA_8U, TEST_UNALIGNED_SIZE, TEST_UNALIGNED_SIZE) != SL_ImgFile::FILE_LOAD_SUCCESS)
+    {
+        std::cerr << "Unable to load an unaligned image from memory." << std::endl;
+        return -3;
+    }
+
+    SL_Texture unalignedSwizzled;
+    SL_Texture unalignedOrdered;
+
+    if (unalignedSwizzled.init(unaligned, SL_TexelOrder::SL_TEXELS_SWIZZLED) != -5)
+    {
+        std::cerr << "Swizzled images must have dimensions which are multiples of " << SL_TEXELS_PER_CHUNK << '.' << std::endl;
+        ++gNumErrors;
+    }
+
+    if (unalignedOrdered.init(unaligned, SL_TexelOrder::SL_TEXELS_ORDERED) != 0)
+    {
+        std::cerr << "Ordered images may have any dimensions." << std::endl;
+        ++gNumErrors;
+    }
+
+    return 0;
+}
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Main
+-----------------------------------------------------------------------------*/
+int main()
+{
+    SL_ColorRGBA8 image[TEST_TEX_SIZE * TEST_TEX_SIZE];
+    std::uniform_int_distribution<int> dist{0, 255};
+
+    for (SL_ColorRGBA8& texel : image)
+    {
+        texel = SL_ColorRGBA8{(uint8_t)dist(gRandom), (uint8_t)dist(gRandom), (uint8_t)dist(gRandom), (uint8_t)dist(gRandom)};
+    }
+
+    SL_Texture ordered;
+    SL_Texture swizzled;
+
+    if (ordered.init(SL_COLOR_RGBA_8U, TEST_TEX_SIZE, TEST_TEX_SIZE, 1, SL_TexelOrder::SL_TEXELS_ORDERED) != 0
+    || swizzled.init(SL_COLOR_RGBA_8U, TEST_TEX_SIZE, TEST_TEX_SIZE, 1, SL_TexelOrder::SL_TEXELS_SWIZZLED) != 0)
+    {
+        std::cerr << "Unable to initialize the test textures." << std::endl;
+        return -1;
+    }
+
+    if (ordered.upload(image, SL_COLOR_RGBA_8U, SL_TexelOrder::SL_TEXELS_ORDERED) != 0
+    || swizzled.upload(image, SL_COLOR_RGBA_8U, SL_TexelOrder::SL_TEXELS_ORDERED) != 0)
+    {
+        std::cerr << "Unable to upload the test image." << std::endl;
+        return -2;
+    }
+
+    _sl_check_texels(image, ordered, swizzled);
+    _sl_check_samplers<SL_WrapModeClampEdge>(ordered, swizzled);
+    _sl_check_samplers<SL_WrapModeClampBorder>(ordered, swizzled);
+    _sl_check_samplers<SL_WrapModeRepeat>(ordered, swizzled);
+
+    if (_sl_check_image_files(image) != 0)
+    {
+        return -3;
+    }
+
+    if (gNumErrors)
+    {
+        std::cerr << "Texel order test failed with " << gNumErrors << " errors." << std::endl;
+        return -4;
+    }
+
+    std::cout << "Texel order test passed." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+
+#include <cstdint>
+#include <cstdlib> // std::abs()
+#include <iostream>
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_Texture.hpp"
+#include "softlight/SL_TextureCompression.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Test Constants
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+enum : uint16_t
+{
+    // Neither dimension is a multiple of the block size so partial edge
+    // blocks are encoded as well.
+    TEST_TEX_WIDTH  = 18,
+    TEST_TEX_HEIGHT = 10
+};
+
+// Maximum per-channel error for a block with a given range of values. Color
+// endpoints are quantized to RGB565 and interpolated in 4 steps while
+// single-channel endpoints are stored exactly and interpolated in 8 steps.
+constexpr int _sl_color_tolerance(int range) noexcept
+{
+    return range / 6 + 8;
+}
+
+constexpr int _sl_channel_tolerance(int range) noexcept
+{
+    return range / 14 + 1;
+}
+
+unsigned gNumErrors = 0;
+
+
+
+/*-------------------------------------
+ * Compare decoded channels against their source
+-------------------------------------*/
+void _sl_compare_channels(
+    const char* pName,
+    const SL_ColorRGBA8* pExpected,
+    const SL_ColorRGBA8* pActual,
+    unsigned numTexels,
+    unsigned firstChannel,
+    unsigned numChannels,
+    int tolerance) noexcept
+{
+    for (unsigned i = 0; i < numTexels; ++i)
+    {
+        for (unsigned c = firstChannel; c < firstChannel+numChannels; ++c)
+        {
+            const int a = (int)pExpected[i][c];
+            const int b = (int)pActual[i][c];
+
+            if (std::abs(a - b) > tolerance)
+            {
+                std::cerr
+                    << pName << ": texel " << i << ", channel " << c << " expected " << a
+                    << " but got " << b << " (tolerance " << tolerance << ")." << std::endl;
+                ++gNumErrors;
+                return;
+            }
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Blocks with exactly representable values decode without error
+-------------------------------------*/
+void _sl_check_exact_blocks() noexcept
+{
+    SL_ColorRGBA8 texels[SL_TEXELS_PER_BLOCK];
+    SL_ColorRGBA8 decoded[SL_TEXELS_PER_BLOCK];
+    uint8_t block[16];
+
+    // Black & white are the RGB565 endpoints of their bounding box
+    for (unsigned i = 0; i < SL_TEXELS_PER_BLOCK; ++i)
+    {
+        const uint8_t c = (i & 1u) ? 255u : 0u;
+        texels[i] = SL_ColorRGBA8{c, c, c, 255u};
+    }
+
+    sl_encode_bc1_block(texels, block);
+    sl_decode_bc1_block(block, decoded);
+    _sl_compare_channels("BC1 (two colors)", texels, decoded, SL_TEXELS_PER_BLOCK, 0, 4, 0);
+
+    // Transparent texels use the 3-color mode and decode to black
+    for (unsigned i = 0; i < SL_TEXELS_PER_BLOCK; ++i)
+    {
+        texels[i] = (i & 2u) ? SL_ColorRGBA8{0u, 0u, 0u, 0u} : SL_ColorRGBA8{255u, 0u, 255u, 255u};
+    }
+
+    sl_encode_bc1_block(texels, block);
+    sl_decode_bc1_block(block, decoded);
+    _sl_compare_channels("BC1 (transparency)", texels, decoded, SL_TEXELS_PER_BLOCK, 0, 4, 0);
+
+    // Single-channel endpoints are stored without quantization
+    for (unsigned i = 0; i < SL_TEXELS_PER_BLOCK; ++i)
+    {
+        texels[i] = SL_ColorRGBA8{(uint8_t)((i & 1u) ? 200u : 17u), (uint8_t)((i & 4u) ? 3u : 99u), 0u, 255u};
+    }
+
+    sl_encode_bc4_block(texels, block);
+    sl_decode_bc4_block(block, decoded);
+    _sl_compare_channels("BC4 (two values)", texels, decoded, SL_TEXELS_PER_BLOCK, 0, 1, 0);
+
+    sl_encode_bc5_block(texels, block);
+    sl_decode_bc5_block(block, decoded);
+    _sl_compare_channels("BC5 (two values)", texels, decoded, SL_TEXELS_PER_BLOCK, 0, 2, 0);
+}
+
+
+
+/*-------------------------------------
+ * Gradients decode within the precision of each format
+-------------------------------------*/
+void _sl_check_gradient_blocks() noexcept
+{
+    SL_ColorRGBA8 texels[SL_TEXELS_PER_BLOCK];
+    SL_ColorRGBA8 decoded[SL_TEXELS_PER_BLOCK];
+    uint8_t block[16];
+
+    for (int range = 0; range <= 255; range += 15)
+    {
+        // Channels increase together so the colors lie along the diagonal of
+        // their bounding box. Alpha stays opaque for BC1.
+        for (unsigned i = 0; i < SL_TEXELS_PER_BLOCK; ++i)
+        {
+            const int t = (range * (int)i) / (SL_TEXELS_PER_BLOCK-1);
+            texels[i] = SL_ColorRGBA8{(uint8_t)t, (uint8_t)(t/2+64), (uint8_t)(t/4+128), (uint8_t)(255-t/2)};
+        }
+
+        sl_encode_bc1_block(texels, block);
+        sl_decode_bc1_block(block, decoded);
+        _sl_compare_channels("BC1 (gradient)", texels, decoded, SL_TEXELS_PER_BLOCK, 0, 3, _sl_color_tolerance(range));
+
+        sl_encode_bc3_block(texels, block);
+        sl_decode_bc3_block(block, decoded);
+        _sl_compare_channels("BC3 (gradient color)", texels, decoded, SL_TEXELS_PER_BLOCK, 0, 3, _sl_color_tolerance(range));
+        _sl_compare_channels("BC3 (gradient alpha)", texels, decoded, SL_TEXELS_PER_BLOCK, 3, 1, _sl_channel_tolerance(range));
+
+        sl_encode_bc4_block(texels, block);
+        sl_decode_bc4_block(block, decoded);
+        _sl_compare_channels("BC4 (gradient)", texels, decoded, SL_TEXELS_PER_BLOCK, 0, 1, _sl_channel_tolerance(range));
+
+        sl_encode_bc5_block(texels, block);
+        sl_decode_bc5_block(block, decoded);
+        _sl_compare_channels("BC5 (gradient)", texels, decoded, SL_TEXELS_PER_BLOCK, 0, 2, _sl_channel_tolerance(range));
+    }
+}
+
+
+
+/*-------------------------------------
+ * Encode an image into a texture and read it back
+-------------------------------------*/
+int _sl_check_texture(SL_ColorDataType type, unsigned numChannels, int tolerance) noexcept
+{
+    SL_ColorRGBA8 image[TEST_TEX_WIDTH * TEST_TEX_HEIGHT];
+
+    // Each 4x4 block spans at most 6 steps along the diagonal
+    for (unsigned y = 0; y < TEST_TEX_HEIGHT; ++y)
+    {
+        for (unsigned x = 0; x < TEST_TEX_WIDTH; ++x)
+        {
+            const unsigned t = (x + y) * 6u;
+            image[x + y*TEST_TEX_WIDTH] = SL_ColorRGBA8{(uint8_t)t, (uint8_t)t, (uint8_t)(t/2u+64u), (uint8_t)(255u-t/2u)};
+        }
+    }
+
+    SL_Texture tex;
+    if (tex.init(type, TEST_TEX_WIDTH, TEST_TEX_HEIGHT, 1) != 0)
+    {
+        std::cerr << "Unable to initialize a compressed texture of type " << (unsigned)type << '.' << std::endl;
+        return -1;
+    }
+
+    if (sl_encode_texture(image, SL_COLOR_RGBA_8U, tex) != 0)
+    {
+        std::cerr << "Unable to encode a texture of type " << (unsigned)type << '.' << std::endl;
+        return -2;
+    }
+
+    SL_ColorRGBA8 decoded[TEST_TEX_WIDTH * TEST_TEX_HEIGHT];
+
+    for (uint16_t y = 0; y < TEST_TEX_HEIGHT; ++y)
+    {
+        for (uint16_t x = 0; x < TEST_TEX_WIDTH; ++x)
+        {
+            decoded[x + y*TEST_TEX_WIDTH] = sl_fetch_compressed_texel(tex, x, y);
+        }
+    }
+
+    _sl_compare_channels("Compressed texture", image, decoded, TEST_TEX_WIDTH*TEST_TEX_HEIGHT, 0, numChannels, tolerance);
+
+    return 0;
+}
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Main
+-----------------------------------------------------------------------------*/
+int main()
+{
+    _sl_check_exact_blocks();
+    _sl_check_gradient_blocks();
+
+    if (_sl_check_texture(SL_COLOR_BC1_RGBA, 3, _sl_color_tolerance(36)) != 0
+    || _sl_check_texture(SL_COLOR_BC3_RGBA, 4, _sl_color_tolerance(36)) != 0
+    || _sl_check_texture(SL_COLOR_BC4_R, 1, _sl_channel_tolerance(36)) != 0
+    || _sl_check_texture(SL_COLOR_BC5_RG, 2, _sl_channel_tolerance(36)) != 0)
+    {
+        return -1;
+    }
+
+    // Only 8-bit images can be encoded, and only into compressed textures
+    SL_Texture tex;
+    const SL_ColorRGBA8 texel{0, 0, 0, 255};
+
+    if (tex.init(SL_COLOR_RGBA_8U, 4, 4, 1) != 0 || sl_encode_texture(&texel, SL_COLOR_RGBA_8U, tex) != -2)
+    {
+        std::cerr << "Uncompressed textures should be rejected by the encoder." << std::endl;
+        return -2;
+    }
+
+    if (gNumErrors)
+    {
+        std::cerr << "Texture compression test failed with " << gNumErrors << " errors." << std::endl;
+        return -3;
+    }
+
+    std::cout << "Texture compression test passed." << std::endl;
+
+    return 0;
+}
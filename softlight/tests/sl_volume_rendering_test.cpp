@@ -27,6 +27,7 @@
 #include "softlight/SL_UniformBuffer.hpp"
 #include "softlight/SL_VertexArray.hpp"
 #include "softlight/SL_VertexBuffer.hpp"
+#include "softlight/SL_VolumeRendering.hpp"
 #include "softlight/SL_WindowBuffer.hpp"
 #include "softlight/SL_WindowEvent.hpp"
 
@@ -56,12 +57,13 @@ namespace utils = ls::utils;
 --------------------------------------*/
 struct VolumeUniforms
 {
-    const SL_Texture* pCubeMap;
-    const SL_Texture* pOpacityMap;
-    const SL_Texture* pColorMap;
-    math::vec4        spacing;
-    math::vec4        camPos;
-    math::mat4        mvpMatrix;
+    const SL_Texture*      pCubeMap;
+    const SL_Texture*      pOpacityMap;
+    const SL_Texture*      pColorMap;
+    const SL_VolumeBricks* pBricks;
+    math::vec4             spacing;
+    math::vec4             camPos;
+    math::mat4             mvpMatrix;
 };
 
 
@@ -262,6 +264,109 @@ SL_FragmentShader volume_frag_shader()
 
 
 
+/*-------------------------------------
+ * Brick-skipping fragment shader
+ *
+ * Marches front-to-back in batches, stepping over empty bricks and stopping
+ * once a ray becomes opaque. Opacity is corrected the same way as above.
+-------------------------------------*/
+bool _volume_brick_frag_shader(SL_FragmentParam& fragParam)
+{
+    constexpr unsigned numSteps = 256;
+    constexpr unsigned minIntensity = 17;
+    constexpr float step = 1.f / (float)numSteps;
+
+    const VolumeUniforms*  pUniforms = fragParam.pUniforms->as<VolumeUniforms>();
+    const math::vec4&      spacing   = pUniforms->spacing;
+    const math::vec4&&     scaling   = math::rcp(spacing);
+    const SL_Texture&      volumeTex = *pUniforms->pCubeMap;
+    const SL_Texture&      alphaTex  = *pUniforms->pOpacityMap;
+    const SL_Texture&      colorTex  = *pUniforms->pColorMap;
+    const SL_VolumeBricks& bricks    = *pUniforms->pBricks;
+    const math::vec4&      pos       = fragParam.pVaryings[0] * scaling;
+    const math::vec4&&     rayDir    = math::normalize(fragParam.pVaryings[1]);
+    float                  nearPos;
+    float                  farPos;
+
+    const bool intersectInternalBox = intersect_ray_box(pos, rayDir, spacing, nearPos, farPos);
+    if (!intersectInternalBox)
+    {
+        return false;
+    }
+
+    // March front-to-back so rays can terminate once they become opaque
+    const math::vec4&& rayFar    = (pos + rayDir * farPos + 1.f) * 0.5f;
+    const math::vec4&& rayNear   = (pos + rayDir * nearPos + 1.f) * 0.5f;
+    const math::vec4&& ray       = rayFar - rayNear;
+    const math::vec4&& rayStep   = ray * step;
+    math::vec4         dstTexel  = {0.f};
+    SL_ColorR8         intensities[SL_VOLUME_RAY_BATCH_SIZE];
+
+    for (unsigned i = 0; i < numSteps && !sl_volume_ray_terminated(dstTexel);)
+    {
+        const math::vec4&& rayPos = math::fmadd(rayStep, math::vec4{(float)i}, rayNear);
+
+        // Step over bricks which cannot contain visible texels
+        const unsigned skip = bricks.skip_steps(rayPos, rayStep, (float)minIntensity);
+        if (skip)
+        {
+            i += skip;
+            continue;
+        }
+
+        sl_sample_volume_ray<SL_ColorR8, SL_WrapMode::EDGE>(volumeTex, rayPos, rayStep, intensities);
+
+        for (unsigned j = 0; j < SL_VOLUME_RAY_BATCH_SIZE && (i+j) < numSteps; ++j)
+        {
+            const unsigned intensity = intensities[j].r;
+            if (intensity < minIntensity)
+            {
+                continue;
+            }
+
+            // regular opacity (doesn't take ray steps into account).
+            float srcAlpha = alphaTex.raw_texel<float>(intensity);
+            if (srcAlpha > 0.f)
+            {
+                const math::vec4&& samplePos = math::fmadd(rayStep, math::vec4{(float)j}, rayPos);
+                const math::vec4&& norm      = calc_normal<numSteps>(volumeTex, samplePos);
+                const float        luminance = 2.f * math::clamp(math::dot(norm, math::vec4{1.f, 0.f, 1.f, 0.f}), 0.f, 1.f);
+                const math::vec3&& volColor  = colorTex.raw_texel<SL_ColorRGBf>(intensity) * luminance;
+
+                // corrected opacity, from:
+                // https://github.com/chrislu/schism/blob/master/projects/examples/ex_volume_ray_cast/src/renderer/shader/volume_ray_cast.glslf
+                srcAlpha = 1.f - math::pow(1.f - srcAlpha, math::length(samplePos - rayNear));
+
+                dstTexel = sl_volume_blend(dstTexel, math::vec4_cast(volColor, 1.f), srcAlpha);
+            }
+        }
+
+        i += SL_VOLUME_RAY_BATCH_SIZE;
+    }
+
+    // output composition
+    fragParam.pOutputs[0] = math::clamp(dstTexel, math::vec4{0.f}, math::vec4{1.f});
+
+    return dstTexel[3] > 0.f;
+}
+
+
+
+SL_FragmentShader volume_brick_frag_shader()
+{
+    SL_FragmentShader shader;
+    shader.numVaryings = 2;
+    shader.numOutputs = 1;
+    shader.blend = SL_BLEND_PREMULTIPLED_ALPHA;
+    shader.depthMask = SL_DEPTH_MASK_OFF;
+    shader.depthTest = SL_DEPTH_TEST_OFF;
+    shader.shader = _volume_brick_frag_shader;
+
+    return shader;
+}
+
+
+
 /*-------------------------------------
  * Read a volume file
 -------------------------------------*/
@@ -487,7 +592,7 @@ int create_color_map(SL_SceneGraph& graph)
 /*-----------------------------------------------------------------------------
  * Create the context for a demo scene
 -----------------------------------------------------------------------------*/
-utils::Pointer<SL_SceneGraph> init_volume_context()
+utils::Pointer<SL_SceneGraph> init_volume_context(SL_VolumeBricks& bricks)
 {
     int retCode = 0;
     utils::Pointer<SL_SceneGraph> pGraph  {new SL_SceneGraph{}};
@@ -525,6 +630,12 @@ utils::Pointer<SL_SceneGraph> init_volume_context()
     retCode = read_volume_file(*pGraph); // creates volume at texture index 2
     assert(retCode == 0);
 
+    retCode = bricks.init(context.texture(2));
+    assert(retCode == 0);
+
+    retCode = context.build_volume_bricks(context.texture(2), bricks);
+    assert(retCode == 0);
+
     retCode = create_opacity_map(*pGraph); // creates volume at texture index 3
     assert(retCode == 0);
 
@@ -536,6 +647,7 @@ utils::Pointer<SL_SceneGraph> init_volume_context()
 
     const SL_VertexShader&&   volVertShader = volume_vert_shader();
     const SL_FragmentShader&& volFragShader = volume_frag_shader();
+    const SL_FragmentShader&& brickFragShader = volume_brick_frag_shader();
 
     size_t uboId = context.create_ubo();
     SL_UniformBuffer& ubo = context.ubo(uboId);
@@ -544,11 +656,16 @@ utils::Pointer<SL_SceneGraph> init_volume_context()
     pUniforms->pCubeMap = &context.texture(2);
     pUniforms->pOpacityMap = &context.texture(3);
     pUniforms->pColorMap = &context.texture(4);
+    pUniforms->pBricks = &bricks;
 
     size_t volShaderId = context.create_shader(volVertShader, volFragShader, uboId);
     assert(volShaderId == 0);
     (void)volShaderId;
 
+    size_t brickShaderId = context.create_shader(volVertShader, brickFragShader, uboId);
+    assert(brickShaderId == 1);
+    (void)brickShaderId;
+
     pGraph->update();
 
     if (retCode != 0)
@@ -566,7 +683,7 @@ utils::Pointer<SL_SceneGraph> init_volume_context()
 /*-------------------------------------
  * Render a scene
 -------------------------------------*/
-void render_volume(SL_SceneGraph* pGraph, const SL_Transform& viewMatrix, const math::mat4& vpMatrix)
+void render_volume(SL_SceneGraph* pGraph, const SL_Transform& viewMatrix, const math::mat4& vpMatrix, size_t shaderId)
 {
     SL_Context&        context   = pGraph->mContext;
     VolumeUniforms*    pUniforms = context.ubo(0).as<VolumeUniforms>();
@@ -576,7 +693,7 @@ void render_volume(SL_SceneGraph* pGraph, const SL_Transform& viewMatrix, const
     pUniforms->camPos            = math::vec4{camPos[0], camPos[1], camPos[2], 0.f};
     pUniforms->mvpMatrix         = vpMatrix * modelMat;
 
-    context.draw(pGraph->mMeshes.back(), 0, 0);
+    context.draw(pGraph->mMeshes.back(), shaderId, 0);
 }
 
 
@@ -626,9 +743,10 @@ void update_cam_position(SL_Transform& camTrans, float tickTime, utils::Pointer<
 -----------------------------------------------------------------------------*/
 int main()
 {
+    SL_VolumeBricks                     bricks;
     ls::utils::Pointer<SL_RenderWindow> pWindow    {std::move(SL_RenderWindow::create())};
     ls::utils::Pointer<SL_WindowBuffer> pRenderBuf {SL_WindowBuffer::create()};
-    ls::utils::Pointer<SL_SceneGraph>   pGraph     {std::move(init_volume_context())};
+    ls::utils::Pointer<SL_SceneGraph>   pGraph     {std::move(init_volume_context(bricks))};
     SL_Context&                         context    = pGraph->mContext;
     ls::utils::Pointer<bool[]>          pKeySyms   {new bool[65536]};
 
@@ -642,6 +760,7 @@ int main()
     float dx = 0.f;
     float dy = 0.f;
     bool autorotate = true;
+    bool skipBricks = false;
     unsigned numThreads = context.num_threads();
 
     math::mat4 vpMatrix;
@@ -731,6 +850,11 @@ int main()
                         context.num_threads(numThreads);
                         break;
 
+                    case SL_KeySymbol::KEY_SYM_b:
+                        skipBricks = !skipBricks;
+                        std::cout << "Brick skipping " << (skipBricks ? "enabled." : "disabled.") << std::endl;
+                        break;
+
                     case SL_KeySymbol::KEY_SYM_ESCAPE:
                         std::cout << "Escape button pressed. Exiting." << std::endl;
                         shouldQuit = true;
@@ -792,7 +916,7 @@ int main()
 
             context.clear_framebuffer(0, 0, SL_ColorRGBAd{0.6, 0.6, 0.6, 1.0}, 0.0);
 
-            render_volume(pGraph.get(), camTrans, vpMatrix);
+            render_volume(pGraph.get(), camTrans, vpMatrix, skipBricks ? 1 : 0);
 
             context.blit(*pRenderBuf, 0);
             pWindow->render(*pRenderBuf);